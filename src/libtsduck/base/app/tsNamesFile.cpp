@@ -235,7 +235,9 @@ ts::NamesFile::NamesFile(const UString& fileName, bool mergeExtensions) :
     _log(CERR),
     _configFile(SearchConfigurationFile(fileName)),
     _configErrors(0),
-    _sections()
+    _mutex(),
+    _sections(),
+    _files()
 {
     // Locate the configuration file.
     if (_configFile.empty()) {
@@ -273,33 +275,56 @@ void ts::NamesFile::loadFile(const UString& fileName)
     _log.debug(u"loading names file %s", {fileName});
 
     // Open configuration file.
-    std::ifstream strm(fileName.toUTF8().c_str());
+    std::ifstream strm(fileName.toUTF8().c_str(), std::ios::in | std::ios::binary);
     if (!strm) {
         _configErrors++;
         _log.error(u"error opening file %s", {fileName});
         return;
     }
 
-    ConfigSection* section = nullptr;
-    UString line;
+    // Read the complete file in memory, in one single operation.
+    _files.emplace_back();
+    FileContent& file(_files.back());
+    file.name = fileName;
+    std::ostringstream content;
+    content << strm.rdbuf();
+    file.text = content.str();
+    strm.close();
 
-    // Read configuration file line by line.
-    for (size_t lineNumber = 1; line.getLine(strm); ++lineNumber) {
+    // Only locate sections in the file, the content of sections is decoded on demand.
+    // Names files are mostly ASCII, including section names, no need to decode UTF-8 here.
+    const std::string& text(file.text);
+    ConfigChunk* chunk = nullptr;
+    size_t lineNumber = 1;
 
-        // Remove leading and trailing spaces in line.
-        line.trim();
+    // Skip potential UTF-8 BOM (Byte Order Mark) at beginning of file.
+    size_t pos = text.compare(0, UString::UTF8_BOM_SIZE, UString::UTF8_BOM, UString::UTF8_BOM_SIZE) == 0 ? UString::UTF8_BOM_SIZE : 0;
 
-        if (line.empty() || line[0] == UChar('#')) {
+    for (size_t eol = 0; pos < text.size(); pos = eol + 1, ++lineNumber) {
+        // Locate current line, without leading and trailing spaces.
+        eol = text.find('\n', pos);
+        if (eol == std::string::npos) {
+            eol = text.size();
+        }
+        size_t first = pos;
+        size_t last = eol;
+        while (first < last && std::isspace(static_cast<unsigned char>(text[first]))) {
+            ++first;
+        }
+        while (first < last && std::isspace(static_cast<unsigned char>(text[last - 1]))) {
+            --last;
+        }
+
+        if (first >= last || text[first] == '#') {
             // Empty or comment line, ignore.
         }
-        else if (line.front() == UChar('[') && line.back() == UChar(']')) {
+        else if (text[first] == '[' && text[last - 1] == ']') {
             // Handle beginning of section, get section name.
-            line.erase(0, 1);
-            line.pop_back();
-            line.convertToLower();
+            const UString name(UString::FromUTF8(text.data() + first + 1, last - first - 2).toLower());
 
             // Get or create associated section.
-            auto it = _sections.find(line);
+            ConfigSection* section = nullptr;
+            const auto it = _sections.find(name);
             if (it != _sections.end()) {
                 section = it->second;
             }
@@ -307,12 +332,20 @@ void ts::NamesFile::loadFile(const UString& fileName)
                 // Create new section.
                 section = new ConfigSection;
                 CheckNonNull(section);
-                _sections.insert(std::make_pair(line, section));
+                _sections.insert(std::make_pair(name, section));
             }
+
+            // Start a new chunk of text for the section, after the current line.
+            section->chunks.emplace_back(&file, std::min(eol + 1, text.size()), lineNumber + 1);
+            chunk = &section->chunks.back();
         }
-        else if (!decodeDefinition(line, section)) {
-            // Invalid line.
-            _log.error(u"%s: invalid line %d: %s", {fileName, lineNumber, line});
+        else if (chunk != nullptr) {
+            // A definition line in a section, to be decoded later.
+            chunk->end = std::min(eol + 1, text.size());
+        }
+        else {
+            // Invalid line outside any section.
+            _log.error(u"%s: invalid line %d: %s", {fileName, lineNumber, UString::FromUTF8(text.data() + first, last - first)});
             if (++_configErrors >= 20) {
                 // Give up after that number of errors
                 _log.error(u"%s: too many errors, giving up", {fileName});
@@ -320,7 +353,66 @@ void ts::NamesFile::loadFile(const UString& fileName)
             }
         }
     }
-    strm.close();
+}
+
+
+//----------------------------------------------------------------------------
+// Decode all pending text chunks of a section, if not already done.
+//----------------------------------------------------------------------------
+
+void ts::NamesFile::decodeSection(ConfigSection* section) const
+{
+    if (section == nullptr || section->decoded.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    GuardMutex lock(_mutex);
+
+    // Check again, the section may have been decoded by another thread in the meantime.
+    if (section->decoded.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    UString line;
+    for (const auto& chunk : section->chunks) {
+        const std::string& text(chunk.file->text);
+        size_t lineNumber = chunk.line;
+        for (size_t pos = chunk.begin, eol = 0; pos < chunk.end; pos = eol + 1, ++lineNumber) {
+            eol = std::min(text.find('\n', pos), chunk.end);
+            line.assignFromUTF8(text.data() + pos, eol - pos);
+            line.trim();
+            if (line.empty() || line[0] == UChar('#')) {
+                // Empty or comment line, ignore.
+            }
+            else if (!decodeDefinition(line, section)) {
+                // Invalid line.
+                _log.error(u"%s: invalid line %d: %s", {chunk.file->name, lineNumber, line});
+                if (++_configErrors >= 20) {
+                    // Give up after that number of errors
+                    _log.error(u"%s: too many errors, giving up", {chunk.file->name});
+                    break;
+                }
+            }
+        }
+    }
+
+    // The text chunks are no longer needed.
+    section->chunks.clear();
+    section->decoded.store(true, std::memory_order_release);
+}
+
+
+//----------------------------------------------------------------------------
+// Get the number of errors in the configuration file.
+//----------------------------------------------------------------------------
+
+size_t ts::NamesFile::errorCount() const
+{
+    // Errors in sections are detected only when the sections are decoded.
+    for (const auto& it : _sections) {
+        decodeSection(it.second);
+    }
+    return _configErrors;
 }
 
 
@@ -328,7 +420,7 @@ void ts::NamesFile::loadFile(const UString& fileName)
 // Decode a line as "first[-last] = name". Return true on success.
 //----------------------------------------------------------------------------
 
-bool ts::NamesFile::decodeDefinition(const UString& line, ConfigSection* section)
+bool ts::NamesFile::decodeDefinition(const UString& line, ConfigSection* section) const
 {
     // Check the presence of the '=' and in a valid section.
     const size_t equal = line.find(UChar('='));
@@ -596,8 +688,9 @@ void ts::NamesFile::getName(const UString& sectionName, Value value, ConfigSecti
             return;
         }
 
-        // Get the name of the value in the section.
+        // Get the name of the value in the section, decode the section on first use.
         section = it->second;
+        decodeSection(section);
         name = section->getName(value);
 
         // Return when name found or no "superclass" or too many levels of inheritance.
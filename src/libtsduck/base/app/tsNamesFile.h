@@ -37,6 +37,7 @@
 #include "tsEnumUtils.h"
 #include "tsReport.h"
 #include "tsVersionInfo.h"
+#include "tsMutex.h"
 
 namespace ts {
     //!
@@ -64,6 +65,10 @@ namespace ts {
     //!
     //! Representation of a ".names" file, containing names for identifiers.
     //! In an instance of NamesFile, all names are loaded from one configuration file.
+    //!
+    //! The configuration files are read when the instance is created but the sections
+    //! are decoded only when a name is requested from them for the first time. Most
+    //! applications use only a few sections from large files. Lookups are thread-safe.
     //! @ingroup app
     //!
     class TSDUCKDLL NamesFile
@@ -145,9 +150,11 @@ namespace ts {
 
         //!
         //! Get the number of errors in the configuration file.
+        //! Since sections are decoded on demand, all sections which were not yet used are
+        //! decoded first. This can be slow on large files, use it in test programs only.
         //! @return The number of errors in the configuration file.
         //!
-        size_t errorCount() const { return _configErrors; }
+        size_t errorCount() const;
 
         //!
         //! Check if a name exists in a specified section.
@@ -233,15 +240,37 @@ namespace ts {
         // Map of configuration entries, indexed by first value of the range.
         typedef std::map<Value, ConfigEntry*> ConfigEntryMap;
 
+        // Content of a loaded configuration file, in UTF-8.
+        class FileContent
+        {
+        public:
+            UString     name {};  // File name, for error messages.
+            std::string text {};  // File content.
+        };
+
+        // A contiguous chunk of text in a configuration file, for one section, not yet decoded.
+        class ConfigChunk
+        {
+        public:
+            const FileContent* file {nullptr};  // File containing the chunk.
+            size_t             begin {0};       // Index of first character in file text.
+            size_t             end {0};         // Index after last character in file text.
+            size_t             line {0};        // Line number of first line in chunk.
+
+            ConfigChunk(const FileContent* f = nullptr, size_t b = 0, size_t l = 0) : file(f), begin(b), end(b), line(l) {}
+        };
+
         // Description of a configuration section.
         // The name of the section is the key in a map.
         class ConfigSection
         {
             TS_NOCOPY(ConfigSection);
         public:
-            size_t          bits {0};     // Number of significant bits in values of the type.
-            ConfigEntryMap  entries {};   // All entries, indexed by names.
-            UString         inherit {};   // Redirect to this section if value not found.
+            size_t                 bits {0};         // Number of significant bits in values of the type.
+            ConfigEntryMap         entries {};       // All entries, indexed by names.
+            UString                inherit {};       // Redirect to this section if value not found.
+            std::list<ConfigChunk> chunks {};        // Text chunks which are not yet decoded.
+            std::atomic<bool>      decoded {false};  // All chunks are decoded into entries.
 
             ConfigSection() = default;
             ~ConfigSection();
@@ -260,7 +289,10 @@ namespace ts {
         typedef std::map<UString, ConfigSection*> ConfigSectionMap;
 
         // Decode a line as "first[-last] = name". Return true on success, false on error.
-        bool decodeDefinition(const UString& line, ConfigSection* section);
+        bool decodeDefinition(const UString& line, ConfigSection* section) const;
+
+        // Decode all pending text chunks of a section, if not already done.
+        void decodeSection(ConfigSection* section) const;
 
         // Compute a number of hexa digits.
         static int HexaDigits(size_t bits);
@@ -278,10 +310,12 @@ namespace ts {
         static UString NormalizedSectionName(const UString& sectionName) { return sectionName.toTrimmed().toLower(); }
 
         // Names private fields.
-        Report&          _log;           // Error logger.
-        const UString    _configFile;    // Configuration file path.
-        size_t           _configErrors;  // Number of errors in configuration file.
-        ConfigSectionMap _sections;      // Configuration sections.
+        Report&                _log;           // Error logger.
+        const UString          _configFile;    // Configuration file path.
+        mutable size_t         _configErrors;  // Number of errors in configuration file.
+        mutable Mutex          _mutex;         // Protect the on-demand decoding of sections.
+        ConfigSectionMap       _sections;      // Configuration sections.
+        std::list<FileContent> _files;         // Content of all loaded files, not yet decoded.
     };
 
     //!
@@ -87,6 +87,15 @@ namespace ts {
             //!
             void add(const Value& value);
 
+            //!
+            //! Start a new value in the open array of the running document.
+            //! This is an alternative to add() when the application directly prints the
+            //! value, without building a JSON tree. Exactly one JSON value shall be printed.
+            //! @return Address of the text formatter where the new value shall be printed
+            //! or a null pointer if the array is not open.
+            //!
+            TextFormatter* startValue();
+
             //!
             //! Close the running document.
             //! If the JSON structure is still open, it is closed.
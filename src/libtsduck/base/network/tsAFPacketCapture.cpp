@@ -0,0 +1,399 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsAFPacketCapture.h"
+#include "tsNullReport.h"
+#include "tsIntegerUtils.h"
+#include "tsIPUtils.h"
+#include "tsSysUtils.h"
+#include "tsTime.h"
+
+#if defined(TS_LINUX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/mman.h>
+    #include <linux/if_packet.h>
+    #include <linux/if_ether.h>
+    #include <unistd.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+namespace {
+    // Nominal frame size in the ring. With TPACKET_V3, frames have variable sizes.
+    // This value is only used by the kernel to validate the ring parameters.
+    constexpr size_t NOMINAL_FRAME_SIZE = 2048;
+
+    // Maximum time to wait in poll(), to periodically check the abort condition.
+    constexpr ts::MilliSecond POLL_SLICE = 100;
+}
+
+
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+ts::AFPacketCapture::~AFPacketCapture()
+{
+    close(NULLREP);
+}
+
+
+#if defined(TS_LINUX)
+
+//----------------------------------------------------------------------------
+// Open the capture on a network interface.
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketCapture::open(const UString& interface, size_t block_size, size_t block_count, MilliSecond block_timeout, Report& report)
+{
+
+    if (isOpen()) {
+        report.error(u"capture already open");
+        return false;
+    }
+
+    // Get the interface index.
+    _ifindex = ::if_nametoindex(interface.toUTF8().c_str());
+    if (_ifindex == 0) {
+        report.error(u"unknown network interface %s", {interface});
+        return false;
+    }
+
+    // Block sizes must be multiples of the page size and large enough for one frame.
+    const size_t page_size = std::max<size_t>(size_t(::sysconf(_SC_PAGESIZE)), 1);
+    _block_size = round_up(std::max(block_size, NOMINAL_FRAME_SIZE), page_size);
+    _block_count = std::max<size_t>(block_count, 1);
+
+    // The AF_PACKET socket receives all protocols, the link-layer header is removed (SOCK_DGRAM).
+    _sock = ::socket(AF_PACKET, SOCK_DGRAM, htons(ETH_P_ALL));
+    if (_sock < 0) {
+        report.error(u"error creating AF_PACKET socket: %s", {SysErrorCodeMessage()});
+        return false;
+    }
+
+    // Use the TPACKET_V3 ring format.
+    int version = TPACKET_V3;
+    if (::setsockopt(_sock, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0) {
+        report.error(u"error setting TPACKET_V3 on AF_PACKET socket: %s", {SysErrorCodeMessage()});
+        close(NULLREP);
+        return false;
+    }
+
+    // Ignore frames which are sent by the local system. Not an error if not supported (kernel before 4.20),
+    // these frames are also filtered in readIP().
+#if defined(PACKET_IGNORE_OUTGOING)
+    int ignore = 1;
+    ::setsockopt(_sock, SOL_PACKET, PACKET_IGNORE_OUTGOING, &ignore, sizeof(ignore));
+#endif
+
+    // Allocate the ring in the kernel.
+    ::tpacket_req3 req;
+    TS_ZERO(req);
+    req.tp_block_size = (unsigned int)(_block_size);
+    req.tp_block_nr = (unsigned int)(_block_count);
+    req.tp_frame_size = (unsigned int)(NOMINAL_FRAME_SIZE);
+    req.tp_frame_nr = (unsigned int)((_block_size / NOMINAL_FRAME_SIZE) * _block_count);
+    req.tp_retire_blk_tov = (unsigned int)(std::max<MilliSecond>(block_timeout, 1));
+    if (::setsockopt(_sock, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) != 0) {
+        report.error(u"error creating AF_PACKET ring (%d blocks of %'d bytes): %s", {_block_count, _block_size, SysErrorCodeMessage()});
+        close(NULLREP);
+        return false;
+    }
+
+    // Map the ring in memory.
+    void* addr = ::mmap(nullptr, _block_size * _block_count, PROT_READ | PROT_WRITE, MAP_SHARED, _sock, 0);
+    if (addr == MAP_FAILED) {
+        report.error(u"error mapping AF_PACKET ring: %s", {SysErrorCodeMessage()});
+        close(NULLREP);
+        return false;
+    }
+    _ring = reinterpret_cast<uint8_t*>(addr);
+
+    // Start the capture on the interface.
+    ::sockaddr_ll sll;
+    TS_ZERO(sll);
+    sll.sll_family = AF_PACKET;
+    sll.sll_protocol = htons(ETH_P_ALL);
+    sll.sll_ifindex = int(_ifindex);
+    if (::bind(_sock, reinterpret_cast<::sockaddr*>(&sll), sizeof(sll)) != 0) {
+        report.error(u"error binding AF_PACKET socket to %s: %s", {interface, SysErrorCodeMessage()});
+        close(NULLREP);
+        return false;
+    }
+
+    report.debug(u"AF_PACKET ring on %s (index %d), %d blocks of %'d bytes", {interface, _ifindex, _block_count, _block_size});
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Close the capture.
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketCapture::close(Report& report)
+{
+    if (_ring != nullptr) {
+        ::munmap(_ring, _block_size * _block_count);
+    }
+    if (_sock >= 0) {
+        ::close(_sock);
+    }
+    if (_sock4 >= 0) {
+        ::close(_sock4);
+    }
+    if (_sock6 >= 0) {
+        ::close(_sock6);
+    }
+    _sock = _sock4 = _sock6 = -1;
+    _ifindex = 0;
+    _ring = _block = _frame = nullptr;
+    _block_size = _block_count = _block_index = _frame_remain = 0;
+    _stat_packets = _stat_drops = _stat_truncated = 0;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Join multicast groups on the capture interface.
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketCapture::addMembership(const IPv4Address& group, Report& report)
+{
+    if (!isOpen()) {
+        report.error(u"capture not open");
+        return false;
+    }
+
+    // The memberships are attached to a UDP socket which is never bound to any port.
+    // This socket never receives anything but the group is joined on the interface.
+    if (_sock4 < 0 && (_sock4 = ::socket(AF_INET, SOCK_DGRAM, 0)) < 0) {
+        report.error(u"error creating UDP socket: %s", {SysErrorCodeMessage()});
+        return false;
+    }
+
+    ::ip_mreqn req;
+    TS_ZERO(req);
+    group.copy(req.imr_multiaddr);
+    req.imr_ifindex = int(_ifindex);
+    report.verbose(u"joining multicast group %s", {group});
+    if (::setsockopt(_sock4, IPPROTO_IP, IP_ADD_MEMBERSHIP, &req, sizeof(req)) != 0) {
+        report.error(u"error adding multicast membership to %s: %s", {group, SysErrorCodeMessage()});
+        return false;
+    }
+    return true;
+}
+
+bool ts::AFPacketCapture::addMembership(const IPv6Address& group, Report& report)
+{
+    if (!isOpen()) {
+        report.error(u"capture not open");
+        return false;
+    }
+    if (_sock6 < 0 && (_sock6 = ::socket(AF_INET6, SOCK_DGRAM, 0)) < 0) {
+        report.error(u"error creating UDP socket: %s", {SysErrorCodeMessage()});
+        return false;
+    }
+
+    ::ipv6_mreq req;
+    TS_ZERO(req);
+    group.copy(req.ipv6mr_multiaddr);
+    req.ipv6mr_interface = _ifindex;
+    report.verbose(u"joining multicast group %s", {group});
+    if (::setsockopt(_sock6, IPPROTO_IPV6, IPV6_JOIN_GROUP, &req, sizeof(req)) != 0) {
+        report.error(u"error adding multicast membership to %s: %s", {group, SysErrorCodeMessage()});
+        return false;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Return the current block to the kernel.
+//----------------------------------------------------------------------------
+
+void ts::AFPacketCapture::releaseBlock()
+{
+    if (_block != nullptr) {
+        ::tpacket_block_desc* desc = reinterpret_cast<::tpacket_block_desc*>(_block);
+        __atomic_store_n(&desc->hdr.bh1.block_status, uint32_t(TP_STATUS_KERNEL), __ATOMIC_RELEASE);
+        _block = _frame = nullptr;
+        _frame_remain = 0;
+        _block_index = (_block_index + 1) % _block_count;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Wait for the current block to be owned by the application.
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketCapture::waitBlock(MilliSecond timeout, const AbortInterface* abort, Report& report)
+{
+    uint8_t* const block = _ring + _block_index * _block_size;
+    ::tpacket_block_desc* const desc = reinterpret_cast<::tpacket_block_desc*>(block);
+    const Time deadline(timeout > 0 ? Time::CurrentUTC() + timeout : Time::Apocalypse);
+
+    // Wait until the kernel passes the block to the application.
+    while ((__atomic_load_n(&desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0) {
+        if (abort != nullptr && abort->aborting()) {
+            // User-interrupt, end of processing but no error message.
+            return false;
+        }
+        MilliSecond wait = POLL_SLICE;
+        if (timeout > 0) {
+            const MilliSecond remain = deadline - Time::CurrentUTC();
+            if (remain <= 0) {
+                report.error(u"capture timeout");
+                return false;
+            }
+            wait = std::min(wait, remain);
+        }
+        ::pollfd pfd;
+        TS_ZERO(pfd);
+        pfd.fd = _sock;
+        pfd.events = POLLIN | POLLERR;
+        if (::poll(&pfd, 1, int(wait)) < 0 && errno != EINTR) {
+            report.error(u"error waiting for AF_PACKET ring: %s", {SysErrorCodeMessage()});
+            return false;
+        }
+    }
+
+    // The block now belongs to the application.
+    _block = block;
+    _frame_remain = desc->hdr.bh1.num_pkts;
+    _frame = block + desc->hdr.bh1.offset_to_first_pkt;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Read the next IPv4 or IPv6 datagram, without copy.
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketCapture::readIP(const uint8_t*& data, size_t& size, MicroSecond& timestamp, MilliSecond timeout, const AbortInterface* abort, Report& report)
+{
+    data = nullptr;
+    size = 0;
+    timestamp = -1;
+
+    if (!isOpen()) {
+        report.error(u"capture not open");
+        return false;
+    }
+
+    for (;;) {
+        // The previous datagram was returned from the current block. Now, we
+        // can return the block to the kernel when all its frames are processed.
+        if (_block != nullptr && _frame_remain == 0) {
+            releaseBlock();
+        }
+        if (_block == nullptr) {
+            if (!waitBlock(timeout, abort, report)) {
+                return false;
+            }
+            continue;
+        }
+
+        // Get next frame in the current block.
+        const uint8_t* const frame = _frame;
+        const ::tpacket3_hdr* const hdr = reinterpret_cast<const ::tpacket3_hdr*>(frame);
+        const ::sockaddr_ll* const sll = reinterpret_cast<const ::sockaddr_ll*>(frame + TPACKET_ALIGN(sizeof(::tpacket3_hdr)));
+        _frame_remain--;
+        _frame += hdr->tp_next_offset;
+
+        // Ignore frames which are sent by the local system and non-IP frames.
+        const size_t offset = hdr->tp_net >= hdr->tp_mac ? size_t(hdr->tp_net - hdr->tp_mac) : size_t(hdr->tp_snaplen);
+        if (sll->sll_pkttype == PACKET_OUTGOING || offset >= hdr->tp_snaplen) {
+            continue;
+        }
+
+        // Ignore frames which were truncated by the kernel (larger than the frame size in the ring).
+        // The IP headers would announce more data than available.
+        if (hdr->tp_snaplen < hdr->tp_len) {
+            _stat_truncated++;
+            report.debug(u"truncated frame ignored, %d bytes, %d captured", {hdr->tp_len, hdr->tp_snaplen});
+            continue;
+        }
+        const uint8_t* const ip = frame + hdr->tp_net;
+        const uint8_t version = ip[0] >> 4;
+        if (version != 4 && version != 6) {
+            continue;
+        }
+
+        data = ip;
+        size = hdr->tp_snaplen - offset;
+        timestamp = MicroSecond(hdr->tp_sec) * MicroSecPerSec + MicroSecond(hdr->tp_nsec) / NanoSecPerMicroSec;
+        return true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the capture statistics from the kernel.
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketCapture::getStatistics(uint64_t& packets, uint64_t& drops, uint64_t& truncated, Report& report)
+{
+    if (isOpen()) {
+        // The kernel counters are reset after each read.
+        ::tpacket_stats_v3 stats;
+        TS_ZERO(stats);
+        ::socklen_t len = sizeof(stats);
+        if (::getsockopt(_sock, SOL_PACKET, PACKET_STATISTICS, &stats, &len) != 0) {
+            report.error(u"error getting AF_PACKET statistics: %s", {SysErrorCodeMessage()});
+            return false;
+        }
+        _stat_packets += stats.tp_packets;
+        _stat_drops += stats.tp_drops;
+    }
+    packets = _stat_packets;
+    drops = _stat_drops;
+    truncated = _stat_truncated;
+    return isOpen();
+}
+
+
+//----------------------------------------------------------------------------
+// Stubs for unsupported operating systems.
+//----------------------------------------------------------------------------
+
+#else
+
+#define NOAFPACKET_ERROR_MSG u"AF_PACKET capture is not supported on this operating system"
+#define NOAFPACKET_ERROR { report.error(NOAFPACKET_ERROR_MSG); return false; }
+
+bool ts::AFPacketCapture::open(const UString&, size_t, size_t, MilliSecond, Report& report) NOAFPACKET_ERROR
+bool ts::AFPacketCapture::close(Report&) { return true; }
+bool ts::AFPacketCapture::addMembership(const IPv4Address&, Report& report) NOAFPACKET_ERROR
+bool ts::AFPacketCapture::addMembership(const IPv6Address&, Report& report) NOAFPACKET_ERROR
+bool ts::AFPacketCapture::readIP(const uint8_t*&, size_t&, MicroSecond&, MilliSecond, const AbortInterface*, Report& report) NOAFPACKET_ERROR
+bool ts::AFPacketCapture::getStatistics(uint64_t&, uint64_t&, Report& report) NOAFPACKET_ERROR
+void ts::AFPacketCapture::releaseBlock() {}
+bool ts::AFPacketCapture::waitBlock(MilliSecond, const AbortInterface*, Report& report) NOAFPACKET_ERROR
+
+#endif
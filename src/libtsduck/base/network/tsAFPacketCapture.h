@@ -0,0 +1,162 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Capture IP datagrams from a network interface using a memory-mapped AF_PACKET ring.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsIPv4Address.h"
+#include "tsIPv6Address.h"
+#include "tsAbortInterface.h"
+#include "tsReport.h"
+#include "tsUString.h"
+
+namespace ts {
+    //!
+    //! Capture IP datagrams from a network interface using a memory-mapped AF_PACKET ring (Linux only).
+    //! @ingroup net
+    //!
+    //! The ring uses the TPACKET_V3 format: the kernel fills blocks of variable-size frames
+    //! and the application processes complete blocks, directly in the mapped memory, without
+    //! system call per datagram. All IPv4 and IPv6 datagrams which are received on the interface
+    //! are returned, the filtering of flows is the responsibility of the application.
+    //! Datagrams which are sent by the local system are ignored. Frames which are truncated
+    //! by the kernel are ignored and counted (see getStatistics()).
+    //!
+    //! On other operating systems than Linux, open() always fails.
+    //!
+    class TSDUCKDLL AFPacketCapture
+    {
+        TS_NOCOPY(AFPacketCapture);
+    public:
+        //!
+        //! Default constructor.
+        //!
+        AFPacketCapture() = default;
+
+        //!
+        //! Destructor.
+        //!
+        ~AFPacketCapture();
+
+        //!
+        //! Open the capture on a network interface.
+        //! @param [in] interface Name of the network interface, for instance "eth0".
+        //! @param [in] block_size Size in bytes of each block in the ring. Rounded up to a multiple of the memory page size.
+        //! @param [in] block_count Number of blocks in the ring.
+        //! @param [in] block_timeout Maximum time in milliseconds before the kernel returns a partially filled block.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool open(const UString& interface, size_t block_size, size_t block_count, MilliSecond block_timeout, Report& report);
+
+        //!
+        //! Check if the capture is open.
+        //! @return True if the capture is open.
+        //!
+        bool isOpen() const { return _sock >= 0; }
+
+        //!
+        //! Close the capture.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool close(Report& report);
+
+        //!
+        //! Join an IPv4 multicast group on the capture interface.
+        //! The capture receives all frames which reach the interface. Joining the group makes sure
+        //! that the network interface and the network switches (IGMP) forward the multicast traffic.
+        //! The membership is dropped when the capture is closed.
+        //! @param [in] group IPv4 multicast address.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool addMembership(const IPv4Address& group, Report& report);
+
+        //!
+        //! Join an IPv6 multicast group on the capture interface (MLD).
+        //! @param [in] group IPv6 multicast address.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool addMembership(const IPv6Address& group, Report& report);
+
+        //!
+        //! Read the next IPv4 or IPv6 datagram (headers included), without copy.
+        //!
+        //! The returned datagram is not copied. It directly points inside the memory-mapped ring
+        //! and remains valid until the next read operation or close().
+        //!
+        //! @param [out] data Address of the IP datagram. Its first byte contains the IP version.
+        //! @param [out] size Size in bytes of the IP datagram.
+        //! @param [out] timestamp Capture timestamp in microseconds since Unix epoch.
+        //! @param [in] timeout Maximum time to wait for a datagram in milliseconds. No timeout if zero or negative.
+        //! @param [in] abort If non-zero, checked periodically while waiting for datagrams.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error, timeout or abort.
+        //!
+        bool readIP(const uint8_t*& data, size_t& size, MicroSecond& timestamp, MilliSecond timeout, const AbortInterface* abort, Report& report);
+
+        //!
+        //! Get the capture statistics from the kernel.
+        //! @param [out] packets Total number of frames which were received by the capture since open().
+        //! @param [out] drops Total number of frames which were dropped by the kernel since open(), because the ring was full.
+        //! @param [out] truncated Total number of frames which were ignored by readIP() since open(), because they
+        //! were truncated by the kernel.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool getStatistics(uint64_t& packets, uint64_t& drops, uint64_t& truncated, Report& report);
+
+    private:
+        int          _sock {-1};          // AF_PACKET socket.
+        int          _sock4 {-1};         // UDP socket for IPv4 multicast memberships.
+        int          _sock6 {-1};         // UDP socket for IPv6 multicast memberships.
+        unsigned int _ifindex {0};        // Index of capture interface.
+        uint8_t*     _ring {nullptr};     // Memory-mapped ring.
+        size_t       _block_size {0};     // Size of one block.
+        size_t       _block_count {0};    // Number of blocks.
+        size_t       _block_index {0};    // Index of current block.
+        uint8_t*     _block {nullptr};    // Current block, owned by the application, null if none.
+        size_t       _frame_remain {0};   // Number of remaining frames in current block.
+        uint8_t*     _frame {nullptr};    // Next frame in current block.
+        uint64_t     _stat_packets {0};   // Cumulated number of received frames.
+        uint64_t     _stat_drops {0};     // Cumulated number of dropped frames.
+        uint64_t     _stat_truncated {0}; // Cumulated number of ignored truncated frames.
+
+        // Return the current block to the kernel.
+        void releaseBlock();
+
+        // Wait for the current block to be owned by the application.
+        bool waitBlock(MilliSecond timeout, const AbortInterface* abort, Report& report);
+    };
+}
@@ -53,7 +53,11 @@
     #include <netinet/in.h>
     #include <netinet/tcp.h>
     #include <netdb.h>
-    #if defined(TS_MAC) || defined(TS_BSD)
+    #include <poll.h>
+    #if defined(TS_LINUX)
+        #include <sys/epoll.h>
+    #endif
+    #if defined(TS_LINUX) || defined(TS_MAC) || defined(TS_BSD)
         #include <ifaddrs.h>
     #endif
     #include "tsAfterStandardHeaders.h"
@@ -0,0 +1,231 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsIPPacketView.h"
+#include "tsIPv4Packet.h"
+
+
+//----------------------------------------------------------------------------
+// Clear the view.
+//----------------------------------------------------------------------------
+
+void ts::IPPacketView::clear()
+{
+    _data = nullptr;
+    _size = 0;
+    _version = 0;
+    _protocol = 0;
+    _fragmented = false;
+    _ip_header_size = 0;
+    _proto_header_size = 0;
+    _source_port = 0;
+    _destination_port = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Reinitialize the view on a new IP datagram.
+//----------------------------------------------------------------------------
+
+bool ts::IPPacketView::reset(const uint8_t* data, size_t size)
+{
+    // Clear previous content.
+    clear();
+    if (data == nullptr || size == 0) {
+        return false;
+    }
+
+    const uint8_t version = (data[0] >> 4) & 0x0F;
+    size_t header_size = 0;
+    uint8_t protocol = 0;
+    bool fragmented = false;
+
+    if (version == IPv4_VERSION) {
+        // IPv4 header: check header size and checksum, then truncate to the packet size in header.
+        header_size = IPv4Packet::IPHeaderSize(data, size);
+        if (header_size == 0 || !IPv4Packet::VerifyIPHeaderChecksum(data, size)) {
+            return false;
+        }
+        size = std::min<size_t>(size, GetUInt16BE(data + IPv4_LENGTH_OFFSET));
+        if (size < header_size) {
+            return false;
+        }
+        protocol = data[IPv4_PROTOCOL_OFFSET];
+        // "More Fragments" bit set or "Fragment Offset" not zero.
+        fragmented = (GetUInt16BE(data + IPv4_FRAGMENT_OFFSET) & 0x3FFF) != 0;
+    }
+    else if (version == IPv6_VERSION) {
+        // IPv6 fixed header, then truncate to the payload size in header (zero means jumbogram).
+        if (size < IPv6_HEADER_SIZE) {
+            return false;
+        }
+        const size_t payload_size = GetUInt16BE(data + IPv6_PAYLOAD_LENGTH_OFFSET);
+        if (payload_size > 0) {
+            size = std::min(size, IPv6_HEADER_SIZE + payload_size);
+        }
+        header_size = IPv6_HEADER_SIZE;
+        protocol = data[IPv6_NEXT_HEADER_OFFSET];
+
+        // Skip extension headers.
+        bool more = true;
+        while (more) {
+            switch (protocol) {
+                case IPv6_EXT_HOP_BY_HOP:
+                case IPv6_EXT_ROUTING:
+                case IPv6_EXT_DESTINATION: {
+                    // Generic format: next header, length in 8-byte units, not including the first 8 bytes.
+                    if (size < header_size + 8 || size < header_size + 8 + 8 * size_t(data[header_size + 1])) {
+                        return false;
+                    }
+                    protocol = data[header_size];
+                    header_size += 8 + 8 * size_t(data[header_size + 1]);
+                    break;
+                }
+                case IPv6_EXT_FRAGMENT: {
+                    // Fixed size of 8 bytes. The next headers are only meaningful in the reassembled datagram.
+                    if (size < header_size + 8) {
+                        return false;
+                    }
+                    protocol = data[header_size];
+                    header_size += 8;
+                    fragmented = true;
+                    more = false;
+                    break;
+                }
+                case IPv6_EXT_AUTH: {
+                    // Length in 4-byte units, minus 2.
+                    if (size < header_size + 8 || size < header_size + 4 * (size_t(data[header_size + 1]) + 2)) {
+                        return false;
+                    }
+                    protocol = data[header_size];
+                    header_size += 4 * (size_t(data[header_size + 1]) + 2);
+                    break;
+                }
+                default: {
+                    more = false;
+                    break;
+                }
+            }
+        }
+    }
+    else {
+        // Neither IPv4 nor IPv6.
+        return false;
+    }
+
+    // Validate the transport protocol header.
+    size_t proto_header_size = 0;
+    Port source_port = 0;
+    Port destination_port = 0;
+    const uint8_t* proto = data + header_size;
+
+    if (fragmented) {
+        // No reassembly, the transport protocol header is not interpreted, even in the first fragment.
+    }
+    else if (protocol == IPv4_PROTO_TCP && size >= header_size + TCP_MIN_HEADER_SIZE) {
+        proto_header_size = 4 * size_t((proto[TCP_HEADER_LENGTH_OFFSET] >> 4) & 0x0F);
+        if (proto_header_size < TCP_MIN_HEADER_SIZE || size < header_size + proto_header_size) {
+            return false;
+        }
+        source_port = GetUInt16BE(proto + TCP_SRC_PORT_OFFSET);
+        destination_port = GetUInt16BE(proto + TCP_DEST_PORT_OFFSET);
+    }
+    else if (protocol == IPv4_PROTO_UDP && size >= header_size + UDP_HEADER_SIZE) {
+        const size_t udp_length = GetUInt16BE(proto + UDP_LENGTH_OFFSET);
+        if (udp_length < UDP_HEADER_SIZE || size < header_size + udp_length) {
+            return false;
+        }
+        // Ignore trailing data after UDP payload.
+        size = header_size + udp_length;
+        proto_header_size = UDP_HEADER_SIZE;
+        source_port = GetUInt16BE(proto + UDP_SRC_PORT_OFFSET);
+        destination_port = GetUInt16BE(proto + UDP_DEST_PORT_OFFSET);
+    }
+    else if (protocol == IPv4_PROTO_TCP || protocol == IPv4_PROTO_UDP) {
+        // Packet too short.
+        return false;
+    }
+
+    // The datagram is valid.
+    _data = data;
+    _size = size;
+    _version = version;
+    _protocol = protocol;
+    _fragmented = fragmented;
+    _ip_header_size = header_size;
+    _proto_header_size = proto_header_size;
+    _source_port = source_port;
+    _destination_port = destination_port;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Access to the source and destination addresses.
+//----------------------------------------------------------------------------
+
+const uint8_t* ts::IPPacketView::sourceAddress() const
+{
+    return isIPv4() ? _data + IPv4_SRC_ADDR_OFFSET : (isIPv6() ? _data + IPv6_SRC_ADDR_OFFSET : nullptr);
+}
+
+const uint8_t* ts::IPPacketView::destinationAddress() const
+{
+    return isIPv4() ? _data + IPv4_DEST_ADDR_OFFSET : (isIPv6() ? _data + IPv6_DEST_ADDR_OFFSET : nullptr);
+}
+
+ts::IPv4SocketAddress ts::IPPacketView::sourceIPv4SocketAddress() const
+{
+    return isIPv4() ? IPv4SocketAddress(GetUInt32BE(_data + IPv4_SRC_ADDR_OFFSET), _source_port) : IPv4SocketAddress();
+}
+
+ts::IPv4SocketAddress ts::IPPacketView::destinationIPv4SocketAddress() const
+{
+    return isIPv4() ? IPv4SocketAddress(GetUInt32BE(_data + IPv4_DEST_ADDR_OFFSET), _destination_port) : IPv4SocketAddress();
+}
+
+ts::IPv6SocketAddress ts::IPPacketView::sourceIPv6SocketAddress() const
+{
+    return isIPv6() ? IPv6SocketAddress(_data + IPv6_SRC_ADDR_OFFSET, IPv6Address::BYTES, _source_port) : IPv6SocketAddress();
+}
+
+ts::IPv6SocketAddress ts::IPPacketView::destinationIPv6SocketAddress() const
+{
+    return isIPv6() ? IPv6SocketAddress(_data + IPv6_DEST_ADDR_OFFSET, IPv6Address::BYTES, _destination_port) : IPv6SocketAddress();
+}
+
+ts::UString ts::IPPacketView::sourceString() const
+{
+    return isIPv4() ? sourceIPv4SocketAddress().toString() : (isIPv6() ? sourceIPv6SocketAddress().toString() : UString());
+}
+
+ts::UString ts::IPPacketView::destinationString() const
+{
+    return isIPv4() ? destinationIPv4SocketAddress().toString() : (isIPv6() ? destinationIPv6SocketAddress().toString() : UString());
+}
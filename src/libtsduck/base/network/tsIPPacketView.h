@@ -0,0 +1,250 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view of an IPv4 or IPv6 datagram in memory.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsIPv4SocketAddress.h"
+#include "tsIPv6SocketAddress.h"
+#include "tsIPProtocols.h"
+
+namespace ts {
+    //!
+    //! Read-only view of an IPv4 or IPv6 datagram in memory.
+    //! @ingroup net
+    //!
+    //! Unlike IPv4Packet, this class does not copy the datagram. It only locates the
+    //! various headers and the payload inside a memory area which is owned by the
+    //! application, typically a memory-mapped capture file. The memory area must
+    //! remain valid as long as the view is used.
+    //!
+    //! IPv6 extension headers are skipped. The protocol() is the protocol of the
+    //! last header, typically UDP or TCP.
+    //!
+    //! Fragmented datagrams (IPv4 or IPv6) are not reassembled. The view of a fragment
+    //! is valid but the transport protocol header and payload are not accessible.
+    //!
+    class TSDUCKDLL IPPacketView
+    {
+    public:
+        //!
+        //! The concept of port is used by TCP and UDP.
+        //!
+        typedef AbstractNetworkAddress::Port Port;
+
+        //!
+        //! Default constructor.
+        //!
+        IPPacketView() = default;
+
+        //!
+        //! Constructor from raw content.
+        //! @param [in] data Address of the IP datagram, IP header included.
+        //! @param [in] size Size in bytes of the IP datagram.
+        //!
+        IPPacketView(const uint8_t* data, size_t size) { reset(data, size); }
+
+        //!
+        //! Reinitialize the view on a new IP datagram.
+        //! @param [in] data Address of the IP datagram, IP header included.
+        //! @param [in] size Size in bytes of the IP datagram.
+        //! @return True if the datagram is a valid IPv4 or IPv6 datagram.
+        //!
+        bool reset(const uint8_t* data, size_t size);
+
+        //!
+        //! Clear the view, becomes invalid.
+        //!
+        void clear();
+
+        //!
+        //! Check if the view is valid.
+        //! @return True if the view is valid.
+        //!
+        bool isValid() const { return _data != nullptr; }
+
+        //!
+        //! Get the IP version.
+        //! @return The IP version, 4 or 6, zero if the view is invalid.
+        //!
+        uint8_t version() const { return _version; }
+
+        //!
+        //! Check if the datagram is an IPv4 one.
+        //! @return True if the datagram is a valid IPv4 datagram.
+        //!
+        bool isIPv4() const { return _version == IPv4_VERSION; }
+
+        //!
+        //! Check if the datagram is an IPv6 one.
+        //! @return True if the datagram is a valid IPv6 datagram.
+        //!
+        bool isIPv6() const { return _version == IPv6_VERSION; }
+
+        //!
+        //! Get the protocol of the IP datagram (after all IPv6 extension headers).
+        //! @return The protocol identifier, as found in the IP header.
+        //!
+        uint8_t protocol() const { return _protocol; }
+
+        //!
+        //! Check if the IP datagram is fragmented.
+        //! @return True if the datagram is just a fragment of a larger datagram.
+        //!
+        bool fragmented() const { return _fragmented; }
+
+        //!
+        //! Check if this is a UDP datagram.
+        //! @return True if this is a valid UDP datagram.
+        //!
+        bool isUDP() const { return _protocol == IPv4_PROTO_UDP && _proto_header_size > 0; }
+
+        //!
+        //! Check if this is a TCP datagram.
+        //! @return True if this is a valid TCP datagram.
+        //!
+        bool isTCP() const { return _protocol == IPv4_PROTO_TCP && _proto_header_size > 0; }
+
+        //!
+        //! Access to the IP datagram, IP headers included.
+        //! @return The address of the IP datagram.
+        //!
+        const uint8_t* data() const { return _data; }
+
+        //!
+        //! Size of the IP datagram, IP headers included.
+        //! @return The size of the IP datagram in bytes.
+        //!
+        size_t size() const { return _size; }
+
+        //!
+        //! Get the size of all IP headers, including IPv6 extension headers.
+        //! @return The IP headers size in bytes.
+        //!
+        size_t headerSize() const { return _ip_header_size; }
+
+        //!
+        //! Get the size of the transport protocol header (UDP, TCP).
+        //! @return The protocol header size in bytes, zero for other protocols.
+        //!
+        size_t protocolHeaderSize() const { return _proto_header_size; }
+
+        //!
+        //! Access to the transport protocol payload (UDP or TCP data).
+        //! @return The address of the protocol payload. Null pointer if the datagram is fragmented.
+        //!
+        const uint8_t* protocolData() const { return _data == nullptr || _fragmented ? nullptr : _data + _ip_header_size + _proto_header_size; }
+
+        //!
+        //! Size of the transport protocol payload (UDP or TCP data).
+        //! @return The size of the protocol payload in bytes. Zero if the datagram is fragmented.
+        //!
+        size_t protocolDataSize() const { return _data == nullptr || _fragmented ? 0 : _size - _ip_header_size - _proto_header_size; }
+
+        //!
+        //! Get the size in bytes of the IP addresses in the header.
+        //! @return The size in bytes of the IP addresses: 4 for IPv4, 16 for IPv6.
+        //!
+        size_t addressSize() const { return isIPv4() ? size_t(IPv4Address::BYTES) : (isIPv6() ? size_t(IPv6Address::BYTES) : 0); }
+
+        //!
+        //! Access to the source IP address in the header.
+        //! @return The address of the source IP address, which is addressSize() bytes long.
+        //!
+        const uint8_t* sourceAddress() const;
+
+        //!
+        //! Access to the destination IP address in the header.
+        //! @return The address of the destination IP address, which is addressSize() bytes long.
+        //!
+        const uint8_t* destinationAddress() const;
+
+        //!
+        //! Get the source port (UDP or TCP).
+        //! @return The source port or zero if neither UDP nor TCP.
+        //!
+        Port sourcePort() const { return _source_port; }
+
+        //!
+        //! Get the destination port (UDP or TCP).
+        //! @return The destination port or zero if neither UDP nor TCP.
+        //!
+        Port destinationPort() const { return _destination_port; }
+
+        //!
+        //! Get the source socket address of an IPv4 datagram.
+        //! @return The source socket address. Invalid if the datagram is not an IPv4 one.
+        //!
+        IPv4SocketAddress sourceIPv4SocketAddress() const;
+
+        //!
+        //! Get the destination socket address of an IPv4 datagram.
+        //! @return The destination socket address. Invalid if the datagram is not an IPv4 one.
+        //!
+        IPv4SocketAddress destinationIPv4SocketAddress() const;
+
+        //!
+        //! Get the source socket address of an IPv6 datagram.
+        //! @return The source socket address. Invalid if the datagram is not an IPv6 one.
+        //!
+        IPv6SocketAddress sourceIPv6SocketAddress() const;
+
+        //!
+        //! Get the destination socket address of an IPv6 datagram.
+        //! @return The destination socket address. Invalid if the datagram is not an IPv6 one.
+        //!
+        IPv6SocketAddress destinationIPv6SocketAddress() const;
+
+        //!
+        //! Get the source socket address as a string, IPv4 or IPv6.
+        //! @return The source socket address as a string.
+        //!
+        UString sourceString() const;
+
+        //!
+        //! Get the destination socket address as a string, IPv4 or IPv6.
+        //! @return The destination socket address as a string.
+        //!
+        UString destinationString() const;
+
+    private:
+        const uint8_t* _data {nullptr};
+        size_t         _size {0};
+        uint8_t        _version {0};
+        uint8_t        _protocol {0};
+        bool           _fragmented {false};
+        size_t         _ip_header_size {0};
+        size_t         _proto_header_size {0};
+        Port           _source_port {0};
+        Port           _destination_port {0};
+    };
+}
@@ -48,18 +48,21 @@ namespace ts {
     constexpr size_t ETHER_HEADER_SIZE      = 14;   //!< Size of an Ethernet II header.
     constexpr size_t ETHER_ADDR_SIZE        =  6;   //!< Size in bytes of a MAC address in an Ethernet II header.
     constexpr size_t ETHER_CRC_SIZE         =  4;   //!< Size in bytes of the trailing CRC in an Ethernet II frame.
+    constexpr size_t ETHER_VLAN_TAG_SIZE    =  4;   //!< Size in bytes of a VLAN tag (TPID and TCI) in an Ethernet II header.
 
     //!
     //! Selected Ethernet II protocol type identifiers.
     //! @see https://en.wikipedia.org/wiki/EtherType
     //!
     enum : uint16_t {
-        ETHERTYPE_IPv4   = 0x0800,  //!< Protocol identifier for IPv4.
-        ETHERTYPE_ARP    = 0x0806,  //!< Protocol identifier for ARP.
-        ETHERTYPE_WOL    = 0x0842,  //!< Protocol identifier for Wake-on-LAN.
-        ETHERTYPE_RARP   = 0x8035,  //!< Protocol identifier for RARP.
-        ETHERTYPE_802_1Q = 0x8100,  //!< Protocol identifier for a 2-byte IEEE 802.1Q tag (VLAN) after EtherType, then real EtherType.
-        ETHERTYPE_IPv6   = 0x86DD,  //!< Protocol identifier for IPv6.
+        ETHERTYPE_IPv4    = 0x0800,  //!< Protocol identifier for IPv4.
+        ETHERTYPE_ARP     = 0x0806,  //!< Protocol identifier for ARP.
+        ETHERTYPE_WOL     = 0x0842,  //!< Protocol identifier for Wake-on-LAN.
+        ETHERTYPE_RARP    = 0x8035,  //!< Protocol identifier for RARP.
+        ETHERTYPE_802_1Q  = 0x8100,  //!< Protocol identifier for a 2-byte IEEE 802.1Q tag (VLAN) after EtherType, then real EtherType.
+        ETHERTYPE_IPv6    = 0x86DD,  //!< Protocol identifier for IPv6.
+        ETHERTYPE_802_1AD = 0x88A8,  //!< Protocol identifier for an IEEE 802.1ad (QinQ) service tag, then another tag or real EtherType.
+        ETHERTYPE_QINQ    = 0x9100,  //!< Non-standard protocol identifier for an outer QinQ tag (pre-802.1ad equipments).
     };
 
     //------------------------------------------------------------------------
@@ -89,6 +92,29 @@ namespace ts {
         IPv4_PROTO_SCTP     = 132,  //!< IPv4 protocol identifier for Stream Control Transmission Protocol (SCTP).
     };
 
+    //------------------------------------------------------------------------
+    // IPv6 protocol.
+    //------------------------------------------------------------------------
+
+    constexpr uint8_t IPv6_VERSION               =  6;   //!< Protocol version of IPv6 is ... 6 !
+    constexpr size_t  IPv6_PAYLOAD_LENGTH_OFFSET =  4;   //!< Offset of the payload length in an IPv6 header.
+    constexpr size_t  IPv6_NEXT_HEADER_OFFSET    =  6;   //!< Offset of the next header (protocol identifier) in an IPv6 header.
+    constexpr size_t  IPv6_SRC_ADDR_OFFSET       =  8;   //!< Offset of source IP address in an IPv6 header.
+    constexpr size_t  IPv6_DEST_ADDR_OFFSET      = 24;   //!< Offset of destination IP address in an IPv6 header.
+    constexpr size_t  IPv6_HEADER_SIZE           = 40;   //!< Size of the fixed part of an IPv6 header.
+
+    //!
+    //! Selected IPv6 extension header identifiers, in the "next header" field.
+    //!
+    enum : uint8_t {
+        IPv6_EXT_HOP_BY_HOP  =  0,  //!< IPv6 extension header for hop-by-hop options.
+        IPv6_EXT_ROUTING     = 43,  //!< IPv6 extension header for routing.
+        IPv6_EXT_FRAGMENT    = 44,  //!< IPv6 extension header for fragmentation.
+        IPv6_EXT_AUTH        = 51,  //!< IPv6 extension header for authentication.
+        IPv6_EXT_NO_NEXT     = 59,  //!< IPv6 "no next header".
+        IPv6_EXT_DESTINATION = 60,  //!< IPv6 extension header for destination options.
+    };
+
     //!
     //! Get the name of an IP protocol (UDP, TCP, etc).
     //! @param [in] protocol Protocol identifier, as set in IP header.
@@ -143,7 +169,12 @@ namespace ts {
     // Real-time Transport Protocol (RTP)
     //------------------------------------------------------------------------
 
+    constexpr uint8_t  RTP_VERSION     =     2;  //!< Current version of the RTP protocol.
     constexpr size_t   RTP_HEADER_SIZE =    12;  //!< Size in bytes of the fixed part of the RTP header.
     constexpr uint8_t  RTP_PT_MP2T     =    33;  //!< RTP payload type for MPEG2-TS.
     constexpr uint64_t RTP_RATE_MP2T   = 90000;  //!< RTP clock rate for MPEG2-TS.
+
+    constexpr size_t   RTP_FEC_HEADER_SIZE     = 16;  //!< Size in bytes of the SMPTE 2022-1 FEC header, after the RTP header.
+    constexpr uint16_t RTP_FEC_COLUMN_PORT_OFFSET = 2;  //!< SMPTE 2022-1 column FEC stream UDP port, relative to media stream port.
+    constexpr uint16_t RTP_FEC_ROW_PORT_OFFSET    = 4;  //!< SMPTE 2022-1 row FEC stream UDP port, relative to media stream port.
 }
@@ -56,6 +56,16 @@ bool ts::IPInitialize(Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Guess the IP generation of an address or socket address string.
+//----------------------------------------------------------------------------
+
+ts::IP ts::IPStringGeneration(const UString& name)
+{
+    return name.startWith(u"[") || std::count(name.begin(), name.end(), u':') >= 2 ? IP::v6 : IP::v4;
+}
+
+
 //----------------------------------------------------------------------------
 // Check if a local system interface has a specified IP address.
 //----------------------------------------------------------------------------
@@ -201,3 +211,96 @@ bool ts::GetLocalIPAddresses(IPv4AddressVector& list, Report& report)
         return false;
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Get the index of a local network interface for IPv6 socket options.
+//----------------------------------------------------------------------------
+
+bool ts::GetIPv6InterfaceIndex(const UString& name, unsigned int& index, Report& report)
+{
+    index = 0;
+
+    if (name.empty() || name.toInteger(index)) {
+        // Default interface or interface index.
+        return true;
+    }
+    else if (IPStringGeneration(name) == IP::v6) {
+
+        // This is an IPv6 address, search the interface which owns it.
+        IPv6Address addr;
+        if (!addr.resolve(name, report)) {
+            return false;
+        }
+
+#if defined(TS_LINUX) || defined(TS_MAC) || defined(TS_BSD)
+        ::ifaddrs* start = nullptr;
+        if (::getifaddrs(&start) != 0) {
+            report.error(u"error getting local addresses: %s", {SysErrorCodeMessage()});
+            return false;
+        }
+        for (::ifaddrs* ifa = start; index == 0 && ifa != nullptr; ifa = ifa->ifa_next) {
+            if (ifa->ifa_addr != nullptr && ifa->ifa_addr->sa_family == AF_INET6 &&
+                IPv6Address(*reinterpret_cast<const ::sockaddr_in6*>(ifa->ifa_addr)) == addr)
+            {
+                index = ::if_nametoindex(ifa->ifa_name);
+            }
+        }
+        ::freeifaddrs(start);
+#endif
+
+        if (index == 0) {
+            report.error(u"%s is not the IPv6 address of a local interface", {addr});
+        }
+        return index != 0;
+    }
+    else {
+
+        // This is an interface name.
+#if defined(TS_WINDOWS)
+        report.error(u"interface names are not supported on this system, use an interface index or an IPv6 address");
+#else
+        index = ::if_nametoindex(name.toUTF8().c_str());
+        if (index == 0) {
+            report.error(u"unknown network interface %s", {name});
+        }
+#endif
+        return index != 0;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the list of local network interfaces which can receive IPv6 multicast.
+//----------------------------------------------------------------------------
+
+bool ts::GetIPv6MulticastInterfaces(std::vector<unsigned int>& indexes, Report& report)
+{
+    indexes.clear();
+
+#if defined(TS_LINUX) || defined(TS_MAC) || defined(TS_BSD)
+
+    // Get the list of local addresses. The memory is allocated by getifaddrs().
+    ::ifaddrs* start = nullptr;
+    if (::getifaddrs(&start) != 0) {
+        report.error(u"error getting local addresses: %s", {SysErrorCodeMessage()});
+        return false;
+    }
+
+    // Browse the list of interfaces, there is one entry per address.
+    for (::ifaddrs* ifa = start; ifa != nullptr; ifa = ifa->ifa_next) {
+        if (ifa->ifa_addr != nullptr && ifa->ifa_addr->sa_family == AF_INET6 && (ifa->ifa_flags & IFF_UP) != 0 && (ifa->ifa_flags & IFF_MULTICAST) != 0) {
+            const unsigned int index = ::if_nametoindex(ifa->ifa_name);
+            if (index != 0 && std::find(indexes.begin(), indexes.end(), index) == indexes.end()) {
+                indexes.push_back(index);
+            }
+        }
+    }
+
+    // Free the system-allocated memory.
+    ::freeifaddrs(start);
+
+#endif
+
+    return true;
+}
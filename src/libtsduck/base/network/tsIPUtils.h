@@ -52,6 +52,24 @@ namespace ts {
     //!
     TSDUCKDLL bool IPInitialize(Report& = CERR);
 
+    //!
+    //! Generation of IP protocols.
+    //!
+    enum class IP : uint8_t {
+        Any = 0,  //!< Unspecified generation.
+        v4  = 4,  //!< IPv4.
+        v6  = 6,  //!< IPv6.
+    };
+
+    //!
+    //! Guess the IP generation of an address or socket address string.
+    //! IPv6 addresses contain at least two colons. IPv6 socket addresses use the syntax "[address]:port".
+    //! Everything else (IPv4 addresses, port numbers alone, host names) is considered as IPv4.
+    //! @param [in] name A string containing an IP address or socket address.
+    //! @return IP::v6 if @a name looks like an IPv6 address or socket address, IP::v4 otherwise.
+    //!
+    TSDUCKDLL IP IPStringGeneration(const UString& name);
+
     //------------------------------------------------------------------------
     // Portable definitions for system socket interface.
     // Most socket types and functions have identical API in UNIX and Windows.
@@ -115,6 +133,17 @@ namespace ts {
     constexpr SysSocketErrorCode SYS_SOCKET_ERR_NOTCONN = ENOTCONN;
 #endif
 
+    //!
+    //! System error code value meaning "operation would block" on a non-blocking socket.
+    //!
+#if defined(DOXYGEN)
+    constexpr SysSocketErrorCode SYS_SOCKET_ERR_WOULDBLOCK = platform_specific;
+#elif defined(TS_WINDOWS)
+    constexpr SysSocketErrorCode SYS_SOCKET_ERR_WOULDBLOCK = WSAEWOULDBLOCK;
+#elif defined(TS_UNIX)
+    constexpr SysSocketErrorCode SYS_SOCKET_ERR_WOULDBLOCK = EWOULDBLOCK;
+#endif
+
     //!
     //! Get the error code of the last socket system call.
     //! The validity of the returned value may depends on specific conditions.
@@ -432,4 +461,27 @@ namespace ts {
     //! @return True is @a address is the address of a local system interface, false otherwise.
     //!
     TSDUCKDLL bool IsLocalIPAddress(const IPv4Address& address);
+
+    //!
+    //! Get the index of a local network interface, as used in IPv6 socket options.
+    //!
+    //! @param [in] name Identification of the local interface. This can be an interface
+    //! name (e.g. "eth0"), an interface index or an IPv6 address of the local interface.
+    //! If empty, @a index is set to zero, meaning the default interface.
+    //! @param [out] index Interface index.
+    //! @param [in] report Where to report errors.
+    //! @return True on success, false on error.
+    //!
+    TSDUCKDLL bool GetIPv6InterfaceIndex(const UString& name, unsigned int& index, Report& report = CERR);
+
+    //!
+    //! Get the list of local network interfaces which can receive IPv6 multicast.
+    //!
+    //! @param [out] indexes A vector of interface indexes, as used in IPv6 socket options.
+    //! Only the interfaces which are up, have an IPv6 address and support multicast are returned.
+    //! On systems where the list of interfaces is not available (Windows), the vector is empty.
+    //! @param [in] report Where to report errors.
+    //! @return True on success, false on error.
+    //!
+    TSDUCKDLL bool GetIPv6MulticastInterfaces(std::vector<unsigned int>& indexes, Report& report = CERR);
 }
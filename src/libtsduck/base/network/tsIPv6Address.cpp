@@ -34,6 +34,32 @@ const ts::IPv6Address ts::IPv6Address::AnyAddress;
 const ts::IPv6Address ts::IPv6Address::LocalHost(0, 0, 0, 0, 0, 0, 0, 1);
 
 
+//----------------------------------------------------------------------------
+// Conversions with system socket API.
+//----------------------------------------------------------------------------
+
+ts::IPv6Address::IPv6Address(const ::sockaddr_in6& a)
+{
+    if (a.sin6_family == AF_INET6) {
+        IPv6Address::setAddress(&a.sin6_addr, sizeof(a.sin6_addr));
+    }
+    else {
+        IPv6Address::clearAddress();
+    }
+}
+
+void ts::IPv6Address::copy(::sockaddr_in6& a, uint16_t port) const
+{
+    TS_ZERO(a);
+#if defined(SIN6_LEN)
+    a.sin6_len = sizeof(a);
+#endif
+    a.sin6_family = AF_INET6;
+    a.sin6_port = htons(port);
+    copy(a.sin6_addr);
+}
+
+
 //----------------------------------------------------------------------------
 // Set/get address
 //----------------------------------------------------------------------------
@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsAbstractNetworkAddress.h"
+#include "tsIP.h"
 #include "tsByteBlock.h"
 #include "tsMemory.h"
 
@@ -48,8 +49,7 @@ namespace ts {
     //! - 8 groups of 16 bits or hextets.
     //! - 2 64-bit values, the network prefix and the network identifier.
     //!
-    //! This class is incomplete. Currently, it does not allow IPv6 networking.
-    //! It is only designed to manipulate IPv6 addresses in DVB signalization.
+    //! Only numerical IPv6 addresses are supported. Host names are not resolved.
     //!
     class TSDUCKDLL IPv6Address: public AbstractNetworkAddress
     {
@@ -121,6 +121,19 @@ namespace ts {
         //!
         IPv6Address(uint64_t net, uint64_t ifid) { setAddress(net, ifid); }
 
+        //!
+        //! Constructor from a system "struct in6_addr" structure (socket API).
+        //! @param [in] a A system "struct in6_addr" structure.
+        //!
+        IPv6Address(const ::in6_addr& a) { IPv6Address::setAddress(&a, sizeof(a)); }
+
+        //!
+        //! Constructor from a system "struct sockaddr_in6" structure (socket API).
+        //! @param [in] a A system "struct sockaddr_in6" structure.
+        //! If the address family is not AF_INET6, the address is set to @link AnyAddress @endlink.
+        //!
+        IPv6Address(const ::sockaddr_in6& a);
+
         // Inherited methods.
         virtual size_t binarySize() const override;
         virtual bool hasAddress() const override;
@@ -147,6 +160,39 @@ namespace ts {
         //!
         void getAddress(ByteBlock& bb) const { bb.copy(_bytes, sizeof(_bytes)); }
 
+        //!
+        //! Copy the address into a system "struct in6_addr" structure (socket API).
+        //! @param [out] a A system "struct in6_addr" structure.
+        //!
+        void copy(::in6_addr& a) const { ::memcpy(&a, _bytes, sizeof(_bytes)); }
+
+        //!
+        //! Copy the address into a system "struct sockaddr_in6" structure (socket API).
+        //! @param [out] a A system "struct sockaddr_in6" structure.
+        //! @param [in] port Port number for the socket address.
+        //!
+        void copy(::sockaddr_in6& a, uint16_t port) const;
+
+        //!
+        //! Check if the address is a source-specific multicast (SSM) address.
+        //! IPv6 SSM addresses are in the range FF3x::/32 (RFC 4607).
+        //! @return True if the address is an SSM address, false otherwise.
+        //!
+        bool isSSM() const { return _bytes[0] == 0xFF && (_bytes[1] & 0xF0) == 0x30; }
+
+        //!
+        //! Check if the address is a link-local address.
+        //! This is a unicast address in the range FE80::/10 or a multicast address with
+        //! an interface-local or link-local scope (FFx1::/16 and FFx2::/16, RFC 4291).
+        //! Such an address is meaningful on one network interface only and requires
+        //! an interface scope identifier to be used in a socket.
+        //! @return True if the address is a link-local address, false otherwise.
+        //!
+        bool isLinkLocal() const
+        {
+            return (_bytes[0] == 0xFE && (_bytes[1] & 0xC0) == 0x80) || (_bytes[0] == 0xFF && ((_bytes[1] & 0x0F) == 0x01 || (_bytes[1] & 0x0F) == 0x02));
+        }
+
         //!
         //! Get the network prefix (64 most significant bits) of the IPv6 address.
         //! @return The network prefix (64 most significant bits) of the IPv6 address.
@@ -130,6 +130,16 @@ namespace ts {
         {
         }
 
+        //!
+        //! Constructor from a system "struct sockaddr_in6" structure (socket API).
+        //! @param [in] s A system "struct sockaddr_in6" structure.
+        //!
+        IPv6SocketAddress(const ::sockaddr_in6& s) :
+            IPv6Address(s),
+            _port(s.sin6_family == AF_INET6 ? ntohs(s.sin6_port) : AnyPort)
+        {
+        }
+
         //!
         //! Constructor from a string "[addr]:port".
         //! @param [in] name A string containing either a host name or a numerical
@@ -214,6 +224,24 @@ namespace ts {
             _port = port;
         }
 
+        //!
+        //! Copy into a system "struct sockaddr_in6" structure (socket API).
+        //! @param [out] s A system "struct sockaddr_in6" structure.
+        //!
+        void copy(::sockaddr_in6& s) const
+        {
+            IPv6Address::copy(s, _port);
+        }
+
+        //!
+        //! Copy the address into a system "struct in6_addr" structure (socket API).
+        //! @param [out] a A system "struct in6_addr" structure.
+        //!
+        void copy(::in6_addr& a) const
+        {
+            IPv6Address::copy(a);
+        }
+
         //!
         //! Check if this socket address "matches" another one.
         //! @param [in] other Another instance to compare.
@@ -29,6 +29,7 @@
 
 #include "tsPcapFile.h"
 #include "tsIPv4Packet.h"
+#include "tsNullReport.h"
 #include "tsByteBlock.h"
 #include "tsIntegerUtils.h"
 #include "tsSysUtils.h"
@@ -64,7 +65,7 @@ bool ts::PcapFile::error(Report& report, const UString& fmt, std::initializer_li
 
 bool ts::PcapFile::open(const UString& filename, Report& report)
 {
-    if (_in != nullptr) {
+    if (isOpen()) {
         report.error(u"already open");
         return false;
     }
@@ -76,6 +77,8 @@ bool ts::PcapFile::open(const UString& filename, Report& report)
     _ipv4_packet_count = 0;
     _packets_size = 0;
     _ipv4_packets_size = 0;
+    _ipv6_packet_count = 0;
+    _ipv6_packets_size = 0;
     _first_timestamp = -1;
     _last_timestamp = -1;
 
@@ -88,7 +91,13 @@ bool ts::PcapFile::open(const UString& filename, Report& report)
         _in = &std::cin;
         _name = u"standard input";
     }
+    else if (_map.open(filename, true, NULLREP)) {
+        // Regular file, mapped in memory.
+        _map_pos = 0;
+        _name = filename;
+    }
     else {
+        // Not a regular file or cannot be mapped, read it as a stream.
         _file.open(filename.toUTF8().c_str(), std::ios::in | std::ios::binary);
         if (!_file) {
             report.error(u"error opening %s", {filename});
@@ -105,7 +114,7 @@ bool ts::PcapFile::open(const UString& filename, Report& report)
         return false;
     }
 
-    report.debug(u"opened %s, %s format version %d.%d, %s endian", {_name, _ng ? u"pcap-ng" : u"pcap", _major, _minor, _be ? u"big" : u"little"});
+    report.debug(u"opened %s, %s format version %d.%d, %s endian%s", {_name, _ng ? u"pcap-ng" : u"pcap", _major, _minor, _be ? u"big" : u"little", _map.isOpen() ? u", memory-mapped" : u""});
     return true;
 }
 
@@ -119,6 +128,8 @@ void ts::PcapFile::close()
     if (_file.is_open()) {
         _file.close();
     }
+    _map.close();
+    _map_pos = 0;
     _in = nullptr;
 }
 
@@ -129,6 +140,16 @@ void ts::PcapFile::close()
 
 bool ts::PcapFile::readall(uint8_t* data, size_t size, Report& report)
 {
+    // With memory-mapped files, simply copy from the mapped file.
+    if (_map.isOpen()) {
+        const uint8_t* const addr = readData(size, report);
+        if (addr == nullptr) {
+            return false;
+        }
+        ::memcpy(data, addr, size);
+        return true;
+    }
+
     // Repeatedly read until all requested bytes are read.
     while (size > 0) {
         // Read at most "size" bytes.
@@ -155,6 +176,32 @@ bool ts::PcapFile::readall(uint8_t* data, size_t size, Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Read exactly "size" bytes, without copy when memory-mapped.
+//----------------------------------------------------------------------------
+
+const uint8_t* ts::PcapFile::readData(size_t size, Report& report)
+{
+    if (_map.isOpen()) {
+        // Directly return the address in the mapped file. Truncated file at end is like end of file.
+        if (size > _map.size() - _map_pos) {
+            _map_pos = _file_size = _map.size();
+            error(report);
+            return nullptr;
+        }
+        const uint8_t* const addr = _map.data() + _map_pos;
+        _map_pos += size;
+        _file_size = _map_pos;
+        return addr;
+    }
+    else {
+        // Read in the internal buffer.
+        _buffer.resize(size);
+        return readall(_buffer.data(), size, report) ? _buffer.data() : nullptr;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Read a file header, starting from a magic which was read as big endian.
 //----------------------------------------------------------------------------
@@ -184,15 +231,16 @@ bool ts::PcapFile::readHeader(uint32_t magic, Report& report)
         case PCAPNG_MAGIC: {
             // This is a pcap-ng file. Read the complete section header, compute endianness.
             _ng = true;
-            ByteBlock header;
-            if (!readNgBlockBody(magic, header, report)) {
+            const uint8_t* header = nullptr;
+            size_t header_size = 0;
+            if (!readNgBlockBody(magic, header, header_size, report)) {
                 return error(report);
             }
-            if (header.size() < 16) {
+            if (header_size < 16) {
                 return error(report, u"invalid pcap-ng file, truncated section header in %s", {_name});
             }
-            _major = get16(header.data() + 4);
-            _minor = get16(header.data() + 6);
+            _major = get16(header + 4);
+            _minor = get16(header + 6);
             _if.clear(); // will read interface descriptions in dedicated blocks.
             break;
         }
@@ -263,9 +311,10 @@ bool ts::PcapFile::analyzeNgInterface(const uint8_t* data, size_t size, Report&
 // Read a pcap-ng block. The 32-bit block type has already been read.
 //----------------------------------------------------------------------------
 
-bool ts::PcapFile::readNgBlockBody(uint32_t block_type, ByteBlock& body, Report& report)
+bool ts::PcapFile::readNgBlockBody(uint32_t block_type, const uint8_t*& body, size_t& body_size, Report& report)
 {
-    body.clear();
+    body = nullptr;
+    body_size = 0;
 
     // Read the first "Block Total Length" field.
     uint8_t lenfield[4];
@@ -274,47 +323,59 @@ bool ts::PcapFile::readNgBlockBody(uint32_t block_type, ByteBlock& body, Report&
     }
 
     // If the block type is Section Header, then the endianness is given by the first 4 bytes.
+    uint8_t order[4];
+    size_t start = 0;
     if (block_type == PCAPNG_SECTION_HEADER) {
         // Pcap-ng files have an endian-neutral block-type value for section header.
         // The byte order is defined by the 'byte-order magic' at the beginning of the section header block body.
-        body.resize(4);
-        if (!readall(body.data(), body.size(), report)) {
-            body.clear();
+        if (!readall(order, sizeof(order), report)) {
             return error(report);
         }
-        const uint32_t order_magic = GetUInt32BE(body.data());
+        const uint32_t order_magic = GetUInt32BE(order);
         if (order_magic != PCAPNG_ORDER_BE && order_magic != PCAPNG_ORDER_LE) {
-            body.clear();
             return error(report, u"invalid pcap-ng file, unknown 'byte-order magic' 0x%X in %s", {order_magic, _name});
         }
         _be = order_magic == PCAPNG_ORDER_BE;
+        start = sizeof(order);
     }
 
     // Interpret the packet size. The packet size include 12 additional bytes
     // for the block type and the two block length fields.
     const size_t size = get32(lenfield);
-    if (size % 4 != 0 || size < 12 + body.size()) {
-        body.clear();
+    if (size % 4 != 0 || size < 12 + start) {
         return error(report, u"invalid pcap-ng block length %d in %s", {size, _name});
     }
 
-    // Read the rest of the block body.
-    const size_t start = body.size();
-    body.resize(size - 12);
-    if (!readall(body.data() + start, body.size() - start, report)) {
-        body.clear();
-        return error(report);
+    // Read the rest of the block body and the trailing "Block Total Length" field.
+    const uint8_t* data = nullptr;
+    if (_map.isOpen()) {
+        // The block body is directly in the mapped file, including the byte-order magic which was just read.
+        data = readData(size - 8 - start, report);
+        if (data != nullptr) {
+            data -= start;
+        }
     }
-
-    // Read and check the last "Block Total Length" field.
-    if (!readall(lenfield, sizeof(lenfield), report)) {
+    else {
+        _buffer.resize(size - 8);
+        if (start > 0) {
+            ::memcpy(_buffer.data(), order, start);
+        }
+        if (readall(_buffer.data() + start, _buffer.size() - start, report)) {
+            data = _buffer.data();
+        }
+    }
+    if (data == nullptr) {
         return error(report);
     }
-    const size_t last_size = get32(lenfield);
+
+    // Check the last "Block Total Length" field.
+    const size_t last_size = get32(data + size - 12);
     if (size != last_size) {
-        body.clear();
         return error(report, u"inconsistent pcap-ng block length in %s, leading length: %d, trailing length: %d", {_name, size, last_size});
     }
+
+    body = data;
+    body_size = size - 12;
     return true;
 }
 
@@ -327,10 +388,134 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report&
 {
     // Clear output values.
     packet.clear();
+
+    // Loop on IP datagrams until an IPv4 one is found.
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    while (PcapFile::readIP(data, size, timestamp, report)) {
+        if ((data[0] >> 4) == IPv4_VERSION) {
+            if (packet.reset(data, size)) {
+                return true;
+            }
+            report.warning(u"invalid IPv4 datagram in pcap file, %d bytes", {size});
+        }
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Locate the IP datagram inside a captured packet, skipping the link layer.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFile::locateIP(const InterfaceDesc& ifd, const uint8_t*& data, size_t& size) const
+{
+    // Address family values in BSD loopback encapsulation. IPv6 has several values, depending on the BSD flavor.
+    constexpr uint32_t BSD_AF_INET = 2;
+    constexpr uint32_t BSD_AF_INET6_1 = 24;
+    constexpr uint32_t BSD_AF_INET6_2 = 28;
+    constexpr uint32_t BSD_AF_INET6_3 = 30;
+
+    // Size of the Linux "cooked" headers, with offset of the protocol type.
+    constexpr size_t SLL_HEADER_SIZE = 16;
+    constexpr size_t SLL_TYPE_OFFSET = 14;
+    constexpr size_t SLL2_HEADER_SIZE = 20;
+    constexpr size_t SLL2_TYPE_OFFSET = 0;
+
+    uint16_t ether_type = 0;    // Ethernet type of the payload, when known
+    size_t header_size = 0;     // Size of link layer header
+    size_t trailer_size = 0;    // Size of link layer trailer
+
+    if ((ifd.link_type == LINKTYPE_NULL || ifd.link_type == LINKTYPE_LOOP) && size > 4) {
+        // BSD loopback encapsulation; the link layer header is a 4-byte field containing the address family.
+        // The field is in host byte order for LINKTYPE_NULL and network byte order for LINKTYPE_LOOP.
+        const uint32_t family = ifd.link_type == LINKTYPE_NULL ? get32(data) : GetUInt32BE(data);
+        if (family == BSD_AF_INET) {
+            ether_type = ETHERTYPE_IPv4;
+            header_size = 4;
+        }
+        else if (family == BSD_AF_INET6_1 || family == BSD_AF_INET6_2 || family == BSD_AF_INET6_3) {
+            ether_type = ETHERTYPE_IPv6;
+            header_size = 4;
+        }
+    }
+    if (ether_type == 0 && (ifd.link_type == LINKTYPE_ETHERNET || ifd.link_type == LINKTYPE_NULL || ifd.link_type == LINKTYPE_LOOP) && size > ETHER_HEADER_SIZE + ifd.fcs_size) {
+        // Ethernet frame: 14-byte header: destination MAC (6 bytes), source MAC (6 bytes), ether type (2 bytes).
+        // This should apply to LINKTYPE_ETHERNET only. However, in some pcap files (not pcap-ng), it has been noticed that
+        // LINKTYPE_NULL and LINKTYPE_LOOP can contain a raw Ethernet frame without the initial 4 bytes of encapsulation.
+        // VLAN tags (802.1Q) and stacked VLAN tags (QinQ) are inserted before the actual ether type, 4 bytes each.
+        header_size = ETHER_HEADER_SIZE;
+        trailer_size = ifd.fcs_size;
+        ether_type = GetUInt16BE(data + ETHER_TYPE_OFFSET);
+        while ((ether_type == ETHERTYPE_802_1Q || ether_type == ETHERTYPE_802_1AD || ether_type == ETHERTYPE_QINQ) &&
+               size > header_size + ETHER_VLAN_TAG_SIZE + trailer_size)
+        {
+            header_size += ETHER_VLAN_TAG_SIZE;
+            ether_type = GetUInt16BE(data + header_size - 2);
+        }
+    }
+    else if (ifd.link_type == LINKTYPE_LINUX_SLL && size > SLL_HEADER_SIZE) {
+        // Linux "cooked" capture, typically on "any" interface.
+        header_size = SLL_HEADER_SIZE;
+        ether_type = GetUInt16BE(data + SLL_TYPE_OFFSET);
+    }
+    else if (ifd.link_type == LINKTYPE_LINUX_SLL2 && size > SLL2_HEADER_SIZE) {
+        // Linux "cooked" capture, version 2.
+        header_size = SLL2_HEADER_SIZE;
+        ether_type = GetUInt16BE(data + SLL2_TYPE_OFFSET);
+    }
+    else if ((ifd.link_type == LINKTYPE_RAW || ifd.link_type == LINKTYPE_IPV4 || ifd.link_type == LINKTYPE_IPV6) && size > 0) {
+        // Raw IPv4 or IPv6 header (version in first byte), no encapsulation.
+        const uint8_t version = data[0] >> 4;
+        ether_type = version == IPv4_VERSION ? ETHERTYPE_IPv4 : (version == IPv6_VERSION ? ETHERTYPE_IPv6 : 0);
+    }
+
+    // Check that an IP datagram was found.
+    if ((ether_type != ETHERTYPE_IPv4 && ether_type != ETHERTYPE_IPv6) || size <= header_size + trailer_size) {
+        return false;
+    }
+    data += header_size;
+    size -= header_size + trailer_size;
+
+    // Check the IP header and truncate the datagram to its actual size (remove Ethernet padding for instance).
+    if (ether_type == ETHERTYPE_IPv4) {
+        const size_t header_size_ip = IPv4Packet::IPHeaderSize(data, size);
+        if (header_size_ip == 0 || !IPv4Packet::VerifyIPHeaderChecksum(data, size)) {
+            return false;
+        }
+        const size_t ip_size = GetUInt16BE(data + IPv4_LENGTH_OFFSET);
+        if (ip_size < header_size_ip) {
+            return false;
+        }
+        size = std::min(size, ip_size);
+    }
+    else {
+        if (size < IPv6_HEADER_SIZE || (data[0] >> 4) != IPv6_VERSION) {
+            return false;
+        }
+        // A zero payload length is used in jumbograms, keep the complete captured packet.
+        const size_t payload_size = GetUInt16BE(data + IPv6_PAYLOAD_LENGTH_OFFSET);
+        if (payload_size > 0) {
+            size = std::min(size, IPv6_HEADER_SIZE + payload_size);
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Read the next IPv4 or IPv6 datagram (headers included), without copy.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFile::readIP(const uint8_t*& data, size_t& size, MicroSecond& timestamp, Report& report)
+{
+    // Clear output values.
+    data = nullptr;
+    size = 0;
     timestamp = -1;
 
     // Check that the file is open.
-    if (_in == nullptr) {
+    if (!isOpen()) {
         report.error(u"no pcap file open");
         return false;
     }
@@ -339,11 +524,12 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report&
         return false;
     }
 
-    // Loop on file blocks until an IPv4 packet is found.
+    // Loop on file blocks until an IP packet is found.
     for (;;) {
 
         // The captured packet will go there.
-        ByteBlock buffer;
+        const uint8_t* buffer = nullptr;
+        size_t buffer_size = 0;
         size_t cap_start = 0;  // captured packet start index in buffer
         size_t cap_size = 0;   // captured packet size
         size_t orig_size = 0;  // original packet size (on network)
@@ -366,25 +552,25 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report&
                 continue; // loop to next packet block
             }
             // Read one data block.
-            if (!readNgBlockBody(type, buffer, report)) {
+            if (!readNgBlockBody(type, buffer, buffer_size, report)) {
                 return error(report);
             }
             if (type == PCAPNG_INTERFACE_DESC) {
                 // Process an interface description.
-                if (!analyzeNgInterface(buffer.data(), buffer.size(), report)) {
+                if (!analyzeNgInterface(buffer, buffer_size, report)) {
                     return error(report);
                 }
                 continue; // loop to next packet block
             }
-            else if ((type == PCAPNG_ENHANCED_PACKET || type == PCAPNG_OBSOLETE_PACKET) && buffer.size() >= 20) {
+            else if ((type == PCAPNG_ENHANCED_PACKET || type == PCAPNG_OBSOLETE_PACKET) && buffer_size >= 20) {
                 _packet_count++;
                 cap_start = 20;
-                cap_size = std::min<size_t>(get32(buffer.data() + 12), buffer.size() - 20);
-                orig_size = get32(buffer.data() + 16);
-                if_index = type == PCAPNG_OBSOLETE_PACKET ? get16(buffer.data()) : get32(buffer.data());
+                cap_size = std::min<size_t>(get32(buffer + 12), buffer_size - 20);
+                orig_size = get32(buffer + 16);
+                if_index = type == PCAPNG_OBSOLETE_PACKET ? get16(buffer) : get32(buffer);
                 if (if_index < _if.size() && _if[if_index].time_units != 0) {
                     const SubSecond units = _if[if_index].time_units;
-                    const SubSecond tstamp = SubSecond(uint64_t(get32(buffer.data() + 4)) << 32) + SubSecond(get32(buffer.data() + 8));
+                    const SubSecond tstamp = SubSecond(uint64_t(get32(buffer + 4)) << 32) + SubSecond(get32(buffer + 8));
                     // Take care to overflow in tstamp * MilliSecPerSec. Sometimes, the timestamp is a full time
                     // since 1970 with time unit being 1,000,000,000. The value is close to the 64-bit max.
                     if (units == MicroSecPerSec) {
@@ -404,11 +590,11 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report&
                     }
                 }
             }
-            else if (type == PCAPNG_SIMPLE_PACKET && buffer.size() >= 4) {
+            else if (type == PCAPNG_SIMPLE_PACKET && buffer_size >= 4) {
                 _packet_count++;
                 cap_start = 4;
-                orig_size = get32(buffer.data());
-                cap_size = std::min(orig_size, buffer.size() - 4);
+                orig_size = get32(buffer);
+                cap_size = std::min(orig_size, buffer_size - 4);
             }
             else {
                 // This data block does not contain a captured packet, ignore it.
@@ -417,11 +603,11 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report&
         }
         else {
             // Pcap file, beginning of a packet block. Read the 16-byte header.
-            _packet_count++;
             uint8_t header[16];
             if (!readall(header, sizeof(header), report)) {
                 return error(report);
             }
+            _packet_count++;
             const uint32_t tstamp = get32(header);
             const uint32_t sub_tstamp = get32(header + 4);
             cap_size = get32(header + 8);
@@ -431,8 +617,8 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report&
             timestamp = (MicroSecond(tstamp) * MicroSecPerSec) + (SubSecond(sub_tstamp) * MicroSecPerSec) / _if[0].time_units;
 
             // Read packet data.
-            buffer.resize(cap_size);
-            if (!readall(buffer.data(), buffer.size(), report)) {
+            buffer_size = cap_size;
+            if ((buffer = readData(cap_size, report)) == nullptr) {
                 return error(report);
             }
         }
@@ -458,46 +644,21 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report&
         }
 
         report.log(2, u"pcap data block: %d bytes, captured packet at offset %d, %d bytes (original: %d bytes), link type: %d",
-                   {buffer.size(), cap_start, cap_size, orig_size, ifd.link_type});
-
-        // Analyze the captured packet, trying to find an IPv4 datagram.
-        if (ifd.link_type == LINKTYPE_NULL && cap_size > 4 && get32(buffer.data() + cap_start) == 2) {
-            // BSD loopback encapsulation; the link layer header is a 4-byte field, in host byte order, containing 2 for IPv4 packets.
-            cap_start += 4;
-            cap_size -= 4;
-        }
-        else if (ifd.link_type == LINKTYPE_LOOP && cap_size > 4 && GetUInt32BE(buffer.data() + cap_start) == 2) {
-            // OpenBSD loopback encapsulation; the link-layer header is a 4-byte field, in network byte order, containing 2 for IPv4 packets/
-            cap_start += 4;
-            cap_size -= 4;
-        }
-        else if ((ifd.link_type == LINKTYPE_ETHERNET || ifd.link_type == LINKTYPE_NULL || ifd.link_type == LINKTYPE_LOOP) &&
-                 cap_size > ETHER_HEADER_SIZE + ifd.fcs_size && GetUInt16BE(buffer.data() + cap_start + ETHER_TYPE_OFFSET) == ETHERTYPE_IPv4)
-        {
-            // Ethernet frame: 14-byte header: destination MAC (6 bytes), source MAC (6 bytes), ether type (2 bytes, 0x0800 for IPv4).
-            // This should apply to LINKTYPE_ETHERNET only. However, in some pcap files (not pcap-ng), it has been noticed that
-            // LINKTYPE_NULL and LINKTYPE_LOOP can contain a raw Ethernet frame without the initial 4 bytes of encapsulation.
-            cap_start += ETHER_HEADER_SIZE;
-            cap_size -= ETHER_HEADER_SIZE + ifd.fcs_size;
-        }
-        else if (ifd.link_type == LINKTYPE_RAW && cap_size >= IPv4_MIN_HEADER_SIZE && (buffer[cap_start] >> 4) == 4) {
-            // Raw IPv4 or IPv6 header (version in first byte), no encopsulation.
-        }
-        else {
-            // Not an identified IPv4 packet.
-            cap_size = 0;
-        }
+                   {buffer_size, cap_start, cap_size, orig_size, ifd.link_type});
 
-        // A possible IPv4 datagram was found.
-        if (cap_size > 0) {
-            if (packet.reset(buffer.data() + cap_start, cap_size)) {
+        // Analyze the captured packet, trying to find an IP datagram.
+        data = buffer + cap_start;
+        size = cap_size;
+        if (locateIP(ifd, data, size)) {
+            if ((data[0] >> 4) == IPv4_VERSION) {
                 _ipv4_packet_count++;
-                _ipv4_packets_size += cap_size;
-                return true;
+                _ipv4_packets_size += size;
             }
             else {
-                report.warning(u"invalid IPv4 datagram in pcap file, %d bytes (original: %d bytes), link type: %d", {cap_size, orig_size, ifd.link_type});
+                _ipv6_packet_count++;
+                _ipv6_packets_size += size;
             }
+            return true;
         }
     }
 }
@@ -37,6 +37,7 @@
 #include "tsMemory.h"
 #include "tsTime.h"
 #include "tsIPv4Packet.h"
+#include "tsMemoryMappedFile.h"
 #include "tsPcap.h"
 
 namespace ts {
@@ -45,8 +46,13 @@ namespace ts {
     //! @ingroup net
     //!
     //! This is the type of files which is created by Wireshark.
-    //! This class reads a pcap or pcapng file and extracts IPv4 frames.
-    //! All metadata and all other types of frames are ignored.
+    //! This class reads a pcap or pcapng file and extracts IPv4 and IPv6 datagrams.
+    //! All metadata and all other types of frames are ignored. On Ethernet links,
+    //! IEEE 802.1Q (VLAN) and 802.1ad (QinQ) tags are skipped.
+    //!
+    //! Regular files are mapped in memory and the captured packets are directly
+    //! accessed in the mapped file, without intermediate copy. The standard input,
+    //! pipes and files which cannot be mapped are read as streams.
     //!
     //! @see https://tools.ietf.org/pdf/draft-gharris-opsawg-pcap-02.pdf (PCAP)
     //! @see https://datatracker.ietf.org/doc/draft-gharris-opsawg-pcap/ (PCAP tracker)
@@ -79,7 +85,13 @@ namespace ts {
         //! Check if the file is open.
         //! @return True if the file is open, false otherwise.
         //!
-        bool isOpen() const { return _in != nullptr; }
+        bool isOpen() const { return _in != nullptr || _map.isOpen(); }
+
+        //!
+        //! Check if the file is mapped in memory.
+        //! @return True if the file is open and mapped in memory.
+        //!
+        bool isMemoryMapped() const { return _map.isOpen(); }
 
         //!
         //! Get the file name.
@@ -99,6 +111,22 @@ namespace ts {
         //!
         virtual bool readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report& report);
 
+        //!
+        //! Read the next IPv4 or IPv6 datagram (headers included), without copy.
+        //! Skip intermediate metadata and other types of packets.
+        //!
+        //! The returned datagram is not copied. With memory-mapped files, it directly points
+        //! inside the mapped file and remains valid until close(). Otherwise, it points inside
+        //! an internal buffer and remains valid until the next read operation or close().
+        //!
+        //! @param [out] data Address of the IP datagram. Its first byte contains the IP version.
+        //! @param [out] size Size in bytes of the IP datagram.
+        //! @param [out] timestamp Capture timestamp in microseconds since Unix epoch or -1 if none is available.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error or end of file.
+        //!
+        virtual bool readIP(const uint8_t*& data, size_t& size, MicroSecond& timestamp, Report& report);
+
         //!
         //! Get the number of captured packets so far.
         //! This includes all packets, not only IPv4 packets.
@@ -119,6 +147,12 @@ namespace ts {
         //!
         size_t ipv4PacketCount() const { return _ipv4_packet_count; }
 
+        //!
+        //! Get the number of valid captured IPv6 packets so far.
+        //! @return The number of valid captured IPv6 packets so far.
+        //!
+        size_t ipv6PacketCount() const { return _ipv6_packet_count; }
+
         //!
         //! Get the total file size in bytes so far.
         //! @return The total file size in bytes so far.
@@ -139,6 +173,13 @@ namespace ts {
         //!
         size_t totalIPv4PacketsSize() const { return _ipv4_packets_size; }
 
+        //!
+        //! Get the total size in bytes of valid captured IPv6 packets so far.
+        //! This includes all IPv6 headers but not link-layer headers when present.
+        //! @return The total size in bytes of valid captured IPv6 packets so far.
+        //!
+        size_t totalIPv6PacketsSize() const { return _ipv6_packets_size; }
+
         //!
         //! Get the capture timestamp of the first packet in the file.
         //! @return Capture timestamp in microseconds since Unix epoch or -1 if none is available.
@@ -185,8 +226,11 @@ namespace ts {
         };
 
         bool          _error {false};          // Error was set, may be logical error, not a file error.
-        std::istream* _in {nullptr};           // Point to actual input stream.
-        std::ifstream _file {};                // Input file (when it is a named file).
+        std::istream* _in {nullptr};           // Point to actual input stream (when not memory-mapped).
+        std::ifstream _file {};                // Input file (when it is a named file which cannot be mapped).
+        MemoryMappedFile _map {};              // Memory-mapped input file.
+        size_t        _map_pos {0};            // Current read position in memory-mapped file.
+        ByteBlock     _buffer {};              // Input buffer when not memory-mapped.
         UString       _name {};                // Saved file name for messages.
         bool          _be {false};             // The file use a big-endian representation.
         bool          _ng {false};             // Pcapng format (not pcap).
@@ -197,6 +241,8 @@ namespace ts {
         size_t        _ipv4_packet_count {0};  // Count of captured IPv4 packets.
         size_t        _packets_size {0};       // Total size in bytes of captured packets.
         size_t        _ipv4_packets_size {0};  // Total size in bytes of captured IPv4 packets.
+        size_t        _ipv6_packet_count {0};  // Count of captured IPv6 packets.
+        size_t        _ipv6_packets_size {0};  // Total size in bytes of captured IPv6 packets.
         MicroSecond   _first_timestamp {-1};   // Timestamp of first packet in file.
         MicroSecond   _last_timestamp {-1};    // Timestamp of last packet in file.
         std::vector<InterfaceDesc> _if {};     // Capture interfaces by index, only one in pcap files.
@@ -207,6 +253,14 @@ namespace ts {
         // Read exactly "size" bytes. Return false if not enough bytes before eof.
         bool readall(uint8_t* data, size_t size, Report& report);
 
+        // Read exactly "size" bytes, without copy when memory-mapped. Return null if not enough bytes before eof.
+        // The returned address is valid until the next read operation.
+        const uint8_t* readData(size_t size, Report& report);
+
+        // Locate the IP datagram inside a captured packet, skipping the link layer.
+        // Return false if there is no IP datagram.
+        bool locateIP(const InterfaceDesc& ifd, const uint8_t*& data, size_t& size) const;
+
         // Read a file / section header, starting from a magic number which was read as big endian.
         bool readHeader(uint32_t magic, Report& report);
 
@@ -215,8 +269,8 @@ namespace ts {
 
         // Read a pcap-ng block. The 32-bit block type has already been read.
         // Start at "Block total length". Read complete block, including the two length fields.
-        // Return only the block body.
-        bool readNgBlockBody(uint32_t block_type, ByteBlock& body, Report& report);
+        // Return only the block body. The returned address is valid until the next read operation.
+        bool readNgBlockBody(uint32_t block_type, const uint8_t*& body, size_t& body_size, Report& report);
 
         // Read 32 or 16 bits using the endianness.
         uint16_t get16(const void* addr) const { return _be ? GetUInt16BE(addr) : GetUInt16LE(addr); }
@@ -28,6 +28,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsPcapFilter.h"
+#include "tsIPPacketView.h"
 #include "tsAlgorithm.h"
 #include "tsArgs.h"
 
@@ -281,3 +282,43 @@ bool ts::PcapFilter::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report
         return true;
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Read an IPv4 or IPv6 datagram, inherited method.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFilter::readIP(const uint8_t*& data, size_t& size, MicroSecond& timestamp, Report& report)
+{
+    // Read datagrams until one which matches the general filters.
+    for (;;) {
+
+        // Invoke superclass to read next datagram.
+        if (!PcapFile::readIP(data, size, timestamp, report)) {
+            return false;
+        }
+
+        // Check final conditions (no need to read further in the file).
+        if (packetCount() > _last_packet ||
+            timestamp > _last_time ||
+            timeOffset(timestamp) > _last_time_offset)
+        {
+            return false;
+        }
+
+        // Check if the datagram matches all general filters.
+        if (packetCount() < _first_packet ||
+            timestamp < _first_time ||
+            timeOffset(timestamp) < _first_time_offset)
+        {
+            continue;
+        }
+        if (!_protocols.empty()) {
+            const IPPacketView ip(data, size);
+            if (!ip.isValid() || !Contains(_protocols, ip.protocol())) {
+                continue;
+            }
+        }
+        return true;
+    }
+}
@@ -238,6 +238,20 @@ namespace ts {
         //!
         bool loadArgs(DuckContext& duck, Args& args);
 
+        //!
+        //! Read the next IPv4 or IPv6 datagram (headers included), without copy.
+        //! Only the packet number, timestamp and protocol filters are applied. The address
+        //! filters are IPv4-only and are not applied here. Use an IPPacketView to check the
+        //! addresses of the returned datagram.
+        //! @param [out] data Address of the IP datagram. Its first byte contains the IP version.
+        //! @param [out] size Size in bytes of the IP datagram.
+        //! @param [out] timestamp Capture timestamp in microseconds since Unix epoch or -1 if none is available.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error or end of file.
+        //! @see PcapFile::readIP()
+        //!
+        virtual bool readIP(const uint8_t*& data, size_t& size, MicroSecond& timestamp, Report& report) override;
+
         // Inherited methods.
         virtual bool open(const UString& filename, Report& report) override;
         virtual bool readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report& report) override;
@@ -0,0 +1,166 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPcapFlowIndex.h"
+
+
+//----------------------------------------------------------------------------
+// Flow identification.
+//----------------------------------------------------------------------------
+
+ts::PcapFlowIndex::FlowId::FlowId(const IPPacketView& ip)
+{
+    if (ip.isValid()) {
+        version = ip.version();
+        protocol = ip.protocol();
+        source_port = ip.sourcePort();
+        destination_port = ip.destinationPort();
+        ::memcpy(source, ip.sourceAddress(), ip.addressSize());
+        ::memcpy(destination, ip.destinationAddress(), ip.addressSize());
+    }
+}
+
+bool ts::PcapFlowIndex::FlowId::operator==(const FlowId& other) const
+{
+    return version == other.version &&
+           protocol == other.protocol &&
+           source_port == other.source_port &&
+           destination_port == other.destination_port &&
+           ::memcmp(source, other.source, sizeof(source)) == 0 &&
+           ::memcmp(destination, other.destination, sizeof(destination)) == 0;
+}
+
+bool ts::PcapFlowIndex::FlowId::operator<(const FlowId& other) const
+{
+    if (version != other.version) {
+        return version < other.version;
+    }
+    const int src = ::memcmp(source, other.source, sizeof(source));
+    if (src != 0) {
+        return src < 0;
+    }
+    if (source_port != other.source_port) {
+        return source_port < other.source_port;
+    }
+    const int dst = ::memcmp(destination, other.destination, sizeof(destination));
+    if (dst != 0) {
+        return dst < 0;
+    }
+    if (destination_port != other.destination_port) {
+        return destination_port < other.destination_port;
+    }
+    return protocol < other.protocol;
+}
+
+ts::UString ts::PcapFlowIndex::FlowId::toString(const uint8_t* addr, uint16_t port) const
+{
+    const bool use_port = protocol == IPv4_PROTO_UDP || protocol == IPv4_PROTO_TCP;
+    if (version == IPv6_VERSION) {
+        return IPv6SocketAddress(addr, IPv6Address::BYTES, use_port ? port : IPv6SocketAddress::AnyPort).toString();
+    }
+    else {
+        return IPv4SocketAddress(GetUInt32BE(addr), use_port ? port : IPv4SocketAddress::AnyPort).toString();
+    }
+}
+
+ts::UString ts::PcapFlowIndex::FlowId::sourceString() const
+{
+    return toString(source, source_port);
+}
+
+ts::UString ts::PcapFlowIndex::FlowId::destinationString() const
+{
+    return toString(destination, destination_port);
+}
+
+
+//----------------------------------------------------------------------------
+// Clear the content of the index.
+//----------------------------------------------------------------------------
+
+void ts::PcapFlowIndex::clear()
+{
+    _flows.clear();
+    _last = _flows.end();
+}
+
+
+//----------------------------------------------------------------------------
+// Add an IP datagram in the index.
+//----------------------------------------------------------------------------
+
+void ts::PcapFlowIndex::addPacket(const IPPacketView& ip, size_t packet_number, MicroSecond timestamp)
+{
+    if (!ip.isValid()) {
+        return;
+    }
+
+    // Locate the flow. Most of the time, consecutive packets belong to the same flow.
+    const FlowId id(ip);
+    if (_last == _flows.end() || !(_last->first == id)) {
+        _last = _flows.insert(std::make_pair(id, FlowStats())).first;
+    }
+
+    // Accumulate statistics.
+    FlowStats& stats(_last->second);
+    if (stats.packet_count++ == 0) {
+        stats.first_packet = packet_number;
+    }
+    stats.last_packet = packet_number;
+    stats.total_ip_size += ip.size();
+    stats.total_data_size += ip.protocolDataSize();
+    if (timestamp >= 0) {
+        if (stats.first_timestamp < 0) {
+            stats.first_timestamp = timestamp;
+        }
+        stats.last_timestamp = timestamp;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build the index of all flows in a capture file.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFlowIndex::build(PcapFile& file, Report& report)
+{
+    clear();
+    if (!file.isOpen()) {
+        report.error(u"no pcap file open");
+        return false;
+    }
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    MicroSecond timestamp = -1;
+    while (file.readIP(data, size, timestamp, report)) {
+        addPacket(IPPacketView(data, size), file.packetCount(), timestamp);
+    }
+    return true;
+}
@@ -0,0 +1,161 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Index of IP flows in a pcap or pcap-ng file.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsIPPacketView.h"
+#include "tsPcapFile.h"
+
+namespace ts {
+    //!
+    //! Index of IP flows in a pcap or pcap-ng file.
+    //! @ingroup net
+    //!
+    //! A flow is made of all IP datagrams from one source socket address to one destination
+    //! socket address using one protocol. IPv4 and IPv6 flows are indexed. The index is built
+    //! in one pass over the capture file. For each flow, it contains statistics and the range
+    //! of packet numbers in the file.
+    //!
+    class TSDUCKDLL PcapFlowIndex
+    {
+        TS_NOCOPY(PcapFlowIndex);
+    public:
+        //!
+        //! Identification of a flow.
+        //!
+        class TSDUCKDLL FlowId
+        {
+        public:
+            uint8_t  version {0};                      //!< IP version, 4 or 6.
+            uint8_t  protocol {0};                     //!< IP protocol (UDP, TCP, etc).
+            uint16_t source_port {0};                  //!< Source port (UDP or TCP only).
+            uint16_t destination_port {0};             //!< Destination port (UDP or TCP only).
+            uint8_t  source[IPv6Address::BYTES] {};       //!< Source IP address, only the first 4 bytes are used with IPv4.
+            uint8_t  destination[IPv6Address::BYTES] {};  //!< Destination IP address, only the first 4 bytes are used with IPv4.
+
+            //!
+            //! Constructor.
+            //! @param [in] ip A valid IP datagram.
+            //!
+            FlowId(const IPPacketView& ip = IPPacketView());
+
+            //!
+            //! Get the source socket address as a string.
+            //! @return The source socket address as a string.
+            //!
+            UString sourceString() const;
+
+            //!
+            //! Get the destination socket address as a string.
+            //! @return The destination socket address as a string.
+            //!
+            UString destinationString() const;
+
+            //!
+            //! Comparison operator for use in containers.
+            //! @param [in] other Another instance to compare.
+            //! @return True if this object is logically less than @a other.
+            //!
+            bool operator<(const FlowId& other) const;
+
+            //!
+            //! Equality operator.
+            //! @param [in] other Another instance to compare.
+            //! @return True if this object is equal to @a other.
+            //!
+            bool operator==(const FlowId& other) const;
+
+        private:
+            // Build an address string.
+            UString toString(const uint8_t* addr, uint16_t port) const;
+        };
+
+        //!
+        //! Description and statistics of a flow.
+        //!
+        class TSDUCKDLL FlowStats
+        {
+        public:
+            FlowStats() = default;                 //!< Constructor.
+            size_t      packet_count {0};          //!< Number of IP datagrams in the flow.
+            size_t      total_ip_size {0};         //!< Total size in bytes of IP datagrams, headers included.
+            size_t      total_data_size {0};       //!< Total data size in bytes (TCP or UDP payload).
+            size_t      first_packet {0};          //!< Number of first packet of the flow in the file (as seen in Wireshark).
+            size_t      last_packet {0};           //!< Number of last packet of the flow in the file.
+            MicroSecond first_timestamp {-1};      //!< Timestamp of first datagram, negative if none found.
+            MicroSecond last_timestamp {-1};       //!< Timestamp of last datagram, negative if none found.
+        };
+
+        //!
+        //! Map of flows, indexed by flow identification.
+        //!
+        typedef std::map<FlowId, FlowStats> FlowMap;
+
+        //!
+        //! Default constructor.
+        //!
+        PcapFlowIndex() = default;
+
+        //!
+        //! Clear the content of the index.
+        //!
+        void clear();
+
+        //!
+        //! Add an IP datagram in the index.
+        //! @param [in] ip A valid IP datagram. Ignored if invalid.
+        //! @param [in] packet_number Packet number in the capture file (as seen in Wireshark).
+        //! @param [in] timestamp Capture timestamp in microseconds since Unix epoch or -1 if none is available.
+        //!
+        void addPacket(const IPPacketView& ip, size_t packet_number, MicroSecond timestamp);
+
+        //!
+        //! Build the index of all flows in a capture file.
+        //! The previous content of the index is cleared.
+        //! @param [in,out] file An open capture file. All IP datagrams are read until end of file.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool build(PcapFile& file, Report& report);
+
+        //!
+        //! Get the indexed flows.
+        //! @return A constant reference to the map of indexed flows.
+        //!
+        const FlowMap& flows() const { return _flows; }
+
+    private:
+        FlowMap           _flows {};
+        FlowMap::iterator _last {_flows.end()};  // Last accessed flow, fast path for bursts of packets in the same flow.
+    };
+}
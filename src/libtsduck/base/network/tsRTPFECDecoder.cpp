@@ -0,0 +1,250 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsRTPFECDecoder.h"
+#include "tsRTPPacketView.h"
+#include "tsIPProtocols.h"
+
+namespace {
+    // Number of media packets to keep. SMPTE 2022-1 limits the FEC matrix to 100 packets (L x D).
+    // A larger history is kept to accept FEC packets which are delayed by the network.
+    constexpr int64_t HISTORY_SIZE = 1024;
+}
+
+
+//----------------------------------------------------------------------------
+// Reset the decoder.
+//----------------------------------------------------------------------------
+
+void ts::RTPFECDecoder::reset()
+{
+    _started = false;
+    _first = _highest = 0;
+    _fec_count = _recovered_count = _unrecoverable_count = 0;
+    _media.clear();
+    _fecs.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Add a received media packet.
+//----------------------------------------------------------------------------
+
+bool ts::RTPFECDecoder::addMedia(const ByteBlockPtr& packet)
+{
+    RTPPacketView rtp;
+    return !packet.isNull() && rtp.reset(packet->data(), packet->size()) && storeMedia(packet, rtp.sequenceNumber());
+}
+
+bool ts::RTPFECDecoder::storeMedia(const ByteBlockPtr& packet, uint16_t seq)
+{
+    int64_t ext = 0;
+    if (_started) {
+        ext = extend(seq);
+    }
+    else {
+        // Start with a large value to avoid negative values when older packets arrive.
+        _started = true;
+        ext = _first = _highest = (int64_t(1) << 32) + seq;
+    }
+
+    // A large jump in sequence numbers is a discontinuity, probably a restart of the sender.
+    // All previous packets are useless.
+    if (ext > _highest + HISTORY_SIZE || ext < _highest - HISTORY_SIZE) {
+        _media.clear();
+        _fecs.clear();
+        _first = _highest = ext;
+    }
+
+    if (_media.find(ext) != _media.end()) {
+        return false;
+    }
+    _media[ext] = packet;
+
+    // Drop packets which are too old.
+    if (ext > _highest) {
+        _highest = ext;
+        while (!_media.empty() && _media.begin()->first < _highest - HISTORY_SIZE) {
+            _media.erase(_media.begin());
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Add a received FEC packet.
+//----------------------------------------------------------------------------
+
+bool ts::RTPFECDecoder::addFEC(const ByteBlockPtr& packet)
+{
+    RTPPacketView rtp;
+    if (packet.isNull() || !rtp.reset(packet->data(), packet->size()) || rtp.payloadSize() < RTP_FEC_HEADER_SIZE) {
+        return false;
+    }
+
+    // FEC header: SNBase low bits (16), length recovery (16), E (1), PT recovery (7), mask (24),
+    // TS recovery (32), X (1), D (1), type (3), index (3), offset (8), NA (8), SNBase ext bits (8).
+    // The only supported FEC type is XOR (type 0), without extension (X = 0).
+    const uint8_t* fh = rtp.payload();
+    FEC fec;
+    fec.packet = packet;
+    fec.base = GetUInt16(fh);
+    fec.offset = fh[13];
+    fec.count = fh[14];
+    if ((fh[12] & 0xB8) != 0 || fec.offset == 0 || fec.count == 0) {
+        return false;
+    }
+    _fec_count++;
+    _fecs.push_back(fec);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Rebuild all missing media packets which can be recovered.
+//----------------------------------------------------------------------------
+
+size_t ts::RTPFECDecoder::recover(std::vector<ByteBlockPtr>& recovered)
+{
+    size_t result = 0;
+
+    // Iterate while some packets are rebuilt because they may complete other columns or rows.
+    bool progress = _started;
+    while (progress) {
+        progress = false;
+        for (auto it = _fecs.begin(); it != _fecs.end(); ) {
+
+            // Locate the missing packets in this column or row.
+            const int64_t first = extend(it->base);
+            const int64_t last = first + int64_t(it->offset) * (it->count - 1);
+            size_t missing_count = 0;
+            int64_t missing = 0;
+            for (int64_t seq = first; seq <= last; seq += it->offset) {
+                if (_media.find(seq) == _media.end()) {
+                    missing_count++;
+                    missing = seq;
+                }
+            }
+
+            bool drop = false;
+            if (missing_count == 0 || first < _first) {
+                // Nothing to recover or protected packets were sent before the start of reception.
+                drop = true;
+            }
+            else if (first < _highest - HISTORY_SIZE) {
+                // Too old, several packets are still missing.
+                drop = true;
+                _unrecoverable_count++;
+            }
+            else if (missing_count == 1 && missing <= _highest) {
+                // Exactly one packet is missing and it should have been received.
+                drop = true;
+                const ByteBlockPtr packet(rebuild(*it, missing));
+                if (!packet.isNull() && storeMedia(packet, uint16_t(missing))) {
+                    recovered.push_back(packet);
+                    _recovered_count++;
+                    result++;
+                    progress = true;
+                }
+            }
+
+            if (drop) {
+                it = _fecs.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+    return result;
+}
+
+
+//----------------------------------------------------------------------------
+// Rebuild the missing media packet of a FEC packet.
+//----------------------------------------------------------------------------
+
+ts::ByteBlockPtr ts::RTPFECDecoder::rebuild(const FEC& fec, int64_t missing)
+{
+    // The FEC packet was already validated.
+    const RTPPacketView frtp(fec.packet->data(), fec.packet->size());
+    const uint8_t* const fh = frtp.payload();
+    const uint8_t* const fdata = fh + RTP_FEC_HEADER_SIZE;
+    const size_t fsize = frtp.payloadSize() - RTP_FEC_HEADER_SIZE;
+
+    // XOR of all protected packets, except the missing one. As specified in RFC 2733, the protected
+    // area is everything after the 12-byte fixed RTP header. The P, X, CC and M bits are recovered
+    // from the RTP header of the FEC packet, the length, payload type and timestamp from the FEC header.
+    ByteBlock payload(fsize, 0);
+    uint8_t byte0 = fec.packet->data()[0];
+    uint8_t byte1 = fec.packet->data()[1] & 0x80;
+    uint8_t pt = fh[4] & 0x7F;
+    uint16_t length = GetUInt16(fh + 2);
+    uint32_t timestamp = GetUInt32(fh + 8);
+    uint32_t ssrc = 0;
+
+    const int64_t first = extend(fec.base);
+    for (size_t i = 0; i < fec.count; ++i) {
+        const int64_t seq = first + int64_t(i) * fec.offset;
+        if (seq != missing) {
+            const ByteBlock& media(*_media[seq]);
+            const size_t msize = media.size() - RTP_HEADER_SIZE;
+            if (msize > fsize) {
+                // Invalid FEC packet, shorter than a protected packet.
+                return ByteBlockPtr();
+            }
+            byte0 ^= media[0];
+            byte1 ^= media[1];
+            length ^= uint16_t(msize);
+            timestamp ^= GetUInt32(media.data() + 4);
+            ssrc = GetUInt32(media.data() + 8);
+            for (size_t n = 0; n < msize; ++n) {
+                payload[n] ^= media[RTP_HEADER_SIZE + n];
+            }
+        }
+    }
+    pt ^= byte1 & 0x7F;
+    if (length > fsize) {
+        return ByteBlockPtr();
+    }
+
+    // Build the recovered packet.
+    ByteBlockPtr packet(new ByteBlock(RTP_HEADER_SIZE + length));
+    uint8_t* const data = packet->data();
+    data[0] = uint8_t(RTP_VERSION << 6) | (byte0 & 0x3F);
+    data[1] = (byte1 & 0x80) | pt;
+    PutUInt16(data + 2, uint16_t(missing));
+    PutUInt32(data + 4, timestamp);
+    PutUInt32(data + 8, ssrc);
+    for (size_t n = 0; n < length; ++n) {
+        data[RTP_HEADER_SIZE + n] = payload[n] ^ fdata[n];
+    }
+    return packet;
+}
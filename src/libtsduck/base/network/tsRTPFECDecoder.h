@@ -0,0 +1,138 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  SMPTE 2022-1 FEC decoder for RTP streams.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsByteBlock.h"
+
+namespace ts {
+    //!
+    //! SMPTE 2022-1 FEC decoder for RTP streams.
+    //! @ingroup net
+    //!
+    //! SMPTE 2022-1 defines a two-dimensional FEC scheme for RTP streams, based on the
+    //! XOR parity of RFC 2733. The media packets are logically arranged in a matrix of
+    //! L columns and D rows. One column FEC packet protects the D packets of a column
+    //! and one optional row FEC packet protects the L packets of a row. The column FEC
+    //! packets are usually sent on the media UDP port plus 2 and the row FEC packets
+    //! on the media UDP port plus 4.
+    //!
+    //! When exactly one packet is missing in a column or a row, it is rebuilt from the
+    //! FEC packet and the other packets. Since a rebuilt packet may complete another
+    //! column or row, the recovery is iterated. This class does not depend on the
+    //! order of arrival of media and FEC packets.
+    //!
+    class TSDUCKDLL RTPFECDecoder
+    {
+    public:
+        //!
+        //! Default constructor.
+        //!
+        RTPFECDecoder() = default;
+
+        //!
+        //! Reset the decoder, drop all packets and reset statistics.
+        //!
+        void reset();
+
+        //!
+        //! Add a received media packet.
+        //! The last media packets are kept to recover missing packets later.
+        //! @param [in] packet The RTP media packet. The decoder keeps a reference to the packet, the content is not copied.
+        //! @return True if the packet is stored, false if the packet is not a valid RTP packet or is already known.
+        //!
+        bool addMedia(const ByteBlockPtr& packet);
+
+        //!
+        //! Add a received FEC packet, from the column or the row FEC stream.
+        //! @param [in] packet The RTP FEC packet. The decoder keeps a reference to the packet, the content is not copied.
+        //! @return True if the packet is a valid SMPTE 2022-1 FEC packet, false otherwise.
+        //!
+        bool addFEC(const ByteBlockPtr& packet);
+
+        //!
+        //! Rebuild all missing media packets which can be recovered from the received FEC packets.
+        //! @param [in,out] recovered The rebuilt RTP media packets are appended to this vector.
+        //! They are also stored in the decoder as if they were received with addMedia().
+        //! @return The number of rebuilt packets.
+        //!
+        size_t recover(std::vector<ByteBlockPtr>& recovered);
+
+        //!
+        //! Get the number of valid FEC packets which were received.
+        //! @return The number of received FEC packets.
+        //!
+        uint64_t fecCount() const { return _fec_count; }
+
+        //!
+        //! Get the number of media packets which were rebuilt.
+        //! @return The number of recovered packets.
+        //!
+        uint64_t recoveredCount() const { return _recovered_count; }
+
+        //!
+        //! Get the number of FEC packets which were dropped while several of their media packets were still missing.
+        //! @return The number of unused FEC packets.
+        //!
+        uint64_t unrecoverableCount() const { return _unrecoverable_count; }
+
+    private:
+        // Description of a received FEC packet.
+        class FEC
+        {
+        public:
+            ByteBlockPtr packet {};    // The complete FEC packet.
+            uint16_t     base {0};     // First protected sequence number.
+            uint8_t      offset {0};   // Distance between protected sequence numbers.
+            uint8_t      count {0};    // Number of protected sequence numbers.
+        };
+
+        bool        _started {false};              // At least one media packet was received.
+        int64_t     _first {0};                    // Extended sequence number of first media packet.
+        int64_t     _highest {0};                  // Highest extended sequence number of media packets.
+        uint64_t    _fec_count {0};
+        uint64_t    _recovered_count {0};
+        uint64_t    _unrecoverable_count {0};
+        std::map<int64_t, ByteBlockPtr> _media {}; // Last media packets, indexed by extended sequence number.
+        std::list<FEC> _fecs {};                   // FEC packets which may be used later.
+
+        // Compute the extended sequence number of a media packet.
+        int64_t extend(uint16_t seq) const { return _highest + int16_t(uint16_t(seq - uint16_t(_highest))); }
+
+        // Store a media packet with its extended sequence number, drop old packets.
+        bool storeMedia(const ByteBlockPtr& packet, uint16_t seq);
+
+        // Rebuild the missing media packet of a FEC packet.
+        ByteBlockPtr rebuild(const FEC& fec, int64_t missing);
+    };
+}
@@ -0,0 +1,282 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsRTPHitlessMerger.h"
+#include "tsRTPPacketView.h"
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::RTPHitlessMerger::MAX_LEGS;
+#endif
+
+namespace {
+    // A jump in sequence numbers which is larger than this, forward or backward, is a possible discontinuity
+    // in the stream. The difference of delay between the legs shall be smaller than this number of packets.
+    constexpr int64_t MAX_DROPOUT = 3000;
+}
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::RTPHitlessMerger::RTPHitlessMerger(size_t legs, MilliSecond window)
+{
+    setLegs(legs);
+    setWindow(window);
+}
+
+
+//----------------------------------------------------------------------------
+// Set the parameters.
+//----------------------------------------------------------------------------
+
+void ts::RTPHitlessMerger::setLegs(size_t legs)
+{
+    _legs.resize(std::max<size_t>(1, std::min(legs, MAX_LEGS)));
+    reset();
+}
+
+void ts::RTPHitlessMerger::setWindow(MilliSecond window)
+{
+    _window = MicroSecPerMilliSec * std::max<MilliSecond>(window, 0);
+    _output.setLatency(window);
+}
+
+
+//----------------------------------------------------------------------------
+// Reset the merger.
+//----------------------------------------------------------------------------
+
+void ts::RTPHitlessMerger::reset()
+{
+    _started = _ended_valid = false;
+    _highest = _ended = 0;
+    _epoch = 0;
+    _restart_time = 0;
+    _repaired = 0;
+    for (auto& leg : _legs) {
+        leg = Leg();
+    }
+    _entries.clear();
+    _output.reset();
+}
+
+
+//----------------------------------------------------------------------------
+// Restart from a new sequence number.
+//----------------------------------------------------------------------------
+
+void ts::RTPHitlessMerger::restart(uint16_t seq, MicroSecond arrival)
+{
+    // On a restart of the sender, the discontinuity is already confirmed, the output buffer
+    // shall follow it immediately. Start a new epoch to recognize the packets of the previous
+    // sequence which still arrive on the other legs.
+    if (_started) {
+        _output.resynchronize();
+        _epoch++;
+        _restart_time = arrival;
+    }
+
+    // Start with a large value to avoid negative values when older packets arrive.
+    _started = true;
+    _ended_valid = false;
+    _highest = (int64_t(1) << 32) + seq;
+    _entries.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Drop the held packet out of the sequence range on a leg, if any.
+//----------------------------------------------------------------------------
+
+void ts::RTPHitlessMerger::dropHeldPacket(Leg& leg)
+{
+    if (leg.bad_valid) {
+        leg.bad_valid = false;
+        leg.bad_packet.clear();
+        leg.late++;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Close the time window of all sequence numbers which are too old.
+//----------------------------------------------------------------------------
+
+void ts::RTPHitlessMerger::endWindow(MicroSecond now)
+{
+    const uint32_t all_legs = uint32_t((uint64_t(1) << _legs.size()) - 1);
+
+    while (!_entries.empty() && _entries.begin()->second.arrival + _window <= now) {
+        const auto it = _entries.begin();
+
+        // Sequence numbers before this one were never received on any leg.
+        if (_ended_valid && it->first > _ended) {
+            for (auto& leg : _legs) {
+                leg.lost += it->first - _ended;
+            }
+        }
+
+        // Count the packet as lost on all legs where it was not received.
+        if (it->second.legs != all_legs) {
+            _repaired++;
+            for (size_t i = 0; i < _legs.size(); ++i) {
+                if ((it->second.legs & (uint32_t(1) << i)) == 0) {
+                    _legs[i].lost++;
+                }
+            }
+        }
+
+        _ended_valid = true;
+        _ended = it->first + 1;
+        _entries.erase(it);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Add a packet which was received on one leg.
+//----------------------------------------------------------------------------
+
+bool ts::RTPHitlessMerger::add(size_t leg_index, const ByteBlockPtr& packet, MicroSecond arrival, MicroSecond timestamp)
+{
+    RTPPacketView rtp;
+    if (leg_index >= _legs.size() || packet.isNull() || !rtp.reset(packet->data(), packet->size())) {
+        return false;
+    }
+    Leg& leg(_legs[leg_index]);
+    leg.received++;
+    endWindow(arrival);
+
+    const uint16_t seq = rtp.sequenceNumber();
+    if (!_started) {
+        restart(seq, arrival);
+        leg.epoch = _epoch;
+        return store(leg_index, _highest, packet, arrival, timestamp);
+    }
+
+    // Compute the extended sequence number, the closest one to the highest received sequence.
+    const int64_t ext = _highest + int16_t(uint16_t(seq - uint16_t(_highest)));
+    if (ext <= _highest + MAX_DROPOUT && ext >= _highest - MAX_DROPOUT) {
+        // In sequence. A packet which was held on this leg is not confirmed.
+        dropHeldPacket(leg);
+        leg.epoch = _epoch;
+        return store(leg_index, ext, packet, arrival, timestamp);
+    }
+
+    // After a restart, the legs with a longer delay still receive the end of the previous sequence
+    // during one time window. These packets are late, they shall not restart the merger again.
+    if (leg.epoch != _epoch && arrival < _restart_time + _window) {
+        leg.late++;
+        return false;
+    }
+
+    // Possible discontinuity, probably a restart of the sender. Hold the packet until the next
+    // packet on the same leg confirms the new sequence (see RFC 3550, appendix A.1).
+    if (!leg.bad_valid || seq != leg.bad_seq) {
+        dropHeldPacket(leg);
+        leg.bad_valid = true;
+        leg.bad_seq = uint16_t(seq + 1);
+        leg.bad_packet = packet;
+        leg.bad_arrival = arrival;
+        leg.bad_timestamp = timestamp;
+        return true;
+    }
+
+    // Confirmed restart of the sender. The held packet starts the new sequence.
+    const ByteBlockPtr first_packet(leg.bad_packet);
+    leg.bad_valid = false;
+    leg.bad_packet.clear();
+    restart(uint16_t(seq - 1), arrival);
+    const int64_t first = _highest;
+    leg.epoch = _epoch;
+    store(leg_index, first, first_packet, leg.bad_arrival, leg.bad_timestamp);
+    const bool stored = store(leg_index, first + 1, packet, arrival, timestamp);
+
+    // The same restart may have been seen on other legs, with a packet which is still held.
+    for (size_t i = 0; i < _legs.size(); ++i) {
+        Leg& other(_legs[i]);
+        if (other.bad_valid) {
+            const int64_t other_ext = first + int16_t(uint16_t(uint16_t(other.bad_seq - 1) - uint16_t(first)));
+            if (other_ext <= first + MAX_DROPOUT && other_ext >= first - MAX_DROPOUT) {
+                other.bad_valid = false;
+                other.epoch = _epoch;
+                store(i, other_ext, other.bad_packet, other.bad_arrival, other.bad_timestamp);
+                other.bad_packet.clear();
+            }
+            else {
+                dropHeldPacket(other);
+            }
+        }
+    }
+    return stored;
+}
+
+
+//----------------------------------------------------------------------------
+// Store a packet in sequence.
+//----------------------------------------------------------------------------
+
+bool ts::RTPHitlessMerger::store(size_t leg_index, int64_t ext, const ByteBlockPtr& packet, MicroSecond arrival, MicroSecond timestamp)
+{
+    Leg& leg(_legs[leg_index]);
+
+    // Filter packets which arrive after their time window.
+    if (_ended_valid && ext < _ended) {
+        leg.late++;
+        return false;
+    }
+
+    // Filter packets which were already received on another leg.
+    const uint32_t mask = uint32_t(1) << leg_index;
+    const auto it = _entries.find(ext);
+    if (it != _entries.end()) {
+        it->second.legs |= mask;
+        return false;
+    }
+
+    // First copy of this packet.
+    Entry& entry(_entries[ext]);
+    entry.arrival = arrival;
+    entry.legs = mask;
+    _highest = std::max(_highest, ext);
+    leg.used++;
+    return _output.add(packet, arrival, timestamp);
+}
+
+
+//----------------------------------------------------------------------------
+// Get the next packet of the merged stream.
+//----------------------------------------------------------------------------
+
+bool ts::RTPHitlessMerger::get(ByteBlockPtr& packet, MicroSecond& timestamp, MicroSecond now)
+{
+    endWindow(now);
+    return _output.get(packet, timestamp, now);
+}
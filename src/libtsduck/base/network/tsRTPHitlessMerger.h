@@ -0,0 +1,223 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Hitless merge of redundant RTP streams (SMPTE 2022-7).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsRTPJitterBuffer.h"
+
+namespace ts {
+    //!
+    //! Hitless merge of redundant RTP streams (SMPTE 2022-7 seamless protection switching).
+    //! @ingroup net
+    //!
+    //! The same RTP stream is received over several network paths, the "legs". Each RTP packet
+    //! is returned once, from the first leg where it arrives. Packets which are lost on one leg
+    //! are transparently replaced by the same packets from the other legs. The merged stream is
+    //! reordered according to the RTP sequence numbers, see RTPJitterBuffer.
+    //!
+    //! The time window is the maximum difference of delay between the legs. A packet which
+    //! arrives on a leg after the end of the time window of its sequence number is discarded.
+    //! At the end of the time window of a sequence number, the packet is counted as lost on
+    //! all legs where it was not received.
+    //!
+    //! A restart of the sender is detected on one leg when two consecutive packets confirm a
+    //! jump in the sequence numbers. The packet which starts the jump is held until confirmed.
+    //! After a restart, during one time window, the packets of the previous sequence which
+    //! still arrive on the legs with a longer delay are discarded as late. Otherwise, they
+    //! would be considered as another restart of the sender.
+    //!
+    //! This class does not use any clock. All times are provided by the application in
+    //! microseconds, from an arbitrary origin.
+    //!
+    class TSDUCKDLL RTPHitlessMerger
+    {
+    public:
+        //!
+        //! Maximum number of legs.
+        //!
+        static constexpr size_t MAX_LEGS = 32;
+
+        //!
+        //! Constructor.
+        //! @param [in] legs Number of legs, from 1 to MAX_LEGS.
+        //! @param [in] window Maximum difference of delay in milliseconds between the legs.
+        //!
+        explicit RTPHitlessMerger(size_t legs = 2, MilliSecond window = 0);
+
+        //!
+        //! Set the number of legs. The merger is reset.
+        //! @param [in] legs Number of legs, from 1 to MAX_LEGS.
+        //!
+        void setLegs(size_t legs);
+
+        //!
+        //! Get the number of legs.
+        //! @return The number of legs.
+        //!
+        size_t legs() const { return _legs.size(); }
+
+        //!
+        //! Set the time window of the merger.
+        //! @param [in] window Maximum difference of delay in milliseconds between the legs.
+        //!
+        void setWindow(MilliSecond window);
+
+        //!
+        //! Get the time window of the merger.
+        //! @return The maximum difference of delay in milliseconds between the legs.
+        //!
+        MilliSecond window() const { return _window / MicroSecPerMilliSec; }
+
+        //!
+        //! Reset the merger, drop all packets and reset statistics.
+        //!
+        void reset();
+
+        //!
+        //! Add a packet which was received on one leg.
+        //! @param [in] leg Index of the leg, from 0 to legs() - 1.
+        //! @param [in] packet The RTP packet. The merger keeps a reference to the packet, the content is not copied.
+        //! @param [in] arrival Arrival time of the packet in microseconds.
+        //! @param [in] timestamp Time stamp to return with the packet.
+        //! @return True if the packet is stored, false if the packet is not a valid RTP packet,
+        //! was already received on another leg or arrives too late.
+        //!
+        bool add(size_t leg, const ByteBlockPtr& packet, MicroSecond arrival, MicroSecond timestamp = -1);
+
+        //!
+        //! Get the next packet of the merged stream.
+        //! @param [out] packet The next RTP packet.
+        //! @param [out] timestamp Time stamp which was associated to the packet.
+        //! @param [in] now Current time in microseconds.
+        //! @return True if a packet is returned, false if no packet is ready at this time.
+        //!
+        bool get(ByteBlockPtr& packet, MicroSecond& timestamp, MicroSecond now);
+
+        //!
+        //! Get the time at which the next packet will be ready.
+        //! @return The time in microseconds at which get() will return a packet. Return -1 when
+        //! no packet is waiting. When a packet is already ready, the returned value is in the past.
+        //!
+        MicroSecond nextDeadline() const { return _output.nextDeadline(); }
+
+        //!
+        //! Get the number of valid RTP packets which were received on a leg.
+        //! @param [in] leg Index of the leg.
+        //! @return The number of received packets, including duplicates and late packets.
+        //!
+        uint64_t receivedCount(size_t leg) const { return leg < _legs.size() ? _legs[leg].received : 0; }
+
+        //!
+        //! Get the number of packets which were first received on a leg and used in the merged stream.
+        //! @param [in] leg Index of the leg.
+        //! @return The number of used packets.
+        //!
+        uint64_t usedCount(size_t leg) const { return leg < _legs.size() ? _legs[leg].used : 0; }
+
+        //!
+        //! Get the number of packets which were discarded on a leg because they arrived after the end
+        //! of their time window or were out of sequence.
+        //! @param [in] leg Index of the leg.
+        //! @return The number of late packets.
+        //!
+        uint64_t lateCount(size_t leg) const { return leg < _legs.size() ? _legs[leg].late : 0; }
+
+        //!
+        //! Get the number of packets which were not received on a leg before the end of their time window.
+        //! @param [in] leg Index of the leg.
+        //! @return The number of lost packets on this leg.
+        //!
+        uint64_t lostCount(size_t leg) const { return leg < _legs.size() ? _legs[leg].lost : 0; }
+
+        //!
+        //! Get the number of packets which were lost on some legs and received on others.
+        //! @return The number of packets which were repaired in the merged stream.
+        //!
+        uint64_t repairedCount() const { return _repaired; }
+
+        //!
+        //! Get the number of packets which are missing in the merged stream.
+        //! @return The number of packets which were lost on all legs.
+        //!
+        uint64_t lostCount() const { return _output.lostCount(); }
+
+    private:
+        // Description of a leg.
+        class Leg
+        {
+        public:
+            bool         bad_valid {false};   // A packet out of the sequence range is held in bad_packet.
+            uint16_t     bad_seq {0};         // Next expected sequence number after a possible discontinuity.
+            ByteBlockPtr bad_packet {};       // Held packet, out of the sequence range.
+            MicroSecond  bad_arrival {0};     // Arrival time of the held packet.
+            MicroSecond  bad_timestamp {-1};  // Time stamp of the held packet.
+            uint32_t     epoch {0};           // Restart epoch of the last packet in sequence on this leg.
+            uint64_t     received {0};
+            uint64_t     used {0};
+            uint64_t     late {0};
+            uint64_t     lost {0};
+        };
+
+        // Description of a sequence number in the time window.
+        class Entry
+        {
+        public:
+            MicroSecond arrival {0};  // Arrival time of the first copy.
+            uint32_t    legs {0};     // Bit mask of legs where the packet was received.
+        };
+
+        MicroSecond      _window {0};           // Time window in microseconds.
+        bool             _started {false};      // At least one packet was received.
+        bool             _ended_valid {false};  // The field _ended is valid.
+        int64_t          _highest {0};          // Highest extended sequence number which was received.
+        int64_t          _ended {0};            // All extended sequence numbers before this one are out of their window.
+        uint32_t         _epoch {0};            // Restart epoch, incremented on each restart of the sender.
+        MicroSecond      _restart_time {0};     // Arrival time of the packet which confirmed the last restart.
+        uint64_t         _repaired {0};
+        std::vector<Leg> _legs {};              // Description of all legs.
+        RTPJitterBuffer  _output {};            // Reordering buffer of the merged stream.
+        std::map<int64_t, Entry> _entries {};   // Sequence numbers in their time window, indexed by extended sequence number.
+
+        // Close the time window of all sequence numbers which are too old.
+        void endWindow(MicroSecond now);
+
+        // Restart from a new sequence number.
+        void restart(uint16_t seq, MicroSecond arrival);
+
+        // Store a packet in sequence, unless already received on another leg or too late.
+        bool store(size_t leg_index, int64_t ext, const ByteBlockPtr& packet, MicroSecond arrival, MicroSecond timestamp);
+
+        // Drop the held packet out of the sequence range on a leg, if any.
+        void dropHeldPacket(Leg& leg);
+    };
+}
@@ -0,0 +1,203 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsRTPJitterBuffer.h"
+#include "tsRTPPacketView.h"
+
+namespace {
+    // Sequence number jumps which are considered as a discontinuity in the stream (see RFC 3550, appendix A.1).
+    constexpr int64_t MAX_DROPOUT = 3000;
+    constexpr int64_t MAX_MISORDER = 100;
+}
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::RTPJitterBuffer::RTPJitterBuffer(MilliSecond latency)
+{
+    setLatency(latency);
+}
+
+
+//----------------------------------------------------------------------------
+// Reset the buffer.
+//----------------------------------------------------------------------------
+
+void ts::RTPJitterBuffer::reset()
+{
+    _started = _next_valid = _bad_valid = _resync = false;
+    _next = _highest = 0;
+    _seq_delta = _bad_seq = 0;
+    _first_arrival = 0;
+    _received = _reordered = _duplicates = _late = _lost = 0;
+    _bad = Entry();
+    _packets.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Drop the held packet out of the sequence range, if any.
+//----------------------------------------------------------------------------
+
+void ts::RTPJitterBuffer::dropHeldPacket()
+{
+    if (_bad_valid) {
+        _bad_valid = false;
+        _bad = Entry();
+        _late++;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Add a received packet in the buffer.
+//----------------------------------------------------------------------------
+
+bool ts::RTPJitterBuffer::add(const ByteBlockPtr& packet, MicroSecond arrival, MicroSecond timestamp)
+{
+    RTPPacketView rtp;
+    if (packet.isNull() || !rtp.reset(packet->data(), packet->size())) {
+        return false;
+    }
+    _received++;
+
+    // Compute the extended sequence number, the closest one to the highest received sequence.
+    const uint16_t rtp_seq = rtp.sequenceNumber();
+    const uint16_t seq = uint16_t(rtp_seq + _seq_delta);
+    int64_t ext = 0;
+    if (!_started) {
+        // Start with a large value to avoid negative values when older packets arrive.
+        _started = true;
+        _first_arrival = arrival;
+        ext = _highest = (int64_t(1) << 32) + seq;
+    }
+    else {
+        ext = _highest + int16_t(uint16_t(seq - uint16_t(_highest)));
+        if (ext > _highest + MAX_DROPOUT || (_next_valid && ext < _next - MAX_MISORDER)) {
+            // Possible discontinuity, probably a restart of the sender. Resynchronize only when
+            // the next packet confirms the new sequence (see RFC 3550, appendix A.1).
+            if (_bad_valid && rtp_seq == _bad_seq) {
+                // Confirmed restart. The held packet starts the new sequence, right after the highest received packet.
+                _highest++;
+                _packets[_highest] = _bad;
+                _bad_valid = false;
+                _bad = Entry();
+            }
+            else if (!_resync) {
+                // Hold the packet until the next one. A previously held packet was not confirmed, drop it.
+                dropHeldPacket();
+                _bad_valid = true;
+                _bad_seq = uint16_t(rtp_seq + 1);
+                _bad.packet = packet;
+                _bad.arrival = arrival;
+                _bad.timestamp = timestamp;
+                return true;
+            }
+            // Renumber the new sequence right after the highest received packet.
+            _seq_delta = uint16_t(_seq_delta + uint16_t(uint16_t(_highest) + 1 - seq));
+            ext = _highest + 1;
+        }
+    }
+    dropHeldPacket();
+    _resync = false;
+
+    // Filter late and duplicated packets.
+    if (_next_valid && ext < _next) {
+        _late++;
+        return false;
+    }
+    if (_packets.find(ext) != _packets.end()) {
+        _duplicates++;
+        return false;
+    }
+    if (ext < _highest) {
+        _reordered++;
+    }
+    else {
+        _highest = ext;
+    }
+
+    Entry& entry(_packets[ext]);
+    entry.packet = packet;
+    entry.arrival = arrival;
+    entry.timestamp = timestamp;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the time at which the next packet will be ready.
+//----------------------------------------------------------------------------
+
+ts::MicroSecond ts::RTPJitterBuffer::nextDeadline() const
+{
+    if (_packets.empty()) {
+        return -1;
+    }
+    else if (!_next_valid) {
+        // Initially, wait for the latency to let packets with lower sequence numbers arrive.
+        return _first_arrival + _latency;
+    }
+    else if (_packets.begin()->first == _next) {
+        // Next packet is already here, no need to wait.
+        return _packets.begin()->second.arrival;
+    }
+    else {
+        // Some packets are missing, wait for them until the first present one has been held long enough.
+        return _packets.begin()->second.arrival + _latency;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the next packet in sequence.
+//----------------------------------------------------------------------------
+
+bool ts::RTPJitterBuffer::get(ByteBlockPtr& packet, MicroSecond& timestamp, MicroSecond now)
+{
+    const MicroSecond deadline = nextDeadline();
+    if (deadline < 0 || now < deadline) {
+        return false;
+    }
+
+    const auto it = _packets.begin();
+    if (!_next_valid) {
+        _next_valid = true;
+    }
+    else if (it->first > _next) {
+        _lost += it->first - _next;
+    }
+    _next = it->first + 1;
+    packet = it->second.packet;
+    timestamp = it->second.timestamp;
+    _packets.erase(it);
+    return true;
+}
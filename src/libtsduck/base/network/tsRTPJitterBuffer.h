@@ -0,0 +1,189 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Reordering and jitter buffer for RTP packets.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsByteBlock.h"
+
+namespace ts {
+    //!
+    //! Reordering and jitter buffer for RTP packets.
+    //! @ingroup net
+    //!
+    //! RTP packets are returned in the order of their sequence numbers. Duplicated packets
+    //! and packets which arrive after their position in the sequence was already returned
+    //! are discarded.
+    //!
+    //! Packets which immediately follow the previously returned one are returned immediately.
+    //! When a packet is missing, the following packets are held until the missing one arrives
+    //! (from the network or from FEC recovery) or until a packet has been held for the
+    //! configured latency. In the latter case, the missing packets are declared lost and
+    //! the sequence resumes after them.
+    //!
+    //! A large jump in the sequence numbers is considered as a restart of the sender only when
+    //! the next packet confirms the new sequence (see RFC 3550, appendix A.1). Until then, the
+    //! packet which started the jump is held. It starts the new sequence when the restart is
+    //! confirmed. Otherwise, it is discarded and counted as late.
+    //!
+    //! This class does not use any clock. All times are provided by the application in
+    //! microseconds, from an arbitrary origin. Time stamps are opaque values which are
+    //! associated with each packet and returned with it.
+    //!
+    class TSDUCKDLL RTPJitterBuffer
+    {
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] latency Maximum time in milliseconds to hold a packet while waiting for a missing one.
+        //!
+        explicit RTPJitterBuffer(MilliSecond latency = 0);
+
+        //!
+        //! Set the latency of the buffer.
+        //! @param [in] latency Maximum time in milliseconds to hold a packet while waiting for a missing one.
+        //!
+        void setLatency(MilliSecond latency) { _latency = MicroSecPerMilliSec * std::max<MilliSecond>(latency, 0); }
+
+        //!
+        //! Get the latency of the buffer.
+        //! @return The maximum time in milliseconds to hold a packet while waiting for a missing one.
+        //!
+        MilliSecond latency() const { return _latency / MicroSecPerMilliSec; }
+
+        //!
+        //! Reset the buffer, drop all packets and reset statistics.
+        //!
+        void reset();
+
+        //!
+        //! Add a received packet in the buffer.
+        //! @param [in] packet The RTP packet. The buffer keeps a reference to the packet, the content is not copied.
+        //! @param [in] arrival Arrival time of the packet in microseconds.
+        //! @param [in] timestamp Time stamp to return with the packet.
+        //! @return True if the packet is stored, false if the packet is not a valid RTP packet,
+        //! is a duplicate or arrives too late. A packet which starts a jump in the sequence
+        //! numbers is held until confirmed and true is returned.
+        //!
+        bool add(const ByteBlockPtr& packet, MicroSecond arrival, MicroSecond timestamp = -1);
+
+        //!
+        //! Accept a discontinuity in the sequence numbers on the next added packet, without confirmation.
+        //! This is typically used when the application has already confirmed a restart of the sender.
+        //!
+        void resynchronize() { _resync = true; }
+
+        //!
+        //! Get the next packet in sequence.
+        //! @param [out] packet The next RTP packet.
+        //! @param [out] timestamp Time stamp which was associated to the packet.
+        //! @param [in] now Current time in microseconds.
+        //! @return True if a packet is returned, false if no packet is ready at this time.
+        //!
+        bool get(ByteBlockPtr& packet, MicroSecond& timestamp, MicroSecond now);
+
+        //!
+        //! Get the time at which the next packet will be ready.
+        //! @return The time in microseconds at which get() will return a packet, even when some packets are
+        //! still missing. Return -1 when the buffer is empty. When a packet is already ready, the returned
+        //! value is in the past.
+        //!
+        MicroSecond nextDeadline() const;
+
+        //!
+        //! Get the number of packets in the buffer.
+        //! @return The number of packets in the buffer.
+        //!
+        size_t size() const { return _packets.size(); }
+
+        //!
+        //! Get the number of valid RTP packets which were added, including duplicates and late packets.
+        //! @return The number of received packets.
+        //!
+        uint64_t receivedCount() const { return _received; }
+
+        //!
+        //! Get the number of packets which were received out of order and reordered.
+        //! @return The number of reordered packets.
+        //!
+        uint64_t reorderedCount() const { return _reordered; }
+
+        //!
+        //! Get the number of duplicated packets which were discarded.
+        //! @return The number of duplicated packets.
+        //!
+        uint64_t duplicateCount() const { return _duplicates; }
+
+        //!
+        //! Get the number of packets which arrived after their position in the sequence was returned.
+        //! @return The number of late packets.
+        //!
+        uint64_t lateCount() const { return _late; }
+
+        //!
+        //! Get the number of packets which never arrived before the latency expired.
+        //! @return The number of lost packets.
+        //!
+        uint64_t lostCount() const { return _lost; }
+
+    private:
+        // Description of a stored packet.
+        class Entry
+        {
+        public:
+            ByteBlockPtr packet {};
+            MicroSecond  arrival {0};
+            MicroSecond  timestamp {-1};
+        };
+
+        MicroSecond _latency {0};         // Maximum holding time in microseconds.
+        bool        _started {false};     // At least one packet was received.
+        bool        _next_valid {false};  // The sequence number of the next packet to return is known.
+        int64_t     _next {0};            // Extended sequence number of next packet to return.
+        int64_t     _highest {0};         // Highest extended sequence number which was received.
+        uint16_t    _seq_delta {0};       // Value to add to RTP sequence numbers, after a discontinuity.
+        bool        _bad_valid {false};   // A packet out of the sequence range is held in _bad.
+        uint16_t    _bad_seq {0};         // RTP sequence number which confirms a discontinuity.
+        Entry       _bad {};              // Held packet, out of the sequence range.
+        bool        _resync {false};      // Accept a discontinuity on next packet without confirmation.
+        MicroSecond _first_arrival {0};   // Arrival time of first packet.
+        uint64_t    _received {0};
+        uint64_t    _reordered {0};
+        uint64_t    _duplicates {0};
+        uint64_t    _late {0};
+        uint64_t    _lost {0};
+        std::map<int64_t, Entry> _packets {};  // Stored packets, indexed by extended sequence number.
+
+        // Drop the held packet out of the sequence range, if any.
+        void dropHeldPacket();
+    };
+}
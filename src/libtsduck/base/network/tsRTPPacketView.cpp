@@ -0,0 +1,86 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsRTPPacketView.h"
+
+
+//----------------------------------------------------------------------------
+// Clear the view.
+//----------------------------------------------------------------------------
+
+void ts::RTPPacketView::clear()
+{
+    _data = nullptr;
+    _size = 0;
+    _header_size = 0;
+    _payload_size = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Reinitialize the view on a new RTP packet.
+//----------------------------------------------------------------------------
+
+bool ts::RTPPacketView::reset(const uint8_t* data, size_t size)
+{
+    // Clear previous content.
+    clear();
+    if (data == nullptr || size < RTP_HEADER_SIZE || (data[0] >> 6) != RTP_VERSION) {
+        return false;
+    }
+
+    // Fixed header, followed by the CSRC list.
+    size_t header_size = RTP_HEADER_SIZE + 4 * size_t(data[0] & 0x0F);
+
+    // Skip header extension: 16-bit profile-specific id, 16-bit length in 32-bit words.
+    if ((data[0] & 0x10) != 0) {
+        if (size < header_size + 4) {
+            return false;
+        }
+        header_size += 4 + 4 * size_t(GetUInt16(data + header_size + 2));
+    }
+
+    // Remove padding, the last byte is the padding size, including itself.
+    size_t padding = 0;
+    if ((data[0] & 0x20) != 0) {
+        padding = data[size - 1];
+        if (padding == 0) {
+            return false;
+        }
+    }
+    if (size < header_size + padding) {
+        return false;
+    }
+
+    _data = data;
+    _size = size;
+    _header_size = header_size;
+    _payload_size = size - header_size - padding;
+    return true;
+}
@@ -0,0 +1,149 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view of an RTP packet in memory.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsIPProtocols.h"
+#include "tsMemory.h"
+
+namespace ts {
+    //!
+    //! Read-only view of an RTP packet in memory.
+    //! @ingroup net
+    //!
+    //! The view does not copy the packet. It only locates the various fields and the
+    //! payload inside a memory area which is owned by the application, typically the
+    //! payload of a UDP datagram. The memory area must remain valid as long as the view
+    //! is used. See RFC 3550.
+    //!
+    class TSDUCKDLL RTPPacketView
+    {
+    public:
+        //!
+        //! Default constructor.
+        //!
+        RTPPacketView() = default;
+
+        //!
+        //! Constructor from raw content.
+        //! @param [in] data Address of the RTP packet, RTP header included.
+        //! @param [in] size Size in bytes of the RTP packet.
+        //!
+        RTPPacketView(const uint8_t* data, size_t size) { reset(data, size); }
+
+        //!
+        //! Reinitialize the view on a new RTP packet.
+        //! @param [in] data Address of the RTP packet, RTP header included.
+        //! @param [in] size Size in bytes of the RTP packet.
+        //! @return True if the packet is a valid RTP version 2 packet.
+        //!
+        bool reset(const uint8_t* data, size_t size);
+
+        //!
+        //! Clear the view, becomes invalid.
+        //!
+        void clear();
+
+        //!
+        //! Check if the view is valid.
+        //! @return True if the view is valid.
+        //!
+        bool isValid() const { return _data != nullptr; }
+
+        //!
+        //! Access to the RTP packet, RTP header included.
+        //! @return The address of the RTP packet.
+        //!
+        const uint8_t* data() const { return _data; }
+
+        //!
+        //! Size of the RTP packet, RTP header included.
+        //! @return The size of the RTP packet in bytes.
+        //!
+        size_t size() const { return _size; }
+
+        //!
+        //! Get the marker bit.
+        //! @return The marker bit.
+        //!
+        bool marker() const { return _data != nullptr && (_data[1] & 0x80) != 0; }
+
+        //!
+        //! Get the payload type.
+        //! @return The payload type.
+        //!
+        uint8_t payloadType() const { return _data == nullptr ? 0 : (_data[1] & 0x7F); }
+
+        //!
+        //! Get the sequence number.
+        //! @return The sequence number.
+        //!
+        uint16_t sequenceNumber() const { return _data == nullptr ? 0 : GetUInt16(_data + 2); }
+
+        //!
+        //! Get the RTP timestamp.
+        //! @return The RTP timestamp.
+        //!
+        uint32_t timestamp() const { return _data == nullptr ? 0 : GetUInt32(_data + 4); }
+
+        //!
+        //! Get the synchronization source identifier (SSRC).
+        //! @return The SSRC.
+        //!
+        uint32_t ssrc() const { return _data == nullptr ? 0 : GetUInt32(_data + 8); }
+
+        //!
+        //! Get the size of the complete RTP header, including CSRC list and header extension.
+        //! @return The RTP header size in bytes.
+        //!
+        size_t headerSize() const { return _header_size; }
+
+        //!
+        //! Access to the RTP payload.
+        //! @return The address of the RTP payload.
+        //!
+        const uint8_t* payload() const { return _data == nullptr ? nullptr : _data + _header_size; }
+
+        //!
+        //! Size of the RTP payload, without padding.
+        //! @return The size of the RTP payload in bytes.
+        //!
+        size_t payloadSize() const { return _payload_size; }
+
+    private:
+        const uint8_t* _data {nullptr};
+        size_t         _size {0};
+        size_t         _header_size {0};
+        size_t         _payload_size {0};
+    };
+}
@@ -78,6 +78,7 @@ void ts::Socket::declareOpened(SysSocketType sock, Report& report)
         throw ImplementationError(u"socket already open");
     }
     _sock = sock;
+    _non_blocking = false;
 }
 
 
@@ -92,6 +93,7 @@ bool ts::Socket::close(Report& report)
         // these threads can immediately check if this is a real error or the result of a close.
         const SysSocketType previous = _sock;
         _sock = SYS_SOCKET_INVALID;
+        _non_blocking = false;
         // Shutdown should not be necessary here. However, on Linux, no using
         // shutdown makes a blocking receive hangs forever when close() is
         // invoked by another thread. By using shutdown() before close(),
@@ -162,6 +164,38 @@ bool ts::Socket::setReceiveTimeout(ts::MilliSecond timeout, ts::Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Set the socket in non-blocking mode.
+//----------------------------------------------------------------------------
+
+bool ts::Socket::setNonBlocking(bool non_blocking, Report& report)
+{
+    report.debug(u"setting socket non-blocking mode to %s", {non_blocking});
+
+#if defined(TS_WINDOWS)
+    ::u_long mode = non_blocking ? 1 : 0;
+    if (::ioctlsocket(_sock, FIONBIO, &mode) != 0) {
+        report.error(u"error setting socket non-blocking mode: %s", {SysSocketErrorCodeMessage()});
+        return false;
+    }
+#else
+    int flags = ::fcntl(_sock, F_GETFL, 0);
+    if (flags < 0) {
+        report.error(u"error getting socket flags: %s", {SysSocketErrorCodeMessage()});
+        return false;
+    }
+    flags = non_blocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    if (::fcntl(_sock, F_SETFL, flags) < 0) {
+        report.error(u"error setting socket non-blocking mode: %s", {SysSocketErrorCodeMessage()});
+        return false;
+    }
+#endif
+
+    _non_blocking = non_blocking;
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Set the "reuse port" option.
 //----------------------------------------------------------------------------
@@ -202,3 +236,17 @@ bool ts::Socket::getLocalAddress(IPv4SocketAddress& addr, Report& report)
     addr = IPv4SocketAddress(sock_addr);
     return true;
 }
+
+bool ts::Socket::getLocalAddress(IPv6SocketAddress& addr, Report& report)
+{
+    ::sockaddr_in6 sock_addr;
+    SysSocketLengthType len = sizeof(sock_addr);
+    TS_ZERO(sock_addr);
+    if (::getsockname(_sock, reinterpret_cast<::sockaddr*>(&sock_addr), &len) != 0) {
+        report.error(u"error getting socket name: %s", {SysSocketErrorCodeMessage()});
+        addr.clear();
+        return false;
+    }
+    addr = IPv6SocketAddress(sock_addr);
+    return true;
+}
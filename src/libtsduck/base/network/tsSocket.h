@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsIPv4SocketAddress.h"
+#include "tsIPv6SocketAddress.h"
 #include "tsIPUtils.h"
 #include "tsReport.h"
 
@@ -101,6 +102,24 @@ namespace ts {
         //!
         bool setReceiveTimeout(MilliSecond timeout, Report& report = CERR);
 
+        //!
+        //! Set the socket in non-blocking mode.
+        //! In non-blocking mode, send and receive operations never wait. They return
+        //! immediately when no data can be sent or received. This mode is typically used
+        //! by applications which manage many sockets from one event loop (select, epoll, etc).
+        //! @param [in] non_blocking If true, set the socket in non-blocking mode.
+        //! If false, restore the default blocking mode.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool setNonBlocking(bool non_blocking, Report& report = CERR);
+
+        //!
+        //! Check if the socket is in non-blocking mode.
+        //! @return True if the socket was set in non-blocking mode using setNonBlocking().
+        //!
+        bool isNonBlocking() const { return _non_blocking; }
+
         //!
         //! Set the "reuse port" option.
         //! @param [in] reuse_port If true, the socket is allowed to reuse a local
@@ -118,6 +137,14 @@ namespace ts {
         //!
         bool getLocalAddress(IPv4SocketAddress& addr, Report& report = CERR);
 
+        //!
+        //! Get local socket address, for an IPv6 socket.
+        //! @param [out] addr Local socket address of the connection.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool getLocalAddress(IPv6SocketAddress& addr, Report& report = CERR);
+
         //!
         //! Get the underlying socket device handle (use with care).
         //!
@@ -150,5 +177,6 @@ namespace ts {
 
     private:
         volatile SysSocketType _sock {SYS_SOCKET_INVALID};
+        bool _non_blocking {false};
     };
 }
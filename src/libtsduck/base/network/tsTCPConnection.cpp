@@ -152,6 +152,41 @@ bool ts::TCPConnection::send(const void* buffer, size_t size, Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Send some data, without waiting for all data to be sent.
+//----------------------------------------------------------------------------
+
+bool ts::TCPConnection::send(const void* buffer, size_t size, size_t& ret_size, Report& report)
+{
+    ret_size = 0;
+
+    // Loop on unsollicited interrupts
+    for (;;) {
+        SysSocketSignedSizeType gone = ::send(getSocket(), SysSendBufferPointer(buffer), int(size), 0);
+        const SysSocketErrorCode err_code = LastSysSocketErrorCode();
+        if (gone >= 0) {
+            assert(size_t(gone) <= size);
+            ret_size = size_t(gone);
+            return true;
+        }
+        else if (isNonBlocking() && err_code == SYS_SOCKET_ERR_WOULDBLOCK) {
+            // Socket send buffer is full, nothing sent.
+            return true;
+        }
+#if !defined(TS_WINDOWS)
+        else if (err_code == EINTR) {
+            // Ignore signal, retry
+            report.debug(u"send() interrupted by signal, retrying");
+        }
+#endif
+        else {
+            report.error(u"error sending data to socket: %s", {SysSocketErrorCodeMessage(err_code)});
+            return false;
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Receive data.
 // If abort interface is non-zero, invoke it when I/O is interrupted
@@ -182,6 +217,10 @@ bool ts::TCPConnection::receive(void* data,             // Buffers address
             declareDisconnected(report);
             return false;
         }
+        else if (isNonBlocking() && err_code == SYS_SOCKET_ERR_WOULDBLOCK) {
+            // No data currently available on a non-blocking socket.
+            return true;
+        }
 #if !defined(TS_WINDOWS)
         else if (err_code == EINTR) {
             // Ignore signal, retry
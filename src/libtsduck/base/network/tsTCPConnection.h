@@ -157,6 +157,22 @@ namespace ts {
         //!
         bool send(const void* data, size_t size, Report& report = CERR);
 
+        //!
+        //! Send some data, without waiting for all data to be sent.
+        //!
+        //! This version of send() is typically used on non-blocking sockets.
+        //! It sends as much data as the socket can currently accept and returns.
+        //!
+        //! @param [in] data Address of the data to send.
+        //! @param [in] size Size in bytes of the data to send.
+        //! @param [out] ret_size Size in bytes of the data which were actually sent.
+        //! On a non-blocking socket, this can be less than @a size, including zero,
+        //! when the socket send buffer is full. This is not an error.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool send(const void* data, size_t size, size_t& ret_size, Report& report = CERR);
+
         //!
         //! Receive data.
         //!
@@ -168,6 +184,9 @@ namespace ts {
         //! how much data will be received and must respond even if the user
         //! buffer is not full.
         //!
+        //! On a non-blocking socket (see setNonBlocking()), this method returns
+        //! true with @a ret_size set to zero when no data is currently available.
+        //!
         //! @param [out] buffer Address of the buffer for the received data.
         //! @param [in] max_size Size in bytes of the reception buffer.
         //! @param [out] ret_size Size in bytes of the received data.
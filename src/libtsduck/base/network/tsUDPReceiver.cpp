@@ -51,7 +51,10 @@ void ts::UDPReceiver::defineArgs(ts::Args& args, bool with_short_options, bool d
            u"The 'port' part is mandatory and specifies the UDP port to listen on. "
            u"The 'address' part is optional. It specifies an IP multicast address to listen on. "
            u"It can be also a host name that translates to a multicast address. "
-           u"An optional source address can be specified as 'source@address:port' in the case of SSM.";
+           u"An optional source address can be specified as 'source@address:port' in the case of SSM. "
+           u"IPv6 socket addresses use the syntax '[address]:port', for instance '[ff3e::1234]:5000' "
+           u"or '[::]:5000' to receive IPv6 unicast traffic. IPv6 addresses must be numerical. "
+           u"Link-local IPv6 addresses (fe80::/10, ff02::/16) are not supported since they require an interface scope.";
     if (multiple_receivers) {
         help.format(u"\nSeveral %s can be specified to receive multiple UDP streams. "
                     u"If distinct receivers use the same port, this may work or not, depending on the operating system.",
@@ -87,6 +90,7 @@ void ts::UDPReceiver::defineArgs(ts::Args& args, bool with_short_options, bool d
 
     help = u"Specify the IP address of the local interface on which to listen. "
            u"It can be also a host name that translates to a local address. "
+           u"With IPv6, this can be an IPv6 address, an interface name or an interface index. "
            u"By default, listen on all local interfaces.";
     if (multiple_receivers) {
         help.format(u"\nIf several %s are specified, several --local-address options can be specified, "
@@ -161,12 +165,57 @@ bool ts::UDPReceiver::loadArgs(DuckContext& duck, Args& args, size_t index)
     args.getIntValue(_recv_bufsize, u"buffer-size", 0);
     args.getIntValue(_recv_timeout, u"receive-timeout", _recv_timeout); // preserve previous value
 
-    // Check the presence of the '@' indicating a source address.
+    // Get destination and source addresses, depending on the IP generation of the destination.
     const size_t sep = destination.find(u'@');
+    _gen = IPStringGeneration(sep == NPOS ? destination : destination.substr(sep + 1));
     _use_source.clear();
+    _use_source6.clear();
+    if (_gen == IP::v6 ? !loadAddresses(destination, _dest_addr6, _use_source6, args) : !loadAddresses(destination, _dest_addr, _use_source, args)) {
+        return false;
+    }
+
+    // Get and resolve optional local address.
+    const size_t laddr_count = args.count(u"local-address");
+    if (laddr_count > _receiver_count) {
+        args.error(u"too many --local-address options");
+        return false;
+    }
+    const UString local(laddr_count == 0 ? UString() : args.value(u"local-address", u"", std::min(_receiver_index, laddr_count - 1)));
+    _local_address.clear();
+    _local_address6.clear();
+    _local_interface6 = 0;
+    if (_gen == IP::v6) {
+        // An IPv6 local address is used to bind the socket. In all cases, the local interface index is used to join groups.
+        if ((IPStringGeneration(local) == IP::v6 && !_local_address6.resolve(local, args)) || !GetIPv6InterfaceIndex(local, _local_interface6, args)) {
+            return false;
+        }
+    }
+    else if (!local.empty() && !_local_address.resolve(local, args)) {
+        return false;
+    }
+
+    // Either specify a local address or let the system decide, but not both.
+    if (_default_interface && !local.empty()) {
+        args.error(u"--default-interface and --local-address are mutually exclusive");
+        return false;
+    }
+
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Resolve and check the destination and source addresses, for one IP generation.
+//----------------------------------------------------------------------------
+
+template <class SOCKADDR>
+bool ts::UDPReceiver::loadAddresses(UString destination, SOCKADDR& dest_addr, SOCKADDR& use_source, Args& args)
+{
+    // Check the presence of the '@' indicating a source address.
+    const size_t sep = destination.find(u'@');
     if (sep != NPOS) {
         // Resolve source address.
-        if (!_use_source.resolve(destination.substr(0, sep), args)) {
+        if (!use_source.resolve(destination.substr(0, sep), args)) {
             return false;
         }
         // Force SSM.
@@ -176,23 +225,23 @@ bool ts::UDPReceiver::loadArgs(DuckContext& duck, Args& args, size_t index)
     }
 
     // Resolve destination address.
-    if (!_dest_addr.resolve(destination, args)) {
+    if (!dest_addr.resolve(destination, args)) {
         return false;
     }
 
     // If a destination address is specified, it must be a multicast address.
-    if (_dest_addr.hasAddress() && !_dest_addr.isMulticast()) {
-        args.error(u"address %s is not multicast", {_dest_addr});
+    if (dest_addr.hasAddress() && !dest_addr.isMulticast()) {
+        args.error(u"address %s is not multicast", {dest_addr});
         return false;
     }
 
     // In case of SSM, it should be in the SSM range, but let it a warning only.
-    if (_use_ssm && !_dest_addr.hasAddress()) {
+    if (_use_ssm && !dest_addr.hasAddress()) {
         args.error(u"multicast group address is missing with SSM");
         return false;
     }
-    if (_use_ssm && !_dest_addr.isSSM()) {
-        args.warning(u"address %s is not an SSM address", {_dest_addr});
+    if (_use_ssm && !dest_addr.isSSM()) {
+        args.warning(u"address %s is not an SSM address", {dest_addr});
     }
     if (_use_ssm && _use_first_source) {
         args.error(u"SSM and --first-source are mutually exclusive");
@@ -200,30 +249,11 @@ bool ts::UDPReceiver::loadArgs(DuckContext& duck, Args& args, size_t index)
     }
 
     // The destination port is mandatory
-    if (!_dest_addr.hasPort()) {
+    if (!dest_addr.hasPort()) {
         args.error(u"no UDP port specified in %s", {destination});
         return false;
     }
 
-    // Get and resolve optional local address.
-    const size_t laddr_count = args.count(u"local-address");
-    if (laddr_count > _receiver_count) {
-        args.error(u"too many --local-address options");
-        return false;
-    }
-    if (laddr_count == 0) {
-        _local_address.clear();
-    }
-    else if (!_local_address.resolve(args.value(u"local-address", u"", std::min(_receiver_index, laddr_count - 1)), args)) {
-        return false;
-    }
-
-    // Either specify a local address or let the system decide, but not both.
-    if (_default_interface && _local_address.hasAddress()) {
-        args.error(u"--default-interface and --local-address are mutually exclusive");
-        return false;
-    }
-
     // Translate optional source address.
     UString source;
     const size_t source_count = args.count(u"source");
@@ -231,21 +261,21 @@ bool ts::UDPReceiver::loadArgs(DuckContext& duck, Args& args, size_t index)
         args.error(u"too many --source options");
         return false;
     }
-    // If _use_source is already set, it comes from source@destination SSM format.
-    if (source_count > 0 && (!_use_source.hasAddress() || _receiver_index < source_count)) {
+    // If use_source is already set, it comes from source@destination SSM format.
+    if (source_count > 0 && (!use_source.hasAddress() || _receiver_index < source_count)) {
         args.getValue(source, u"source", u"", std::min(_receiver_index, source_count - 1));
     }
-    if (_use_source.hasAddress() && _receiver_index < source_count) {
+    if (use_source.hasAddress() && _receiver_index < source_count) {
         args.error(u"SSM source address specified twice");
         return false;
     }
     if (source.empty()) {
         // No --source specified, no additional check.
     }
-    else if (!_use_source.resolve(source, args)) {
+    else if (!use_source.resolve(source, args)) {
         return false;
     }
-    else if (!_use_source.hasAddress()) {
+    else if (!use_source.hasAddress()) {
         // If source is specified, the port is optional but the address is mandatory.
         args.error(u"missing IP address in --source %s", {source});
         return false;
@@ -254,7 +284,7 @@ bool ts::UDPReceiver::loadArgs(DuckContext& duck, Args& args, size_t index)
         args.error(u"--first-source and --source are mutually exclusive");
         return false;
     }
-    if (_use_ssm && !_use_source.hasAddress()) {
+    if (_use_ssm && !use_source.hasAddress()) {
         args.error(u"missing source address with --ssm");
         return false;
     }
@@ -275,12 +305,30 @@ void ts::UDPReceiver::setReceiveTimeoutArg(MilliSecond timeout)
 }
 
 
+//----------------------------------------------------------------------------
+// Shift the destination UDP port for a companion stream.
+//----------------------------------------------------------------------------
+
+void ts::UDPReceiver::shiftDestinationPort(uint16_t offset)
+{
+    if (_gen == IP::v6) {
+        _dest_addr6.setPort(uint16_t(_dest_addr6.port() + offset));
+        _use_source6.setPort(IPv6SocketAddress::AnyPort);
+    }
+    else {
+        _dest_addr.setPort(uint16_t(_dest_addr.port() + offset));
+        _use_source.setPort(IPv4SocketAddress::AnyPort);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Set application-specified parameters to receive unicast traffic.
 //----------------------------------------------------------------------------
 
 void ts::UDPReceiver::setParameters(const IPv4SocketAddress& localAddress, bool reusePort, size_t bufferSize)
 {
+    _gen = IP::v4;
     _receiver_specified = true;
     _use_ssm = false;
     _dest_addr.clear();
@@ -290,6 +338,19 @@ void ts::UDPReceiver::setParameters(const IPv4SocketAddress& localAddress, bool
     _recv_bufsize = bufferSize;
 }
 
+void ts::UDPReceiver::setParameters(const IPv6SocketAddress& localAddress, bool reusePort, size_t bufferSize)
+{
+    _gen = IP::v6;
+    _receiver_specified = true;
+    _use_ssm = false;
+    _dest_addr6.clear();
+    _dest_addr6.setPort(localAddress.port());
+    _local_address6 = localAddress;
+    _local_interface6 = 0;
+    _reuse_port = reusePort;
+    _recv_bufsize = bufferSize;
+}
+
 
 //----------------------------------------------------------------------------
 // Open the socket. Override UDPSocket::open().
@@ -306,6 +367,56 @@ bool ts::UDPReceiver::open(ts::Report& report)
     // Clear collection of source address information.
     _first_source.clear();
     _sources.clear();
+    _first_source6.clear();
+    _sources6.clear();
+
+    // Create UDP socket from the superclass.
+    bool ok =
+        UDPSocket::open(_gen, report) &&
+        reusePort(_reuse_port, report) &&
+        setReceiveTimestamps(_recv_timestamps, report) &&
+        setMulticastLoop(_mc_loopback, report) &&
+        (_recv_bufsize <= 0 || setReceiveBufferSize(_recv_bufsize, report)) &&
+        (_recv_timeout < 0 || setReceiveTimeout(_recv_timeout, report));
+
+    // Bind and join multicast group.
+    // Note: On Windows, bind must be done *before* joining multicast groups.
+    if (_gen == IP::v6) {
+        // Same principles as IPv4 below.
+        const IPv6SocketAddress local_addr(
+#if defined(TS_UNIX)
+            _dest_addr6.hasAddress() ? IPv6Address(_dest_addr6) : _local_address6,
+#else
+            _local_address6,
+#endif
+            _dest_addr6.port());
+        ok = ok && bind(local_addr, report);
+
+        // Optional SSM source address.
+        IPv6Address ssm_source;
+        if (_use_ssm) {
+            ssm_source = _use_source6;
+        }
+
+        // Join multicast group.
+        if (ok && _dest_addr6.hasAddress()) {
+            if (_default_interface) {
+                ok = addMembershipDefault(_dest_addr6, ssm_source, report);
+            }
+            else if (_local_interface6 != 0) {
+                ok = addMembership(_dest_addr6, _local_interface6, ssm_source, report);
+            }
+            else {
+                // By default, listen on all interfaces.
+                ok = addMembershipAll(_dest_addr6, ssm_source, report);
+            }
+        }
+
+        if (!ok) {
+            close(report);
+        }
+        return ok;
+    }
 
     // The local socket address to bind is the optional local IP address and the destination port.
     // Except on Linux, macOS and probably most Unix, when listening to a multicast group.
@@ -319,16 +430,7 @@ bool ts::UDPReceiver::open(ts::Report& report)
 #endif
         _dest_addr.port());
 
-    // Create UDP socket from the superclass.
-    // Note: On Windows, bind must be done *before* joining multicast groups.
-    bool ok =
-        UDPSocket::open(report) &&
-        reusePort(_reuse_port, report) &&
-        setReceiveTimestamps(_recv_timestamps, report) &&
-        setMulticastLoop(_mc_loopback, report) &&
-        (_recv_bufsize <= 0 || setReceiveBufferSize(_recv_bufsize, report)) &&
-        (_recv_timeout < 0 || setReceiveTimeout(_recv_timeout, report)) &&
-        bind(local_addr, report);
+    ok = ok && bind(local_addr, report);
 
     // Optional SSM source address.
     IPv4Address ssm_source;
@@ -372,81 +474,126 @@ bool ts::UDPReceiver::receive(void* data,
 {
     // Loop on packet reception until one matching filtering criteria is found.
     for (;;) {
-
         // Wait for a UDP message from the superclass.
         if (!UDPSocket::receive(data, max_size, ret_size, sender, destination, abort, report, timestamp)) {
             return false;
         }
-
+        // No message currently available on a non-blocking socket.
+        if (ret_size == 0 && !sender.hasAddress()) {
+            return true;
+        }
         // Debug (level 2) message for each message.
         if (report.maxSeverity() >= 2) {
             // Prior report level checking to avoid evaluating parameters when not necessary.
             report.log(2, u"received UDP packet, source: %s, destination: %s, timestamp: %'d", {sender, destination, timestamp != nullptr ? *timestamp : -1});
         }
+        if (acceptPacket(sender, destination, _dest_addr, _use_source, _first_source, _sources, report)) {
+            return true;
+        }
+    }
+}
 
-        // Check the destination address to exclude packets from other streams.
-        // When several multicast streams use the same destination port and several
-        // applications on the same system listen to these distinct streams,
-        // the multicast MAC address management is such that any socket which
-        // is bound to the common port will receive the traffic for all streams.
-        // This is why we need to check the destination address and exclude
-        // packets which are not from the intended stream.
-        //
-        // We accept a packet in any of:
-        // 1) Actual packet destination is unknown. Probably, the system cannot
-        //    report the destination address.
-        // 2) We listen to a multicast address and the actual destination is the same.
-        // 3) If we listen to unicast traffic and the actual destination is unicast.
-        //    In that case, unicast is by definition sent to us.
-
-        if (destination.hasAddress() && ((_dest_addr.hasAddress() && destination != _dest_addr) || (!_dest_addr.hasAddress() && destination.isMulticast()))) {
-            // This is a spurious packet.
-            if (report.maxSeverity() >= Severity::Debug) {
-                // Prior report level checking to avoid evaluating parameters when not necessary.
-                report.debug(u"rejecting packet, destination: %s, expecting: %s", {destination, _dest_addr});
-            }
-            continue;
+bool ts::UDPReceiver::receive(void* data,
+                              size_t max_size,
+                              size_t& ret_size,
+                              ts::IPv6SocketAddress& sender,
+                              ts::IPv6SocketAddress& destination,
+                              const ts::AbortInterface* abort,
+                              ts::Report& report,
+                              MicroSecond* timestamp)
+{
+    // Loop on packet reception until one matching filtering criteria is found.
+    for (;;) {
+        // Wait for a UDP message from the superclass.
+        if (!UDPSocket::receive(data, max_size, ret_size, sender, destination, abort, report, timestamp)) {
+            return false;
+        }
+        // No message currently available on a non-blocking socket.
+        if (ret_size == 0 && !sender.hasAddress()) {
+            return true;
         }
+        // Debug (level 2) message for each message.
+        if (report.maxSeverity() >= 2) {
+            // Prior report level checking to avoid evaluating parameters when not necessary.
+            report.log(2, u"received UDP packet, source: %s, destination: %s, timestamp: %'d", {sender, destination, timestamp != nullptr ? *timestamp : -1});
+        }
+        if (acceptPacket(sender, destination, _dest_addr6, _use_source6, _first_source6, _sources6, report)) {
+            return true;
+        }
+    }
+}
 
-        // Keep track of the first sender address.
-        if (!_first_source.hasAddress()) {
-            // First packet, keep address of the sender.
-            _first_source = sender;
-            _sources.insert(sender);
-
-            // With option --first-source, use this one to filter packets.
-            if (_use_first_source) {
-                assert(!_use_source.hasAddress());
-                _use_source = sender;
-                report.verbose(u"now filtering on source address %s", {sender});
-            }
+
+//----------------------------------------------------------------------------
+// Check if a received packet matches the filtering criteria.
+//----------------------------------------------------------------------------
+
+template <class SOCKADDR>
+bool ts::UDPReceiver::acceptPacket(const SOCKADDR& sender, const SOCKADDR& destination, const SOCKADDR& dest_addr,
+                                   SOCKADDR& use_source, SOCKADDR& first_source, std::set<SOCKADDR>& sources, Report& report)
+{
+    // Check the destination address to exclude packets from other streams.
+    // When several multicast streams use the same destination port and several
+    // applications on the same system listen to these distinct streams,
+    // the multicast MAC address management is such that any socket which
+    // is bound to the common port will receive the traffic for all streams.
+    // This is why we need to check the destination address and exclude
+    // packets which are not from the intended stream.
+    //
+    // We accept a packet in any of:
+    // 1) Actual packet destination is unknown. Probably, the system cannot
+    //    report the destination address.
+    // 2) We listen to a multicast address and the actual destination is the same.
+    // 3) If we listen to unicast traffic and the actual destination is unicast.
+    //    In that case, unicast is by definition sent to us.
+
+    if (destination.hasAddress() && ((dest_addr.hasAddress() && destination != dest_addr) || (!dest_addr.hasAddress() && destination.isMulticast()))) {
+        // This is a spurious packet.
+        if (report.maxSeverity() >= Severity::Debug) {
+            // Prior report level checking to avoid evaluating parameters when not necessary.
+            report.debug(u"rejecting packet, destination: %s, expecting: %s", {destination, dest_addr});
         }
+        return false;
+    }
 
-        // Keep track of senders (sources) to detect or filter multiple sources.
-        if (_sources.count(sender) == 0) {
-            // Detected an additional source, warn the user that distinct streams are potentially mixed.
-            // If no source filtering is applied, this is a warning since this may affect the resulting stream.
-            // With source filtering, this is just an informational verbose-level message.
-            const int level = _use_source.hasAddress() ? Severity::Verbose : Severity::Warning;
-            if (_sources.size() == 1) {
-                report.log(level, u"detected multiple sources for the same destination %s with potentially distinct streams", {destination});
-                report.log(level, u"detected source: %s", {_first_source});
-            }
-            report.log(level, u"detected source: %s", {sender});
-            _sources.insert(sender);
+    // Keep track of the first sender address.
+    if (!first_source.hasAddress()) {
+        // First packet, keep address of the sender.
+        first_source = sender;
+        sources.insert(sender);
+
+        // With option --first-source, use this one to filter packets.
+        if (_use_first_source) {
+            assert(!use_source.hasAddress());
+            use_source = sender;
+            report.verbose(u"now filtering on source address %s", {sender});
         }
+    }
 
-        // Filter packets based on source address if requested.
-        if (!sender.match(_use_source)) {
-            // Not the expected source, this is a spurious packet.
-            if (report.maxSeverity() >= Severity::Debug) {
-                // Prior report level checking to avoid evaluating parameters when not necessary.
-                report.debug(u"rejecting packet, source: %s, expecting: %s", {sender, _use_source});
-            }
-            continue;
+    // Keep track of senders (sources) to detect or filter multiple sources.
+    if (sources.count(sender) == 0) {
+        // Detected an additional source, warn the user that distinct streams are potentially mixed.
+        // If no source filtering is applied, this is a warning since this may affect the resulting stream.
+        // With source filtering, this is just an informational verbose-level message.
+        const int level = use_source.hasAddress() ? Severity::Verbose : Severity::Warning;
+        if (sources.size() == 1) {
+            report.log(level, u"detected multiple sources for the same destination %s with potentially distinct streams", {destination});
+            report.log(level, u"detected source: %s", {first_source});
         }
+        report.log(level, u"detected source: %s", {sender});
+        sources.insert(sender);
+    }
 
-        // Now found a packet matching all criteria.
-        return true;
+    // Filter packets based on source address if requested.
+    if (!sender.match(use_source)) {
+        // Not the expected source, this is a spurious packet.
+        if (report.maxSeverity() >= Severity::Debug) {
+            // Prior report level checking to avoid evaluating parameters when not necessary.
+            report.debug(u"rejecting packet, source: %s, expecting: %s", {sender, use_source});
+        }
+        return false;
     }
+
+    // Now found a packet matching all criteria.
+    return true;
 }
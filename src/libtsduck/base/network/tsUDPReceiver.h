@@ -44,6 +44,10 @@ namespace ts {
     //! UDP datagram receiver with common command line options.
     //! @ingroup net
     //!
+    //! The receiver is either IPv4 or IPv6, depending on the syntax of the destination address
+    //! on the command line. IPv6 socket addresses use the syntax "[address]:port". After loadArgs()
+    //! or setParameters(), use generation() to know which version of receive() to use.
+    //!
     class TSDUCKDLL UDPReceiver: public UDPSocket
     {
         TS_NOCOPY(UDPReceiver);
@@ -123,12 +127,43 @@ namespace ts {
         //!
         void setParameters(const IPv4SocketAddress& localAddress, bool reusePort, size_t bufferSize = 0);
 
+        //!
+        //! Set application-specified parameters to receive IPv6 unicast traffic.
+        //! This method is used when command line parameters are not used.
+        //! @param [in] localAddress Optional local address and required UDP port.
+        //! @param [in] reusePort Reuse-port option.
+        //! @param [in] bufferSize Optional socket receive buffer size.
+        //!
+        void setParameters(const IPv6SocketAddress& localAddress, bool reusePort, size_t bufferSize = 0);
+
+        //!
+        //! Get the IP generation of the receiver.
+        //! Before open(), this is the IP generation which will be used to open the socket.
+        //! @return The IP generation of the receiver.
+        //!
+        IP generation() const { return _gen; }
+
         //!
         //! Set reception timeout as if it comes from command line.
         //! @param [in] timeout Receive timeout in milliseconds. No timeout if zero or negative.
         //!
         void setReceiveTimeoutArg(MilliSecond timeout);
 
+        //!
+        //! Get the reception timeout, as specified on the command line or using setReceiveTimeoutArg().
+        //! @return Receive timeout in milliseconds. No timeout if zero or negative.
+        //!
+        MilliSecond receiveTimeoutArg() const { return _recv_timeout; }
+
+        //!
+        //! Shift the destination UDP port, after loading the command line arguments.
+        //! This is typically used to receive a companion stream which is sent on a port
+        //! relative to the port of the main stream, such as SMPTE 2022-1 FEC streams.
+        //! If the source address filter includes a port, this port is removed.
+        //! @param [in] offset Value to add to the destination UDP port.
+        //!
+        void shiftDestinationPort(uint16_t offset);
+
         // Override UDPSocket methods
         virtual bool open(Report& report = CERR) override;
         virtual bool receive(void* data,
@@ -139,6 +174,14 @@ namespace ts {
                              const AbortInterface* abort = nullptr,
                              Report& report = CERR,
                              MicroSecond* timestamp = nullptr) override;
+        virtual bool receive(void* data,
+                             size_t max_size,
+                             size_t& ret_size,
+                             IPv6SocketAddress& sender,
+                             IPv6SocketAddress& destination,
+                             const AbortInterface* abort = nullptr,
+                             Report& report = CERR,
+                             MicroSecond* timestamp = nullptr) override;
 
     private:
         bool              _dest_is_parameter {true};   // Destination address is a command line parameter, not an option.
@@ -159,7 +202,25 @@ namespace ts {
         IPv4SocketAddress _first_source {};            // Socket address of first received packet.
         IPv4SocketAddressSet _sources {};              // Set of all detected packet sources.
 
+        // Same parameters for IPv6. On IPv6, the local interface is identified by its index.
+        IP                _gen {IP::v4};               // IP generation of the receiver.
+        IPv6SocketAddress _dest_addr6 {};              // Expected destination of packets.
+        IPv6Address       _local_address6 {};          // Local address on which to listen (unicast).
+        unsigned int      _local_interface6 {0};       // Local interface index on which to listen (multicast).
+        IPv6SocketAddress _use_source6 {};             // Filter on this socket address of sender.
+        IPv6SocketAddress _first_source6 {};           // Socket address of first received packet.
+        IPv6SocketAddressSet _sources6 {};             // Set of all detected packet sources.
+
         // Get the command line argument for the destination parameter.
         const UChar* destinationOptionName() const { return _dest_is_parameter ? u"" : u"ip-udp"; }
+
+        // Resolve and check the destination and source addresses from the command line, for one IP generation.
+        template <class SOCKADDR>
+        bool loadAddresses(UString destination, SOCKADDR& dest_addr, SOCKADDR& use_source, Args& args);
+
+        // Check if a received packet matches the filtering criteria, for one IP generation.
+        template <class SOCKADDR>
+        bool acceptPacket(const SOCKADDR& sender, const SOCKADDR& destination, const SOCKADDR& dest_addr,
+                          SOCKADDR& use_source, SOCKADDR& first_source, std::set<SOCKADDR>& sources, Report& report);
     };
 }
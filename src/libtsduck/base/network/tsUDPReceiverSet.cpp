@@ -0,0 +1,377 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsUDPReceiverSet.h"
+#include "tsArgs.h"
+#include "tsNullReport.h"
+
+namespace {
+    // Maximum duration of one wait for ready receivers, before checking if they were closed.
+    constexpr ts::MilliSecond CLOSE_CHECK_INTERVAL = 100;
+}
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::UDPReceiverSet::UDPReceiverSet(Report& report) :
+    _report(report)
+{
+}
+
+ts::UDPReceiverSet::~UDPReceiverSet()
+{
+    close(NULLREP);
+#if defined(TS_LINUX)
+    if (_epoll >= 0) {
+        ::close(_epoll);
+        _epoll = -1;
+    }
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Define and load command line arguments.
+//----------------------------------------------------------------------------
+
+void ts::UDPReceiverSet::defineArgs(Args& args, bool with_short_options)
+{
+    // Use a dummy UDP receiver to define common options.
+    UDPReceiver dummy(_report);
+    dummy.defineArgs(args, with_short_options, true, true);
+}
+
+bool ts::UDPReceiverSet::loadArgs(DuckContext& duck, Args& args)
+{
+    // Clearing the vector of receivers automatically deallocates previous receivers (if any).
+    _receivers.clear();
+
+    // There must be at least one receiver. The command line syntax was defined using another
+    // instance of UDPReceiver. So we need to respecify that the UDP destination is a parameter.
+    do {
+        _receivers.push_back(UDPReceiverPtr(new UDPReceiver(_report)));
+        if (!_receivers.back()->loadArgs(true, duck, args, _receivers.size() - 1)) {
+            return false;
+        }
+        _receivers.back()->setReceiveTimeoutArg(_recv_timeout);
+    } while (_receivers.size() < _receivers.back()->receiverCount());
+
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Add one companion receiver for each receiver from the command line.
+//----------------------------------------------------------------------------
+
+bool ts::UDPReceiverSet::addCompanions(DuckContext& duck, Args& args, uint16_t port_offset)
+{
+    // The main receivers are the first ones, loaded from the command line.
+    const size_t main_count = _receivers.empty() ? 0 : _receivers[0]->receiverCount();
+    for (size_t i = 0; i < main_count; ++i) {
+        _receivers.push_back(UDPReceiverPtr(new UDPReceiver(_report)));
+        if (!_receivers.back()->loadArgs(true, duck, args, i)) {
+            return false;
+        }
+        _receivers.back()->shiftDestinationPort(port_offset);
+        _receivers.back()->setReceiveTimeoutArg(_recv_timeout);
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Set reception timeout as if it comes from command line.
+//----------------------------------------------------------------------------
+
+void ts::UDPReceiverSet::setReceiveTimeoutArg(MilliSecond timeout)
+{
+    if (timeout > 0) {
+        // Also keep the value for receivers which are created later in loadArgs().
+        _recv_timeout = timeout;
+        for (auto& rec : _receivers) {
+            rec->setReceiveTimeoutArg(timeout);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Open all UDP receivers.
+//----------------------------------------------------------------------------
+
+bool ts::UDPReceiverSet::open(Report& report, bool event_loop)
+{
+    _ready.clear();
+    _next_ready = 0;
+    _last_receive = Time::CurrentUTC();
+
+    // Open all sockets. With several receivers, they are non-blocking and serviced from one event loop.
+    _event_loop = event_loop || _receivers.size() > 1;
+    bool ok = !_receivers.empty();
+    for (size_t i = 0; ok && i < _receivers.size(); ++i) {
+        ok = _receivers[i]->open(report) && (!_event_loop || _receivers[i]->setNonBlocking(true, report));
+    }
+
+#if defined(TS_LINUX)
+
+    // Recreate the epoll set, the previous sockets were automatically removed when they were closed.
+    if (_epoll >= 0) {
+        ::close(_epoll);
+        _epoll = -1;
+    }
+    if (ok && _event_loop) {
+        _epoll = ::epoll_create1(EPOLL_CLOEXEC);
+        if (_epoll < 0) {
+            report.error(u"error creating epoll: %s", {SysErrorCodeMessage()});
+            ok = false;
+        }
+        for (size_t i = 0; ok && i < _receivers.size(); ++i) {
+            ::epoll_event ev;
+            TS_ZERO(ev);
+            ev.events = EPOLLIN;
+            ev.data.u64 = i;
+            if (::epoll_ctl(_epoll, EPOLL_CTL_ADD, _receivers[i]->getSocket(), &ev) < 0) {
+                report.error(u"error adding UDP socket to epoll: %s", {SysErrorCodeMessage()});
+                ok = false;
+            }
+        }
+        _events.resize(_receivers.size());
+    }
+
+#else
+
+    // Build the list of sockets to poll.
+    _pollfds.clear();
+    if (ok && _event_loop) {
+        _pollfds.resize(_receivers.size());
+        for (size_t i = 0; i < _receivers.size(); ++i) {
+            TS_ZERO(_pollfds[i]);
+            _pollfds[i].fd = _receivers[i]->getSocket();
+            _pollfds[i].events = POLLIN;
+        }
+    }
+
+#endif
+
+    if (!ok) {
+        close(NULLREP);
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Close all UDP receivers.
+//----------------------------------------------------------------------------
+
+bool ts::UDPReceiverSet::close(Report& report)
+{
+    // The epoll set is not closed here since this method can be invoked from another
+    // thread to abort a receive operation. The event loop periodically checks if the sockets are closed.
+    bool ok = true;
+    for (auto& rec : _receivers) {
+        ok = rec->close(report) && ok;
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Receive a message from any receiver in the set.
+//----------------------------------------------------------------------------
+
+bool ts::UDPReceiverSet::receive(void* data,
+                                 size_t max_size,
+                                 size_t& ret_size,
+                                 size_t& index,
+                                 const AbortInterface* abort,
+                                 Report& report,
+                                 MicroSecond* timestamp,
+                                 MilliSecond max_wait)
+{
+    ret_size = 0;
+    index = 0;
+
+    if (_receivers.empty()) {
+        report.error(u"no UDP receiver is defined");
+        return false;
+    }
+    else if (!_event_loop) {
+        // Only one receiver, use a direct blocking receive.
+        return receiveOne(*_receivers[0], data, max_size, ret_size, abort, report, timestamp);
+    }
+
+    // Loop until a message is received. Each ready receiver is serviced once, in turn,
+    // before waiting again for ready receivers. This prevents one high-bitrate stream
+    // from starving the others.
+    for (;;) {
+        while (_next_ready >= _ready.size()) {
+            if (!waitReady(max_wait, abort, report)) {
+                return false;
+            }
+            if (_ready.empty() && max_wait > 0) {
+                // Maximum waiting time expired, no message.
+                return true;
+            }
+        }
+        index = _ready[_next_ready++];
+        UDPReceiver& rec(*_receivers[index]);
+        if (!rec.isOpen()) {
+            // Closed from another thread, no error message.
+            return false;
+        }
+        if (!receiveOne(rec, data, max_size, ret_size, abort, report, timestamp)) {
+            return false;
+        }
+        if (ret_size > 0) {
+            _last_receive = Time::CurrentUTC();
+            return true;
+        }
+        // No message available on this receiver, probably filtered out by the receiver.
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Receive one message on one receiver, depending on its IP generation.
+//----------------------------------------------------------------------------
+
+bool ts::UDPReceiverSet::receiveOne(UDPReceiver& rec, void* data, size_t max_size, size_t& ret_size, const AbortInterface* abort, Report& report, MicroSecond* timestamp)
+{
+    if (rec.generation() == IP::v6) {
+        IPv6SocketAddress sender;
+        IPv6SocketAddress destination;
+        return rec.receive(data, max_size, ret_size, sender, destination, abort, report, timestamp);
+    }
+    else {
+        IPv4SocketAddress sender;
+        IPv4SocketAddress destination;
+        return rec.receive(data, max_size, ret_size, sender, destination, abort, report, timestamp);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Wait for at least one receiver to have pending messages.
+//----------------------------------------------------------------------------
+
+bool ts::UDPReceiverSet::waitReady(MilliSecond max_wait, const AbortInterface* abort, Report& report)
+{
+    _ready.clear();
+    _next_ready = 0;
+
+    // All receivers share the same command line options, including the receive timeout.
+    // The reception timeout is counted from the last received message.
+    const MilliSecond recv_timeout = _receivers[0]->receiveTimeoutArg();
+    const Time start(Time::CurrentUTC());
+    int count = 0;
+
+    for (;;) {
+        // Remaining waiting time, negative means infinite.
+        const Time now(Time::CurrentUTC());
+        MilliSecond wait = -1;
+        if (recv_timeout > 0) {
+            wait = std::max<MilliSecond>(0, _last_receive + recv_timeout - now);
+        }
+        if (max_wait > 0) {
+            const MilliSecond remain = std::max<MilliSecond>(0, start + max_wait - now);
+            if (wait < 0 || remain < wait) {
+                wait = remain;
+            }
+        }
+
+        // Closing the sockets from another thread does not reliably wake up the wait:
+        // a closed socket is silently removed from an epoll set. Wait by slices of
+        // limited duration and check the state of the receivers after each of them.
+        const MilliSecond slice = wait < 0 ? CLOSE_CHECK_INTERVAL : std::min(wait, CLOSE_CHECK_INTERVAL);
+
+#if defined(TS_LINUX)
+        count = ::epoll_wait(_epoll, _events.data(), int(_events.size()), int(slice));
+#elif defined(TS_WINDOWS)
+        count = ::WSAPoll(_pollfds.data(), ::ULONG(_pollfds.size()), int(slice));
+#else
+        count = ::poll(_pollfds.data(), ::nfds_t(_pollfds.size()), int(slice));
+#endif
+        const SysSocketErrorCode err = LastSysSocketErrorCode();
+
+        if (abort != nullptr && abort->aborting()) {
+            // User-interrupt, end of processing but no error message.
+            return false;
+        }
+        for (const auto& rec : _receivers) {
+            if (!rec->isOpen()) {
+                // Closed from another thread, no error message.
+                return false;
+            }
+        }
+        if (count > 0) {
+            break;
+        }
+        else if (count == 0) {
+            if (wait < 0 || slice < wait) {
+                // End of slice only, wait again.
+                continue;
+            }
+            if (recv_timeout > 0 && Time::CurrentUTC() >= _last_receive + recv_timeout) {
+                report.error(u"UDP reception timeout");
+                return false;
+            }
+            // Maximum waiting time expired, return with no ready receiver.
+            return true;
+        }
+        else {
+#if !defined(TS_WINDOWS)
+            if (err == EINTR) {
+                // Got a signal, not a user interrupt, will ignore it.
+                report.debug(u"signal, not user interrupt");
+                return true;
+            }
+#endif
+            report.error(u"error waiting for UDP sockets: %s", {SysSocketErrorCodeMessage(err)});
+            return false;
+        }
+    }
+
+    // Collect the indexes of all ready receivers.
+#if defined(TS_LINUX)
+    for (int i = 0; i < count; ++i) {
+        _ready.push_back(size_t(_events[i].data.u64));
+    }
+#else
+    for (size_t i = 0; i < _pollfds.size(); ++i) {
+        if (_pollfds[i].revents != 0) {
+            _ready.push_back(i);
+        }
+    }
+#endif
+    return true;
+}
@@ -0,0 +1,186 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  A set of UDP receivers, serviced from one single thread.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsUDPReceiver.h"
+#include "tsSafePtr.h"
+#include "tsTime.h"
+
+namespace ts {
+    //!
+    //! A set of UDP receivers with common command line options, serviced from one single thread.
+    //! @ingroup net
+    //!
+    //! Each [address:]port on the command line defines a distinct UDP receiver, with its own socket.
+    //! All receivers are waited for at the same time (epoll on Linux, poll on other systems).
+    //! Each call to receive() returns one datagram and the index of the receiver it came from.
+    //! This is typically used to service dozens of low-bitrate multicast streams without using
+    //! one thread per stream.
+    //!
+    //! When there is only one receiver, the set directly uses a blocking receive operation on it,
+    //! unless an event loop is explicitly requested in open().
+    //!
+    class TSDUCKDLL UDPReceiverSet
+    {
+        TS_NOCOPY(UDPReceiverSet);
+    public:
+        //!
+        //! Constructor.
+        //! @param [in,out] report Where to report error.
+        //!
+        explicit UDPReceiverSet(Report& report = CERR);
+
+        //!
+        //! Destructor.
+        //!
+        ~UDPReceiverSet();
+
+        //!
+        //! Add command line option definitions in an Args.
+        //! The destinations [address:]port are parameters and there can be several of them.
+        //! @param [in,out] args Command line arguments to update.
+        //! @param [in] with_short_options When true, define one-letter short options.
+        //!
+        void defineArgs(Args& args, bool with_short_options);
+
+        //!
+        //! Load arguments from command line.
+        //! Args error indicator is set in case of incorrect arguments.
+        //! @param [in,out] duck TSDuck execution context.
+        //! @param [in,out] args Command line arguments.
+        //! @return True on success, false on error in argument line.
+        //!
+        bool loadArgs(DuckContext& duck, Args& args);
+
+        //!
+        //! Add one companion receiver for each receiver from the command line.
+        //! Must be called after loadArgs() and before open(). A companion receiver uses the same
+        //! options as the corresponding main receiver, with a different destination port. This is
+        //! typically used to receive SMPTE 2022-1 FEC streams. If there are N receivers from the
+        //! command line, the companion of receiver i after the k-th call is at index i + k * N.
+        //! @param [in,out] duck TSDuck execution context.
+        //! @param [in,out] args Command line arguments.
+        //! @param [in] port_offset Value to add to the destination UDP port of the main receivers.
+        //! @return True on success, false on error in argument line.
+        //!
+        bool addCompanions(DuckContext& duck, Args& args, uint16_t port_offset);
+
+        //!
+        //! Get the number of receivers in the set.
+        //! @return The number of receivers, after loadArgs().
+        //!
+        size_t count() const { return _receivers.size(); }
+
+        //!
+        //! Access one receiver in the set.
+        //! @param [in] index Index of the receiver, from 0 to count() - 1.
+        //! @return A reference to the receiver.
+        //!
+        UDPReceiver& receiver(size_t index) { return *_receivers[index]; }
+
+        //!
+        //! Set reception timeout as if it comes from command line.
+        //! @param [in] timeout Receive timeout in milliseconds. No timeout if zero or negative.
+        //!
+        void setReceiveTimeoutArg(MilliSecond timeout);
+
+        //!
+        //! Open all UDP receivers.
+        //! @param [in,out] report Where to report error.
+        //! @param [in] event_loop If true, use an event loop even if there is only one receiver.
+        //! This is required to use a maximum waiting time in receive() with only one receiver.
+        //! @return True on success, false on error. On error, all receivers are closed.
+        //!
+        bool open(Report& report = CERR, bool event_loop = false);
+
+        //!
+        //! Close all UDP receivers.
+        //! This method can be invoked from another thread to abort a receive() operation.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool close(Report& report = CERR);
+
+        //!
+        //! Receive a message from any receiver in the set.
+        //! When several receivers have pending messages, they are serviced in turn.
+        //! @param [out] data Address of the buffer for the received message.
+        //! @param [in] max_size Size in bytes of the reception buffer.
+        //! @param [out] ret_size Size in bytes of the received message.
+        //! Will never be larger than @a max_size.
+        //! @param [out] index Index of the receiver which received the message.
+        //! @param [in] abort If non-zero, invoked when I/O is interrupted
+        //! (in case of user-interrupt, return, otherwise retry).
+        //! @param [in,out] report Where to report error.
+        //! @param [out] timestamp When not null, return the receive timestamp in micro-seconds.
+        //! If the returned value is negative, no timestamp is available.
+        //! @param [in] max_wait Maximum time to wait for a message in milliseconds, when an event loop
+        //! is used. If no message is received within that time, return true with @a ret_size set to zero.
+        //! This is not an error, unlike the reception timeout. No maximum if zero or negative.
+        //! @return True on success, false on error or timeout.
+        //!
+        bool receive(void* data,
+                     size_t max_size,
+                     size_t& ret_size,
+                     size_t& index,
+                     const AbortInterface* abort = nullptr,
+                     Report& report = CERR,
+                     MicroSecond* timestamp = nullptr,
+                     MilliSecond max_wait = 0);
+
+    private:
+        typedef SafePtr<UDPReceiver, NullMutex> UDPReceiverPtr;
+
+        Report&                     _report;             // Report for the receivers.
+        MilliSecond                 _recv_timeout {-1};  // Receive timeout, as set by setReceiveTimeoutArg().
+        std::vector<UDPReceiverPtr> _receivers {};       // All UDP receivers.
+        std::vector<size_t>         _ready {};           // Indexes of receivers with pending messages, not yet serviced.
+        size_t                      _next_ready {0};     // Next index in _ready to service.
+        bool                        _event_loop {false}; // Receivers are serviced from an event loop.
+        Time                        _last_receive {};    // Time of last received message, for the reception timeout.
+#if defined(TS_LINUX)
+        int                         _epoll {-1};         // Epoll file descriptor.
+        std::vector<::epoll_event>  _events {};          // Events from epoll_wait(), one per receiver.
+#else
+        std::vector<::pollfd>       _pollfds {};         // Sockets to poll, one per receiver.
+#endif
+
+        // Wait for at least one receiver to have pending messages. Fill _ready.
+        // Return true with an empty _ready when max_wait expires.
+        bool waitReady(MilliSecond max_wait, const AbortInterface* abort, Report& report);
+
+        // Receive one message on one receiver, depending on its IP generation.
+        bool receiveOne(UDPReceiver& rec, void* data, size_t max_size, size_t& ret_size, const AbortInterface* abort, Report& report, MicroSecond* timestamp);
+    };
+}
@@ -69,11 +69,40 @@ ts::UDPSocket::~UDPSocket()
 //----------------------------------------------------------------------------
 
 bool ts::UDPSocket::open(Report& report)
+{
+    return open(IP::v4, report);
+}
+
+bool ts::UDPSocket::open(IP gen, Report& report)
 {
     // Create a datagram socket.
-    if (!createSocket(PF_INET, SOCK_DGRAM, IPPROTO_UDP, report)) {
+    if (!createSocket(gen == IP::v6 ? PF_INET6 : PF_INET, SOCK_DGRAM, IPPROTO_UDP, report)) {
         return false;
     }
+    _gen = gen == IP::v6 ? IP::v6 : IP::v4;
+
+    if (_gen == IP::v6) {
+        // Pure IPv6 socket, IPv4-mapped addresses are not used.
+        int opt = 1;
+        if (::setsockopt(getSocket(), IPPROTO_IPV6, IPV6_V6ONLY, SysSockOptPointer(&opt), sizeof(opt)) != 0) {
+            report.error(u"error setting socket IPV6_V6ONLY option: %s", {SysSocketErrorCodeMessage()});
+            return false;
+        }
+        // Get the destination address of all UDP packets arriving on this socket.
+        // IPV6_RECVPKTINFO is the RFC 3542 name, IPV6_PKTINFO is the older RFC 2292 one.
+#if defined(IPV6_RECVPKTINFO)
+        if (::setsockopt(getSocket(), IPPROTO_IPV6, IPV6_RECVPKTINFO, SysSockOptPointer(&opt), sizeof(opt)) != 0) {
+            report.error(u"error setting socket IPV6_RECVPKTINFO option: %s", {SysSocketErrorCodeMessage()});
+            return false;
+        }
+#else
+        if (::setsockopt(getSocket(), IPPROTO_IPV6, IPV6_PKTINFO, SysSockOptPointer(&opt), sizeof(opt)) != 0) {
+            report.error(u"error setting socket IPV6_PKTINFO option: %s", {SysSocketErrorCodeMessage()});
+            return false;
+        }
+#endif
+        return true;
+    }
 
     // Set the IP_PKTINFO option. This option is used to get the destination address of all
     // UDP packets arriving on this socket. Actual socket option is an int.
@@ -119,6 +148,10 @@ bool ts::UDPSocket::close(Report& report)
 
 bool ts::UDPSocket::bind(const IPv4SocketAddress& addr, Report& report)
 {
+    if (!checkGeneration(IP::v4, report)) {
+        return false;
+    }
+
     ::sockaddr sock_addr;
     addr.copy(sock_addr);
 
@@ -132,6 +165,45 @@ bool ts::UDPSocket::bind(const IPv4SocketAddress& addr, Report& report)
     return getLocalAddress(_local_address, report);
 }
 
+bool ts::UDPSocket::bind(const IPv6SocketAddress& addr, Report& report)
+{
+    if (!checkGeneration(IP::v6, report)) {
+        return false;
+    }
+
+    // The interface scope identifier of link-local addresses is not supported.
+    if (addr.isLinkLocal()) {
+        report.error(u"cannot bind to link-local IPv6 address %s, use a global address or the any address", {IPv6Address(addr)});
+        return false;
+    }
+
+    ::sockaddr_in6 sock_addr;
+    addr.copy(sock_addr);
+
+    report.debug(u"binding socket to %s", {addr});
+    if (::bind(getSocket(), reinterpret_cast<::sockaddr*>(&sock_addr), sizeof(sock_addr)) != 0) {
+        report.error(u"error binding socket to local address: %s", {SysSocketErrorCodeMessage()});
+        return false;
+    }
+
+    // Keep a cached value of the bound local address.
+    return getLocalAddress(_local_address6, report);
+}
+
+
+//----------------------------------------------------------------------------
+// Check that the socket uses the expected IP generation.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::checkGeneration(IP gen, Report& report) const
+{
+    if (gen != _gen) {
+        report.error(u"cannot use an IPv%d address on an IPv%d socket", {int(gen), int(_gen)});
+        return false;
+    }
+    return true;
+}
+
 
 //----------------------------------------------------------------------------
 // Set outgoing local address for multicast messages.
@@ -140,12 +212,36 @@ bool ts::UDPSocket::bind(const IPv4SocketAddress& addr, Report& report)
 
 bool ts::UDPSocket::setOutgoingMulticast(const UString& name, Report& report)
 {
-    IPv4Address addr;
-    return addr.resolve(name, report) && setOutgoingMulticast(addr, report);
+    if (_gen == IP::v6) {
+        unsigned int index = 0;
+        return GetIPv6InterfaceIndex(name, index, report) && setOutgoingMulticastInterface(index, report);
+    }
+    else {
+        IPv4Address addr;
+        return addr.resolve(name, report) && setOutgoingMulticast(addr, report);
+    }
+}
+
+bool ts::UDPSocket::setOutgoingMulticastInterface(unsigned int index, Report& report)
+{
+    if (!checkGeneration(IP::v6, report)) {
+        return false;
+    }
+
+    // Actual socket option is an unsigned int, even on Windows.
+    if (::setsockopt(getSocket(), IPPROTO_IPV6, IPV6_MULTICAST_IF, SysSockOptPointer(&index), sizeof(index)) != 0) {
+        report.error(u"error setting outgoing local interface: " + SysSocketErrorCodeMessage());
+        return false;
+    }
+    return true;
 }
 
 bool ts::UDPSocket::setOutgoingMulticast(const IPv4Address& addr, Report& report)
 {
+    if (!checkGeneration(IP::v4, report)) {
+        return false;
+    }
+
     ::in_addr iaddr;
     addr.copy(iaddr);
 
@@ -165,8 +261,30 @@ bool ts::UDPSocket::setOutgoingMulticast(const IPv4Address& addr, Report& report
 
 bool ts::UDPSocket::setDefaultDestination(const UString& name, Report& report)
 {
-    IPv4SocketAddress addr;
-    return addr.resolve(name, report) && setDefaultDestination(addr, report);
+    if (IPStringGeneration(name) == IP::v6) {
+        IPv6SocketAddress addr;
+        return addr.resolve(name, report) && setDefaultDestination(addr, report);
+    }
+    else {
+        IPv4SocketAddress addr;
+        return addr.resolve(name, report) && setDefaultDestination(addr, report);
+    }
+}
+
+bool ts::UDPSocket::setDefaultDestination(const IPv6SocketAddress& addr, Report& report)
+{
+    if (!addr.hasAddress()) {
+        report.error(u"missing IP address in UDP destination");
+        return false;
+    }
+    else if (!addr.hasPort()) {
+        report.error(u"missing port number in UDP destination");
+        return false;
+    }
+    else {
+        _default_destination6 = addr;
+        return true;
+    }
 }
 
 bool ts::UDPSocket::setDefaultDestination(const IPv4SocketAddress& addr, Report& report)
@@ -192,7 +310,15 @@ bool ts::UDPSocket::setDefaultDestination(const IPv4SocketAddress& addr, Report&
 
 bool ts::UDPSocket::setTTL(int ttl, bool multicast, Report& report)
 {
-    if (multicast) {
+    if (_gen == IP::v6) {
+        // Hop limits are int on all systems, including Windows.
+        const int hops = ttl;
+        if (::setsockopt(getSocket(), IPPROTO_IPV6, multicast ? IPV6_MULTICAST_HOPS : IPV6_UNICAST_HOPS, SysSockOptPointer(&hops), sizeof(hops)) != 0) {
+            report.error(u"socket option %s hop limit: %s", {multicast ? u"multicast" : u"unicast", SysSocketErrorCodeMessage()});
+            return false;
+        }
+    }
+    else if (multicast) {
         SysSocketMulticastTTLType mttl = SysSocketMulticastTTLType(ttl);
         if (::setsockopt(getSocket(), IPPROTO_IP, IP_MULTICAST_TTL, SysSockOptPointer(&mttl), sizeof(mttl)) != 0) {
             report.error(u"socket option multicast TTL: " + SysSocketErrorCodeMessage());
@@ -216,6 +342,16 @@ bool ts::UDPSocket::setTTL(int ttl, bool multicast, Report& report)
 
 bool ts::UDPSocket::setTOS(int tos, Report& report)
 {
+    if (_gen == IP::v6) {
+        // The IPv6 traffic class replaces the IPv4 TOS. Actual socket option is an int.
+        const int tclass = tos;
+        if (::setsockopt(getSocket(), IPPROTO_IPV6, IPV6_TCLASS, SysSockOptPointer(&tclass), sizeof(tclass)) != 0) {
+            report.error(u"socket option traffic class: " + SysSocketErrorCodeMessage());
+            return false;
+        }
+        return true;
+    }
+
     SysSocketTOSType utos = SysSocketTOSType(tos);
     if (::setsockopt(getSocket(), IPPROTO_IP, IP_TOS, SysSockOptPointer(&utos), sizeof(utos)) != 0) {
         report.error(u"socket option TOS: " + SysSocketErrorCodeMessage());
@@ -231,6 +367,17 @@ bool ts::UDPSocket::setTOS(int tos, Report& report)
 
 bool ts::UDPSocket::setMulticastLoop(bool on, Report& report)
 {
+    if (_gen == IP::v6) {
+        // Actual socket option is an unsigned int on all systems.
+        const unsigned int mloop6 = on;
+        report.debug(u"setting socket IPV6_MULTICAST_LOOP to %d", {mloop6});
+        if (::setsockopt(getSocket(), IPPROTO_IPV6, IPV6_MULTICAST_LOOP, SysSockOptPointer(&mloop6), sizeof(mloop6)) != 0) {
+            report.error(u"socket option multicast loop: " + SysSocketErrorCodeMessage());
+            return false;
+        }
+        return true;
+    }
+
     SysSocketMulticastLoopType mloop = SysSocketMulticastLoopType(on);
     report.debug(u"setting socket IP_MULTICAST_LOOP to %d", {mloop});
     if (::setsockopt(getSocket(), IPPROTO_IP, IP_MULTICAST_LOOP, SysSockOptPointer(&mloop), sizeof(mloop)) != 0) {
@@ -306,6 +453,10 @@ bool ts::UDPSocket::setBroadcastIfRequired(const IPv4Address destination, Report
 
 bool ts::UDPSocket::addMembership(const IPv4Address& multicast, const IPv4Address& local, const IPv4Address& source, Report& report)
 {
+    if (!checkGeneration(IP::v4, report)) {
+        return false;
+    }
+
     // Verbose message about joining the group.
     UString groupString;
     if (source.hasAddress()) {
@@ -390,6 +541,98 @@ bool ts::UDPSocket::addMembershipAll(const IPv4Address& multicast, const IPv4Add
 }
 
 
+//----------------------------------------------------------------------------
+// Join one IPv6 multicast group on one local interface.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::addMembership(const IPv6Address& multicast, unsigned int interface_index, const IPv6Address& source, Report& report)
+{
+    if (!checkGeneration(IP::v6, report)) {
+        return false;
+    }
+
+    // Verbose message about joining the group.
+    UString groupString;
+    if (source.hasAddress()) {
+        groupString = source.toString() + u"@";
+    }
+    groupString += multicast.toString();
+    if (interface_index != 0) {
+        report.verbose(u"joining multicast group %s from local interface %d", {groupString, interface_index});
+    }
+    else {
+        report.verbose(u"joining multicast group %s from default interface", {groupString});
+    }
+
+    // Now join the group.
+    if (source.hasAddress()) {
+        // Source-specific multicast (SSM), MLDv2 source-specific join.
+#if defined(TS_NO_SSM)
+        report.error(u"source-specific multicast (SSM) is not supported on this operating system");
+        return false;
+#else
+        SSMReq6 req(multicast, interface_index, source);
+        if (::setsockopt(getSocket(), IPPROTO_IPV6, MCAST_JOIN_SOURCE_GROUP, SysSockOptPointer(&req.data), sizeof(req.data)) != 0) {
+            report.error(u"error adding SSM membership to %s from local interface %d: %s", {groupString, interface_index, SysSocketErrorCodeMessage()});
+            return false;
+        }
+        else {
+            _ssmcast6.insert(req);
+            return true;
+        }
+#endif
+    }
+    else {
+        // Standard multicast.
+        MReq6 req(multicast, interface_index);
+        if (::setsockopt(getSocket(), IPPROTO_IPV6, IPV6_JOIN_GROUP, SysSockOptPointer(&req.data), sizeof(req.data)) != 0) {
+            report.error(u"error adding multicast membership to %s from local interface %d: %s", {groupString, interface_index, SysSocketErrorCodeMessage()});
+            return false;
+        }
+        else {
+            _mcast6.insert(req);
+            return true;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Join one IPv6 multicast group, let the system select the local interface.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::addMembershipDefault(const IPv6Address& multicast, const IPv6Address& source, Report& report)
+{
+    return addMembership(multicast, 0, source, report);
+}
+
+
+//----------------------------------------------------------------------------
+// Join one IPv6 multicast group on all local interfaces.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::addMembershipAll(const IPv6Address& multicast, const IPv6Address& source, Report& report)
+{
+    // Get all local interfaces which can receive IPv6 multicast.
+    std::vector<unsigned int> indexes;
+    if (!GetIPv6MulticastInterfaces(indexes, report)) {
+        return false;
+    }
+
+    // If the list is not available, let the system choose.
+    if (indexes.empty()) {
+        return addMembership(multicast, 0, source, report);
+    }
+
+    // Add all memberships
+    bool ok = true;
+    for (auto index : indexes) {
+        ok = addMembership(multicast, index, source, report) && ok;
+    }
+    return ok;
+}
+
+
 //----------------------------------------------------------------------------
 // Leave all multicast groups.
 //----------------------------------------------------------------------------
@@ -421,6 +664,31 @@ bool ts::UDPSocket::dropMembership(Report& report)
     _ssmcast.clear();
 #endif
 
+    // Drop all IPv6 standard multicast groups.
+    for (const auto& it : _mcast6) {
+        report.verbose(u"leaving multicast group %s from local interface %d", {IPv6Address(it.data.ipv6mr_multiaddr), it.data.ipv6mr_interface});
+        if (::setsockopt(getSocket(), IPPROTO_IPV6, IPV6_LEAVE_GROUP, SysSockOptPointer(&it.data), sizeof(it.data)) != 0) {
+            report.error(u"error dropping multicast membership: %s", {SysSocketErrorCodeMessage()});
+            ok = false;
+        }
+    }
+    _mcast6.clear();
+
+    // Drop all IPv6 source-specific multicast groups.
+#if !defined(TS_NO_SSM)
+    for (const auto& it : _ssmcast6) {
+        report.verbose(u"leaving multicast group %s@%s from local interface %d",
+                       {IPv6Address(*reinterpret_cast<const ::sockaddr_in6*>(&it.data.gsr_source)),
+                        IPv6Address(*reinterpret_cast<const ::sockaddr_in6*>(&it.data.gsr_group)),
+                        it.data.gsr_interface});
+        if (::setsockopt(getSocket(), IPPROTO_IPV6, MCAST_LEAVE_SOURCE_GROUP, SysSockOptPointer(&it.data), sizeof(it.data)) != 0) {
+            report.error(u"error dropping multicast membership: %s", {SysSocketErrorCodeMessage()});
+            ok = false;
+        }
+    }
+    _ssmcast6.clear();
+#endif
+
     return ok;
 }
 
@@ -431,11 +699,42 @@ bool ts::UDPSocket::dropMembership(Report& report)
 
 bool ts::UDPSocket::send(const void* data, size_t size, Report& report)
 {
-    return send(data, size, _default_destination, report);
+    if (_gen == IP::v6) {
+        return send(data, size, _default_destination6, report);
+    }
+    else {
+        return send(data, size, _default_destination, report);
+    }
+}
+
+bool ts::UDPSocket::send(const void* data, size_t size, const IPv6SocketAddress& dest, Report& report)
+{
+    if (!checkGeneration(IP::v6, report)) {
+        return false;
+    }
+
+    // Without interface scope identifier, a link-local unicast destination is ambiguous.
+    if (dest.isLinkLocal() && !dest.isMulticast()) {
+        report.error(u"cannot send to link-local IPv6 address %s, use a global address", {IPv6Address(dest)});
+        return false;
+    }
+
+    ::sockaddr_in6 addr;
+    dest.copy(addr);
+
+    if (::sendto(getSocket(), SysSendBufferPointer(data), SysSendSizeType(size), 0, reinterpret_cast<::sockaddr*>(&addr), sizeof(addr)) < 0) {
+        report.error(u"error sending UDP message: " + SysSocketErrorCodeMessage());
+        return false;
+    }
+    return true;
 }
 
 bool ts::UDPSocket::send(const void* data, size_t size, const IPv4SocketAddress& dest, Report& report)
 {
+    if (!checkGeneration(IP::v4, report)) {
+        return false;
+    }
+
     ::sockaddr addr;
     dest.copy(addr);
 
@@ -462,6 +761,60 @@ bool ts::UDPSocket::receive(void* data,
                             const AbortInterface* abort,
                             Report& report,
                             MicroSecond* timestamp)
+{
+    ::sockaddr_storage sender_sock;
+    ::sockaddr_storage dest_sock;
+    const bool ok = checkGeneration(IP::v4, report) && receiveLoop(data, max_size, ret_size, sender_sock, dest_sock, abort, report, timestamp);
+    sender = ok ? IPv4SocketAddress(*reinterpret_cast<const ::sockaddr_in*>(&sender_sock)) : IPv4SocketAddress();
+    destination = ok ? IPv4SocketAddress(*reinterpret_cast<const ::sockaddr_in*>(&dest_sock)) : IPv4SocketAddress();
+    return ok;
+}
+
+bool ts::UDPSocket::receive(void* data,
+                            size_t max_size,
+                            size_t& ret_size,
+                            IPv6SocketAddress& sender,
+                            IPv6SocketAddress& destination,
+                            const AbortInterface* abort,
+                            Report& report,
+                            MicroSecond* timestamp)
+{
+    ::sockaddr_storage sender_sock;
+    ::sockaddr_storage dest_sock;
+    const bool ok = checkGeneration(IP::v6, report) && receiveLoop(data, max_size, ret_size, sender_sock, dest_sock, abort, report, timestamp);
+    sender = ok ? IPv6SocketAddress(*reinterpret_cast<const ::sockaddr_in6*>(&sender_sock)) : IPv6SocketAddress();
+    destination = ok ? IPv6SocketAddress(*reinterpret_cast<const ::sockaddr_in6*>(&dest_sock)) : IPv6SocketAddress();
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Receive loop on unsollicited interrupts, with system socket addresses.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Check if a system socket address contains an IP address.
+    bool HasAddress(const ::sockaddr_storage& addr)
+    {
+        switch (addr.ss_family) {
+            case AF_INET:
+                return reinterpret_cast<const ::sockaddr_in*>(&addr)->sin_addr.s_addr != 0;
+            case AF_INET6:
+                return ts::IPv6Address(*reinterpret_cast<const ::sockaddr_in6*>(&addr)).hasAddress();
+            default:
+                return false;
+        }
+    }
+}
+
+bool ts::UDPSocket::receiveLoop(void* data,
+                                size_t max_size,
+                                size_t& ret_size,
+                                ::sockaddr_storage& sender,
+                                ::sockaddr_storage& destination,
+                                const AbortInterface* abort,
+                                Report& report,
+                                MicroSecond* timestamp)
 {
     // Clear timestamp if specified.
     if (timestamp != nullptr) {
@@ -480,10 +833,14 @@ bool ts::UDPSocket::receive(void* data,
         }
         else if (err == SYS_SUCCESS) {
             // Sometimes, we get "successful" empty message coming from nowhere. Ignore them.
-            if (ret_size > 0 || sender.hasAddress()) {
+            if (ret_size > 0 || HasAddress(sender)) {
                 return true;
             }
         }
+        else if (isNonBlocking() && err == SYS_SOCKET_ERR_WOULDBLOCK) {
+            // No message currently available on a non-blocking socket, ret_size is zero.
+            return true;
+        }
         else if (abort != nullptr && abort->aborting()) {
             // User-interrupt, end of processing but no error message
             return false;
@@ -513,19 +870,15 @@ bool ts::UDPSocket::receive(void* data,
 ts::SysSocketErrorCode ts::UDPSocket::receiveOne(void* data,
                                                  size_t max_size,
                                                  size_t& ret_size,
-                                                 IPv4SocketAddress& sender,
-                                                 IPv4SocketAddress& destination,
+                                                 ::sockaddr_storage& sender,
+                                                 ::sockaddr_storage& destination,
                                                  Report& report,
                                                  MicroSecond* timestamp)
 {
-    // Clear returned values
+    // Clear returned values. The sender socket address is directly received in sender.
     ret_size = 0;
-    sender.clear();
-    destination.clear();
-
-    // Reserve a socket address to receive the sender address.
-    ::sockaddr sender_sock;
-    TS_ZERO(sender_sock);
+    TS_ZERO(sender);
+    TS_ZERO(destination);
 
     // Normally, this operation should be done quite easily using recvmsg.
     // On Windows, all socket operations are smoothly emulated, including
@@ -570,8 +923,8 @@ ts::SysSocketErrorCode ts::UDPSocket::receiveOne(void* data,
     // Build a WSAMSG for WSARecvMsg.
     ::WSAMSG msg;
     TS_ZERO(msg);
-    msg.name = &sender_sock;
-    msg.namelen = sizeof(sender_sock);
+    msg.name = reinterpret_cast<::sockaddr*>(&sender);
+    msg.namelen = sizeof(sender);
     msg.lpBuffers = &vec;
     msg.dwBufferCount = 1; // number of WSAMSG
     msg.Control.buf = ancil_data;
@@ -587,7 +940,11 @@ ts::SysSocketErrorCode ts::UDPSocket::receiveOne(void* data,
     for (::WSACMSGHDR* cmsg = WSA_CMSG_FIRSTHDR(&msg); cmsg != 0; cmsg = WSA_CMSG_NXTHDR(&msg, cmsg)) {
         if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO) {
             const ::IN_PKTINFO* info = reinterpret_cast<const ::IN_PKTINFO*>(WSA_CMSG_DATA(cmsg));
-            destination = IPv4SocketAddress(info->ipi_addr, _local_address.port());
+            IPv4SocketAddress(info->ipi_addr, _local_address.port()).copy(*reinterpret_cast<::sockaddr_in*>(&destination));
+        }
+        else if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO) {
+            const ::IN6_PKTINFO* info = reinterpret_cast<const ::IN6_PKTINFO*>(WSA_CMSG_DATA(cmsg));
+            IPv6SocketAddress(info->ipi6_addr, _local_address6.port()).copy(*reinterpret_cast<::sockaddr_in6*>(&destination));
         }
     }
 
@@ -607,8 +964,8 @@ ts::SysSocketErrorCode ts::UDPSocket::receiveOne(void* data,
     // Build a msghdr structure for recvmsg().
     ::msghdr hdr;
     TS_ZERO(hdr);
-    hdr.msg_name = &sender_sock;
-    hdr.msg_namelen = sizeof(sender_sock);
+    hdr.msg_name = &sender;
+    hdr.msg_namelen = sizeof(sender);
     hdr.msg_iov = &vec;
     hdr.msg_iovlen = 1; // number of iovec structures
     hdr.msg_control = ancil_data;
@@ -635,15 +992,21 @@ ts::SysSocketErrorCode ts::UDPSocket::receiveOne(void* data,
 #if defined(IP_PKTINFO)
         if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO && cmsg->cmsg_len >= sizeof(::in_pktinfo)) {
             const ::in_pktinfo* info = reinterpret_cast<const ::in_pktinfo*>(CMSG_DATA(cmsg));
-            destination = IPv4SocketAddress(info->ipi_addr, _local_address.port());
+            IPv4SocketAddress(info->ipi_addr, _local_address.port()).copy(*reinterpret_cast<::sockaddr_in*>(&destination));
         }
 #elif defined(IP_RECVDSTADDR)
         if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_RECVDSTADDR && cmsg->cmsg_len >= sizeof(::in_addr)) {
             const ::in_addr* info = reinterpret_cast<const ::in_addr*>(CMSG_DATA(cmsg));
-            destination = IPv4SocketAddress(*info, _local_address.port());
+            IPv4SocketAddress(*info, _local_address.port()).copy(*reinterpret_cast<::sockaddr_in*>(&destination));
         }
 #endif
 
+        // Look for destination IPv6 address.
+        else if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO && cmsg->cmsg_len >= sizeof(::in6_pktinfo)) {
+            const ::in6_pktinfo* info = reinterpret_cast<const ::in6_pktinfo*>(CMSG_DATA(cmsg));
+            IPv6SocketAddress(info->ipi6_addr, _local_address6.port()).copy(*reinterpret_cast<::sockaddr_in6*>(&destination));
+        }
+
         // On Linux, look for receive timestamp.
 #if defined(TS_LINUX)
         else if (timestamp != nullptr && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMPNS && cmsg->cmsg_len >= sizeof(::timespec)) {
@@ -664,7 +1027,6 @@ ts::SysSocketErrorCode ts::UDPSocket::receiveOne(void* data,
 
     // Successfully received a message
     ret_size = size_t(insize);
-    sender = IPv4SocketAddress(sender_sock);
 
     return SYS_SUCCESS;
 }
@@ -35,6 +35,7 @@
 #pragma once
 #include "tsSocket.h"
 #include "tsIPv4SocketAddress.h"
+#include "tsIPv6SocketAddress.h"
 #include "tsIPUtils.h"
 #include "tsAbortInterface.h"
 #include "tsReport.h"
@@ -52,6 +53,14 @@ namespace ts {
     //! UDP Socket.
     //! @ingroup net
     //!
+    //! A UDP socket is either IPv4 or IPv6, as specified when the socket is opened.
+    //! Each method which uses an address exists in two versions, using either IPv4
+    //! or IPv6 addresses. The version which is used must match the IP generation
+    //! of the socket.
+    //!
+    //! On IPv6 sockets, local network interfaces are identified by their index,
+    //! as returned by GetIPv6InterfaceIndex().
+    //!
     class TSDUCKDLL UDPSocket: public Socket
     {
         TS_NOCOPY(UDPSocket);
@@ -68,6 +77,20 @@ namespace ts {
         //!
         virtual ~UDPSocket() override;
 
+        //!
+        //! Open the socket for a given IP generation.
+        //! @param [in] gen IP generation of the socket. IP::Any means IPv4.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool open(IP gen, Report& report = CERR);
+
+        //!
+        //! Get the IP generation of the socket.
+        //! @return The IP generation of the socket, as specified in the last call to open().
+        //!
+        IP generation() const { return _gen; }
+
         //!
         //! Bind to a local address and port.
         //!
@@ -98,6 +121,16 @@ namespace ts {
         //!
         bool bind(const IPv4SocketAddress& addr, Report& report = CERR);
 
+        //!
+        //! Bind an IPv6 socket to a local address and port.
+        //! Same as the IPv4 version, using IPv6Address::AnyAddress for any local interface.
+        //! Link-local addresses are rejected since they require an interface scope identifier.
+        //! @param [in] addr Local socket address to bind to.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool bind(const IPv6SocketAddress& addr, Report& report = CERR);
+
         //!
         //! Set a default destination address and port for outgoing messages.
         //!
@@ -114,6 +147,15 @@ namespace ts {
         //!
         bool setDefaultDestination(const IPv4SocketAddress& addr, Report& report = CERR);
 
+        //!
+        //! Set a default IPv6 destination address and port for outgoing messages.
+        //! @param [in] addr Socket address of the destination.
+        //! Both address and port are mandatory in the socket address.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool setDefaultDestination(const IPv6SocketAddress& addr, Report& report = CERR);
+
         //!
         //! Set a default destination address and port for outgoing messages.
         //!
@@ -123,7 +165,8 @@ namespace ts {
         //! destination</i>.
         //!
         //! @param [in] name A string describing the socket address of the destination.
-        //! See IPv4SocketAddress::resolve() for a description of the expected string format.
+        //! See IPv4SocketAddress::resolve() and IPv6SocketAddress::resolve() for a description
+        //! of the expected string format. IPv6 addresses are recognized using IPStringGeneration().
         //! @param [in,out] report Where to report error.
         //! @return True on success, false on error.
         //!
@@ -135,6 +178,12 @@ namespace ts {
         //!
         IPv4SocketAddress getDefaultDestination() const {return _default_destination;}
 
+        //!
+        //! Get the default IPv6 destination address and port for outgoing messages.
+        //! @return The default IPv6 destination address and port for outgoing messages.
+        //!
+        IPv6SocketAddress getDefaultDestinationIPv6() const {return _default_destination6;}
+
         //!
         //! Set the outgoing local interface for multicast messages.
         //!
@@ -149,14 +198,26 @@ namespace ts {
         //!
         //! @param [in] name A string describing the IP address of a local interface.
         //! See IPv4Address::resolve() for a description of the expected string format.
+        //! On IPv6 sockets, see GetIPv6InterfaceIndex() for a description of the expected string format.
         //! @param [in,out] report Where to report error.
         //! @return True on success, false on error.
         //!
         bool setOutgoingMulticast(const UString& name, Report& report = CERR);
 
+        //!
+        //! Set the outgoing local interface for multicast messages on an IPv6 socket.
+        //!
+        //! @param [in] index Index of a local interface. Zero means the default interface.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool setOutgoingMulticastInterface(unsigned int index, Report& report = CERR);
+
         //!
         //! Set the Time To Live (TTL) option.
         //!
+        //! On IPv6 sockets, the <i>hop limit</i> options are used.
+        //!
         //! @param [in] ttl The TTL value, ie. the maximum number of "hops" between
         //! routers before an IP packet is dropped.
         //! @param [in] multicast When true, set the <i>multicast TTL</i> option.
@@ -179,7 +240,7 @@ namespace ts {
         //!
         bool setTTL(int ttl, Report& report = CERR)
         {
-            return setTTL(ttl, _default_destination.isMulticast(), report);
+            return setTTL(ttl, _gen == IP::v6 ? _default_destination6.isMulticast() : _default_destination.isMulticast(), report);
         }
 
         //!
@@ -187,6 +248,7 @@ namespace ts {
         //!
         //! Note that correct support for this option depends on the operating
         //! system. Typically, it never worked correctly on Windows.
+        //! On IPv6 sockets, the <i>traffic class</i> option is used.
         //!
         //! @param [in] tos The TOS value.
         //! @param [in,out] report Where to report error.
@@ -292,6 +354,45 @@ namespace ts {
         //!
         bool addMembershipDefault(const IPv4Address& multicast, const IPv4Address& source = IPv4Address(), Report& report = CERR);
 
+        //!
+        //! Join an IPv6 multicast group.
+        //!
+        //! This method indicates that the application wishes to receive multicast
+        //! packets which are sent to a specific multicast address. Specifying a
+        //! non-default @a source address, source-specific multicast (SSM) is used
+        //! (MLDv2 source-specific join).
+        //!
+        //! @param [in] multicast Multicast IPv6 address to listen to.
+        //! @param [in] interface_index Index of the local interface on which to listen.
+        //! If zero, the application lets the system selects the appropriate local interface.
+        //! @param [in] source Source address for SSM.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool addMembership(const IPv6Address& multicast, unsigned int interface_index, const IPv6Address& source = IPv6Address(), Report& report = CERR);
+
+        //!
+        //! Join an IPv6 multicast group on all local interfaces which support IPv6 multicast.
+        //! If the list of local interfaces is not available, let the system select the
+        //! appropriate local interface.
+        //!
+        //! @param [in] multicast Multicast IPv6 address to listen to.
+        //! @param [in] source Source address for SSM.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool addMembershipAll(const IPv6Address& multicast, const IPv6Address& source = IPv6Address(), Report& report = CERR);
+
+        //!
+        //! Join an IPv6 multicast group, let the system select the appropriate local interface.
+        //!
+        //! @param [in] multicast Multicast IPv6 address to listen to.
+        //! @param [in] source Source address for SSM.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool addMembershipDefault(const IPv6Address& multicast, const IPv6Address& source = IPv6Address(), Report& report = CERR);
+
         //!
         //! Drop all multicast membership requests, including source-specific multicast.
         //! @param [in,out] report Where to report error.
@@ -312,6 +413,19 @@ namespace ts {
         //!
         virtual bool send(const void* data, size_t size, const IPv4SocketAddress& destination, Report& report = CERR);
 
+        //!
+        //! Send a message to an IPv6 destination address and port.
+        //! Link-local unicast destinations are rejected since they require an interface scope
+        //! identifier. Link-local multicast destinations use the outgoing multicast interface.
+        //!
+        //! @param [in] data Address of the message to send.
+        //! @param [in] size Size in bytes of the message to send.
+        //! @param [in] destination Socket address of the destination.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        virtual bool send(const void* data, size_t size, const IPv6SocketAddress& destination, Report& report = CERR);
+
         //!
         //! Send a message to the default destination address and port.
         //!
@@ -325,6 +439,9 @@ namespace ts {
         //!
         //! Receive a message.
         //!
+        //! On a non-blocking socket (see setNonBlocking()), this method returns
+        //! true with @a ret_size set to zero when no message is currently available.
+        //!
         //! @param [out] data Address of the buffer for the received message.
         //! @param [in] max_size Size in bytes of the reception buffer.
         //! @param [out] ret_size Size in bytes of the received message.
@@ -349,6 +466,30 @@ namespace ts {
                              Report& report = CERR,
                              MicroSecond* timestamp = nullptr);
 
+        //!
+        //! Receive a message on an IPv6 socket.
+        //!
+        //! @param [out] data Address of the buffer for the received message.
+        //! @param [in] max_size Size in bytes of the reception buffer.
+        //! @param [out] ret_size Size in bytes of the received message.
+        //! Will never be larger than @a max_size.
+        //! @param [out] sender Socket address of the sender.
+        //! @param [out] destination Socket address of the packet destination.
+        //! @param [in] abort If non-zero, invoked when I/O is interrupted.
+        //! @param [in,out] report Where to report error.
+        //! @param [out] timestamp When not null, return the receive timestamp in micro-seconds.
+        //! @return True on success, false on error.
+        //! @see receive(void*, size_t, size_t&, IPv4SocketAddress&, IPv4SocketAddress&, const AbortInterface*, Report&, MicroSecond*)
+        //!
+        virtual bool receive(void* data,
+                             size_t max_size,
+                             size_t& ret_size,
+                             IPv6SocketAddress& sender,
+                             IPv6SocketAddress& destination,
+                             const AbortInterface* abort = nullptr,
+                             Report& report = CERR,
+                             MicroSecond* timestamp = nullptr);
+
         // Implementation of Socket interface.
         virtual bool open(Report& report = CERR) override;
         virtual bool close(Report& report = CERR) override;
@@ -403,16 +544,56 @@ namespace ts {
         typedef std::set<SSMReq> SSMReqSet;
 #endif
 
+        // Encapsulate an ipv6_mreq
+        struct MReq6 : public POCS<::ipv6_mreq>
+        {
+            typedef POCS<::ipv6_mreq> SuperClass;
+            MReq6() = default;
+            MReq6(const IPv6Address& multicast_, unsigned int interface_) : SuperClass()
+            {
+                multicast_.copy(data.ipv6mr_multiaddr);
+                data.ipv6mr_interface = interface_;
+            }
+        };
+        typedef std::set<MReq6> MReq6Set;
+
+        // Encapsulate a group_source_req (protocol-independent SSM, used for IPv6)
+#if !defined(TS_NO_SSM)
+        struct SSMReq6 : public POCS<::group_source_req>
+        {
+            typedef POCS<::group_source_req> SuperClass;
+            SSMReq6() = default;
+            SSMReq6(const IPv6Address& multicast_, unsigned int interface_, const IPv6Address& source_) : SuperClass()
+            {
+                data.gsr_interface = interface_;
+                multicast_.copy(*reinterpret_cast<::sockaddr_in6*>(&data.gsr_group), IPv6SocketAddress::AnyPort);
+                source_.copy(*reinterpret_cast<::sockaddr_in6*>(&data.gsr_source), IPv6SocketAddress::AnyPort);
+            }
+        };
+        typedef std::set<SSMReq6> SSMReq6Set;
+#endif
+
         // Private members
+        IP                _gen {IP::v4};
         IPv4SocketAddress _local_address {};
         IPv4SocketAddress _default_destination {};
+        IPv6SocketAddress _local_address6 {};
+        IPv6SocketAddress _default_destination6 {};
 #if !defined(TS_NO_SSM)
         SSMReqSet         _ssmcast {};  // Current set of source-specific multicast memberships
+        SSMReq6Set        _ssmcast6 {}; // Same for IPv6
 #endif
         MReqSet           _mcast {};    // Current set of multicast memberships
+        MReq6Set          _mcast6 {};   // Same for IPv6
+
+        // Check that the socket uses the expected IP generation.
+        bool checkGeneration(IP gen, Report& report) const;
+
+        // Receive loop on unsollicited interrupts, with system socket addresses.
+        bool receiveLoop(void* data, size_t max_size, size_t& ret_size, ::sockaddr_storage& sender, ::sockaddr_storage& destination, const AbortInterface* abort, Report& report, MicroSecond* timestamp);
 
         // Perform one receive operation. Hide the system mud.
-        SysSocketErrorCode receiveOne(void* data, size_t max_size, size_t& ret_size, IPv4SocketAddress& sender, IPv4SocketAddress& destination, Report& report, MicroSecond* timestamp);
+        SysSocketErrorCode receiveOne(void* data, size_t max_size, size_t& ret_size, ::sockaddr_storage& sender, ::sockaddr_storage& destination, Report& report, MicroSecond* timestamp);
 
         // Furiously idiotic Windows feature, see comment in receiveOne()
 #if defined(TS_WINDOWS)
@@ -0,0 +1,87 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  A subclass of ts::Report which stores messages to be replayed later.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsReport.h"
+
+namespace ts {
+    //!
+    //! A subclass of ts::Report which stores messages to be replayed later on another report.
+    //! @ingroup log
+    //!
+    //! This class is typically used by worker threads which cannot directly log messages
+    //! on the report of the application. All messages are stored with their severity.
+    //! After termination of the thread, the messages are replayed on the report of the
+    //! application, with their original severity.
+    //!
+    //! There is no synchronization. The messages shall be replayed after the termination
+    //! of the thread which logs them.
+    //!
+    class TSDUCKDLL DeferredReport: public Report
+    {
+        TS_NOCOPY(DeferredReport);
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] max_severity Maximum debug level to store.
+        //!
+        explicit DeferredReport(int max_severity = Severity::Info) : Report(max_severity) {}
+
+        //!
+        //! Replay all stored messages on another report, with their original severity.
+        //! The stored messages are then cleared.
+        //! @param [in,out] report Where to replay the messages.
+        //! @return True if no error was reported on this object, false otherwise. Messages
+        //! with lower severities such as warning, verbose or debug are not errors.
+        //!
+        bool replay(Report& report);
+
+        //!
+        //! Clear the stored messages.
+        //!
+        void clearMessages() { _messages.clear(); }
+
+        //!
+        //! Check if there is no stored message.
+        //! @return True if no message is stored, false otherwise.
+        //!
+        bool emptyMessages() const { return _messages.empty(); }
+
+    protected:
+        virtual void writeLog(int severity, const UString& message) override;
+
+    private:
+        std::list<std::pair<int, UString>> _messages {};
+    };
+}
@@ -0,0 +1,304 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsMemoryMappedFile.h"
+#include "tsSysUtils.h"
+
+#if defined(TS_UNIX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/types.h>
+    #include <sys/stat.h>
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+ts::MemoryMappedFile::~MemoryMappedFile()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Open a file and map its content in memory.
+//----------------------------------------------------------------------------
+
+bool ts::MemoryMappedFile::open(const UString& filename, bool sequential, Report& report)
+{
+    if (_data != nullptr) {
+        report.error(u"%s already open", {_filename});
+        return false;
+    }
+    _filename = filename;
+    _size = 0;
+    _writable = false;
+
+#if defined(TS_WINDOWS)
+
+    // Windows implementation.
+    const ::HANDLE file = ::CreateFileW(filename.wc_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                        sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        report.error(u"cannot open %s: %s", {filename, SysErrorCodeMessage()});
+        return false;
+    }
+
+    ::LARGE_INTEGER fsize;
+    bool ok = ::GetFileType(file) == FILE_TYPE_DISK && ::GetFileSizeEx(file, &fsize) != 0;
+    if (!ok) {
+        report.error(u"%s is not a regular file, cannot be mapped in memory", {filename});
+    }
+    else if (fsize.QuadPart <= 0 || uint64_t(fsize.QuadPart) > uint64_t(std::numeric_limits<size_t>::max())) {
+        report.error(u"cannot map %s in memory, file size: %'d bytes", {filename, fsize.QuadPart});
+        ok = false;
+    }
+    else {
+        _mapping = ::CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (_mapping == nullptr) {
+            report.error(u"cannot map %s in memory: %s", {filename, SysErrorCodeMessage()});
+            ok = false;
+        }
+        else {
+            _data = reinterpret_cast<uint8_t*>(::MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+            if (_data == nullptr) {
+                report.error(u"cannot map %s in memory: %s", {filename, SysErrorCodeMessage()});
+                ::CloseHandle(_mapping);
+                _mapping = nullptr;
+                ok = false;
+            }
+            else {
+                _size = size_t(fsize.QuadPart);
+            }
+        }
+    }
+
+    // The file handle is no longer needed, the mapping object keeps a reference on it.
+    ::CloseHandle(file);
+    return ok;
+
+#else
+
+    // UNIX implementation.
+    const int fd = ::open(filename.toUTF8().c_str(), O_RDONLY | O_LARGEFILE);
+    if (fd < 0) {
+        report.error(u"cannot open %s: %s", {filename, SysErrorCodeMessage()});
+        return false;
+    }
+
+    struct stat st;
+    bool ok = ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    if (!ok) {
+        report.error(u"%s is not a regular file, cannot be mapped in memory", {filename});
+    }
+    else if (st.st_size <= 0 || uint64_t(st.st_size) > uint64_t(std::numeric_limits<size_t>::max())) {
+        report.error(u"cannot map %s in memory, file size: %'d bytes", {filename, st.st_size});
+        ok = false;
+    }
+    else {
+        void* addr = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            report.error(u"cannot map %s in memory: %s", {filename, SysErrorCodeMessage()});
+            ok = false;
+        }
+        else {
+            _data = reinterpret_cast<uint8_t*>(addr);
+            _size = size_t(st.st_size);
+            if (sequential) {
+                // This is only a hint, ignore errors.
+                ::posix_madvise(addr, _size, POSIX_MADV_SEQUENTIAL);
+            }
+        }
+    }
+
+    // The file descriptor is no longer needed, the mapping keeps a reference on the file.
+    ::close(fd);
+    return ok;
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Open or create a file and map its content in read-write mode.
+//----------------------------------------------------------------------------
+
+bool ts::MemoryMappedFile::openReadWrite(const UString& filename, size_t size, bool sequential, Report& report)
+{
+    if (_data != nullptr) {
+        report.error(u"%s already open", {_filename});
+        return false;
+    }
+    if (size == 0) {
+        report.error(u"cannot map an empty file in memory");
+        return false;
+    }
+    _filename = filename;
+    _size = 0;
+    _writable = true;
+
+#if defined(TS_WINDOWS)
+
+    // Windows implementation.
+    const ::HANDLE file = ::CreateFileW(filename.wc_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS,
+                                        sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        report.error(u"cannot open %s: %s", {filename, SysErrorCodeMessage()});
+        return false;
+    }
+
+    // Set the file size. The mapping object extends the file but does not truncate it.
+    ::LARGE_INTEGER fsize;
+    fsize.QuadPart = ::LONGLONG(size);
+    bool ok = ::SetFilePointerEx(file, fsize, NULL, FILE_BEGIN) != 0 && ::SetEndOfFile(file) != 0;
+    if (!ok) {
+        report.error(u"cannot set size of %s to %'d bytes: %s", {filename, size, SysErrorCodeMessage()});
+    }
+    else {
+        _mapping = ::CreateFileMappingW(file, NULL, PAGE_READWRITE, ::DWORD(uint64_t(size) >> 32), ::DWORD(size & 0xFFFFFFFF), NULL);
+        if (_mapping == nullptr) {
+            report.error(u"cannot map %s in memory: %s", {filename, SysErrorCodeMessage()});
+            ok = false;
+        }
+        else {
+            _data = reinterpret_cast<uint8_t*>(::MapViewOfFile(_mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+            if (_data == nullptr) {
+                report.error(u"cannot map %s in memory: %s", {filename, SysErrorCodeMessage()});
+                ::CloseHandle(_mapping);
+                _mapping = nullptr;
+                ok = false;
+            }
+            else {
+                _size = size;
+            }
+        }
+    }
+
+    // The file handle is no longer needed, the mapping object keeps a reference on it.
+    ::CloseHandle(file);
+    return ok;
+
+#else
+
+    // UNIX implementation.
+    const int fd = ::open(filename.toUTF8().c_str(), O_RDWR | O_CREAT | O_LARGEFILE, 0666);
+    if (fd < 0) {
+        report.error(u"cannot open %s: %s", {filename, SysErrorCodeMessage()});
+        return false;
+    }
+
+    struct stat st;
+    bool ok = ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    if (!ok) {
+        report.error(u"%s is not a regular file, cannot be mapped in memory", {filename});
+    }
+    else if (uint64_t(st.st_size) != uint64_t(size) && ::ftruncate(fd, ::off_t(size)) != 0) {
+        report.error(u"cannot set size of %s to %'d bytes: %s", {filename, size, SysErrorCodeMessage()});
+        ok = false;
+    }
+#if defined(TS_LINUX)
+    else if (uint64_t(st.st_size) < uint64_t(size)) {
+        // Allocate the disk space of the extended part. Unsupported file systems are silently ignored.
+        const int err = ::posix_fallocate(fd, ::off_t(st.st_size), ::off_t(size - size_t(st.st_size)));
+        if (err == ENOSPC) {
+            report.error(u"not enough disk space for %s, %'d bytes", {filename, size});
+            ok = false;
+        }
+    }
+#endif
+
+    if (ok) {
+        void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            report.error(u"cannot map %s in memory: %s", {filename, SysErrorCodeMessage()});
+            ok = false;
+        }
+        else {
+            _data = reinterpret_cast<uint8_t*>(addr);
+            _size = size;
+            if (sequential) {
+                // This is only a hint, ignore errors.
+                ::posix_madvise(addr, _size, POSIX_MADV_SEQUENTIAL);
+            }
+        }
+    }
+
+    // The file descriptor is no longer needed, the mapping keeps a reference on the file.
+    ::close(fd);
+    return ok;
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Write all modified pages to the disk.
+//----------------------------------------------------------------------------
+
+bool ts::MemoryMappedFile::flush(Report& report)
+{
+    if (_data == nullptr || !_writable) {
+        return true;
+    }
+#if defined(TS_WINDOWS)
+    const bool ok = ::FlushViewOfFile(_data, 0) != 0;
+#else
+    const bool ok = ::msync(_data, _size, MS_SYNC) == 0;
+#endif
+    if (!ok) {
+        report.error(u"error flushing %s: %s", {_filename, SysErrorCodeMessage()});
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Unmap and close the file.
+//----------------------------------------------------------------------------
+
+void ts::MemoryMappedFile::close()
+{
+    if (_data != nullptr) {
+#if defined(TS_WINDOWS)
+        ::UnmapViewOfFile(_data);
+        ::CloseHandle(_mapping);
+        _mapping = nullptr;
+#else
+        ::munmap(_data, _size);
+#endif
+        _data = nullptr;
+    }
+    _size = 0;
+    _writable = false;
+}
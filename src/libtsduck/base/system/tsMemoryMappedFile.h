@@ -0,0 +1,143 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Memory-mapped file.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsUString.h"
+#include "tsReport.h"
+
+namespace ts {
+    //!
+    //! Memory-mapped file.
+    //! @ingroup system
+    //!
+    //! The complete content of a regular file is mapped in the virtual memory of the
+    //! process. The file content is directly accessed in memory, without intermediate
+    //! copy in application buffers. Only regular files can be mapped, not pipes or
+    //! devices. On 32-bit systems, very large files may not be mapped.
+    //!
+    //! The file is either mapped read-only, using open(), or read-write, using openReadWrite().
+    //! In read-write mode, the modifications in memory are shared with the file.
+    //!
+    class TSDUCKDLL MemoryMappedFile
+    {
+        TS_NOCOPY(MemoryMappedFile);
+    public:
+        //!
+        //! Default constructor.
+        //!
+        MemoryMappedFile() = default;
+
+        //!
+        //! Destructor.
+        //!
+        ~MemoryMappedFile();
+
+        //!
+        //! Open a file and map its content in memory.
+        //! @param [in] filename File name.
+        //! @param [in] sequential If true, the application indicates that the file will be
+        //! read sequentially. The system may use more aggressive read-ahead.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool open(const UString& filename, bool sequential, Report& report);
+
+        //!
+        //! Open or create a file with a given size and map its content in memory in read-write mode.
+        //! The existing content of the file is preserved, up to the specified size.
+        //! When supported by the system, the disk space is allocated in advance. Otherwise,
+        //! the file can be sparse and the application may crash later if the disk becomes full.
+        //! @param [in] filename File name. The file is created if it does not exist.
+        //! @param [in] size Size of the file in bytes. The file is extended or truncated to this size.
+        //! @param [in] sequential If true, the application indicates that the file will be
+        //! accessed sequentially. The system may use more aggressive read-ahead.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool openReadWrite(const UString& filename, size_t size, bool sequential, Report& report);
+
+        //!
+        //! Write all modified pages of a file which was mapped in read-write mode to the disk.
+        //! This is not necessary to preserve the content of the file when the application terminates
+        //! or crashes, only when the operating system crashes.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool flush(Report& report);
+
+        //!
+        //! Unmap and close the file.
+        //!
+        void close();
+
+        //!
+        //! Check if the file is open and mapped.
+        //! @return True if the file is open and mapped.
+        //!
+        bool isOpen() const { return _data != nullptr; }
+
+        //!
+        //! Get the file name.
+        //! @return The file name as specified in open().
+        //!
+        const UString& fileName() const { return _filename; }
+
+        //!
+        //! Get the address of the mapped file content.
+        //! @return The address of the mapped file content or a null pointer if the file is not open.
+        //!
+        const uint8_t* data() const { return _data; }
+
+        //!
+        //! Get the address of the mapped file content for modification.
+        //! @return The address of the mapped file content or a null pointer if the file is not open in read-write mode.
+        //!
+        uint8_t* writableData() { return _writable ? _data : nullptr; }
+
+        //!
+        //! Get the size of the mapped file content.
+        //! @return The size of the mapped file content in bytes.
+        //!
+        size_t size() const { return _size; }
+
+    private:
+        UString  _filename {};
+        uint8_t* _data {nullptr};
+        size_t   _size {0};
+        bool     _writable {false};
+#if defined(TS_WINDOWS)
+        ::HANDLE _mapping {nullptr};
+#endif
+    };
+}
@@ -44,6 +44,10 @@
     #include "tsSysCtl.h"
 #endif
 
+#if defined(TS_X86_64) && (defined(TS_GCC) || defined(TS_LLVM))
+    #include <cpuid.h>
+#endif
+
 // Define singleton instance
 TS_DEFINE_SINGLETON(ts::SysInfo);
 
@@ -302,7 +306,10 @@ ts::SysInfo::SysInfo() :
             #endif
         }
         if (GetEnvironment(u"TS_NO_AES_INSTRUCTIONS").empty()) {
-            #if defined(TS_LINUX) && defined(HWCAP_AES)
+            #if defined(TS_X86_64) && (defined(TS_GCC) || defined(TS_LLVM))
+                unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+                _aesInstructions = tsAESIsAccelerated && __get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0 && (ecx & bit_AES) != 0;
+            #elif defined(TS_LINUX) && defined(HWCAP_AES)
                 _aesInstructions = tsAESIsAccelerated && (::getauxval(AT_HWCAP) & HWCAP_AES) != 0;
             #elif defined(TS_MAC)
                 _aesInstructions = tsAESIsAccelerated && SysCtrlBool("hw.optional.arm.FEAT_AES");
@@ -29,6 +29,12 @@
 
 #include "tsMemory.h"
 
+#if defined(TS_X86_64)
+    #include <emmintrin.h>
+#elif defined(TS_ARM64)
+    #include <arm_neon.h>
+#endif
+
 
 //----------------------------------------------------------------------------
 // Check if a memory area starts with the specified prefix
@@ -66,6 +72,60 @@ const uint8_t* ts::LocatePattern(const void* area, size_t area_size, const void*
 }
 
 
+//----------------------------------------------------------------------------
+// Locate a 3-byte pattern 00 00 XY, with XY in a range, into a memory area.
+// Return 0 if not found
+//----------------------------------------------------------------------------
+
+const uint8_t* ts::LocateZeroZero(const void* area, size_t area_size, uint8_t third_min, uint8_t third_max)
+{
+    const uint8_t* a = reinterpret_cast<const uint8_t*>(area);
+    const uint8_t* const end = a + area_size;
+
+    // XY is in range when XY - min <= max - min, as unsigned bytes.
+    const uint8_t range = uint8_t(third_max - third_min);
+
+    // Check 16 positions at a time, stop on the first block which contains the pattern.
+    // SSE2 and Neon are always present on x86-64 and Arm64.
+#if defined(TS_X86_64)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i vmin = _mm_set1_epi8(char(third_min));
+    const __m128i vrange = _mm_set1_epi8(char(range));
+    while (end - a >= 18) {
+        const __m128i b0 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a)), zero);
+        const __m128i b1 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + 1)), zero);
+        const __m128i d2 = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + 2)), vmin);
+        const __m128i b2 = _mm_cmpeq_epi8(_mm_min_epu8(d2, vrange), d2);
+        if (_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(b0, b1), b2)) != 0) {
+            break;
+        }
+        a += 16;
+    }
+#elif defined(TS_ARM64)
+    const uint8x16_t vmin = vdupq_n_u8(third_min);
+    const uint8x16_t vrange = vdupq_n_u8(range);
+    while (end - a >= 18) {
+        const uint8x16_t b0 = vceqzq_u8(vld1q_u8(a));
+        const uint8x16_t b1 = vceqzq_u8(vld1q_u8(a + 1));
+        const uint8x16_t b2 = vcleq_u8(vsubq_u8(vld1q_u8(a + 2), vmin), vrange);
+        if (vmaxvq_u8(vandq_u8(vandq_u8(b0, b1), b2)) != 0) {
+            break;
+        }
+        a += 16;
+    }
+#endif
+
+    // Locate the pattern byte by byte in the rest of the area.
+    while (end - a >= 3) {
+        if (uint8_t(a[2] - third_min) <= range && a[1] == 0 && a[0] == 0) {
+            return a;
+        }
+        ++a;
+    }
+    return nullptr; // not found
+}
+
+
 //----------------------------------------------------------------------------
 // Check if a memory area contains all identical byte values.
 //----------------------------------------------------------------------------
@@ -77,6 +77,33 @@ namespace ts {
     //!
     TSDUCKDLL const uint8_t* LocatePattern(const void* area, size_t area_size, const void* pattern, size_t pattern_size);
 
+    //!
+    //! Locate a 3-byte pattern 00 00 XY into a memory area, where XY is in a range of values.
+    //! This is typically used to locate the end of a video NALunit, 00 00 00 or 00 00 01, in one pass.
+    //! It is optimized using vector instructions, when available.
+    //! @param [in] area Address of a memory area to check.
+    //! @param [in] area_size Size in bytes of the memory area.
+    //! @param [in] third_min Minimum value of the third byte in the pattern, after 00 00.
+    //! @param [in] third_max Maximum value of the third byte in the pattern, after 00 00.
+    //! @return Address of the first occurence of the pattern in @a area or zero if not found.
+    //!
+    TSDUCKDLL const uint8_t* LocateZeroZero(const void* area, size_t area_size, uint8_t third_min, uint8_t third_max);
+
+    //!
+    //! Locate a 3-byte pattern 00 00 XY into a memory area.
+    //! This is a specialized version of LocatePattern(), typically used to locate start code
+    //! prefixes (00 00 01) in video streams. It is optimized using vector instructions, when
+    //! available, and is typically much faster than LocatePattern() on large areas.
+    //! @param [in] area Address of a memory area to check.
+    //! @param [in] area_size Size in bytes of the memory area.
+    //! @param [in] third Third byte in the pattern, after 00 00.
+    //! @return Address of the first occurence of the pattern in @a area or zero if not found.
+    //!
+    TSDUCKDLL inline const uint8_t* LocateZeroZero(const void* area, size_t area_size, uint8_t third)
+    {
+        return LocateZeroZero(area, area_size, third, third);
+    }
+
     //!
     //! Check if a memory area contains all identical byte values.
     //! @param [in] area Address of a memory area to check.
@@ -37,6 +37,12 @@
 #include "tsByteBlock.h"
 #include "tsSysUtils.h"
 
+#if defined(TS_X86_64)
+    #include <emmintrin.h>
+#elif defined(TS_ARM64)
+    #include <arm_neon.h>
+#endif
+
 // The UTF-8 Byte Order Mark
 const char* const ts::UString::UTF8_BOM = "\xEF\xBB\xBF";
 
@@ -208,6 +214,54 @@ std::ostream& operator<<(std::ostream& strm, const ts::UChar c)
 }
 
 
+//----------------------------------------------------------------------------
+// Fast routine to convert a sequence of 8-bit characters into UTF-16.
+//----------------------------------------------------------------------------
+
+void ts::UString::ConvertASCIIToUTF16(const uint8_t*& inStart, const uint8_t* inEnd, UChar*& outStart, UChar* outEnd, uint8_t first, uint8_t last)
+{
+    // A byte b is in range when (b - first) <= (last - first), as unsigned 8-bit values.
+    const uint8_t span = uint8_t(last - first);
+
+    // Process 16 bytes at a time. SSE2 and Neon are always present on x86-64 and Arm64.
+#if defined(TS_X86_64)
+    const __m128i vfirst = _mm_set1_epi8(char(first));
+    const __m128i vspan = _mm_set1_epi8(char(span));
+    const __m128i zero = _mm_setzero_si128();
+    while (inEnd - inStart >= 16 && outEnd - outStart >= 16) {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inStart));
+        // With unsigned saturation, bytes in range become zero.
+        const __m128i excess = _mm_subs_epu8(_mm_sub_epi8(in, vfirst), vspan);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(excess, zero)) != 0xFFFF) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(outStart), _mm_unpacklo_epi8(in, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(outStart + 8), _mm_unpackhi_epi8(in, zero));
+        inStart += 16;
+        outStart += 16;
+    }
+#elif defined(TS_ARM64)
+    const uint8x16_t vfirst = vdupq_n_u8(first);
+    const uint8x16_t vspan = vdupq_n_u8(span);
+    while (inEnd - inStart >= 16 && outEnd - outStart >= 16) {
+        const uint8x16_t in = vld1q_u8(inStart);
+        if (vminvq_u8(vcleq_u8(vsubq_u8(in, vfirst), vspan)) != 0xFF) {
+            break;
+        }
+        vst1q_u16(reinterpret_cast<uint16_t*>(outStart), vmovl_u8(vget_low_u8(in)));
+        vst1q_u16(reinterpret_cast<uint16_t*>(outStart + 8), vmovl_high_u8(in));
+        inStart += 16;
+        outStart += 16;
+    }
+#endif
+
+    // Process remaining bytes one by one, until the first one which is out of range.
+    while (inStart < inEnd && outStart < outEnd && uint8_t(*inStart - first) <= span) {
+        *outStart++ = UChar(*inStart++);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // General routine to convert from UTF-8 to UTF-16.
 //----------------------------------------------------------------------------
@@ -218,6 +272,14 @@ void ts::UString::ConvertUTF8ToUTF16(const char*& inStart, const char* inEnd, UC
 
     while (inStart < inEnd && outStart < outEnd) {
 
+        // Fast path for sequences of ASCII characters.
+        if ((*inStart & 0x80) == 0) {
+            const uint8_t* in = reinterpret_cast<const uint8_t*>(inStart);
+            ConvertASCIIToUTF16(in, reinterpret_cast<const uint8_t*>(inEnd), outStart, outEnd);
+            inStart = reinterpret_cast<const char*>(in);
+            continue;
+        }
+
         // Get current code point at 8-bit value.
         code = *inStart++ & 0xFF;
 
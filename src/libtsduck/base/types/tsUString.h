@@ -467,6 +467,22 @@ namespace ts {
         //!
         static void ConvertUTF8ToUTF16(const char*& inStart, const char* inEnd, UChar*& outStart, UChar* outEnd);
 
+        //!
+        //! Fast routine to convert a sequence of 8-bit characters in a given range into UTF-16.
+        //! Each byte is converted into the UTF-16 code with the same value. This is typically used
+        //! to decode the ASCII parts of UTF-8 or DVB strings. Vector instructions are used when possible.
+        //! Stop when the input buffer is empty, the output buffer is full or a byte out of range is found.
+        //! @param [in,out] inStart Address of the input buffer to convert.
+        //! Updated upon return to point after the last converted character.
+        //! @param [in] inEnd Address after the end of the input buffer.
+        //! @param [in,out] outStart Address of the output UTF-16 buffer to fill.
+        //! Updated upon return to point after the last converted character.
+        //! @param [in] outEnd Address after the end of the output UTF-16 buffer to fill.
+        //! @param [in] first First byte value in the range of converted bytes.
+        //! @param [in] last Last byte value in the range of converted bytes.
+        //!
+        static void ConvertASCIIToUTF16(const uint8_t*& inStart, const uint8_t* inEnd, UChar*& outStart, UChar* outEnd, uint8_t first = 0x00, uint8_t last = 0x7F);
+
         //!
         //! Assign from a @c std::vector of 16-bit characters of any type.
         //! @tparam CHARTYPE A 16-bit character or integer type.
@@ -104,76 +104,82 @@ ts::json::ValuePtr ts::xml::JSONConverter::convertElementToJSON(const Element* m
 
     // Add attributes in the JSON object.
     for (const auto& it : attributes) {
-
-        // JSON value of the attribute.
-        json::ValuePtr jvalue;
         int64_t intValue = 0;
         bool boolValue = false;
-
-        // Get description of this attribute in the model.
-        UString description;
-        bool intModel = false;
-        bool boolModel = false;
-        if (model != nullptr) {
-            // Get description, empty string without error if not found.
-            model->getAttribute(description, it.first, false);
-            description.trim(true, false, false);
-            intModel = description.startWith(u"uint", CASE_INSENSITIVE) || description.startWith(u"int", CASE_INSENSITIVE);
-            boolModel = description.startWith(u"bool", CASE_INSENSITIVE);
+        switch (attributeType(model, source, it.first, it.second, intValue, boolValue, xml_tweaks)) {
+            case ValueType::INTEGER:
+                jobj->add(it.first, json::ValuePtr(new json::Number(intValue)));
+                break;
+            case ValueType::BOOLEAN:
+                jobj->add(it.first, json::Bool(boolValue));
+                break;
+            case ValueType::STRING:
+            default:
+                jobj->add(it.first, json::ValuePtr(new json::String(it.second)));
+                break;
         }
+    }
 
-        // Try to convert as an integer or boolean if defined as such by the model.
-        if (intModel) {
-            // Should be an integer according to the model.
-            if (it.second.toInteger(intValue, UString::DEFAULT_THOUSANDS_SEPARATOR)) {
-                if (intValue < -TS_CONST64(0xFFFFFFFF)) {
-                    // This is a "very negative" value. This is typically a large unsigned hexadecimal value
-                    // which will not be handled correctly when reading back the JSON file. We cannot use
-                    // hexadecimal literals in JSON (new in JSON 5), so we leave it as a string.
-                    jvalue = new json::String(it.second);
-                }
-                else {
-                    // Acceptable integer.
-                    jvalue = new json::Number(intValue);
-                }
-            }
-            else {
-                source->report().warning(u"attribute '%s' in <%s> line %d is '%s' but should be an integer", {it.first, source->name(), source->lineNumber(), it.second});
-            }
-        }
-        else if (boolModel) {
-            // Should be a boolean according to the model.
-            if (it.second.toBool(boolValue)) {
-                jvalue = json::Bool(boolValue);
-            }
-            else {
-                source->report().warning(u"attribute '%s' in <%s> line %d is '%s' but should be a boolean", {it.first, source->name(), source->lineNumber(), it.second});
-            }
-        }
+    // Process the list of children, if any.
+    if (source->hasChildren()) {
+        jobj->add(HashNodes, convertChildrenToJSON(model, source, xml_tweaks));
+    }
+
+    return jobj;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the JSON type of an XML attribute value.
+//----------------------------------------------------------------------------
+
+ts::xml::JSONConverter::ValueType ts::xml::JSONConverter::attributeType(const Element* model, const Element* source, const UString& name, const UString& value, int64_t& int_value, bool& bool_value, const Tweaks& xml_tweaks) const
+{
+    // Get description of this attribute in the model.
+    UString description;
+    bool intModel = false;
+    bool boolModel = false;
+    if (model != nullptr) {
+        // Get description, empty string without error if not found.
+        model->getAttribute(description, name, false);
+        description.trim(true, false, false);
+        intModel = description.startWith(u"uint", CASE_INSENSITIVE) || description.startWith(u"int", CASE_INSENSITIVE);
+        boolModel = description.startWith(u"bool", CASE_INSENSITIVE);
+    }
 
-        // Try to enforce integer of boolean value if specified on command line.
-        if (jvalue.isNull() && xml_tweaks.x2jEnforceInteger && !intModel && it.second.toInteger(intValue, UString::DEFAULT_THOUSANDS_SEPARATOR)) {
-            jvalue = new json::Number(intValue);
+    // Try to convert as an integer or boolean if defined as such by the model.
+    if (intModel) {
+        // Should be an integer according to the model.
+        if (value.toInteger(int_value, UString::DEFAULT_THOUSANDS_SEPARATOR)) {
+            // A "very negative" value is typically a large unsigned hexadecimal value
+            // which will not be handled correctly when reading back the JSON file. We cannot use
+            // hexadecimal literals in JSON (new in JSON 5), so we leave it as a string.
+            return int_value < -TS_CONST64(0xFFFFFFFF) ? ValueType::STRING : ValueType::INTEGER;
         }
-        if (jvalue.isNull() && xml_tweaks.x2jEnforceBoolean && !boolModel && it.second.toBool(boolValue)) {
-            jvalue = json::Bool(boolValue);
+        else {
+            source->report().warning(u"attribute '%s' in <%s> line %d is '%s' but should be an integer", {name, source->name(), source->lineNumber(), value});
         }
-
-        // Use a string value by default.
-        if (jvalue.isNull()) {
-            jvalue = new json::String(it.second);
+    }
+    else if (boolModel) {
+        // Should be a boolean according to the model.
+        if (value.toBool(bool_value)) {
+            return ValueType::BOOLEAN;
+        }
+        else {
+            source->report().warning(u"attribute '%s' in <%s> line %d is '%s' but should be a boolean", {name, source->name(), source->lineNumber(), value});
         }
-
-        // Add the attribute in the JSON object.
-        jobj->add(it.first, jvalue);
     }
 
-    // Process the list of children, if any.
-    if (source->hasChildren()) {
-        jobj->add(HashNodes, convertChildrenToJSON(model, source, xml_tweaks));
+    // Try to enforce integer of boolean value if specified on command line.
+    if (xml_tweaks.x2jEnforceInteger && !intModel && value.toInteger(int_value, UString::DEFAULT_THOUSANDS_SEPARATOR)) {
+        return ValueType::INTEGER;
+    }
+    if (xml_tweaks.x2jEnforceBoolean && !boolModel && value.toBool(bool_value)) {
+        return ValueType::BOOLEAN;
     }
 
-    return jobj;
+    // Use a string value by default.
+    return ValueType::STRING;
 }
 
 
@@ -225,6 +231,115 @@ ts::json::ValuePtr ts::xml::JSONConverter::convertChildrenToJSON(const Element*
 }
 
 
+//----------------------------------------------------------------------------
+// Print an XML element as a JSON object, without intermediate JSON tree.
+//----------------------------------------------------------------------------
+
+void ts::xml::JSONConverter::printAsJSON(TextFormatter& output, const Element* source) const
+{
+    if (source == nullptr) {
+        output << "null";
+        return;
+    }
+
+    // Build the path of elements from the root of the source document.
+    std::vector<const Element*> path;
+    for (const Element* elem = source; elem != nullptr; elem = dynamic_cast<const Element*>(elem->parent())) {
+        path.push_back(elem);
+    }
+
+    // Locate the model of the element, following the same path in the model.
+    const Element* model = rootElement();
+    if (model != nullptr && !model->name().similar(path.back()->name())) {
+        model = nullptr;
+    }
+    for (size_t i = path.size() - 1; model != nullptr && i-- > 0; ) {
+        model = findModelElement(model, path[i]->name());
+    }
+
+    printElementJSON(output, model, source, tweaks());
+}
+
+// The output is formatted exactly as the printing of the JSON object from
+// convertElementToJSON(). The fields of a JSON object are sorted by name and
+// "#name" and "#nodes" always come before the XML attribute names.
+void ts::xml::JSONConverter::printElementJSON(TextFormatter& output, const Element* model, const Element* source, const Tweaks& xml_tweaks) const
+{
+    output << "{" << ts::indent;
+    output << ts::endl << ts::margin << '"' << HashName.toJSON() << "\": \"" << source->name().toJSON() << '"';
+
+    // Print the list of children, if any.
+    if (source->hasChildren()) {
+        output << "," << ts::endl << ts::margin << '"' << HashNodes.toJSON() << "\": ";
+        printChildrenJSON(output, model, source, xml_tweaks);
+    }
+
+    // Print all attributes of the XML element.
+    std::map<UString,UString> attributes;
+    source->getAttributes(attributes);
+    for (const auto& it : attributes) {
+        output << "," << ts::endl << ts::margin << '"' << it.first.toJSON() << "\": ";
+        int64_t intValue = 0;
+        bool boolValue = false;
+        switch (attributeType(model, source, it.first, it.second, intValue, boolValue, xml_tweaks)) {
+            case ValueType::INTEGER:
+                output << UString::Decimal(intValue, 0, true, UString());
+                break;
+            case ValueType::BOOLEAN:
+                output << (boolValue ? "true" : "false");
+                break;
+            case ValueType::STRING:
+            default:
+                output << '"' << it.second.toJSON() << '"';
+                break;
+        }
+    }
+
+    output << ts::endl << ts::unindent << ts::margin << "}";
+}
+
+void ts::xml::JSONConverter::printChildrenJSON(TextFormatter& output, const Element* model, const Element* parent, const Tweaks& xml_tweaks) const
+{
+    output << "[" << ts::indent;
+
+    // Content of the text children in the model.
+    UString textModel;
+    bool getTextModel = model != nullptr;
+    bool hexaModel = false;
+
+    // Loop on all children nodes, same logic as convertChildrenToJSON().
+    bool first = true;
+    bool lastNode = false;
+    for (const Node* child = parent->firstChild(); child != nullptr && !lastNode; child = child->nextSibling()) {
+        lastNode = child == parent->lastChild();
+        const Element* elem = dynamic_cast<const Element*>(child);
+        const Text* text = dynamic_cast<const Text*>(child);
+        if (elem != nullptr || text != nullptr) {
+            if (!first) {
+                output << ",";
+            }
+            output << ts::endl << ts::margin;
+            first = false;
+        }
+        if (elem != nullptr) {
+            printElementJSON(output, findModelElement(model, elem->name()), elem, xml_tweaks);
+        }
+        else if (text != nullptr) {
+            UString content(text->value());
+            if (getTextModel) {
+                getTextModel = false;
+                model->getText(textModel, true);
+                hexaModel = textModel.startWith(u"hexa", CASE_INSENSITIVE);
+            }
+            content.trim(hexaModel || xml_tweaks.x2jTrimText, hexaModel || xml_tweaks.x2jTrimText, hexaModel || xml_tweaks.x2jCollapseText);
+            output << '"' << content.toJSON() << '"';
+        }
+    }
+
+    output << ts::endl << ts::unindent << ts::margin << "]";
+}
+
+
 //----------------------------------------------------------------------------
 // Build a valid XML element name from a JSON string.
 //----------------------------------------------------------------------------
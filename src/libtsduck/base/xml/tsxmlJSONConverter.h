@@ -36,6 +36,7 @@
 #include "tsxmlDocument.h"
 #include "tsxmlModelDocument.h"
 #include "tsjson.h"
+#include "tsTextFormatter.h"
 #include "tsReport.h"
 
 namespace ts {
@@ -111,6 +112,17 @@ namespace ts {
             //!
             bool convertToXML(const json::Value& source, Document& destination, bool auto_validate) const;
 
+            //!
+            //! Print an XML element as a JSON object, without building an intermediate JSON tree.
+            //! The printed text is identical to the printing of the corresponding JSON object
+            //! in the result of convertToJSON(). This is faster when the JSON object is only
+            //! printed, typically when logging a large number of tables in JSON format.
+            //! @param [in,out] output Where to print the JSON object.
+            //! @param [in] source The source XML element to convert. Its model is searched from
+            //! the root of its document.
+            //!
+            void printAsJSON(TextFormatter& output, const Element* source) const;
+
             //!
             //! The string "#name" which is used to hold the name of an XML element in a JSON object.
             //!
@@ -127,6 +139,16 @@ namespace ts {
             static const UString HashUnnamed;
 
         private:
+            // JSON type of an XML attribute value.
+            enum class ValueType {STRING, INTEGER, BOOLEAN};
+
+            // Get the JSON type of an XML attribute value, according to the model and tweaks.
+            ValueType attributeType(const Element* model, const Element* source, const UString& name, const UString& value, int64_t& int_value, bool& bool_value, const Tweaks&) const;
+
+            // Print an XML element or all children of an element in JSON format.
+            void printElementJSON(TextFormatter& output, const Element* model, const Element* source, const Tweaks&) const;
+            void printChildrenJSON(TextFormatter& output, const Element* model, const Element* parent, const Tweaks&) const;
+
             // Convert an XML tree of elements. Null pointer on error or if not convertible.
             json::ValuePtr convertElementToJSON(const Element* model, const Element* source, const Tweaks&) const;
 
@@ -0,0 +1,432 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsxmlRunningReader.h"
+#include "tsxmlElement.h"
+#include "tsTextParser.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::xml::RunningReader::RunningReader(Report& report) :
+    Document(report),
+    _file(),
+    _inline(),
+    _input(nullptr),
+    _lines(),
+    _index(0),
+    _lineNumber(1),
+    _eof(false)
+{
+}
+
+ts::xml::RunningReader::~RunningReader()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Open the document.
+//----------------------------------------------------------------------------
+
+bool ts::xml::RunningReader::open(const UString& fileName)
+{
+    // Cleanup previous state.
+    close();
+
+    if (IsInlineXML(fileName)) {
+        // Specific case of inline XML content.
+        _inline.str(fileName.toUTF8());
+        _input = &_inline;
+    }
+    else if (fileName.empty() || fileName == u"-") {
+        // Specific case of the standard input.
+        _input = &std::cin;
+    }
+    else {
+        _file.open(fileName.toUTF8().c_str(), std::ios::in);
+        if (!_file) {
+            report().error(u"cannot open %s", {fileName});
+            return false;
+        }
+        report().debug(u"reading XML file %s", {fileName});
+        _input = &_file;
+    }
+    return start();
+}
+
+bool ts::xml::RunningReader::open(std::istream& strm)
+{
+    close();
+    _input = &strm;
+    return start();
+}
+
+
+//----------------------------------------------------------------------------
+// Read the XML declaration and the start tag of the root element.
+//----------------------------------------------------------------------------
+
+bool ts::xml::RunningReader::start()
+{
+    // Skip everything before the root element.
+    Cursor cur(begin());
+    bool ok = true;
+    for (;;) {
+        if (!findChar(cur, u'<')) {
+            report().error(u"invalid XML document, no root element found");
+            return false;
+        }
+        else if (!skipSpecial(cur, ok)) {
+            break;
+        }
+        else if (!ok) {
+            report().error(u"line %d: unexpected end of document", {cur.number});
+            return false;
+        }
+    }
+
+    // Now at start of root element, get its name.
+    UString rootName;
+    for (size_t i = cur.index + 1; i < cur.line->length() && (IsAlpha((*cur.line)[i]) || IsDigit((*cur.line)[i]) || UString(u"_:.-").contain((*cur.line)[i])); ++i) {
+        rootName.push_back((*cur.line)[i]);
+    }
+
+    // Read the complete start tag of the root element.
+    bool empty = false;
+    if (!skipStartTag(cur, empty)) {
+        report().error(u"line %d: unexpected end of document", {cur.number});
+        return false;
+    }
+
+    // Parse the document header with an empty root element.
+    UStringList lines;
+    extractLines(lines, cur);
+    if (!empty) {
+        lines.back().append(u"</" + rootName + u">");
+    }
+    TextParser parser(report());
+    parser.loadDocument(lines);
+    _eof = empty;
+    return Document::parseNode(parser, nullptr);
+}
+
+
+//----------------------------------------------------------------------------
+// Read the next element under the document root.
+//----------------------------------------------------------------------------
+
+ts::xml::Element* ts::xml::RunningReader::readElement()
+{
+    Element* root = rootElement();
+    if (root == nullptr || _eof) {
+        return nullptr;
+    }
+
+    // Delete previous elements under the root.
+    Element* elem = nullptr;
+    while ((elem = root->firstChildElement()) != nullptr) {
+        delete elem;
+    }
+
+    // Skip everything before the next element.
+    Cursor cur(begin());
+    bool ok = true;
+    for (;;) {
+        if (!findChar(cur, u'<')) {
+            report().error(u"line %d: unexpected end of document, root element <%s> not terminated", {cur.number, root->name()});
+            return nullptr;
+        }
+        else if (match(cur, u"</")) {
+            // End of root element. Ignore what comes after.
+            _eof = true;
+            return nullptr;
+        }
+        else if (!skipSpecial(cur, ok)) {
+            break;
+        }
+        else if (!ok) {
+            report().error(u"line %d: unexpected end of document", {cur.number});
+            return nullptr;
+        }
+    }
+
+    // Drop the skipped text and locate the end of the element.
+    UStringList lines;
+    extractLines(lines, cur);
+    const size_t firstLine = _lineNumber;
+    cur = begin();
+    if (!skipElement(cur)) {
+        report().error(u"line %d: unexpected end of document, element not terminated", {firstLine});
+        return nullptr;
+    }
+
+    // Parse the element in the document and move it under the root.
+    extractLines(lines, cur);
+    TextParser parser(report());
+    parser.loadDocument(lines, firstLine);
+    if (!parseChildren(parser)) {
+        return nullptr;
+    }
+    elem = dynamic_cast<Element*>(lastChild());
+    if (elem != nullptr) {
+        elem->reparent(root);
+    }
+    return elem;
+}
+
+
+//----------------------------------------------------------------------------
+// Close the running document.
+//----------------------------------------------------------------------------
+
+void ts::xml::RunningReader::close()
+{
+    if (_file.is_open()) {
+        _file.close();
+    }
+    _inline.str(std::string());
+    _inline.clear();
+    _input = nullptr;
+    _lines.clear();
+    _index = 0;
+    _lineNumber = 1;
+    _eof = false;
+
+    // Clear the document itself using the superclass.
+    Document::clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Read the next line in the buffered lines, false at end of file.
+//----------------------------------------------------------------------------
+
+bool ts::xml::RunningReader::readLine()
+{
+    if (_input == nullptr) {
+        return false;
+    }
+    _lines.emplace_back();
+    if (!_lines.back().getLine(*_input)) {
+        _lines.pop_back();
+        return false;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Make sure the cursor points to an existing character, reading more lines
+// when necessary. Return false at end of file.
+//----------------------------------------------------------------------------
+
+bool ts::xml::RunningReader::ready(Cursor& cur)
+{
+    for (;;) {
+        if (cur.line == _lines.end()) {
+            // All buffered lines are consumed, read one more.
+            if (!readLine()) {
+                return false;
+            }
+            cur.line = --_lines.end();
+            cur.index = 0;
+        }
+        else if (cur.index < cur.line->length()) {
+            return true;
+        }
+        else {
+            ++cur.line;
+            ++cur.number;
+            cur.index = 0;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Move the cursor to the next occurrence of a character or a string.
+//----------------------------------------------------------------------------
+
+bool ts::xml::RunningReader::findChar(Cursor& cur, UChar c)
+{
+    while (ready(cur)) {
+        if ((*cur.line)[cur.index] == c) {
+            return true;
+        }
+        cur.index++;
+    }
+    return false;
+}
+
+bool ts::xml::RunningReader::findString(Cursor& cur, const UString& str)
+{
+    while (!str.empty() && findChar(cur, str[0])) {
+        if (match(cur, str)) {
+            return true;
+        }
+        cur.index++;
+    }
+    return false;
+}
+
+bool ts::xml::RunningReader::match(const Cursor& cur, const UString& str)
+{
+    return cur.line != _lines.end() && cur.index <= cur.line->length() && cur.line->compare(cur.index, str.length(), str) == 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Skip a special construct (comment, CDATA, declaration, DTD) at cursor.
+//----------------------------------------------------------------------------
+
+bool ts::xml::RunningReader::skipSpecial(Cursor& cur, bool& ok)
+{
+    // Start and end of special constructs. Order is significant, "<!" must be last.
+    static const UChar* const specials[][2] = {
+        {u"<!--",      u"-->"},
+        {u"<![CDATA[", u"]]>"},
+        {u"<?",        u"?>"},
+        {u"<!",        u">"},
+    };
+
+    for (const auto& sp : specials) {
+        const UString start(sp[0]);
+        if (match(cur, start)) {
+            const UString end(sp[1]);
+            cur.index += start.length();
+            ok = findString(cur, end);
+            if (ok) {
+                cur.index += end.length();
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Skip a start tag, cursor on the opening '<', set after the closing '>'.
+//----------------------------------------------------------------------------
+
+bool ts::xml::RunningReader::skipStartTag(Cursor& cur, bool& empty)
+{
+    UChar quote = CHAR_NULL;
+    UChar previous = CHAR_NULL;
+    cur.index++;
+    while (ready(cur)) {
+        const UChar c = (*cur.line)[cur.index++];
+        if (quote != CHAR_NULL) {
+            // Inside an attribute value, wait for the closing quote.
+            if (c == quote) {
+                quote = CHAR_NULL;
+            }
+        }
+        else if (c == u'"' || c == u'\'') {
+            quote = c;
+        }
+        else if (c == u'>') {
+            empty = previous == u'/';
+            return true;
+        }
+        previous = c;
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Skip a complete element, cursor on the opening '<', set after the end tag.
+//----------------------------------------------------------------------------
+
+bool ts::xml::RunningReader::skipElement(Cursor& cur)
+{
+    int depth = 0;
+    bool ok = true;
+    do {
+        if (!findChar(cur, u'<')) {
+            return false;
+        }
+        else if (skipSpecial(cur, ok)) {
+            if (!ok) {
+                return false;
+            }
+        }
+        else if (match(cur, u"</")) {
+            // End tag.
+            if (!findChar(cur, u'>')) {
+                return false;
+            }
+            cur.index++;
+            depth--;
+        }
+        else {
+            // Start tag.
+            bool empty = false;
+            if (!skipStartTag(cur, empty)) {
+                return false;
+            }
+            if (!empty) {
+                depth++;
+            }
+        }
+    } while (depth > 0);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Extract the text lines between the beginning of the buffered lines and a cursor.
+//----------------------------------------------------------------------------
+
+void ts::xml::RunningReader::extractLines(UStringList& lines, const Cursor& end)
+{
+    lines.clear();
+
+    // Extract complete lines before the end line, the first one can be partial.
+    while (!_lines.empty() && _lines.begin() != end.line) {
+        lines.push_back(_lines.front().substr(_index));
+        _lines.pop_front();
+        _index = 0;
+    }
+
+    // Extract the beginning of the end line.
+    if (end.line != _lines.end()) {
+        lines.push_back(end.line->substr(_index, end.index - _index));
+        _index = end.index;
+    }
+    else {
+        _index = 0;
+    }
+    _lineNumber = end.number;
+}
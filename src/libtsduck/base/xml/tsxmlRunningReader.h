@@ -0,0 +1,166 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!
+//!  @file
+//!  Representation of a "running" XML document which is read on the fly.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsxmlDocument.h"
+
+namespace ts {
+    namespace xml {
+        //!
+        //! Representation of a "running" XML document which is read on the fly.
+        //! @ingroup xml
+        //!
+        //! This is the input counterpart of RunningDocument. The input XML file is
+        //! read progressively and the elements directly under the document root are
+        //! returned one by one. Only the XML declaration, the root element and the
+        //! current child element of the root are present in the document at any time.
+        //! The other children of the root are deleted after being used.
+        //!
+        //! This is useful to process arbitrary large XML files with a constant memory
+        //! usage when the children of the root are independent. A typical example is
+        //! a TSDuck XML file containing many large tables.
+        //!
+        //! Because the document contains at most one child element in the root, the
+        //! complete document can be validated using an XML model after each call to
+        //! readElement().
+        //!
+        class TSDUCKDLL RunningReader: public Document
+        {
+            TS_NOCOPY(RunningReader);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in,out] report Where to report errors.
+            //!
+            explicit RunningReader(Report& report = NULLREP);
+
+            //!
+            //! Destructor.
+            //!
+            virtual ~RunningReader() override;
+
+            //!
+            //! Open the running document.
+            //! The XML declaration and the start tag of the root element are read.
+            //! @param [in] fileName Input file name. When empty or "-", the standard input is used.
+            //! If @a fileName starts with "<?xml", this is considered as "inline XML content".
+            //! @return True on success, false on error.
+            //!
+            bool open(const UString& fileName);
+
+            //!
+            //! Open the running document from a text stream.
+            //! @param [in,out] strm The input text stream. The referenced stream object must
+            //! remain valid as long as the document is open.
+            //! @return True on success, false on error.
+            //!
+            bool open(std::istream& strm);
+
+            //!
+            //! Read the next element under the document root.
+            //! The previous element under the document root, if any, is deleted first.
+            //! Comments and texts between the children of the root are ignored.
+            //! @return Address of the new element in the document root or null at end of
+            //! document or on error. Use eof() to check if the end of document was reached.
+            //!
+            Element* readElement();
+
+            //!
+            //! Check if the end of the root element was reached.
+            //! @return True if the end of the root element was reached.
+            //!
+            bool eof() const { return _eof; }
+
+            //!
+            //! Close the running document.
+            //! The input file, if any, is closed.
+            //!
+            void close();
+
+        private:
+            // A position in the buffered lines.
+            class Cursor
+            {
+            public:
+                UStringList::iterator line;    // Current line in _lines.
+                size_t                index;   // Index in current line.
+                size_t                number;  // Line number in the document.
+                Cursor(UStringList::iterator l, size_t i, size_t n) : line(l), index(i), number(n) {}
+            };
+
+            std::ifstream      _file;        // Input file, when a file name is used.
+            std::istringstream _inline;      // Input stream for inline XML content.
+            std::istream*      _input;       // Current input stream.
+            UStringList        _lines;       // Buffered input lines, not yet parsed.
+            size_t             _index;       // Index of first non-parsed character in first buffered line.
+            size_t             _lineNumber;  // Line number of first buffered line.
+            bool               _eof;         // End of root element was reached.
+
+            // Read the XML declaration and the start tag of the root element.
+            bool start();
+
+            // Read the next line in the buffered lines, false at end of file.
+            bool readLine();
+
+            // Make sure the cursor points to an existing character, reading more lines if necessary.
+            bool ready(Cursor& cur);
+
+            // Move the cursor to the next occurrence of a character or a string.
+            // When found, the cursor points to the first character of the string.
+            bool findChar(Cursor& cur, UChar c);
+            bool findString(Cursor& cur, const UString& str);
+
+            // Check if a string is present at the cursor. The string must be in one line.
+            bool match(const Cursor& cur, const UString& str);
+
+            // Skip a special construct (comment, CDATA, declaration, DTD) at cursor if there is one.
+            // Return true if one was found, set ok to false if it is not terminated.
+            bool skipSpecial(Cursor& cur, bool& ok);
+
+            // Skip a start tag, cursor on the opening '<', set to after the closing '>'.
+            bool skipStartTag(Cursor& cur, bool& empty);
+
+            // Skip a complete element, cursor on the opening '<', set to after the end tag.
+            bool skipElement(Cursor& cur);
+
+            // Extract the text lines between the beginning of the buffered lines and a cursor.
+            // The extracted lines are removed from the buffered lines.
+            void extractLines(UStringList& lines, const Cursor& end);
+
+            // Get a cursor at the beginning of the buffered lines.
+            Cursor begin() { return Cursor(_lines.begin(), _index, _lineNumber); }
+        };
+    }
+}
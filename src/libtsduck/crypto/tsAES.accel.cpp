@@ -5,6 +5,7 @@
 //  AES block cipher
 //
 //  Arm64 acceleration based on public domain code from Arm.
+//  Intel acceleration using AES-NI instructions.
 //
 //----------------------------------------------------------------------------
 //
@@ -18,6 +19,7 @@
 
 #include "tsAES.h"
 #include "tsByteSwap.h"
+#include "tsMemory.h"
 #include "tsCryptoAcceleration.h"
 
 // Check if Arm-64 AES instructions can be used in asm() directives and intrinsics.
@@ -25,6 +27,11 @@
     #define TS_ARM_AES_INSTRUCTIONS 1
 #endif
 
+// Check if Intel AES-NI instructions can be used in intrinsics.
+#if defined(__AES__) && defined(__SSE2__) && !defined(TS_NO_X86_AES_INSTRUCTIONS)
+    #define TS_X86_AES_INSTRUCTIONS 1
+#endif
+
 #if defined(TS_ARM_AES_INSTRUCTIONS)
 #include <arm_neon.h>
 class ts::AES::Acceleration
@@ -33,11 +40,24 @@ public:
     uint8x16_t eK[15];  // Scheduled encryption keys in SIMD register format.
     uint8x16_t dK[15];  // Scheduled decryption keys in SIMD register format.
 };
+#elif defined(TS_X86_AES_INSTRUCTIONS)
+#include <wmmintrin.h>
+class ts::AES::Acceleration
+{
+public:
+    __m128i eK[15];  // Scheduled encryption keys in SIMD register format.
+    __m128i dK[15];  // Scheduled decryption keys in SIMD register format.
+};
 #endif
 
+// Number of independent blocks which are processed together in the pipeline of AES instructions.
+namespace {
+    constexpr size_t PIPELINE_BLOCKS = 8;
+}
+
 // "Hidden" exported bool to inform the SysInfo class that we have compiled accelerated instructions.
 extern const bool tsAESIsAccelerated =
-#if defined(TS_ARM_AES_INSTRUCTIONS)
+#if defined(TS_ARM_AES_INSTRUCTIONS) || defined(TS_X86_AES_INSTRUCTIONS)
     true;
 #else
     false;
@@ -53,7 +73,7 @@ TS_LLVM_NOWARNING(missing-noreturn)
 
 ts::AES::Acceleration* ts::AES::newAccel()
 {
-#if defined(TS_ARM_AES_INSTRUCTIONS)
+#if defined(TS_ARM_AES_INSTRUCTIONS) || defined(TS_X86_AES_INSTRUCTIONS)
     return new Acceleration;
 #else
     // Shall not be called.
@@ -64,7 +84,7 @@ ts::AES::Acceleration* ts::AES::newAccel()
 
 void ts::AES::deleteAccel(Acceleration* accel)
 {
-#if defined(TS_ARM_AES_INSTRUCTIONS)
+#if defined(TS_ARM_AES_INSTRUCTIONS) || defined(TS_X86_AES_INSTRUCTIONS)
     delete accel;
 #else
     // Shall not be called.
@@ -97,6 +117,20 @@ void ts::AES::setKeyAccel()
         accel.eK[i] = vld1q_u8(ek + 16 * i);
         accel.dK[i] = vld1q_u8(dk + 16 * i);
     }
+#elif defined(TS_X86_AES_INSTRUCTIONS)
+    // Serialize the scheduled keys in big endian order, as expected by AES-NI instructions.
+    // The decryption keys are already in the "equivalent inverse cipher" form which is used by AESDEC.
+    Acceleration& accel(*_accel);
+    uint8_t ek[16];
+    uint8_t dk[16];
+    for (int i = 0; i <= _nrounds; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            PutUInt32(ek + 4 * j, _eK[4 * i + j]);
+            PutUInt32(dk + 4 * j, _dK[4 * i + j]);
+        }
+        accel.eK[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ek));
+        accel.dK[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dk));
+    }
 #else
     // Shall not be called.
     assert(false);
@@ -141,6 +175,14 @@ void ts::AES::encryptAccel(const uint8_t* pt, uint8_t* ct)
         }
     }
     vst1q_u8(ct, blk);
+#elif defined(TS_X86_AES_INSTRUCTIONS)
+    const Acceleration& accel(*_accel);
+    __m128i blk = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pt)), accel.eK[0]);
+    for (int r = 1; r < _nrounds; ++r) {
+        blk = _mm_aesenc_si128(blk, accel.eK[r]);
+    }
+    blk = _mm_aesenclast_si128(blk, accel.eK[_nrounds]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(ct), blk);
 #else
     // Shall not be called.
     assert(false);
@@ -185,6 +227,117 @@ void ts::AES::decryptAccel(const uint8_t* ct, uint8_t* pt)
         }
     }
     vst1q_u8(pt, blk);
+#elif defined(TS_X86_AES_INSTRUCTIONS)
+    const Acceleration& accel(*_accel);
+    __m128i blk = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ct)), accel.dK[0]);
+    for (int r = 1; r < _nrounds; ++r) {
+        blk = _mm_aesdec_si128(blk, accel.dK[r]);
+    }
+    blk = _mm_aesdeclast_si128(blk, accel.dK[_nrounds]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pt), blk);
+#else
+    // Shall not be called.
+    assert(false);
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Accelerated encryption of several blocks in ECB mode.
+// Independent blocks are interleaved to fill the pipeline of AES instructions.
+//----------------------------------------------------------------------------
+
+void ts::AES::encryptBlocksAccel(const uint8_t* pt, uint8_t* ct, size_t count)
+{
+#if defined(TS_ARM_AES_INSTRUCTIONS)
+    const Acceleration& accel(*_accel);
+    for (; count >= PIPELINE_BLOCKS; count -= PIPELINE_BLOCKS, pt += PIPELINE_BLOCKS * BLOCK_SIZE, ct += PIPELINE_BLOCKS * BLOCK_SIZE) {
+        uint8x16_t blk[PIPELINE_BLOCKS];
+        for (size_t i = 0; i < PIPELINE_BLOCKS; ++i) {
+            blk[i] = vld1q_u8(pt + i * BLOCK_SIZE);
+        }
+        for (int r = 0; r < _nrounds - 1; ++r) {
+            for (size_t i = 0; i < PIPELINE_BLOCKS; ++i) {
+                blk[i] = vaesmcq_u8(vaeseq_u8(blk[i], accel.eK[r]));
+            }
+        }
+        for (size_t i = 0; i < PIPELINE_BLOCKS; ++i) {
+            vst1q_u8(ct + i * BLOCK_SIZE, veorq_u8(vaeseq_u8(blk[i], accel.eK[_nrounds - 1]), accel.eK[_nrounds]));
+        }
+    }
+    for (; count > 0; --count, pt += BLOCK_SIZE, ct += BLOCK_SIZE) {
+        encryptAccel(pt, ct);
+    }
+#elif defined(TS_X86_AES_INSTRUCTIONS)
+    const Acceleration& accel(*_accel);
+    for (; count >= PIPELINE_BLOCKS; count -= PIPELINE_BLOCKS, pt += PIPELINE_BLOCKS * BLOCK_SIZE, ct += PIPELINE_BLOCKS * BLOCK_SIZE) {
+        __m128i blk[PIPELINE_BLOCKS];
+        for (size_t i = 0; i < PIPELINE_BLOCKS; ++i) {
+            blk[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pt + i * BLOCK_SIZE)), accel.eK[0]);
+        }
+        for (int r = 1; r < _nrounds; ++r) {
+            for (size_t i = 0; i < PIPELINE_BLOCKS; ++i) {
+                blk[i] = _mm_aesenc_si128(blk[i], accel.eK[r]);
+            }
+        }
+        for (size_t i = 0; i < PIPELINE_BLOCKS; ++i) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(ct + i * BLOCK_SIZE), _mm_aesenclast_si128(blk[i], accel.eK[_nrounds]));
+        }
+    }
+    for (; count > 0; --count, pt += BLOCK_SIZE, ct += BLOCK_SIZE) {
+        encryptAccel(pt, ct);
+    }
+#else
+    // Shall not be called.
+    assert(false);
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Accelerated decryption of several blocks in ECB mode.
+//----------------------------------------------------------------------------
+
+void ts::AES::decryptBlocksAccel(const uint8_t* ct, uint8_t* pt, size_t count)
+{
+#if defined(TS_ARM_AES_INSTRUCTIONS)
+    const Acceleration& accel(*_accel);
+    for (; count >= PIPELINE_BLOCKS; count -= PIPELINE_BLOCKS, ct += PIPELINE_BLOCKS * BLOCK_SIZE, pt += PIPELINE_BLOCKS * BLOCK_SIZE) {
+        uint8x16_t blk[PIPELINE_BLOCKS];
+        for (size_t i = 0; i < PIPELINE_BLOCKS; ++i) {
+            blk[i] = vld1q_u8(ct + i * BLOCK_SIZE);
+        }
+        for (int r = 0; r < _nrounds - 1; ++r) {
+            for (size_t i = 0; i < PIPELINE_BLOCKS; ++i) {
+                blk[i] = vaesimcq_u8(vaesdq_u8(blk[i], accel.dK[r]));
+            }
+        }
+        for (size_t i = 0; i < PIPELINE_BLOCKS; ++i) {
+            vst1q_u8(pt + i * BLOCK_SIZE, veorq_u8(vaesdq_u8(blk[i], accel.dK[_nrounds - 1]), accel.dK[_nrounds]));
+        }
+    }
+    for (; count > 0; --count, ct += BLOCK_SIZE, pt += BLOCK_SIZE) {
+        decryptAccel(ct, pt);
+    }
+#elif defined(TS_X86_AES_INSTRUCTIONS)
+    const Acceleration& accel(*_accel);
+    for (; count >= PIPELINE_BLOCKS; count -= PIPELINE_BLOCKS, ct += PIPELINE_BLOCKS * BLOCK_SIZE, pt += PIPELINE_BLOCKS * BLOCK_SIZE) {
+        __m128i blk[PIPELINE_BLOCKS];
+        for (size_t i = 0; i < PIPELINE_BLOCKS; ++i) {
+            blk[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ct + i * BLOCK_SIZE)), accel.dK[0]);
+        }
+        for (int r = 1; r < _nrounds; ++r) {
+            for (size_t i = 0; i < PIPELINE_BLOCKS; ++i) {
+                blk[i] = _mm_aesdec_si128(blk[i], accel.dK[r]);
+            }
+        }
+        for (size_t i = 0; i < PIPELINE_BLOCKS; ++i) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pt + i * BLOCK_SIZE), _mm_aesdeclast_si128(blk[i], accel.dK[_nrounds]));
+        }
+    }
+    for (; count > 0; --count, ct += BLOCK_SIZE, pt += BLOCK_SIZE) {
+        decryptAccel(ct, pt);
+    }
 #else
     // Shall not be called.
     assert(false);
@@ -998,3 +998,30 @@ bool ts::AES::decryptImpl(const void* cipher, size_t cipher_length, void* plain,
     }
     return true;
 }
+
+
+//----------------------------------------------------------------------------
+// Encryption and decryption of several blocks in ECB mode.
+//----------------------------------------------------------------------------
+
+bool ts::AES::encryptBlocksImpl(const uint8_t* plain, uint8_t* cipher, size_t count)
+{
+    if (_accel_supported) {
+        encryptBlocksAccel(plain, cipher, count);
+        return true;
+    }
+    else {
+        return BlockCipher::encryptBlocksImpl(plain, cipher, count);
+    }
+}
+
+bool ts::AES::decryptBlocksImpl(const uint8_t* cipher, uint8_t* plain, size_t count)
+{
+    if (_accel_supported) {
+        decryptBlocksAccel(cipher, plain, count);
+        return true;
+    }
+    else {
+        return BlockCipher::decryptBlocksImpl(cipher, plain, count);
+    }
+}
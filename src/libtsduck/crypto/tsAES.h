@@ -68,6 +68,8 @@ namespace ts {
         virtual bool setKeyImpl(const void* key, size_t key_length, size_t rounds) override;
         virtual bool encryptImpl(const void* plain, size_t plain_length, void* cipher, size_t cipher_maxsize, size_t* cipher_length) override;
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length) override;
+        virtual bool encryptBlocksImpl(const uint8_t* plain, uint8_t* cipher, size_t count) override;
+        virtual bool decryptBlocksImpl(const uint8_t* cipher, uint8_t* plain, size_t count) override;
 
     private:
         class Acceleration;
@@ -87,5 +89,7 @@ namespace ts {
         void setKeyAccel();
         void encryptAccel(const uint8_t* pt, uint8_t* ct);
         void decryptAccel(const uint8_t* ct, uint8_t* pt);
+        void encryptBlocksAccel(const uint8_t* pt, uint8_t* ct, size_t count);
+        void decryptBlocksAccel(const uint8_t* ct, uint8_t* pt, size_t count);
     };
 }
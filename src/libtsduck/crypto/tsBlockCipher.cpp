@@ -173,3 +173,97 @@ bool ts::BlockCipher::decryptInPlaceImpl(void* data, size_t data_length, size_t*
     const size_t plain_max_size = max_actual_length != nullptr ? *max_actual_length : data_length;
     return decryptImpl(cipher.data(), cipher.size(), data, plain_max_size, max_actual_length);
 }
+
+
+//----------------------------------------------------------------------------
+// Encrypt several consecutive blocks in ECB mode.
+//----------------------------------------------------------------------------
+
+bool ts::BlockCipher::encryptBlocks(const void* plain, void* cipher, size_t count)
+{
+    return allowEncrypt() && encryptBlocksImpl(reinterpret_cast<const uint8_t*>(plain), reinterpret_cast<uint8_t*>(cipher), count);
+}
+
+bool ts::BlockCipher::encryptBlocksImpl(const uint8_t* plain, uint8_t* cipher, size_t count)
+{
+    const size_t bsize = blockSize();
+    for (size_t i = 0; i < count; ++i) {
+        if (!encryptImpl(plain + i * bsize, bsize, cipher + i * bsize, bsize, nullptr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Decrypt several consecutive blocks in ECB mode.
+//----------------------------------------------------------------------------
+
+bool ts::BlockCipher::decryptBlocks(const void* cipher, void* plain, size_t count)
+{
+    return allowDecrypt() && decryptBlocksImpl(reinterpret_cast<const uint8_t*>(cipher), reinterpret_cast<uint8_t*>(plain), count);
+}
+
+bool ts::BlockCipher::decryptBlocksImpl(const uint8_t* cipher, uint8_t* plain, size_t count)
+{
+    const size_t bsize = blockSize();
+    for (size_t i = 0; i < count; ++i) {
+        if (!decryptImpl(cipher + i * bsize, bsize, plain + i * bsize, bsize, nullptr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Encrypt several independent messages in place.
+//----------------------------------------------------------------------------
+
+bool ts::BlockCipher::encryptMessages(uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (!allowEncrypt()) {
+            return false;
+        }
+    }
+    return encryptMessagesImpl(data, sizes, count);
+}
+
+bool ts::BlockCipher::encryptMessagesImpl(uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        size_t size = sizes[i];
+        if (!encryptInPlaceImpl(data[i], sizes[i], &size) || size != sizes[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Decrypt several independent messages in place.
+//----------------------------------------------------------------------------
+
+bool ts::BlockCipher::decryptMessages(uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (!allowDecrypt()) {
+            return false;
+        }
+    }
+    return decryptMessagesImpl(data, sizes, count);
+}
+
+bool ts::BlockCipher::decryptMessagesImpl(uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        size_t size = sizes[i];
+        if (!decryptInPlaceImpl(data[i], sizes[i], &size) || size != sizes[i]) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -189,6 +189,71 @@ namespace ts {
         //!
         bool decryptInPlace(void* data, size_t data_length, size_t* max_actual_length = nullptr);
 
+        //!
+        //! Encrypt several consecutive blocks of data in ECB mode.
+        //!
+        //! This method is intended for pure block ciphers such as AES or DES. Some algorithms
+        //! process several blocks at once, with hardware acceleration when available.
+        //! This is used by cipher chainings to process all independent blocks at once.
+        //! The operation counts as one encryption for the current key.
+        //!
+        //! @param [in] plain Address of plain text.
+        //! @param [out] cipher Address of buffer for cipher text. It can be the same address
+        //! as @a plain (encryption in place) but the two areas shall not partially overlap.
+        //! @param [in] count Number of blocks to encrypt. The size of @a plain and @a cipher
+        //! is @a count times blockSize().
+        //! @return True on success, false on error.
+        //!
+        bool encryptBlocks(const void* plain, void* cipher, size_t count);
+
+        //!
+        //! Decrypt several consecutive blocks of data in ECB mode.
+        //!
+        //! This method is intended for pure block ciphers such as AES or DES. Some algorithms
+        //! process several blocks at once, with hardware acceleration when available.
+        //! This is used by cipher chainings to process all independent blocks at once.
+        //! The operation counts as one decryption for the current key.
+        //!
+        //! @param [in] cipher Address of cipher text.
+        //! @param [out] plain Address of buffer for plain text. It can be the same address
+        //! as @a cipher (decryption in place) but the two areas shall not partially overlap.
+        //! @param [in] count Number of blocks to decrypt. The size of @a cipher and @a plain
+        //! is @a count times blockSize().
+        //! @return True on success, false on error.
+        //!
+        bool decryptBlocks(const void* cipher, void* plain, size_t count);
+
+        //!
+        //! Encrypt several independent messages in place.
+        //!
+        //! Each message is encrypted as with encryptInPlace(), without padding: the encrypted
+        //! message has the same size as the plain message. This is typically used to process
+        //! the payloads of a window of TS packets at once. Some cipher chainings interleave
+        //! the processing of the messages, to use the multi-block capabilities of the algorithm.
+        //! Each message counts as one encryption for the current key.
+        //!
+        //! @param [in,out] data Array of @a count addresses of messages to encrypt.
+        //! @param [in] sizes Array of @a count message sizes in bytes.
+        //! @param [in] count Number of messages.
+        //! @return True on success, false on error.
+        //!
+        bool encryptMessages(uint8_t* const data[], const size_t sizes[], size_t count);
+
+        //!
+        //! Decrypt several independent messages in place.
+        //!
+        //! Each message is decrypted as with decryptInPlace(), without padding: the decrypted
+        //! message has the same size as the encrypted message. This is typically used to process
+        //! the payloads of a window of TS packets at once.
+        //! Each message counts as one decryption for the current key.
+        //!
+        //! @param [in,out] data Array of @a count addresses of messages to decrypt.
+        //! @param [in] sizes Array of @a count message sizes in bytes.
+        //! @param [in] count Number of messages.
+        //! @return True on success, false on error.
+        //!
+        bool decryptMessages(uint8_t* const data[], const size_t sizes[], size_t count);
+
         //!
         //! Get the number of times the current key was used for encryption.
         //! @return The number of times the current key was used for encryption.
@@ -314,6 +379,50 @@ namespace ts {
         //!
         virtual bool decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length);
 
+        //!
+        //! Encrypt several consecutive blocks of data in ECB mode (implementation of algorithm-specific part).
+        //! The default implementation calls encryptImpl() on each block.
+        //! A subclass may provide a more efficient implementation.
+        //! @param [in] plain Address of plain text.
+        //! @param [out] cipher Address of buffer for cipher text, can be the same as @a plain.
+        //! @param [in] count Number of blocks to encrypt.
+        //! @return True on success, false on error.
+        //!
+        virtual bool encryptBlocksImpl(const uint8_t* plain, uint8_t* cipher, size_t count);
+
+        //!
+        //! Decrypt several consecutive blocks of data in ECB mode (implementation of algorithm-specific part).
+        //! The default implementation calls decryptImpl() on each block.
+        //! A subclass may provide a more efficient implementation.
+        //! @param [in] cipher Address of cipher text.
+        //! @param [out] plain Address of buffer for plain text, can be the same as @a cipher.
+        //! @param [in] count Number of blocks to decrypt.
+        //! @return True on success, false on error.
+        //!
+        virtual bool decryptBlocksImpl(const uint8_t* cipher, uint8_t* plain, size_t count);
+
+        //!
+        //! Encrypt several independent messages in place (implementation of algorithm-specific part).
+        //! The default implementation calls encryptInPlaceImpl() on each message.
+        //! A subclass may provide a more efficient implementation.
+        //! @param [in,out] data Array of @a count addresses of messages to encrypt.
+        //! @param [in] sizes Array of @a count message sizes in bytes.
+        //! @param [in] count Number of messages.
+        //! @return True on success, false on error.
+        //!
+        virtual bool encryptMessagesImpl(uint8_t* const data[], const size_t sizes[], size_t count);
+
+        //!
+        //! Decrypt several independent messages in place (implementation of algorithm-specific part).
+        //! The default implementation calls decryptInPlaceImpl() on each message.
+        //! A subclass may provide a more efficient implementation.
+        //! @param [in,out] data Array of @a count addresses of messages to decrypt.
+        //! @param [in] sizes Array of @a count message sizes in bytes.
+        //! @param [in] count Number of messages.
+        //! @return True on success, false on error.
+        //!
+        virtual bool decryptMessagesImpl(uint8_t* const data[], const size_t sizes[], size_t count);
+
     private:
         bool      _key_set {false};                   // Current key successfully set.
         int       _cipher_id {0};                     // Cipher identity (from application).
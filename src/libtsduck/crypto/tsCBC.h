@@ -75,6 +75,12 @@ namespace ts {
 
         //! @copydoc ts::BlockCipher::decryptImpl()
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length) override;
+
+        //! @copydoc ts::BlockCipher::decryptInPlaceImpl()
+        virtual bool decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length) override;
+
+        //! @copydoc ts::BlockCipher::encryptMessagesImpl()
+        virtual bool encryptMessagesImpl(uint8_t* const data[], const size_t sizes[], size_t count) override;
     };
 }
 
@@ -165,26 +171,38 @@ bool ts::CBC<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, void
         *plain_length = cipher_length;
     }
 
-    const uint8_t* previous = this->iv.data();
-    const uint8_t* ct = reinterpret_cast<const uint8_t*> (cipher);
-    uint8_t* pt = reinterpret_cast<uint8_t*> (plain);
+    // All blocks are independently decrypted, using multi-block decryption.
+    return this->decryptBlocksCBC(this->iv.data(), reinterpret_cast<const uint8_t*>(cipher), reinterpret_cast<uint8_t*>(plain), cipher_length / this->block_size);
+}
+
+
+//----------------------------------------------------------------------------
+// Decryption in place in CBC mode: the cipher text is no longer needed
+// once all blocks are decrypted, no need to save it first.
+//----------------------------------------------------------------------------
 
-    while (cipher_length > 0) {
-        // work = decrypt (cipher-text)
-        if (!this->algo->decrypt(ct, this->block_size, this->work.data(), this->block_size)) {
+template<class CIPHER>
+bool ts::CBC<CIPHER>::decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length)
+{
+    return this->decryptImpl(data, data_length, data, max_actual_length != nullptr ? *max_actual_length : data_length, max_actual_length);
+}
+
+
+//----------------------------------------------------------------------------
+// Encryption of several messages in CBC mode.
+//----------------------------------------------------------------------------
+
+template<class CIPHER>
+bool ts::CBC<CIPHER>::encryptMessagesImpl(uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    if (this->algo == nullptr || this->iv.size() != this->block_size) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (sizes[i] % this->block_size != 0) {
             return false;
         }
-        // plain-text = previous-cipher XOR work
-        for (size_t i = 0; i < this->block_size; ++i) {
-            pt[i] = previous[i] ^ this->work[i];
-        }
-        // previous-cipher = cipher-text
-        previous = ct;
-        // advance one block
-        ct += this->block_size;
-        pt += this->block_size;
-        cipher_length -= this->block_size;
     }
-
-    return true;
+    // The messages are interleaved to use multi-block encryption.
+    return this->encryptMessagesCBC(data, sizes, count, this->iv.data());
 }
@@ -194,27 +194,33 @@ bool ts::CTR<CIPHER>::encryptImpl(const void* plain, size_t plain_length, void*
     // work[0] = iv
     ::memcpy(this->work.data(), this->iv.data(), this->block_size);
 
-    // Loop on all blocks, including last truncated one.
+    // Loop on groups of blocks, including last truncated one.
+    // The key stream of several blocks is computed at once using multi-block encryption.
 
     const uint8_t* pt = reinterpret_cast<const uint8_t*>(plain);
     uint8_t* ct = reinterpret_cast<uint8_t*>(cipher);
 
     while (plain_length > 0) {
-        // work[1] = encrypt(work[0])
-        if (!this->algo->encrypt(this->work.data(), this->block_size, this->work.data() + this->block_size, this->block_size)) {
+        // Number of blocks in this group, including last truncated one.
+        const size_t blocks = std::min<size_t>((plain_length + this->block_size - 1) / this->block_size, size_t(CipherChaining::BATCH_BLOCKS));
+        // batch[i] = work[0] + i
+        for (size_t blk = 0; blk < blocks; ++blk) {
+            ::memcpy(this->batch.data() + blk * this->block_size, this->work.data(), this->block_size);
+            if (!incrementCounter()) {
+                return false;
+            }
+        }
+        // batch = encrypt(batch)
+        if (!this->algo->encryptBlocks(this->batch.data(), this->batch.data(), blocks)) {
             return false;
         }
-        // This block size:
-        const size_t size = std::min(plain_length, this->block_size);
-        // cipher-text = plain-text XOR work[1]
+        // This group size:
+        const size_t size = std::min(plain_length, blocks * this->block_size);
+        // cipher-text = plain-text XOR batch
         for (size_t i = 0; i < size; ++i) {
-            ct[i] = this->work[this->block_size + i] ^ pt[i];
-        }
-        // work[0] += 1
-        if (!incrementCounter()) {
-            return false;
+            ct[i] = this->batch[i] ^ pt[i];
         }
-        // advance one block
+        // advance the group of blocks
         ct += size;
         pt += size;
         plain_length -= size;
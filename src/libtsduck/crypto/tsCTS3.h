@@ -119,14 +119,13 @@ bool ts::CTS3<CIPHER>::encryptImpl(const void* plain, size_t plain_length, void*
     uint8_t* ct = reinterpret_cast<uint8_t*> (cipher);
 
     // Process in ECB mode, except the last 2 blocks
-    while (plain_length > 2 * this->block_size) {
-        if (!this->algo->encrypt(pt, this->block_size, ct, this->block_size)) {
-            return false;
-        }
-        ct += this->block_size;
-        pt += this->block_size;
-        plain_length -= this->block_size;
+    const size_t count = (plain_length - this->block_size - 1) / this->block_size;
+    if (count > 0 && !this->algo->encryptBlocks(pt, ct, count)) {
+        return false;
     }
+    pt += count * this->block_size;
+    ct += count * this->block_size;
+    plain_length -= count * this->block_size;
 
     // Process final two blocks.
     assert(plain_length > this->block_size);
@@ -167,14 +166,13 @@ bool ts::CTS3<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, voi
     uint8_t* pt = reinterpret_cast<uint8_t*> (plain);
 
     // Process in ECB mode, except the last 2 blocks
-    while (cipher_length > 2 * this->block_size) {
-        if (!this->algo->decrypt (ct, this->block_size, pt, this->block_size)) {
-            return false;
-        }
-        ct += this->block_size;
-        pt += this->block_size;
-        cipher_length -= this->block_size;
+    const size_t count = (cipher_length - this->block_size - 1) / this->block_size;
+    if (count > 0 && !this->algo->decryptBlocks(ct, pt, count)) {
+        return false;
     }
+    ct += count * this->block_size;
+    pt += count * this->block_size;
+    cipher_length -= count * this->block_size;
 
     // Process final two blocks.
     assert(cipher_length > this->block_size);
@@ -29,6 +29,10 @@
 
 #include "tsCipherChaining.h"
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::CipherChaining::BATCH_BLOCKS;
+#endif
+
 
 //----------------------------------------------------------------------------
 // Constructor for subclasses
@@ -40,7 +44,8 @@ ts::CipherChaining::CipherChaining(BlockCipher* cipher, size_t iv_min_blocks, si
     iv_min_size(iv_min_blocks * block_size),
     iv_max_size(iv_max_blocks * block_size),
     iv(iv_max_blocks * block_size),
-    work(work_blocks * block_size)
+    work(work_blocks * block_size),
+    batch(BATCH_BLOCKS * block_size)
 {
 }
 
@@ -124,3 +129,88 @@ bool ts::CipherChaining::setIV(const void* iv_data, size_t iv_length)
         return true;
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Decrypt consecutive blocks in CBC mode, using multi-block decryption.
+//----------------------------------------------------------------------------
+
+bool ts::CipherChaining::decryptBlocksCBC(const uint8_t* previous, const uint8_t* cipher, uint8_t* plain, size_t count)
+{
+    if (algo == nullptr || batch.size() < BATCH_BLOCKS * block_size) {
+        return false;
+    }
+
+    // Process batches from the end of the message. When decrypting in place, each
+    // plain text block overwrites a cipher block which is no longer used.
+    size_t end = count;
+    while (end > 0) {
+        const size_t first = end > BATCH_BLOCKS ? end - BATCH_BLOCKS : 0;
+
+        // batch = decrypt (cipher-text)
+        if (!algo->decryptBlocks(cipher + first * block_size, batch.data(), end - first)) {
+            return false;
+        }
+
+        // plain-text = previous-cipher XOR batch, from last to first block.
+        for (size_t blk = end; blk-- > first; ) {
+            const uint8_t* prev = blk == 0 ? previous : cipher + (blk - 1) * block_size;
+            const uint8_t* dec = batch.data() + (blk - first) * block_size;
+            uint8_t* pt = plain + blk * block_size;
+            for (size_t i = 0; i < block_size; ++i) {
+                pt[i] = prev[i] ^ dec[i];
+            }
+        }
+        end = first;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Encrypt in place the complete blocks of several messages in CBC mode.
+//----------------------------------------------------------------------------
+
+bool ts::CipherChaining::encryptMessagesCBC(uint8_t* const data[], const size_t sizes[], size_t count, const uint8_t* initial)
+{
+    if (algo == nullptr || batch.size() < BATCH_BLOCKS * block_size) {
+        return false;
+    }
+
+    // Process messages by groups of BATCH_BLOCKS.
+    for (size_t first = 0; first < count; first += BATCH_BLOCKS) {
+        const size_t end = count - first > BATCH_BLOCKS ? first + BATCH_BLOCKS : count;
+
+        // Number of complete blocks in the largest message of the group.
+        size_t max_blocks = 0;
+        for (size_t msg = first; msg < end; ++msg) {
+            max_blocks = std::max(max_blocks, sizes[msg] / block_size);
+        }
+
+        // Encrypt the same block in all messages of the group at once.
+        for (size_t blk = 0; blk < max_blocks; ++blk) {
+            // batch = previous-cipher XOR plain-text, for all messages which contain this block.
+            size_t index[BATCH_BLOCKS];
+            size_t n = 0;
+            for (size_t msg = first; msg < end; ++msg) {
+                if (sizes[msg] / block_size > blk) {
+                    const uint8_t* prev = blk == 0 ? initial : data[msg] + (blk - 1) * block_size;
+                    const uint8_t* pt = data[msg] + blk * block_size;
+                    uint8_t* work_blk = batch.data() + n * block_size;
+                    for (size_t i = 0; i < block_size; ++i) {
+                        work_blk[i] = prev[i] ^ pt[i];
+                    }
+                    index[n++] = msg;
+                }
+            }
+            // cipher-text = encrypt (batch)
+            if (!algo->encryptBlocks(batch.data(), batch.data(), n)) {
+                return false;
+            }
+            for (size_t i = 0; i < n; ++i) {
+                ::memcpy(data[index[i]] + blk * block_size, batch.data() + i * block_size, block_size);  // Flawfinder: ignore: memcpy()
+            }
+        }
+    }
+    return true;
+}
@@ -99,6 +99,12 @@ namespace ts {
         const size_t iv_max_size; //!< IV max size in bytes.
         ByteBlock    iv;          //!< Current initialization vector.
         ByteBlock    work;        //!< Temporary working buffer.
+        ByteBlock    batch;       //!< Temporary buffer for multi-block operations, BATCH_BLOCKS blocks.
+
+        //!
+        //! Number of blocks which are processed at once in multi-block operations.
+        //!
+        static constexpr size_t BATCH_BLOCKS = 8;
 
         //!
         //! Constructor for subclasses.
@@ -114,6 +120,32 @@ namespace ts {
 
         // Implementation of BlockCipher interface:
         virtual bool setKeyImpl(const void* key, size_t key_length, size_t rounds) override;
+
+        //!
+        //! Decrypt consecutive blocks in CBC mode, using multi-block decryption.
+        //! In CBC mode, the decryption of all blocks is independent. The blocks are decrypted
+        //! by batches of BATCH_BLOCKS using decryptBlocks() on the block cipher. The batches
+        //! are processed from the end of the message to allow decryption in place.
+        //! @param [in] previous Address of the cipher block before the first one (usually the IV).
+        //! @param [in] cipher Address of cipher text.
+        //! @param [out] plain Address of plain text. Can be the same as @a cipher.
+        //! @param [in] count Number of blocks to decrypt.
+        //! @return True on success, false on error.
+        //!
+        bool decryptBlocksCBC(const uint8_t* previous, const uint8_t* cipher, uint8_t* plain, size_t count);
+
+        //!
+        //! Encrypt in place the complete blocks of several independent messages in CBC mode.
+        //! In CBC mode, the encryption of successive blocks in a message is serialized. To use
+        //! multi-block encryption, the same block in up to BATCH_BLOCKS messages is encrypted at once.
+        //! A residue after the last complete block of a message is left unmodified.
+        //! @param [in,out] data Array of @a count addresses of messages to encrypt.
+        //! @param [in] sizes Array of @a count message sizes in bytes.
+        //! @param [in] count Number of messages.
+        //! @param [in] initial Initialization vector for all messages, one block.
+        //! @return True on success, false on error.
+        //!
+        bool encryptMessagesCBC(uint8_t* const data[], const size_t sizes[], size_t count, const uint8_t* initial);
     };
 
     //!
@@ -103,8 +103,23 @@ namespace ts {
         //! @copydoc ts::BlockCipher::decryptImpl()
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize,                              size_t* plain_length) override;
 
+        //! @copydoc ts::BlockCipher::decryptInPlaceImpl()
+        virtual bool decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length) override;
+
+        //! @copydoc ts::BlockCipher::encryptMessagesImpl()
+        virtual bool encryptMessagesImpl(uint8_t* const data[], const size_t sizes[], size_t count) override;
+
+        //! @copydoc ts::BlockCipher::decryptMessagesImpl()
+        virtual bool decryptMessagesImpl(uint8_t* const data[], const size_t sizes[], size_t count) override;
+
     protected:
         ByteBlock shortIV;  //!< Current initialization vector for short blocks.
+
+    private:
+        // Process the final incomplete blocks of several messages, using multi-block encryption.
+        // The residue processing is identical for encryption and decryption. When decrypting,
+        // it must be done first because it uses the last complete cipher block of the message.
+        bool processResidues(uint8_t* const data[], const size_t sizes[], size_t count);
     };
 }
 
@@ -253,39 +268,109 @@ bool ts::DVS042<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, v
         *plain_length = cipher_length;
     }
 
-    // Select IV depending on block size.
-    const uint8_t* previous = cipher_length < this->block_size ? this->shortIV.data() : this->iv.data();
-
-    // Decrypt all blocks in CBC mode, except the last one if partial
     const uint8_t* ct = reinterpret_cast<const uint8_t*>(cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*>(plain);
+    const size_t count = cipher_length / this->block_size;
+    const size_t residue = cipher_length % this->block_size;
 
-    while (cipher_length >= this->block_size) {
-        // work = decrypt (cipher-text)
-        if (!this->algo->decrypt(ct, this->block_size, this->work.data(), this->block_size)) {
+    // Process final block first if incomplete. When decrypting in place,
+    // the previous cipher block will be overwritten by the CBC decryption.
+    if (residue > 0) {
+        // work = encrypt (Cn-1), which is encrypt (shortIV) for short packets
+        const uint8_t* previous = count == 0 ? this->shortIV.data() : ct + (count - 1) * this->block_size;
+        if (!this->algo->encrypt(previous, this->block_size, this->work.data(), this->block_size)) {
             return false;
         }
-        // plain-text = previous-cipher XOR work
-        for (size_t i = 0; i < this->block_size; ++i) {
-            pt[i] = previous[i] ^ this->work[i];
+        // Pn = work XOR Cn, truncated
+        const size_t last = count * this->block_size;
+        for (size_t i = 0; i < residue; ++i) {
+            pt[last + i] = this->work[i] ^ ct[last + i];
         }
-        // previous-cipher = cipher-text
-        previous = ct;
-        // advance one block
-        ct += this->block_size;
-        pt += this->block_size;
-        cipher_length -= this->block_size;
     }
 
-    // Process final block if incomplete
-    if (cipher_length > 0) {
-        // work = encrypt (Cn-1), which is encrypt (shortIV) for short packets
-        if (!this->algo->encrypt(previous, this->block_size, this->work.data(), this->block_size)) {
+    // Decrypt all complete blocks in CBC mode, using multi-block decryption.
+    return this->decryptBlocksCBC(this->iv.data(), ct, pt, count);
+}
+
+
+//----------------------------------------------------------------------------
+// Decryption in place in DVS 042 mode: no need to save the cipher text.
+//----------------------------------------------------------------------------
+
+template<class CIPHER>
+bool ts::DVS042<CIPHER>::decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length)
+{
+    return this->decryptImpl(data, data_length, data, max_actual_length != nullptr ? *max_actual_length : data_length, max_actual_length);
+}
+
+
+//----------------------------------------------------------------------------
+// Encryption and decryption of several messages in DVS 042 mode.
+//----------------------------------------------------------------------------
+
+template<class CIPHER>
+bool ts::DVS042<CIPHER>::encryptMessagesImpl(uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    if (this->algo == nullptr || this->iv.size() != this->block_size || this->shortIV.size() != this->block_size) {
+        return false;
+    }
+    // Complete blocks of all messages are interleaved, then all residues are processed.
+    return this->encryptMessagesCBC(data, sizes, count, this->iv.data()) && processResidues(data, sizes, count);
+}
+
+template<class CIPHER>
+bool ts::DVS042<CIPHER>::decryptMessagesImpl(uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    if (this->algo == nullptr || this->iv.size() != this->block_size || this->shortIV.size() != this->block_size) {
+        return false;
+    }
+    // Process all residues first, while the last complete cipher blocks are still available.
+    if (!processResidues(data, sizes, count)) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!this->decryptBlocksCBC(this->iv.data(), data[i], data[i], sizes[i] / this->block_size)) {
             return false;
         }
-        // Pn = work XOR Cn, truncated
-        for (size_t i = 0; i < cipher_length; ++i) {
-            pt[i] = this->work[i] ^ ct[i];
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Process the final incomplete blocks of several messages.
+//----------------------------------------------------------------------------
+
+template<class CIPHER>
+bool ts::DVS042<CIPHER>::processResidues(uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    const size_t bsize = this->block_size;
+    size_t index[CipherChaining::BATCH_BLOCKS];
+    size_t n = 0;
+
+    for (size_t msg = 0; msg <= count; ++msg) {
+        // Flush the batch when full or after the last message.
+        if (n > 0 && (n == CipherChaining::BATCH_BLOCKS || msg == count)) {
+            // batch = encrypt (Cn-1), which is encrypt (shortIV) for short packets
+            if (!this->algo->encryptBlocks(this->batch.data(), this->batch.data(), n)) {
+                return false;
+            }
+            // Rn = batch XOR Rn, truncated
+            for (size_t i = 0; i < n; ++i) {
+                const size_t residue = sizes[index[i]] % bsize;
+                uint8_t* last = data[index[i]] + sizes[index[i]] - residue;
+                for (size_t j = 0; j < residue; ++j) {
+                    last[j] ^= this->batch[i * bsize + j];
+                }
+            }
+            n = 0;
+        }
+        // Add the previous cipher block of an incomplete final block in the batch.
+        if (msg < count && sizes[msg] % bsize != 0) {
+            const size_t complete = sizes[msg] - sizes[msg] % bsize;
+            const uint8_t* previous = complete == 0 ? this->shortIV.data() : data[msg] + complete - bsize;
+            ::memcpy(this->batch.data() + n * bsize, previous, bsize);
+            index[n++] = msg;
         }
     }
     return true;
@@ -96,6 +96,7 @@ ts::TSAnalyzer::TSAnalyzer(DuckContext& duck, const BitRate& bitrate_hint, BitRa
     _pids(),
     _services(),
     _modified(false),
+    _context_only(false),
     _ts_bitrate_sum(0),
     _ts_bitrate_cnt(0),
     _preceding_errors(0),
@@ -127,6 +128,7 @@ ts::TSAnalyzer::~TSAnalyzer()
 void ts::TSAnalyzer::reset()
 {
     _modified = false;
+    _context_only = false;
     _ts_id = 0;
     _ts_id_valid = false;
     _ts_pkt_cnt = 0;
@@ -306,7 +308,15 @@ ts::TSAnalyzer::PIDContext::PIDContext(PID pid_, const UString& description_) :
     br_last_pcr(INVALID_PCR),
     br_last_pcr_pkt(0),
     ts_bitrate_sum(0),
-    ts_bitrate_cnt(0)
+    ts_bitrate_cnt(0),
+    first_pkt(0),
+    first_continuity(0),
+    first_payload(false),
+    first_discontinuity(false),
+    first_ts_sc(0),
+    cryptop_first_ts(0),
+    br_first_pcr(INVALID_PCR),
+    br_first_pcr_pkt(0)
 {
     // Guess the initial description, based on the PID
     // Global PID's (PAT, CAT, etc) are marked as "referenced" since they
@@ -514,7 +524,9 @@ void ts::TSAnalyzer::PIDContext::addService(uint16_t service_id)
 
 void ts::TSAnalyzer::handleInvalidSection(SectionDemux&, const DemuxedData& data)
 {
-    getPID(data.sourcePID())->inv_sections++;
+    if (!_context_only) {
+        getPID(data.sourcePID())->inv_sections++;
+    }
 }
 
 
@@ -525,6 +537,11 @@ void ts::TSAnalyzer::handleInvalidSection(SectionDemux&, const DemuxedData& data
 
 void ts::TSAnalyzer::handleSection(SectionDemux&, const Section& section)
 {
+    // Sections in context packets were already counted in the previous part of the stream.
+    if (_context_only) {
+        return;
+    }
+
     ETIDContextPtr etc(getETID(section));
     const uint8_t version = section.version();
 
@@ -717,7 +734,9 @@ void ts::TSAnalyzer::analyzePMT(PID pid, const PMT& pmt)
 {
     // Count the number of PMT's on this PID
     PIDContextPtr ps(getPID(pid));
-    ps->pmt_cnt++;
+    if (!_context_only) {
+        ps->pmt_cnt++;
+    }
 
     // Get service description
     ServiceContextPtr svp(getService(pmt.service_id));
@@ -1400,7 +1419,9 @@ void ts::TSAnalyzer::handleNewMPEG2AudioAttributes(PESDemux&, const PESPacket& p
 
 void ts::TSAnalyzer::handleInvalidPESPacket(PESDemux&, const DemuxedData& data)
 {
-    getPID(data.sourcePID())->inv_pes++;
+    if (!_context_only) {
+        getPID(data.sourcePID())->inv_pes++;
+    }
 }
 
 
@@ -1483,7 +1504,9 @@ void ts::TSAnalyzer::handleT2MIPacket(T2MIDemux& demux, const T2MIPacket& pkt)
     PIDContextPtr pc(getPID(pkt.sourcePID(), u"T2-MI"));
 
     // Count T2-MI packets.
-    pc->t2mi_cnt++;
+    if (!_context_only) {
+        pc->t2mi_cnt++;
+    }
 
     // Process PLP (only in baseband frame).
     if (pkt.plpValid()) {
@@ -1506,7 +1529,9 @@ void ts::TSAnalyzer::handleTSPacket(T2MIDemux& demux, const T2MIPacket& t2mi, co
     PIDContextPtr pc(getPID(t2mi.sourcePID(), u"T2-MI"));
 
     // Count demux'ed TS packets from this PLP.
-    pc->t2mi_plp_ts[t2mi.plp()]++;
+    if (!_context_only) {
+        pc->t2mi_plp_ts[t2mi.plp()]++;
+    }
 }
 
 
@@ -1569,7 +1594,9 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
 
     // Get PID context
     PIDContextPtr ps(getPID(pkt.getPID()));
-    ps->ts_pkt_cnt++;
+    if (ps->ts_pkt_cnt++ == 0) {
+        ps->first_pkt = packet_index;
+    }
 
     // Accumulate stat from packet
     if (pkt.hasAF()) {
@@ -1593,7 +1620,12 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
     else if (pkt.getScrambling() != SC_CLEAR) {
         ps->ts_sc_cnt++;
     }
-    if (pkt.getScrambling() != ps->cur_ts_sc) {
+    if (ps->ts_pkt_cnt == 1) {
+        // First packet in the PID, start of first crypto-period (or clear period).
+        ps->first_ts_sc = ps->cur_ts_sc = pkt.getScrambling();
+        ps->cur_ts_sc_pkt = packet_index;
+    }
+    else if (pkt.getScrambling() != ps->cur_ts_sc) {
         // Change of crypto-period
         if (ps->cur_ts_sc != SC_CLEAR) {
             // End of a crypto-period, not a clear/scramble transition.
@@ -1605,6 +1637,9 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
             if (ps->cryptop_cnt > 1) {
                 ps->cryptop_ts_cnt += packet_index - ps->cur_ts_sc_pkt;
             }
+            else {
+                ps->cryptop_first_ts = packet_index - ps->cur_ts_sc_pkt;
+            }
         }
         ps->cur_ts_sc = pkt.getScrambling();
         ps->cur_ts_sc_pkt = packet_index;
@@ -1615,7 +1650,9 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
     if (ps->pid != PID_NULL) {
         if (ps->ts_pkt_cnt == 1) {
             // First packet, initialize continuity
-            ps->cur_continuity = pkt.getCC();
+            ps->cur_continuity = ps->first_continuity = pkt.getCC();
+            ps->first_payload = pkt.hasPayload();
+            ps->first_discontinuity = pkt.getDiscontinuityIndicator();
         }
         else if (pkt.getDiscontinuityIndicator()) {
             // Expected discontinuity
@@ -1654,6 +1691,11 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
         // Count PID's with PCR
         if (ps->pcr_cnt++ == 0) {
             _pcr_pid_cnt++;
+            // Keep first PCR for bitrate computation across merged analyses.
+            if (ps->exp_discont == 0 && ps->unexp_discont == 0) {
+                ps->br_first_pcr = pcr;
+                ps->br_first_pcr_pkt = packet_index;
+            }
         }
         // If last PCR valid, compute transport rate between the two
         if (ps->br_last_pcr != INVALID_PCR && ps->br_last_pcr < pcr) {
@@ -1753,6 +1795,405 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
 }
 
 
+//----------------------------------------------------------------------------
+// Feed the analyzer with a TS packet which precedes the analyzed part.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::feedContextPacket(const TSPacket& pkt)
+{
+    // Only the demux are fed, to collect the PSI/SI context and the start of
+    // sections and PES packets. The handlers do not count anything.
+    if (pkt.hasValidSync() && !pkt.getTEI()) {
+        _context_only = true;
+        _demux.feedPacket(pkt);
+        _pes_demux.feedPacket(pkt);
+        _t2mi_demux.feedPacket(pkt);
+        _context_only = false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Merge the analysis of the next contiguous part of the same stream.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::merge(TSAnalyzer& next)
+{
+    // Packet indexes in the next part start after all packets in this part.
+    const uint64_t offset = _ts_pkt_cnt;
+
+    // Global counters.
+    _ts_pkt_cnt += next._ts_pkt_cnt;
+    _invalid_sync += next._invalid_sync;
+    _transport_errors += next._transport_errors;
+    _suspect_ignored += next._suspect_ignored;
+    _ts_bitrate_sum += next._ts_bitrate_sum;
+    _ts_bitrate_cnt += next._ts_bitrate_cnt;
+    _preceding_errors = next._preceding_errors;
+    _preceding_suspects = next._preceding_suspects;
+    _tid_present |= next._tid_present;
+
+    // The most recent information comes from the next part.
+    if (next._ts_id_valid) {
+        _ts_id = next._ts_id;
+        _ts_id_valid = true;
+    }
+    if (!next._country_code.empty()) {
+        _country_code = next._country_code;
+    }
+    if (_first_utc == Time::Epoch) {
+        _first_utc = next._first_utc;
+        _first_local = next._first_local;
+    }
+    if (_first_tdt == Time::Epoch) {
+        _first_tdt = next._first_tdt;
+    }
+    if (next._last_tdt != Time::Epoch) {
+        _last_tdt = next._last_tdt;
+    }
+    if (_first_tot == Time::Epoch) {
+        _first_tot = next._first_tot;
+    }
+    if (next._last_tot != Time::Epoch) {
+        _last_tot = next._last_tot;
+    }
+    if (_first_stt == Time::Epoch) {
+        _first_stt = next._first_stt;
+    }
+    if (next._last_stt != Time::Epoch) {
+        _last_stt = next._last_stt;
+    }
+
+    // Merge PID's. PID's which are only in the next part are moved here.
+    for (auto& it : next._pids) {
+        const auto cur = _pids.find(it.first);
+        if (cur != _pids.end()) {
+            mergePID(*cur->second, *it.second, offset);
+        }
+        else {
+            PIDContext& pc(*it.second);
+            pc.first_pkt += offset;
+            pc.cur_ts_sc_pkt += offset;
+            pc.br_last_pcr_pkt += offset;
+            pc.br_first_pcr_pkt += offset;
+            for (auto& etc : pc.sections) {
+                etc.second->first_pkt += offset;
+                etc.second->last_pkt += offset;
+            }
+            _pids.insert(it);
+        }
+    }
+
+    // Merge services.
+    for (auto& it : next._services) {
+        const auto cur = _services.find(it.first);
+        if (cur == _services.end()) {
+            _services.insert(it);
+        }
+        else {
+            ServiceContext& srv(*cur->second);
+            const ServiceContext& nsrv(*it.second);
+            if (nsrv.orig_netw_id != 0) {
+                srv.orig_netw_id = nsrv.orig_netw_id;
+            }
+            if (nsrv.service_type != 0) {
+                srv.service_type = nsrv.service_type;
+            }
+            if (!nsrv.name.empty()) {
+                srv.name = nsrv.name;
+            }
+            if (!nsrv.provider.empty()) {
+                srv.provider = nsrv.provider;
+            }
+            if (nsrv.pmt_pid != 0) {
+                srv.pmt_pid = nsrv.pmt_pid;
+            }
+            if (nsrv.pcr_pid != 0) {
+                srv.pcr_pid = nsrv.pcr_pid;
+            }
+            srv.carry_ssu = srv.carry_ssu || nsrv.carry_ssu;
+            srv.carry_t2mi = srv.carry_t2mi || nsrv.carry_t2mi;
+        }
+    }
+
+    // Recount PID's which were first found in the next part.
+    _scrambled_pid_cnt = 0;
+    _pcr_pid_cnt = 0;
+    for (const auto& it : _pids) {
+        if (it.second->scrambled) {
+            _scrambled_pid_cnt++;
+        }
+        if (it.second->pcr_cnt > 0) {
+            _pcr_pid_cnt++;
+        }
+    }
+
+    _modified = true;
+    next.reset();
+}
+
+
+//----------------------------------------------------------------------------
+// Merge the context of a PID from the next part of the stream.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::mergePID(PIDContext& pc, const PIDContext& next, uint64_t offset)
+{
+    // Descriptive information. The most recent one, from the next part, is preferred.
+    if (next.referenced && next.description != UNREFERENCED) {
+        pc.description = next.description;
+    }
+    if (!next.comment.empty()) {
+        pc.comment = next.comment;
+    }
+    if (next.stream_type != 0) {
+        pc.stream_type = next.stream_type;
+    }
+    if (next.cas_id != 0) {
+        pc.cas_id = next.cas_id;
+    }
+    if (!pc.audio2.isValid()) {
+        pc.audio2 = next.audio2;
+    }
+    for (const auto& it : next.languages) {
+        AppendUnique(pc.languages, it);
+    }
+    for (const auto& it : next.attributes) {
+        AppendUnique(pc.attributes, it);
+    }
+    pc.services.insert(next.services.begin(), next.services.end());
+    pc.cas_operators.insert(next.cas_operators.begin(), next.cas_operators.end());
+    pc.ssu_oui.insert(next.ssu_oui.begin(), next.ssu_oui.end());
+    for (const auto& it : next.t2mi_plp_ts) {
+        pc.t2mi_plp_ts[it.first] += it.second;
+    }
+    pc.is_pmt_pid = pc.is_pmt_pid || next.is_pmt_pid;
+    pc.is_pcr_pid = pc.is_pcr_pid || next.is_pcr_pid;
+    pc.referenced = pc.referenced || next.referenced;
+    pc.optional = pc.optional && next.optional;
+    pc.carry_pes = pc.carry_pes || next.carry_pes;
+    pc.carry_section = pc.carry_section || next.carry_section;
+    pc.carry_ecm = pc.carry_ecm || next.carry_ecm;
+    pc.carry_emm = pc.carry_emm || next.carry_emm;
+    pc.carry_audio = pc.carry_audio || next.carry_audio;
+    pc.carry_video = pc.carry_video || next.carry_video;
+    pc.carry_t2mi = pc.carry_t2mi || next.carry_t2mi;
+    pc.scrambled = pc.scrambled || next.scrambled;
+
+    // PES stream id.
+    if (pc.pes_stream_id == 0) {
+        pc.pes_stream_id = next.pes_stream_id;
+        pc.same_stream_id = next.same_stream_id;
+    }
+    else if (next.pes_stream_id != 0) {
+        pc.same_stream_id = pc.same_stream_id && next.same_stream_id && pc.pes_stream_id == next.pes_stream_id;
+    }
+
+    // Sections, with repetition intervals across the boundary.
+    for (const auto& it : next.sections) {
+        const auto cur = pc.sections.find(it.first);
+        if (cur != pc.sections.end()) {
+            mergeETID(*cur->second, *it.second, offset);
+        }
+        else {
+            it.second->first_pkt += offset;
+            it.second->last_pkt += offset;
+            pc.sections.insert(it);
+        }
+    }
+
+    // The rest of the processing applies to packets in the next part.
+    if (next.ts_pkt_cnt > 0) {
+
+        // Index of first packet of this PID in the next part, from the beginning of this part.
+        const uint64_t first_index = offset + next.first_pkt;
+
+        // Check continuity on the first packet of the next part, same as feedPacket().
+        bool broken_rate = false;
+        if (pc.ts_pkt_cnt > 0 && pc.pid != PID_NULL) {
+            if (next.first_discontinuity) {
+                pc.exp_discont++;
+                broken_rate = true;
+            }
+            else if (next.first_payload) {
+                if (next.first_continuity == pc.cur_continuity) {
+                    pc.duplicated++;
+                }
+                else if (next.first_continuity != (pc.cur_continuity + 1) % CC_MAX) {
+                    pc.unexp_discont++;
+                    broken_rate = true;
+                }
+            }
+            else if (next.first_continuity != pc.cur_continuity) {
+                pc.unexp_discont++;
+                broken_rate = true;
+            }
+        }
+        pc.cur_continuity = next.cur_continuity;
+
+        // TS bitrate between the last PCR of this part and the first PCR of the next part.
+        if (!broken_rate && pc.br_last_pcr != INVALID_PCR && next.br_first_pcr != INVALID_PCR && pc.br_last_pcr < next.br_first_pcr) {
+            const BitRate ts_bitrate = BitRate((offset + next.br_first_pcr_pkt - pc.br_last_pcr_pkt) * SYSTEM_CLOCK_FREQ * PKT_SIZE_BITS) / (next.br_first_pcr - pc.br_last_pcr);
+            pc.ts_bitrate_sum += ts_bitrate;
+            pc.ts_bitrate_cnt++;
+            _ts_bitrate_sum += ts_bitrate;
+            _ts_bitrate_cnt++;
+        }
+        if (pc.pcr_cnt == 0 && pc.exp_discont == 0 && pc.unexp_discont == 0 && !broken_rate) {
+            pc.br_first_pcr = next.br_first_pcr;
+            pc.br_first_pcr_pkt = offset + next.br_first_pcr_pkt;
+        }
+        if (next.br_last_pcr != INVALID_PCR) {
+            pc.br_last_pcr = next.br_last_pcr;
+            pc.br_last_pcr_pkt = offset + next.br_last_pcr_pkt;
+        }
+        else if (broken_rate || next.exp_discont > 0 || next.unexp_discont > 0) {
+            pc.br_last_pcr = INVALID_PCR;
+        }
+
+        // Clock leaps across the boundary.
+        if (pc.last_pcr != INVALID_PCR && next.first_pcr != INVALID_PCR && (pc.last_pcr > next.first_pcr || (next.first_pcr - pc.last_pcr) > SYSTEM_CLOCK_FREQ)) {
+            pc.pcr_leap_cnt++;
+        }
+        if (pc.last_pts != INVALID_PTS && next.first_pts != INVALID_PTS) {
+            const uint64_t diff = next.first_pts > pc.last_pts ? next.first_pts - pc.last_pts : pc.last_pts - next.first_pts;
+            if (diff > 3 * SYSTEM_CLOCK_SUBFREQ) {
+                pc.pts_leap_cnt++;
+            }
+        }
+        if (pc.last_dts != INVALID_DTS && next.first_dts != INVALID_DTS && (pc.last_dts > next.first_dts || (next.first_dts - pc.last_dts) > 3 * SYSTEM_CLOCK_SUBFREQ)) {
+            pc.dts_leap_cnt++;
+        }
+        if (pc.first_pcr == INVALID_PCR) {
+            pc.first_pcr = next.first_pcr;
+        }
+        if (next.last_pcr != INVALID_PCR) {
+            pc.last_pcr = next.last_pcr;
+        }
+        if (pc.first_pts == INVALID_PTS) {
+            pc.first_pts = next.first_pts;
+        }
+        if (next.last_pts != INVALID_PTS) {
+            pc.last_pts = next.last_pts;
+        }
+        if (pc.first_dts == INVALID_DTS) {
+            pc.first_dts = next.first_dts;
+        }
+        if (next.last_dts != INVALID_DTS) {
+            pc.last_dts = next.last_dts;
+        }
+
+        // Crypto-periods. A change of scrambling control at the boundary ends the last
+        // crypto-period of this part. Otherwise, the first crypto-period of the next part
+        // is the continuation of the last one in this part.
+        const bool border_change = pc.cur_ts_sc != next.first_ts_sc;
+        if (border_change && pc.cur_ts_sc != SC_CLEAR) {
+            if (pc.cryptop_cnt++ == 0) {
+                pc.cryptop_first_ts = first_index - pc.cur_ts_sc_pkt;
+            }
+            else {
+                pc.cryptop_ts_cnt += first_index - pc.cur_ts_sc_pkt;
+            }
+        }
+        if (next.cryptop_cnt > 0) {
+            // Length of the first complete crypto-period of the next part, in the complete stream.
+            uint64_t first_length = next.cryptop_first_ts;
+            if (!border_change && next.first_ts_sc != SC_CLEAR) {
+                first_length += first_index - pc.cur_ts_sc_pkt;
+            }
+            if (pc.cryptop_cnt == 0) {
+                pc.cryptop_first_ts = first_length;
+            }
+            else {
+                pc.cryptop_ts_cnt += first_length;
+            }
+            pc.cryptop_cnt += next.cryptop_cnt;
+            pc.cryptop_ts_cnt += next.cryptop_ts_cnt;
+        }
+        if (next.cur_ts_sc_pkt != next.first_pkt) {
+            pc.cur_ts_sc_pkt = offset + next.cur_ts_sc_pkt;
+        }
+        else if (border_change) {
+            pc.cur_ts_sc_pkt = first_index;
+        }
+        pc.cur_ts_sc = next.cur_ts_sc;
+
+        // State at start of analysis.
+        if (pc.ts_pkt_cnt == 0) {
+            pc.first_pkt = first_index;
+            pc.first_continuity = next.first_continuity;
+            pc.first_payload = next.first_payload;
+            pc.first_discontinuity = next.first_discontinuity;
+            pc.first_ts_sc = next.first_ts_sc;
+        }
+    }
+
+    // Accumulate counters.
+    pc.ts_pkt_cnt += next.ts_pkt_cnt;
+    pc.ts_af_cnt += next.ts_af_cnt;
+    pc.unit_start_cnt += next.unit_start_cnt;
+    pc.pl_start_cnt += next.pl_start_cnt;
+    pc.pmt_cnt += next.pmt_cnt;
+    pc.unexp_discont += next.unexp_discont;
+    pc.exp_discont += next.exp_discont;
+    pc.duplicated += next.duplicated;
+    pc.ts_sc_cnt += next.ts_sc_cnt;
+    pc.inv_ts_sc_cnt += next.inv_ts_sc_cnt;
+    pc.inv_sections += next.inv_sections;
+    pc.inv_pes += next.inv_pes;
+    pc.inv_pes_start += next.inv_pes_start;
+    pc.t2mi_cnt += next.t2mi_cnt;
+    pc.pcr_cnt += next.pcr_cnt;
+    pc.pts_cnt += next.pts_cnt;
+    pc.dts_cnt += next.dts_cnt;
+    pc.pcr_leap_cnt += next.pcr_leap_cnt;
+    pc.pts_leap_cnt += next.pts_leap_cnt;
+    pc.dts_leap_cnt += next.dts_leap_cnt;
+    pc.ts_bitrate_sum += next.ts_bitrate_sum;
+    pc.ts_bitrate_cnt += next.ts_bitrate_cnt;
+}
+
+
+//----------------------------------------------------------------------------
+// Merge the context of a table from the next part of the stream.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::mergeETID(ETIDContext& etc, const ETIDContext& next, uint64_t offset)
+{
+    etc.section_count += next.section_count;
+    if (next.table_count == 0) {
+        return;
+    }
+    if (etc.table_count == 0) {
+        etc.first_pkt = offset + next.first_pkt;
+        etc.first_version = next.first_version;
+        etc.min_repetition_ts = next.min_repetition_ts;
+        etc.max_repetition_ts = next.max_repetition_ts;
+    }
+    else {
+        // Repetition interval across the boundary.
+        const uint64_t rep = offset + next.first_pkt - etc.last_pkt;
+        if (etc.table_count == 1 || rep < etc.min_repetition_ts) {
+            etc.min_repetition_ts = rep;
+        }
+        if (etc.table_count == 1 || rep > etc.max_repetition_ts) {
+            etc.max_repetition_ts = rep;
+        }
+        if (next.table_count > 1) {
+            etc.min_repetition_ts = std::min(etc.min_repetition_ts, next.min_repetition_ts);
+            etc.max_repetition_ts = std::max(etc.max_repetition_ts, next.max_repetition_ts);
+        }
+    }
+    etc.table_count += next.table_count;
+    etc.last_pkt = offset + next.last_pkt;
+    etc.last_version = next.last_version;
+    etc.versions |= next.versions;
+    if (etc.table_count > 1) {
+        etc.repetition_ts = (etc.last_pkt - etc.first_pkt + (etc.table_count - 1) / 2) / (etc.table_count - 1);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Specify a "bitrate hint" for the analysis. It is the user-specified
 // bitrate in bits/seconds, based on 188-byte packets. The bitrate is
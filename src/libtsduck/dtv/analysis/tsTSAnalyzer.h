@@ -87,6 +87,35 @@ namespace ts {
         //!
         void feedPacket(const TSPacket& packet);
 
+        //!
+        //! Feed the analyzer with a TS packet which precedes the analyzed part of the stream.
+        //!
+        //! This is used when a large stream is split into contiguous chunks which are analyzed
+        //! in parallel, each one with a distinct analyzer. Before analyzing its chunk, an analyzer
+        //! can be fed with some packets from the end of the previous chunk. These packets are not
+        //! counted in the analysis. They are only used to collect the PSI/SI context and the
+        //! start of the sections and PES packets which overlap the chunk boundary.
+        //! @param [in] packet One TS packet from the stream.
+        //! @see merge()
+        //!
+        void feedContextPacket(const TSPacket& packet);
+
+        //!
+        //! Merge the analysis of the next contiguous part of the same stream.
+        //!
+        //! This is used when a large stream is split into contiguous chunks which are analyzed
+        //! in parallel, each one with a distinct analyzer. The analyzers are then merged in order
+        //! into the first one. The statistics which depend on consecutive packets (continuity
+        //! counters, PCR-based bitrates, table repetition rates, crypto-periods) are adjusted at
+        //! the chunk boundary so that the result is the same as a sequential analysis.
+        //!
+        //! @param [in,out] next The analyzer of the part of the stream which immediately follows
+        //! the packets which were analyzed by this object. On return, @a next is reset.
+        //! Both analyzers shall use the same bitrate hint.
+        //! @see feedContextPacket()
+        //!
+        void merge(TSAnalyzer& next);
+
         //!
         //! Reset the analysis context.
         //!
@@ -383,6 +412,16 @@ namespace ts {
             BitRate       ts_bitrate_sum;   //!< Sum of all computed TS bitrates.
             uint64_t      ts_bitrate_cnt;   //!< Number of computed TS bitrates.
 
+            // Public members - Analysis data: State at start of analysis, used to merge analyses.
+            uint64_t      first_pkt;           //!< Index of first packet in the PID.
+            uint8_t       first_continuity;    //!< Continuity counter in first packet.
+            bool          first_payload;       //!< First packet has a payload.
+            bool          first_discontinuity; //!< First packet has the discontinuity indicator set.
+            uint8_t       first_ts_sc;         //!< Scrambling control in first packet.
+            uint64_t      cryptop_first_ts;    //!< Number of TS packets in first crypto-period (not in cryptop_ts_cnt).
+            uint64_t      br_first_pcr;        //!< First PCR value in the PID, when not preceded by a discontinuity.
+            uint64_t      br_first_pcr_pkt;    //!< Index of packet with br_first_pcr.
+
             //!
             //! Default constructor.
             //! @param [in] pid PID value.
@@ -507,6 +546,11 @@ namespace ts {
         // Reset the section demux.
         void resetSectionDemux();
 
+        // Merge the context of a PID or a table from the next part of the stream.
+        // The packet indexes in the next part start after offset.
+        void mergePID(PIDContext& pc, const PIDContext& next, uint64_t offset);
+        static void mergeETID(ETIDContext& etc, const ETIDContext& next, uint64_t offset);
+
         // Analyze the various PSI tables
         void analyzePAT(const PAT&);
         void analyzeCAT(const CAT&);
@@ -554,6 +598,7 @@ namespace ts {
 
         // TSAnalyzer private members (state data, used during analysis):
         bool         _modified;                  // Internal data modified, need recomputeStatistics
+        bool         _context_only;              // Processing context packets, do not count anything
         BitRate      _ts_bitrate_sum;            // Sum of all computed TS bitrates
         uint64_t     _ts_bitrate_cnt;            // Number of computed TS bitrates
         uint64_t     _preceding_errors;          // Number of contiguous invalid packets before current packet
@@ -51,7 +51,10 @@ ts::TSScrambling::TSScrambling(Report& report, uint8_t scrambling) :
     _idsa(),
     _aescbc(),
     _aesctr(),
-    _scrambler{nullptr, nullptr}
+    _scrambler{nullptr, nullptr},
+    _batch_packets(),
+    _batch_data(),
+    _batch_sizes()
 {
     setScramblingType(scrambling);
 }
@@ -71,7 +74,10 @@ ts::TSScrambling::TSScrambling(const TSScrambling& other) :
     _idsa(),
     _aescbc(),
     _aesctr(),
-    _scrambler{nullptr, nullptr}
+    _scrambler{nullptr, nullptr},
+    _batch_packets(),
+    _batch_data(),
+    _batch_sizes()
 {
     setScramblingType(_scrambling_type);
     _dvbcsa[0].setEntropyMode(other._dvbcsa[0].entropyMode());
@@ -93,7 +99,10 @@ ts::TSScrambling::TSScrambling(TSScrambling&& other) :
     _idsa(),
     _aescbc(),
     _aesctr(),
-    _scrambler{nullptr, nullptr}
+    _scrambler{nullptr, nullptr},
+    _batch_packets(),
+    _batch_data(),
+    _batch_sizes()
 {
     setScramblingType(_scrambling_type);
     _dvbcsa[0].setEntropyMode(other._dvbcsa[0].entropyMode());
@@ -583,3 +592,129 @@ bool ts::TSScrambling::decrypt(TSPacket& pkt)
     }
     return ok;
 }
+
+
+//----------------------------------------------------------------------------
+// Encrypt several TS packets with the current parity and corresponding CW.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::encrypt(TSPacket* const pkts[], size_t count)
+{
+    // If no current parity is set, start with even by default.
+    if (_encrypt_scv == SC_CLEAR && !setEncryptParity(SC_EVEN_KEY)) {
+        return false;
+    }
+
+    // Select scrambling algo.
+    assert(_encrypt_scv == SC_EVEN_KEY || _encrypt_scv == SC_ODD_KEY);
+    CipherChaining* algo = _scrambler[_encrypt_scv & 1];
+    assert(algo != nullptr);
+
+    // Build the batch of packets to encrypt.
+    for (size_t i = 0; i < count; ++i) {
+        TSPacket& pkt(*pkts[i]);
+        if (pkt.isScrambled()) {
+            // Filter out encrypted packets, after encrypting the previous ones.
+            processBatch(algo, true, _encrypt_scv);
+            _report.error(u"try to scramble an already scrambled packet");
+            return false;
+        }
+        // Silently pass packets without payload.
+        if (pkt.hasPayload()) {
+            addToBatch(algo, pkt);
+        }
+    }
+    return processBatch(algo, true, _encrypt_scv);
+}
+
+
+//----------------------------------------------------------------------------
+// Decrypt several TS packets with the CW corresponding to their parity.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::decrypt(TSPacket* const pkts[], size_t count)
+{
+    CipherChaining* algo = nullptr;
+
+    for (size_t i = 0; i < count; ++i) {
+        TSPacket& pkt(*pkts[i]);
+
+        // Clear or invalid packets are silently accepted.
+        const uint8_t scv = pkt.getScrambling();
+        if (scv != SC_EVEN_KEY && scv != SC_ODD_KEY) {
+            continue;
+        }
+
+        // On parity change, decrypt all packets with the previous parity first.
+        if (scv != _decrypt_scv) {
+            if (!processBatch(algo, false, SC_CLEAR)) {
+                return false;
+            }
+            const uint8_t previous_scv = _decrypt_scv;
+            _decrypt_scv = scv;
+
+            // In case of fixed control word, use next key when the scrambling control changes.
+            if (hasFixedCW() && previous_scv != _decrypt_scv && !setNextFixedCW(_decrypt_scv)) {
+                return false;
+            }
+        }
+
+        // Select descrambling algo.
+        algo = _scrambler[_decrypt_scv & 1];
+        assert(algo != nullptr);
+        addToBatch(algo, pkt);
+    }
+    return processBatch(algo, false, SC_CLEAR);
+}
+
+
+//----------------------------------------------------------------------------
+// Add a packet in the batch.
+//----------------------------------------------------------------------------
+
+void ts::TSScrambling::addToBatch(CipherChaining* algo, TSPacket& pkt)
+{
+    // Check if the residue shall be included in the scrambling.
+    size_t psize = pkt.getPayloadSize();
+    if (!algo->residueAllowed()) {
+        // Remove the residue from the payload.
+        assert(algo->blockSize() != 0);
+        psize -= psize % algo->blockSize();
+    }
+    if (psize > 0) {
+        _batch_data.push_back(pkt.getPayload());
+        _batch_sizes.push_back(psize);
+    }
+    _batch_packets.push_back(&pkt);
+}
+
+
+//----------------------------------------------------------------------------
+// Process the batch of packets.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::processBatch(CipherChaining* algo, bool encrypt, uint8_t scv)
+{
+    bool ok = true;
+    if (!_batch_data.empty()) {
+        assert(algo != nullptr);
+        if (encrypt) {
+            ok = algo->encryptMessages(_batch_data.data(), _batch_sizes.data(), _batch_data.size());
+        }
+        else {
+            ok = algo->decryptMessages(_batch_data.data(), _batch_sizes.data(), _batch_data.size());
+        }
+    }
+    if (ok) {
+        for (auto pkt : _batch_packets) {
+            pkt->setScrambling(scv);
+        }
+    }
+    else {
+        _report.error(u"packet %s error using %s", {encrypt ? u"encryption" : u"decryption", algo->name()});
+    }
+    _batch_packets.clear();
+    _batch_data.clear();
+    _batch_sizes.clear();
+    return ok;
+}
@@ -212,6 +212,28 @@ namespace ts {
         //!
         bool decrypt(TSPacket& pkt);
 
+        //!
+        //! Encrypt several TS packets with the current parity and corresponding CW.
+        //! This is equivalent to calling encrypt() on each packet but the payloads of all
+        //! packets are encrypted at once, using the multi-block capabilities of the
+        //! scrambling algorithm when available.
+        //! @param [in,out] pkts Array of @a count addresses of packets to encrypt.
+        //! @param [in] count Number of packets.
+        //! @return True on success, false on error. An already encrypted packet is an error.
+        //!
+        bool encrypt(TSPacket* const pkts[], size_t count);
+
+        //!
+        //! Decrypt several TS packets with the CW corresponding to the parity in each packet.
+        //! This is equivalent to calling decrypt() on each packet but the payloads of all
+        //! consecutive packets with the same parity are decrypted at once, using the
+        //! multi-block capabilities of the scrambling algorithm when available.
+        //! @param [in,out] pkts Array of @a count addresses of packets to decrypt.
+        //! @param [in] count Number of packets.
+        //! @return True on success, false on error. A clear packet is not an error.
+        //!
+        bool decrypt(TSPacket* const pkts[], size_t count);
+
     private:
         // List of control words
         typedef std::list<ByteBlock> CWList;
@@ -232,6 +254,17 @@ namespace ts {
         CTR<AES>         _aesctr[2];
         CipherChaining*  _scrambler[2];
 
+        // Batch of packets which are processed at once.
+        std::vector<TSPacket*> _batch_packets;  // Packets to update.
+        std::vector<uint8_t*>  _batch_data;     // Payloads to encrypt or decrypt.
+        std::vector<size_t>    _batch_sizes;    // Size of payloads to encrypt or decrypt.
+
+        // Add a packet in the batch.
+        void addToBatch(CipherChaining* algo, TSPacket& pkt);
+
+        // Process the batch of packets, set the scrambling control value of all packets on success.
+        bool processBatch(CipherChaining* algo, bool encrypt, uint8_t scv);
+
         // Set the next fixed control word as scrambling key.
         bool setNextFixedCW(int parity);
 
@@ -195,7 +195,11 @@ void ts::ARIBCharset::Decoder::decodeAll(const uint8_t* data, size_t size)
 
     // Loop in input byte sequences.
     while (_size > 0) {
-        if (match(0x20)) {
+        if (_GL == _lockedGL && _G[_GL] == &ALPHANUMERIC_MAP && *_data >= 0x20 && *_data < 0x7E) {
+            // Fast path for sequences of ASCII characters in the alphanumeric set.
+            decodeAlphanumeric();
+        }
+        else if (match(0x20)) {
             // Always a space in all character sets.
             // Use a "Japanese space" when GL set is not alphanumeric.
             _str.push_back(_G[_GL] == &ALPHANUMERIC_MAP ? SPACE : IDEOGRAPHIC_SPACE);
@@ -264,6 +268,28 @@ bool ts::ARIBCharset::Decoder::match(uint8_t c)
 }
 
 
+//----------------------------------------------------------------------------
+// Decode a sequence of ASCII characters in the alphanumeric set.
+//----------------------------------------------------------------------------
+
+void ts::ARIBCharset::Decoder::decodeAlphanumeric()
+{
+    // The alphanumeric set is identical to ASCII in range 0x20-0x7D, except 0x5C.
+    const size_t previous = _str.size();
+    _str.resize(previous + _size);
+    UChar* const outBase = const_cast<UChar*>(_str.data()) + previous;
+    UChar* out = outBase;
+    UString::ConvertASCIIToUTF16(_data, _data + _size, out, outBase + _size, 0x20, 0x7D);
+    _size -= out - outBase;
+    for (UChar* p = outBase; p < out; ++p) {
+        if (*p == 0x005C) {
+            *p = ALPHANUMERIC_ROW[0x5C - GL_FIRST];
+        }
+    }
+    _str.resize(out - _str.data());
+}
+
+
 //----------------------------------------------------------------------------
 // Decode one character and append to str.
 //----------------------------------------------------------------------------
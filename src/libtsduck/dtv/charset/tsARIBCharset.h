@@ -256,6 +256,9 @@ namespace ts {
             // Decode one character and append to str. Update data and size.
             bool decodeOneChar(const CharMap* gset);
 
+            // Decode a sequence of ASCII characters in the alphanumeric set. Update data and size.
+            void decodeAlphanumeric();
+
             // Process an escape sequence starting at current byte (after ESC).
             bool escape();
 
@@ -95,15 +95,30 @@ ts::DVBCharTableSingleByte::DVBCharTableSingleByte(const UChar* name, uint32_t t
 
 bool ts::DVBCharTableSingleByte::decode(UString& str, const uint8_t* dvb, size_t dvbSize) const
 {
-    str.clear();
-    str.reserve(dvbSize);
+    if (dvb == nullptr) {
+        dvbSize = 0;
+    }
+
+    // Resize the string over the maximum size (one character per byte) and decode directly into it.
+    str.resize(dvbSize);
+    UChar* const outBase = const_cast<UChar*>(str.data());
+    UChar* const outEnd = outBase + dvbSize;
+    UChar* out = outBase;
+    const uint8_t* const dvbEnd = dvb + dvbSize;
+
     bool status = true;
     bool reverseNext = false;  // after decoding next character, it shall be swapped with previous one.
     bool hasDiacritical = false;
 
-    for (; dvb != nullptr && dvbSize > 0; --dvbSize) {
+    while (dvb < dvbEnd) {
         // Get next byte
-        const uint8_t b = *dvb++;
+        const uint8_t b = *dvb;
+        // Fast path for sequences of ASCII characters, identical in all single-byte tables.
+        if (b >= 0x20 && b <= 0x7E && !reverseNext) {
+            UString::ConvertASCIIToUTF16(dvb, dvbEnd, out, outEnd, 0x20, 0x7E);
+            continue;
+        }
+        dvb++;
         // Convert it to a code point
         uint16_t cp = 0;
         if (b >= 0x20 && b <= 0x7E) {
@@ -120,15 +135,17 @@ bool ts::DVBCharTableSingleByte::decode(UString& str, const uint8_t* dvb, size_t
             // Untranslatable character.
             status = false;
         }
-        else if (reverseNext && !str.empty()) {
+        else if (reverseNext && out > outBase) {
             // Insert decoded character before the previous one.
             // This is typically a letter coming after a reversable diacritical mark.
             // In Unicode, the letter must preceed the diacritical mark.
-            str.insert(str.length() - 1, 1, UChar(cp));
+            *out = out[-1];
+            out[-1] = UChar(cp);
+            out++;
         }
         else {
             // Simply add the decoded character.
-            str.push_back(UChar(cp));
+            *out++ = UChar(cp);
         }
         // Try the presence of diacritical, reversable or not.
         hasDiacritical = hasDiacritical || IsCombiningDiacritical(UChar(cp));
@@ -136,6 +153,9 @@ bool ts::DVBCharTableSingleByte::decode(UString& str, const uint8_t* dvb, size_t
         reverseNext = b >= 0xA0 && _reversedDiacritical.test(b - 0xA0);
     }
 
+    // Truncate to the exact number of characters.
+    str.resize(out - outBase);
+
     // If some diacritical mark was found, try to combine them.
     if (hasDiacritical) {
         str.combineDiacritical();
@@ -84,6 +84,7 @@ void ts::AccessUnitIterator::reset()
         // Point to the beginning of area, before the first access unit.
         // Calling next() will find the first one (if any).
         _nalunit = _data;
+        _nalunit_size = 0;
         next();
         // Reset NALunit index since we point to the first one.
         _nalunit_index = 0;
@@ -124,9 +125,8 @@ bool ts::AccessUnitIterator::next()
         return false;
     }
 
-    // Memory patterns which are used between access units.
-    static const uint8_t Zero3[] = {0x00, 0x00, 0x00};
-    static const uint8_t StartCodePrefix[] = {0x00, 0x00, 0x01};
+    // Skip the current access unit, if any. It contains no start code prefix.
+    _nalunit += _nalunit_size;
 
     // Remaining size in data area.
     assert(_nalunit >= _data);
@@ -142,7 +142,7 @@ bool ts::AccessUnitIterator::next()
     // Locate next access unit: starts with 00 00 01.
     // The start code prefix 00 00 01 is not part of the NALunit.
     // The NALunit starts at the NALunit type byte (see H.264, 7.3.1).
-    const uint8_t* const p1 = LocatePattern(_nalunit, remain, StartCodePrefix, sizeof(StartCodePrefix));
+    const uint8_t* const p1 = LocateZeroZero(_nalunit, remain, 0x01);
     if (p1 == nullptr) {
         // No next access unit.
         _nalunit = nullptr;
@@ -151,26 +151,14 @@ bool ts::AccessUnitIterator::next()
     }
 
     // Jump to first byte of NALunit.
-    remain -= p1 - _nalunit + sizeof(StartCodePrefix);
-    _nalunit = p1 + sizeof(StartCodePrefix);
+    remain -= p1 - _nalunit + 3;
+    _nalunit = p1 + 3;
 
     // Locate end of access unit: ends with 00 00 00, 00 00 01 or end of data.
-    const uint8_t* const p2 = LocatePattern(_nalunit, remain, StartCodePrefix, sizeof(StartCodePrefix));
-    const uint8_t* const p3 = LocatePattern(_nalunit, remain, Zero3, sizeof(Zero3));
-    if (p2 == nullptr && p3 == nullptr) {
-        // No 00 00 01, no 00 00 00, the NALunit extends up to the end of data.
-        _nalunit_size = remain;
-    }
-    else if (p2 == nullptr || (p3 != nullptr && p3 < p2)) {
-        // NALunit ends at 00 00 00.
-        assert(p3 != nullptr);
-        _nalunit_size = p3 - _nalunit;
-    }
-    else {
-        // NALunit ends at 00 00 01.
-        assert(p2 != nullptr);
-        _nalunit_size = p2 - _nalunit;
-    }
+    // Because of the start code emulation prevention, these sequences cannot appear inside a NALunit.
+    // Both are searched in one pass, the NALunit ends at the first one.
+    const uint8_t* const p2 = LocateZeroZero(_nalunit, remain, 0x00, 0x01);
+    _nalunit_size = p2 == nullptr ? remain : p2 - _nalunit;
 
     // Extract NALunit type.
     if (_format == CodecType::AVC && _nalunit_size >= 1) {
@@ -72,6 +72,21 @@ void ts::SectionDemux::Status::reset()
     truncated_sect = 0;
 }
 
+// Add the error counters of another status block.
+ts::SectionDemux::Status& ts::SectionDemux::Status::operator+=(const Status& other)
+{
+    invalid_ts += other.invalid_ts;
+    discontinuities += other.discontinuities;
+    scrambled += other.scrambled;
+    inv_sect_length += other.inv_sect_length;
+    inv_sect_index += other.inv_sect_index;
+    inv_sect_version += other.inv_sect_version;
+    wrong_crc += other.wrong_crc;
+    is_next += other.is_next;
+    truncated_sect += other.truncated_sect;
+    return *this;
+}
+
 // Check if any counter is non zero.
 bool ts::SectionDemux::Status::hasErrors() const
 {
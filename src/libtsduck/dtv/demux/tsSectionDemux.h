@@ -205,6 +205,13 @@ namespace ts {
             //!
             void reset();
 
+            //!
+            //! Add the error counters of another status block.
+            //! @param [in] other Another status block.
+            //! @return A reference to this object.
+            //!
+            Status& operator+=(const Status& other);
+
             //!
             //! Check if any counter is non zero.
             //! @return True if any error counter is not zero.
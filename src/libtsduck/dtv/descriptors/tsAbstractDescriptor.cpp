@@ -32,7 +32,7 @@
 #include "tsDescriptor.h"
 #include "tsDescriptorList.h"
 #include "tsPSIBuffer.h"
-#include "tsNames.h"
+#include "tsPSIRepository.h"
 
 
 //----------------------------------------------------------------------------
@@ -82,7 +82,7 @@ ts::EDID ts::AbstractDescriptor::edid(TID tid) const
     if (!isValid()) {
         return EDID();  // invalid value.
     }
-    else if (tid != TID_NULL && names::HasTableSpecificName(_tag, tid)) {
+    else if (tid != TID_NULL && PSIRepository::Instance()->isTableSpecificDescriptor(_tag, tid)) {
         // Table-specific descriptor.
         return EDID::TableSpecific(_tag, tid);
     }
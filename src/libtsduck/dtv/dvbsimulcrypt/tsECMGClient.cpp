@@ -103,6 +103,9 @@ bool ts::ECMGClient::connect(const ECMGClientArgs& args,
                              const AbortInterface* abort,
                              const tlv::Logger& logger)
 {
+    // Synchronous exchanges with the ECMG are serialized.
+    GuardMutex sync(_sync_mutex);
+
     // Initial state check
     {
         GuardMutex lock(_mutex);
@@ -181,6 +184,9 @@ bool ts::ECMGClient::connect(const ECMGClientArgs& args,
     // ECM stream now established
     {
         GuardMutex lock(_mutex);
+        _streams.clear();
+        _streams.insert(std::make_pair(_stream_status.stream_id, StreamContext(_stream_status, _abort, _logger)));
+        _owner = _stream_status.stream_id;
         _state = CONNECTED;
     }
 
@@ -194,29 +200,44 @@ bool ts::ECMGClient::connect(const ECMGClientArgs& args,
 
 bool ts::ECMGClient::disconnect()
 {
+    // Synchronous exchanges with the ECMG are serialized.
+    GuardMutex sync(_sync_mutex);
+
     // Mark disconnection in progress
     State previous_state;
+    std::vector<ecmgscs::StreamCloseRequest> requests;
     {
         GuardMutex lock(_mutex);
         previous_state = _state;
         if (_state == CONNECTING || _state == CONNECTED) {
             _state = DISCONNECTING;
         }
+        // Build one stream_close_request per open stream.
+        requests.reserve(_streams.size());
+        for (const auto& it : _streams) {
+            requests.emplace_back(_protocol);
+            requests.back().channel_id = _channel_status.channel_id;
+            requests.back().stream_id = it.first;
+        }
+        _streams.clear();
+        _async_requests.clear();
     }
 
     // Disconnection sequence
     bool ok = previous_state == CONNECTED;
     if (ok) {
-        // Politely send a stream_close_request
-        ecmgscs::StreamCloseRequest req(_protocol);
-        req.channel_id = _stream_status.channel_id;
-        req.stream_id = _stream_status.stream_id;
-        tlv::MessagePtr resp;
-        // Politely send a stream_close_request
-        // and wait for a stream_close_response
-        ok = _connection.send(req, _logger) &&
-            _response_queue.dequeue(resp, RESPONSE_TIMEOUT) &&
-            resp->tag() == ecmgscs::Tags::stream_close_response;
+        // Politely send all stream_close_request at once
+        // and wait for the corresponding stream_close_response.
+        std::vector<const tlv::Message*> msgs;
+        msgs.reserve(requests.size());
+        for (const auto& req : requests) {
+            msgs.push_back(&req);
+        }
+        ok = _connection.send(msgs.data(), msgs.size(), _logger);
+        for (size_t i = 0; ok && i < requests.size(); ++i) {
+            tlv::MessagePtr resp;
+            ok = _response_queue.dequeue(resp, RESPONSE_TIMEOUT) && resp->tag() == ecmgscs::Tags::stream_close_response;
+        }
         // If we get a polite reply, send a channel_close
         if (ok) {
             ecmgscs::ChannelClose cc(_protocol);
@@ -238,19 +259,121 @@ bool ts::ECMGClient::disconnect()
 }
 
 
+//----------------------------------------------------------------------------
+// Open an additional ECM stream on the channel.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGClient::addStream(uint16_t stream_id,
+                               uint16_t ecm_id,
+                               uint16_t nominal_cp_duration,
+                               ecmgscs::StreamStatus& stream_status,
+                               const AbortInterface* abort,
+                               const tlv::Logger& logger)
+{
+    // Synchronous exchanges with the ECMG are serialized.
+    GuardMutex sync(_sync_mutex);
+
+    // All messages about this stream are reported using its own logger.
+    tlv::Logger log(logger);
+
+    // Check the state of the channel.
+    {
+        GuardMutex lock(_mutex);
+        if (_state != CONNECTED) {
+            log.report().error(u"ECMG client not connected");
+            return false;
+        }
+        if (_streams.find(stream_id) != _streams.end()) {
+            log.report().error(u"ECM stream id %d already open on ECMG channel %d", {stream_id, _channel_status.channel_id});
+            return false;
+        }
+    }
+
+    // Send a stream_setup message to ECMG
+    ecmgscs::StreamSetup stream_setup(_protocol);
+    stream_setup.channel_id = _channel_status.channel_id;
+    stream_setup.stream_id = stream_id;
+    stream_setup.ECM_id = ecm_id;
+    stream_setup.nominal_CP_duration = nominal_cp_duration;
+    if (!_connection.send(stream_setup, log)) {
+        return false;
+    }
+
+    // Wait for a stream_status from the ECMG
+    tlv::MessagePtr msg;
+    if (!_response_queue.dequeue(msg, RESPONSE_TIMEOUT)) {
+        log.report().error(u"ECMG stream_setup response timeout");
+        return false;
+    }
+    ecmgscs::StreamStatus* const ssp = dynamic_cast<ecmgscs::StreamStatus*>(msg.pointer());
+    if (ssp == nullptr || ssp->stream_id != stream_id) {
+        log.report().error(u"unexpected response from ECMG (expected stream_status):\n%s", {msg->dump(4)});
+        return false;
+    }
+    stream_status = *ssp;
+
+    // ECM stream now established
+    GuardMutex lock(_mutex);
+    _streams.insert(std::make_pair(stream_id, StreamContext(*ssp, abort, logger)));
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Close an ECM stream on the channel.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGClient::removeStream(uint16_t stream_id)
+{
+    // Synchronous exchanges with the ECMG are serialized.
+    GuardMutex sync(_sync_mutex);
+
+    // Forget the stream and all its pending requests.
+    tlv::Logger logger;
+    {
+        GuardMutex lock(_mutex);
+        const auto it = _streams.find(stream_id);
+        if (_state != CONNECTED || it == _streams.end()) {
+            _logger.report().error(u"ECM stream id %d not open on ECMG channel", {stream_id});
+            return false;
+        }
+        logger = it->second.logger;
+        _streams.erase(it);
+        _async_requests.erase(_async_requests.lower_bound(RequestKey(stream_id, 0)), _async_requests.upper_bound(RequestKey(stream_id, 0xFFFF)));
+
+        // If the channel used the abort interface and logger of this stream, use those of another stream.
+        if (_owner == stream_id && !_streams.empty()) {
+            _owner = _streams.begin()->first;
+            _abort = _streams.begin()->second.abort;
+            _logger = _streams.begin()->second.logger;
+        }
+    }
+
+    // Send a stream_close_request and wait for a stream_close_response
+    ecmgscs::StreamCloseRequest req(_protocol);
+    req.channel_id = _channel_status.channel_id;
+    req.stream_id = stream_id;
+    tlv::MessagePtr resp;
+    return _connection.send(req, logger) &&
+        _response_queue.dequeue(resp, RESPONSE_TIMEOUT) &&
+        resp->tag() == ecmgscs::Tags::stream_close_response;
+}
+
+
 //----------------------------------------------------------------------------
 // Build a CW_provision message.
 //----------------------------------------------------------------------------
 
 void ts::ECMGClient::buildCWProvision(ecmgscs::CWProvision& msg,
+                                      uint16_t stream_id,
                                       uint16_t cp_number,
                                       const ByteBlock& current_cw,
                                       const ByteBlock& next_cw,
                                       const ByteBlock& ac,
                                       uint16_t cp_duration)
 {
-    msg.channel_id = _stream_status.channel_id;
-    msg.stream_id = _stream_status.stream_id;
+    msg.channel_id = _channel_status.channel_id;
+    msg.stream_id = stream_id;
     msg.CP_number = cp_number;
     msg.has_CW_encryption = false;
     msg.has_CP_duration = cp_duration != 0;
@@ -279,12 +402,27 @@ bool ts::ECMGClient::generateECM(uint16_t cp_number,
                                  uint16_t cp_duration,
                                  ecmgscs::ECMResponse& ecm_response)
 {
+    return generateECM(_stream_status.stream_id, cp_number, current_cw, next_cw, ac, cp_duration, ecm_response);
+}
+
+bool ts::ECMGClient::generateECM(uint16_t stream_id,
+                                 uint16_t cp_number,
+                                 const ByteBlock& current_cw,
+                                 const ByteBlock& next_cw,
+                                 const ByteBlock& ac,
+                                 uint16_t cp_duration,
+                                 ecmgscs::ECMResponse& ecm_response)
+{
+    // Synchronous exchanges with the ECMG are serialized.
+    GuardMutex sync(_sync_mutex);
+    tlv::Logger logger(streamLogger(stream_id));
+
     // Build a CW_provision message
     ecmgscs::CWProvision msg(_protocol);
-    buildCWProvision(msg, cp_number, current_cw, next_cw, ac, cp_duration);
+    buildCWProvision(msg, stream_id, cp_number, current_cw, next_cw, ac, cp_duration);
 
     // Send the CW_provision message
-    if (!_connection.send(msg, _logger)) {
+    if (!_connection.send(msg, logger)) {
         return false;
     }
 
@@ -294,13 +432,13 @@ bool ts::ECMGClient::generateECM(uint16_t cp_number,
     // Wait for an ECM response from the ECMG
     tlv::MessagePtr resp;
     if (!_response_queue.dequeue(resp, timeout)) {
-        _logger.report().error(u"ECM generation timeout");
+        logger.report().error(u"ECM generation timeout");
         return false;
     }
     if (resp->tag() == ecmgscs::Tags::ECM_response) {
         ecmgscs::ECMResponse* const ep = dynamic_cast <ecmgscs::ECMResponse*>(resp.pointer());
         assert(ep != nullptr);
-        if (ep->CP_number == cp_number) {
+        if (ep->stream_id == stream_id && ep->CP_number == cp_number) {
             // This is our ECM
             ecm_response = *ep;
             return true;
@@ -311,7 +449,7 @@ bool ts::ECMGClient::generateECM(uint16_t cp_number,
     // and status_test. They are automatically handled in the reception thread.
     // At this point, if we receive a message, this is an error or an truely
     // unexpected message.
-    _logger.report().error(u"unexpected response to ECM request:\n%s", {resp->dump(4)});
+    logger.report().error(u"unexpected response to ECM request:\n%s", {resp->dump(4)});
     return false;
 }
 
@@ -326,30 +464,118 @@ bool ts::ECMGClient::submitECM(uint16_t cp_number,
                                const ByteBlock& ac,
                                uint16_t cp_duration,
                                ECMGClientHandlerInterface* ecm_handler)
+{
+    return submitECM(_stream_status.stream_id, cp_number, current_cw, next_cw, ac, cp_duration, ecm_handler);
+}
+
+bool ts::ECMGClient::submitECM(uint16_t stream_id,
+                               uint16_t cp_number,
+                               const ByteBlock& current_cw,
+                               const ByteBlock& next_cw,
+                               const ByteBlock& ac,
+                               uint16_t cp_duration,
+                               ECMGClientHandlerInterface* ecm_handler)
 {
     // Build a CW_provision message
     ecmgscs::CWProvision msg(_protocol);
-    buildCWProvision(msg, cp_number, current_cw, next_cw, ac, cp_duration);
+    buildCWProvision(msg, stream_id, cp_number, current_cw, next_cw, ac, cp_duration);
 
     // Register an asynchronous request
-    {
-        GuardMutex lock(_mutex);
-        _async_requests.insert(std::make_pair(cp_number, ecm_handler));
+    if (!registerRequest(stream_id, cp_number, ecm_handler)) {
+        return false;
     }
 
     // Send the CW_provision message
-    bool ok = _connection.send(msg, _logger);
+    tlv::Logger logger(streamLogger(stream_id));
+    bool ok = _connection.send(msg, logger);
 
     // Clear asynchronous request on error
     if (!ok) {
         GuardMutex lock(_mutex);
-        _async_requests.erase(cp_number);
+        _async_requests.erase(RequestKey(stream_id, cp_number));
     }
 
     return ok;
 }
 
 
+//----------------------------------------------------------------------------
+// Asynchronously generate a batch of ECM's.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGClient::submitECMs(const ECMRequestVector& requests)
+{
+    if (requests.empty()) {
+        return true;
+    }
+
+    // Build all CW_provision messages.
+    std::vector<ecmgscs::CWProvision> msgs;
+    std::vector<const tlv::Message*> addresses;
+    msgs.reserve(requests.size());
+    addresses.reserve(requests.size());
+    for (const auto& req : requests) {
+        msgs.emplace_back(_protocol);
+        buildCWProvision(msgs.back(), req.stream_id, req.cp_number, req.current_cw, req.next_cw, req.ac, req.cp_duration);
+        addresses.push_back(&msgs.back());
+    }
+
+    // Register all asynchronous requests, undo everything if one is invalid.
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (!registerRequest(requests[i].stream_id, requests[i].cp_number, requests[i].handler)) {
+            unregisterRequests(requests, i);
+            return false;
+        }
+    }
+
+    // Send all CW_provision messages at once. Errors are reported on the first stream of the batch.
+    tlv::Logger logger(streamLogger(requests.front().stream_id));
+    const bool ok = _connection.send(addresses.data(), addresses.size(), logger);
+
+    // Clear asynchronous requests on error
+    if (!ok) {
+        unregisterRequests(requests, requests.size());
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Get a copy of the logger of a stream.
+//----------------------------------------------------------------------------
+
+ts::tlv::Logger ts::ECMGClient::streamLogger(uint16_t stream_id)
+{
+    GuardMutex lock(_mutex);
+    const auto it = _streams.find(stream_id);
+    return it != _streams.end() ? it->second.logger : _logger;
+}
+
+
+//----------------------------------------------------------------------------
+// Register and unregister asynchronous requests.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGClient::registerRequest(uint16_t stream_id, uint16_t cp_number, ECMGClientHandlerInterface* ecm_handler)
+{
+    GuardMutex lock(_mutex);
+    if (_streams.find(stream_id) == _streams.end()) {
+        _logger.report().error(u"ECM stream id %d not open on ECMG channel", {stream_id});
+        return false;
+    }
+    _async_requests[RequestKey(stream_id, cp_number)] = ecm_handler;
+    return true;
+}
+
+void ts::ECMGClient::unregisterRequests(const ECMRequestVector& requests, size_t count)
+{
+    GuardMutex lock(_mutex);
+    for (size_t i = 0; i < count && i < requests.size(); ++i) {
+        _async_requests.erase(RequestKey(requests[i].stream_id, requests[i].cp_number));
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Receiver thread main code
 //----------------------------------------------------------------------------
@@ -359,8 +585,6 @@ void ts::ECMGClient::main()
     // Main loop
     for (;;) {
 
-        const AbortInterface* abort = nullptr;
-
         // Wait for a connection to be managed
         {
             // Lock the mutex, get object state
@@ -374,24 +598,69 @@ void ts::ECMGClient::main()
             if (_state == DESTRUCTING) {
                 return;
             }
-            // Get abort handler
-            abort = _abort;
             // Automatically release mutex
         }
 
         // Loop on message reception
         tlv::MessagePtr msg;
         bool ok = true;
-        while (ok && _connection.receive(msg, abort, _logger)) {
+        while (ok) {
+            // Get the abort handler and logger of the channel, they may move from one stream to another.
+            const AbortInterface* abort = nullptr;
+            tlv::Logger logger;
+            {
+                GuardMutex lock(_mutex);
+                abort = _abort;
+                logger = _logger;
+            }
+            if (!_connection.receive(msg, abort, logger)) {
+                break;
+            }
             switch (msg->tag()) {
                 case ecmgscs::Tags::channel_test: {
                     // Automatic reply to channel_test
-                    ok = _connection.send(_channel_status, _logger);
+                    ok = _connection.send(_channel_status, logger);
                     break;
                 }
                 case ecmgscs::Tags::stream_test: {
-                    // Automatic reply to stream_test
-                    ok = _connection.send(_stream_status, _logger);
+                    // Automatic reply to stream_test, using the status of the tested stream.
+                    // The status is copied under the mutex but sent without holding it.
+                    const tlv::StreamMessage* const test = dynamic_cast<const tlv::StreamMessage*>(msg.pointer());
+                    assert(test != nullptr);
+                    ecmgscs::StreamStatus status(_protocol);
+                    {
+                        GuardMutex lock(_mutex);
+                        const auto it = _streams.find(test->stream_id);
+                        status = it != _streams.end() ? it->second.status : _stream_status;
+                    }
+                    ok = _connection.send(status, logger);
+                    break;
+                }
+                case ecmgscs::Tags::stream_error: {
+                    // An error on a stream with pending asynchronous requests is not an answer to
+                    // a synchronous request. All pending requests on this stream fail, the ECMG
+                    // will not return their ECM. Do not block on the response queue.
+                    const ecmgscs::StreamError* const err = dynamic_cast<const ecmgscs::StreamError*>(msg.pointer());
+                    assert(err != nullptr);
+                    AsyncRequests failed;
+                    {
+                        GuardMutex lock(_mutex);
+                        const auto first = _async_requests.lower_bound(RequestKey(err->stream_id, 0));
+                        const auto last = _async_requests.upper_bound(RequestKey(err->stream_id, 0xFFFF));
+                        failed.insert(first, last);
+                        _async_requests.erase(first, last);
+                    }
+                    if (failed.empty()) {
+                        _response_queue.enqueue(msg);
+                    }
+                    else {
+                        streamLogger(err->stream_id).report().error(u"ECMG error on ECM stream %d, %d pending ECM requests failed:\n%s", {err->stream_id, failed.size(), msg->dump(4)});
+                        for (const auto& it : failed) {
+                            if (it.second != nullptr) {
+                                it.second->handleECMError(uint16_t(it.first & 0xFFFF), *err);
+                            }
+                        }
+                    }
                     break;
                 }
                 case ecmgscs::Tags::ECM_response: {
@@ -399,15 +668,21 @@ void ts::ECMGClient::main()
                     ecmgscs::ECMResponse* const resp = dynamic_cast <ecmgscs::ECMResponse*>(msg.pointer());
                     assert(resp != nullptr);
                     ECMGClientHandlerInterface* handler = nullptr;
+                    bool closed = false;
                     {
                         GuardMutex lock(_mutex);
-                        auto it = _async_requests.find(resp->CP_number);
+                        const auto it = _async_requests.find(RequestKey(resp->stream_id, resp->CP_number));
                         if (it != _async_requests.end()) {
                             handler = it->second;
-                            _async_requests.erase(resp->CP_number);
+                            _async_requests.erase(it);
                         }
+                        closed = _streams.find(resp->stream_id) == _streams.end();
+                    }
+                    if (handler == nullptr && closed) {
+                        // Late response on a stream which was closed in the meantime, ignore it.
+                        logger.report().debug(u"ignored ECM response on closed stream %d", {resp->stream_id});
                     }
-                    if (handler == nullptr) {
+                    else if (handler == nullptr) {
                         // Not an asynchronous request -> enqueue response for application thread
                         _response_queue.enqueue(msg);
                     }
@@ -51,6 +51,20 @@ namespace ts {
     //! Restriction: The target ECMG shall support only current or current/next control
     //! words in ECM, meaning CW_per_msg = 1 or 2 and lead_CW = 0 or 1.
     //!
+    //! One ECMG channel can carry many ECM streams. The first stream is opened by connect().
+    //! Additional streams are opened on the same channel using addStream(). ECM requests
+    //! can be submitted asynchronously on all streams. They are pipelined on the connection:
+    //! many CW_provision messages can be sent without waiting for the ECM_response messages
+    //! and the completion of each request is notified to its handler. Several requests can
+    //! be submitted at once using submitECMs(), the corresponding CW_provision messages are
+    //! sent using one single network operation.
+    //!
+    //! All public methods are thread-safe. An ECMGClient instance can be shared by several
+    //! threads, each of them using its own ECM stream on the same channel. Each stream has its
+    //! own abort interface and logger, which are used for the requests on that stream. The abort
+    //! interface and logger of the channel are those of one of the open streams. When that stream
+    //! is closed, they are transferred to another open stream.
+    //!
     //! @see DVB standard ETSI TS 103.197 V1.4.1 for ECMG <=> SCS protocol.
     //! @ingroup mpeg
     //!
@@ -130,6 +144,111 @@ namespace ts {
                        uint16_t cp_duration,
                        ECMGClientHandlerInterface* handler);
 
+        //!
+        //! Description of an asynchronous ECM request, for batch submission.
+        //!
+        struct TSDUCKDLL ECMRequest
+        {
+            uint16_t                    stream_id {0};       //!< ECM stream id, must be open on the channel.
+            uint16_t                    cp_number {0};       //!< Current crypto-period number.
+            ByteBlock                   current_cw {};       //!< Control word for current crypto-period.
+            ByteBlock                   next_cw {};          //!< Control word for next crypto-period, can be empty.
+            ByteBlock                   ac {};               //!< Access criteria, can be empty.
+            uint16_t                    cp_duration {0};     //!< Crypto-period in 100 ms units, unspecified if zero.
+            ECMGClientHandlerInterface* handler {nullptr};   //!< Object which will be notified of the returned ECM.
+        };
+
+        //!
+        //! Vector of asynchronous ECM requests.
+        //!
+        typedef std::vector<ECMRequest> ECMRequestVector;
+
+        //!
+        //! Open an additional ECM stream on the channel.
+        //! The client must be already connected using connect().
+        //! @param [in] stream_id ECM stream id, must be unique in the channel.
+        //! @param [in] ecm_id ECM id, must be unique in the ECMG.
+        //! @param [in] nominal_cp_duration Nominal crypto-period in 100 ms units.
+        //! @param [out] stream_status Response to stream_setup.
+        //! @param [in] abort An interface to check if the user of the stream is interrupted.
+        //! @param [in] logger Where to report errors and messages about this stream.
+        //! @return True on success, false on error.
+        //!
+        bool addStream(uint16_t stream_id,
+                       uint16_t ecm_id,
+                       uint16_t nominal_cp_duration,
+                       ecmgscs::StreamStatus& stream_status,
+                       const AbortInterface* abort,
+                       const tlv::Logger& logger);
+
+        //!
+        //! Close an ECM stream on the channel.
+        //! Pending asynchronous requests on this stream are dropped.
+        //! If the abort interface and logger of the channel are those of this stream,
+        //! they are transferred to another open stream.
+        //! @param [in] stream_id ECM stream id.
+        //! @return True on success, false on error.
+        //!
+        bool removeStream(uint16_t stream_id);
+
+        //!
+        //! Synchronously generate an ECM on a given stream.
+        //! @param [in] stream_id ECM stream id, must be open on the channel.
+        //! @param [in] cp_number Current crypto-period number.
+        //! @param [in] current_cw Control word for current crypto-period.
+        //! @param [in] next_cw Control word for next crypto-period.
+        //! If empty, the ECMG must work with CW_per_msg = 1.
+        //! @param [in] ac Access criteria, can be empty.
+        //! @param [in] cp_duration Crypto-period in 100 ms units, unspecified if zero.
+        //! @param [out] response Returned ECM.
+        //! @return True on success, false on error.
+        //!
+        bool generateECM(uint16_t stream_id,
+                         uint16_t cp_number,
+                         const ByteBlock& current_cw,
+                         const ByteBlock& next_cw,
+                         const ByteBlock& ac,
+                         uint16_t cp_duration,
+                         ecmgscs::ECMResponse& response);
+
+        //!
+        //! Asynchronously generate an ECM on a given stream.
+        //! Submit the ECM request and return immediately.
+        //! The notification of the ECM generation or error is performed through the specified handler.
+        //! @param [in] stream_id ECM stream id, must be open on the channel.
+        //! @param [in] cp_number Current crypto-period number.
+        //! @param [in] current_cw Control word for current crypto-period.
+        //! @param [in] next_cw Control word for next crypto-period.
+        //! If empty, the ECMG must work with CW_per_msg = 1.
+        //! @param [in] ac Access criteria, can be empty.
+        //! @param [in] cp_duration Crypto-period in 100 ms units, unspecified if zero.
+        //! @param [in] handler Object which will be notified of the returned ECM.
+        //! @return True on success, false on error.
+        //!
+        bool submitECM(uint16_t stream_id,
+                       uint16_t cp_number,
+                       const ByteBlock& current_cw,
+                       const ByteBlock& next_cw,
+                       const ByteBlock& ac,
+                       uint16_t cp_duration,
+                       ECMGClientHandlerInterface* handler);
+
+        //!
+        //! Asynchronously generate a batch of ECM's.
+        //! Submit all ECM requests and return immediately. The CW_provision messages are
+        //! sent using one single network operation. The notification of each ECM generation
+        //! or error is performed through the handler of the corresponding request.
+        //! @param [in] requests List of ECM requests. They can use different streams.
+        //! @return True on success, false on error.
+        //!
+        bool submitECMs(const ECMRequestVector& requests);
+
+        //!
+        //! Get the response to the initial channel_setup.
+        //! @return A constant reference to the channel status of the connection.
+        //!
+        const ecmgscs::ChannelStatus& channelStatus() const { return _channel_status; }
+
         //!
         //! Disconnect from remote ECMG.
         //! Close stream and channel.
@@ -163,24 +282,43 @@ namespace ts {
         // Timeout for responses from ECMG (except ECM generation)
         static const MilliSecond RESPONSE_TIMEOUT = 5000;
 
-        // List of asynchronous ECM requests: key=cp_number, value=handler
-        typedef std::map <uint16_t, ECMGClientHandlerInterface*> AsyncRequests;
+        // List of asynchronous ECM requests: key=stream_id/cp_number, value=handler
+        typedef std::map <uint32_t, ECMGClientHandlerInterface*> AsyncRequests;
+
+        // Key of an asynchronous ECM request.
+        static uint32_t RequestKey(uint16_t stream_id, uint16_t cp_number) { return (uint32_t(stream_id) << 16) | cp_number; }
+
+        // Context of an open ECM stream.
+        class StreamContext
+        {
+        public:
+            StreamContext(const ecmgscs::StreamStatus& st, const AbortInterface* ab, const tlv::Logger& log) : status(st), abort(ab), logger(log) {}
+            StreamContext(const StreamContext&) = default;
+            StreamContext& operator=(const StreamContext&) = default;
+            ecmgscs::StreamStatus status;  // Response to stream_setup.
+            const AbortInterface* abort;   // Abort interface of the user of the stream.
+            tlv::Logger           logger;  // Logger of the user of the stream.
+        };
 
         // Private members
         const ecmgscs::Protocol& _protocol;
         State                    _state = INITIAL;
-        const AbortInterface*    _abort = nullptr;
-        tlv::Logger              _logger {};
+        const AbortInterface*    _abort = nullptr;  // abort interface of the channel, from stream _owner
+        tlv::Logger              _logger {};        // logger of the channel, from stream _owner
+        uint16_t                 _owner = 0;        // stream id providing the abort interface and logger of the channel
         tlv::Connection <Mutex>  _connection {_protocol, true, 3}; // connection with ECMG server
         ecmgscs::ChannelStatus   _channel_status {_protocol};      // initial response to channel_setup
         ecmgscs::StreamStatus    _stream_status {_protocol};       // initial response to stream_setup
         Mutex                    _mutex {};          // exclusive access to protected fields
+        Mutex                    _sync_mutex {};     // serialize synchronous request/response exchanges
         Condition                _work_to_do {};     // notify receiver thread to do some work
         AsyncRequests            _async_requests {};
+        std::map<uint16_t, StreamContext> _streams {};  // all open streams, by stream id
         MessageQueue <tlv::Message, NullMutex> _response_queue {RESPONSE_QUEUE_SIZE};
 
         // Build a CW_provision message.
         void buildCWProvision(ecmgscs::CWProvision& msg,
+                              uint16_t stream_id,
                               uint16_t cp_number,
                               const ByteBlock& current_cw,
                               const ByteBlock& next_cw,
@@ -192,5 +330,14 @@ namespace ts {
 
         // Report specified error message if not empty, abort connection and return false
         bool abortConnection(const UString& = UString());
+
+        // Get a copy of the logger of a stream, the logger of the channel if the stream is not open.
+        tlv::Logger streamLogger(uint16_t stream_id);
+
+        // Register an asynchronous request, return false if the stream is not open.
+        bool registerRequest(uint16_t stream_id, uint16_t cp_number, ECMGClientHandlerInterface* handler);
+
+        // Unregister the first count asynchronous requests of a batch after an error.
+        void unregisterRequests(const ECMRequestVector& requests, size_t count);
     };
 }
@@ -32,3 +32,7 @@
 ts::ECMGClientHandlerInterface::~ECMGClientHandlerInterface()
 {
 }
+
+void ts::ECMGClientHandlerInterface::handleECMError(uint16_t, const ecmgscs::StreamError&)
+{
+}
@@ -51,5 +51,16 @@ namespace ts {
         //! @param [in] response The response from the ECMG.
         //!
         virtual void handleECM(const ecmgscs::ECMResponse& response) = 0;
+
+        //!
+        //! This hook is invoked when an asynchronous ECM request fails.
+        //! This happens when the ECMG returns a stream_error message on the ECM stream of the request.
+        //! All pending asynchronous requests on that stream fail. The ECM of a failed request will
+        //! never be available. It is invoked in the context of an internal thread of the ECMG client
+        //! object. The default implementation does nothing.
+        //! @param [in] cp_number Crypto-period number of the failed request.
+        //! @param [in] error The stream_error message from the ECMG.
+        //!
+        virtual void handleECMError(uint16_t cp_number, const ecmgscs::StreamError& error);
     };
 }
@@ -75,6 +75,29 @@ ts::EMMGClient::~EMMGClient()
         lock.signal();
     }
     waitForTermination();
+
+    // Terminate the sender thread, drop pending messages.
+    _send_queue.clear();
+    stopSender();
+}
+
+ts::EMMGClient::Sender::~Sender()
+{
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Stop the sender thread after sending all queued messages.
+//----------------------------------------------------------------------------
+
+void ts::EMMGClient::stopSender()
+{
+    if (_send_queue_size > 0) {
+        // A null message instructs the sender thread to terminate.
+        _send_queue.forceEnqueue(nullptr);
+        _sender.waitForTermination();
+    }
 }
 
 
@@ -262,6 +285,14 @@ bool ts::EMMGClient::connect(const IPv4SocketAddress& mux,
         _state = CONNECTED;
     }
 
+    // Start the sender thread if data_provision messages are queued.
+    if (_send_queue_size > 0) {
+        _send_error = false;
+        _send_queue.clear();
+        _send_queue.setMaxMessages(_send_queue_size);
+        _sender.start();
+    }
+
     return true;
 }
 
@@ -272,6 +303,9 @@ bool ts::EMMGClient::connect(const IPv4SocketAddress& mux,
 
 bool ts::EMMGClient::disconnect()
 {
+    // Send all queued data_provision messages before closing the stream.
+    stopSender();
+
     // Mark disconnection in progress
     State previous_state;
     {
@@ -396,8 +430,32 @@ bool ts::EMMGClient::dataProvision(const void* data, size_t size)
 
 bool ts::EMMGClient::dataProvision(const std::vector<ByteBlockPtr>& data)
 {
-    // Build a data provision message.
-    emmgmux::DataProvision request(_protocol);
+    if (_send_queue_size == 0) {
+        // Directly send the message.
+        emmgmux::DataProvision request(_protocol);
+        buildDataProvision(request, data);
+        return sendDataProvision(request);
+    }
+    else if (_send_error || !isConnected()) {
+        // The sender thread already failed or was not started.
+        _logger.report().error(u"MUX is disconnected");
+        return false;
+    }
+    else {
+        // Enqueue the message, wait for some space in the queue if necessary.
+        emmgmux::DataProvision* request = new emmgmux::DataProvision(_protocol);
+        buildDataProvision(*request, data);
+        return _send_queue.enqueue(request);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build a data_provision message.
+//----------------------------------------------------------------------------
+
+void ts::EMMGClient::buildDataProvision(emmgmux::DataProvision& request, const std::vector<ByteBlockPtr>& data)
+{
     request.channel_id = _stream_status.channel_id;
     request.stream_id = _stream_status.stream_id;
     request.client_id = _stream_status.client_id;
@@ -414,8 +472,15 @@ bool ts::EMMGClient::dataProvision(const std::vector<ByteBlockPtr>& data)
             ++it;
         }
     }
+}
 
-    // Send the message.
+
+//----------------------------------------------------------------------------
+// Send a data_provision message.
+//----------------------------------------------------------------------------
+
+bool ts::EMMGClient::sendDataProvision(const emmgmux::DataProvision& request)
+{
     if (_udp_address.hasPort()) {
         // Send data_provision messages using UDP.
         // We need to separately check if the TCP connection is still active.
@@ -423,21 +488,40 @@ bool ts::EMMGClient::dataProvision(const std::vector<ByteBlockPtr>& data)
             _logger.report().error(u"MUX is disconnected");
             return false;
         }
-        // Manually serialize the data_provision message.
-        ByteBlockPtr bbp(new ByteBlock);
-        tlv::Serializer serial(bbp);
-        request.serialize(serial);
+        // Manually serialize the data_provision message. The serialization buffer is reused.
+        _udp_buffer->clear();
+        {
+            tlv::Serializer serial(_udp_buffer);
+            request.serialize(serial);
+        }
         _logger.log(request, u"sending UDP message to " + _udp_address.toString());
-        return _udp_socket.send(bbp->data(), bbp->size(), _udp_address, _logger.report());
+        return _udp_socket.send(_udp_buffer->data(), _udp_buffer->size(), _udp_address, _logger.report());
     }
     else {
-        // Send data_provision messages using UDP.
+        // Send data_provision messages using TCP.
         // The data_provision message is automatically serialized by the tlv::Connection object.
         return _connection.send(request, _logger);
     }
 }
 
 
+//----------------------------------------------------------------------------
+// Sender thread main code
+//----------------------------------------------------------------------------
+
+void ts::EMMGClient::Sender::main()
+{
+    // Loop on all queued messages, until a null message is received.
+    DataProvisionQueue::MessagePtr msg;
+    while (_client->_send_queue.dequeue(msg) && !msg.isNull()) {
+        // After an error, the remaining messages are dropped.
+        if (!_client->_send_error && !_client->sendDataProvision(*msg)) {
+            _client->_send_error = true;
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Send data provision in section format.
 //----------------------------------------------------------------------------
@@ -40,6 +40,7 @@
 #include "tstlvConnection.h"
 #include "tsUDPSocket.h"
 #include "tsTablesPtr.h"
+#include "tsMessageQueue.h"
 #include "tsCondition.h"
 #include "tsMutex.h"
 #include "tsThread.h"
@@ -54,6 +55,12 @@ namespace ts {
     //! Restriction: Only the TCP version of the EMMG/PDG <=> MUX protocol
     //! is supported here. The UDP version is currently unsupported.
     //!
+    //! By default, the data_provision messages are sent by the application thread
+    //! which calls dataProvision(). For high bitrates, a send queue can be enabled
+    //! using setSendQueueSize(). In that case, dataProvision() builds the message
+    //! and enqueues it, an internal thread sends the messages. When the queue is full,
+    //! dataProvision() waits for some space, which naturally regulates the application.
+    //!
     //! @see DVB standard ETSI TS 103.197 V1.4.1 for EMMG/PDG <=> MUX protocol.
     //! @ingroup mpeg
     //!
@@ -107,6 +114,15 @@ namespace ts {
                      const AbortInterface* abort,
                      const tlv::Logger& logger);
 
+        //!
+        //! Set the size of the queue of outgoing data_provision messages.
+        //! This must be set before connect(). When zero (the default), dataProvision()
+        //! directly sends the message. When non-zero, dataProvision() enqueues the
+        //! message and returns, an internal thread sends the queued messages.
+        //! @param [in] size Maximum number of queued data_provision messages.
+        //!
+        void setSendQueueSize(size_t size) { _send_queue_size = size; }
+
         //!
         //! Send a bandwidth request.
         //! @param [in] bandwidth Requested bandwidth in kbits/second.
@@ -177,6 +193,7 @@ namespace ts {
 
         //!
         //! Get the total number of data bytes which were sent so far.
+        //! When a send queue is used, this includes the data which are still in the queue.
         //! @return The total number of data bytes which were sent so far.
         //!
         uint64_t totalBytes() const { return _total_bytes; }
@@ -203,6 +220,21 @@ namespace ts {
         // Timeout for responses from MUX.
         static const MilliSecond RESPONSE_TIMEOUT = 5000;
 
+        // Queue of outgoing data_provision messages.
+        typedef MessageQueue<emmgmux::DataProvision, Mutex> DataProvisionQueue;
+
+        // Internal thread which sends the queued data_provision messages.
+        class Sender : public Thread
+        {
+            TS_NOBUILD_NOCOPY(Sender);
+        public:
+            explicit Sender(EMMGClient* client) : Thread(ThreadAttributes().setStackSize(RECEIVER_STACK_SIZE)), _client(client) {}
+            virtual ~Sender() override;
+        private:
+            EMMGClient* const _client;
+            virtual void main() override;
+        };
+
         // Private members
         const DuckContext&       _duck;
         const emmgmux::Protocol& _protocol;
@@ -222,6 +254,11 @@ namespace ts {
         uint16_t                 _allocated_bw {0};   // last allocated bandwidth
         std::vector<uint16_t>    _error_status {};    // last error status
         std::vector<uint16_t>    _error_info {};      // last error information
+        size_t                   _send_queue_size {0};  // max number of queued data_provision messages
+        DataProvisionQueue       _send_queue {};        // outgoing data_provision messages
+        Sender                   _sender {this};        // thread which sends queued data_provision messages
+        std::atomic<bool>        _send_error {false};   // error in the sender thread
+        ByteBlockPtr             _udp_buffer {new ByteBlock}; // serialization buffer for UDP data_provision
 
         // Receiver thread main code
         virtual void main() override;
@@ -232,5 +269,12 @@ namespace ts {
 
         // Report specified error message if not empty, abort connection and return false
         bool abortConnection(const UString& = UString());
+
+        // Build and send a data_provision message.
+        void buildDataProvision(emmgmux::DataProvision& request, const std::vector<ByteBlockPtr>& data);
+        bool sendDataProvision(const emmgmux::DataProvision& request);
+
+        // Stop the sender thread after sending all queued messages.
+        void stopSender();
     };
 }
@@ -91,6 +91,17 @@ namespace ts {
             //!
             bool send(const Message& msg, Logger& logger);
 
+            //!
+            //! Serialize and send several TLV messages at once.
+            //! All messages are serialized in the same buffer and sent using one single
+            //! network operation. This is typically used to pipeline many requests.
+            //! @param [in] msgs Address of an array of pointers to the messages to send.
+            //! @param [in] count Number of messages in @a msgs.
+            //! @param [in,out] logger Where to report errors and messages.
+            //! @return True on success, false on error.
+            //!
+            bool send(const Message* const msgs[], size_t count, Logger& logger);
+
             //!
             //! Receive a TLV message.
             //! Wait for the message, deserialize it and validate it.
@@ -115,6 +126,46 @@ namespace ts {
             //!
             bool receive(MessagePtr& msg, const AbortInterface* abort, Logger& logger);
 
+            //!
+            //! Serialize and send a TLV message on a non-blocking connection.
+            //! The serialized message is appended to an internal output buffer and
+            //! as much data as possible are immediately sent. The rest of the data
+            //! remain in the output buffer until the application calls flushOutput(),
+            //! typically when the socket becomes writable again.
+            //! @param [in] msg The message to send.
+            //! @param [in,out] logger Where to report errors and messages.
+            //! @return True on success, false on error.
+            //!
+            bool sendNonBlocking(const Message& msg, Logger& logger);
+
+            //!
+            //! Send data which remain in the output buffer of a non-blocking connection.
+            //! @param [in,out] report Where to report errors.
+            //! @return True on success, false on error. Success does not mean that
+            //! all data were sent, use hasPendingOutput() to check that.
+            //!
+            bool flushOutput(Report& report);
+
+            //!
+            //! Check if some data remain in the output buffer of a non-blocking connection.
+            //! @return True if some serialized messages are not yet completely sent.
+            //!
+            bool hasPendingOutput() const { return !_output->empty(); }
+
+            //!
+            //! Receive a TLV message on a non-blocking connection.
+            //! The data which are currently available on the socket are read, without waiting.
+            //! Partial messages are kept in an internal input buffer until they are complete.
+            //! Invalid messages are processed as in receive(). Since several messages may be
+            //! received at once, the application shall call this method repeatedly until
+            //! it returns no message.
+            //! @param [out] msg A safe pointer to the received message. This is a null pointer
+            //! when no complete message is currently available.
+            //! @param [in,out] logger Where to report errors and messages.
+            //! @return True on success, false on error or disconnection.
+            //!
+            bool receiveNonBlocking(MessagePtr& msg, Logger& logger);
+
             //!
             //! Get invalid incoming messages processing.
             //! @return True if, when an invalid message is received, the corresponding
@@ -148,12 +199,21 @@ namespace ts {
             virtual void handleConnected(Report&) override;
 
         private:
+            // Process an invalid received message. Return false if the connection must be aborted.
+            bool processInvalidMessage(Logger& logger, bool non_blocking);
+
             const Protocol& _protocol;
             bool            _auto_error_response {false};
             size_t          _max_invalid_msg {0};
             size_t          _invalid_msg_count {0};
             MUTEX           _send_mutex {};
             MUTEX           _receive_mutex {};
+            MessageFactory  _factory;                       // Reused for all received messages.
+            ByteBlockPtr    _send_buffer {new ByteBlock};   // Reused for all sent messages.
+            ByteBlock       _receive_buffer {};             // Reused for all received messages.
+            ByteBlock       _input {};                      // Partial input messages in non-blocking mode.
+            size_t          _input_start {0};               // Start of unprocessed data in _input.
+            ByteBlockPtr    _output {new ByteBlock};        // Pending output data in non-blocking mode.
         };
     }
 }
@@ -169,7 +229,8 @@ ts::tlv::Connection<MUTEX>::Connection(const Protocol& protocol, bool auto_error
     ts::TCPConnection(),
     _protocol(protocol),
     _auto_error_response(auto_error_response),
-    _max_invalid_msg(max_invalid_msg)
+    _max_invalid_msg(max_invalid_msg),
+    _factory(protocol)
 {
 }
 
@@ -200,12 +261,30 @@ bool ts::tlv::Connection<MUTEX>::send(const Message& msg, Logger& logger)
 {
     logger.log(msg, u"sending message to " + peerName());
 
-    ByteBlockPtr bbp(new ByteBlock);
-    Serializer serial(bbp);
-    msg.serialize(serial);
+    // The same serialization buffer is reused for all messages.
+    GuardMutex lock(_send_mutex);
+    _send_buffer->clear();
+    {
+        Serializer serial(_send_buffer);
+        msg.serialize(serial);
+    }
+    return SuperClass::send(_send_buffer->data(), _send_buffer->size(), logger.report());
+}
 
+// Serialize and send several TLV messages at once.
+template <class MUTEX>
+bool ts::tlv::Connection<MUTEX>::send(const Message* const msgs[], size_t count, Logger& logger)
+{
     GuardMutex lock(_send_mutex);
-    return SuperClass::send(bbp->data(), bbp->size(), logger.report());
+    _send_buffer->clear();
+    for (size_t i = 0; i < count; ++i) {
+        if (msgs[i] != nullptr) {
+            logger.log(*msgs[i], u"sending message to " + peerName());
+            Serializer serial(_send_buffer);
+            msgs[i]->serialize(serial);
+        }
+    }
+    return _send_buffer->empty() || SuperClass::send(_send_buffer->data(), _send_buffer->size(), logger.report());
 }
 
 // Receive a TLV message (wait for the message, deserialize it and validate it)
@@ -226,30 +305,26 @@ bool ts::tlv::Connection<MUTEX>::receive(MessagePtr& msg, const AbortInterface*
 
     // Loop until a valid message is received
     for (;;) {
-        ByteBlock bb(header_size);
+        // The same reception buffer and message factory are reused for all messages.
+        GuardMutex lock(_receive_mutex);
 
-        // Receive complete message
-        {
-            GuardMutex lock(_receive_mutex);
-
-            // Read message header
-            if (!SuperClass::receive(bb.data(), header_size, abort, logger.report())) {
-                return false;
-            }
+        // Read message header
+        _receive_buffer.resize(header_size);
+        if (!SuperClass::receive(_receive_buffer.data(), header_size, abort, logger.report())) {
+            return false;
+        }
 
-            // Get message length and read message payload
-            const size_t length = GetUInt16(bb.data() + length_offset);
-            bb.resize(header_size + length);
-            if (!SuperClass::receive(bb.data() + header_size, length, abort, logger.report())) {
-                return false;
-            }
+        // Get message length and read message payload
+        const size_t length = GetUInt16(_receive_buffer.data() + length_offset);
+        _receive_buffer.resize(header_size + length);
+        if (!SuperClass::receive(_receive_buffer.data() + header_size, length, abort, logger.report())) {
+            return false;
         }
 
         // Analyze the message
-        MessageFactory mf(bb.data(), bb.size(), _protocol);
-        if (mf.errorStatus() == tlv::OK) {
+        if (_factory.analyze(_receive_buffer.data(), _receive_buffer.size()) == tlv::OK) {
             _invalid_msg_count = 0;
-            mf.factory(msg);
+            _factory.factory(msg);
             if (!msg.isNull()) {
                 logger.log(*msg, u"received message from " + peerName());
             }
@@ -257,21 +332,122 @@ bool ts::tlv::Connection<MUTEX>::receive(MessagePtr& msg, const AbortInterface*
         }
 
         // Received an invalid message
-        _invalid_msg_count++;
+        if (!processInvalidMessage(logger, false)) {
+            return false;
+        }
+    }
+}
 
-        // Send back an error message if necessary
-        if (_auto_error_response) {
-            MessagePtr resp;
-            mf.buildErrorResponse(resp);
-            if (!send(*resp, logger.report())) {
+// Process an invalid received message.
+template <class MUTEX>
+bool ts::tlv::Connection<MUTEX>::processInvalidMessage(Logger& logger, bool non_blocking)
+{
+    _invalid_msg_count++;
+
+    // Send back an error message if necessary
+    if (_auto_error_response) {
+        MessagePtr resp;
+        _factory.buildErrorResponse(resp);
+        tlv::Logger resp_logger(Severity::Debug, &logger.report());
+        if (!(non_blocking ? sendNonBlocking(*resp, resp_logger) : send(*resp, resp_logger))) {
+            return false;
+        }
+    }
+
+    // If invalid message max has been reached, break the connection
+    if (_max_invalid_msg > 0 && _invalid_msg_count >= _max_invalid_msg) {
+        logger.report().error(u"too many invalid messages from %s, disconnecting", {peerName()});
+        disconnect(logger.report());
+        return false;
+    }
+    return true;
+}
+
+// Serialize and send a TLV message on a non-blocking connection.
+template <class MUTEX>
+bool ts::tlv::Connection<MUTEX>::sendNonBlocking(const Message& msg, Logger& logger)
+{
+    logger.log(msg, u"sending message to " + peerName());
+
+    // Serialize the message directly at the end of the output buffer.
+    GuardMutex lock(_send_mutex);
+    {
+        Serializer serial(_output);
+        msg.serialize(serial);
+    }
+    return flushOutput(logger.report());
+}
+
+// Send data which remain in the output buffer of a non-blocking connection.
+template <class MUTEX>
+bool ts::tlv::Connection<MUTEX>::flushOutput(Report& report)
+{
+    GuardMutex lock(_send_mutex);
+    size_t start = 0;
+    size_t sent = 0;
+    bool ok = true;
+    while (ok && start < _output->size()) {
+        ok = SuperClass::send(_output->data() + start, _output->size() - start, sent, report);
+        if (sent == 0) {
+            // Socket buffer full, retry later.
+            break;
+        }
+        start += sent;
+    }
+    _output->erase(0, start);
+    return ok;
+}
+
+// Receive a TLV message on a non-blocking connection.
+template <class MUTEX>
+bool ts::tlv::Connection<MUTEX>::receiveNonBlocking(MessagePtr& msg, Logger& logger)
+{
+    const bool has_version(_protocol.hasVersion());
+    const size_t header_size(has_version ? 5 : 4);
+    const size_t length_offset(has_version ? 3 : 2);
+    constexpr size_t read_size = 4096;
+
+    msg.clear();
+
+    // Loop until a valid message is received or no more data are available.
+    for (;;) {
+        GuardMutex lock(_receive_mutex);
+        const uint8_t* const data = _input.data() + _input_start;
+        const size_t size = _input.size() - _input_start;
+        const size_t msg_size = size < header_size ? 0 : header_size + GetUInt16(data + length_offset);
+
+        if (msg_size == 0 || size < msg_size) {
+            // No complete message in the input buffer, drop processed messages and read what is available on the socket.
+            _input.erase(0, _input_start);
+            _input_start = 0;
+            size_t got = 0;
+            _input.resize(size + std::max(read_size, msg_size - std::min(msg_size, size)));
+            const bool ok = SuperClass::receive(_input.data() + size, _input.size() - size, got, nullptr, logger.report());
+            _input.resize(size + got);
+            if (!ok) {
                 return false;
             }
+            else if (got == 0) {
+                // No complete message for now.
+                return true;
+            }
+            continue;
+        }
+
+        // Analyze the message in place in the input buffer.
+        const bool valid = _factory.analyze(data, msg_size) == tlv::OK;
+        _input_start += msg_size;
+        if (valid) {
+            _invalid_msg_count = 0;
+            _factory.factory(msg);
+            if (!msg.isNull()) {
+                logger.log(*msg, u"received message from " + peerName());
+            }
+            return true;
         }
 
-        // If invalid message max has been reached, break the connection
-        if (_max_invalid_msg > 0 && _invalid_msg_count >= _max_invalid_msg) {
-            logger.report().error(u"too many invalid messages from %s, disconnecting", {peerName()});
-            disconnect(logger.report());
+        // Received an invalid message
+        if (!processInvalidMessage(logger, true)) {
             return false;
         }
     }
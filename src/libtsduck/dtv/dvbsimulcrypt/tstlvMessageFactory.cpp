@@ -57,6 +57,63 @@ ts::tlv::MessageFactory::MessageFactory(const ByteBlock &bb, const Protocol& pro
     analyzeMessage();
 }
 
+ts::tlv::MessageFactory::MessageFactory(const Protocol& protocol) :
+    _protocol(protocol),
+    _error_status(InvalidMessage)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Analyze a new TLV message in memory, reusing this object.
+//----------------------------------------------------------------------------
+
+ts::tlv::Error ts::tlv::MessageFactory::analyze(const void* addr, size_t size)
+{
+    // Clearing the vector keeps its capacity for the next messages.
+    _msg_base = reinterpret_cast<const uint8_t*>(addr);
+    _msg_length = size;
+    _error_status = OK;
+    _error_info = 0;
+    _error_info_is_offset = false;
+    _protocol_version = 0;
+    _command_tag = 0;
+    _params.clear();
+    analyzeMessage();
+    return _error_status;
+}
+
+
+//----------------------------------------------------------------------------
+// Locate parameters in the sorted vector.
+//----------------------------------------------------------------------------
+
+ts::tlv::MessageFactory::ParameterVector::const_iterator ts::tlv::MessageFactory::lowerBound(TAG tag) const
+{
+    return std::lower_bound(_params.begin(), _params.end(), tag, [](const ParameterVector::value_type& p, TAG t) { return p.first < t; });
+}
+
+ts::tlv::MessageFactory::ParameterVector::const_iterator ts::tlv::MessageFactory::upperBound(TAG tag) const
+{
+    return std::upper_bound(_params.begin(), _params.end(), tag, [](TAG t, const ParameterVector::value_type& p) { return t < p.first; });
+}
+
+ts::tlv::MessageFactory::ParameterVector::const_iterator ts::tlv::MessageFactory::find(TAG tag) const
+{
+    const auto it = lowerBound(tag);
+    return it != _params.end() && it->first == tag ? it : _params.end();
+}
+
+ts::tlv::MessageFactory::ParameterVector::iterator ts::tlv::MessageFactory::insert(TAG tag, const ExtParameter& param)
+{
+    // Messages are usually serialized in increasing tag order, most insertions are at the end.
+    auto it = _params.end();
+    while (it != _params.begin() && (it - 1)->first > tag) {
+        --it;
+    }
+    return _params.insert(it, ParameterVector::value_type(tag, param));
+}
+
 
 //----------------------------------------------------------------------------
 // Message factory
@@ -176,7 +233,7 @@ void ts::tlv::MessageFactory::analyzeMessage()
             // The parameter is a compound TLV, analyze it.
             // Store the parameter value in the multimap for this command.
             // Analyze the compound parameter.
-            auto it = _params.insert(ParameterMultimap::value_type(parm_tag, ExtParameter(tlv_addr, tlv_size, value_addr, value_length, new MessageFactory(tlv_addr, tlv_size, *parm_it->second.compound))));
+            auto it = insert(parm_tag, ExtParameter(tlv_addr, tlv_size, value_addr, value_length, new MessageFactory(tlv_addr, tlv_size, *parm_it->second.compound)));
 
             // Check if the analysis is successful
             if ((_error_status = it->second.compound->_error_status) != OK) {
@@ -198,7 +255,7 @@ void ts::tlv::MessageFactory::analyzeMessage()
         else {
             // The parameter is not a compound TLV and its length is fine.
             // Store the parameter value in the multimap for this command
-            _params.insert(ParameterMultimap::value_type (parm_tag, ExtParameter(tlv_addr, tlv_size, value_addr, value_length)));
+            insert(parm_tag, ExtParameter(tlv_addr, tlv_size, value_addr, value_length));
         }
 
         // Advance to next parameter
@@ -224,10 +281,10 @@ void ts::tlv::MessageFactory::analyzeMessage()
         // Protocol-defined parameter properties:
         const Protocol::Parameter& desc(parm_it.second);
         // Number of actual occurences in current command:
-        size_t count = _params.count(tag);
+        const size_t actual_count = count(tag);
 
-        if (count < desc.min_count || count > desc.max_count) {
-            if (count == 0 && desc.min_count > 0) {
+        if (actual_count < desc.min_count || actual_count > desc.max_count) {
+            if (actual_count == 0 && desc.min_count > 0) {
                 _error_status = MissingParameter;
             }
             else {
@@ -247,7 +304,7 @@ void ts::tlv::MessageFactory::analyzeMessage()
 
 void ts::tlv::MessageFactory::get(TAG tag, Parameter& param) const
 {
-    const auto it = _params.find(tag);
+    const auto it = find(tag);
     if (it == _params.end()) {
         throw DeserializationInternalError(UString::Format(u"No parameter 0x%X in message", {tag}));
     }
@@ -265,11 +322,11 @@ void ts::tlv::MessageFactory::get(TAG tag, std::vector<Parameter>& param) const
 {
     // Reinitialize result vector
     param.clear();
-    param.reserve(_params.count(tag));
+    param.reserve(count(tag));
 
     // Fill vector with parameter values
-    const auto last = _params.upper_bound(tag);
-    for (auto it = _params.lower_bound(tag); it != last; ++it) {
+    const auto last = upperBound(tag);
+    for (auto it = lowerBound(tag); it != last; ++it) {
         param.push_back(it->second);
     }
 }
@@ -283,10 +340,10 @@ void ts::tlv::MessageFactory::get(TAG tag, std::vector<bool>& param) const
 {
     // Reinitialize result vector
     param.clear();
-    param.reserve(_params.count(tag));
+    param.reserve(count(tag));
     // Fill vector with parameter values
-    const auto last = _params.upper_bound(tag);
-    for (auto it = _params.lower_bound(tag); it != last; ++it) {
+    const auto last = upperBound(tag);
+    for (auto it = lowerBound(tag); it != last; ++it) {
         checkParamSize<uint8_t> (tag, it);
         param.push_back(GetUInt8(it->second.addr) != 0);
     }
@@ -301,10 +358,10 @@ void ts::tlv::MessageFactory::get(TAG tag, std::vector<std::string>& param) cons
 {
     // Reinitialize result vector
     param.clear();
-    param.resize(_params.count(tag));
+    param.resize(count(tag));
     // Fill vector with parameter values
-    auto it = _params.lower_bound(tag);
-    const auto last = _params.upper_bound(tag);
+    auto it = lowerBound(tag);
+    const auto last = upperBound(tag);
     for (int i = 0; it != last; ++it, ++i) {
         param[i].assign(static_cast<const char*>(it->second.addr), it->second.length);
     }
@@ -317,7 +374,7 @@ void ts::tlv::MessageFactory::get(TAG tag, std::vector<std::string>& param) cons
 
 void ts::tlv::MessageFactory::getCompound(TAG tag, MessagePtr& param) const
 {
-    const auto it = _params.find(tag);
+    const auto it = find(tag);
     if (it == _params.end()) {
         throw DeserializationInternalError(UString::Format(u"No parameter 0x%X in message", {tag}));
     }
@@ -338,10 +395,10 @@ void ts::tlv::MessageFactory::getCompound(TAG tag, std::vector<MessagePtr>& para
 {
     // Reinitialize result vector
     param.clear();
-    param.resize(_params.count(tag));
+    param.resize(count(tag));
     // Fill vector with parameter values
-    auto it = _params.lower_bound(tag);
-    const auto last = _params.upper_bound(tag);
+    auto it = lowerBound(tag);
+    const auto last = upperBound(tag);
     for (int i = 0; it != last; ++it, ++i) {
         if (it->second.compound.isNull()) {
             throw DeserializationInternalError(UString::Format(u"Occurence %d of parameter 0x%X not a compound TLV", {i, tag}));
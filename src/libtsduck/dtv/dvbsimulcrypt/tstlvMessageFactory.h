@@ -60,6 +60,11 @@ namespace ts {
         //! - factory()
         //! - buildErrorResponse()
         //!
+        //! A MessageFactory is an in-place view of a binary TLV message. The message is not
+        //! copied and the parameters point into the original message buffer. To analyze a
+        //! high rate of messages without memory allocation, create one MessageFactory for
+        //! a protocol and reuse it for each message using analyze().
+        //!
         //! The following types and methods should be used by the
         //! constructors of the ts::tlv::Message subclasses.
         //! - Parameter
@@ -103,6 +108,25 @@ namespace ts {
             //!
             MessageFactory(const ByteBlock &bb, const Protocol& protocol);
 
+            //!
+            //! Constructor: Build a reusable message factory without message.
+            //! Use analyze() to analyze each new message.
+            //! @param [in] protocol The messages are validated according to this protocol.
+            //!
+            explicit MessageFactory(const Protocol& protocol);
+
+            //!
+            //! Analyze a new TLV message in memory, reusing this object.
+            //! The previous message, if any, is forgotten. The internal resources of this
+            //! object are reused, there is no memory allocation after a few messages, except
+            //! for compound TLV parameters. The message buffer is not copied and must remain
+            //! valid as long as the parameters are used.
+            //! @param [in] addr Address of a binary TLV message.
+            //! @param [in] size Size in bytes of the message.
+            //! @return The error status. If not OK, there is no valid message.
+            //!
+            tlv::Error analyze(const void* addr, size_t size);
+
             //!
             //! Get the "error status" resulting from the analysis of the message.
             //! @return The error status. If not OK, there is no valid message.
@@ -193,7 +217,7 @@ namespace ts {
             //! @param [in] tag Parameter tag to search.
             //! @return The actual number of occurences of a parameter.
             //!
-            size_t count(TAG tag) const { return _params.count(tag); }
+            size_t count(TAG tag) const { return size_t(upperBound(tag) - lowerBound(tag)); }
 
             //!
             //! Get the location of a parameter.
@@ -335,8 +359,19 @@ namespace ts {
             TAG             _command_tag = 0;
 
             // Location of actual parameters. Point into the message block.
-            typedef std::multimap <TAG, ExtParameter> ParameterMultimap;
-            ParameterMultimap _params {};
+            // The vector is sorted by tag, occurences of the same tag in message order.
+            // A sorted vector is used instead of a multimap to reuse the storage from one
+            // message to another. Messages contain a few parameters, insertion is cheap.
+            typedef std::vector<std::pair<TAG, ExtParameter>> ParameterVector;
+            ParameterVector _params {};
+
+            // Locate parameters in the sorted vector, same semantics as a multimap.
+            ParameterVector::const_iterator lowerBound(TAG tag) const;
+            ParameterVector::const_iterator upperBound(TAG tag) const;
+            ParameterVector::const_iterator find(TAG tag) const;
+
+            // Insert a parameter in the sorted vector, after existing occurences of the same tag.
+            ParameterVector::iterator insert(TAG tag, const ExtParameter& param);
 
             // Analyze the TLV message, called by constructors.
             void analyzeMessage();
@@ -349,7 +384,7 @@ namespace ts {
             // Should never throw an exception, except bug in the
             // constructor of the Message subclasses.
             template <typename T>
-            void checkParamSize(TAG, const ParameterMultimap::const_iterator&) const;
+            void checkParamSize(TAG, const ParameterVector::const_iterator&) const;
         };
 
         // Template specializations for performance.
@@ -367,7 +402,7 @@ namespace ts {
 
 // Internal method: Check the size of a parameter.
 template <typename T>
-void ts::tlv::MessageFactory::checkParamSize(TAG tag, const ParameterMultimap::const_iterator& it) const
+void ts::tlv::MessageFactory::checkParamSize(TAG tag, const ParameterVector::const_iterator& it) const
 {
     const size_t expected = dataSize<T>();
     if (it->second.length != expected) {
@@ -379,7 +414,7 @@ void ts::tlv::MessageFactory::checkParamSize(TAG tag, const ParameterMultimap::c
 template <typename INT, typename std::enable_if<std::is_integral<INT>::value>::type*>
 INT ts::tlv::MessageFactory::get(TAG tag) const
 {
-    const auto it = _params.find(tag);
+    const auto it = find(tag);
     if (it == _params.end()) {
         throw DeserializationInternalError(UString::Format(u"No parameter 0x%X in message", {tag}));
     }
@@ -395,10 +430,10 @@ void ts::tlv::MessageFactory::get(TAG tag, std::vector<INT>& param) const
 {
     // Reinitialize result vector
     param.clear();
-    param.reserve(_params.count(tag));
+    param.reserve(count(tag));
     // Fill vector with parameter values
-    const auto last = _params.upper_bound (tag);
-    for (auto it = _params.lower_bound(tag); it != last; ++it) {
+    const auto last = upperBound(tag);
+    for (auto it = lowerBound(tag); it != last; ++it) {
         checkParamSize<INT>(tag, it);
         param.push_back(GetInt<INT>(it->second.addr));
     }
@@ -424,8 +459,8 @@ void ts::tlv::MessageFactory::getCompound(TAG tag, std::vector<MSG>& param) cons
     // Reinitialize result vector
     param.clear();
     // Fill vector with parameter values
-    auto it = _params.lower_bound(tag);
-    const auto last = _params.upper_bound(tag);
+    auto it = lowerBound(tag);
+    const auto last = upperBound(tag);
     for (int i = 0; it != last; ++it, ++i) {
         if (it->second.compound.isNull()) {
             throw DeserializationInternalError(UString::Format(u"Occurence %d of parameter 0x%X not a compound TLV", {i, tag}));
@@ -45,6 +45,11 @@ namespace ts {
         //! A DVB message is serialized in TLV into a ByteBlock.
         //! A Serializer is always associated to a ByteBlock.
         //!
+        //! The serialized data are appended to the existing content of the ByteBlock.
+        //! To serialize a high rate of messages without memory allocation, reuse the
+        //! same ByteBlock for all messages and clear it before each message. Clearing
+        //! a ByteBlock keeps its allocated capacity.
+        //!
         class TSDUCKDLL Serializer
         {
         private:
@@ -32,6 +32,7 @@
 #include "tsAlgorithm.h"
 #include "tsCerrReport.h"
 #include "tsNames.h"
+#include "tsGuardMutex.h"
 
 TS_DEFINE_SINGLETON(ts::PSIRepository);
 
@@ -42,12 +43,15 @@ TS_DEFINE_SINGLETON(ts::PSIRepository);
 
 ts::PSIRepository::PSIRepository() :
     _tables(),
+    _standardDescriptors(),
     _descriptors(),
     _tableNames(),
     _descriptorNames(),
     _descriptorTablesIds(),
     _casIdDescriptorDisplays(),
-    _xmlModelFiles()
+    _xmlModelFiles(),
+    _tsTagsMutex(),
+    _tsTags()
 {
 }
 
@@ -121,29 +125,29 @@ FUNCTION ts::PSIRepository::getTableFunction(TID tid, Standards standards, PID p
     FUNCTION fallbackFunc = nullptr;
     size_t fallbackCount = 0;
 
-    // Look for an exact match.
-    for (auto it = _tables.lower_bound(tid); it != _tables.end() && it->first == tid; ++it) {
+    // Look for an exact match. The list of descriptions is directly indexed by table id.
+    for (const auto& desc : _tables[tid]) {
         // Ignore entries for which the searched function is not present.
-        if (it->second.*member != nullptr) {
+        if (desc.*member != nullptr) {
 
             // If the table in a standard PID, this is an exact match.
-            if (it->second.hasPID(pid)) {
-                return it->second.*member;
+            if (desc.hasPID(pid)) {
+                return desc.*member;
             }
 
             // CAS match: either a CAS is specified and is in range, or no CAS specified and CAS-agnostic table (all CASID_NULL).
-            const bool casMatch = cas >= it->second.minCAS && cas <= it->second.maxCAS;
+            const bool casMatch = cas >= desc.minCAS && cas <= desc.maxCAS;
 
             // Standard match: at least one standard of the table is current, or standard-agnostic table (Standards::NONE).
-            const bool stdMatch = bool(standards & it->second.standards) || it->second.standards == Standards::NONE;
+            const bool stdMatch = bool(standards & desc.standards) || desc.standards == Standards::NONE;
 
             if (stdMatch && casMatch) {
                 // Found an exact match, no need to search further.
-                return it->second.*member;
+                return desc.*member;
             }
-            else if (it->second.minCAS == CASID_NULL) {
+            else if (desc.minCAS == CASID_NULL) {
                 // Not the right standard but a CAS-agnostic table, use as potential fallback.
-                fallbackFunc = it->second.*member;
+                fallbackFunc = desc.*member;
                 fallbackCount++;
             }
         }
@@ -161,22 +165,49 @@ FUNCTION ts::PSIRepository::getTableFunction(TID tid, Standards standards, PID p
 template <typename FUNCTION, typename std::enable_if<std::is_pointer<FUNCTION>::value>::type*>
 FUNCTION ts::PSIRepository::getDescriptorFunction(const EDID& edid, TID tid, FUNCTION DescriptorDescription::* member) const
 {
-    auto it(_descriptors.end());
-
-    if (edid.isStandard() && tid != TID_NULL) {
-        // For standard descriptors, first search a table-specific descriptor.
-        it = _descriptors.find(EDID::TableSpecific(edid.did(), tid));
-        // If not found and there is a table-specific name for the descriptor,
-        // do not fallback to non-table-specific function for this descriptor.
-        if (it == _descriptors.end() && (edid.isTableSpecific() || names::HasTableSpecificName(edid.did(), tid))) {
-            return nullptr;
+    if (edid.isStandard()) {
+        if (tid != TID_NULL && isTableSpecificDescriptor(edid.did(), tid)) {
+            // For standard descriptors, search a table-specific descriptor first. If not found,
+            // do not fallback to non-table-specific function for this descriptor.
+            const auto it = _descriptors.find(EDID::TableSpecific(edid.did(), tid));
+            return it != _descriptors.end() ? it->second.*member : nullptr;
+        }
+        else {
+            // Standard descriptors are directly indexed by tag, without map lookup.
+            return _standardDescriptors[edid.did()].*member;
         }
     }
-    if (it == _descriptors.end()) {
-        // If non-standard or no table-specific descriptor found, use direct lookup.
-        it = _descriptors.find(edid);
+    else {
+        // Private, extension or table-specific descriptor, use map lookup.
+        const auto it = _descriptors.find(edid);
+        return it != _descriptors.end() ? it->second.*member : nullptr;
     }
-    return it != _descriptors.end() ? it->second.*member : nullptr;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a descriptor tag has a table-specific meaning in a given table.
+//----------------------------------------------------------------------------
+
+bool ts::PSIRepository::isTableSpecificDescriptor(DID did, TID tid) const
+{
+    if (tid == TID_NULL || did >= 0x80) {
+        return false;
+    }
+
+    TableSpecificTags& tags(_tsTags[tid]);
+    if (!tags.valid.load(std::memory_order_acquire)) {
+        // First lookup for this table id, build the set of table-specific tags.
+        // This requires 128 lookups in the names file but only once per table id.
+        GuardMutex lock(_tsTagsMutex);
+        if (!tags.valid.load(std::memory_order_relaxed)) {
+            for (size_t tag = 0; tag < tags.tags.size(); ++tag) {
+                tags.tags.set(tag, names::HasTableSpecificName(uint8_t(tag), tid) || _descriptors.find(EDID::TableSpecific(DID(tag), tid)) != _descriptors.end());
+            }
+            tags.valid.store(true, std::memory_order_release);
+        }
+    }
+    return tags.tags.test(did);
 }
 
 
@@ -226,7 +257,7 @@ ts::PSIRepository::RegisterTable::RegisterTable(TableFactory factory,
     // Store a copy of the table description for each table id.
     // This is a multimap, distinct definitions for the same table id accumulate.
     for (auto it : tids) {
-        PSIRepository::Instance()->_tables.insert(std::make_pair(it, desc));
+        repo->_tables[it].push_back(desc);
     }
 }
 
@@ -254,7 +285,20 @@ ts::PSIRepository::RegisterDescriptor::RegisterDescriptor(DescriptorFactory fact
                                                           const UString& xmlNameLegacy)
 {
     registerXML(factory, edid, xmlName, xmlNameLegacy);
-    PSIRepository::Instance()->_descriptors.insert(std::make_pair(edid, DescriptorDescription(factory, displayFunction)));
+    PSIRepository* const repo = PSIRepository::Instance();
+    const DescriptorDescription desc(factory, displayFunction);
+
+    // The first registration wins, as in the map of all descriptors.
+    if (repo->_descriptors.insert(std::make_pair(edid, desc)).second && edid.isStandard()) {
+        repo->_standardDescriptors[edid.did()] = desc;
+    }
+
+    // A table-specific descriptor may be registered late, by a plugin shared library.
+    // Make sure it is known in the cache of table-specific tags if already computed.
+    if (edid.isTableSpecific() && edid.did() < 0x80) {
+        GuardMutex lock(repo->_tsTagsMutex);
+        repo->_tsTags[edid.tableId()].tags.set(edid.did());
+    }
 }
 
 void ts::PSIRepository::RegisterDescriptor::registerXML(DescriptorFactory factory, const EDID& edid, const UString& xmlName, const UString& xmlNameLegacy)
@@ -342,18 +386,18 @@ ts::Standards ts::PSIRepository::getTableStandards(TID tid, PID pid) const
 {
     // Accumulate the common subset of all standards for this table id.
     Standards standards = Standards::NONE;
-    for (auto it = _tables.lower_bound(tid); it != _tables.end() && it->first == tid; ++it) {
-        if (it->second.hasPID(pid)) {
+    for (const auto& desc : _tables[tid]) {
+        if (desc.hasPID(pid)) {
             // We are in a standard PID for this table id, return the corresponding standards only.
-            return it->second.standards;
+            return desc.standards;
         }
         else if (standards == Standards::NONE) {
             // No standard found yet, use all standards from first definition.
-            standards = it->second.standards;
+            standards = desc.standards;
         }
         else {
             // Some standards were already found, keep only the common subset.
-            standards &= it->second.standards;
+            standards &= desc.standards;
         }
     }
     return standards;
@@ -413,12 +457,9 @@ ts::UString ts::PSIRepository::descriptorTables(const DuckContext& duck, const U
 void ts::PSIRepository::getRegisteredTableIds(std::vector<TID>& ids) const
 {
     ids.clear();
-    TID previous = TID_NULL;
-    for (const auto& it : _tables) {
-        // This is a multimap, the same key can be reused, use it once only.
-        if (it.first != previous) {
-            ids.push_back(it.first);
-            previous = it.first;
+    for (size_t tid = 0; tid < _tables.size(); ++tid) {
+        if (!_tables[tid].empty()) {
+            ids.push_back(TID(tid));
         }
     }
 }
@@ -39,6 +39,7 @@
 #include "tsTablesPtr.h"
 #include "tsSingletonManager.h"
 #include "tsVersionInfo.h"
+#include "tsMutex.h"
 
 namespace ts {
 
@@ -54,7 +55,13 @@ namespace ts {
     //! Multi-threading considerations: The singleton is built and modified using static
     //! registration instances during the initialization of the application (ie. in one
     //! single thread). Then, the singleton is only read during the execution of the
-    //! application. So, no explicit synchronization is required.
+    //! application. So, no explicit synchronization is required. The only exception is
+    //! the internal cache of table-specific descriptor tags which is lazily built and
+    //! internally synchronized.
+    //!
+    //! Performance considerations: Tables and standard descriptors are indexed in dense
+    //! arrays, directly addressed by table id or descriptor tag. Maps are used only for
+    //! private, extension and table-specific descriptors, and for XML names.
     //!
     //! @ingroup mpeg
     //!
@@ -108,6 +115,17 @@ namespace ts {
         //!
         DescriptorFactory getDescriptorFactory(const EDID& edid, TID tid = TID_NULL) const;
 
+        //!
+        //! Check if a descriptor tag has a table-specific meaning in a given table.
+        //! This is equivalent to names::HasTableSpecificName() but the result is cached
+        //! after the first lookup of a given table id. This function is called for each
+        //! descriptor in each deserialized or displayed table and must remain fast.
+        //! @param [in] did Descriptor tag.
+        //! @param [in] tid Table id of the table containing the descriptor.
+        //! @return True if @a did is a table-specific descriptor in table @a tid.
+        //!
+        bool isTableSpecificDescriptor(DID did, TID tid) const;
+
         //!
         //! Get the table factory for a given XML node name.
         //! @param [in] nodeName Name of XML node.
@@ -364,14 +382,33 @@ namespace ts {
             DescriptorDescription(DescriptorFactory fact = nullptr, DisplayDescriptorFunction disp = nullptr);
         };
 
+        // Possible multiple descriptions of one table id, in order of registration.
+        typedef std::vector<TableDescription> TableDescriptionList;
+
+        // Lazily computed set of table-specific descriptor tags for one table id.
+        // Only tags in the MPEG-defined range 0x00-0x7F can be table-specific.
+        class TableSpecificTags
+        {
+        public:
+            std::atomic<bool> valid;  // The set of tags is computed.
+            std::bitset<128>  tags;   // Table-specific descriptor tags.
+
+            // Constructor.
+            TableSpecificTags() : valid(false), tags() {}
+        };
+
         // PSIRepository instance private members.
-        std::multimap<TID, TableDescription>            _tables;                   // Description of all table ids, potential multiple entries per table idx
+        // The descriptions of table ids and standard descriptors are dense arrays, directly indexed by TID or DID.
+        std::array<TableDescriptionList, 256>           _tables;                   // Description of all table ids, potential multiple entries per table id.
+        std::array<DescriptorDescription, 256>          _standardDescriptors;      // Description of standard descriptors, by descriptor tag.
         std::map<EDID, DescriptorDescription>           _descriptors;              // Description of all descriptors, by extended id.
         std::map<UString, TableFactory>                 _tableNames;               // XML table name to table factory
         std::map<UString, DescriptorFactory>            _descriptorNames;          // XML descriptor name to descriptor factory
         std::multimap<UString, TID>                     _descriptorTablesIds;      // XML descriptor name to table id for table-specific descriptors
         std::map<uint16_t, DisplayCADescriptorFunction> _casIdDescriptorDisplays;  // CA_system_id to display function for CA_descriptor.
         UStringList                                     _xmlModelFiles;            // Additional XML model files for tables.
+        mutable Mutex                                   _tsTagsMutex;              // Protect the computation of _tsTags.
+        mutable std::array<TableSpecificTags, 256>      _tsTags;                   // Cache of table-specific descriptor tags, by table id.
 
         // Common code to lookup a table function.
         template <typename FUNCTION, typename std::enable_if<std::is_pointer<FUNCTION>::value>::type* = nullptr>
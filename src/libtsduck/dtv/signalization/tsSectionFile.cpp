@@ -36,6 +36,8 @@
 #include "tsDuckContext.h"
 #include "tsxmlElement.h"
 #include "tsxmlJSONConverter.h"
+#include "tsxmlRunningReader.h"
+#include "tsxmlRunningDocument.h"
 #include "tsjsonNull.h"
 #include "tsFileUtils.h"
 #include "tsEIT.h"
@@ -407,6 +409,123 @@ bool ts::SectionFile::saveBinary(std::ostream& strm, Report& report) const
 }
 
 
+//----------------------------------------------------------------------------
+// Compile an XML file into a binary section file on the fly.
+//----------------------------------------------------------------------------
+
+bool ts::SectionFile::compileXML(const UString& xml_file, const UString& binary_file)
+{
+    // Load the XML model for TSDuck files, if not already done.
+    if (!loadThisModel()) {
+        return false;
+    }
+
+    // Open the XML input file.
+    xml::RunningReader doc(_report);
+    doc.setTweaks(_xmlTweaks);
+    if (!doc.open(xml_file)) {
+        return false;
+    }
+
+    // Create the binary output file.
+    std::ofstream file;
+    std::ostream* strm = &std::cout;
+    if (!binary_file.empty() && binary_file != u"-") {
+        file.open(binary_file.toUTF8().c_str(), std::ios::out | std::ios::binary);
+        if (!file.is_open()) {
+            _report.error(u"error creating %s", {binary_file});
+            return false;
+        }
+        strm = &file;
+    }
+
+    // Read, convert and write tables one by one. The document contains one table at a time.
+    bool success = true;
+    for (const xml::Element* node = doc.readElement(); node != nullptr && strm->good(); node = doc.readElement()) {
+        BinaryTable bin;
+        if (!_model.validate(doc)) {
+            success = false;
+        }
+        else if (bin.fromXML(_duck, node) && bin.isValid()) {
+            _duck.addStandards(bin.definingStandards());
+            for (size_t i = 0; i < bin.sectionCount(); ++i) {
+                bin.sectionAt(i)->write(*strm, _report);
+            }
+        }
+        else {
+            doc.report().error(u"Error in table <%s> at line %d", {node->name(), node->lineNumber()});
+            success = false;
+        }
+    }
+    success = success && doc.eof() && strm->good();
+    if (file.is_open()) {
+        file.close();
+    }
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Decompile a binary section file into an XML file on the fly.
+//----------------------------------------------------------------------------
+
+bool ts::SectionFile::decompileBinary(const UString& binary_file, const UString& xml_file)
+{
+    // Open the binary input file.
+    std::ifstream file;
+    std::istream* strm = &std::cin;
+    if (!binary_file.empty() && binary_file != u"-") {
+        file.open(binary_file.toUTF8().c_str(), std::ios::in | std::ios::binary);
+        if (!file.is_open()) {
+            _report.error(u"cannot open %s", {binary_file});
+            return false;
+        }
+        strm = &file;
+    }
+
+    // Create the XML output file.
+    xml::RunningDocument doc(_report);
+    doc.setTweaks(_xmlTweaks);
+    xml::Element* root = doc.open(u"tsduck", UString(), xml_file);
+    if (root == nullptr) {
+        return false;
+    }
+
+    // A temporary section file collects sections until tables are complete.
+    SectionFile temp(_duck);
+    temp.setCRCValidation(_crc_op);
+    size_t table_count = 0;
+
+    // Read all binary sections one by one and output tables as soon as they are complete.
+    ReportWithPrefix report(_report, binary_file + u": ");
+    for (;;) {
+        SectionPtr sp(new Section);
+        if (!sp->read(*strm, _crc_op, report)) {
+            break;
+        }
+        temp.add(sp);
+        if (!temp._tables.empty()) {
+            for (const auto& table : temp._tables) {
+                table->toXML(_duck, root);
+            }
+            table_count += temp._tables.size();
+            temp._tables.clear();
+            temp._sections.clear();
+            doc.flush();
+        }
+    }
+
+    // Issue a warning if incomplete tables were not saved.
+    if (!temp._orphanSections.empty()) {
+        _report.warning(u"%d orphan sections not saved in XML document (%d tables saved)", {temp._orphanSections.size(), table_count});
+    }
+
+    doc.flush();
+    doc.close();
+    return strm->eof();
+}
+
+
 //----------------------------------------------------------------------------
 // Load a binary section file from a memory buffer.
 //----------------------------------------------------------------------------
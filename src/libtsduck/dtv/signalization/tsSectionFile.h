@@ -316,6 +316,28 @@ namespace ts {
         //!
         bool saveBinary(const UString& file_name) const;
 
+        //!
+        //! Compile an XML file into a binary section file on the fly.
+        //! The tables are read, converted and written one by one. The memory usage remains
+        //! constant, regardless of the size of the XML file. The content of this object is unchanged.
+        //! @param [in] xml_file XML file name. If the file name is empty or "-", the standard input is used.
+        //! If the file name starts with "<?xml", this is considered as "inline XML content".
+        //! @param [in] binary_file Binary file name. If the file name is empty or "-", the standard output is used.
+        //! @return True on success, false on error.
+        //!
+        bool compileXML(const UString& xml_file, const UString& binary_file);
+
+        //!
+        //! Decompile a binary section file into an XML file on the fly.
+        //! The sections are read one by one and each table is written as soon as it is complete.
+        //! The memory usage remains constant, regardless of the size of the binary file.
+        //! The content of this object is unchanged.
+        //! @param [in] binary_file Binary file name. If the file name is empty or "-", the standard input is used.
+        //! @param [in] xml_file XML file name. If the file name is empty or "-", the standard output is used.
+        //! @return True on success, false on error.
+        //!
+        bool decompileBinary(const UString& binary_file, const UString& xml_file);
+
         //!
         //! Load a binary section file from a memory buffer.
         //! The loaded sections are added to the content of this object.
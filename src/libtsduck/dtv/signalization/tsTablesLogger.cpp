@@ -56,6 +56,7 @@ ts::TablesLogger::TablesLogger(TablesDisplay& display) :
     _report(_duck.report()),
     _demux(_duck),
     _cas_mapper(_duck),
+    _shard_demux(_duck),
     _xml_doc(_report),
     _x2j_conv(_report),
     _json_doc(_report),
@@ -387,6 +388,8 @@ bool ts::TablesLogger::open()
     _table_count = 0;
     _packet_count = 0;
     _demux.reset();
+    _shard_demux.reset();
+    _shard_errors.reset();
     _cas_mapper.reset();
     _xml_doc.clear();
     _json_doc.close();
@@ -394,6 +397,7 @@ bool ts::TablesLogger::open()
     _last_sections.clear();
     _deep_hashes.clear();
     _sections_once.clear();
+    _fragments.clear();
 
     if (_bin_file.is_open()) {
         _bin_file.close();
@@ -403,15 +407,24 @@ bool ts::TablesLogger::open()
     }
 
     // Set PID's to filter.
-    _demux.setPIDFilter(_initial_pids);
+    _demux.setPIDFilter(_initial_pids & _shard_pids);
+
+    // In a sharded logger, the PAT is always demuxed to track PMT PID's, even when not in the shard.
+    _shard_demux.setPIDFilter(NoPID);
+    if (_sharded && _initial_pids.test(PID_PAT) && !_shard_pids.test(PID_PAT)) {
+        _shard_demux.addPID(PID_PAT);
+    }
 
     // Set either a table or section handler, depending on --all-sections
     _demux.setTableHandler(_all_sections ? nullptr : this);
     _demux.setSectionHandler(_all_sections ? this : nullptr);
     _demux.setInvalidSectionHandler(_invalid_sections ? this : nullptr);
+    _shard_demux.setTableHandler(_all_sections ? nullptr : this);
+    _shard_demux.setSectionHandler(_all_sections ? this : nullptr);
 
     // Type of sections to get.
     _demux.setCurrentNext(_use_current, _use_next);
+    _shard_demux.setCurrentNext(_use_current, _use_next);
     _cas_mapper.setCurrentNext(_use_current, _use_next);
 
     // Track invalid section versions.
@@ -421,6 +434,13 @@ bool ts::TablesLogger::open()
     // Log TS error at verbose level.
     _demux.setTransportErrorLogLevel(Severity::Verbose);
 
+    // A sharded logger formats the text output in memory, all outputs are produced by the main logger.
+    if (_sharded) {
+        _shard_text.str(std::string());
+        _duck.setOutput(&_shard_text);
+        return true;
+    }
+
     // Load the XML model for tables if we need to convert to JSON.
     if ((_use_json || _log_json_line) && !SectionFile::LoadModel(_x2j_conv)) {
         return false;
@@ -489,10 +509,13 @@ void ts::TablesLogger::close()
     if (!_exit) {
 
         // Pack sections in incomplete tables if required.
+        // The packet counter is incremented to order the output fragments of sharded loggers.
         if (_pack_and_flush) {
+            _packet_count++;
             _demux.packAndFlushSections();
         }
         if (_fill_eit) {
+            _packet_count++;
             _demux.fillAndFlushEITs();
         }
 
@@ -520,12 +543,126 @@ void ts::TablesLogger::feedPacket(const TSPacket& pkt)
 {
     if (!completed()) {
         _demux.feedPacket(pkt);
+        if (_sharded) {
+            _shard_demux.feedPacket(pkt);
+        }
         _cas_mapper.feedPacket(pkt);
         _packet_count++;
     }
 }
 
 
+//----------------------------------------------------------------------------
+// Restrict the logger to a shard of the PID's.
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::setShard(size_t index, size_t count)
+{
+    _sharded = count > 1;
+    _shard_pids.reset();
+    for (PID pid = 0; pid < PID_MAX; ++pid) {
+        _shard_pids.set(pid, !_sharded || pid % count == index);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the output fragments from a sharded logger.
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::getFragments(FragmentList& fragments)
+{
+    fragments.splice(fragments.end(), _fragments);
+}
+
+void ts::TablesLogger::addFragment(PID pid, const BinaryTable* table, const Section* section)
+{
+    _fragments.emplace_back();
+    Fragment& frag(_fragments.back());
+    frag.position = _packet_count;
+    frag.pid = pid;
+    if (table != nullptr) {
+        frag.table = new BinaryTable(*table, ShareMode::COPY);
+    }
+    if (section != nullptr) {
+        frag.section = new Section(*section, ShareMode::COPY);
+    }
+    frag.text = _shard_text.str();
+    _shard_text.str(std::string());
+}
+
+
+//----------------------------------------------------------------------------
+// Produce the output of fragments from sharded loggers.
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::logFragments(FragmentList& fragments)
+{
+    // Restore the input order. In the same packet, all tables and sections come from the same PID.
+    // After the end of input, flushed tables are produced in PID order. The list sort is stable.
+    fragments.sort([](const Fragment& f1, const Fragment& f2) {
+        return f1.position < f2.position || (f1.position == f2.position && f1.pid < f2.pid);
+    });
+
+    for (const auto& frag : fragments) {
+        if (completed()) {
+            break;
+        }
+        else if (!frag.table.isNull()) {
+            saveTable(_demux, *frag.table, &frag);
+            countTable();
+        }
+        else if (!frag.section.isNull()) {
+            saveSection(_demux, *frag.section, &frag);
+            countTable();
+        }
+        else {
+            // Invalid section, text only.
+            logText(frag.text);
+        }
+    }
+    fragments.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Log text which was formatted by a sharded logger.
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::logText(const std::string& text)
+{
+    if (_logger) {
+        // One-liners, log them again, either on output or on report.
+        UStringVector lines;
+        UString::FromUTF8(text).split(lines, u'\n', false, true);
+        for (const auto& line : lines) {
+            _display.logLine(line);
+        }
+    }
+    else {
+        // Initial spacing, as in preDisplay().
+        if (_table_count == 0) {
+            _duck.out() << std::endl;
+        }
+        _duck.out() << text;
+    }
+    postDisplay();
+}
+
+
+//----------------------------------------------------------------------------
+// Count a logged table or section, check max table count.
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::countTable()
+{
+    _table_count++;
+    if (_max_tables > 0 && _table_count >= _max_tables) {
+        _exit = true;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Detect and track duplicate section by PID.
 //----------------------------------------------------------------------------
@@ -588,7 +725,7 @@ void ts::TablesLogger::handleTable(SectionDemux& demux, const BinaryTable& table
     for (size_t i = 0; !keep && i < table.sectionCount(); ++i) {
         keep = isFiltered(*table.sectionAt(i), cas);
     }
-    if (!keep) {
+    if (!keep || !_shard_pids.test(pid)) {
         return;
     }
 
@@ -605,20 +742,69 @@ void ts::TablesLogger::handleTable(SectionDemux& demux, const BinaryTable& table
     }
 
     // Filtering done, now save table in various formats.
+    if (_sharded) {
+        // Only format the text, the table will be saved by the main logger.
+        if (_use_text && !_invalid_only) {
+            displayTable(table);
+        }
+        addFragment(pid, &table, nullptr);
+    }
+    else {
+        saveTable(demux, table, nullptr);
+    }
+    countTable();
+}
+
+
+//----------------------------------------------------------------------------
+// Format a table or section in the text output.
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::displayTable(const BinaryTable& table)
+{
+    preDisplay(table.firstTSPacketIndex(), table.lastTSPacketIndex());
+    if (_logger) {
+        // Short log message
+        logSection(*table.sectionAt(0));
+    }
+    else {
+        // Full table formatting
+        _display.displayTable(table, u"", _cas_mapper.casId(table.sourcePID()));
+        _display << std::endl;
+    }
+    postDisplay();
+}
+
+void ts::TablesLogger::displaySection(const Section& sect)
+{
+    preDisplay(sect.firstTSPacketIndex(), sect.lastTSPacketIndex());
+    if (_logger) {
+        // Short log message
+        logSection(sect);
+    }
+    else {
+        // Full section formatting.
+        _display.displaySection(sect, u"", _cas_mapper.casId(sect.sourcePID()));
+        _display << std::endl;
+    }
+    postDisplay();
+}
+
 
+//----------------------------------------------------------------------------
+// Save a table in all output formats.
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::saveTable(SectionDemux& demux, const BinaryTable& table, const Fragment* frag)
+{
     // Save table in text format.
     if (_use_text && !_invalid_only) {
-        preDisplay(table.firstTSPacketIndex(), table.lastTSPacketIndex());
-        if (_logger) {
-            // Short log message
-            logSection(*table.sectionAt(0));
+        if (frag != nullptr) {
+            logText(frag->text);
         }
         else {
-            // Full table formatting
-            _display.displayTable(table, u"", _cas_mapper.casId(pid));
-            _display << std::endl;
+            displayTable(table);
         }
-        postDisplay();
     }
 
     // Save table in XML format.
@@ -643,15 +829,17 @@ void ts::TablesLogger::handleTable(SectionDemux& demux, const BinaryTable& table
         // First, build an XML document with the table.
         xml::Document doc(_report);
         doc.initialize(u"tsduck");
-        table.toXML(_duck, doc.rootElement(), _xml_options);
+        const xml::Element* elem = table.toXML(_duck, doc.rootElement(), _xml_options);
         if (_rewrite_json) {
             // Convert to JSON and save a new document each time.
             _x2j_conv.convertToJSON(doc)->save(_json_destination, 2, true, _report);
         }
-        else {
-            // Convert to JSON. Force "tsduck" root to appear so that the path to the first table is always the same.
-            // Query the first (and only) converted table and add it to the running document.
-            _json_doc.add(_x2j_conv.convertToJSON(doc, true)->query(u"#nodes[0]"));
+        else if (elem != nullptr) {
+            // Directly print the XML table as JSON in the running document, without intermediate JSON tree.
+            TextFormatter* text = _json_doc.startValue();
+            if (text != nullptr) {
+                _x2j_conv.printAsJSON(*text, elem);
+            }
         }
     }
 
@@ -699,12 +887,6 @@ void ts::TablesLogger::handleTable(SectionDemux& demux, const BinaryTable& table
             _section_handler->handleSection(demux, *table.sectionAt(i));
         }
     }
-
-    // Check max table count
-    _table_count++;
-    if (_max_tables > 0 && _table_count >= _max_tables) {
-        _exit = true;
-    }
 }
 
 
@@ -754,7 +936,7 @@ void ts::TablesLogger::handleSection(SectionDemux& demux, const Section& sect)
     }
 
     // Ignore section if not to be filtered
-    if (!isFiltered(sect, cas)) {
+    if (!isFiltered(sect, cas) || !_shard_pids.test(pid)) {
         return;
     }
 
@@ -769,20 +951,37 @@ void ts::TablesLogger::handleSection(SectionDemux& demux, const Section& sect)
     }
 
     // Filtering done, now save data.
+    if (_sharded) {
+        // Only format the text, the section will be saved by the main logger.
+        if (_use_text && !_invalid_only) {
+            displaySection(sect);
+        }
+        addFragment(pid, nullptr, &sect);
+    }
+    else {
+        saveSection(demux, sect, nullptr);
+    }
+
+    // Check max table count (actually count sections with --all-sections)
+    countTable();
+}
+
+
+//----------------------------------------------------------------------------
+// Save a section in all output formats (option --all-sections).
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::saveSection(SectionDemux& demux, const Section& sect, const Fragment* frag)
+{
     // Note that no XML can be produced since valid XML structures contain complete tables only.
 
     if (_use_text && !_invalid_only) {
-        preDisplay(sect.firstTSPacketIndex(), sect.lastTSPacketIndex());
-        if (_logger) {
-            // Short log message
-            logSection(sect);
+        if (frag != nullptr) {
+            logText(frag->text);
         }
         else {
-            // Full section formatting.
-            _display.displaySection(sect, u"", _cas_mapper.casId(pid));
-            _display << std::endl;
+            displaySection(sect);
         }
-        postDisplay();
     }
 
     if (_use_binary) {
@@ -808,12 +1007,6 @@ void ts::TablesLogger::handleSection(SectionDemux& demux, const Section& sect)
     if (_section_handler != nullptr) {
         _section_handler->handleSection(demux, sect);
     }
-
-    // Check max table count (actually count sections with --all-sections)
-    _table_count++;
-    if (_max_tables > 0 && _table_count >= _max_tables) {
-        _exit = true;
-    }
 }
 
 
@@ -851,6 +1044,11 @@ void ts::TablesLogger::handleInvalidSection(SectionDemux& demux, const DemuxedDa
         _display << std::endl;
     }
     postDisplay();
+
+    // In a sharded logger, the text will be logged by the main logger.
+    if (_sharded) {
+        addFragment(ddata.sourcePID(), nullptr, nullptr);
+    }
 }
 
 
@@ -883,17 +1081,13 @@ void ts::TablesLogger::logXMLJSON(const BinaryTable& table)
     // Log the JSON line.
     if (_log_json_line) {
 
-        // Convert the XML document into JSON.
-        // Force "tsduck" root to appear so that the path to the first table is always the same.
-        const json::ValuePtr root(_x2j_conv.convertToJSON(doc, true));
-
         // Reset the text formatter if already used for XML.
         if (_log_xml_line) {
             text.setString();
         }
 
-        // Query the first (and only) converted table and log it as one line.
-        root->query(u"#nodes[0]").print(text);
+        // Directly print the XML table as JSON, without intermediate JSON tree, and log it as one line.
+        _x2j_conv.printAsJSON(text, elem);
         _report.info(_log_json_prefix + text.toString());
     }
 }
@@ -1175,7 +1369,7 @@ bool ts::TablesLogger::isFiltered(const Section& sect, uint16_t cas)
         if (!it->filterSection(_duck, sect, cas, pids)) {
             status = false;
         }
-        _demux.addPIDs(pids);
+        _demux.addPIDs(pids & _shard_pids);
     }
     return status;
 }
@@ -1189,8 +1383,8 @@ void ts::TablesLogger::preDisplay(PacketCounter first, PacketCounter last)
 {
     std::ostream& strm(_duck.out());
 
-    // Initial spacing
-    if (_table_count == 0 && !_logger) {
+    // Initial spacing, added by the main logger with sharded loggers.
+    if (_table_count == 0 && !_logger && !_sharded) {
         strm << std::endl;
     }
 
@@ -1228,10 +1422,16 @@ void ts::TablesLogger::postDisplay()
 // Report the demux errors (if any)
 //----------------------------------------------------------------------------
 
+void ts::TablesLogger::addDemuxErrors(const TablesLogger& shard)
+{
+    _shard_errors += SectionDemux::Status(shard._demux);
+}
+
 void ts::TablesLogger::reportDemuxErrors(std::ostream& strm)
 {
-    if (_demux.hasErrors()) {
-        SectionDemux::Status status(_demux);
+    SectionDemux::Status status(_demux);
+    status += _shard_errors;
+    if (status.hasErrors()) {
         strm << "* PSI/SI analysis errors:" << std::endl;
         status.display(strm, 4, true);
     }
@@ -1239,8 +1439,9 @@ void ts::TablesLogger::reportDemuxErrors(std::ostream& strm)
 
 void ts::TablesLogger::reportDemuxErrors(Report& report, int level)
 {
-    if (_demux.hasErrors()) {
-        SectionDemux::Status status(_demux);
+    SectionDemux::Status status(_demux);
+    status += _shard_errors;
+    if (status.hasErrors()) {
         status.display(report, level, UString(), true);
     }
 }
@@ -114,6 +114,58 @@ namespace ts {
         //!
         void feedPacket(const TSPacket& pkt);
 
+        //!
+        //! A piece of output from a sharded table logger.
+        //! A sharded logger demuxes and filters the tables and formats the text output.
+        //! The main logger produces the actual output of all shards in input order.
+        //! @see setShard()
+        //!
+        struct TSDUCKDLL Fragment
+        {
+            PacketCounter  position = 0;     //!< Ordering position, number of input packets before the one which completed the table or section.
+            PID            pid = PID_NULL;   //!< Source PID.
+            BinaryTablePtr table {};         //!< Complete table, null for a section or an invalid section.
+            SectionPtr     section {};       //!< Section with -\-all-sections, null for a table or an invalid section.
+            std::string    text {};          //!< Formatted text output (UTF-8), empty if there is no text output.
+        };
+
+        //!
+        //! List of output fragments from sharded table loggers.
+        //!
+        typedef std::list<Fragment> FragmentList;
+
+        //!
+        //! Restrict the logger to a shard of the PID's, for parallel processing of a transport stream.
+        //! All shards must receive all packets. Each shard demuxes and formats the tables from its
+        //! own PID's only (@a pid % @a count == @a index). The PAT is always demuxed in all shards
+        //! to track the PMT PID's. A sharded logger produces no output by itself, the output is
+        //! collected using getFragments() and produced by a non-sharded logger using logFragments().
+        //! Must be called before open().
+        //! @param [in] index Index of this shard, from 0 to @a count - 1.
+        //! @param [in] count Total number of shards. When less than 2, the logger is not sharded.
+        //!
+        void setShard(size_t index, size_t count);
+
+        //!
+        //! Get the output fragments from a sharded logger.
+        //! @param [in,out] fragments The output fragments since the previous call are appended to this list.
+        //!
+        void getFragments(FragmentList& fragments);
+
+        //!
+        //! Produce the output of fragments from sharded loggers.
+        //! @param [in,out] fragments Output fragments from all shards, for the same range of input packets.
+        //! The list is sorted in input order and then cleared.
+        //!
+        void logFragments(FragmentList& fragments);
+
+        //!
+        //! Add the demux errors of a sharded logger to the demux errors of this logger.
+        //! @param [in] shard A sharded logger.
+        //! @see reportDemuxErrors()
+        //!
+        void addDemuxErrors(const TablesLogger& shard);
+
         //!
         //! Open files, start operations.
         //! The options must have been loaded first.
@@ -232,6 +284,12 @@ namespace ts {
         PacketCounter            _packet_count = 0;
         SectionDemux             _demux;
         CASMapper                _cas_mapper;
+        bool                     _sharded = false;           // This is a sharded logger.
+        PIDSet                   _shard_pids {AllPIDs};      // PID's in this shard.
+        SectionDemux             _shard_demux;               // Demux of the PAT when not in this shard.
+        SectionDemux::Status     _shard_errors {};           // Demux errors from other shards.
+        std::ostringstream       _shard_text {};             // Text output of a sharded logger.
+        FragmentList             _fragments {};              // Output fragments of a sharded logger.
         xml::RunningDocument     _xml_doc;                   // XML document, built on-the-fly.
         xml::JSONConverter       _x2j_conv;                  // XML-to-JSON converter.
         json::RunningDocument    _json_doc;                  // JSON document, built on-the-fly.
@@ -257,6 +315,23 @@ namespace ts {
         void sendUDP(const BinaryTable& table);
         void sendUDP(const Section& section);
 
+        // Save a table or section in all output formats. When not null, the fragment contains the formatted text.
+        void saveTable(SectionDemux& demux, const BinaryTable& table, const Fragment* frag);
+        void saveSection(SectionDemux& demux, const Section& section, const Fragment* frag);
+
+        // Format a table or section in the text output.
+        void displayTable(const BinaryTable& table);
+        void displaySection(const Section& section);
+
+        // Log text which was formatted by a sharded logger.
+        void logText(const std::string& text);
+
+        // Add an output fragment in a sharded logger.
+        void addFragment(PID pid, const BinaryTable* table, const Section* section);
+
+        // Count a logged table or section, check max table count.
+        void countTable();
+
         // Pre/post-display of a table or section
         void preDisplay(PacketCounter first, PacketCounter last);
         void postDisplay();
@@ -31,6 +31,11 @@
 #include "tsMemory.h"
 #include "tsUString.h"
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr ts::MilliSecond ts::PCRAnalyzer::DEFAULT_WINDOW_DURATION;
+constexpr size_t ts::PCRAnalyzer::DEFAULT_WINDOW_CAPACITY;
+#endif
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -54,7 +59,10 @@ ts::PCRAnalyzer::PCRAnalyzer(size_t min_pid, size_t min_pcr) :
     _pcr_pids(0),
     _discontinuities(0),
     _pid(),
-    _packet_pcr_index_map()
+    _inst_duration(SYSTEM_CLOCK_FREQ),
+    _inst_first(0),
+    _inst_count(0),
+    _inst_points(DEFAULT_WINDOW_CAPACITY)
 {
     TS_ZERO(_pid);
 }
@@ -155,7 +163,7 @@ void ts::PCRAnalyzer::reset()
         }
     }
 
-    _packet_pcr_index_map.clear();
+    _inst_first = _inst_count = 0;
 }
 
 
@@ -181,6 +189,28 @@ void ts::PCRAnalyzer::setIgnoreErrors(bool ignore)
 }
 
 
+//----------------------------------------------------------------------------
+// Set the sliding window which is used to compute the instantaneous bitrate.
+//----------------------------------------------------------------------------
+
+void ts::PCRAnalyzer::setInstantaneousWindow(MilliSecond duration, size_t capacity)
+{
+    _inst_duration = uint64_t(std::max<MilliSecond>(1, duration)) * (SYSTEM_CLOCK_FREQ / MilliSecPerSec);
+    _inst_points.resize(std::max<size_t>(2, capacity));
+    _inst_first = _inst_count = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Difference between two PCR or DTS values, in PCR units.
+//----------------------------------------------------------------------------
+
+uint64_t ts::PCRAnalyzer::diffValues(uint64_t value1, uint64_t value2) const
+{
+    return _use_dts ? DiffPTS(value1, value2) * SYSTEM_CLOCK_SUBFACTOR : DiffPCR(value1, value2);
+}
+
+
 //----------------------------------------------------------------------------
 // Process a discontinuity in the transport stream
 //----------------------------------------------------------------------------
@@ -195,7 +225,7 @@ void ts::PCRAnalyzer::processDiscontinuity()
             _pid[i]->last_pcr_value = INVALID_PCR;
         }
     }
-    _packet_pcr_index_map.clear();
+    _inst_first = _inst_count = 0;
 }
 
 
@@ -356,18 +386,19 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
             BitRate ts_bitrate_204 = diff_values == 0 ? 0 :
                 BitRate((_ts_pkt_cnt - ps->last_pcr_packet) * SYSTEM_CLOCK_FREQ * PKT_RS_SIZE_BITS) / diff_values;
 
-            // Clear out values older than 1 second from _packet_pcr_index_map.
-            // Note that this is a map that covers PCR/DTS packets across all PIDs
-            // as long as the clocks used to generate the PCR/DTS values for different
-            // programs is the same clock, there should be no issue, but if the PCR/DTS values
-            // across the two programs are wildly different, then the following approach won't work.
-            while (!_packet_pcr_index_map.empty()) {
-                const uint64_t earliestPCR_DTS = _packet_pcr_index_map.begin()->first;
-                diff_values = _use_dts ?
-                    DiffPTS(earliestPCR_DTS, pcr_dts) * SYSTEM_CLOCK_SUBFACTOR :
-                    DiffPCR(earliestPCR_DTS, pcr_dts);
-                if (diff_values > SYSTEM_CLOCK_FREQ) {
-                    _packet_pcr_index_map.erase(_packet_pcr_index_map.begin());
+            // Drop values which are older than the sliding window, the oldest ones first.
+            // Note that this window covers PCR/DTS packets across all PIDs. As long as the
+            // clocks used to generate the PCR/DTS values for different programs is the same
+            // clock, there should be no issue, but if the PCR/DTS values across the programs
+            // are wildly different, then the following approach won't work. The values are
+            // in packet order, the PCR/DTS wrap-up is handled. A value from another PID which
+            // is slightly more recent than the current one (more than half a PCR scale away)
+            // is not considered as old.
+            while (_inst_count > 0) {
+                diff_values = diffValues(_inst_points[_inst_first].pcr_dts, pcr_dts);
+                if (diff_values > _inst_duration && diff_values <= PCR_SCALE / 2) {
+                    _inst_first = (_inst_first + 1) % _inst_points.size();
+                    _inst_count--;
                 }
                 else {
                     break;
@@ -390,14 +421,15 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
 
             // Transport stream instantaneous statistics.
             // For instantaneous bit rates, these are the actual bit rates, and it doesn't use the "count" approach.
-            if (!_packet_pcr_index_map.empty()) {
-                diff_values = _use_dts ?
-                    DiffPTS(_packet_pcr_index_map.begin()->first, pcr_dts) * SYSTEM_CLOCK_SUBFACTOR :
-                    DiffPCR(_packet_pcr_index_map.begin()->first, pcr_dts);
-                _inst_ts_bitrate_188 = diff_values == 0 ? 0 :
-                    BitRate((_ts_pkt_cnt - _packet_pcr_index_map.begin()->second) * SYSTEM_CLOCK_FREQ * PKT_SIZE_BITS) / diff_values;
-                _inst_ts_bitrate_204 = diff_values == 0 ? 0 :
-                    BitRate((_ts_pkt_cnt - _packet_pcr_index_map.begin()->second) * SYSTEM_CLOCK_FREQ * PKT_RS_SIZE_BITS) / diff_values;
+            if (_inst_count > 0) {
+                const PCRPoint& oldest(_inst_points[_inst_first]);
+                diff_values = diffValues(oldest.pcr_dts, pcr_dts);
+                if (diff_values <= PCR_SCALE / 2) {
+                    _inst_ts_bitrate_188 = diff_values == 0 ? 0 :
+                        BitRate((_ts_pkt_cnt - oldest.packet) * SYSTEM_CLOCK_FREQ * PKT_SIZE_BITS) / diff_values;
+                    _inst_ts_bitrate_204 = diff_values == 0 ? 0 :
+                        BitRate((_ts_pkt_cnt - oldest.packet) * SYSTEM_CLOCK_FREQ * PKT_RS_SIZE_BITS) / diff_values;
+                }
             }
 
             // Check if we got enough values for this PID
@@ -412,14 +444,16 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
             ps->last_pcr_value = pcr_dts;
             ps->last_pcr_packet = _ts_pkt_cnt;
 
-            // Also add PCR (or DTS)/packet index combo to map for use in instantaneous bit rate calculations.
-            _packet_pcr_index_map[pcr_dts] = _ts_pkt_cnt;
-
-            // Make sure that some crazy TS does not accumulate thousands of PCR values in the same second range.
-            while (_packet_pcr_index_map.size() > FOOLPROOF_MAP_LIMIT) {
-                // Erase older entries.
-                _packet_pcr_index_map.erase(_packet_pcr_index_map.begin());
+            // Also add PCR (or DTS)/packet index combo in the sliding window for use in instantaneous bit rate calculations.
+            // When the circular buffer is full, overwrite the oldest entry. This makes sure that some crazy TS does not
+            // accumulate thousands of PCR values in the same window.
+            if (_inst_count == _inst_points.size()) {
+                _inst_first = (_inst_first + 1) % _inst_points.size();
+                _inst_count--;
             }
+            PCRPoint& point(_inst_points[(_inst_first + _inst_count++) % _inst_points.size()]);
+            point.pcr_dts = pcr_dts;
+            point.packet = _ts_pkt_cnt;
         }
     }
 
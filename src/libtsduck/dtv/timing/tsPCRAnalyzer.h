@@ -101,6 +101,33 @@ namespace ts {
         //!
         void setIgnoreErrors(bool ignore);
 
+        //!
+        //! Default duration of the sliding window for the instantaneous bitrate.
+        //!
+        static constexpr MilliSecond DEFAULT_WINDOW_DURATION = 1000;
+
+        //!
+        //! Default maximum number of PCR's (or DTS's) in the sliding window for the instantaneous bitrate.
+        //!
+        static constexpr size_t DEFAULT_WINDOW_CAPACITY = 1000;
+
+        //!
+        //! Set the sliding window which is used to compute the instantaneous bitrate.
+        //! The PCR's (or DTS's) of the sliding window are kept in a circular buffer of fixed
+        //! capacity. The memory usage remains constant, regardless of the duration of the stream.
+        //! The content of the current sliding window is reset.
+        //! @param [in] duration Duration of the sliding window in milliseconds.
+        //! @param [in] capacity Maximum number of PCR's (or DTS's) in the sliding window.
+        //! When the capacity is reached, the oldest values are dropped, shortening the window.
+        //!
+        void setInstantaneousWindow(MilliSecond duration, size_t capacity = DEFAULT_WINDOW_CAPACITY);
+
+        //!
+        //! Get the current number of PCR's (or DTS's) in the sliding window for the instantaneous bitrate.
+        //! @return The current number of PCR's (or DTS's) in the sliding window.
+        //!
+        size_t instantaneousPCRCount() const { return _inst_count; }
+
         //!
         //! The following method feeds the analyzer with a TS packet.
         //! @param [in] pkt A new transport stream packet.
@@ -200,6 +227,9 @@ namespace ts {
         // Process a discontinuity in the transport stream
         void processDiscontinuity();
 
+        // Difference between two PCR or DTS values, in PCR units.
+        uint64_t diffValues(uint64_t value1, uint64_t value2) const;
+
         // Analysis of one PID
         struct PIDAnalysis
         {
@@ -215,6 +245,13 @@ namespace ts {
             uint64_t ts_bitrate_cnt;   // Count of computed TS bitrates
         };
 
+        // A PCR/DTS value and the index of the packet containing it, in the sliding window.
+        struct PCRPoint
+        {
+            uint64_t pcr_dts;  // PCR or DTS value
+            uint64_t packet;   // Index of packet in the TS
+        };
+
         // Private members:
         bool     _use_dts;             // Use DTS instead of PCR
         bool     _ignore_errors;       // Ignore TS errors such as discontinuities.
@@ -231,7 +268,9 @@ namespace ts {
         size_t   _pcr_pids;            // Number of PIDs with PCRs
         size_t   _discontinuities;     // Number of discontinuities
         PIDAnalysis* _pid[PID_MAX];    // Per-PID stats
-        std::map<uint64_t, uint64_t> _packet_pcr_index_map; // Map of PCR/DTS to packet index across entire TS
-        static constexpr size_t FOOLPROOF_MAP_LIMIT = 1000; // Max number of entries in the PCR map
+        uint64_t _inst_duration;       // Duration of the sliding window in PCR units
+        size_t   _inst_first;          // Index of the oldest PCR/DTS in _inst_points
+        size_t   _inst_count;          // Number of PCR/DTS in the sliding window
+        std::vector<PCRPoint> _inst_points; // Sliding window of PCR/DTS across all PID's, circular buffer
     };
 }
@@ -30,6 +30,7 @@
 #include "tsTimeShiftBuffer.h"
 #include "tsNullReport.h"
 #include "tsFileUtils.h"
+#include "tsMemory.h"
 
 #if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
 constexpr size_t ts::TimeShiftBuffer::MIN_TOTAL_PACKETS;
@@ -38,6 +39,16 @@ constexpr size_t ts::TimeShiftBuffer::MIN_MEMORY_PACKETS;
 constexpr size_t ts::TimeShiftBuffer::DEFAULT_MEMORY_PACKETS;
 #endif
 
+// Layout of a memory-mapped ring file: a header, followed by fixed-size records.
+// Each record contains the serialized packet metadata, followed by the packet.
+// Header: magic[8], record size[4], total packets[8], current packets[8], next write index[8].
+namespace {
+    constexpr size_t RING_HEADER_SIZE = 4096;
+    constexpr size_t RING_RECORD_SIZE = ts::TSPacketMetadata::SERIALIZATION_SIZE + ts::PKT_SIZE;
+    constexpr size_t RING_MAGIC_SIZE = 8;
+    const uint8_t RING_MAGIC[RING_MAGIC_SIZE] = {'T', 'S', 'S', 'H', 'I', 'F', 'T', '1'};
+}
+
 
 //----------------------------------------------------------------------------
 // Constructors and destructors
@@ -58,7 +69,10 @@ ts::TimeShiftBuffer::TimeShiftBuffer(size_t count) :
     _wcache(),
     _rcache(),
     _wmdata(),
-    _rmdata()
+    _rmdata(),
+    _mapped(false),
+    _persistent_file(),
+    _ring()
 {
 }
 
@@ -106,6 +120,29 @@ bool ts::TimeShiftBuffer::setBackupDirectory(const UString& directory)
 }
 
 
+bool ts::TimeShiftBuffer::setMemoryMapped(bool on)
+{
+    if (_is_open) {
+        return false;
+    }
+    else {
+        _mapped = on;
+        return true;
+    }
+}
+
+bool ts::TimeShiftBuffer::setPersistentFile(const UString& filename)
+{
+    if (_is_open) {
+        return false;
+    }
+    else {
+        _persistent_file = filename;
+        return true;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Open the buffer.
 //----------------------------------------------------------------------------
@@ -124,6 +161,12 @@ bool ts::TimeShiftBuffer::open(Report& report)
         _rcache.clear();
         _rmdata.clear();
     }
+    else if (!_persistent_file.empty()) {
+        // The buffer is a persistent ring file, entirely mapped in memory.
+        if (!openRing(_persistent_file, report)) {
+            return false;
+        }
+    }
     else {
         // The buffer is backed up on disk.
         // Get the name of a temporary file. If a directory is specified, we will use the base name only.
@@ -138,29 +181,107 @@ bool ts::TimeShiftBuffer::open(Report& report)
             }
         }
 
+        if (_mapped) {
+            // Temporary ring file, entirely mapped in memory.
+            if (!openRing(filename, report)) {
+                return false;
+            }
+#if !defined(TS_WINDOWS)
+            // On UNIX systems, the file can be deleted now, the mapping keeps a reference on it.
+            // This guarantees that the disk space is reclaimed, even if the application crashes.
+            DeleteFile(filename, report);
+#endif
+        }
         // Create the backup file. The flag temporary means that it will be deleted on close.
         // Use TSDuck proprietary format to save the packet metadata.
-        if (!_file.open(filename, TSFile::READ | TSFile::WRITE | TSFile::TEMPORARY, report, TSPacketFormat::DUCK)) {
+        else if (!_file.open(filename, TSFile::READ | TSFile::WRITE | TSFile::TEMPORARY, report, TSPacketFormat::DUCK)) {
             return false;
         }
 
         // The read and write buffers use half of memory quota each.
         // Since the size of the file is larger than the sum of the two,
         // the read and write caches never overlap when the buffer is full.
-        _wcache.resize(_mem_packets / 2);
-        _wmdata.resize(_mem_packets / 2);
-        _rcache.resize(_mem_packets / 2);
-        _rmdata.resize(_mem_packets / 2);
+        // There is no cache with a memory-mapped ring file.
+        const size_t cache_size = _mapped ? 0 : _mem_packets / 2;
+        _wcache.resize(cache_size);
+        _wmdata.resize(cache_size);
+        _rcache.resize(cache_size);
+        _rmdata.resize(cache_size);
     }
 
     _cur_packets = 0;
     _next_read = _next_write = 0;
     _wcache_next = _rcache_end = _rcache_next = 0;
+    if (useRing()) {
+        loadRingState(report);
+    }
     _is_open = true;
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Open and map the ring file.
+//----------------------------------------------------------------------------
+
+bool ts::TimeShiftBuffer::openRing(const UString& filename, Report& report)
+{
+    const uint64_t size = RING_HEADER_SIZE + uint64_t(_total_packets) * RING_RECORD_SIZE;
+    if (size > uint64_t(std::numeric_limits<size_t>::max())) {
+        report.error(u"time-shift buffer too large for a memory-mapped file: %'d bytes", {size});
+        return false;
+    }
+    _wcache.clear();
+    _wmdata.clear();
+    _rcache.clear();
+    _rmdata.clear();
+    return _ring.openReadWrite(filename, size_t(size), true, report);
+}
+
+
+//----------------------------------------------------------------------------
+// Load or initialize the state of the memory-mapped ring file.
+//----------------------------------------------------------------------------
+
+void ts::TimeShiftBuffer::loadRingState(Report& report)
+{
+    uint8_t* const header = _ring.writableData();
+    assert(header != nullptr);
+
+    // Reuse the previous state if the file is a ring file with the same size.
+    if (std::memcmp(header, RING_MAGIC, RING_MAGIC_SIZE) == 0 &&
+        GetUInt32(header + 8) == RING_RECORD_SIZE &&
+        GetUInt64(header + 12) == _total_packets &&
+        GetUInt64(header + 20) <= _total_packets &&
+        GetUInt64(header + 28) < _total_packets)
+    {
+        _cur_packets = size_t(GetUInt64(header + 20));
+        _next_write = size_t(GetUInt64(header + 28));
+        _next_read = (_next_write + _total_packets - _cur_packets) % _total_packets;
+        report.verbose(u"restored %'d packets from time-shift file %s", {_cur_packets, _ring.fileName()});
+    }
+    else {
+        // New or incompatible file, start with an empty buffer.
+        std::memcpy(header, RING_MAGIC, RING_MAGIC_SIZE);
+        PutUInt32(header + 8, uint32_t(RING_RECORD_SIZE));
+        PutUInt64(header + 12, uint64_t(_total_packets));
+        saveRingState();
+    }
+}
+
+void ts::TimeShiftBuffer::saveRingState()
+{
+    uint8_t* const header = _ring.writableData();
+    PutUInt64(header + 20, uint64_t(_cur_packets));
+    PutUInt64(header + 28, uint64_t(_next_write));
+}
+
+uint8_t* ts::TimeShiftBuffer::ringRecord(size_t index)
+{
+    return _ring.writableData() + RING_HEADER_SIZE + index * RING_RECORD_SIZE;
+}
+
+
 //----------------------------------------------------------------------------
 // Close the buffer.
 //----------------------------------------------------------------------------
@@ -177,7 +298,21 @@ bool ts::TimeShiftBuffer::close(Report& report)
     _wmdata.clear();
     _rcache.clear();
     _rmdata.clear();
-    return !_file.isOpen() || _file.close(report);
+
+    bool ok = true;
+    if (_ring.isOpen()) {
+        if (!_persistent_file.empty()) {
+            // Make sure that the state of the persistent file survives a system crash.
+            ok = _ring.flush(report);
+        }
+        const UString filename(_ring.fileName());
+        _ring.close();
+        // A temporary ring file is already deleted on UNIX systems, not on Windows where a mapped file cannot be deleted.
+        if (_persistent_file.empty() && FileExists(filename)) {
+            ok = DeleteFile(filename, report) && ok;
+        }
+    }
+    return (!_file.isOpen() || _file.close(report)) && ok;
 }
 
 
@@ -217,6 +352,26 @@ bool ts::TimeShiftBuffer::shift(TSPacket& packet, TSPacketMetadata& mdata, Repor
         _wmdata[_next_write] = mdata;
         _next_write = (_next_write + 1) % _wcache.size();
     }
+    else if (useRing()) {
+        // The buffer is a memory-mapped ring file. When the buffer is full,
+        // the oldest packet is in the same record as the new one.
+        uint8_t* const record = ringRecord(_next_write);
+        if (was_full) {
+            // Buffer full: return oldest packet.
+            assert(_next_read == _next_write);
+            ret_mdata.deserialize(record, TSPacketMetadata::SERIALIZATION_SIZE);
+            std::memcpy(ret_packet.b, record + TSPacketMetadata::SERIALIZATION_SIZE, PKT_SIZE);
+            _next_read = (_next_read + 1) % _total_packets;
+        }
+        else {
+            // Buffer not full, increase the packet count.
+            _cur_packets++;
+        }
+        mdata.serialize(record, TSPacketMetadata::SERIALIZATION_SIZE);
+        std::memcpy(record + TSPacketMetadata::SERIALIZATION_SIZE, packet.b, PKT_SIZE);
+        _next_write = (_next_write + 1) % _total_packets;
+        saveRingState();
+    }
     else {
         // The buffer uses a backup file.
         if (!was_full) {
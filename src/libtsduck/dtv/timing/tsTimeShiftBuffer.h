@@ -36,6 +36,7 @@
 #include "tsUString.h"
 #include "tsTSFile.h"
 #include "tsTSPacketMetadata.h"
+#include "tsMemoryMappedFile.h"
 #include "tsReport.h"
 
 namespace ts {
@@ -44,9 +45,17 @@ namespace ts {
 
     //!
     //! A TS packet buffer for time shift.
-    //! The buffer is partly implemented in virtual memory and partly on disk.
     //! @ingroup mpeg
     //!
+    //! By default, the buffer is partly implemented in virtual memory and partly on disk,
+    //! using a read cache and a write cache on a backup file.
+    //!
+    //! Alternatively, the buffer can be a ring file which is entirely mapped in virtual memory.
+    //! The system then performs large contiguous I/O on the file. This is recommended for large
+    //! buffers (long durations at high bitrates) on 64-bit systems. The ring file can be persistent:
+    //! it is not deleted on close and the buffer content is restored when the same file is reopened,
+    //! including after a crash of the application.
+    //!
     class TSDUCKDLL TimeShiftBuffer
     {
         TS_NOCOPY(TimeShiftBuffer);
@@ -107,6 +116,26 @@ namespace ts {
         //!
         bool setBackupDirectory(const UString& directory);
 
+        //!
+        //! Use a ring file which is mapped in memory instead of a backup file with memory caches.
+        //! Must be called before open().
+        //! When the memory-mapped ring file is used, the number of cached packets in memory is ignored.
+        //! @param [in] on True to use a memory-mapped ring file.
+        //! @return True on success, false if already open.
+        //!
+        bool setMemoryMapped(bool on);
+
+        //!
+        //! Use a persistent memory-mapped ring file.
+        //! Must be called before open(). A non-empty file name implies setMemoryMapped(true).
+        //! The file is not deleted on close. If the file already exists with the same buffer size,
+        //! its content is reused in open() and the buffer restarts in the state it was on close
+        //! or when the application crashed.
+        //! @param [in] filename File name. If empty, use a temporary file which is deleted on close.
+        //! @return True on success, false if already open.
+        //!
+        bool setPersistentFile(const UString& filename);
+
         //!
         //! Open the buffer.
         //! @param [in,out] report Where to report errors.
@@ -156,7 +185,7 @@ namespace ts {
         //! Check if the buffer is completely memory resident.
         //! @return True when the buffer is memory resident, false when it is backup by a file.
         //!
-        bool memoryResident() const { return _total_packets <= _mem_packets; }
+        bool memoryResident() const { return !useRing() && _total_packets <= _mem_packets; }
 
         //!
         //! Push a packet in the time-shift buffer and pull the oldest one.
@@ -191,6 +220,18 @@ namespace ts {
         TSPacketVector         _rcache;  // Read cache.
         TSPacketMetadataVector _wmdata;  // Packet metadata for _wcache.
         TSPacketMetadataVector _rmdata;  // Packet metadata for _rcache.
+        bool    _mapped;                 // Use a memory-mapped ring file.
+        UString _persistent_file;        // Name of persistent ring file, empty for temporary file.
+        MemoryMappedFile       _ring;    // Memory-mapped ring file.
+
+        // Check if a memory-mapped ring file is used.
+        bool useRing() const { return _mapped || !_persistent_file.empty(); }
+
+        // Open, load or initialize the state of the memory-mapped ring file.
+        bool openRing(const UString& filename, Report& report);
+        void loadRingState(Report& report);
+        void saveRingState();
+        uint8_t* ringRecord(size_t index);
 
         // Seek, read, write in the backup file.
         bool seekFile(size_t index, Report& report);
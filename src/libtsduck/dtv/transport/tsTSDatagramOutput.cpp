@@ -59,6 +59,10 @@ ts::TSDatagramOutput::TSDatagramOutput(TSDatagramOutputOptions flags, TSDatagram
     _rs204_format(false),
     _destination(),
     _local_addr(),
+    _gen(IP::v4),
+    _destination6(),
+    _local_addr6(),
+    _local_if6(0),
     _local_port(IPv4SocketAddress::AnyPort),
     _ttl(0),
     _tos(-1),
@@ -136,7 +140,10 @@ void ts::TSDatagramOutput::defineArgs(Args& args)
                   u"The parameter address:port describes the destination for UDP packets. "
                   u"The 'address' specifies an IP address which can be either unicast or "
                   u"multicast. It can be also a host name that translates to an IP address. "
-                  u"The 'port' specifies the destination UDP port.");
+                  u"The 'port' specifies the destination UDP port. "
+                  u"IPv6 destinations use the syntax '[address]:port' with a numerical IPv6 address. "
+                  u"Link-local IPv6 unicast destinations (fe80::/10) are not supported. "
+                  u"Link-local multicast destinations (ff02::/16) are sent on the interface from --local-address.");
 
         args.option(u"buffer-size", 'b', Args::UNSIGNED);
         args.help(u"buffer-size", u"Specify the UDP socket send buffer size in bytes (socket option).");
@@ -162,7 +169,8 @@ void ts::TSDatagramOutput::defineArgs(Args& args)
         args.help(u"local-address",
                   u"When the destination is a multicast address, specify the IP address "
                   u"of the outgoing local interface. It can be also a host name that "
-                  u"translates to a local address.");
+                  u"translates to a local address. With an IPv6 destination, this can be "
+                  u"an IPv6 address, an interface name or an interface index.");
 
         args.option(u"local-port", 0, Args::UINT16);
         args.help(u"local-port",
@@ -211,10 +219,22 @@ bool ts::TSDatagramOutput::loadArgs(DuckContext& duck, Args& args)
     }
 
     if (_raw_udp) {
-        success = _destination.resolve(args.value(u""), args) && success;
+        const UString destination(args.value(u""));
         const UString local(args.value(u"local-address"));
+        _gen = IPStringGeneration(destination);
         _local_addr.clear();
-        success = (local.empty() || _local_addr.resolve(local, args)) && success;
+        _local_addr6.clear();
+        _local_if6 = 0;
+        if (_gen == IP::v6) {
+            // The local IPv6 address, if any, is used to bind. The interface index is used for outgoing multicast.
+            success = _destination6.resolve(destination, args) && success;
+            success = (IPStringGeneration(local) != IP::v6 || _local_addr6.resolve(local, args)) && success;
+            success = GetIPv6InterfaceIndex(local, _local_if6, args) && success;
+        }
+        else {
+            success = _destination.resolve(destination, args) && success;
+            success = (local.empty() || _local_addr.resolve(local, args)) && success;
+        }
         args.getIntValue(_local_port, u"local-port", IPv4SocketAddress::AnyPort);
         args.getIntValue(_ttl, u"ttl", 0);
         args.getIntValue(_tos, u"tos", -1);
@@ -267,15 +287,27 @@ bool ts::TSDatagramOutput::open(Report& report)
 
     // Initialize raw UDP socket
     if (_raw_udp) {
-        if (!_sock.open(report)) {
+        if (!_sock.open(_gen, report)) {
             return false;
         }
-        const IPv4SocketAddress local(_local_addr, _local_port);
-        if ((_local_port != IPv4SocketAddress::AnyPort && !_sock.reusePort(true, report)) ||
-            !_sock.bind(local, report) ||
-            !_sock.setDefaultDestination(_destination, report) ||
+        bool ok = true;
+        if (_gen == IP::v6) {
+            // An IPv6 interface name or index is only used as outgoing multicast interface.
+            const IPv6SocketAddress local(_local_addr6, _local_port);
+            ok = (_local_port == IPv6SocketAddress::AnyPort || _sock.reusePort(true, report)) &&
+                 _sock.bind(local, report) &&
+                 _sock.setDefaultDestination(_destination6, report) &&
+                 (!_destination6.isMulticast() || _local_if6 == 0 || (!_force_mc_local && _local_addr6.hasAddress()) || _sock.setOutgoingMulticastInterface(_local_if6, report));
+        }
+        else {
+            const IPv4SocketAddress local(_local_addr, _local_port);
+            ok = (_local_port == IPv4SocketAddress::AnyPort || _sock.reusePort(true, report)) &&
+                 _sock.bind(local, report) &&
+                 _sock.setDefaultDestination(_destination, report) &&
+                 (!_force_mc_local || !_destination.isMulticast() || !_local_addr.hasAddress() || _sock.setOutgoingMulticast(_local_addr, report));
+        }
+        if (!ok ||
             !_sock.setMulticastLoop(_mc_loopback, report) ||
-            (_force_mc_local && _destination.isMulticast() && _local_addr.hasAddress() && !_sock.setOutgoingMulticast(_local_addr, report)) ||
             (_send_bufsize > 0 && !_sock.setSendBufferSize(_send_bufsize, report)) ||
             (_tos >= 0 && !_sock.setTOS(_tos, report)) ||
             (_ttl > 0 && !_sock.setTTL(_ttl, report)))
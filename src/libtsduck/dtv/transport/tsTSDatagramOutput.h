@@ -148,6 +148,10 @@ namespace ts {
         // Command line options for raw UDP.
         IPv4SocketAddress _destination;        // Destination address/port.
         IPv4Address       _local_addr;         // Local address.
+        IP                _gen;                // IP generation of the destination.
+        IPv6SocketAddress _destination6;       // Destination address/port, IPv6.
+        IPv6Address       _local_addr6;        // Local address, IPv6.
+        unsigned int      _local_if6;          // Local interface index, IPv6.
         uint16_t          _local_port;         // Local UDP source port.
         int               _ttl;                // Time to live option.
         int               _tos;                // Type of service option.
@@ -0,0 +1,153 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSFileIndex.h"
+#include "tsMemory.h"
+
+const ts::UChar* const ts::TSFileIndex::FILE_SUFFIX = u".tsidx";
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::TSFileIndex::HEADER_SIZE;
+constexpr size_t ts::TSFileIndex::ENTRY_SIZE;
+constexpr uint8_t ts::TSFileIndex::VERSION;
+#endif
+
+// Magic number at start of index files.
+namespace {
+    const uint8_t INDEX_MAGIC[] = {'T', 'S', 'I', 'X'};
+}
+
+
+//----------------------------------------------------------------------------
+// Serialization of the header.
+//----------------------------------------------------------------------------
+
+void ts::TSFileIndex::SerializeHeader(uint8_t* data, size_t packet_size)
+{
+    ::memset(data, 0, HEADER_SIZE);
+    ::memcpy(data, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    data[4] = VERSION;
+    PutUInt16(data + 6, uint16_t(packet_size));
+}
+
+
+//----------------------------------------------------------------------------
+// Serialization of entries.
+//----------------------------------------------------------------------------
+
+void ts::TSFileIndex::Entry::serialize(uint8_t* data) const
+{
+    ::memset(data, 0, ENTRY_SIZE);
+    PutUInt64(data, offset);
+    PutInt64(data + 8, time);
+    PutUInt64(data + 16, pcr);
+    PutUInt64(data + 24, pts);
+    PutInt64(data + 32, utc == Time::Epoch ? -1 : utc - Time::UnixEpoch);
+    PutUInt16(data + 40, pid & 0x1FFF);
+    data[42] = rap ? 0x01 : 0x00;
+}
+
+void ts::TSFileIndex::Entry::deserialize(const uint8_t* data)
+{
+    offset = GetUInt64(data);
+    time = GetInt64(data + 8);
+    pcr = GetUInt64(data + 16);
+    pts = GetUInt64(data + 24);
+    const MilliSecond ms = GetInt64(data + 32);
+    utc = ms < 0 ? Time::Epoch : Time::UnixEpoch + ms;
+    pid = GetUInt16(data + 40) & 0x1FFF;
+    rap = (data[42] & 0x01) != 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Clear the content of the index.
+//----------------------------------------------------------------------------
+
+void ts::TSFileIndex::clear()
+{
+    _packet_size = PKT_SIZE;
+    _entries.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Load an index file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileIndex::load(const UString& filename, Report& report)
+{
+    clear();
+
+    std::ifstream strm(filename.toUTF8().c_str(), std::ios::in | std::ios::binary);
+    if (!strm) {
+        report.error(u"cannot open index file %s", {filename});
+        return false;
+    }
+
+    uint8_t data[ENTRY_SIZE];
+    if (!strm.read(reinterpret_cast<char*>(data), HEADER_SIZE) ||
+        ::memcmp(data, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+        data[4] != VERSION ||
+        GetUInt16(data + 6) < PKT_SIZE)
+    {
+        report.error(u"invalid index file %s", {filename});
+        return false;
+    }
+    _packet_size = GetUInt16(data + 6);
+
+    // The index can be read while the recording is in progress, ignore a truncated last entry.
+    while (strm.read(reinterpret_cast<char*>(data), ENTRY_SIZE)) {
+        _entries.resize(_entries.size() + 1);
+        _entries.back().deserialize(data);
+    }
+    report.debug(u"loaded %d entries from index file %s", {_entries.size(), filename});
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Find where to start reading the TS file to play it from a given time offset.
+//----------------------------------------------------------------------------
+
+const ts::TSFileIndex::Entry* ts::TSFileIndex::findTime(MilliSecond time) const
+{
+    // Entries are in increasing order of time. Locate the first one after the requested time.
+    const auto after = std::upper_bound(_entries.begin(), _entries.end(), time, [](MilliSecond t, const Entry& e) { return t < e.time; });
+
+    // Go back to the last random access point.
+    for (auto it = after; it != _entries.begin(); ) {
+        if ((--it)->rap) {
+            return &*it;
+        }
+    }
+
+    // No random access point, use the last entry, if any.
+    return after == _entries.begin() ? nullptr : &*(after - 1);
+}
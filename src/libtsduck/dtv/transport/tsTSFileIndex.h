@@ -0,0 +1,190 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Random access index of a recorded transport stream file.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTS.h"
+#include "tsTime.h"
+#include "tsReport.h"
+
+namespace ts {
+    //!
+    //! Random access index of a recorded transport stream file.
+    //! @ingroup mpeg
+    //!
+    //! An index file is a "sidecar" file which is created with a TS file, typically during
+    //! the recording. It maps time stamps and random access points to byte offsets in the
+    //! TS file, so that applications can directly seek into multi-hour recordings.
+    //! Index files are created using the class TSFileIndexer.
+    //!
+    //! The index file has the same name as the TS file with an additional ".tsidx" suffix.
+    //! The binary format is a 16-byte header, followed by a sequence of 48-byte entries.
+    //! All integer values are in big endian representation.
+    //!
+    //! Header:
+    //! - 4 bytes: "TSIX"
+    //! - 1 byte: version of the format, currently 1.
+    //! - 1 byte: reserved.
+    //! - 2 bytes: size in bytes of each packet in the TS file (188 with raw TS, 192 with M2TS, etc).
+    //! - 8 bytes: reserved.
+    //!
+    //! Entry:
+    //! - 8 bytes: byte offset of the packet in the TS file.
+    //! - 8 bytes: time offset in milliseconds from the beginning of the TS file, based on PCR's.
+    //! - 8 bytes: last PCR value before the packet, all ones if none.
+    //! - 8 bytes: PTS of the PES packet which starts in the packet, all ones if none.
+    //! - 8 bytes: wall-clock UTC time of the recording, in milliseconds since 1970-01-01, all ones if unknown.
+    //! - 2 bytes: 3-bit reserved, 13-bit PID of the packet.
+    //! - 1 byte: 7-bit reserved, 1-bit random access point (the packet has random_access_indicator set).
+    //! - 5 bytes: reserved.
+    //!
+    class TSDUCKDLL TSFileIndex
+    {
+    public:
+        //!
+        //! Suffix of index file names.
+        //!
+        static const UChar* const FILE_SUFFIX;
+
+        //!
+        //! Size in bytes of the header of an index file.
+        //!
+        static constexpr size_t HEADER_SIZE = 16;
+
+        //!
+        //! Size in bytes of each entry in an index file.
+        //!
+        static constexpr size_t ENTRY_SIZE = 48;
+
+        //!
+        //! Current version of the index file format.
+        //!
+        static constexpr uint8_t VERSION = 1;
+
+        //!
+        //! Description of an entry in the index.
+        //!
+        class TSDUCKDLL Entry
+        {
+        public:
+            Entry() = default;                 //!< Constructor.
+            uint64_t    offset {0};            //!< Byte offset of the packet in the TS file.
+            MilliSecond time {0};              //!< Time offset from the beginning of the TS file, based on PCR's.
+            uint64_t    pcr {INVALID_PCR};     //!< Last PCR value before the packet.
+            uint64_t    pts {INVALID_PTS};     //!< PTS of the PES packet which starts in the packet.
+            Time        utc {Time::Epoch};     //!< Wall-clock UTC time of the recording, Time::Epoch if unknown.
+            PID         pid {PID_NULL};        //!< PID of the packet.
+            bool        rap {false};           //!< The packet is a random access point.
+
+            //!
+            //! Serialize the entry.
+            //! @param [out] data Address of an area of ENTRY_SIZE bytes.
+            //!
+            void serialize(uint8_t* data) const;
+
+            //!
+            //! Deserialize the entry.
+            //! @param [in] data Address of an area of ENTRY_SIZE bytes.
+            //!
+            void deserialize(const uint8_t* data);
+        };
+
+        //!
+        //! Vector of entries, in increasing order of offset.
+        //!
+        typedef std::vector<Entry> EntryVector;
+
+        //!
+        //! Default constructor.
+        //!
+        TSFileIndex() = default;
+
+        //!
+        //! Get the name of the index file for a TS file.
+        //! @param [in] ts_file_name Name of the TS file.
+        //! @return Name of the associated index file.
+        //!
+        static UString IndexFileName(const UString& ts_file_name) { return ts_file_name + FILE_SUFFIX; }
+
+        //!
+        //! Build the header of an index file.
+        //! @param [out] data Address of an area of HEADER_SIZE bytes.
+        //! @param [in] packet_size Size in bytes of each packet in the TS file.
+        //!
+        static void SerializeHeader(uint8_t* data, size_t packet_size);
+
+        //!
+        //! Load an index file.
+        //! @param [in] filename Name of the index file.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool load(const UString& filename, Report& report);
+
+        //!
+        //! Clear the content of the index.
+        //!
+        void clear();
+
+        //!
+        //! Get the size in bytes of each packet in the TS file.
+        //! @return The size in bytes of each packet in the TS file.
+        //!
+        size_t packetSize() const { return _packet_size; }
+
+        //!
+        //! Get all entries in the index.
+        //! @return A constant reference to all entries in the index.
+        //!
+        const EntryVector& entries() const { return _entries; }
+
+        //!
+        //! Get the duration of the indexed TS file.
+        //! @return The time offset of the last entry.
+        //!
+        MilliSecond duration() const { return _entries.empty() ? 0 : _entries.back().time; }
+
+        //!
+        //! Find where to start reading the TS file to play it from a given time offset.
+        //! @param [in] time Time offset in milliseconds from the beginning of the TS file.
+        //! @return Address of the last random access point at or before @a time. If there is no
+        //! random access point before @a time, the last entry at or before @a time is used.
+        //! Return a null pointer if there is no such entry.
+        //!
+        const Entry* findTime(MilliSecond time) const;
+
+    private:
+        size_t      _packet_size {PKT_SIZE};
+        EntryVector _entries {};
+    };
+}
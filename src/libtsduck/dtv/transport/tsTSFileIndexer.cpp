@@ -0,0 +1,183 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSFileIndexer.h"
+#include "tsFileUtils.h"
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr ts::MilliSecond ts::TSFileIndexer::DEFAULT_INTERVAL;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+ts::TSFileIndexer::~TSFileIndexer()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Create an index file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileIndexer::open(const UString& filename, size_t packet_size, uint64_t base_offset, bool append, Report& report)
+{
+    close();
+
+    // In append mode, load the existing entries. The time offsets of the new entries shall
+    // continue after the existing ones, otherwise the index would no longer be sorted by time.
+    TSFileIndex previous;
+    if (append && GetFileSize(filename) > 0) {
+        if (!previous.load(filename, report)) {
+            return false;
+        }
+        if (previous.packetSize() != packet_size) {
+            report.error(u"cannot append to index file %s, packet size is %d bytes, expected %d", {filename, previous.packetSize(), packet_size});
+            return false;
+        }
+    }
+
+    // The file is always rewritten, dropping a possibly truncated last entry.
+    _strm.open(filename.toUTF8().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!_strm) {
+        report.error(u"cannot create index file %s", {filename});
+        return false;
+    }
+    uint8_t data[TSFileIndex::ENTRY_SIZE];
+    TSFileIndex::SerializeHeader(data, packet_size);
+    _strm.write(reinterpret_cast<const char*>(data), TSFileIndex::HEADER_SIZE);
+    for (const auto& entry : previous.entries()) {
+        entry.serialize(data);
+        _strm.write(reinterpret_cast<const char*>(data), sizeof(data));
+    }
+    _strm.flush();
+    if (!_strm) {
+        report.error(u"error writing index file %s", {filename});
+        _strm.close();
+        return false;
+    }
+
+    _filename = filename;
+    _packet_size = packet_size;
+    _base_offset = base_offset;
+    _pcr_pid = PID_NULL;
+    _last_pcr = INVALID_PCR;
+    _elapsed = uint64_t(previous.duration()) * (SYSTEM_CLOCK_FREQ / MilliSecPerSec);
+    _next_periodic = _elapsed;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Close the index file.
+//----------------------------------------------------------------------------
+
+void ts::TSFileIndexer::close()
+{
+    if (_strm.is_open()) {
+        _strm.close();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Index packets which are written in the TS file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileIndexer::addPackets(const TSPacket* buffer, size_t count, PacketCounter first_index, Report& report)
+{
+    if (!_strm.is_open()) {
+        return false;
+    }
+
+    // Maximum gap between two PCR's. Above, this is a discontinuity and the gap is not counted.
+    constexpr uint64_t max_pcr_gap = uint64_t(SYSTEM_CLOCK_FREQ);
+
+    // Wall-clock time, the same for all packets in the group.
+    const Time now(Time::CurrentUTC());
+    bool written = false;
+
+    for (size_t i = 0; i < count; ++i) {
+        const TSPacket& pkt(buffer[i]);
+        const PID pid = pkt.getPID();
+        bool periodic = false;
+
+        // Track PCR's on the reference PID.
+        if (pkt.hasPCR() && (_pcr_pid == PID_NULL || _pcr_pid == pid)) {
+            const uint64_t pcr = pkt.getPCR();
+            if (_pcr_pid == PID_NULL) {
+                _pcr_pid = pid;
+            }
+            else {
+                const uint64_t gap = DiffPCR(_last_pcr, pcr);
+                if (gap <= max_pcr_gap) {
+                    _elapsed += gap;
+                }
+            }
+            _last_pcr = pcr;
+            periodic = _interval > 0 && _elapsed >= _next_periodic;
+        }
+
+        // Create an entry on each random access point and periodically.
+        const bool rap = pkt.getRandomAccessIndicator();
+        if (rap || periodic) {
+            TSFileIndex::Entry entry;
+            entry.offset = _base_offset + (first_index + i) * _packet_size;
+            entry.time = MilliSecond(_elapsed / (SYSTEM_CLOCK_FREQ / MilliSecPerSec));
+            entry.pcr = _last_pcr;
+            entry.pts = pkt.getPUSI() ? pkt.getPTS() : INVALID_PTS;
+            entry.utc = now;
+            entry.pid = pid;
+            entry.rap = rap;
+
+            uint8_t data[TSFileIndex::ENTRY_SIZE];
+            entry.serialize(data);
+            _strm.write(reinterpret_cast<const char*>(data), sizeof(data));
+            written = true;
+
+            if (periodic) {
+                _next_periodic = _elapsed + uint64_t(_interval) * (SYSTEM_CLOCK_FREQ / MilliSecPerSec);
+            }
+        }
+    }
+
+    // Make the new entries immediately visible to readers of the index.
+    if (written) {
+        _strm.flush();
+    }
+    if (!_strm) {
+        report.error(u"error writing index file %s", {_filename});
+        close();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,122 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Creation of a random access index for a transport stream file.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSFileIndex.h"
+#include "tsTSPacket.h"
+
+namespace ts {
+    //!
+    //! Creation of a random access index for a transport stream file.
+    //! @ingroup mpeg
+    //!
+    //! The packets are passed to the indexer while they are written in the TS file.
+    //! An index entry is created on each random access point and periodically,
+    //! based on the PCR's. The index file is flushed after each group of packets so
+    //! that it can be used while the recording is in progress.
+    //!
+    //! @see TSFileIndex
+    //!
+    class TSDUCKDLL TSFileIndexer
+    {
+        TS_NOCOPY(TSFileIndexer);
+    public:
+        //!
+        //! Default interval in milliseconds between two periodic index entries.
+        //!
+        static constexpr MilliSecond DEFAULT_INTERVAL = 1000;
+
+        //!
+        //! Default constructor.
+        //!
+        TSFileIndexer() = default;
+
+        //!
+        //! Destructor.
+        //!
+        ~TSFileIndexer();
+
+        //!
+        //! Create an index file.
+        //! @param [in] filename Name of the index file.
+        //! @param [in] packet_size Size in bytes of each packet in the TS file.
+        //! @param [in] base_offset Byte offset in the TS file of the first packet which will be indexed.
+        //! This is typically zero, unless the TS file is open in append mode.
+        //! @param [in] append If true and the index file already exists, append new entries to the file.
+        //! The existing file must have the same packet size. The time offsets of the new entries
+        //! continue from the time offset of the last existing entry.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool open(const UString& filename, size_t packet_size, uint64_t base_offset, bool append, Report& report);
+
+        //!
+        //! Close the index file.
+        //!
+        void close();
+
+        //!
+        //! Check if the index file is open.
+        //! @return True if the index file is open.
+        //!
+        bool isOpen() const { return _strm.is_open(); }
+
+        //!
+        //! Set the interval between two periodic index entries.
+        //! @param [in] interval Interval in milliseconds. Zero means no periodic entry, only random access points.
+        //!
+        void setInterval(MilliSecond interval) { _interval = interval; }
+
+        //!
+        //! Index packets which are written in the TS file.
+        //! @param [in] buffer Address of packets.
+        //! @param [in] count Number of packets in @a buffer.
+        //! @param [in] first_index Index in the TS file of the first packet in @a buffer.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool addPackets(const TSPacket* buffer, size_t count, PacketCounter first_index, Report& report);
+
+    private:
+        std::ofstream _strm {};
+        UString       _filename {};
+        size_t        _packet_size {PKT_SIZE};
+        uint64_t      _base_offset {0};
+        MilliSecond   _interval {DEFAULT_INTERVAL};
+        PID           _pcr_pid {PID_NULL};        // Reference PID for PCR's.
+        uint64_t      _last_pcr {INVALID_PCR};    // Last PCR on reference PID.
+        uint64_t      _elapsed {0};               // Elapsed time since first PCR, in PCR units.
+        uint64_t      _next_periodic {0};         // Elapsed time of next periodic entry, in PCR units.
+    };
+}
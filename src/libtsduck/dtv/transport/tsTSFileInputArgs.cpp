@@ -28,6 +28,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsTSFileInputArgs.h"
+#include "tsTSFileIndex.h"
 #include "tsAlgorithm.h"
 
 
@@ -45,6 +46,8 @@ ts::TSFileInputArgs::TSFileInputArgs() :
     _current_file(0),
     _repeat_count(1),
     _start_offset(0),
+    _use_time_offset(false),
+    _time_offset(0),
     _base_label(0),
     _file_format(TSPacketFormat::AUTODETECT),
     _filenames(),
@@ -121,6 +124,13 @@ void ts::TSFileInputArgs::defineArgs(Args& args)
               u"Start reading each file at the specified TS packet (default: 0). "
               u"This option is allowed only if all input files are regular files.");
 
+    args.option(u"time-offset", 0, Args::UNSIGNED);
+    args.help(u"time-offset", u"milliseconds",
+              u"Start reading each file at the specified time offset, in milliseconds from the beginning of the file. "
+              u"Each input file must have an associated index file, as created by the option --index of the file output plugin. "
+              u"Reading starts at the last random access point which is indexed at or before the specified time. "
+              u"The options --byte-offset, --packet-offset and --time-offset are mutually exclusive.");
+
     args.option(u"repeat", 'r', Args::POSITIVE);
     args.help(u"repeat",
               u"Repeat the playout of each file the specified number of times (default: only once). "
@@ -137,6 +147,8 @@ bool ts::TSFileInputArgs::loadArgs(DuckContext& duck, Args& args)
     args.getValues(_filenames);
     _repeat_count = args.present(u"infinite") ? 0 : args.intValue<size_t>(u"repeat", 1);
     _start_offset = args.intValue<uint64_t>(u"byte-offset", args.intValue<uint64_t>(u"packet-offset", 0) * PKT_SIZE);
+    _use_time_offset = args.present(u"time-offset");
+    args.getIntValue(_time_offset, u"time-offset", 0);
     _interleave = args.present(u"interleave");
     _first_terminate = args.present(u"first-terminate");
     args.getIntValue(_interleave_chunk, u"interleave", 1);
@@ -162,6 +174,10 @@ bool ts::TSFileInputArgs::loadArgs(DuckContext& duck, Args& args)
         args.error(u"specifying --infinite is meaningless with more than one file");
         return false;
     }
+    if (args.present(u"byte-offset") + args.present(u"packet-offset") + _use_time_offset > 1) {
+        args.error(u"--byte-offset, --packet-offset and --time-offset are mutually exclusive");
+        return false;
+    }
 
     // Make sure start and stop stuffing vectors have the same size as the file vector.
     // If the vectors must be enlarged, repeat the last value in the array.
@@ -172,6 +188,34 @@ bool ts::TSFileInputArgs::loadArgs(DuckContext& duck, Args& args)
 }
 
 
+//----------------------------------------------------------------------------
+// Get the starting byte offset of one input file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileInputArgs::getStartOffset(const UString& name, uint64_t& offset, Report& report) const
+{
+    // Without --time-offset, the same byte offset is used in all files.
+    if (!_use_time_offset) {
+        offset = _start_offset;
+        return true;
+    }
+    if (name.empty()) {
+        report.error(u"--time-offset cannot be used on standard input");
+        return false;
+    }
+
+    // Load the index file and locate the starting point.
+    TSFileIndex index;
+    if (!index.load(TSFileIndex::IndexFileName(name), report)) {
+        return false;
+    }
+    const TSFileIndex::Entry* entry = index.findTime(_time_offset);
+    offset = entry == nullptr ? 0 : entry->offset;
+    report.debug(u"time offset %'d ms in %s, starting at byte offset %'d", {_time_offset, name, offset});
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Open one input file.
 //----------------------------------------------------------------------------
@@ -192,7 +236,9 @@ bool ts::TSFileInputArgs::openFile(size_t name_index, size_t file_index, Report&
     _files[file_index].setStuffing(_start_stuffing[name_index], _stop_stuffing[name_index]);
 
     // Actually open the file.
-    return _files[file_index].openRead(name, _repeat_count, _start_offset, report, _file_format);
+    uint64_t start_offset = 0;
+    return getStartOffset(name, start_offset, report) &&
+           _files[file_index].openRead(name, _repeat_count, start_offset, report, _file_format);
 }
 
 
@@ -111,6 +111,8 @@ namespace ts {
         size_t              _current_file;       // Current file index in _files. Depends on _interleave.
         size_t              _repeat_count;
         uint64_t            _start_offset;
+        bool                _use_time_offset;    // Use _time_offset instead of _start_offset.
+        MilliSecond         _time_offset;        // Start time in each file, using the index files.
         size_t              _base_label;
         TSPacketFormat      _file_format;
         UStringVector       _filenames;
@@ -119,6 +121,9 @@ namespace ts {
         std::set<size_t>    _eof;                // Set of file indexes having reached end of file.
         std::vector<TSFile> _files;              // Array of open files, only one without interleave.
 
+        // Get the starting byte offset of one input file.
+        bool getStartOffset(const UString& name, uint64_t& offset, Report& report) const;
+
         // Open one input file.
         bool openFile(size_t name_index, size_t file_index, Report& report);
 
@@ -53,7 +53,9 @@ ts::TSFileOutputArgs::TSFileOutputArgs(bool allow_stdout) :
     _max_duration(0),
     _max_files(0),
     _multiple_files(false),
+    _index(false),
     _file(),
+    _indexer(),
     _name_gen(),
     _current_size(0),
     _next_open_time(),
@@ -88,6 +90,16 @@ void ts::TSFileOutputArgs::defineArgs(Args& args)
     args.option(u"append", 'a');
     args.help(u"append", u"If the file already exists, append to the end of the file. By default, existing files are overwritten.");
 
+    args.option(u"index");
+    args.help(u"index",
+              u"Create a random access index file next to each output file. "
+              u"The name of the index file is the name of the TS file with an additional \"" +
+              UString(TSFileIndex::FILE_SUFFIX) + u"\" suffix. "
+              u"The index contains the position of all random access points in the file "
+              u"and periodic time references, based on the PCR's. "
+              u"The index is updated during the recording and can be used by another application "
+              u"to seek into the file by time while it is still being written.");
+
     args.option(u"keep", 'k');
     args.help(u"keep", u"Keep existing file (abort if the specified file already exists). By default, existing files are overwritten.");
 
@@ -153,6 +165,7 @@ bool ts::TSFileOutputArgs::loadArgs(DuckContext& duck, Args& args)
     args.getIntValue(_max_duration, u"max-duration", 0);
     _file_format = LoadTSPacketFormatOutputOption(args);
     _multiple_files = _max_size > 0 || _max_duration > 0;
+    _index = args.present(u"index");
 
     _flags = TSFile::WRITE | TSFile::SHARED;
     if (args.present(u"append")) {
@@ -170,6 +183,10 @@ bool ts::TSFileOutputArgs::loadArgs(DuckContext& duck, Args& args)
         args.error(u"--max-duration and --max-size cannot be used on standard output");
         return false;
     }
+    if (_name.empty() && _index) {
+        args.error(u"--index cannot be used on standard output");
+        return false;
+    }
 
     return true;
 }
@@ -227,8 +244,15 @@ bool ts::TSFileOutputArgs::openAndRetry(bool initial_wait, size_t& retry_allowed
         // Try to open the file.
         const UString name(_multiple_files ? _name_gen.newFileName() : _name);
         report.verbose(u"creating file %s", {name});
+        const uint64_t base_offset = (_flags & TSFile::APPEND) != 0 && FileExists(name) ? uint64_t(std::max<int64_t>(0, GetFileSize(name))) : 0;
         const bool success = _file.open(name, _flags, report, _file_format);
 
+        // Create the associated index file. An indexing error is reported but does not prevent the recording.
+        if (success && _index) {
+            const size_t packet_size = _file.packetHeaderSize() + PKT_SIZE + _file.packetTrailerSize();
+            _indexer.open(TSFileIndex::IndexFileName(name), packet_size, base_offset, (_flags & TSFile::APPEND) != 0, report);
+        }
+
         // Remember the list of created files if we need to limit their number.
         if (success && _multiple_files && _max_files > 0) {
             _current_files.push_back(name);
@@ -266,6 +290,7 @@ bool ts::TSFileOutputArgs::openAndRetry(bool initial_wait, size_t& retry_allowed
 bool ts::TSFileOutputArgs::closeAndCleanup(Report& report)
 {
     // Close the current file.
+    _indexer.close();
     if (_file.isOpen() && !_file.close(report)) {
         return false;
     }
@@ -286,6 +311,13 @@ bool ts::TSFileOutputArgs::closeAndCleanup(Report& report)
             // Failed to delete, keep it to retry later.
             failed_delete.push_back(name);
         }
+        else if (_index) {
+            // Also delete the associated index file.
+            const UString index_name(TSFileIndex::IndexFileName(name));
+            if (FileExists(index_name)) {
+                DeleteFile(index_name, report);
+            }
+        }
     }
 
     // Re-insert files we failed to delete at head of list so that we will retry to delete them next time.
@@ -323,6 +355,11 @@ bool ts::TSFileOutputArgs::write(const TSPacket* buffer, const TSPacketMetadata*
         const size_t written = std::min(size_t(_file.writePacketsCount() - where), packet_count);
         _current_size += written * PKT_SIZE;
 
+        // Index the packets which were actually written.
+        if (_indexer.isOpen()) {
+            _indexer.addPackets(buffer, written, where, report);
+        }
+
         // In case of success or no retry, return now.
         if (success || !_reopen || (abort != nullptr && abort->aborting())) {
             return success;
@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsTSFile.h"
+#include "tsTSFileIndexer.h"
 #include "tsTSPacket.h"
 #include "tsTSPacketMetadata.h"
 #include "tsFileNameGenerator.h"
@@ -114,9 +115,11 @@ namespace ts {
         Second            _max_duration;
         size_t            _max_files;
         bool              _multiple_files;
+        bool              _index;
 
         // Working data:
         TSFile            _file;
+        TSFileIndexer     _indexer;
         FileNameGenerator _name_gen;
         uint64_t          _current_size;
         Time              _next_open_time;
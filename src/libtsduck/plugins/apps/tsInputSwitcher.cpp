@@ -99,7 +99,7 @@ bool ts::InputSwitcher::start(const InputSwitcherArgs& args)
     _success = !_report.gotErrors();
 
     // If a remote control is specified, start a UDP listener thread.
-    if (_success && _args.remoteServer.hasPort()) {
+    if (_success && (_args.remoteServer.hasPort() || _args.remoteServer6.hasPort())) {
         _remote = new tsswitch::CommandListener(*_core, _args, _report);
         CheckNonNull(_remote);
         _success = _remote->open();
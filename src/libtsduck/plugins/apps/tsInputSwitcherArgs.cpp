@@ -29,6 +29,7 @@
 
 #include "tsInputSwitcherArgs.h"
 #include "tsArgsWithPlugins.h"
+#include "tsIPUtils.h"
 
 #if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
 constexpr size_t ts::InputSwitcherArgs::DEFAULT_MAX_INPUT_PACKETS;
@@ -60,11 +61,15 @@ ts::InputSwitcherArgs::InputSwitcherArgs() :
     eventCommand(),
     eventUDP(),
     eventLocalAddress(),
+    eventUDP6(),
+    eventLocalInterface6(0),
     eventTTL(0),
     eventUserData(),
     sockBuffer(0),
     remoteServer(),
     allowedRemote(),
+    remoteServer6(),
+    allowedRemote6(),
     receiveTimeout(0),
     inputs(),
     output()
@@ -105,6 +110,7 @@ void ts::InputSwitcherArgs::defineArgs(Args& args)
     args.option(u"allow", 'a', Args::STRING);
     args.help(u"allow",
               u"Specify an IP address or host name which is allowed to send remote commands. "
+              u"IPv6 addresses must be numerical. "
               u"Several --allow options are allowed. By default, all remote commands are accepted.");
 
     args.option(u"buffer-packets", 'b', Args::POSITIVE);
@@ -142,13 +148,15 @@ void ts::InputSwitcherArgs::defineArgs(Args& args)
               u"This can be used to notify some external system of the event. "
               u"The 'address' specifies an IP address which can be either unicast or multicast. "
               u"It can be also a host name that translates to an IP address. "
-              u"The 'port' specifies the destination UDP port.");
+              u"The 'port' specifies the destination UDP port. "
+              u"IPv6 destinations use the syntax '[address]:port' with a numerical IPv6 address.");
 
     args.option(u"event-local-address", 0, Args::STRING);
     args.help(u"event-local-address", u"address",
               u"With --event-udp, when the destination is a multicast address, specify "
               u"the IP address of the outgoing local interface. It can be also a host "
-              u"name that translates to a local address.");
+              u"name that translates to a local address. With an IPv6 destination, this "
+              u"can be an IPv6 address, an interface name or an interface index.");
 
     args.option(u"event-ttl", 0, Args::POSITIVE);
     args.help(u"event-ttl",
@@ -218,6 +226,8 @@ void ts::InputSwitcherArgs::defineArgs(Args& args)
     args.help(u"remote", u"[address:]port",
               u"Specify the local UDP port which is used to receive remote commands. "
               u"If an optional address is specified, it must be a local IP address of the system. "
+              u"Use the syntax '[address]:port' to receive remote commands over IPv6, "
+              u"for instance '[::]:port' on all local IPv6 addresses. "
               u"By default, there is no remote control.");
 
     args.option(u"terminate", 't');
@@ -265,7 +275,17 @@ bool ts::InputSwitcherArgs::loadArgs(DuckContext& duck, Args& args)
     }
 
     // Resolve network names. The resolve() method reports error and set the args error state.
-    if (!remoteName.empty() && remoteServer.resolve(remoteName, args) && !remoteServer.hasPort()) {
+    remoteServer.clear();
+    remoteServer6.clear();
+    if (remoteName.empty()) {
+        // No remote control.
+    }
+    else if (IPStringGeneration(remoteName) == IP::v6) {
+        if (remoteServer6.resolve(remoteName, args) && !remoteServer6.hasPort()) {
+            args.error(u"missing UDP port number in --remote");
+        }
+    }
+    else if (remoteServer.resolve(remoteName, args) && !remoteServer.hasPort()) {
         args.error(u"missing UDP port number in --remote");
     }
 
@@ -273,10 +293,19 @@ bool ts::InputSwitcherArgs::loadArgs(DuckContext& duck, Args& args)
     UStringVector remotes;
     args.getValues(remotes, u"allow");
     allowedRemote.clear();
+    allowedRemote6.clear();
     for (const auto& it : remotes) {
-        const IPv4Address addr(it, args);
-        if (addr.hasAddress()) {
-            allowedRemote.insert(addr);
+        if (IPStringGeneration(it) == IP::v6) {
+            const IPv6Address addr(it, args);
+            if (addr.hasAddress()) {
+                allowedRemote6.insert(addr);
+            }
+        }
+        else {
+            const IPv4Address addr(it, args);
+            if (addr.hasAddress()) {
+                allowedRemote.insert(addr);
+            }
         }
     }
 
@@ -314,6 +343,23 @@ bool ts::InputSwitcherArgs::loadArgs(DuckContext& duck, Args& args)
 
 bool ts::InputSwitcherArgs::setEventUDP(const UString& destination, const UString& local, Report& report)
 {
+    eventUDP6.clear();
+    eventLocalInterface6 = 0;
+
+    if (!destination.empty() && IPStringGeneration(destination) == IP::v6) {
+        // IPv6 destination, the local interface is identified by its index.
+        eventUDP.clear();
+        eventLocalAddress.clear();
+        if (!eventUDP6.resolve(destination, report)) {
+            return false;
+        }
+        else if (!eventUDP6.hasAddress() || !eventUDP6.hasPort()) {
+            report.error(u"event reporting through UDP requires an IP address and a UDP port");
+            return false;
+        }
+        return GetIPv6InterfaceIndex(local, eventLocalInterface6, report);
+    }
+
     if (destination.empty()) {
         eventUDP.clear();
     }
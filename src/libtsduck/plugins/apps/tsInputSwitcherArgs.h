@@ -35,6 +35,7 @@
 #pragma once
 #include "tsPluginOptions.h"
 #include "tsIPv4SocketAddress.h"
+#include "tsIPv6SocketAddress.h"
 
 namespace ts {
 
@@ -62,11 +63,15 @@ namespace ts {
         UString             eventCommand;      //!< External shell command to run on an event.
         IPv4SocketAddress   eventUDP;          //!< Remote UDP socket address for event description.
         IPv4Address         eventLocalAddress; //!< Outgoing local interface for UDP event description.
+        IPv6SocketAddress   eventUDP6;         //!< Remote UDP socket address for event description, when using IPv6.
+        unsigned int        eventLocalInterface6; //!< Outgoing local interface index for UDP event description, when using IPv6.
         int                 eventTTL;          //!< Time-to-live socket option for event UDP.
         UString             eventUserData;     //!< User-defined data string in event messages.
         size_t              sockBuffer;        //!< Socket buffer size.
         IPv4SocketAddress   remoteServer;      //!< UDP server address for remote control.
         IPv4AddressSet      allowedRemote;     //!< Set of allowed remotes.
+        IPv6SocketAddress   remoteServer6;     //!< UDP server address for remote control, when using IPv6.
+        IPv6AddressSet      allowedRemote6;    //!< Set of allowed IPv6 remotes.
         MilliSecond         receiveTimeout;    //!< Receive timeout before switch (0=none).
         PluginOptionsVector inputs;            //!< Input plugins descriptions.
         PluginOptions       output;            //!< Output plugin description.
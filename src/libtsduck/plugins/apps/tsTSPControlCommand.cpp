@@ -56,6 +56,18 @@ ts::TSPControlCommand::TSPControlCommand(Report& report) :
 
     arg = command(u"list", u"List all running plugins", u"[options]", flags);
 
+    arg = command(u"stats", u"Display the packet statistics of all plugins", u"[options]", flags);
+    arg->setIntro(u"Display a snapshot of the number of packets and bitrate in each plugin. "
+                  u"The statistics are collected without interrupting the packet processing.");
+
+    arg = command(u"subscribe", u"Periodically display the packet statistics of all plugins", u"[options]", flags);
+    arg->setIntro(u"Periodically display a snapshot of the number of packets and bitrate in each plugin, "
+                  u"as with command 'stats', until the connection is closed or the tsp process terminates.");
+    arg->option(u"count", 'c', Args::POSITIVE);
+    arg->help(u"count", u"Stop after the specified number of snapshots. By default, never stop.");
+    arg->option(u"interval", 'i', Args::INTEGER, 0, 1, 100, 3600000);
+    arg->help(u"interval", u"milliseconds", u"Interval between two snapshots in milliseconds. The default is 1000 ms.");
+
     arg = command(u"suspend", u"Suspend a plugin", u"[options] plugin-index", flags);
     arg->setIntro(u"Suspend a plugin. When a packet processing plugin is suspended, "
                   u"the TS packets are directly passed from the previous to the next plugin, "
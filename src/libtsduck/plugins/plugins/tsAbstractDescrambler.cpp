@@ -29,10 +29,16 @@
 
 #include "tsAbstractDescrambler.h"
 #include "tsGuardCondition.h"
+#include "tsTSPacketWindow.h"
 
 // Stack usage required by this module in the ECM deciphering thread.
 #define ECM_THREAD_STACK_OVERHEAD (16  * 1024)
 
+namespace {
+    // With --threads, number of packets in the packet window.
+    constexpr size_t DESCRAMBLER_WINDOW_SIZE = 2048;
+}
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -45,6 +51,7 @@ ts::AbstractDescrambler::AbstractDescrambler(TSP* tsp_, const UString& descripti
     _abort(false),
     _synchronous(false),
     _swap_cw(false),
+    _threads(1),
     _scrambling(*tsp),
     _pids(),
     _service(duck, this),
@@ -55,7 +62,10 @@ ts::AbstractDescrambler::AbstractDescrambler(TSP* tsp_, const UString& descripti
     _mutex(),
     _ecm_to_do(),
     _ecm_thread(this),
-    _stop_thread(false)
+    _stop_thread(false),
+    _workers(),
+    _jobs(),
+    _failed_index(NPOS)
 {
     // We need to define character sets to specify service names.
     duck.defineArgsForCharset(*this);
@@ -91,6 +101,15 @@ ts::AbstractDescrambler::AbstractDescrambler(TSP* tsp_, const UString& descripti
     help(u"swap-cw",
         u"Swap even and odd control words from the ECM's. "
         u"Useful when a crazy ECMG inadvertently swapped the CW before generating the ECM.");
+
+    option(u"threads", 0, INTEGER, 0, 1, 1, 64);
+    help(u"threads",
+         u"Descramble the packets in parallel, using the specified number of threads. "
+         u"The packets are processed by windows of " + UString::Decimal(DESCRAMBLER_WINDOW_SIZE) + u" packets, "
+         u"which are distributed over the threads. Each thread uses its own copy of the control words. "
+         u"This option is useful on high bitrate services when the descrambling becomes the bottleneck. "
+         u"It is ignored when several fixed control words are specified. "
+         u"By default, the packets are descrambled one by one in the plugin thread.");
 }
 
 
@@ -105,11 +124,18 @@ bool ts::AbstractDescrambler::getOptions()
     _service.set(value(u""));
     _synchronous = present(u"synchronous") || !tsp->realtime();
     _swap_cw = present(u"swap-cw");
+    getIntValue(_threads, u"threads", 1);
     getIntValues(_pids, u"pid");
     if (!duck.loadArgs(*this) || !_scrambling.loadArgs(duck, *this)) {
         return false;
     }
 
+    // A list of fixed control words is used in sequence, the packets must be processed in order.
+    if (_threads > 1 && _scrambling.fixedCWCount() > 1) {
+        tsp->warning(u"--threads ignored with several fixed control words");
+        _threads = 1;
+    }
+
     // Descramble either a service or a list of PID's, not a mixture of them.
     if ((_use_service + _pids.any()) != 1) {
         tsp->error(u"specify either a service or a list of PID's");
@@ -154,7 +180,9 @@ ts::AbstractDescrambler::ECMStream::ECMStream(AbstractDescrambler* parent) :
     new_ecm(false),
     ecm(),
     cw_even(),
-    cw_odd()
+    cw_odd(),
+    cw_generation(0),
+    cw_current()
 {
 }
 
@@ -204,6 +232,14 @@ bool ts::AbstractDescrambler::start()
         _ecm_thread.start();
     }
 
+    // With --threads, create the descrambling threads.
+    _jobs.clear();
+    _workers.clear();
+    for (size_t i = 0; _threads > 1 && i < _threads; ++i) {
+        _workers.push_back(DescramblerThreadPtr(new DescramblerThread(this)));
+        _workers.back()->start();
+    }
+
     return true;
 }
 
@@ -225,6 +261,9 @@ bool ts::AbstractDescrambler::stop()
         _ecm_thread.waitForTermination();
     }
 
+    // Terminate the descrambling threads.
+    _workers.clear();
+
     _scrambling.stop();
     return true;
 }
@@ -238,6 +277,9 @@ void ts::AbstractDescrambler::handlePMT(const PMT& pmt, PID)
 {
     tsp->debug(u"PMT: service 0x%X, %d elementary streams", {pmt.service_id, pmt.streams.size()});
 
+    // With --threads, the previous packets must be descrambled with the previous scrambling type.
+    descrambleJobs();
+
     // Default scrambling is DVB-CSA2.
     uint8_t scrambling_type = SCRAMBLING_DVB_CSA2;
 
@@ -508,18 +550,180 @@ void ts::AbstractDescrambler::ECMThread::main()
 
 
 //----------------------------------------------------------------------------
-// Packet processing method
+// Descrambling threads (--threads).
+//----------------------------------------------------------------------------
+
+ts::AbstractDescrambler::DescramblerThread::DescramblerThread(AbstractDescrambler* parent) :
+    jobs(),
+    results(),
+    _parent(parent),
+    _engines(),
+    _packets()
+{
+}
+
+ts::AbstractDescrambler::DescramblerThread::~DescramblerThread()
+{
+    // Request the thread to terminate and wait for it.
+    jobs.enqueue(new JobRange{NPOS, 0});
+    waitForTermination();
+}
+
+// Get the descrambling engine for an ECM stream, with up-to-date CW.
+ts::TSScrambling& ts::AbstractDescrambler::DescramblerThread::engine(ECMStream* stream)
+{
+    // The model descrambler is not modified by the plugin thread while we run.
+    TSScrambling& model(stream == nullptr ? _parent->_scrambling : stream->scrambling);
+
+    // Create the engine the first time. With fixed CW, recreate it when the PMT changed the scrambling type.
+    EnginePtr& eng_ptr(_engines[stream]);
+    if (eng_ptr.isNull() || (stream == nullptr && eng_ptr->scrambling.scramblingType() != model.scramblingType())) {
+        eng_ptr = new Engine(model);
+    }
+    Engine& eng(*eng_ptr);
+
+    // Load the current CW of the ECM stream if they changed since last time.
+    if (stream != nullptr && eng.cw_generation != stream->cw_generation) {
+        eng.cw_generation = stream->cw_generation;
+        for (int parity = 0; parity < 2; ++parity) {
+            const CWData& cw(stream->cw_current[parity]);
+            if (!cw.cw.empty()) {
+                eng.scrambling.setScramblingType(cw.scrambling, false);
+                eng.scrambling.setCW(cw.cw, SC_EVEN_KEY | parity);
+            }
+        }
+    }
+    return eng.scrambling;
+}
+
+// Thread entry point.
+void ts::AbstractDescrambler::DescramblerThread::main()
+{
+    for (;;) {
+        MessageQueue<JobRange>::MessagePtr range;
+        jobs.dequeue(range);
+        if (range->first == NPOS) {
+            break;
+        }
+        MessageQueue<size_t>::MessagePtr failed(new size_t(NPOS));
+        const size_t end = range->first + range->count;
+        for (size_t first = range->first; first < end; ) {
+            // Descramble all consecutive packets from the same ECM stream at once.
+            ECMStream* const stream = _parent->_jobs[first].stream;
+            _packets.clear();
+            size_t last = first;
+            while (last < end && _parent->_jobs[last].stream == stream) {
+                _packets.push_back(_parent->_jobs[last++].packet);
+            }
+            if (!engine(stream).decrypt(_packets.data(), _packets.size())) {
+                *failed = _parent->_jobs[first].index;
+                break;
+            }
+            first = last;
+        }
+        results.enqueue(failed);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Descramble all pending jobs of the packet window and wait for completion.
 //----------------------------------------------------------------------------
 
+void ts::AbstractDescrambler::descrambleJobs()
+{
+    if (_workers.empty()) {
+        // No descrambling thread (e.g. --threads 1 with a forced packet window), descramble in the plugin thread.
+        for (const auto& job : _jobs) {
+            TSScrambling& scrambling(job.stream == nullptr ? _scrambling : job.stream->scrambling);
+            if (!scrambling.decrypt(*job.packet)) {
+                _failed_index = std::min(_failed_index, job.index);
+                break;
+            }
+        }
+        _jobs.clear();
+    }
+    else if (!_jobs.empty()) {
+
+        // Split the jobs in contiguous ranges, one per thread.
+        const size_t per_thread = (_jobs.size() + _workers.size() - 1) / _workers.size();
+        size_t active = 0;
+        for (size_t first = 0; first < _jobs.size(); first += per_thread) {
+            _workers[active++]->jobs.enqueue(new JobRange{first, std::min(per_thread, _jobs.size() - first)});
+        }
+
+        // Wait for all threads to complete.
+        for (size_t i = 0; i < active; ++i) {
+            MessageQueue<size_t>::MessagePtr failed;
+            _workers[i]->results.dequeue(failed);
+            _failed_index = std::min(_failed_index, *failed);
+        }
+        _jobs.clear();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Packet processing methods
+//----------------------------------------------------------------------------
+
+size_t ts::AbstractDescrambler::getPacketWindowSize()
+{
+    return _workers.empty() ? 0 : DESCRAMBLER_WINDOW_SIZE;
+}
+
 ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
+{
+    TSScrambling* scrambling = nullptr;
+    ECMStream* stream = nullptr;
+    const Status status = selectDescrambler(pkt, scrambling, stream);
+    return status != TSP_OK || scrambling == nullptr || scrambling->decrypt(pkt) ? status : TSP_END;
+}
+
+size_t ts::AbstractDescrambler::processPacketWindow(TSPacketWindow& win)
+{
+    // Analyze all packets in sequence and build the list of packets to descramble.
+    _jobs.clear();
+    _failed_index = NPOS;
+    size_t count = 0;
+    for (; count < win.size() && _failed_index == NPOS; ++count) {
+        TSPacket* pkt = win.packet(count);
+        if (pkt != nullptr) {
+            TSScrambling* scrambling = nullptr;
+            ECMStream* stream = nullptr;
+            if (selectDescrambler(*pkt, scrambling, stream) == TSP_END) {
+                break;
+            }
+            if (scrambling != nullptr) {
+                _jobs.push_back({count, pkt, stream});
+            }
+        }
+    }
+
+    // Descramble the remaining packets in parallel.
+    descrambleJobs();
+    return std::min(count, _failed_index);
+}
+
+
+//----------------------------------------------------------------------------
+// Analyze a packet and update the control words.
+//----------------------------------------------------------------------------
+
+ts::ProcessorPlugin::Status ts::AbstractDescrambler::selectDescrambler(TSPacket& pkt, TSScrambling*& scrambling, ECMStream*& stream)
 {
     const PID pid = pkt.getPID();
+    scrambling = nullptr;
+    stream = nullptr;
 
     // Descramble packets from fixed PID's using fixed control words.
     // If there is a user-specified list of PID's, we don't manage a service
     // and there is nothing else to do.
     if (_pids.any()) {
-        return !_pids.test(pid) || _scrambling.decrypt(pkt) ? TSP_OK : TSP_END;
+        if (_pids.test(pid)) {
+            scrambling = &_scrambling;
+        }
+        return TSP_OK;
     }
 
     // Filter sections to locate the service and grab ECM's.
@@ -541,7 +745,8 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
 
     // Without ECM's, we descramble using fixed control words.
     if (!_need_ecm) {
-        return _scrambling.decrypt(pkt) ? TSP_OK : TSP_END;
+        scrambling = &_scrambling;
+        return TSP_OK;
     }
 
     // Get PID context. If the PID is not known as a scrambled PID,
@@ -571,6 +776,9 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
     if ((scv == SC_EVEN_KEY && pecm->new_cw_even) || (scv == SC_ODD_KEY && pecm->new_cw_odd)) {
 
         // A new CW was deciphered.
+        // With --threads, the previous packets must be descrambled with the previous CW first.
+        descrambleJobs();
+
         // In asynchronous mode, the CW are accessed under mutex protection.
         if (!_synchronous) {
             _mutex.acquire();
@@ -580,19 +788,24 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
         if (scv == SC_EVEN_KEY) {
             pecm->scrambling.setScramblingType(pecm->cw_even.scrambling, false);
             pecm->scrambling.setCW(pecm->cw_even.cw, SC_EVEN_KEY);
+            pecm->cw_current[0] = pecm->cw_even;
             pecm->new_cw_even = false;
         }
         else {
             pecm->scrambling.setScramblingType(pecm->cw_odd.scrambling, false);
             pecm->scrambling.setCW(pecm->cw_odd.cw, SC_ODD_KEY);
+            pecm->cw_current[1] = pecm->cw_odd;
             pecm->new_cw_odd = false;
         }
+        pecm->cw_generation++;
 
         if (!_synchronous) {
             _mutex.release();
         }
     }
 
-    // Descramble the packet payload.
-    return pecm->scrambling.decrypt(pkt) ? TSP_OK : TSP_END;
+    // Descramble the packet payload using the CW from this ECM stream.
+    scrambling = &pecm->scrambling;
+    stream = pecm.pointer();
+    return TSP_OK;
 }
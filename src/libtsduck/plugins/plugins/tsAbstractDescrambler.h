@@ -41,6 +41,7 @@
 #include "tsCondition.h"
 #include "tsMutex.h"
 #include "tsThread.h"
+#include "tsMessageQueue.h"
 #include "tsMemory.h"
 
 namespace ts {
@@ -61,7 +62,9 @@ namespace ts {
         virtual bool getOptions() override;
         virtual bool start() override;
         virtual bool stop() override;
+        virtual size_t getPacketWindowSize() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual size_t processPacketWindow(TSPacketWindow&) override;
 
     protected:
         //!
@@ -227,6 +230,9 @@ namespace ts {
             CWData        cw_even;      // Last valid CW (even)
             CWData        cw_odd;       // Last valid CW (odd)
             // -- end of protected area --
+            // -- accessed by descrambling threads while the plugin thread waits for them --
+            uint32_t      cw_generation;   // Incremented each time a new CW is stored in the descrambler.
+            CWData        cw_current[2];   // CW currently stored in the descrambler (index 0 = even, 1 = odd).
         };
 
         typedef SafePtr<ECMStream, NullMutex> ECMStreamPtr;
@@ -248,6 +254,62 @@ namespace ts {
             AbstractDescrambler* _parent;
         };
 
+        // Descrambling of one packet by a descrambling thread (--threads).
+        class PacketJob
+        {
+        public:
+            size_t     index;   // Index of the packet in the packet window.
+            TSPacket*  packet;  // Packet to descramble.
+            ECMStream* stream;  // ECM stream providing the CW, null with fixed CW.
+        };
+        typedef std::vector<PacketJob> PacketJobVector;
+
+        // Range of packet jobs to process by a descrambling thread.
+        class JobRange
+        {
+        public:
+            size_t first;  // Index of first job in _jobs, NPOS to terminate the thread.
+            size_t count;  // Number of jobs.
+        };
+
+        // Descrambling thread (--threads).
+        class DescramblerThread : public Thread
+        {
+            TS_NOBUILD_NOCOPY(DescramblerThread);
+        public:
+            // Constructor and destructor.
+            DescramblerThread(AbstractDescrambler* parent);
+            virtual ~DescramblerThread() override;
+
+            // Ranges of jobs to process and corresponding results.
+            // The result is the window index of the first packet which cannot be descrambled, NPOS if none.
+            MessageQueue<JobRange> jobs;
+            MessageQueue<size_t>   results;
+
+        private:
+            // Descrambling engine with a private copy of the CW of an ECM stream.
+            class Engine
+            {
+                TS_NOBUILD_NOCOPY(Engine);
+            public:
+                Engine(const TSScrambling& model) : scrambling(model), cw_generation(0) {}
+                TSScrambling scrambling;     // Private descrambler.
+                uint32_t     cw_generation;  // Generation of the CW in the descrambler.
+            };
+            typedef SafePtr<Engine, NullMutex> EnginePtr;
+
+            AbstractDescrambler*                 _parent;   // Link to parent descrambler.
+            std::map<const ECMStream*, EnginePtr> _engines;  // Descrambling engines, indexed by ECM stream.
+            std::vector<TSPacket*>               _packets;  // Consecutive packets to descramble with the same engine.
+
+            // Get the descrambling engine for an ECM stream (null for fixed CW), with up-to-date CW.
+            TSScrambling& engine(ECMStream* stream);
+
+            // Thread entry point.
+            virtual void main() override;
+        };
+        typedef SafePtr<DescramblerThread, NullMutex> DescramblerThreadPtr;
+
         // Get the ECM stream for a PID, create it if non existent
         ECMStreamPtr getOrCreateECMStream(PID);
 
@@ -259,12 +321,21 @@ namespace ts {
         // Analyze a list of descriptors from the PMT, looking for ECM PID's
         void analyzeDescriptors(const DescriptorList& dlist, std::set<PID>& ecm_pids, uint8_t& scrambling);
 
+        // Analyze a packet and update the control words. Return the descrambler to use
+        // (null if the packet shall not be descrambled) and the corresponding ECM stream
+        // (null when using fixed control words).
+        Status selectDescrambler(TSPacket& pkt, TSScrambling*& scrambling, ECMStream*& stream);
+
+        // Descramble all pending jobs of the packet window, using the descrambling threads when there are some.
+        void descrambleJobs();
+
         // Abstract descrambler private data.
         bool               _use_service;       // Descramble a service (ie. not a specific list of PID's).
         bool               _need_ecm;          // We need to get control words from ECM's.
         bool               _abort;             // Error, abort asap.
         bool               _synchronous;       // Synchronous ECM deciphering.
         bool               _swap_cw;           // Swap even/odd CW from ECM.
+        size_t             _threads;           // Number of descrambling threads.
         TSScrambling       _scrambling;        // Default descrambling (used with fixed control words).
         PIDSet             _pids;              // Explicit PID's to descramble.
         ServiceDiscovery   _service;           // Service to descramble (by name, id or none).
@@ -278,5 +349,8 @@ namespace ts {
         // -- start of protected area --
         bool               _stop_thread;       // Terminate ECM processing thread
         // -- end of protected area --
+        std::vector<DescramblerThreadPtr> _workers;  // Descrambling threads (--threads).
+        PacketJobVector    _jobs;              // Pending packets to descramble in current window.
+        size_t             _failed_index;      // Window index of first packet which failed to descramble.
     };
 }
@@ -31,22 +31,74 @@
 #include "tsPluginRepository.h"
 #include "tsIPProtocols.h"
 #include "tsSysUtils.h"
+#include "tsRTPPacketView.h"
 
 TS_REGISTER_INPUT_PLUGIN(u"ip", ts::IPInputPlugin);
 
+namespace {
+    // Default RTP reordering latency when FEC is used.
+    constexpr ts::MilliSecond DEFAULT_FEC_LATENCY = 100;
+
+    // Default maximum difference of delay between the legs of a hitless merge.
+    constexpr ts::MilliSecond DEFAULT_MERGE_LATENCY = 50;
+}
+
 
 //----------------------------------------------------------------------------
 // Input constructor
 //----------------------------------------------------------------------------
 
 ts::IPInputPlugin::IPInputPlugin(TSP* tsp_) :
-    AbstractDatagramInputPlugin(tsp_, IP_MAX_PACKET_SIZE, u"Receive TS packets from UDP/IP, multicast or unicast", u"[options] [address:]port",
+    AbstractDatagramInputPlugin(tsp_, IP_MAX_PACKET_SIZE, u"Receive TS packets from UDP/IP, multicast or unicast", u"[options] [address:]port ...",
                                 u"kernel", u"A kernel-provided time-stamp for the packet, when available (Linux only)",
                                 true), // real-time network reception
     _sock(*tsp_)
 {
     // Add UDP receiver common options.
-    _sock.defineArgs(*this, true, true, false);
+    _sock.defineArgs(*this, true);
+
+    option(u"label-base", 0, INTEGER, 0, 1, 0, TSPacketLabelSet::MAX);
+    help(u"label-base",
+         u"Set a label on each input packet. "
+         u"Packets from the first [address:]port are tagged with the specified base label, "
+         u"packets from the second [address:]port with base label plus one, and so on. "
+         u"For a given [address:]port, if the computed label is above the maximum (" +
+         UString::Decimal(TSPacketLabelSet::MAX) + u"), its packets are not labelled. "
+         u"When several [address:]port are specified, all UDP streams are received in the same thread "
+         u"and the labels can be used to process each stream separately, using the option --only-label "
+         u"of packet processing plugins.");
+
+    option(u"fec");
+    help(u"fec",
+         u"Receive SMPTE 2022-1 FEC streams and recover lost RTP packets. "
+         u"For each [address:]port, the column FEC stream is received on port + " + UString::Decimal(RTP_FEC_COLUMN_PORT_OFFSET) +
+         u" and the row FEC stream, if any, on port + " + UString::Decimal(RTP_FEC_ROW_PORT_OFFSET) + u". "
+         u"This option implies RTP reordering, see option --rtp-latency.");
+
+    option(u"merge");
+    help(u"merge",
+         u"Merge the RTP streams from all [address:]port as redundant copies of the same stream, "
+         u"received over distinct network paths (SMPTE 2022-7 hitless merge). "
+         u"At least two [address:]port shall be specified. "
+         u"Each RTP packet is output once, from the first stream where it arrives. "
+         u"The packets which are lost on one stream are replaced by the same packets from the other streams. "
+         u"UDP datagrams which are not RTP packets are dropped. "
+         u"With --fec, the FEC recovery is applied on each stream before merging. "
+         u"The option --rtp-latency specifies the maximum difference of delay between the streams, "
+         u"the default is " + UString::Decimal(DEFAULT_MERGE_LATENCY) + u" milliseconds. "
+         u"With --label-base, all packets are tagged with the base label. "
+         u"Use --verbose to get the loss statistics of each stream at the end of the session.");
+
+    option(u"rtp-latency", 0, POSITIVE);
+    help(u"rtp-latency", u"milliseconds",
+         u"Reorder the received RTP packets according to their sequence numbers. "
+         u"Duplicated packets are removed. "
+         u"When a packet is missing, the next packets are held until the missing one arrives or is recovered using FEC, "
+         u"for at most the specified latency. After that delay, the missing packets are considered as lost. "
+         u"UDP datagrams which are not RTP packets are passed immediately. "
+         u"By default, the RTP packets are not reordered, except with options --fec and --merge where the default latency is " +
+         UString::Decimal(DEFAULT_FEC_LATENCY) + u" and " + UString::Decimal(DEFAULT_MERGE_LATENCY) + u" milliseconds respectively. "
+         u"With FEC, the latency shall be larger than the transmission time of a complete FEC matrix.");
 }
 
 
@@ -57,7 +109,22 @@ ts::IPInputPlugin::IPInputPlugin(TSP* tsp_) :
 bool ts::IPInputPlugin::getOptions()
 {
     // Get command line arguments for superclass and socket.
-    return AbstractDatagramInputPlugin::getOptions() && _sock.loadArgs(duck, *this);
+    getIntValue(_base_label, u"label-base", TSPacketLabelSet::MAX + 1);
+    _use_fec = present(u"fec");
+    _merge = present(u"merge");
+    getIntValue(_rtp_latency, u"rtp-latency", _use_fec ? DEFAULT_FEC_LATENCY : (_merge ? DEFAULT_MERGE_LATENCY : 0));
+
+    if (!AbstractDatagramInputPlugin::getOptions() || !_sock.loadArgs(duck, *this)) {
+        return false;
+    }
+    if (_merge && (_sock.count() < 2 || _sock.count() > RTPHitlessMerger::MAX_LEGS)) {
+        tsp->error(u"--merge requires from 2 to %d [address:]port", {RTPHitlessMerger::MAX_LEGS});
+        return false;
+    }
+
+    // Add the FEC receivers after the main ones.
+    _stream_count = _sock.count();
+    return !_use_fec || (_sock.addCompanions(duck, *this, RTP_FEC_COLUMN_PORT_OFFSET) && _sock.addCompanions(duck, *this, RTP_FEC_ROW_PORT_OFFSET));
 }
 
 
@@ -67,8 +134,24 @@ bool ts::IPInputPlugin::getOptions()
 
 bool ts::IPInputPlugin::start()
 {
-    // Initialize superclass and UDP socket.
-    return AbstractDatagramInputPlugin::start() && _sock.open(*tsp);
+    // Initialize RTP processing.
+    _last_index = _next_stream = 0;
+    _streams.clear();
+    if (_rtp_latency > 0) {
+        _streams.resize(_stream_count);
+        for (auto& st : _streams) {
+            st.jitter.setLatency(_rtp_latency);
+        }
+        if (_merge) {
+            _merger.setLegs(_stream_count);
+            _merger.setWindow(_rtp_latency);
+        }
+        _buffer.resize(IP_MAX_PACKET_SIZE);
+        _origin.getSystemTime();
+    }
+
+    // Initialize superclass and UDP socket. RTP processing needs to periodically wake up.
+    return AbstractDatagramInputPlugin::start() && _sock.open(*tsp, _rtp_latency > 0);
 }
 
 
@@ -78,6 +161,25 @@ bool ts::IPInputPlugin::start()
 
 bool ts::IPInputPlugin::stop()
 {
+    // Report RTP statistics.
+    for (size_t i = 0; i < _streams.size(); ++i) {
+        const RTPStream& st(_streams[i]);
+        if (_merge) {
+            tsp->verbose(u"stream %d: %'d RTP packets, %'d used in merged stream, %'d late, %'d lost",
+                         {i, _merger.receivedCount(i), _merger.usedCount(i), _merger.lateCount(i), _merger.lostCount(i)});
+        }
+        else {
+            tsp->verbose(u"stream %d: %'d RTP packets, %'d reordered, %'d duplicated, %'d late, %'d lost",
+                         {i, st.jitter.receivedCount(), st.jitter.reorderedCount(), st.jitter.duplicateCount(), st.jitter.lateCount(), st.jitter.lostCount()});
+        }
+        if (_use_fec) {
+            tsp->verbose(u"stream %d: %'d FEC packets, %'d recovered RTP packets, %'d unrecoverable FEC groups",
+                         {i, st.fec.fecCount(), st.fec.recoveredCount(), st.fec.unrecoverableCount()});
+        }
+    }
+    if (_merge) {
+        tsp->verbose(u"merged stream: %'d packets repaired from other streams, %'d lost on all streams", {_merger.repairedCount(), _merger.lostCount()});
+    }
     _sock.close(*tsp);
     return AbstractDatagramInputPlugin::stop();
 }
@@ -114,7 +216,144 @@ bool ts::IPInputPlugin::setReceiveTimeout(MilliSecond timeout)
 
 bool ts::IPInputPlugin::receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp)
 {
-    IPv4SocketAddress sender;
-    IPv4SocketAddress destination;
-    return _sock.receive(buffer, buffer_size, ret_size, sender, destination, tsp, *tsp, &timestamp);
+    if (_rtp_latency > 0) {
+        return receiveRTP(buffer, buffer_size, ret_size, timestamp);
+    }
+    else {
+        return _sock.receive(buffer, buffer_size, ret_size, _last_index, tsp, *tsp, &timestamp);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Add an RTP packet from a UDP stream in its reordering buffer or in the merger.
+//----------------------------------------------------------------------------
+
+void ts::IPInputPlugin::addRTP(size_t stream, const ByteBlockPtr& packet, MicroSecond arrival, MicroSecond timestamp)
+{
+    if (_merge) {
+        _merger.add(stream, packet, arrival, timestamp);
+    }
+    else {
+        _streams[stream].jitter.add(packet, arrival, timestamp);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the next ready RTP packet from the reordering buffers or from the merger.
+//----------------------------------------------------------------------------
+
+bool ts::IPInputPlugin::getRTP(ByteBlockPtr& packet, MicroSecond& timestamp, MicroSecond now, MicroSecond& deadline)
+{
+    // With a hitless merge, there is only one output stream.
+    if (_merge) {
+        _last_index = 0;
+        deadline = _merger.nextDeadline();
+        return _merger.get(packet, timestamp, now);
+    }
+
+    // Service all streams in turn.
+    deadline = -1;
+    for (size_t n = 0; n < _streams.size(); ++n) {
+        const size_t i = (_next_stream + n) % _streams.size();
+        if (_streams[i].jitter.get(packet, timestamp, now)) {
+            _next_stream = (i + 1) % _streams.size();
+            _last_index = i;
+            return true;
+        }
+        const MicroSecond d = _streams[i].jitter.nextDeadline();
+        if (d >= 0 && (deadline < 0 || d < deadline)) {
+            deadline = d;
+        }
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Datagram reception with RTP reordering, FEC recovery and hitless merge.
+//----------------------------------------------------------------------------
+
+bool ts::IPInputPlugin::receiveRTP(uint8_t* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp)
+{
+    std::vector<ByteBlockPtr> recovered;
+
+    for (;;) {
+        // Return the next ready RTP packet.
+        MicroSecond now = currentTime();
+        MicroSecond deadline = -1;
+        ByteBlockPtr packet;
+        if (getRTP(packet, timestamp, now, deadline)) {
+            ret_size = std::min(packet->size(), buffer_size);
+            ::memcpy(buffer, packet->data(), ret_size);
+            return true;
+        }
+
+        // Wait for a datagram, at most until the next held packet must be released.
+        const MilliSecond max_wait = deadline < 0 ? 0 : std::max<MilliSecond>(1, (deadline - now + MicroSecPerMilliSec - 1) / MicroSecPerMilliSec);
+        size_t size = 0;
+        size_t index = 0;
+        MicroSecond tstamp = -1;
+        if (!_sock.receive(_buffer.data(), _buffer.size(), size, index, tsp, *tsp, &tstamp, max_wait)) {
+            return false;
+        }
+        if (size == 0) {
+            continue; // maximum waiting time expired
+        }
+
+        // FEC receivers are after the main ones. Main stream index is the same.
+        const size_t stream = index % _stream_count;
+        RTPStream& st(_streams[stream]);
+        if (index >= _stream_count) {
+            st.fec.addFEC(ByteBlockPtr(new ByteBlock(_buffer.data(), size)));
+        }
+        else if (!RTPPacketView(_buffer.data(), size).isValid()) {
+            // Not an RTP packet, pass it immediately. In a merge, it cannot be deduplicated, drop it.
+            if (_merge) {
+                continue;
+            }
+            _last_index = stream;
+            ret_size = std::min(size, buffer_size);
+            ::memcpy(buffer, _buffer.data(), ret_size);
+            timestamp = tstamp;
+            return true;
+        }
+        else {
+            packet = ByteBlockPtr(new ByteBlock(_buffer.data(), size));
+            addRTP(stream, packet, currentTime(), tstamp);
+            if (_use_fec) {
+                st.fec.addMedia(packet);
+            }
+        }
+
+        // Try to recover missing packets.
+        if (_use_fec) {
+            recovered.clear();
+            st.fec.recover(recovered);
+            now = currentTime();
+            for (const auto& rec : recovered) {
+                addRTP(stream, rec, now, -1);
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Input method.
+//----------------------------------------------------------------------------
+
+size_t ts::IPInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
+{
+    const size_t count = AbstractDatagramInputPlugin::receive(buffer, pkt_data, max_packets);
+
+    // All returned packets come from the last received datagram. Mark them with the label of the receiver.
+    const size_t label = _base_label + _last_index;
+    if (label <= TSPacketLabelSet::MAX) {
+        for (size_t n = 0; n < count; ++n) {
+            pkt_data[n].setLabel(label);
+        }
+    }
+    return count;
 }
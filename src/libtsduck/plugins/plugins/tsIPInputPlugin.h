@@ -34,7 +34,11 @@
 
 #pragma once
 #include "tsAbstractDatagramInputPlugin.h"
-#include "tsUDPReceiver.h"
+#include "tsUDPReceiverSet.h"
+#include "tsRTPJitterBuffer.h"
+#include "tsRTPHitlessMerger.h"
+#include "tsRTPFECDecoder.h"
+#include "tsMonotonic.h"
 
 namespace ts {
     //!
@@ -57,12 +61,44 @@ namespace ts {
         virtual bool stop() override;
         virtual bool abortInput() override;
         virtual bool setReceiveTimeout(MilliSecond timeout) override;
+        virtual size_t receive(TSPacket*, TSPacketMetadata*, size_t) override;
 
     protected:
         // Implementation of AbstractDatagramInputPlugin.
         virtual bool receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp) override;
 
     private:
-        UDPReceiver _sock; // Incoming socket with associated command line options.
+        // RTP processing context of one UDP stream.
+        class RTPStream
+        {
+        public:
+            RTPJitterBuffer jitter {};  // Reordering buffer.
+            RTPFECDecoder   fec {};     // SMPTE 2022-1 FEC decoder.
+        };
+
+        UDPReceiverSet         _sock;                // Incoming sockets with associated command line options.
+        size_t                 _base_label {0};      // Label of packets from first receiver, next receivers use next labels.
+        size_t                 _last_index {0};      // Index of stream of last datagram.
+        MilliSecond            _rtp_latency {0};     // RTP reordering latency, no RTP processing if zero.
+        bool                   _use_fec {false};     // Receive SMPTE 2022-1 FEC streams.
+        bool                   _merge {false};       // Merge all UDP streams as redundant copies of the same RTP stream.
+        size_t                 _stream_count {0};    // Number of UDP streams from the command line.
+        size_t                 _next_stream {0};     // Next stream to check for ready RTP packets.
+        Monotonic              _origin {};           // Time origin for RTP processing.
+        ByteBlock              _buffer {};           // Reception buffer for RTP processing.
+        std::vector<RTPStream> _streams {};          // RTP processing contexts, one per UDP stream.
+        RTPHitlessMerger       _merger {};           // SMPTE 2022-7 merger of all UDP streams.
+
+        // Current time in microseconds for RTP processing.
+        MicroSecond currentTime() const { return (Monotonic(true) - _origin) / NanoSecPerMicroSec; }
+
+        // Datagram reception with RTP reordering, FEC recovery and hitless merge.
+        bool receiveRTP(uint8_t* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp);
+
+        // Add an RTP packet from a UDP stream in its reordering buffer or in the merger.
+        void addRTP(size_t stream, const ByteBlockPtr& packet, MicroSecond arrival, MicroSecond timestamp);
+
+        // Get the next ready RTP packet from the reordering buffers or from the merger.
+        bool getRTP(ByteBlockPtr& packet, MicroSecond& timestamp, MicroSecond now, MicroSecond& deadline);
     };
 }
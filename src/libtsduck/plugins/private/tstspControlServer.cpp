@@ -34,7 +34,20 @@
 #include "tsReportBuffer.h"
 #include "tsTelnetConnection.h"
 #include "tsGuardMutex.h"
+#include "tsGuardCondition.h"
 #include "tsSysUtils.h"
+#include "tsTime.h"
+
+namespace {
+    // Maximum number of simultaneous client sessions.
+    constexpr size_t MAX_SESSIONS = 16;
+
+    // Stack size of client session threads.
+    constexpr size_t SESSION_STACK_SIZE = 128 * 1024;
+
+    // Default interval between two snapshots in the subscribe command.
+    constexpr ts::MilliSecond DEFAULT_SUBSCRIBE_INTERVAL = 1000;
+}
 
 
 //----------------------------------------------------------------------------
@@ -46,12 +59,15 @@ ts::tsp::ControlServer::ControlServer(TSProcessorArgs& options, Report& log, Mut
     _terminate(false),
     _options(options),
     _log(log, u"control commands: "),
-    _reference(_log),
     _server(),
     _mutex(global_mutex),
     _input(input),
     _output(nullptr),
-    _plugins()
+    _plugins(),
+    _command_mutex(),
+    _sessions_mutex(),
+    _sessions_cond(),
+    _sessions()
 {
     // Locate output plugin, count packet processor plugins.
     if (_input != nullptr) {
@@ -70,14 +86,6 @@ ts::tsp::ControlServer::ControlServer(TSProcessorArgs& options, Report& log, Mut
         }
     }
     _log.debug(u"found %d packet processor plugins", {_plugins.size()});
-
-    // Register command handlers.
-    _reference.setCommandLineHandler(this, &ControlServer::executeExit, u"exit");
-    _reference.setCommandLineHandler(this, &ControlServer::executeSetLog, u"set-log");
-    _reference.setCommandLineHandler(this, &ControlServer::executeList, u"list");
-    _reference.setCommandLineHandler(this, &ControlServer::executeSuspend, u"suspend");
-    _reference.setCommandLineHandler(this, &ControlServer::executeResume, u"resume");
-    _reference.setCommandLineHandler(this, &ControlServer::executeRestart, u"restart");
 }
 
 ts::tsp::ControlServer::~ControlServer()
@@ -108,7 +116,7 @@ bool ts::tsp::ControlServer::open()
         if (!_server.open(_log) ||
             !_server.reusePort(_options.control_reuse, _log) ||
             !_server.bind(addr, _log) ||
-            !_server.listen(5, _log))
+            !_server.listen(int(MAX_SESSIONS), _log))
         {
             _server.close(NULLREP);
             _log.error(u"error starting TCP server for control commands.");
@@ -130,6 +138,9 @@ void ts::tsp::ControlServer::close()
 
         // Wait for the termination of the thread.
         waitForTermination();
+
+        // Terminate all client sessions.
+        cleanupSessions(true);
         _is_open = false;
     }
 }
@@ -146,36 +157,42 @@ void ts::tsp::ControlServer::main()
     // Get accept errors in a buffer since some errors are normal.
     ReportBuffer<NullMutex> error(_log.maxSeverity());
 
-    // Client address and connection.
-    IPv4SocketAddress source;
-    TelnetConnection conn;
-    UString line;
-
-    // Loop on incoming connections.
-    // Since the commands are expected to be short, treat only one at a time.
-    while (_server.accept(conn, source, error)) {
-
-        // Filter allowed sources.
-        // Set receive timeout on the connection and read one line.
-        if (std::find(_options.control_sources.begin(), _options.control_sources.end(), source.address()) == _options.control_sources.end()) {
-            _log.warning(u"connection attempt from unauthorized source %s (ignored)", {source});
-            conn.sendLine("error: client address is not authorized", _log);
+    // Loop on incoming connections. Each connection is handled in its own session thread.
+    for (;;) {
+        Session* session = new Session(*this);
+        if (!_server.accept(session->conn, session->source, error)) {
+            delete session;
+            break;
         }
-        else if (conn.setReceiveTimeout(_options.control_timeout, _log) && conn.receiveLine(line, nullptr, _log)) {
-            _log.verbose(u"received from %s: %s", {source, line});
 
-            // Reset the severity of the connection before analysing the line.
-            // A previous analysis may have used --verbose or --debug.
-            conn.setMaxSeverity(Severity::Info);
+        // Cleanup previously terminated sessions.
+        cleanupSessions(false);
 
-            // Analyze the command, return errors on the client connection.
-            if (_reference.processCommand(line, &conn) != CommandStatus::SUCCESS) {
-                conn.error(u"invalid tsp control command: %s", {line});
+        // Filter allowed sources and limit the number of sessions.
+        bool started = false;
+        if (std::find(_options.control_sources.begin(), _options.control_sources.end(), session->source.address()) == _options.control_sources.end()) {
+            _log.warning(u"connection attempt from unauthorized source %s (ignored)", {session->source});
+            session->conn.sendLine("error: client address is not authorized", _log);
+        }
+        else {
+            GuardMutex lock(_sessions_mutex);
+            if (_sessions.size() >= MAX_SESSIONS) {
+                _log.warning(u"too many control sessions, rejecting connection from %s", {session->source});
+                session->conn.sendLine("error: too many control sessions", _log);
+            }
+            else {
+                _sessions.push_back(session);
+                started = session->start();
+                if (!started) {
+                    _sessions.pop_back();
+                }
             }
         }
-
-        conn.closeWriter(_log);
-        conn.close(_log);
+        if (!started) {
+            session->conn.closeWriter(_log);
+            session->conn.close(_log);
+            delete session;
+        }
     }
 
     // If termination was requested, receive error is not an error.
@@ -186,12 +203,165 @@ void ts::tsp::ControlServer::main()
 }
 
 
+//----------------------------------------------------------------------------
+// Cleanup terminated sessions.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ControlServer::cleanupSessions(bool all)
+{
+    SessionList terminated;
+    {
+        GuardCondition lock(_sessions_mutex, _sessions_cond);
+        for (auto it = _sessions.begin(); it != _sessions.end(); ) {
+            if (all || (*it)->done) {
+                if (all) {
+                    // Break the connection to unblock the session thread.
+                    (*it)->conn.disconnect(NULLREP);
+                }
+                terminated.push_back(*it);
+                it = _sessions.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        // Wake up sessions which wait in a subscription.
+        if (all) {
+            lock.signal();
+        }
+    }
+
+    // Wait for the termination of the threads outside the mutex.
+    for (auto session : terminated) {
+        delete session;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Client session.
+//----------------------------------------------------------------------------
+
+ts::tsp::ControlServer::Session::Session(ControlServer& server) :
+    Thread(ThreadAttributes().setStackSize(SESSION_STACK_SIZE)),
+    conn(),
+    source(),
+    done(false),
+    _server(server),
+    _command(server._log)
+{
+    // Register command handlers. Most commands are handled by the server.
+    _command.setCommandLineHandler(&_server, &ControlServer::executeExit, u"exit");
+    _command.setCommandLineHandler(&_server, &ControlServer::executeSetLog, u"set-log");
+    _command.setCommandLineHandler(&_server, &ControlServer::executeList, u"list");
+    _command.setCommandLineHandler(&_server, &ControlServer::executeStats, u"stats");
+    _command.setCommandLineHandler(&_server, &ControlServer::executeSuspend, u"suspend");
+    _command.setCommandLineHandler(&_server, &ControlServer::executeResume, u"resume");
+    _command.setCommandLineHandler(&_server, &ControlServer::executeRestart, u"restart");
+    _command.setCommandLineHandler(this, &Session::executeSubscribe, u"subscribe");
+}
+
+ts::tsp::ControlServer::Session::~Session()
+{
+    waitForTermination();
+}
+
+void ts::tsp::ControlServer::Session::main()
+{
+    UString line;
+    Report& log(_server._log);
+
+    // Set receive timeout on the connection and read one line.
+    if (conn.setReceiveTimeout(_server._options.control_timeout, log) && conn.receiveLine(line, nullptr, log)) {
+        log.verbose(u"received from %s: %s", {source, line});
+
+        // Reset the severity of the connection before analysing the line.
+        conn.setMaxSeverity(Severity::Info);
+
+        // Analyze the command, return errors on the client connection.
+        if (_command.processCommand(line, &conn) != CommandStatus::SUCCESS) {
+            conn.error(u"invalid tsp control command: %s", {line});
+        }
+    }
+
+    conn.closeWriter(NULLREP);
+    conn.close(NULLREP);
+    done = true;
+}
+
+
+//----------------------------------------------------------------------------
+// Subscribe command: periodically send statistics until disconnection.
+//----------------------------------------------------------------------------
+
+ts::CommandStatus ts::tsp::ControlServer::Session::executeSubscribe(const UString& command, Args& args)
+{
+    const MilliSecond interval = args.intValue<MilliSecond>(u"interval", DEFAULT_SUBSCRIBE_INTERVAL);
+    const size_t count = args.intValue<size_t>(u"count", 0);
+    const bool verbose = args.verbose();
+    UStringVector lines;
+
+    for (size_t iter = 0; !_server._terminate && (count == 0 || iter < count); ++iter) {
+        // Wait between two snapshots, unless the server terminates.
+        if (iter > 0) {
+            GuardCondition lock(_server._sessions_mutex, _server._sessions_cond);
+            if (!_server._terminate) {
+                lock.waitCondition(interval);
+            }
+            if (_server._terminate) {
+                break;
+            }
+        }
+
+        // Send a snapshot, stop when the client disconnects.
+        _server.getStatistics(lines, verbose);
+        bool ok = conn.sendLine(Time::CurrentLocalTime().format(Time::DATETIME), NULLREP);
+        for (size_t i = 0; ok && i < lines.size(); ++i) {
+            ok = conn.sendLine(lines[i], NULLREP);
+        }
+        if (!ok) {
+            break;
+        }
+    }
+    return CommandStatus::SUCCESS;
+}
+
+
+//----------------------------------------------------------------------------
+// Build a snapshot of all plugins statistics.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ControlServer::getStatistics(UStringVector& lines, bool verbose) const
+{
+    // The counters are published by each plugin thread. Copying them does not use
+    // the global mutex and never stalls the packet processing.
+    lines.clear();
+    PluginExecutor* plugin = _input;
+    PluginExecutor::Status status;
+    size_t index = 0;
+    do {
+        const UChar type = plugin == _input ? u'I' : (plugin == _output ? u'O' : u'P');
+        plugin->getStatus(status);
+        UString line(UString::Format(u"%2d: -%c %-12s packets: %'d, bitrate: %'d b/s", {index, type, plugin->pluginName(), status.plugin_packets, status.bitrate}));
+        if (verbose) {
+            line.format(u", thread packets: %'d", {status.thread_packets});
+        }
+        if (plugin->getSuspended()) {
+            line.append(u" (suspended)");
+        }
+        lines.push_back(line);
+        index++;
+    } while ((plugin = plugin->ringNext<PluginExecutor>()) != _input);
+}
+
+
 //----------------------------------------------------------------------------
 // Exit command.
 //----------------------------------------------------------------------------
 
 ts::CommandStatus ts::tsp::ControlServer::executeExit(const UString& command, Args& args)
 {
+    GuardMutex lock(_command_mutex);
     if (args.present(u"abort")) {
         // Immediate exit.
         ::exit(EXIT_FAILURE);
@@ -215,6 +385,7 @@ ts::CommandStatus ts::tsp::ControlServer::executeExit(const UString& command, Ar
 
 ts::CommandStatus ts::tsp::ControlServer::executeSetLog(const UString& command, Args& args)
 {
+    GuardMutex cmd_lock(_command_mutex);
     const int level = args.intValue(u"", Severity::Info);
 
     // Set log severity of the main logger.
@@ -244,12 +415,15 @@ ts::CommandStatus ts::tsp::ControlServer::executeList(const UString& command, Ar
         args.info(u"");
     }
 
-    listOnePlugin(0, u'I', _input, args);
+    // A plugin can be concurrently restarted by another session. Its command line is
+    // published by the plugin thread, the global mutex is not used.
+    const bool verbose = args.verbose();
+    args.info(listOnePlugin(0, u'I', _input, verbose));
     size_t index = 1;
     for (size_t i = 0; i < _plugins.size(); ++i) {
-        listOnePlugin(index++, u'P', _plugins[i], args);
+        args.info(listOnePlugin(index++, u'P', _plugins[i], verbose));
     }
-    listOnePlugin(index, u'O', _output, args);
+    args.info(listOnePlugin(index, u'O', _output, verbose));
 
     if (args.verbose()) {
         args.info(u"");
@@ -257,15 +431,28 @@ ts::CommandStatus ts::tsp::ControlServer::executeList(const UString& command, Ar
     return CommandStatus::SUCCESS;
 }
 
-void ts::tsp::ControlServer::listOnePlugin(size_t index, UChar type, PluginExecutor* plugin, Report& report)
+ts::CommandStatus ts::tsp::ControlServer::executeStats(const UString& command, Args& args)
+{
+    UStringVector lines;
+    getStatistics(lines, args.verbose());
+    for (const auto& line : lines) {
+        args.info(line);
+    }
+    return CommandStatus::SUCCESS;
+}
+
+ts::UString ts::tsp::ControlServer::listOnePlugin(size_t index, UChar type, PluginExecutor* plugin, bool verbose) const
 {
-    const bool verbose = report.verbose();
     const bool suspended = plugin->getSuspended();
-    report.info(u"%2d: %s-%c %s", {
-                index,
-                verbose && suspended ? u"(suspended) " : u"",
-                type,
-                verbose ? plugin->plugin()->commandLine() : plugin->pluginName() });
+    PluginExecutor::Status status;
+    if (verbose) {
+        plugin->getStatus(status);
+    }
+    return UString::Format(u"%2d: %s-%c %s", {
+                           index,
+                           verbose && suspended ? u"(suspended) " : u"",
+                           type,
+                           verbose ? status.command_line : plugin->pluginName() });
 }
 
 
@@ -285,6 +472,7 @@ ts::CommandStatus ts::tsp::ControlServer::executeResume(const UString& command,
 
 ts::CommandStatus ts::tsp::ControlServer::executeSuspendResume(bool state, Args& args)
 {
+    GuardMutex lock(_command_mutex);
     const size_t index = args.intValue<size_t>(u"");
     if (index > 0 && index <= _plugins.size()) {
         _plugins[index-1]->setSuspended(state);
@@ -340,6 +528,7 @@ ts::CommandStatus ts::tsp::ControlServer::executeRestart(const UString& command,
     }
 
     // Restart the plugin.
+    GuardMutex lock(_command_mutex);
     if (same) {
         plugin->restart(args);
     }
@@ -40,7 +40,9 @@
 #include "tsTSPControlCommand.h"
 #include "tsThread.h"
 #include "tsMutex.h"
+#include "tsCondition.h"
 #include "tsTCPServer.h"
+#include "tsTelnetConnection.h"
 #include "tsReportWithPrefix.h"
 
 namespace ts {
@@ -50,6 +52,12 @@ namespace ts {
         //! This class is internal to the TSDuck library and cannot be called by applications.
         //! @ingroup plugin
         //!
+        //! Several clients can be simultaneously connected. Each client connection is handled
+        //! in its own thread so that a slow client does not delay the others. The commands
+        //! which modify the state of the plugins are serialized. The read-only commands such
+        //! as "list", "stats" or "subscribe" use the state which is published by each plugin
+        //! thread and never lock the packet processing.
+        //!
         class ControlServer : public CommandLineHandler, private Thread
         {
             TS_NOBUILD_NOCOPY(ControlServer);
@@ -80,25 +88,55 @@ namespace ts {
             void close();
 
         private:
+            class Session;
+            typedef std::list<Session*> SessionList;
+
             volatile bool     _is_open;
             volatile bool     _terminate;
             TSProcessorArgs&  _options;
             ReportWithPrefix  _log;
-            TSPControlCommand _reference;
             TCPServer         _server;
             Mutex&            _mutex;
             InputExecutor*    _input;
             OutputExecutor*   _output;
             std::vector<ProcessorExecutor*> _plugins;  // Packet processing plugins
+            Mutex             _command_mutex;   // Serialize the commands which modify the state of plugins.
+            Mutex             _sessions_mutex;  // Protect the list of sessions.
+            Condition         _sessions_cond;   // Signaled on termination, wake up waiting sessions.
+            SessionList       _sessions;        // Active client sessions.
+
+            // A client session, handled in its own thread.
+            class Session : public CommandLineHandler, public Thread
+            {
+                TS_NOBUILD_NOCOPY(Session);
+            public:
+                Session(ControlServer& server);
+                virtual ~Session() override;
+                TelnetConnection  conn;
+                IPv4SocketAddress source;
+                volatile bool     done;
+            private:
+                ControlServer&    _server;
+                TSPControlCommand _command;
+                virtual void main() override;
+                CommandStatus executeSubscribe(const UString&, Args&);
+            };
 
             // Implementation of Thread.
             virtual void main() override;
 
+            // Cleanup terminated sessions. When all is true, terminate all sessions.
+            void cleanupSessions(bool all);
+
+            // Build a snapshot of all plugins statistics, without locking the packet processing.
+            void getStatistics(UStringVector& lines, bool verbose) const;
+
             // Command handlers.
             CommandStatus executeExit(const UString&, Args&);
             CommandStatus executeSetLog(const UString&, Args&);
             CommandStatus executeList(const UString&, Args&);
-            void listOnePlugin(size_t index, UChar type, PluginExecutor* plugin, Report& report);
+            CommandStatus executeStats(const UString&, Args&);
+            UString listOnePlugin(size_t index, UChar type, PluginExecutor* plugin, bool verbose) const;
             CommandStatus executeSuspend(const UString&, Args&);
             CommandStatus executeResume(const UString&, Args&);
             CommandStatus executeSuspendResume(bool state, Args&);
@@ -58,7 +58,9 @@ ts::tsp::PluginExecutor::PluginExecutor(const TSProcessorArgs& options,
     _bitrate(0),
     _br_confidence(BitRateConfidence::LOW),
     _restart(false),
-    _restart_data()
+    _restart_data(),
+    _status_mutex(),
+    _status()
 {
     // Preset common default options.
     if (plugin() != nullptr) {
@@ -142,6 +144,29 @@ void ts::tsp::PluginExecutor::initBuffer(PacketBuffer*         buffer,
     _br_confidence = br_confidence;
     _tsp_bitrate = bitrate;
     _tsp_bitrate_confidence = br_confidence;
+    publishStatus(true);
+}
+
+
+//----------------------------------------------------------------------------
+// Publish and get the state of the plugin.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::publishStatus(bool command_line)
+{
+    GuardMutex lock(_status_mutex);
+    if (command_line) {
+        _status.command_line = plugin()->commandLine();
+    }
+    _status.plugin_packets = pluginPackets();
+    _status.thread_packets = totalPacketsInThread();
+    _status.bitrate = bitrate();
+}
+
+void ts::tsp::PluginExecutor::getStatus(Status& status) const
+{
+    GuardMutex lock(_status_mutex);
+    status = _status;
 }
 
 
@@ -155,6 +180,9 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, const BitRate& bitrate,
 
     log(10, u"passPackets(count = %'d, bitrate = %'d, input_end = %s, aborted = %s)", {count, bitrate, input_end, aborted});
 
+    // Publish the counters of the plugin for the control server, outside the global mutex.
+    publishStatus(false);
+
     // We access data under the protection of the global mutex.
     GuardMutex lock(_global_mutex);
 
@@ -399,6 +427,9 @@ bool ts::tsp::PluginExecutor::processPendingRestart(bool& restarted)
     _restart = false;
     _restart_data.clear();
 
+    // The command line and the counters of the plugin have changed.
+    publishStatus(true);
+
     debug(u"restarted plugin %s, status: %s", {pluginName(), success});
     return success;
 }
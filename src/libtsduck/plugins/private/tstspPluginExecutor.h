@@ -145,6 +145,26 @@ namespace ts {
             //!
             void restart(Report& report);
 
+            //!
+            //! Snapshot of the state of the plugin, as published by the plugin thread.
+            //!
+            class Status
+            {
+            public:
+                UString       command_line {};     //!< Command line of the plugin.
+                PacketCounter plugin_packets = 0;  //!< Number of packets processed by the plugin object.
+                PacketCounter thread_packets = 0;  //!< Number of packets processed in the plugin thread.
+                BitRate       bitrate = 0;         //!< Input bitrate of the plugin.
+            };
+
+            //!
+            //! Get the last state of the plugin, as published by the plugin thread.
+            //! This method can be called from any thread. It does not use the global mutex
+            //! and never waits for the packet processing.
+            //! @param [out] status Last published state of the plugin.
+            //!
+            void getStatus(Status& status) const;
+
             // Implementation of TSP virtual methods.
             virtual size_t pluginCount() const override;
             virtual void signalPluginEvent(uint32_t event_code, Object* plugin_data = nullptr) const override;
@@ -237,6 +257,14 @@ namespace ts {
             bool              _restart;        // Restart the plugin asap using _restart_data
             RestartDataPtr    _restart_data;   // How to restart the plugin
 
+            // Last published state of the plugin, protected by its own mutex, not the global mutex.
+            mutable Mutex     _status_mutex;
+            Status            _status;
+
+            // Publish the state of the plugin. Called in the plugin thread or before it starts.
+            // The command line is updated only when specified (it is modified on restart only).
+            void publishStatus(bool command_line);
+
             // Description of a restart operation.
             class RestartData
             {
@@ -62,7 +62,12 @@ ts::tsswitch::CommandListener::~CommandListener()
 bool ts::tsswitch::CommandListener::open()
 {
     // Set command line parameters.
-    _sock.setParameters(_opt.remoteServer, _opt.reusePort, _opt.sockBuffer);
+    if (_opt.remoteServer6.hasPort()) {
+        _sock.setParameters(_opt.remoteServer6, _opt.reusePort, _opt.sockBuffer);
+    }
+    else {
+        _sock.setParameters(_opt.remoteServer, _opt.reusePort, _opt.sockBuffer);
+    }
 
     // Open the UDP receiver and start the thread.
     return _sock.open(_log) && start();
@@ -86,17 +91,17 @@ void ts::tsswitch::CommandListener::main()
 
     char inbuf[1024];
     size_t insize = 0;
-    IPv4SocketAddress sender;
-    IPv4SocketAddress destination;
+    UString sender;
+    bool allowed = false;
 
     // Get receive errors in a buffer since some errors are normal.
     ReportBuffer<NullMutex> error(_log.maxSeverity());
 
     // Loop on incoming messages.
-    while (_sock.receive(inbuf, sizeof(inbuf), insize, sender, destination, nullptr, error)) {
+    while (receiveCommand(inbuf, sizeof(inbuf), insize, sender, allowed, error)) {
 
         // Filter out unauthorized remote systems.
-        if (!_opt.allowedRemote.empty() && !Contains(_opt.allowedRemote, sender)) {
+        if (!allowed) {
             _log.warning(u"rejected remote command from unauthorized host %s", {sender});
             continue;
         }
@@ -143,3 +148,34 @@ void ts::tsswitch::CommandListener::main()
     }
     _log.debug(u"UDP server thread completed");
 }
+
+
+//----------------------------------------------------------------------------
+// Receive one command message, IPv4 or IPv6.
+//----------------------------------------------------------------------------
+
+bool ts::tsswitch::CommandListener::receiveCommand(char* buffer, size_t buffer_size, size_t& ret_size, UString& sender, bool& allowed, Report& report)
+{
+    // When no allowed remote is specified, all remote commands are accepted.
+    const bool all = _opt.allowedRemote.empty() && _opt.allowedRemote6.empty();
+
+    if (_sock.generation() == IP::v6) {
+        IPv6SocketAddress source;
+        IPv6SocketAddress destination;
+        if (!_sock.receive(buffer, buffer_size, ret_size, source, destination, nullptr, report)) {
+            return false;
+        }
+        sender = source.toString();
+        allowed = all || Contains(_opt.allowedRemote6, IPv6Address(source));
+    }
+    else {
+        IPv4SocketAddress source;
+        IPv4SocketAddress destination;
+        if (!_sock.receive(buffer, buffer_size, ret_size, source, destination, nullptr, report)) {
+            return false;
+        }
+        sender = source.toString();
+        allowed = all || Contains(_opt.allowedRemote, IPv4Address(source));
+    }
+    return true;
+}
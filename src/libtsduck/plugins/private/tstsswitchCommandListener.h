@@ -84,6 +84,9 @@ namespace ts {
 
             // Implementation of Thread.
             virtual void main() override;
+
+            // Receive one command message. Return the sender as a string and indicate if the sender is allowed.
+            bool receiveCommand(char* buffer, size_t buffer_size, size_t& ret_size, UString& sender, bool& allowed, Report& report);
         };
     }
 }
@@ -41,7 +41,7 @@ ts::tsswitch::EventDispatcher::EventDispatcher(const InputSwitcherArgs& opt, Rep
     _opt(opt),
     _log(log),
     _sendCommand(!_opt.eventCommand.empty()),
-    _sendUDP(_opt.eventUDP.hasAddress() && _opt.eventUDP.hasPort()),
+    _sendUDP((_opt.eventUDP.hasAddress() && _opt.eventUDP.hasPort()) || (_opt.eventUDP6.hasAddress() && _opt.eventUDP6.hasPort())),
     _userData(_opt.eventUserData),
     _socket()
 {
@@ -76,10 +76,12 @@ bool ts::tsswitch::EventDispatcher::sendUDP(const UString& eventName, json::Obje
 {
     // Open socket the first time.
     if (!_socket.isOpen()) {
-        if (!_socket.open(_log) ||
-            !_socket.setDefaultDestination(_opt.eventUDP, _log) ||
+        const bool ipv6 = _opt.eventUDP6.hasAddress();
+        if (!_socket.open(ipv6 ? IP::v6 : IP::v4, _log) ||
+            !(ipv6 ? _socket.setDefaultDestination(_opt.eventUDP6, _log) : _socket.setDefaultDestination(_opt.eventUDP, _log)) ||
             (_opt.sockBuffer > 0 && !_socket.setSendBufferSize(_opt.sockBuffer, _log)) ||
-            (_opt.eventLocalAddress.hasAddress() && !_socket.setOutgoingMulticast(_opt.eventLocalAddress, _log)) ||
+            (!ipv6 && _opt.eventLocalAddress.hasAddress() && !_socket.setOutgoingMulticast(_opt.eventLocalAddress, _log)) ||
+            (ipv6 && _opt.eventLocalInterface6 != 0 && !_socket.setOutgoingMulticastInterface(_opt.eventLocalInterface6, _log)) ||
             (_opt.eventTTL > 0 && !_socket.setTTL(_opt.eventTTL, _log)))
         {
             _socket.close(_log);
@@ -49,6 +49,11 @@
 #include "tsCTS4.h"
 #include "tsDVS042.h"
 
+namespace {
+    // Number of packets which are processed at once in a packet window.
+    constexpr size_t AES_WINDOW_SIZE = 512;
+}
+
 
 //----------------------------------------------------------------------------
 // Plugin definition
@@ -63,7 +68,9 @@ namespace ts {
         AESPlugin(TSP*);
         virtual bool getOptions() override;
         virtual bool start() override;
+        virtual size_t getPacketWindowSize() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual size_t processPacketWindow(TSPacketWindow& win) override;
 
     private:
         // Command line options:
@@ -83,6 +90,15 @@ namespace ts {
         bool            _abort;           // Error (service not found, etc)
         Service         _service;         // Service name & id
         SectionDemux    _demux;           // Section demux
+        std::vector<TSPacket*> _batch_packets;  // Packets to (de)scramble at once
+        std::vector<uint8_t*>  _batch_data;     // Payloads to (de)scramble
+        std::vector<size_t>    _batch_sizes;    // Size of payloads to (de)scramble
+
+        // Analyze a packet and add it in the batch of packets to (de)scramble.
+        Status selectPacket(TSPacket& pkt);
+
+        // (De)scramble all packets in the batch at once.
+        bool processBatch();
 
         // Invoked by the demux when a complete table is available.
         virtual void handleTable(SectionDemux&, const BinaryTable&) override;
@@ -116,7 +132,10 @@ ts::AESPlugin::AESPlugin(TSP* tsp_) :
     _chain(nullptr),
     _abort(false),
     _service(),
-    _demux(duck, this)
+    _demux(duck, this),
+    _batch_packets(),
+    _batch_data(),
+    _batch_sizes()
 {
     // We need to define character sets to specify service names.
     duck.defineArgsForCharset(*this);
@@ -272,6 +291,9 @@ bool ts::AESPlugin::start()
     // Reset other states.
     _service = _service_arg;
     _abort = false;
+    _batch_packets.clear();
+    _batch_data.clear();
+    _batch_sizes.clear();
 
     return true;
 }
@@ -391,10 +413,51 @@ void ts::AESPlugin::processPMT(PMT& pmt)
 
 
 //----------------------------------------------------------------------------
-// Packet processing method
+// Packet processing methods
 //----------------------------------------------------------------------------
 
+size_t ts::AESPlugin::getPacketWindowSize()
+{
+    // The payloads of all packets in a window are (de)scrambled at once,
+    // using the multi-block capabilities of the cipher chaining.
+    return AES_WINDOW_SIZE;
+}
+
 ts::ProcessorPlugin::Status ts::AESPlugin::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
+{
+    const Status status = selectPacket(pkt);
+    return status == TSP_OK && !processBatch() ? TSP_END : status;
+}
+
+size_t ts::AESPlugin::processPacketWindow(TSPacketWindow& win)
+{
+    // Analyze all packets in sequence and build the list of packets to (de)scramble.
+    size_t count = 0;
+    size_t first = NPOS;
+    for (; count < win.size(); ++count) {
+        TSPacket* pkt = win.packet(count);
+        if (pkt != nullptr) {
+            const size_t previous = _batch_packets.size();
+            if (selectPacket(*pkt) == TSP_END) {
+                break;
+            }
+            if (first == NPOS && _batch_packets.size() > previous) {
+                first = count;
+            }
+        }
+    }
+
+    // Now (de)scramble all selected packets at once.
+    // In case of error, stop before the first packet of the batch.
+    return processBatch() ? count : first;
+}
+
+
+//----------------------------------------------------------------------------
+// Analyze a packet and add it in the batch of packets to (de)scramble.
+//----------------------------------------------------------------------------
+
+ts::ProcessorPlugin::Status ts::AESPlugin::selectPacket(TSPacket& pkt)
 {
     const PID pid = pkt.getPID();
 
@@ -436,25 +499,43 @@ ts::ProcessorPlugin::Status ts::AESPlugin::processPacket(TSPacket& pkt, TSPacket
         return TSP_OK;
     }
 
-    // Now (de)scramble the packet
-    uint8_t tmp[PKT_SIZE];
-    assert (pl_size < sizeof(tmp));
-    if (_descramble) {
-        if (!_chain->decrypt(pl, pl_size, tmp, pl_size)) {
-            tsp->error(u"AES decrypt error");
-            return TSP_END;
+    // Add the packet in the batch.
+    _batch_packets.push_back(&pkt);
+    _batch_data.push_back(pl);
+    _batch_sizes.push_back(pl_size);
+    return TSP_OK;
+}
+
+
+//----------------------------------------------------------------------------
+// (De)scramble all packets in the batch at once.
+//----------------------------------------------------------------------------
+
+bool ts::AESPlugin::processBatch()
+{
+    bool ok = true;
+    if (!_batch_packets.empty()) {
+        if (_descramble) {
+            ok = _chain->decryptMessages(_batch_data.data(), _batch_sizes.data(), _batch_data.size());
+            if (!ok) {
+                tsp->error(u"AES decrypt error");
+            }
         }
-    }
-    else {
-        if (!_chain->encrypt(pl, pl_size, tmp, pl_size)) {
-            tsp->error(u"AES encrypt error");
-            return TSP_END;
+        else {
+            ok = _chain->encryptMessages(_batch_data.data(), _batch_sizes.data(), _batch_data.size());
+            if (!ok) {
+                tsp->error(u"AES encrypt error");
+            }
         }
+        if (ok) {
+            // Mark "even key" (there is only one key but we must set something).
+            for (auto pkt : _batch_packets) {
+                pkt->setScrambling(uint8_t(_descramble ? SC_CLEAR : SC_EVEN_KEY));
+            }
+        }
+        _batch_packets.clear();
+        _batch_data.clear();
+        _batch_sizes.clear();
     }
-    ::memcpy(pl, tmp, pl_size);
-
-    // Mark "even key" (there is only one key but we must set something).
-    pkt.setScrambling(uint8_t(_descramble ? SC_CLEAR : SC_EVEN_KEY));
-
-    return TSP_OK;
+    return ok;
 }
@@ -0,0 +1,410 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Transport stream processor shared library:
+//  Direct capture of UDP datagrams from a network interface (Linux AF_PACKET).
+//
+//----------------------------------------------------------------------------
+
+#include "tsAbstractDatagramInputPlugin.h"
+#include "tsPluginRepository.h"
+#include "tsAFPacketCapture.h"
+#include "tsIPPacketView.h"
+#include "tsIPUtils.h"
+
+namespace {
+    // Default parameters of the capture ring.
+    constexpr size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+    constexpr size_t DEFAULT_BLOCK_COUNT = 64;
+    constexpr ts::MilliSecond DEFAULT_BLOCK_TIMEOUT = 10;
+}
+
+//----------------------------------------------------------------------------
+// Plugin definition
+//----------------------------------------------------------------------------
+
+namespace ts {
+    class AFPacketInputPlugin: public AbstractDatagramInputPlugin
+    {
+        TS_NOBUILD_NOCOPY(AFPacketInputPlugin);
+    public:
+        // Implementation of plugin API
+        AFPacketInputPlugin(TSP*);
+        virtual bool getOptions() override;
+        virtual bool start() override;
+        virtual bool stop() override;
+        virtual bool setReceiveTimeout(MilliSecond timeout) override;
+        virtual size_t receive(TSPacket*, TSPacketMetadata*, size_t) override;
+
+    protected:
+        // Implementation of AbstractDatagramInputPlugin.
+        virtual bool receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp) override;
+
+    private:
+        // Description of one selected UDP stream.
+        class Flow
+        {
+        public:
+            IPv4SocketAddress destination {};   // Destination UDP socket address, IPv4.
+            IPv6SocketAddress destination6 {};  // Destination UDP socket address, IPv6.
+            uint8_t           ip_version {0};   // IP version, zero until the destination address is known.
+        };
+
+        // Command line options:
+        UString           _interface {};        // Capture network interface.
+        std::vector<Flow> _flows {};            // Selected UDP streams, from --destination options.
+        IPv4SocketAddress _source {};           // Selected source UDP socket address.
+        IPv6SocketAddress _source6 {};          // Selected source UDP socket address, IPv6.
+        uint8_t           _source_version {0};  // IP version of source address, zero if unspecified.
+        bool              _multicast {false};   // Use multicast destinations only.
+        bool              _join {true};         // Join multicast destinations on the capture interface.
+        size_t            _base_label {0};      // Label of packets from first flow, next flows use next labels.
+        size_t            _block_size {0};      // Size of blocks in the capture ring.
+        size_t            _block_count {0};     // Number of blocks in the capture ring.
+        MilliSecond       _block_timeout {0};   // Timeout before the kernel passes an incomplete block.
+        MilliSecond       _timeout {0};         // Receive timeout from tsp.
+
+        // Working data:
+        AFPacketCapture   _capture {};          // Memory-mapped capture ring.
+        size_t            _last_flow {0};       // Index of flow of last datagram.
+
+        // Decode a socket address, IPv4 or IPv6. Return the IP version, zero if no address.
+        bool decodeAddress(const UString& str, IPv4SocketAddress& addr4, IPv6SocketAddress& addr6, uint8_t& version);
+
+        // Check if a UDP datagram is selected. Return true if it is.
+        template <class SOCKADDR>
+        bool selectUDP(const SOCKADDR& src, const SOCKADDR& dst, const SOCKADDR& source, SOCKADDR& destination, const uint8_t* udp_data, size_t udp_size);
+    };
+}
+
+TS_REGISTER_INPUT_PLUGIN(u"afpacket", ts::AFPacketInputPlugin);
+
+
+//----------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------
+
+ts::AFPacketInputPlugin::AFPacketInputPlugin(TSP* tsp_) :
+    AbstractDatagramInputPlugin(tsp_, IP_MAX_PACKET_SIZE,
+                                u"Capture TS packets from UDP datagrams on a network interface (Linux only)", u"[options] interface",
+                                u"kernel", u"A kernel-provided capture time-stamp for the packet",
+                                true) // real-time network reception
+{
+    option(u"", 0, STRING, 1, 1);
+    help(u"", u"interface",
+         u"The name of the network interface to capture, for instance 'eth0'. "
+         u"All frames from this interface are captured in a memory-mapped ring which is shared with the kernel (Linux AF_PACKET). "
+         u"This input plugin extracts IPv4 or IPv6 UDP datagrams which contain transport stream packets. "
+         u"The datagrams are captured before the IP and UDP layers of the kernel. "
+         u"There is no socket buffer limitation and there is no need for a socket to be bound to the destination port. "
+         u"This plugin usually requires root privileges or the CAP_NET_RAW capability.");
+
+    option(u"block-size", 0, UNSIGNED);
+    help(u"block-size",
+         u"Size in bytes of each block in the capture ring. "
+         u"The value is rounded up to a multiple of the memory page size. "
+         u"The default is " + UString::Decimal(DEFAULT_BLOCK_SIZE) + u" bytes.");
+
+    option(u"blocks", 0, POSITIVE);
+    help(u"blocks",
+         u"Number of blocks in the capture ring. "
+         u"The default is " + UString::Decimal(DEFAULT_BLOCK_COUNT) + u" blocks.");
+
+    option(u"block-timeout", 0, POSITIVE);
+    help(u"block-timeout", u"milliseconds",
+         u"Maximum time the kernel fills a block before passing it to the application, even if the block is not full. "
+         u"This is the maximum additional latency on low-bitrate streams. "
+         u"The default is " + UString::Decimal(DEFAULT_BLOCK_TIMEOUT) + u" milliseconds.");
+
+    option(u"destination", 'd', STRING, 0, UNLIMITED_COUNT);
+    help(u"destination", u"[address][:port]",
+         u"Select UDP datagrams based on the specified destination socket address. "
+         u"IPv6 socket addresses must be enclosed in square brackets, as in [address]:port. "
+         u"If either the IP address or UDP port is missing, use the destination of the first matching "
+         u"UDP datagram containing TS packets. Then, select only UDP datagrams with this socket address. "
+         u"Several --destination options can be specified to capture several UDP streams from the same thread. "
+         u"By default, use the destination of the first UDP datagram containing TS packets.");
+
+    option(u"label-base", 0, INTEGER, 0, 1, 0, TSPacketLabelSet::MAX);
+    help(u"label-base",
+         u"Set a label on each input packet. "
+         u"Packets from the first --destination are tagged with the specified base label, "
+         u"packets from the second --destination with base label plus one, and so on. "
+         u"For a given --destination, if the computed label is above the maximum (" +
+         UString::Decimal(TSPacketLabelSet::MAX) + u"), its packets are not labelled.");
+
+    option(u"multicast-only", 'm');
+    help(u"multicast-only",
+         u"When the destination address is not specified, select the first multicast address which is found in a UDP datagram. "
+         u"By default, use the destination address of the first UDP datagram containing TS packets, unicast or multicast.");
+
+    option(u"no-join");
+    help(u"no-join",
+         u"Do not join the multicast destination addresses on the capture interface. "
+         u"By default, the multicast groups from the --destination options are joined on the capture interface "
+         u"so that the multicast traffic is routed to this interface. "
+         u"Use this option when the multicast traffic is already present, for instance on a monitoring port.");
+
+    option(u"source", 's', STRING);
+    help(u"source", u"[address][:port]",
+         u"Filter UDP datagrams based on the specified source socket address. "
+         u"IPv6 socket addresses must be enclosed in square brackets, as in [address]:port. "
+         u"By default, do not filter on source address.");
+}
+
+
+//----------------------------------------------------------------------------
+// Command line options method
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketInputPlugin::getOptions()
+{
+    getValue(_interface, u"");
+    getIntValue(_block_size, u"block-size", DEFAULT_BLOCK_SIZE);
+    getIntValue(_block_count, u"blocks", DEFAULT_BLOCK_COUNT);
+    getIntValue(_block_timeout, u"block-timeout", DEFAULT_BLOCK_TIMEOUT);
+    getIntValue(_base_label, u"label-base", TSPacketLabelSet::MAX + 1);
+    _multicast = present(u"multicast-only");
+    _join = !present(u"no-join");
+
+    // Decode source address.
+    if (!decodeAddress(value(u"source"), _source, _source6, _source_version)) {
+        return false;
+    }
+
+    // Decode all destination addresses, one flow per destination.
+    // Without destination, use one flow, selected by the first UDP datagram containing TS packets.
+    UStringVector dest;
+    getValues(dest, u"destination");
+    if (dest.empty()) {
+        dest.push_back(UString());
+    }
+    _flows.resize(dest.size());
+    for (size_t i = 0; i < dest.size(); ++i) {
+        Flow& fl(_flows[i]);
+        if (!decodeAddress(dest[i], fl.destination, fl.destination6, fl.ip_version)) {
+            return false;
+        }
+        if (_source_version != 0 && fl.ip_version != 0 && fl.ip_version != _source_version) {
+            tsp->error(u"cannot mix IPv4 and IPv6 addresses in --source and --destination %s", {dest[i]});
+            return false;
+        }
+    }
+
+    // Get command line arguments for superclass.
+    return AbstractDatagramInputPlugin::getOptions();
+}
+
+
+//----------------------------------------------------------------------------
+// Decode a socket address, IPv4 or IPv6.
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketInputPlugin::decodeAddress(const UString& str, IPv4SocketAddress& addr4, IPv6SocketAddress& addr6, uint8_t& version)
+{
+    addr4.clear();
+    addr6.clear();
+    version = 0;
+
+    if (str.empty()) {
+        return true;
+    }
+    else if (IPStringGeneration(str) == IP::v6) {
+        // IPv6 socket address.
+        if (!addr6.resolve(str, *tsp)) {
+            return false;
+        }
+        if (addr6.hasAddress()) {
+            version = IPv6_VERSION;
+        }
+        addr4.setPort(addr6.port());
+    }
+    else {
+        // IPv4 socket address or port alone.
+        if (!addr4.resolve(str, *tsp)) {
+            return false;
+        }
+        if (addr4.hasAddress()) {
+            version = IPv4_VERSION;
+        }
+        addr6.setPort(addr4.port());
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Set receive timeout from tsp.
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketInputPlugin::setReceiveTimeout(MilliSecond timeout)
+{
+    if (timeout > 0) {
+        _timeout = timeout;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Start method
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketInputPlugin::start()
+{
+    _last_flow = 0;
+    if (!AbstractDatagramInputPlugin::start() || !_capture.open(_interface, _block_size, _block_count, _block_timeout, *tsp)) {
+        return false;
+    }
+
+    // Join multicast destinations on the capture interface.
+    bool ok = true;
+    for (size_t i = 0; ok && _join && i < _flows.size(); ++i) {
+        const Flow& fl(_flows[i]);
+        if (fl.ip_version == IPv4_VERSION && fl.destination.isMulticast()) {
+            ok = _capture.addMembership(IPv4Address(fl.destination), *tsp);
+        }
+        else if (fl.ip_version == IPv6_VERSION && fl.destination6.isMulticast()) {
+            ok = _capture.addMembership(IPv6Address(fl.destination6), *tsp);
+        }
+    }
+    if (!ok) {
+        _capture.close(*tsp);
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Stop method
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketInputPlugin::stop()
+{
+    // Report capture statistics, once per session.
+    uint64_t packets = 0;
+    uint64_t drops = 0;
+    uint64_t truncated = 0;
+    if (_capture.getStatistics(packets, drops, truncated, *tsp)) {
+        tsp->log(drops > 0 ? Severity::Warning : Severity::Verbose, u"captured %'d frames on %s, dropped %'d frames", {packets, _interface, drops});
+        if (truncated > 0) {
+            tsp->warning(u"ignored %'d truncated frames on %s, use a larger --block-size", {truncated, _interface});
+        }
+    }
+    _capture.close(*tsp);
+    return AbstractDatagramInputPlugin::stop();
+}
+
+
+//----------------------------------------------------------------------------
+// Datagram reception method.
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketInputPlugin::receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp)
+{
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    IPPacketView ip;
+
+    // Loop on captured IP datagrams until a matching UDP packet is found.
+    for (;;) {
+
+        // Read one IPv4 or IPv6 datagram, without copy.
+        if (!_capture.readIP(data, size, timestamp, _timeout, tsp, *tsp)) {
+            return false;
+        }
+        if (!ip.reset(data, size) || !ip.isUDP() || (_source_version != 0 && ip.version() != _source_version)) {
+            continue; // not a UDP datagram or not the selected IP version
+        }
+
+        // Look for the first matching flow.
+        for (_last_flow = 0; _last_flow < _flows.size(); ++_last_flow) {
+            Flow& fl(_flows[_last_flow]);
+            if (fl.ip_version != 0 && fl.ip_version != ip.version()) {
+                continue;
+            }
+            const bool selected = ip.isIPv4() ?
+                selectUDP(ip.sourceIPv4SocketAddress(), ip.destinationIPv4SocketAddress(), _source, fl.destination, ip.protocolData(), ip.protocolDataSize()) :
+                selectUDP(ip.sourceIPv6SocketAddress(), ip.destinationIPv6SocketAddress(), _source6, fl.destination6, ip.protocolData(), ip.protocolDataSize());
+            if (selected) {
+                // Once the destination is selected, stick to the same IP version.
+                fl.ip_version = ip.version();
+                // This is the only copy of the UDP payload, from the capture ring into the plugin buffer.
+                ret_size = std::min(ip.protocolDataSize(), buffer_size);
+                ::memcpy(buffer, ip.protocolData(), ret_size);
+                return true;
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a UDP datagram is selected.
+//----------------------------------------------------------------------------
+
+template <class SOCKADDR>
+bool ts::AFPacketInputPlugin::selectUDP(const SOCKADDR& src, const SOCKADDR& dst, const SOCKADDR& source, SOCKADDR& destination, const uint8_t* udp_data, size_t udp_size)
+{
+    // Filter source or destination socket address if one was specified.
+    if (!src.match(source) || !dst.match(destination)) {
+        return false;
+    }
+
+    // The destination can be dynamically selected (address, port or both) by the first UDP datagram containing TS packets.
+    if (!destination.hasAddress() || !destination.hasPort()) {
+        size_t start_index = 0;
+        size_t packet_count = 0;
+        if ((!destination.hasAddress() && _multicast && !dst.isMulticast()) || !TSPacket::Locate(udp_data, udp_size, start_index, packet_count)) {
+            return false;
+        }
+        destination = dst;
+        tsp->verbose(u"using UDP destination address %s", {dst});
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Input method.
+//----------------------------------------------------------------------------
+
+size_t ts::AFPacketInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
+{
+    const size_t count = AbstractDatagramInputPlugin::receive(buffer, pkt_data, max_packets);
+
+    // All returned packets come from the last received datagram. Mark them with the label of the flow.
+    const size_t label = _base_label + _last_flow;
+    if (label <= TSPacketLabelSet::MAX) {
+        for (size_t n = 0; n < count; ++n) {
+            pkt_data[n].setLabel(label);
+        }
+    }
+    return count;
+}
@@ -35,6 +35,7 @@
 #include "tsAbstractDatagramInputPlugin.h"
 #include "tsPluginRepository.h"
 #include "tsPcapStream.h"
+#include "tsIPPacketView.h"
 #include "tsEMMGMUX.h"
 #include "tstlvMessageFactory.h"
 
@@ -63,6 +64,9 @@ namespace ts {
         UString           _file_name {};            // Pcap file name.
         IPv4SocketAddress _destination {};          // Selected destination UDP socket address.
         IPv4SocketAddress _source {};               // Selected source UDP socket address.
+        IPv6SocketAddress _destination6 {};         // Selected destination UDP socket address, IPv6.
+        IPv6SocketAddress _source6 {};              // Selected source UDP socket address, IPv6.
+        uint8_t           _ip_version {0};          // Selected IP version from options, zero if unspecified.
         bool              _multicast {false};       // Use multicast destinations only.
         bool              _udp_emmg_mux {false};    // Extract packets from EMMG/PDG <=> MUX data provisions in UDP mode.
         bool              _tcp_emmg_mux {false};    // Extract packets from EMMG/PDG <=> MUX data provisions in TCP mode.
@@ -76,13 +80,24 @@ namespace ts {
         PcapStream           _pcap_tcp {};          // Pcap file, in TCP mode (DVB SimulCrypt EMMG/PDG <=> MUX).
         MicroSecond          _first_tstamp {0};     // Time stamp of first datagram.
         IPv4SocketAddress    _act_destination {};   // Actual destination UDP socket address.
+        IPv6SocketAddress    _act_destination6 {};  // Actual destination UDP socket address, IPv6.
+        uint8_t              _act_ip_version {0};   // Actual IP version, zero until the destination is selected.
         IPv4SocketAddressSet _all_sources {};       // All source addresses.
+        IPv6SocketAddressSet _all_sources6 {};      // All source addresses, IPv6.
         emmgmux::Protocol    _emmgmux {};           // EMMG/PDG <=> MUX protocol instance to decode TCP stream.
 
         // Internal receive methods.
         bool receiveUDP(uint8_t* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp);
         bool receiveTCP(uint8_t* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp);
 
+        // Decode a --source or --destination option, IPv4 or IPv6.
+        bool decodeAddress(const UChar* name, IPv4SocketAddress& addr4, IPv6SocketAddress& addr6);
+
+        // Process a UDP datagram, IPv4 or IPv6. Return true if the datagram is selected.
+        template <class SOCKADDR, class SOCKADDRSET>
+        bool processUDP(const SOCKADDR& src, const SOCKADDR& dst, const SOCKADDR& source, SOCKADDR& act_destination, SOCKADDRSET& all_sources,
+                        const uint8_t* udp_data, size_t udp_size, uint8_t* buffer, size_t buffer_size, size_t& ret_size);
+
         // Identify and extract TS packets from an EMMG/PDG <=> data_provision message.
         bool isDataProvision(const uint8_t* data, size_t size);
         size_t extractDataProvision(uint8_t* buffer, size_t buffer_size, const uint8_t* msg, size_t msg_size);
@@ -107,12 +122,13 @@ ts::PcapInputPlugin::PcapInputPlugin(TSP* tsp_) :
     option(u"", 0, FILENAME, 0, 1);
     help(u"", u"file-name",
          u"The name of a '.pcap' or '.pcapng' capture file as produced by Wireshark for instance. "
-         u"This input plugin extracts IPv4 UDP datagrams which contain transport stream packets. "
+         u"This input plugin extracts IPv4 or IPv6 UDP datagrams which contain transport stream packets. "
          u"Use the standard input by default, when no file name is specified.");
 
     option(u"destination", 'd', STRING);
     help(u"destination", u"[address][:port]",
          u"Filter UDP datagrams based on the specified destination socket address. "
+         u"IPv6 socket addresses must be enclosed in square brackets, as in [address]:port. "
          u"By default or if either the IP address or UDP port is missing, "
          u"use the destination of the first matching UDP datagram containing TS packets. "
          u"Then, select only UDP datagrams with this socket address.");
@@ -135,6 +151,7 @@ ts::PcapInputPlugin::PcapInputPlugin(TSP* tsp_) :
     option(u"source", 's', STRING);
     help(u"source", u"[address][:port]",
          u"Filter UDP datagrams based on the specified source socket address. "
+         u"IPv6 socket addresses must be enclosed in square brackets, as in [address]:port. "
          u"By default, do not filter on source address.");
 
     option(u"tcp-emmg-mux");
@@ -165,8 +182,6 @@ ts::PcapInputPlugin::PcapInputPlugin(TSP* tsp_) :
 bool ts::PcapInputPlugin::getOptions()
 {
     getValue(_file_name, u"");
-    const UString str_source(value(u"source"));
-    const UString str_destination(value(u"destination"));
     _multicast = present(u"multicast-only");
     _udp_emmg_mux = present(u"udp-emmg-mux");
     _tcp_emmg_mux = present(u"tcp-emmg-mux");
@@ -181,12 +196,8 @@ bool ts::PcapInputPlugin::getOptions()
     }
 
     // Decode socket addresses.
-    _source.clear();
-    _destination.clear();
-    if (!str_source.empty() && !_source.resolve(str_source, *tsp)) {
-        return false;
-    }
-    if (!str_destination.empty() && !_destination.resolve(str_destination, *tsp)) {
+    _ip_version = 0;
+    if (!decodeAddress(u"source", _source, _source6) || !decodeAddress(u"destination", _destination, _destination6)) {
         return false;
     }
 
@@ -203,7 +214,10 @@ bool ts::PcapInputPlugin::start()
 {
     _first_tstamp = -1;
     _act_destination = _destination;
+    _act_destination6 = _destination6;
+    _act_ip_version = _ip_version;
     _all_sources.clear();
+    _all_sources6.clear();
 
     // Initialize superclass and pcap file.
     bool ok = AbstractDatagramInputPlugin::start();
@@ -254,83 +268,33 @@ bool ts::PcapInputPlugin::receiveDatagram(uint8_t* buffer, size_t buffer_size, s
 
 bool ts::PcapInputPlugin::receiveUDP(uint8_t *buffer, size_t buffer_size, size_t &ret_size, MicroSecond &timestamp)
 {
-    IPv4Packet ip;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    IPPacketView ip;
 
-    // Loop on IPv4 datagrams from the pcap file until a matching UDP packet is found (or end of file).
+    // Loop on IP datagrams from the pcap file until a matching UDP packet is found (or end of file).
     for (;;) {
 
-        // Read one IPv4 datagram.
-        if (!_pcap_udp.readIPv4(ip, timestamp, *tsp)) {
+        // Read one IPv4 or IPv6 datagram, without copy.
+        if (!_pcap_udp.readIP(data, size, timestamp, *tsp)) {
             return 0; // end of file, invalid pcap file format or other i/o error
         }
-
-        // Get IP addresses and UDP ports.
-        const IPv4SocketAddress src(ip.sourceSocketAddress());
-        const IPv4SocketAddress dst(ip.destinationSocketAddress());
-
-        // Filter source or destination socket address if one was specified.
-        if (!src.match(_source) || !dst.match(_act_destination)) {
-            continue; // not a matching address
-        }
-
-        // If the destination is not yet found, filter multicast addresses if required.
-        if (!_act_destination.hasAddress() && _multicast && !dst.isMulticast()) {
-            continue; // not a multicast address
+        if (!ip.reset(data, size) || !ip.isUDP() || (_act_ip_version != 0 && ip.version() != _act_ip_version)) {
+            continue; // not a UDP datagram or not the selected IP version
         }
 
-        // Locate UDP payload.
-        const uint8_t* const udp_data = ip.protocolData();
-        const size_t udp_size = ip.protocolDataSize();
-
-        // DVB SimulCrypt vs. raw TS.
-        // The destination can be dynamically selected (address, port or both) by the first UDP datagram containing TS packets.
-        if (_udp_emmg_mux) {
-            // Try to decode UDP packet as DVB SimulCrypt.
-            if (!_act_destination.hasAddress() || !_act_destination.hasPort()) {
-                // The actual destination is not fully known yet.
-                // We are still waiting for the first UDP datagram containing a data_provision message.
-                // Is there any in this one?
-                if (!isDataProvision(udp_data, udp_size)) {
-                    continue; // no data_provision message in this UDP datagram.
-                }
-                // We just found the first UDP datagram with a data_provision message, now use this destination address all the time.
-                _act_destination = dst;
-                tsp->verbose(u"using UDP destination address %s", {dst});
-            }
-
-            // Extract TS packets from the data_provision message.
-            ret_size = extractDataProvision(buffer, buffer_size, udp_data, udp_size);
-            if (ret_size == 0) {
-                continue; // no TS packets in this message
-            }
-        }
-        else {
-            // Look for raw TS.
-            if (!_act_destination.hasAddress() || !_act_destination.hasPort()) {
-                // The actual destination is not fully known yet.
-                // We are still waiting for the first UDP datagram containing TS packets.
-                // Is there any TS packet in this one?
-                size_t start_index = 0;
-                size_t packet_count = 0;
-                if (!TSPacket::Locate(ip.protocolData(), ip.protocolDataSize(), start_index, packet_count)) {
-                    continue; // no TS packet in this UDP datagram.
-                }
-                // We just found the first UDP datagram with TS packets, now use this destination address all the time.
-                _act_destination = dst;
-                tsp->verbose(u"using UDP destination address %s", {dst});
-            }
-
-            // Now we have a valid UDP packet.
-            ret_size = std::min(ip.protocolDataSize(), buffer_size);
-            ::memmove(buffer, ip.protocolData(), ret_size);
+        // Check the addresses and extract the TS packets.
+        const bool selected = ip.isIPv4() ?
+            processUDP(ip.sourceIPv4SocketAddress(), ip.destinationIPv4SocketAddress(), _source, _act_destination, _all_sources,
+                       ip.protocolData(), ip.protocolDataSize(), buffer, buffer_size, ret_size) :
+            processUDP(ip.sourceIPv6SocketAddress(), ip.destinationIPv6SocketAddress(), _source6, _act_destination6, _all_sources6,
+                       ip.protocolData(), ip.protocolDataSize(), buffer, buffer_size, ret_size);
+        if (!selected) {
+            continue;
         }
 
-        // List all source addresses as they appear.
-        if (_all_sources.find(src) == _all_sources.end()) {
-            // This is a new source address.
-            tsp->verbose(u"%s UDP source address %s", {_all_sources.empty() ? u"using" : u"adding", src});
-            _all_sources.insert(src);
-        }
+        // Once the destination is selected, stick to the same IP version.
+        _act_ip_version = ip.version();
 
         // Adjust time stamps according to first one.
         if (timestamp >= 0) {
@@ -351,6 +315,122 @@ bool ts::PcapInputPlugin::receiveUDP(uint8_t *buffer, size_t buffer_size, size_t
 }
 
 
+//----------------------------------------------------------------------------
+// Process a UDP datagram, IPv4 or IPv6. Return true if the datagram is selected.
+//----------------------------------------------------------------------------
+
+template <class SOCKADDR, class SOCKADDRSET>
+bool ts::PcapInputPlugin::processUDP(const SOCKADDR& src, const SOCKADDR& dst, const SOCKADDR& source, SOCKADDR& act_destination, SOCKADDRSET& all_sources,
+                                     const uint8_t* udp_data, size_t udp_size, uint8_t* buffer, size_t buffer_size, size_t& ret_size)
+{
+    // Filter source or destination socket address if one was specified.
+    if (!src.match(source) || !dst.match(act_destination)) {
+        return false; // not a matching address
+    }
+
+    // If the destination is not yet found, filter multicast addresses if required.
+    if (!act_destination.hasAddress() && _multicast && !dst.isMulticast()) {
+        return false; // not a multicast address
+    }
+
+    // DVB SimulCrypt vs. raw TS.
+    // The destination can be dynamically selected (address, port or both) by the first UDP datagram containing TS packets.
+    if (_udp_emmg_mux) {
+        // Try to decode UDP packet as DVB SimulCrypt.
+        if (!act_destination.hasAddress() || !act_destination.hasPort()) {
+            // The actual destination is not fully known yet.
+            // We are still waiting for the first UDP datagram containing a data_provision message.
+            // Is there any in this one?
+            if (!isDataProvision(udp_data, udp_size)) {
+                return false; // no data_provision message in this UDP datagram.
+            }
+            // We just found the first UDP datagram with a data_provision message, now use this destination address all the time.
+            act_destination = dst;
+            tsp->verbose(u"using UDP destination address %s", {dst});
+        }
+
+        // Extract TS packets from the data_provision message.
+        ret_size = extractDataProvision(buffer, buffer_size, udp_data, udp_size);
+        if (ret_size == 0) {
+            return false; // no TS packets in this message
+        }
+    }
+    else {
+        // Look for raw TS.
+        if (!act_destination.hasAddress() || !act_destination.hasPort()) {
+            // The actual destination is not fully known yet.
+            // We are still waiting for the first UDP datagram containing TS packets.
+            // Is there any TS packet in this one?
+            size_t start_index = 0;
+            size_t packet_count = 0;
+            if (!TSPacket::Locate(udp_data, udp_size, start_index, packet_count)) {
+                return false; // no TS packet in this UDP datagram.
+            }
+            // We just found the first UDP datagram with TS packets, now use this destination address all the time.
+            act_destination = dst;
+            tsp->verbose(u"using UDP destination address %s", {dst});
+        }
+
+        // Now we have a valid UDP packet, directly copied from the capture file.
+        ret_size = std::min(udp_size, buffer_size);
+        ::memcpy(buffer, udp_data, ret_size);
+    }
+
+    // List all source addresses as they appear.
+    if (all_sources.find(src) == all_sources.end()) {
+        // This is a new source address.
+        tsp->verbose(u"%s UDP source address %s", {all_sources.empty() ? u"using" : u"adding", src});
+        all_sources.insert(src);
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Decode a --source or --destination option, IPv4 or IPv6.
+//----------------------------------------------------------------------------
+
+bool ts::PcapInputPlugin::decodeAddress(const UChar* name, IPv4SocketAddress& addr4, IPv6SocketAddress& addr6)
+{
+    const UString str(value(name));
+    addr4.clear();
+    addr6.clear();
+
+    if (str.empty()) {
+        return true;
+    }
+    else if (str.startWith(u"[") || std::count(str.begin(), str.end(), u':') > 1) {
+        // IPv6 socket address.
+        if (!addr6.resolve(str, *tsp)) {
+            return false;
+        }
+        if (addr6.hasAddress()) {
+            if (_ip_version == IPv4_VERSION) {
+                tsp->error(u"cannot mix IPv4 and IPv6 addresses in --source and --destination");
+                return false;
+            }
+            _ip_version = IPv6_VERSION;
+        }
+        addr4.setPort(addr6.port());
+    }
+    else {
+        // IPv4 socket address or port alone.
+        if (!addr4.resolve(str, *tsp)) {
+            return false;
+        }
+        if (addr4.hasAddress()) {
+            if (_ip_version == IPv6_VERSION) {
+                tsp->error(u"cannot mix IPv4 and IPv6 addresses in --source and --destination");
+                return false;
+            }
+            _ip_version = IPv4_VERSION;
+        }
+        addr6.setPort(addr4.port());
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // TCP input method
 //----------------------------------------------------------------------------
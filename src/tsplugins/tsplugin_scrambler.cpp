@@ -49,6 +49,41 @@
 #define ASYNC_HANDLER_EXTRA_STACK_SIZE (1024 * 1024)
 
 
+//----------------------------------------------------------------------------
+// ECMG channels which are shared between scrambler plugins.
+//----------------------------------------------------------------------------
+
+// With --shared-channel, all scrambler plugins in the same process which use the
+// same ECMG, ECM_channel_id and Super_CAS_id share the same ECMG client and channel.
+// Each plugin opens its own ECM stream on that channel. The first plugin opens the
+// channel, the last one closes it.
+
+namespace {
+    class SharedECMG
+    {
+        TS_NOCOPY(SharedECMG);
+    public:
+        SharedECMG() = default;
+        ts::ecmgscs::Protocol protocol {};     // Protocol instance, must outlive the client.
+        ts::ECMGClient        client {protocol, ASYNC_HANDLER_EXTRA_STACK_SIZE};
+        size_t                users {0};       // Number of plugins using the channel.
+    };
+
+    // The repository of shared channels is indexed by ECMG address, channel id and Super_CAS_id.
+    struct SharedECMGRepository
+    {
+        ts::Mutex mutex {};
+        std::map<ts::UString, SharedECMG*> channels {};
+    };
+
+    SharedECMGRepository& SharedChannels()
+    {
+        static SharedECMGRepository repo;
+        return repo;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Plugin definition
 //----------------------------------------------------------------------------
@@ -154,6 +189,9 @@ namespace ts {
 
             // Invoked when an ECM is available, maybe in the context of an external thread.
             virtual void handleECM(const ecmgscs::ECMResponse&) override;
+
+            // Invoked when the asynchronous ECM generation failed, in the context of an external thread.
+            virtual void handleECMError(uint16_t cp_number, const ecmgscs::StreamError&) override;
         };
 
         // ScramblerPlugin parameters, remain constant after start()
@@ -164,6 +202,7 @@ namespace ts {
         bool              _scramble_video {false};      // Scramble all video components
         bool              _scramble_subtitles {false};  // Scramble all subtitles components
         bool              _synchronous_ecmg {false};    // Synchronous ECM generation
+        bool              _shared_channel {false};      // Share the ECMG channel with other scrambler plugins
         bool              _ignore_scrambled {false};    // Ignore packets which are already scrambled
         bool              _update_pmt {false};          // Update PMT.
         bool              _need_cp {false};             // Need to manage crypto-periods (ie. not one single fixed CW).
@@ -191,7 +230,9 @@ namespace ts {
         PacketCounter     _pkt_change_cw {0};           // Transition point for next CW change
         PacketCounter     _pkt_change_ecm {0};          // Transition point for next ECM change
         BitRate           _ts_bitrate {0};              // Saved TS bitrate
-        ECMGClient        _ecmg {_ecmgscs, ASYNC_HANDLER_EXTRA_STACK_SIZE}; // Connection with the ECMG
+        ECMGClient        _private_ecmg {_ecmgscs, ASYNC_HANDLER_EXTRA_STACK_SIZE}; // Connection with the ECMG, when not shared
+        ECMGClient*       _ecmg {nullptr};              // Connection with the ECMG, private or shared
+        UString           _shared_key {};               // Key of the shared ECMG channel
         uint8_t           _ecm_cc {0};                  // Continuity counter in ECM PID.
         PIDSet            _scrambled_pids {};           // List of pids to scramble
         PIDSet            _conflict_pids {};            // List of pids to scramble with scrambled input packets
@@ -205,6 +246,10 @@ namespace ts {
         // Initialize ECM and CP scheduling.
         void initializeScheduling();
 
+        // Connect to / disconnect from the ECMG.
+        bool connectECMG();
+        void disconnectECMG();
+
         // Return current/next CryptoPeriod for CW or ECM
         CryptoPeriod& currentCW()  { return _cp[_current_cw]; }
         CryptoPeriod& nextCW()     { return _cp[(_current_cw + 1) & 0x01]; }
@@ -316,6 +361,14 @@ ts::ScramblerPlugin::ScramblerPlugin(TSP* tsp_) :
          u"Specifies the private data to insert in the CA_descriptor in the PMT. "
          u"The value must be a suite of hexadecimal digits.");
 
+    option(u"shared-channel");
+    help(u"shared-channel",
+         u"Share the ECMG channel with all other instances of the scrambler plugin in the same "
+         u"process which use the same ECMG, ECM_channel_id and Super_CAS_id. Each instance opens "
+         u"its own ECM stream on the shared channel and ECM requests from all instances are "
+         u"pipelined on the same connection. Each instance must use a distinct --stream-id and "
+         u"--ecm-id. This is useful to scramble many services with the same ECMG.");
+
     option(u"subtitles");
     help(u"subtitles",
          u"Scramble subtitles components in the selected service. By default, the "
@@ -345,6 +398,7 @@ bool ts::ScramblerPlugin::getOptions()
     _service.set(value(u""));
     getIntValues(_scrambled_pids, u"pid");
     _synchronous_ecmg = present(u"synchronous") || !tsp->realtime();
+    _shared_channel = present(u"shared-channel");
     _component_level = present(u"component-level");
     _scramble_audio = !present(u"no-audio");
     _scramble_video = !present(u"no-video");
@@ -430,7 +484,7 @@ bool ts::ScramblerPlugin::start()
             tsp->error(u"--super-cas-id is required with --ecmg");
             return false;
         }
-        else if (!_ecmg.connect(_ecmg_args, _channel_status, _stream_status, tsp, _logger)) {
+        else if (!connectECMG()) {
             // Error connecting to ECMG, error message already reported
             return false;
         }
@@ -469,6 +523,87 @@ bool ts::ScramblerPlugin::start()
 }
 
 
+//----------------------------------------------------------------------------
+// Connect to the ECMG, using a private or shared channel.
+//----------------------------------------------------------------------------
+
+bool ts::ScramblerPlugin::connectECMG()
+{
+    // Without shared channel, use our private connection.
+    if (!_shared_channel) {
+        _ecmg = &_private_ecmg;
+        return _ecmg->connect(_ecmg_args, _channel_status, _stream_status, tsp, _logger);
+    }
+
+    // Look for an existing channel in the repository of shared channels.
+    SharedECMGRepository& repo(SharedChannels());
+    GuardMutex lock(repo.mutex);
+    _shared_key = UString::Format(u"%s/%d/0x%X/%d", {_ecmg_args.ecmg_address, _ecmg_args.ecm_channel_id, _ecmg_args.super_cas_id, _ecmg_args.dvbsim_version});
+    SharedECMG*& shared(repo.channels[_shared_key]);
+    if (shared == nullptr) {
+        shared = new SharedECMG;
+        shared->protocol.setVersion(_ecmg_args.dvbsim_version);
+    }
+
+    bool ok = false;
+    if (shared->client.isConnected()) {
+        // The channel is already open by another plugin, add our stream.
+        _channel_status = shared->client.channelStatus();
+        ok = shared->client.addStream(_ecmg_args.ecm_stream_id, _ecmg_args.ecm_id, uint16_t(_ecmg_args.cp_duration / 100), _stream_status, tsp, _logger);
+    }
+    else {
+        // First user of the channel, or previous users have all disconnected.
+        ok = shared->client.connect(_ecmg_args, _channel_status, _stream_status, tsp, _logger);
+    }
+
+    if (ok) {
+        shared->users++;
+        _ecmg = &shared->client;
+        tsp->debug(u"using shared ECMG channel %s, %d users", {_shared_key, shared->users});
+    }
+    else if (shared->users == 0) {
+        delete shared;
+        repo.channels.erase(_shared_key);
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Disconnect from the ECMG, using a private or shared channel.
+//----------------------------------------------------------------------------
+
+void ts::ScramblerPlugin::disconnectECMG()
+{
+    if (_ecmg == &_private_ecmg) {
+        if (_ecmg->isConnected()) {
+            _ecmg->disconnect();
+        }
+    }
+    else if (_ecmg != nullptr) {
+        // Shared channel: close our stream, the last user closes the channel.
+        SharedECMGRepository& repo(SharedChannels());
+        GuardMutex lock(repo.mutex);
+        const auto it = repo.channels.find(_shared_key);
+        if (it != repo.channels.end() && it->second != nullptr) {
+            SharedECMG* shared = it->second;
+            if (shared->users > 1) {
+                shared->client.removeStream(_ecmg_args.ecm_stream_id);
+                shared->users--;
+            }
+            else {
+                if (shared->client.isConnected()) {
+                    shared->client.disconnect();
+                }
+                delete shared;
+                repo.channels.erase(it);
+            }
+        }
+    }
+    _ecmg = nullptr;
+}
+
+
 //----------------------------------------------------------------------------
 // Stop method
 //----------------------------------------------------------------------------
@@ -476,9 +611,7 @@ bool ts::ScramblerPlugin::start()
 bool ts::ScramblerPlugin::stop()
 {
     // Disconnect from ECMG
-    if (_ecmg.isConnected()) {
-        _ecmg.disconnect();
-    }
+    disconnectECMG();
 
     // Terminate the scrambling engine.
     _scrambling.stop();
@@ -938,12 +1071,13 @@ void ts::ScramblerPlugin::CryptoPeriod::generateECM()
     if (_plugin->_synchronous_ecmg) {
         // Synchronous ECM generation
         ecmgscs::ECMResponse response(_plugin->_ecmgscs);
-        if (!_plugin->_ecmg.generateECM(_cp_number,
-                                        _cw_current,
-                                        _cw_next,
-                                        _plugin->_ecmg_args.access_criteria,
-                                        uint16_t(_plugin->_ecmg_args.cp_duration / 100),
-                                        response))
+        if (!_plugin->_ecmg->generateECM(_plugin->_stream_status.stream_id,
+                                         _cp_number,
+                                         _cw_current,
+                                         _cw_next,
+                                         _plugin->_ecmg_args.access_criteria,
+                                         uint16_t(_plugin->_ecmg_args.cp_duration / 100),
+                                         response))
         {
             // Error, message already reported
             _plugin->_abort = true;
@@ -954,12 +1088,13 @@ void ts::ScramblerPlugin::CryptoPeriod::generateECM()
     }
     else {
         // Asynchronous ECM generation
-        if (!_plugin->_ecmg.submitECM(_cp_number,
-                                      _cw_current,
-                                      _cw_next,
-                                      _plugin->_ecmg_args.access_criteria,
-                                      uint16_t(_plugin->_ecmg_args.cp_duration / 100),
-                                      this))
+        if (!_plugin->_ecmg->submitECM(_plugin->_stream_status.stream_id,
+                                       _cp_number,
+                                       _cw_current,
+                                       _cw_next,
+                                       _plugin->_ecmg_args.access_criteria,
+                                       uint16_t(_plugin->_ecmg_args.cp_duration / 100),
+                                       this))
         {
             // Error, message already reported
             _plugin->_abort = true;
@@ -1009,6 +1144,18 @@ void ts::ScramblerPlugin::CryptoPeriod::handleECM(const ecmgscs::ECMResponse& re
 }
 
 
+//----------------------------------------------------------------------------
+// Invoked when the asynchronous ECM generation failed.
+//----------------------------------------------------------------------------
+
+void ts::ScramblerPlugin::CryptoPeriod::handleECMError(uint16_t cp_number, const ecmgscs::StreamError&)
+{
+    // Error already reported by the ECMG client, the ECM will never be available.
+    _plugin->tsp->debug(u"ECM generation failed for crypto-period %d", {cp_number});
+    _plugin->_abort = true;
+}
+
+
 //----------------------------------------------------------------------------
 // Get next ECM packet
 //----------------------------------------------------------------------------
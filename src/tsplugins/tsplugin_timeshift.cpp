@@ -89,6 +89,13 @@ ts::TimeShiftPlugin::TimeShiftPlugin (TSP* tsp_) :
          u"Drop output packets during the initial phase, while the time-shift buffer is filling. "
          u"By default, initial packets are replaced by null packets.");
 
+    option(u"memory-mapped");
+    help(u"memory-mapped",
+         u"Use a ring file which is entirely mapped in virtual memory, instead of a file with memory caches. "
+         u"The operating system performs large contiguous reads and writes on the file. "
+         u"This is recommended for very large buffers (long durations at high bitrates) on 64-bit systems. "
+         u"The option --memory-packets is ignored.");
+
     option(u"memory-packets", 'm', UNSIGNED);
     help(u"memory-packets",
          u"Specify the number of packets which are cached in memory. "
@@ -101,6 +108,13 @@ ts::TimeShiftPlugin::TimeShiftPlugin (TSP* tsp_) :
          u"Specify the size of the time-shift buffer in packets. "
          u"There is no default, the size of the buffer shall be specified either using --packets or --time.");
 
+    option(u"persistent-file", 0, FILENAME);
+    help(u"persistent-file",
+         u"Use the specified file as persistent memory-mapped ring file. Implies --memory-mapped. "
+         u"The file is not deleted on termination. When the plugin is restarted with the same file "
+         u"and the same buffer size, the content of the time-shift buffer is restored, "
+         u"even after a crash of the application.");
+
     option(u"time", 't', UNSIGNED);
     help(u"time", u"milliseconds",
          u"Specify the size of the time-shift buffer in milliseconds. "
@@ -122,6 +136,8 @@ bool ts::TimeShiftPlugin::getOptions()
     const size_t packets = intValue<size_t>(u"packets", 0);
     _buffer.setBackupDirectory(value(u"directory"));
     _buffer.setMemoryPackets(intValue<size_t>(u"memory-packets", TimeShiftBuffer::DEFAULT_MEMORY_PACKETS));
+    _buffer.setMemoryMapped(present(u"memory-mapped"));
+    _buffer.setPersistentFile(value(u"persistent-file"));
 
     if ((packets > 0 && _time_shift_ms > 0) || (packets == 0 && _time_shift_ms == 0)) {
         tsp->error(u"specify exactly one of --packets and --time for time-shift buffer sizing");
@@ -37,8 +37,23 @@
 #include "tsTSFile.h"
 #include "tsPagerArgs.h"
 #include "tsDuckContext.h"
+#include "tsThread.h"
+#include "tsDeferredReport.h"
+#include "tsFileUtils.h"
 TS_MAIN(MainCode);
 
+namespace {
+    // Number of packets to read at a time.
+    constexpr size_t PACKETS_PER_READ = 1024;
+
+    // In parallel analysis, number of packets from the previous chunk which are used
+    // as context (PSI/SI, sections and PES packets overlapping the chunk boundary).
+    constexpr ts::PacketCounter CONTEXT_PACKETS = 100000;
+
+    // In parallel analysis, minimum number of packets per chunk. Smaller files are analyzed sequentially.
+    constexpr ts::PacketCounter MIN_CHUNK_PACKETS = 10 * CONTEXT_PACKETS;
+}
+
 
 //----------------------------------------------------------------------------
 //  Command line options
@@ -57,6 +72,7 @@ namespace {
         ts::TSPacketFormat    format;    // Input file format.
         ts::TSAnalyzerOptions analysis;  // Analysis options.
         ts::PagerArgs         pager;     // Output paging options.
+        size_t                threads;   // Number of analysis threads.
     };
 }
 
@@ -67,7 +83,8 @@ Options::Options(int argc, char *argv[]) :
     infile(),
     format(ts::TSPacketFormat::AUTODETECT),
     analysis(),
-    pager(true, true)
+    pager(true, true),
+    threads(1)
 {
     // Define all standard analysis options.
     duck.defineArgsForStandards(*this);
@@ -87,6 +104,14 @@ Options::Options(int argc, char *argv[]) :
          u"(based on 188-byte packets). By default, the bitrate is "
          u"evaluated using the PCR in the transport stream.");
 
+    option(u"threads", 't', INTEGER, 0, 1, 1, 64);
+    help(u"threads",
+         u"Analyze the input file in parallel, using the specified number of threads. "
+         u"The file is split into contiguous chunks which are analyzed independently and the results are merged. "
+         u"The analysis report is the same as with a sequential analysis. "
+         u"This option is useful on very large files only and requires a regular file as input, not a pipe. "
+         u"By default, the file is analyzed sequentially, using one thread.");
+
     analyze(argc, argv);
 
     // Define all standard analysis options.
@@ -96,12 +121,164 @@ Options::Options(int argc, char *argv[]) :
 
     getValue(infile, u"");
     getValue(bitrate, u"bitrate");
+    getIntValue(threads, u"threads", 1);
     format = ts::LoadTSPacketFormatInputOption(*this);
 
+    if (threads > 1 && infile.empty()) {
+        error(u"--threads cannot be used on standard input");
+    }
+
     exitOnError();
 }
 
 
+//----------------------------------------------------------------------------
+//  Analysis of one chunk of the input file, in a separate thread.
+//----------------------------------------------------------------------------
+
+namespace {
+    class ChunkAnalyzer: public ts::Thread
+    {
+        TS_NOBUILD_NOCOPY(ChunkAnalyzer);
+    public:
+        // Constructor and destructor.
+        // The thread starts reading at byte offset 'offset', first 'context_count' context packets, then 'packet_count' packets.
+        ChunkAnalyzer(const Options& opt, ts::TSPacketFormat format, uint64_t offset, ts::PacketCounter context_count, ts::PacketCounter packet_count);
+        virtual ~ChunkAnalyzer() override;
+
+        // Replay all messages from the thread, after termination. Return false if there was an error.
+        bool replayMessages(ts::Report& report) { return _report.replay(report); }
+
+        // Analysis of the chunk, valid after termination.
+        ts::TSAnalyzerReport& analyzer() { return _analyzer; }
+        ts::DuckContext& duck() { return _duck; }
+
+    private:
+        const Options&           _opt;
+        ts::DeferredReport       _report;
+        ts::DuckContext          _duck;
+        ts::TSAnalyzerReport     _analyzer;
+        const ts::TSPacketFormat _format;
+        const uint64_t           _offset;
+        const ts::PacketCounter  _context_count;
+        const ts::PacketCounter  _packet_count;
+
+        // Thread main code.
+        virtual void main() override;
+    };
+
+    typedef ts::SafePtr<ChunkAnalyzer> ChunkAnalyzerPtr;
+}
+
+// Constructor.
+ChunkAnalyzer::ChunkAnalyzer(const Options& opt, ts::TSPacketFormat format, uint64_t offset, ts::PacketCounter context_count, ts::PacketCounter packet_count) :
+    _opt(opt),
+    _report(opt.maxSeverity()),
+    _duck(&_report),
+    _analyzer(_duck, opt.bitrate, ts::BitRateConfidence::OVERRIDE),
+    _format(format),
+    _offset(offset),
+    _context_count(context_count),
+    _packet_count(packet_count)
+{
+    // Same DVB options as the main context.
+    ts::DuckContext::SavedArgs args;
+    opt.duck.saveArgs(args);
+    _duck.restoreArgs(args);
+    _analyzer.setAnalysisOptions(opt.analysis);
+}
+
+// Destructor.
+ChunkAnalyzer::~ChunkAnalyzer()
+{
+    waitForTermination();
+}
+
+// Thread main code.
+void ChunkAnalyzer::main()
+{
+    ts::TSFile file;
+    if (!file.openRead(_opt.infile, 1, _offset, _report, _format)) {
+        return;
+    }
+
+    ts::TSPacketVector buffer(PACKETS_PER_READ);
+    size_t count = 0;
+
+    // Context packets, from the end of the previous chunk.
+    ts::PacketCounter remain = _context_count;
+    while (remain > 0 && (count = file.readPackets(buffer.data(), nullptr, size_t(std::min<ts::PacketCounter>(remain, buffer.size())), _report)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            _analyzer.feedContextPacket(buffer[i]);
+        }
+        remain -= count;
+    }
+
+    // Packets in the chunk.
+    remain = _packet_count;
+    while (remain > 0 && (count = file.readPackets(buffer.data(), nullptr, size_t(std::min<ts::PacketCounter>(remain, buffer.size())), _report)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            _analyzer.feedPacket(buffer[i]);
+        }
+        remain -= count;
+    }
+    file.close(_report);
+}
+
+
+//----------------------------------------------------------------------------
+//  Parallel analysis of the input file. Return false if not possible.
+//----------------------------------------------------------------------------
+
+namespace {
+    bool ParallelAnalysis(Options& opt, ts::TSAnalyzer& analyzer, bool& success)
+    {
+        // Read the first packet to get the file format and the size of packets.
+        ts::TSFile file;
+        ts::TSPacket pkt;
+        if (!file.openRead(opt.infile, 1, 0, opt, opt.format)) {
+            success = false;
+            return true;
+        }
+        const bool valid = file.readPackets(&pkt, nullptr, 1, opt) == 1;
+        const ts::TSPacketFormat format = file.packetFormat();
+        const size_t packet_size = file.packetHeaderSize() + ts::PKT_SIZE + file.packetTrailerSize();
+        file.close(opt);
+
+        // Split the file in chunks, if large enough.
+        const int64_t file_size = ts::GetFileSize(opt.infile);
+        const ts::PacketCounter total = file_size <= 0 ? 0 : ts::PacketCounter(file_size) / packet_size;
+        const size_t threads = size_t(std::min<ts::PacketCounter>(opt.threads, total / MIN_CHUNK_PACKETS));
+        if (!valid || threads < 2) {
+            opt.verbose(u"file too small for parallel analysis, using sequential analysis");
+            return false;
+        }
+        const ts::PacketCounter chunk = total / threads;
+        opt.verbose(u"analyzing %'d packets using %d threads", {total, threads});
+
+        // Start all threads. The last one reads up to the end of file.
+        std::vector<ChunkAnalyzerPtr> workers(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            const ts::PacketCounter start = i * chunk;
+            const ts::PacketCounter context = std::min(start, CONTEXT_PACKETS);
+            const ts::PacketCounter count = i + 1 < threads ? chunk : std::numeric_limits<ts::PacketCounter>::max();
+            workers[i] = new ChunkAnalyzer(opt, format, (start - context) * packet_size, context, count);
+            workers[i]->start();
+        }
+
+        // Wait for all threads and merge the results, in order.
+        success = true;
+        for (const auto& worker : workers) {
+            worker->waitForTermination();
+            success = worker->replayMessages(opt) && success;
+            analyzer.merge(worker->analyzer());
+            opt.duck.addStandards(worker->duck().standards());
+        }
+        return true;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 //  Program entry point
 //----------------------------------------------------------------------------
@@ -115,18 +292,26 @@ int MainCode(int argc, char *argv[])
     ts::TSAnalyzerReport analyzer(opt.duck, opt.bitrate, ts::BitRateConfidence::OVERRIDE);
     analyzer.setAnalysisOptions(opt.analysis);
 
-    // Open the TS file.
-    ts::TSFile file;
-    if (!file.openRead(opt.infile, 1, 0, opt, opt.format)) {
-        return EXIT_FAILURE;
-    }
+    // Analyze the file in parallel when requested and possible.
+    bool success = true;
+    if (opt.threads < 2 || !ParallelAnalysis(opt, analyzer, success)) {
 
-    // Analyze all packets in the file.
-    ts::TSPacket pkt;
-    while (file.readPackets(&pkt, nullptr, 1, opt) > 0) {
-        analyzer.feedPacket(pkt);
+        // Open the TS file.
+        ts::TSFile file;
+        if (!file.openRead(opt.infile, 1, 0, opt, opt.format)) {
+            return EXIT_FAILURE;
+        }
+
+        // Analyze all packets in the file.
+        ts::TSPacket pkt;
+        while (file.readPackets(&pkt, nullptr, 1, opt) > 0) {
+            analyzer.feedPacket(pkt);
+        }
+        file.close(opt);
+    }
+    if (!success) {
+        return EXIT_FAILURE;
     }
-    file.close(opt);
 
     // Display analysis results.
     analyzer.report(opt.pager.output(opt), opt.analysis, opt);
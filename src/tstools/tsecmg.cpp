@@ -45,6 +45,14 @@
 #include "tsDuckProtocol.h"
 #include "tsVariable.h"
 #include "tsOneShotPacketizer.h"
+#include "tsTime.h"
+
+#if defined(TS_LINUX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/epoll.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
 TS_MAIN(MainCode);
 
 namespace {
@@ -59,6 +67,16 @@ namespace {
     // Stack size for execution of the client connection thread
     static const size_t CLIENT_STACK_SIZE = 128 * 1024;
 
+    // TCP listen backlog, larger in event loop mode which expects many clients.
+    static const int LISTEN_BACKLOG = 5;
+    static const int EVENT_LOOP_LISTEN_BACKLOG = 256;
+
+    // Max number of events in one call to epoll_wait().
+    static const int EVENT_LOOP_MAX_EVENTS = 64;
+
+    // In event loop mode, the server is identified by id zero in epoll events.
+    static const uint64_t SERVER_ID = 0;
+
     // Instantiation of a TCP connection in a multi-thread context for TLV messages.
     typedef ts::tlv::Connection<ts::Mutex> ECMGConnection;
     typedef ts::SafePtr<ECMGConnection, ts::Mutex> ECMGConnectionPtr;
@@ -82,6 +100,7 @@ namespace {
         int                        logProtocol {ts::Severity::Debug};  // Log level for ECMG <=> SCS protocol.
         int                        logData {ts::Severity::Debug};      // Log level for CW/ECM data messages.
         bool                       once {false};            // Accept only one client.
+        bool                       eventLoop {false};       // Use one event loop instead of one thread per client.
         bool                       reusePort {false};       // Socket option.
         ts::MilliSecond            ecmCompTime {0};         // ECM computation time.
         ts::IPv4SocketAddress      serverAddress {};        // TCP server local address.
@@ -135,6 +154,15 @@ ECMGOptions::ECMGOptions(int argc, char *argv[]) :
          u"Specify the version of the ECMG <=> SCS DVB SimulCrypt protocol. "
          u"Valid values are 2 and 3. The default is 2.");
 
+    option(u"event-loop", 'e');
+    help(u"event-loop",
+         u"Manage all client connections from one single event loop instead of "
+         u"one thread per client connection. This mode uses non-blocking sockets "
+         u"and is more efficient when a large number of SCS connect simultaneously "
+         u"to the ECMG. The ECM computation time (option --comp-time) is emulated "
+         u"without blocking the other connections. "
+         u"This option is available on Linux only.");
+
     option(u"log-data", 0, ts::Severity::Enums, 0, 1, true);
     help(u"log-data", u"level",
          u"Same as --log-protocol but applies to CW_provision and ECM_response "
@@ -188,6 +216,7 @@ ECMGOptions::ECMGOptions(int argc, char *argv[]) :
     logArgs.loadArgs(duck, *this);
     serverAddress.setPort(intValue<uint16_t>(u"port", DEFAULT_SERVER_PORT));
     once = present(u"once");
+    eventLoop = present(u"event-loop");
     reusePort = !present(u"no-reuse-port");
     ecmCompTime = intValue<ts::MilliSecond>(u"comp-time", 0);
     logProtocol = present(u"log-protocol") ? intValue<int>(u"log-protocol", ts::Severity::Info) : ts::Severity::Debug;
@@ -220,6 +249,12 @@ ECMGOptions::ECMGOptions(int argc, char *argv[]) :
     channelStatus.min_CP_duration = 10;  // Minimum crypto period in 100 x ms, 1 second here.
     streamStatus.access_criteria_transfer_mode = false;  // We don't really need access criteria.
 
+#if !defined(TS_LINUX)
+    if (eventLoop) {
+        error(u"--event-loop is supported on Linux only");
+    }
+#endif
+
     exitOnError();
 }
 
@@ -289,31 +324,41 @@ bool ECMGSharedData::closeChannel(uint16_t id)
 
 
 //----------------------------------------------------------------------------
-// A class implementing a thread which manages a client connection.
+// A class implementing the ECMG protocol in a client session.
+// This class is independent of the way messages are sent and received.
 //----------------------------------------------------------------------------
 
-class ECMGClientHandler: public ts::Thread
+class ECMGClientSession
 {
-    TS_NOBUILD_NOCOPY(ECMGClientHandler);
+    TS_NOBUILD_NOCOPY(ECMGClientSession);
 public:
     // Constructor.
-    // When deleteWhenTerminated is true, this object is automatically deleted when the thread terminates.
-    ECMGClientHandler(const ECMGOptions& opt, const ECMGConnectionPtr& conn, ECMGSharedData* shared, bool deleteWhenTerminated);
+    ECMGClientSession(const ECMGOptions& opt, ECMGSharedData* shared);
 
     // Destructor.
-    virtual ~ECMGClientHandler() override;
+    virtual ~ECMGClientSession();
 
-    // Main code of the thread.
-    virtual void main() override;
+    // Process one message from the client. Return false on error.
+    bool handleMessage(const ts::tlv::MessagePtr& msg);
+
+    // Release the channel at end of session, if not done by the client.
+    void releaseChannel();
+
+protected:
+    const ECMGOptions& _opt;
+    ECMGSharedData*    _shared {nullptr};
+
+    // Send a response message.
+    virtual bool send(const ts::tlv::Message* msg) = 0;
+
+    // Send an ECM response, after emulating the computation time of a real ECMG.
+    virtual bool sendECMResponse(const ts::ecmgscs::ECMResponse* msg) = 0;
 
 private:
-    const ECMGOptions&          _opt;
     ts::duck::Protocol          _protocol {};   // To encode ECM structure.
-    ECMGSharedData*             _shared {nullptr};
-    ECMGConnectionPtr           _conn {};
-    ts::UString                 _peer {};
     ts::Variable<uint16_t>      _channel {};    // Current channel id.
     std::map<uint16_t,uint16_t> _streams {};    // Map of current stream id => ECM id.
+    ts::ByteBlockPtr            _ecm_data {new ts::ByteBlock};  // Reused for all ECM serializations.
 
     // Handle the various ECMG client messages.
     bool handleChannelSetup(ts::ecmgscs::ChannelSetup* msg);
@@ -324,104 +369,71 @@ private:
     bool handleStreamCloseRequest(ts::ecmgscs::StreamCloseRequest* msg);
     bool handleCWProvision(ts::ecmgscs::CWProvision* msg);
 
-    // Send a response message.
-    bool send(const ts::tlv::Message* msg)
-    {
-        return _conn->send(*msg, _shared->logger());
-    }
-
     // Send an error related to the msg.
     bool sendErrorResponse(const ts::tlv::Message* msg, uint16_t errorStatus);
 };
 
 
 //----------------------------------------------------------------------------
-// ECMG client constructor and destructor.
+// ECMG client session constructor and destructor.
 //----------------------------------------------------------------------------
 
-ECMGClientHandler::ECMGClientHandler(const ECMGOptions& opt, const ECMGConnectionPtr& conn, ECMGSharedData* shared, bool deleteWhenTerminated) :
+ECMGClientSession::ECMGClientSession(const ECMGOptions& opt, ECMGSharedData* shared) :
     _opt(opt),
-    _shared(shared),
-    _conn(conn)
+    _shared(shared)
 {
-    // Set thread attributes. Beware of deleteWhenTerminated...
-    ts::ThreadAttributes attr;
-    attr.setStackSize(CLIENT_STACK_SIZE);
-    attr.setDeleteWhenTerminated(deleteWhenTerminated);
-    setAttributes(attr);
 }
 
-ECMGClientHandler::~ECMGClientHandler()
+ECMGClientSession::~ECMGClientSession()
 {
-    // Wait for completion of the thread.
-    waitForTermination();
 }
 
 
 //----------------------------------------------------------------------------
-// Main code of the client connection thread.
+// Release the channel at end of session.
 //----------------------------------------------------------------------------
 
-void ECMGClientHandler::main()
+void ECMGClientSession::releaseChannel()
 {
-    _peer = _conn->peerName();
-    _shared->report().verbose(u"%s: session started", {_peer});
-
-    // Normally, an ECMG should handle incoming and outgoing messages independently.
-    // However, here we have a minimal implementation. We never send any request to
-    // the client and the ECM generation is instantaneous. So, we simply wait for
-    // requests from the client and respond to them immediately.
-
-    // Loop on message reception
-    ts::tlv::MessagePtr msg;
-    bool ok = true;
-    while (ok && _conn->receive(msg, nullptr, _shared->logger())) {
-        switch (msg->tag()) {
-            case ts::ecmgscs::Tags::channel_setup:
-                ok = handleChannelSetup(dynamic_cast<ts::ecmgscs::ChannelSetup*>(msg.pointer()));
-                break;
-            case ts::ecmgscs::Tags::channel_test:
-                ok = handleChannelTest(dynamic_cast<ts::ecmgscs::ChannelTest*>(msg.pointer()));
-                break;
-            case ts::ecmgscs::Tags::channel_close:
-                ok = handleChannelClose(dynamic_cast<ts::ecmgscs::ChannelClose*>(msg.pointer()));
-                break;
-            case ts::ecmgscs::Tags::stream_setup:
-                ok = handleStreamSetup(dynamic_cast<ts::ecmgscs::StreamSetup*>(msg.pointer()));
-                break;
-            case ts::ecmgscs::Tags::stream_test:
-                ok = handleStreamTest(dynamic_cast<ts::ecmgscs::StreamTest*>(msg.pointer()));
-                break;
-            case ts::ecmgscs::Tags::stream_close_request:
-                ok = handleStreamCloseRequest(dynamic_cast<ts::ecmgscs::StreamCloseRequest*>(msg.pointer()));
-                break;
-            case ts::ecmgscs::Tags::CW_provision:
-                ok = handleCWProvision(dynamic_cast<ts::ecmgscs::CWProvision*>(msg.pointer()));
-                break;
-            case ts::ecmgscs::Tags::channel_status:
-            case ts::ecmgscs::Tags::stream_status:
-            case ts::ecmgscs::Tags::channel_error:
-            case ts::ecmgscs::Tags::stream_error:
-                // Silently ignore unsollicited status or error messages.
-                break;
-            default:
-                // Received an invalid message for ECMG.
-                ok = sendErrorResponse(msg.pointer(), ts::ecmgscs::Errors::inv_message);
-                break;
-        }
-    }
-
-    // Error while receiving or sending messages, most likely a client disconnection.
-    _conn->disconnect(NULLREP);
-    _conn->close(_shared->report());
-
-    // Make sure to release the channel if not done by the clients.
     if (_channel.set()) {
         _shared->closeChannel(_channel.value());
         _channel.clear();
     }
+    _streams.clear();
+}
 
-    _shared->report().verbose(u"%s: session completed", {_peer});
+
+//----------------------------------------------------------------------------
+// Process one message from the client.
+//----------------------------------------------------------------------------
+
+bool ECMGClientSession::handleMessage(const ts::tlv::MessagePtr& msg)
+{
+    switch (msg->tag()) {
+        case ts::ecmgscs::Tags::channel_setup:
+            return handleChannelSetup(dynamic_cast<ts::ecmgscs::ChannelSetup*>(msg.pointer()));
+        case ts::ecmgscs::Tags::channel_test:
+            return handleChannelTest(dynamic_cast<ts::ecmgscs::ChannelTest*>(msg.pointer()));
+        case ts::ecmgscs::Tags::channel_close:
+            return handleChannelClose(dynamic_cast<ts::ecmgscs::ChannelClose*>(msg.pointer()));
+        case ts::ecmgscs::Tags::stream_setup:
+            return handleStreamSetup(dynamic_cast<ts::ecmgscs::StreamSetup*>(msg.pointer()));
+        case ts::ecmgscs::Tags::stream_test:
+            return handleStreamTest(dynamic_cast<ts::ecmgscs::StreamTest*>(msg.pointer()));
+        case ts::ecmgscs::Tags::stream_close_request:
+            return handleStreamCloseRequest(dynamic_cast<ts::ecmgscs::StreamCloseRequest*>(msg.pointer()));
+        case ts::ecmgscs::Tags::CW_provision:
+            return handleCWProvision(dynamic_cast<ts::ecmgscs::CWProvision*>(msg.pointer()));
+        case ts::ecmgscs::Tags::channel_status:
+        case ts::ecmgscs::Tags::stream_status:
+        case ts::ecmgscs::Tags::channel_error:
+        case ts::ecmgscs::Tags::stream_error:
+            // Silently ignore unsollicited status or error messages.
+            return true;
+        default:
+            // Received an invalid message for ECMG.
+            return sendErrorResponse(msg.pointer(), ts::ecmgscs::Errors::inv_message);
+    }
 }
 
 
@@ -429,7 +441,7 @@ void ECMGClientHandler::main()
 // Send an error related to the msg.
 //----------------------------------------------------------------------------
 
-bool ECMGClientHandler::sendErrorResponse(const ts::tlv::Message* msg, uint16_t errorStatus)
+bool ECMGClientSession::sendErrorResponse(const ts::tlv::Message* msg, uint16_t errorStatus)
 {
     const ts::tlv::ChannelMessage* channelMsg = nullptr;
     const ts::tlv::StreamMessage* streamMsg = nullptr;
@@ -467,7 +479,7 @@ bool ECMGClientHandler::sendErrorResponse(const ts::tlv::Message* msg, uint16_t
 // Handle the various types of messages from the client.
 //----------------------------------------------------------------------------
 
-bool ECMGClientHandler::handleChannelSetup(ts::ecmgscs::ChannelSetup* msg)
+bool ECMGClientSession::handleChannelSetup(ts::ecmgscs::ChannelSetup* msg)
 {
     assert(msg != nullptr);
     if (_channel.set()) {
@@ -488,7 +500,7 @@ bool ECMGClientHandler::handleChannelSetup(ts::ecmgscs::ChannelSetup* msg)
 }
 
 
-bool ECMGClientHandler::handleChannelTest(ts::ecmgscs::ChannelTest* msg)
+bool ECMGClientSession::handleChannelTest(ts::ecmgscs::ChannelTest* msg)
 {
     assert(msg != nullptr);
     if (_channel != msg->channel_id) {
@@ -505,7 +517,7 @@ bool ECMGClientHandler::handleChannelTest(ts::ecmgscs::ChannelTest* msg)
 }
 
 
-bool ECMGClientHandler::handleChannelClose(ts::ecmgscs::ChannelClose* msg)
+bool ECMGClientSession::handleChannelClose(ts::ecmgscs::ChannelClose* msg)
 {
     assert(msg != nullptr);
     if (_channel != msg->channel_id) {
@@ -522,7 +534,7 @@ bool ECMGClientHandler::handleChannelClose(ts::ecmgscs::ChannelClose* msg)
 }
 
 
-bool ECMGClientHandler::handleStreamSetup(ts::ecmgscs::StreamSetup* msg)
+bool ECMGClientSession::handleStreamSetup(ts::ecmgscs::StreamSetup* msg)
 {
     assert(msg != nullptr);
     if (_channel != msg->channel_id) {
@@ -545,7 +557,7 @@ bool ECMGClientHandler::handleStreamSetup(ts::ecmgscs::StreamSetup* msg)
 }
 
 
-bool ECMGClientHandler::handleStreamTest(ts::ecmgscs::StreamTest* msg)
+bool ECMGClientSession::handleStreamTest(ts::ecmgscs::StreamTest* msg)
 {
     assert(msg != nullptr);
     if (_channel != msg->channel_id) {
@@ -567,7 +579,7 @@ bool ECMGClientHandler::handleStreamTest(ts::ecmgscs::StreamTest* msg)
 }
 
 
-bool ECMGClientHandler::handleStreamCloseRequest(ts::ecmgscs::StreamCloseRequest* msg)
+bool ECMGClientSession::handleStreamCloseRequest(ts::ecmgscs::StreamCloseRequest* msg)
 {
     assert(msg != nullptr);
     if (_channel != msg->channel_id) {
@@ -589,7 +601,7 @@ bool ECMGClientHandler::handleStreamCloseRequest(ts::ecmgscs::StreamCloseRequest
 }
 
 
-bool ECMGClientHandler::handleCWProvision(ts::ecmgscs::CWProvision* msg)
+bool ECMGClientSession::handleCWProvision(ts::ecmgscs::CWProvision* msg)
 {
     assert(msg != nullptr);
     if (_channel != msg->channel_id) {
@@ -637,10 +649,12 @@ bool ECMGClientHandler::handleCWProvision(ts::ecmgscs::CWProvision* msg)
             ecm.access_criteria = msg->access_criteria;
         }
 
-        // Serialize the ECM section payload.
-        ts::ByteBlockPtr ecmBin(new ts::ByteBlock);
-        ts::tlv::Serializer serial(ecmBin);
-        ecm.serialize(serial);
+        // Serialize the ECM section payload, reusing the same buffer.
+        _ecm_data->clear();
+        {
+            ts::tlv::Serializer serial(_ecm_data);
+            ecm.serialize(serial);
+        }
 
         // Compute the table id for the ECM, 0x80 or 0x81. There are two incompatible possibilities.
         // First method is to copy the parity of the crypto period number. Second method is to
@@ -652,7 +666,7 @@ bool ECMGClientHandler::handleCWProvision(ts::ecmgscs::CWProvision* msg)
         const ts::TID tid = ts::TID(ts::TID_ECM_80 | (msg->CP_number & 0x01));
 
         // Build the ECM section.
-        ts::SectionPtr ecmSection(new ts::Section(tid, true, ecmBin->data(), ecmBin->size()));
+        ts::SectionPtr ecmSection(new ts::Section(tid, true, _ecm_data->data(), _ecm_data->size()));
 
         // Format ECM for the response message.
         if (_opt.channelStatus.section_TSpkt_flag) {
@@ -670,16 +684,459 @@ bool ECMGClientHandler::handleCWProvision(ts::ecmgscs::CWProvision* msg)
             resp.ECM_datagram.copy(ecmSection->content(), ecmSection->size());
         }
 
-        // Emulate the computation time of a real ECMG.
-        if (_opt.ecmCompTime > 0) {
-            ts::SleepThread(_opt.ecmCompTime);
+        return sendECMResponse(&resp);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// A class implementing a thread which manages a client connection.
+//----------------------------------------------------------------------------
+
+class ECMGClientHandler: public ts::Thread, private ECMGClientSession
+{
+    TS_NOBUILD_NOCOPY(ECMGClientHandler);
+public:
+    // Constructor.
+    // When deleteWhenTerminated is true, this object is automatically deleted when the thread terminates.
+    ECMGClientHandler(const ECMGOptions& opt, const ECMGConnectionPtr& conn, ECMGSharedData* shared, bool deleteWhenTerminated);
+
+    // Destructor.
+    virtual ~ECMGClientHandler() override;
+
+    // Main code of the thread.
+    virtual void main() override;
+
+private:
+    ECMGConnectionPtr _conn {};
+    ts::UString       _peer {};
+
+    // Implementation of ECMGClientSession.
+    virtual bool send(const ts::tlv::Message* msg) override
+    {
+        return _conn->send(*msg, _shared->logger());
+    }
+    virtual bool sendECMResponse(const ts::ecmgscs::ECMResponse* msg) override;
+};
+
+
+//----------------------------------------------------------------------------
+// ECMG client constructor and destructor.
+//----------------------------------------------------------------------------
+
+ECMGClientHandler::ECMGClientHandler(const ECMGOptions& opt, const ECMGConnectionPtr& conn, ECMGSharedData* shared, bool deleteWhenTerminated) :
+    ECMGClientSession(opt, shared),
+    _conn(conn)
+{
+    // Set thread attributes. Beware of deleteWhenTerminated...
+    ts::ThreadAttributes attr;
+    attr.setStackSize(CLIENT_STACK_SIZE);
+    attr.setDeleteWhenTerminated(deleteWhenTerminated);
+    setAttributes(attr);
+}
+
+ECMGClientHandler::~ECMGClientHandler()
+{
+    // Wait for completion of the thread.
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Main code of the client connection thread.
+//----------------------------------------------------------------------------
+
+void ECMGClientHandler::main()
+{
+    _peer = _conn->peerName();
+    _shared->report().verbose(u"%s: session started", {_peer});
+
+    // Normally, an ECMG should handle incoming and outgoing messages independently.
+    // However, here we have a minimal implementation. We never send any request to
+    // the client and the ECM generation is instantaneous. So, we simply wait for
+    // requests from the client and respond to them immediately.
+
+    // Loop on message reception
+    ts::tlv::MessagePtr msg;
+    bool ok = true;
+    while (ok && _conn->receive(msg, nullptr, _shared->logger())) {
+        ok = handleMessage(msg);
+    }
+
+    // Error while receiving or sending messages, most likely a client disconnection.
+    _conn->disconnect(NULLREP);
+    _conn->close(_shared->report());
+
+    // Make sure to release the channel if not done by the clients.
+    releaseChannel();
+
+    _shared->report().verbose(u"%s: session completed", {_peer});
+}
+
+
+//----------------------------------------------------------------------------
+// Send an ECM response in the client thread.
+//----------------------------------------------------------------------------
+
+bool ECMGClientHandler::sendECMResponse(const ts::ecmgscs::ECMResponse* msg)
+{
+    // Emulate the computation time of a real ECMG.
+    if (_opt.ecmCompTime > 0) {
+        ts::SleepThread(_opt.ecmCompTime);
+    }
+    return send(msg);
+}
+
+
+//----------------------------------------------------------------------------
+// Event loop mode: all client connections are managed from one thread.
+//----------------------------------------------------------------------------
+
+#if defined(TS_LINUX)
+
+class ECMGEventLoop;
+
+// A client session in the event loop, using a non-blocking connection.
+class ECMGEventClient: public ECMGClientSession
+{
+    TS_NOBUILD_NOCOPY(ECMGEventClient);
+public:
+    // Constructor.
+    ECMGEventClient(const ECMGOptions& opt, ECMGSharedData* shared, ECMGEventLoop* loop, uint64_t id, const ECMGConnectionPtr& conn);
+
+    const uint64_t    id;          // Client identifier in the event loop.
+    ECMGConnectionPtr conn;        // Non-blocking TCP connection.
+    ts::UString       peer {};     // Peer name, for messages.
+    uint32_t          events {0};  // Current epoll events for this client.
+
+    // Send a response message.
+    virtual bool send(const ts::tlv::Message* msg) override
+    {
+        return conn->sendNonBlocking(*msg, _shared->logger());
+    }
+
+private:
+    ECMGEventLoop* _loop {nullptr};
+
+    // ECM responses are delayed by the event loop, without blocking other clients.
+    virtual bool sendECMResponse(const ts::ecmgscs::ECMResponse* msg) override;
+};
+
+typedef ts::SafePtr<ECMGEventClient, ts::NullMutex> ECMGEventClientPtr;
+
+// The event loop, using epoll.
+class ECMGEventLoop
+{
+    TS_NOBUILD_NOCOPY(ECMGEventLoop);
+public:
+    // Constructor and destructor.
+    ECMGEventLoop(const ECMGOptions& opt, ECMGSharedData* shared, ts::TCPServer& server);
+    ~ECMGEventLoop();
+
+    // Run the event loop. Return false on error.
+    bool run();
+
+    // Send an ECM response to a client after the ECM computation time.
+    void deferResponse(uint64_t id, const ts::ecmgscs::ECMResponse* msg);
+
+private:
+    // A delayed ECM response.
+    struct DeferredResponse
+    {
+        ts::Time            due;   // When to send the response.
+        uint64_t            id;    // Client identifier.
+        ts::tlv::MessagePtr msg;   // Message to send.
+    };
+
+    const ECMGOptions&                   _opt;
+    ECMGSharedData*                      _shared {nullptr};
+    ts::TCPServer&                       _server;
+    int                                  _epoll {-1};     // Epoll file descriptor.
+    bool                                 _accept {true};  // Still accepting new clients.
+    uint64_t                             _next_id {1};    // Next client identifier.
+    std::map<uint64_t,ECMGEventClientPtr> _clients {};    // Active clients, by identifier.
+    std::deque<DeferredResponse>         _deferred {};    // Delayed responses, in due time order.
+
+    // Accept a new client. Errors are reported but do not stop the server.
+    void acceptClient();
+
+    // Process events on a client.
+    void processClient(const ECMGEventClientPtr& client, uint32_t events);
+
+    // Update the epoll events of a client, depending on pending output. Return false on error.
+    bool updateEvents(const ECMGEventClientPtr& client);
+
+    // Close a client session.
+    void closeClient(const ECMGEventClientPtr& client);
+
+    // Send all deferred responses which are due.
+    void sendDeferredResponses();
+};
+
+
+
+//----------------------------------------------------------------------------
+// Event loop client implementation.
+//----------------------------------------------------------------------------
+
+ECMGEventClient::ECMGEventClient(const ECMGOptions& opt, ECMGSharedData* shared, ECMGEventLoop* loop, uint64_t id_, const ECMGConnectionPtr& conn_) :
+    ECMGClientSession(opt, shared),
+    id(id_),
+    conn(conn_),
+    _loop(loop)
+{
+}
+
+bool ECMGEventClient::sendECMResponse(const ts::ecmgscs::ECMResponse* msg)
+{
+    if (_opt.ecmCompTime > 0) {
+        _loop->deferResponse(id, msg);
+        return true;
+    }
+    else {
+        return send(msg);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Event loop constructor and destructor.
+//----------------------------------------------------------------------------
+
+ECMGEventLoop::ECMGEventLoop(const ECMGOptions& opt, ECMGSharedData* shared, ts::TCPServer& server) :
+    _opt(opt),
+    _shared(shared),
+    _server(server)
+{
+}
+
+ECMGEventLoop::~ECMGEventLoop()
+{
+    for (auto& it : _clients) {
+        it.second->conn->disconnect(NULLREP);
+        it.second->conn->close(NULLREP);
+        it.second->releaseChannel();
+    }
+    _clients.clear();
+    if (_epoll >= 0) {
+        ::close(_epoll);
+        _epoll = -1;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Send an ECM response to a client after the ECM computation time.
+//----------------------------------------------------------------------------
+
+void ECMGEventLoop::deferResponse(uint64_t id, const ts::ecmgscs::ECMResponse* msg)
+{
+    // The computation time is constant, the deferred responses remain sorted by due time.
+    _deferred.push_back({ts::Time::CurrentUTC() + _opt.ecmCompTime, id, ts::tlv::MessagePtr(new ts::ecmgscs::ECMResponse(*msg))});
+}
+
+
+//----------------------------------------------------------------------------
+// Run the event loop.
+//----------------------------------------------------------------------------
+
+bool ECMGEventLoop::run()
+{
+    _epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll < 0) {
+        _shared->report().error(u"error creating epoll: %s", {ts::SysErrorCodeMessage()});
+        return false;
+    }
+
+    // Wait for incoming connections on the server socket.
+    ::epoll_event ev;
+    TS_ZERO(ev);
+    ev.events = EPOLLIN;
+    ev.data.u64 = SERVER_ID;
+    if (::epoll_ctl(_epoll, EPOLL_CTL_ADD, _server.getSocket(), &ev) < 0) {
+        _shared->report().error(u"error adding server socket to epoll: %s", {ts::SysErrorCodeMessage()});
+        return false;
+    }
+
+    ::epoll_event events[EVENT_LOOP_MAX_EVENTS];
+
+    // In --once mode, stop after the first client session.
+    while (_accept || !_clients.empty()) {
+
+        // Wait until the next deferred response is due.
+        int timeout = -1;
+        if (!_deferred.empty()) {
+            timeout = int(std::max<ts::MilliSecond>(0, _deferred.front().due - ts::Time::CurrentUTC()));
         }
 
-        return send(&resp);
+        const int count = ::epoll_wait(_epoll, events, EVENT_LOOP_MAX_EVENTS, timeout);
+        if (count < 0 && errno != EINTR) {
+            _shared->report().error(u"epoll error: %s", {ts::SysErrorCodeMessage()});
+            return false;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.u64 == SERVER_ID) {
+                acceptClient();
+            }
+            else {
+                // The client may have been closed while processing a previous event.
+                const auto it = _clients.find(events[i].data.u64);
+                if (it != _clients.end()) {
+                    processClient(it->second, events[i].events);
+                }
+            }
+        }
+
+        sendDeferredResponses();
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Accept a new client.
+//----------------------------------------------------------------------------
+
+void ECMGEventLoop::acceptClient()
+{
+    // The server socket is ready, accept() does not block. An accept error is
+    // typically transient (aborted connection, no more file descriptors) and
+    // concerns one client only. It is reported but the other clients continue.
+    ts::IPv4SocketAddress clientAddress;
+    ECMGConnectionPtr conn(new ECMGConnection(_opt.ecmgscs, true, 3));
+    ts::CheckNonNull(conn.pointer());
+    if (!_server.accept(*conn, clientAddress, _shared->report())) {
+        _shared->report().warning(u"failed to accept a client connection, continuing");
+        return;
+    }
+    if (!conn->setNonBlocking(true, _shared->report())) {
+        conn->close(NULLREP);
+        return;
+    }
+
+    ECMGEventClientPtr client(new ECMGEventClient(_opt, _shared, this, _next_id++, conn));
+    ts::CheckNonNull(client.pointer());
+    client->peer = conn->peerName();
+    client->events = EPOLLIN;
+
+    ::epoll_event ev;
+    TS_ZERO(ev);
+    ev.events = client->events;
+    ev.data.u64 = client->id;
+    if (::epoll_ctl(_epoll, EPOLL_CTL_ADD, conn->getSocket(), &ev) < 0) {
+        _shared->report().error(u"error adding client socket to epoll: %s", {ts::SysErrorCodeMessage()});
+        conn->close(NULLREP);
+        return;
+    }
+    _clients[client->id] = client;
+    _shared->report().verbose(u"%s: session started", {client->peer});
+
+    // With --once, stop listening after the first client.
+    if (_opt.once) {
+        ::epoll_ctl(_epoll, EPOLL_CTL_DEL, _server.getSocket(), nullptr);
+        _accept = false;
     }
 }
 
 
+//----------------------------------------------------------------------------
+// Process events on a client.
+//----------------------------------------------------------------------------
+
+void ECMGEventLoop::processClient(const ECMGEventClientPtr& client, uint32_t events)
+{
+    bool ok = true;
+
+    // Send pending output first when the socket becomes writable.
+    if ((events & EPOLLOUT) != 0) {
+        ok = client->conn->flushOutput(_shared->report());
+    }
+
+    // Process all complete messages which are available.
+    // Disconnections and errors are detected when reading the socket.
+    if (ok && (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0) {
+        ts::tlv::MessagePtr msg;
+        while ((ok = client->conn->receiveNonBlocking(msg, _shared->logger())) && !msg.isNull()) {
+            if (!(ok = client->handleMessage(msg))) {
+                break;
+            }
+        }
+    }
+
+    if (!ok || !updateEvents(client)) {
+        closeClient(client);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Update the epoll events of a client.
+//----------------------------------------------------------------------------
+
+bool ECMGEventLoop::updateEvents(const ECMGEventClientPtr& client)
+{
+    // Wait for the socket to be writable only when some output is pending.
+    const uint32_t events = EPOLLIN | (client->conn->hasPendingOutput() ? uint32_t(EPOLLOUT) : 0);
+    if (events != client->events) {
+        ::epoll_event ev;
+        TS_ZERO(ev);
+        ev.events = events;
+        ev.data.u64 = client->id;
+        if (::epoll_ctl(_epoll, EPOLL_CTL_MOD, client->conn->getSocket(), &ev) < 0) {
+            _shared->report().error(u"error updating client socket in epoll: %s", {ts::SysErrorCodeMessage()});
+            return false;
+        }
+        client->events = events;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Close a client session.
+//----------------------------------------------------------------------------
+
+void ECMGEventLoop::closeClient(const ECMGEventClientPtr& client)
+{
+    // Keep a reference on the client while removing it from the map.
+    ECMGEventClientPtr keep(client);
+    ::epoll_ctl(_epoll, EPOLL_CTL_DEL, keep->conn->getSocket(), nullptr);
+    keep->conn->disconnect(NULLREP);
+    keep->conn->close(_shared->report());
+
+    // Make sure to release the channel if not done by the clients.
+    keep->releaseChannel();
+    _clients.erase(keep->id);
+
+    _shared->report().verbose(u"%s: session completed", {keep->peer});
+}
+
+
+//----------------------------------------------------------------------------
+// Send all deferred responses which are due.
+//----------------------------------------------------------------------------
+
+void ECMGEventLoop::sendDeferredResponses()
+{
+    const ts::Time now(ts::Time::CurrentUTC());
+    while (!_deferred.empty() && _deferred.front().due <= now) {
+        const DeferredResponse resp(_deferred.front());
+        _deferred.pop_front();
+        // The client may have disconnected in the meantime.
+        const auto it = _clients.find(resp.id);
+        if (it != _clients.end()) {
+            const ECMGEventClientPtr client(it->second);
+            if (!client->send(resp.msg.pointer()) || !updateEvents(client)) {
+                closeClient(client);
+            }
+        }
+    }
+}
+
+#endif // TS_LINUX
+
+
 //----------------------------------------------------------------------------
 //  Program entry point
 //----------------------------------------------------------------------------
@@ -696,7 +1153,7 @@ int MainCode(int argc, char *argv[])
     if (!server.open(shared.report()) ||
         !server.reusePort(opt.reusePort, shared.report()) ||
         !server.bind(opt.serverAddress, shared.report()) ||
-        !server.listen(5, shared.report()))
+        !server.listen(opt.eventLoop ? EVENT_LOOP_LISTEN_BACKLOG : LISTEN_BACKLOG, shared.report()))
     {
         return EXIT_FAILURE;
     }
@@ -708,6 +1165,14 @@ int MainCode(int argc, char *argv[])
     // the client disconnects, creating a SIGPIPE signal.
     ts::IgnorePipeSignal();
 
+#if defined(TS_LINUX)
+    // In event loop mode, all client connections are managed in the main thread.
+    if (opt.eventLoop) {
+        ECMGEventLoop loop(opt, &shared, server);
+        return loop.run() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+#endif
+
     // Manage incoming client connections.
     for (;;) {
 
@@ -50,10 +50,18 @@ namespace {
     static const ts::TID         DEFAULT_EMM_MAX_TID    = ts::TID_EMM_LAST;
     static const size_t          DEFAULT_BYTES_PER_SEND = 500;
     static const ts::MilliSecond DEFAULT_UDP_END_WAIT   = 100;
+    static const size_t          DEFAULT_QUEUE_SIZE     = 32;
 
     // Minimum interval between two send operations.
     static const ts::NanoSecond MIN_SEND_INTERVAL = 4 * ts::NanoSecPerMilliSec; // 4 ms
 
+    // In bulk mode, interval between two send operations and maximum data size per data_provision.
+    static const ts::NanoSecond BULK_SEND_INTERVAL = 10 * ts::NanoSecPerMilliSec; // 10 ms
+    static const size_t MAX_BYTES_PER_SEND = 0xEFFF;
+
+    // In bulk mode, interval between two reports of the achieved bitrate.
+    static const ts::NanoSecond BULK_REPORT_INTERVAL = 10 * ts::NanoSecPerSec; // 10 s
+
     // Values for --type option.
     const ts::Enumeration DataTypeEnum({
         {u"emm",          0},
@@ -89,6 +97,9 @@ namespace {
         uint16_t              dataId {0};                // Data_id, see EMMG/PDG <=> MUX protocol.
         uint8_t               dataType {0};              // Data_type, see EMMG/PDG <=> MUX protocol.
         bool                  sectionMode {false};       // If true, send data in section format.
+        bool                  bulkMode {false};          // Compute send sizes from bandwidth, use a send queue.
+        size_t                queueSize {0};             // Max number of queued data_provision in bulk mode.
+        uint16_t              maxBandwidth {0};          // Bandwidth from --bandwidth in kb/s.
         uint16_t              sendBandwidth {0};         // Bandwidth of sent data in kb/s.
         uint16_t              requestedBandwidth {0};    // Requested bandwidth in kb/s.
         bool                  ignoreAllocatedBW {false}; // Ignore the returned allocated bandwidth.
@@ -126,7 +137,18 @@ EMMGOptions::EMMGOptions(int argc, char *argv[]) :
          u"Specify the bandwidth of the data which are sent to the MUX in kilobits "
          u"per second. Default: " + ts::UString::Decimal(DEFAULT_BANDWIDTH) + u" kb/s.");
 
-    option(u"bytes-per-send", 0, INTEGER, 0, 1, 0x20, 0xEFFF);
+    option(u"bulk");
+    help(u"bulk",
+         u"Bulk mode for high bitrates. The size of each data_provision message is computed from "
+         u"the allocated bandwidth, packing as many sections or packets as possible, up to " +
+         ts::UString::Decimal(MAX_BYTES_PER_SEND) + u" bytes, every " +
+         ts::UString::Decimal(BULK_SEND_INTERVAL / ts::NanoSecPerMilliSec) + u" ms. "
+         u"The option --bytes-per-send is ignored. The messages are sent by a separate thread through "
+         u"a bounded queue (see option --queue-size). When the MUX sends a new bandwidth allocation "
+         u"during the session, the data bitrate is adjusted accordingly. In verbose mode, the "
+         u"achieved bitrate is periodically reported and compared with the allocated bandwidth.");
+
+    option(u"bytes-per-send", 0, INTEGER, 0, 1, 0x20, MAX_BYTES_PER_SEND);
     help(u"bytes-per-send",
          u"Specify the average size in bytes of each data provision. The exact value "
          u"depends on sections and packets sizes. Default: " + ts::UString::Decimal(DEFAULT_BYTES_PER_SEND) + u" bytes.");
@@ -198,6 +220,11 @@ EMMGOptions::EMMGOptions(int argc, char *argv[]) :
          u"Specify the IP address (or host name) and TCP port of the MUX. This is a "
          u"required parameter, there is no default.");
 
+    option(u"queue-size", 'q', INTEGER, 0, 1, 1, 10000);
+    help(u"queue-size",
+         u"With --bulk, specify the maximum number of data_provision messages which are queued "
+         u"before being sent to the MUX. Default: " + ts::UString::Decimal(DEFAULT_QUEUE_SIZE) + u".");
+
     option(u"requested-bandwidth", 0, INT16);
     help(u"requested-bandwidth",
          u"This option sets the DVB SimulCrypt parameter 'bandwidth' in the "
@@ -250,7 +277,10 @@ EMMGOptions::EMMGOptions(int argc, char *argv[]) :
     getIntValue(streamId, u"stream-id", 1);
     getIntValue(dataType, u"type", 0);
     sectionMode = present(u"section-mode");
-    getIntValue(sendBandwidth, u"bandwidth", DEFAULT_BANDWIDTH);
+    bulkMode = present(u"bulk");
+    getIntValue(queueSize, u"queue-size", DEFAULT_QUEUE_SIZE);
+    getIntValue(maxBandwidth, u"bandwidth", DEFAULT_BANDWIDTH);
+    sendBandwidth = maxBandwidth;
     dataBitrate = sendBandwidth * 1000;
     getIntValue(requestedBandwidth, u"requested-bandwidth", sendBandwidth);
     ignoreAllocatedBW = present(u"ignore-allocated");
@@ -319,6 +349,8 @@ bool EMMGOptions::adjustBandwidth(uint16_t allocated)
     verbose(u"Allocated bandwidth: %'d kb/s", {allocated});
 
     // Reduce the bandwidth if not enough was allocated.
+    // Restart from the planned bandwidth since the allocation may increase during the session.
+    sendBandwidth = maxBandwidth;
     if (sendBandwidth > allocated) {
         if (ignoreAllocatedBW) {
             info(u"Allocated bandwidth %'d kb/s but will send data at %'d kbs/s because of --ignore-allocated", {allocated, sendBandwidth});
@@ -349,6 +381,15 @@ bool EMMGOptions::adjustBandwidth(uint16_t allocated)
     }
     info(u"Target data bitrate: %'d b/s", {dataBitrate});
 
+    // In bulk mode, compute the size of each send operation from the bitrate, up to the maximum size.
+    if (bulkMode) {
+        bytesPerSend = std::max<size_t>(ts::PKT_SIZE, std::min<size_t>(MAX_BYTES_PER_SEND, ((dataBitrate * BULK_SEND_INTERVAL) / (8 * ts::NanoSecPerSec)).toInt()));
+        if (!sectionMode) {
+            bytesPerSend = ts::round_down<size_t>(bytesPerSend, ts::PKT_SIZE);
+        }
+        info(u"Bytes per data_provision: %'d", {bytesPerSend});
+    }
+
     // Compute interval between two send operations in nanoseconds.
     sendInterval = std::max<ts::NanoSecond>(MIN_SEND_INTERVAL, ((bytesPerSend * 8 * ts::NanoSecPerSec) / dataBitrate).toInt());
 
@@ -449,7 +490,11 @@ int MainCode(int argc, char *argv[])
     EMMGOptions opt(argc, argv);
 
     // An object to manage the TCP connection with the MUX.
+    // In bulk mode, the data_provision messages are sent by a separate thread.
     ts::EMMGClient client(opt.duck, opt.emmgmux);
+    if (opt.bulkMode) {
+        client.setSendQueueSize(opt.queueSize);
+    }
     ts::emmgmux::ChannelStatus channelStatus(opt.emmgmux);
     ts::emmgmux::StreamStatus streamStatus(opt.emmgmux);
 
@@ -497,10 +542,39 @@ int MainCode(int argc, char *argv[])
     // This clock will be our reference.
     ts::Monotonic currentTime(startTime);
 
+    // Number of bytes which were sent before startTime (when the bitrate computation is restarted).
+    uint64_t startBytes = 0;
+
+    // In bulk mode, last allocated bandwidth and time of next bitrate report.
+    uint16_t allocatedBandwidth = client.allocatedBandwidth();
+    const ts::Monotonic sessionStart(startTime);
+    ts::Monotonic nextReport(startTime);
+    nextReport += BULK_REPORT_INTERVAL;
+
     // Send data as long as the maximum is not reached.
     bool ok = true;
     while (ok && client.totalBytes() < opt.maxBytes) {
 
+        // In bulk mode, follow the bandwidth allocations from the MUX and report the achieved bitrate.
+        if (opt.bulkMode) {
+            const uint16_t allocated = client.allocatedBandwidth();
+            if (allocated != allocatedBandwidth) {
+                allocatedBandwidth = allocated;
+                if (!opt.adjustBandwidth(allocated)) {
+                    break;
+                }
+                // Restart the bitrate computation with the new bitrate.
+                startTime = currentTime;
+                startBytes = client.totalBytes();
+            }
+            if (currentTime >= nextReport) {
+                nextReport += BULK_REPORT_INTERVAL;
+                const ts::MicroSecond elapsed = (currentTime - sessionStart) / ts::NanoSecPerMicroSec;
+                opt.verbose(u"Sent %'d bytes, achieved bitrate: %'d b/s, allocated bandwidth: %'d kb/s",
+                            {client.totalBytes(), (client.totalBytes() * 8 * ts::MicroSecPerSec) / std::max<ts::MicroSecond>(1, elapsed), allocatedBandwidth});
+            }
+        }
+
         // Compute the number of bytes we need to send now.
         // Use microseconds instead of nanoseconds to avoid too frequent overflows
         // (the difference between two Monotonic clock values are in nanoseconds).
@@ -512,7 +586,7 @@ int MainCode(int argc, char *argv[])
         }
         else if (!opt.dataBitrate.mulOverflow(duration) && !(opt.dataBitrate * duration).divOverflow(8 * ts::MicroSecPerSec)) {
             // Compute the theoretical number of bytes we should have sent up to now. No overflow.
-            const uint64_t allBytes = ((opt.dataBitrate * duration) / (8 * ts::MicroSecPerSec)).toInt();
+            const uint64_t allBytes = startBytes + ((opt.dataBitrate * duration) / (8 * ts::MicroSecPerSec)).toInt();
             // We need to send the difference.
             if (allBytes > client.totalBytes()) {
                 targetBytes = allBytes - client.totalBytes();
@@ -522,6 +596,7 @@ int MainCode(int argc, char *argv[])
             // Overflow if we count from the beginning, restart the count.
             opt.debug(u"overflow in bitrate computation, resetting bitrate accumulation, bitrate: %'d b/s, duration: %'d ns", {opt.dataBitrate, duration});
             startTime = currentTime;
+            startBytes = client.totalBytes();
             targetBytes = opt.bytesPerSend;
         }
 
@@ -583,7 +658,14 @@ int MainCode(int argc, char *argv[])
         ts::SleepThread(opt.udpEndWait);
     }
 
-    // Disconnect from the MUX.
+    // Disconnect from the MUX. In bulk mode, all queued messages are sent first.
     client.disconnect();
+
+    // Final report of the achieved bitrate.
+    if (opt.bulkMode) {
+        const ts::MicroSecond elapsed = (ts::Monotonic(true) - sessionStart) / ts::NanoSecPerMicroSec;
+        opt.verbose(u"Sent %'d bytes in %'d ms, achieved bitrate: %'d b/s, allocated bandwidth: %'d kb/s",
+                    {client.totalBytes(), elapsed / 1000, (client.totalBytes() * 8 * ts::MicroSecPerSec) / std::max<ts::MicroSecond>(1, elapsed), allocatedBandwidth});
+    }
     return EXIT_SUCCESS;
 }
@@ -34,12 +34,19 @@
 #include "tsMain.h"
 #include "tsDuckContext.h"
 #include "tsPcapStream.h"
+#include "tsPcapFlowIndex.h"
+#include "tsIPPacketView.h"
 #include "tsIPv4Packet.h"
 #include "tsTime.h"
 #include "tsBitRate.h"
 #include "tsEMMGMUX.h"
 #include "tsECMGSCS.h"
 #include "tsPagerArgs.h"
+#include "tsTSFile.h"
+#include "tsThread.h"
+#include "tsMessageQueue.h"
+#include "tsDeferredReport.h"
+#include "tsFileUtils.h"
 #include "tstlvMessageFactory.h"
 TS_MAIN(MainCode);
 
@@ -49,6 +56,9 @@ TS_MAIN(MainCode);
 //----------------------------------------------------------------------------
 
 namespace {
+    // Default number of threads to extract TS files.
+    constexpr size_t DEFAULT_TS_THREADS = 4;
+
     class Options: public ts::Args
     {
         TS_NOBUILD_NOCOPY(Options);
@@ -63,12 +73,18 @@ namespace {
         bool                  print_intervals {false};
         bool                  dvb_simulcrypt {false};
         bool                  extract_tcp {false};
+        bool                  extract_ts {false};
+        ts::UString           ts_directory {};
+        size_t                ts_threads {0};
         std::set<uint8_t>     protocols {};
         ts::IPv4SocketAddress source_filter {};
         ts::IPv4SocketAddress dest_filter {};
         ts::MicroSecond       interval {-1};
         ts::emmgmux::Protocol emmgmux {};
         ts::ecmgscs::Protocol ecmgscs {};
+
+        // Check if an IP packet matches the source and destination filters.
+        bool addressMatch(const ts::IPPacketView&) const;
     };
 }
 
@@ -99,26 +115,38 @@ Options::Options(int argc, char *argv[]) :
     option(u"destination", 'd', STRING);
     help(u"destination", u"[address][:port]",
          u"Filter IPv4 packets based on the specified destination socket address. "
-         u"The optional port number is used for TCP and UDP packets only.");
+         u"The optional port number is used for TCP and UDP packets only. "
+         u"When an address is specified, IPv6 packets are ignored. "
+         u"When only a port is specified, it also applies to IPv6 packets.");
 
     option(u"extract-tcp-stream", 'e');
     help(u"extract-tcp-stream",
          u"Extract the content of a TCP session as hexadecimal dump. "
          u"The first TCP session matching the --source and --destination options is selected.");
 
+    option(u"extract-ts", 'x', DIRECTORY);
+    help(u"extract-ts",
+         u"Extract all UDP streams containing transport stream packets into separate TS files in the specified directory. "
+         u"All streams are demultiplexed in one single pass over the pcap file. "
+         u"Each file is named after the destination and source socket addresses of the stream. "
+         u"The streams can be selected using the options --source and --destination. "
+         u"The options --tcp, --udp and --others are ignored.");
+
     option(u"interval", 'i', POSITIVE);
     help(u"interval", u"micro-seconds",
          u"Print a summary of exchanged data by intervals of times in micro-seconds.");
 
     option(u"list-streams", 'l');
     help(u"list-streams",
-         u"List all data streams. "
+         u"List all data streams, IPv4 and IPv6. "
          u"A data streams is made of all packets from one source to one destination using one protocol.");
 
     option(u"source", 's', STRING);
     help(u"source", u"[address][:port]",
          u"Filter IPv4 packets based on the specified source socket address. "
-         u"The optional port number is used for TCP and UDP packets only.");
+         u"The optional port number is used for TCP and UDP packets only. "
+         u"When an address is specified, IPv6 packets are ignored. "
+         u"When only a port is specified, it also applies to IPv6 packets.");
 
     option(u"others", 'o');
     help(u"others", u"Filter packets from \"other\" protocols, i.e. neither TCP nor UDP.");
@@ -126,6 +154,12 @@ Options::Options(int argc, char *argv[]) :
     option(u"tcp", 't');
     help(u"tcp", u"Filter TCP packets.");
 
+    option(u"threads", 0, INTEGER, 0, 1, 1, 256);
+    help(u"threads",
+         u"With --extract-ts, specify the number of threads which process the extracted streams. "
+         u"Each stream is processed by one single thread. "
+         u"The default is " + ts::UString::Decimal(DEFAULT_TS_THREADS) + u" threads.");
+
     option(u"udp", 'u');
     help(u"udp", u"Filter UDP packets.");
 
@@ -142,6 +176,9 @@ Options::Options(int argc, char *argv[]) :
     print_intervals = present(u"interval");
     dvb_simulcrypt = present(u"dvb-simulcrypt");
     extract_tcp = present(u"extract-tcp-stream");
+    extract_ts = present(u"extract-ts");
+    getValue(ts_directory, u"extract-ts");
+    getIntValue(ts_threads, u"threads", DEFAULT_TS_THREADS);
 
     // Default is to print a summary of the file content.
     print_summary = !list_streams && !print_intervals;
@@ -170,12 +207,29 @@ Options::Options(int argc, char *argv[]) :
     }
 
     // Final checking.
-    if (dvb_simulcrypt && extract_tcp) {
-        error(u"--dvb-simulcrypt and --extract-tcp-stream are mutually exclusive");
+    if (dvb_simulcrypt + extract_tcp + extract_ts > 1) {
+        error(u"--dvb-simulcrypt, --extract-tcp-stream and --extract-ts are mutually exclusive");
+    }
+    if (extract_ts && !ts::IsDirectory(ts_directory)) {
+        error(u"directory %s not found", {ts_directory});
     }
     exitOnError();
 }
 
+// Check if an IP packet matches the source and destination filters.
+bool Options::addressMatch(const ts::IPPacketView& ip) const
+{
+    if (ip.isIPv4()) {
+        return ip.sourceIPv4SocketAddress().match(source_filter) && ip.destinationIPv4SocketAddress().match(dest_filter);
+    }
+    else {
+        // The address filters are IPv4 only, only the ports can match IPv6 packets.
+        return !source_filter.hasAddress() && !dest_filter.hasAddress() &&
+               (!source_filter.hasPort() || source_filter.port() == ip.sourcePort()) &&
+               (!dest_filter.hasPort() || dest_filter.port() == ip.destinationPort());
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Statistics data for a set of IP packets.
@@ -195,7 +249,7 @@ namespace {
         StatBlock() = default;
 
         // Add statistics from one packet.
-        void addPacket(const ts::IPv4Packet&, ts::MicroSecond);
+        void addPacket(const ts::IPPacketView&, ts::MicroSecond);
 
         // Reset content, optionally set timestamps.
         void reset(ts::MicroSecond = -1);
@@ -210,7 +264,7 @@ void StatBlock::reset(ts::MicroSecond timestamps)
 }
 
 // Add statistics from one packet.
-void StatBlock::addPacket(const ts::IPv4Packet& ip, ts::MicroSecond timestamp)
+void StatBlock::addPacket(const ts::IPPacketView& ip, ts::MicroSecond timestamp)
 {
     packet_count++;
     total_ip_size += ip.size();
@@ -224,47 +278,6 @@ void StatBlock::addPacket(const ts::IPv4Packet& ip, ts::MicroSecond timestamp)
 }
 
 
-//----------------------------------------------------------------------------
-// Identification of one "data stream".
-//----------------------------------------------------------------------------
-
-namespace {
-    class StreamId
-    {
-    public:
-        ts::IPv4SocketAddress source;
-        ts::IPv4SocketAddress destination;
-        uint8_t               protocol;
-
-        // Constructor.
-        StreamId(const ts::IPv4SocketAddress& src = ts::IPv4SocketAddress(), const ts::IPv4SocketAddress& dst = ts::IPv4SocketAddress(), uint8_t proto = 0xFF);
-
-        // Comparison, for use in containers.
-        bool operator<(const StreamId& other) const;
-    };
-}
-
-StreamId::StreamId(const ts::IPv4SocketAddress& src, const ts::IPv4SocketAddress& dst, uint8_t proto) :
-    source(src),
-    destination(dst),
-    protocol(proto)
-{
-}
-
-bool StreamId::operator<(const StreamId& other) const
-{
-    if (source != other.source) {
-        return source < other.source;
-    }
-    else if (destination != other.destination) {
-        return destination < other.destination;
-    }
-    else {
-        return protocol < other.protocol;
-    }
-}
-
-
 //----------------------------------------------------------------------------
 // Display summary of content by intervals of time.
 //----------------------------------------------------------------------------
@@ -277,8 +290,8 @@ namespace {
         // Constructor.
         DisplayInterval(Options& opt) : _opt(opt) {}
 
-        // Process one IPv4 packet.
-        void addPacket(std::ostream&, const ts::PcapFile&, const ts::IPv4Packet&, ts::MicroSecond);
+        // Process one IP packet.
+        void addPacket(std::ostream&, const ts::PcapFile&, const ts::IPPacketView&, ts::MicroSecond);
 
         // Terminate output.
         void close(std::ostream&, const ts::PcapFile&);
@@ -305,8 +318,8 @@ void DisplayInterval::print(std::ostream& out, const ts::PcapFile& file)
     _stats.reset(_stats.first_timestamp + _opt.interval);
 }
 
-// Process one IPv4 packet.
-void DisplayInterval::addPacket(std::ostream& out, const ts::PcapFile& file, const ts::IPv4Packet& ip, ts::MicroSecond timestamp)
+// Process one IP packet.
+void DisplayInterval::addPacket(std::ostream& out, const ts::PcapFile& file, const ts::IPPacketView& ip, ts::MicroSecond timestamp)
 {
     // Without timestamp, we cannot do anything.
     if (timestamp >= 0) {
@@ -352,11 +365,11 @@ namespace {
         bool analyze(std::ostream&);
 
     private:
-        Options&        _opt;
-        ts::PcapFilter  _file {};
-        DisplayInterval _interval;                      // Display stats by time intervals.
-        StatBlock       _global_stats {};               // Global stats
-        std::map<StreamId,StatBlock> _streams_stats {}; // Stats per data stream.
+        Options&          _opt;
+        ts::PcapFilter    _file {};
+        DisplayInterval   _interval;            // Display stats by time intervals.
+        StatBlock         _global_stats {};     // Global stats
+        ts::PcapFlowIndex _streams {};          // Index of data streams.
 
         // Display summary of content.
         void displaySummary(std::ostream& out, const StatBlock& stats);
@@ -374,18 +387,21 @@ bool FileAnalysis::analyze(std::ostream& out)
         return false;
     }
 
-    // Set packet filters.
+    // Set packet filters. The address filters are checked here.
     _file.setProtocolFilter(_opt.protocols);
-    _file.setSourceFilter(_opt.source_filter);
-    _file.setDestinationFilter(_opt.dest_filter);
 
-    // Read all IPv4 packets from the file.
-    ts::IPv4Packet ip;
+    // Read all IP packets from the file, in one pass, without copy.
+    const uint8_t* data = nullptr;
+    size_t size = 0;
     ts::MicroSecond timestamp = 0;
-    while (_file.readIPv4(ip, timestamp, _opt)) {
+    ts::IPPacketView ip;
+    while (_file.readIP(data, size, timestamp, _opt)) {
+        if (!ip.reset(data, size) || !_opt.addressMatch(ip)) {
+            continue;
+        }
         _global_stats.addPacket(ip, timestamp);
         if (_opt.list_streams) {
-            _streams_stats[StreamId(ip.sourceSocketAddress(), ip.destinationSocketAddress(), ip.protocol())].addPacket(ip, timestamp);
+            _streams.addPacket(ip, _file.packetCount(), timestamp);
         }
         if (_opt.print_intervals) {
             _interval.addPacket(out, _file, ip, timestamp);
@@ -415,9 +431,11 @@ void FileAnalysis::displaySummary(std::ostream& out, const StatBlock& stats)
     out << "File summary:" << std::endl;
     out << ts::UString::Format(u"  %-*s %'d", {hwidth, u"Total packets in file:", _file.packetCount()}) << std::endl;
     out << ts::UString::Format(u"  %-*s %'d", {hwidth, u"Total IPv4 packets:", _file.ipv4PacketCount()}) << std::endl;
+    out << ts::UString::Format(u"  %-*s %'d", {hwidth, u"Total IPv6 packets:", _file.ipv6PacketCount()}) << std::endl;
     out << ts::UString::Format(u"  %-*s %'d bytes", {hwidth, u"File size:", _file.fileSize()}) << std::endl;
     out << ts::UString::Format(u"  %-*s %'d bytes", {hwidth, u"Total packets size:", _file.totalPacketsSize()}) << std::endl;
     out << ts::UString::Format(u"  %-*s %'d bytes", {hwidth, u"Total IPv4 size:", _file.totalIPv4PacketsSize()}) << std::endl;
+    out << ts::UString::Format(u"  %-*s %'d bytes", {hwidth, u"Total IPv6 size:", _file.totalIPv6PacketsSize()}) << std::endl;
     out << std::endl;
 
     out << "Filtered packets summary:" << std::endl;
@@ -446,12 +464,12 @@ void FileAnalysis::listStreams(std::ostream& out, ts::MicroSecond duration)
     out << std::endl
         << ts::UString::Format(u"%-22s %-22s %-8s %11s %15s %12s", {u"Source", u"Destination", u"Protocol", u"Packets", u"Data bytes", u"Bitrate"})
         << std::endl;
-    for (const auto& it : _streams_stats) {
-        const StreamId& id(it.first);
-        const StatBlock& sb(it.second);
+    for (const auto& it : _streams.flows()) {
+        const ts::PcapFlowIndex::FlowId& id(it.first);
+        const ts::PcapFlowIndex::FlowStats& sb(it.second);
         out << ts::UString::Format(u"%-22s %-22s %-8s %11'd %15'd %12'd",
-                                   {id.source,
-                                    id.destination,
+                                   {id.sourceString(),
+                                    id.destinationString(),
                                     ts::IPProtocolName(id.protocol),
                                     sb.packet_count,
                                     sb.total_data_size,
@@ -462,6 +480,308 @@ void FileAnalysis::listStreams(std::ostream& out, ts::MicroSecond duration)
 }
 
 
+//----------------------------------------------------------------------------
+// Extraction of TS files: description of one extracted stream.
+//----------------------------------------------------------------------------
+
+namespace {
+    class TSStream
+    {
+        TS_NOCOPY(TSStream);
+    public:
+        // Constructor.
+        TSStream() = default;
+
+        // Public fields. Once the output file is open, they are exclusively used by one worker thread.
+        size_t      worker {0};           // index of worker thread for this stream
+        ts::UString file_name {};         // output file name, empty if not a TS stream (yet)
+        ts::TSFile  file {};              // output TS file
+        size_t      datagram_count {0};   // number of UDP datagrams
+        size_t      packet_count {0};     // number of extracted TS packets
+        size_t      invalid_count {0};    // number of UDP datagrams without TS packets
+        bool        error {false};        // error on output file, stop writing it
+    };
+
+    typedef ts::SafePtr<TSStream> TSStreamPtr;
+}
+
+
+//----------------------------------------------------------------------------
+// Extraction of TS files: batches of UDP datagrams for a worker thread.
+//----------------------------------------------------------------------------
+
+namespace {
+    class TSBatch
+    {
+        TS_NOCOPY(TSBatch);
+    public:
+        // Constructor.
+        TSBatch() = default;
+
+        // Description of one UDP datagram.
+        class Datagram
+        {
+        public:
+            TSStream*      stream;  // associated stream
+            const uint8_t* data;    // UDP payload address, null if copied in batch buffer
+            size_t         offset;  // offset of UDP payload in batch buffer, when copied
+            size_t         size;    // UDP payload size
+        };
+
+        // Public fields.
+        std::vector<Datagram> datagrams {};
+        ts::ByteBlock         buffer {};  // copy of UDP payloads when the file is not memory-mapped
+
+        // Maximum number of datagrams per batch.
+        static constexpr size_t MAX_DATAGRAMS = 128;
+
+        // Add a datagram. The data are copied only when they may be overwritten by the next read.
+        void add(TSStream* stream, const uint8_t* data, size_t size, bool copy)
+        {
+            if (copy) {
+                datagrams.push_back({stream, nullptr, buffer.size(), size});
+                buffer.append(data, size);
+            }
+            else {
+                datagrams.push_back({stream, data, 0, size});
+            }
+        }
+    };
+
+    // Message queue to worker threads. An empty batch is a termination request.
+    typedef ts::MessageQueue<TSBatch> TSBatchQueue;
+}
+
+
+//----------------------------------------------------------------------------
+// Extraction of TS files: worker thread.
+//----------------------------------------------------------------------------
+
+namespace {
+    class TSWorker: public ts::Thread
+    {
+        TS_NOCOPY(TSWorker);
+    public:
+        // Constructor and destructor.
+        TSWorker(int max_severity) : _report(max_severity) {}
+        virtual ~TSWorker() override;
+
+        // Queue of datagrams to process. Bounded to avoid loading the whole file in memory.
+        TSBatchQueue queue {16};
+
+        // Replay all messages from the thread, after termination. Return false if there was an error.
+        bool replayMessages(ts::Report& report) { return _report.replay(report); }
+
+    private:
+        ts::DeferredReport _report;
+
+        // Thread main code.
+        virtual void main() override;
+    };
+
+    typedef ts::SafePtr<TSWorker> TSWorkerPtr;
+}
+
+// Destructor.
+TSWorker::~TSWorker()
+{
+    waitForTermination();
+}
+
+// Thread main code.
+void TSWorker::main()
+{
+    for (;;) {
+        TSBatchQueue::MessagePtr batch;
+        if (!queue.dequeue(batch) || batch.isNull() || batch->datagrams.empty()) {
+            break; // termination request
+        }
+        for (const auto& dg : batch->datagrams) {
+            TSStream& stream(*dg.stream);
+            const uint8_t* const data = dg.data != nullptr ? dg.data : batch->buffer.data() + dg.offset;
+            size_t start_index = 0;
+            size_t packet_count = 0;
+            stream.datagram_count++;
+            if (!ts::TSPacket::Locate(data, dg.size, start_index, packet_count)) {
+                stream.invalid_count++;
+            }
+            else if (!stream.error) {
+                stream.packet_count += packet_count;
+                stream.error = !stream.file.writePackets(reinterpret_cast<const ts::TSPacket*>(data + start_index), nullptr, packet_count, _report);
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Extraction of TS files: all streams in one pass.
+//----------------------------------------------------------------------------
+
+namespace {
+    class TSExtraction
+    {
+        TS_NOBUILD_NOCOPY(TSExtraction);
+    public:
+        // Constructor.
+        TSExtraction(Options& opt) : _opt(opt) {}
+
+        // Extract all TS streams, return true on success, false on error.
+        bool extract(std::ostream&);
+
+    private:
+        typedef std::map<ts::PcapFlowIndex::FlowId, TSStreamPtr> TSStreamMap;
+
+        Options&                              _opt;
+        ts::PcapFilter                        _file {};
+        TSStreamMap                           _streams {};
+        std::vector<TSWorkerPtr>              _workers {};
+        std::vector<TSBatchQueue::MessagePtr> _batches {};  // one pending batch per worker
+        size_t                                _next_worker {0};
+
+        // Get the stream for an IP datagram, create it if necessary.
+        TSStream& getStream(const ts::IPPacketView&);
+
+        // Start the output file of a stream, when the first TS packets are found.
+        void startStream(TSStream&, const ts::PcapFlowIndex::FlowId&);
+
+        // Send the pending batch of a worker.
+        void flushBatch(size_t worker, bool force);
+
+        // Display the list of extracted streams.
+        void listStreams(std::ostream&);
+    };
+}
+
+// Extract all TS streams, return true on success, false on error.
+bool TSExtraction::extract(std::ostream& out)
+{
+    // Open the pcap file.
+    if (!_file.loadArgs(_opt.duck, _opt) || !_file.open(_opt.input_file, _opt)) {
+        return false;
+    }
+    _file.setProtocolFilterUDP();
+
+    // With memory-mapped files, the datagrams remain valid until the file is closed and are directly passed to the workers.
+    const bool copy = !_file.isMemoryMapped();
+
+    // Start worker threads.
+    _workers.resize(_opt.ts_threads);
+    _batches.resize(_opt.ts_threads);
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        _workers[i] = new TSWorker(_opt.maxSeverity());
+        _batches[i] = new TSBatch;
+        _workers[i]->start();
+    }
+
+    // Read all UDP datagrams from the file, in one pass.
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    ts::MicroSecond timestamp = 0;
+    ts::IPPacketView ip;
+    while (_file.readIP(data, size, timestamp, _opt)) {
+        if (!ip.reset(data, size) || !ip.isUDP() || !_opt.addressMatch(ip)) {
+            continue;
+        }
+        TSStream& stream(getStream(ip));
+        if (stream.file_name.empty()) {
+            // Not yet identified as a TS stream. Is there any TS packet in this datagram?
+            size_t start_index = 0;
+            size_t packet_count = 0;
+            if (!ts::TSPacket::Locate(ip.protocolData(), ip.protocolDataSize(), start_index, packet_count)) {
+                continue;
+            }
+            startStream(stream, ts::PcapFlowIndex::FlowId(ip));
+        }
+        // Let the worker of this stream process the datagram.
+        _batches[stream.worker]->add(&stream, ip.protocolData(), ip.protocolDataSize(), copy);
+        flushBatch(stream.worker, false);
+    }
+
+    // Flush all pending datagrams and terminate all workers.
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        flushBatch(i, true);
+        TSBatchQueue::MessagePtr end(new TSBatch);
+        _workers[i]->queue.forceEnqueue(end);
+    }
+    bool success = true;
+    for (const auto& worker : _workers) {
+        worker->waitForTermination();
+        success = worker->replayMessages(_opt) && success;
+    }
+    _file.close();
+
+    // Close all output files.
+    for (const auto& it : _streams) {
+        if (it.second->file.isOpen()) {
+            success = it.second->file.close(_opt) && success;
+        }
+    }
+    listStreams(out);
+    return success;
+}
+
+// Get the stream for an IP datagram, create it if necessary.
+TSStream& TSExtraction::getStream(const ts::IPPacketView& ip)
+{
+    TSStreamPtr& stream(_streams[ts::PcapFlowIndex::FlowId(ip)]);
+    if (stream.isNull()) {
+        stream = new TSStream;
+    }
+    return *stream;
+}
+
+// Start the output file of a stream, when the first TS packets are found.
+void TSExtraction::startStream(TSStream& stream, const ts::PcapFlowIndex::FlowId& id)
+{
+    // Build a file name from the socket addresses.
+    ts::UString name(id.destinationString() + u"_from_" + id.sourceString());
+    name.remove(u'[');
+    name.remove(u']');
+    name.substitute(u':', u'_');
+    stream.file_name = _opt.ts_directory + ts::PathSeparator + name + u".ts";
+
+    // Distribute the streams over all workers.
+    stream.worker = _next_worker;
+    _next_worker = (_next_worker + 1) % _workers.size();
+
+    _opt.verbose(u"extracting TS from %s to %s", {id.sourceString(), id.destinationString()});
+    stream.error = !stream.file.open(stream.file_name, ts::TSFile::WRITE | ts::TSFile::SHARED, _opt);
+}
+
+// Send the pending batch of a worker.
+void TSExtraction::flushBatch(size_t worker, bool force)
+{
+    TSBatchQueue::MessagePtr& batch(_batches[worker]);
+    if ((force && !batch->datagrams.empty()) || batch->datagrams.size() >= TSBatch::MAX_DATAGRAMS) {
+        // Wait for free space in the queue of the worker. The pointer becomes null.
+        _workers[worker]->queue.enqueue(batch);
+        batch = new TSBatch;
+    }
+}
+
+// Display the list of extracted streams.
+void TSExtraction::listStreams(std::ostream& out)
+{
+    out << std::endl
+        << ts::UString::Format(u"%-22s %-22s %11s %11s  %s", {u"Source", u"Destination", u"Datagrams", u"TS packets", u"File"})
+        << std::endl;
+    for (const auto& it : _streams) {
+        const TSStream& stream(*it.second);
+        if (!stream.file_name.empty()) {
+            out << ts::UString::Format(u"%-22s %-22s %11'd %11'd  %s",
+                                       {it.first.sourceString(),
+                                        it.first.destinationString(),
+                                        stream.datagram_count,
+                                        stream.packet_count,
+                                        stream.file_name})
+                << std::endl;
+        }
+    }
+    out << std::endl;
+}
+
+
 //----------------------------------------------------------------------------
 // DVB SimulCrypt dump, base class.
 //----------------------------------------------------------------------------
@@ -759,7 +1079,12 @@ int MainCode(int argc, char *argv[])
     // Output device, may be paginated.
     std::ostream& out(opt.pager.output(opt));
 
-    if (opt.extract_tcp) {
+    if (opt.extract_ts) {
+        // Extraction of all TS streams.
+        TSExtraction ext(opt);
+        status = ext.extract(out);
+    }
+    else if (opt.extract_tcp) {
         // TCP session dump.
         TCPSessionDump tcp(opt);
         status = tcp.dump(out);
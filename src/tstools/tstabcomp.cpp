@@ -64,6 +64,7 @@ namespace {
         bool                toJSON;          // Decompile to JSON.
         bool                xmlModel;        // Display XML model instead of compilation.
         bool                withExtensions;  // XML model with extensions.
+        bool                streaming;       // Compile or decompile tables on the fly.
         ts::SectionFileArgs sectionOptions;  // Section file processing options.
         ts::xml::Tweaks     xmlTweaks;       // XML formatting options.
     };
@@ -83,6 +84,7 @@ Options::Options(int argc, char *argv[]) :
     toJSON(false),
     xmlModel(false),
     withExtensions(false),
+    streaming(false),
     sectionOptions(),
     xmlTweaks()
 {
@@ -140,6 +142,14 @@ Options::Options(int argc, char *argv[]) :
          u"The default output file for the standard input (\"-\") is the standard output (\"-\"). "
          u"If more than one input file is specified, the output path, if present, must be either a directory name or \"-\".");
 
+    option(u"streaming");
+    help(u"streaming",
+         u"Compile or decompile tables one by one, on the fly. "
+         u"The memory usage remains constant, regardless of the size of the input files. "
+         u"This is useful for very large files, typically containing a large number of EIT sections. "
+         u"This option is incompatible with JSON files and with options which need all tables at once "
+         u"(--pack-and-flush, --eit-normalization).");
+
     option(u"xml-model", 'x');
     help(u"xml-model",
          u"Display the XML model of the table files. This model is not a full "
@@ -161,6 +171,7 @@ Options::Options(int argc, char *argv[]) :
     toJSON = present(u"json") || outFile.endWith(ts::SectionFile::DEFAULT_JSON_SECTION_FILE_SUFFIX);
     xmlModel = present(u"xml-model");
     withExtensions = present(u"extensions");
+    streaming = present(u"streaming");
     useStdIn = ts::UString(u"-").isContainedSimilarIn(inFiles);
     useStdOut = outFile == u"-";
     outIsDir = !useStdOut && !outFile.empty() && ts::IsDirectory(outFile);
@@ -180,6 +191,12 @@ Options::Options(int argc, char *argv[]) :
     if (compile && decompile) {
         error(u"specify either --compile or --decompile but not both");
     }
+    if (streaming && (fromJSON || toJSON)) {
+        error(u"--streaming cannot be used with JSON files");
+    }
+    if (streaming && (sectionOptions.pack_and_flush || sectionOptions.eit_normalize)) {
+        error(u"--streaming cannot be used with --pack-and-flush or --eit-normalization");
+    }
 
     exitOnError();
 }
@@ -264,6 +281,20 @@ namespace {
             opt.error(u"cannot decompile XML or JSON file %s", {infile});
             return false;
         }
+        else if (opt.streaming && compile && inType == FType::JSON) {
+            opt.error(u"cannot compile JSON file %s with --streaming", {infile});
+            return false;
+        }
+        else if (opt.streaming && compile) {
+            // Compile XML tables one by one into binary sections.
+            opt.verbose(u"Compiling %s to %s on the fly", {infile, outname});
+            return file.compileXML(infile, outname);
+        }
+        else if (opt.streaming) {
+            // Decompile binary sections one by one into XML tables.
+            opt.verbose(u"Decompiling %s to %s on the fly", {infile, outname});
+            return file.decompileBinary(infile, outname);
+        }
         else if (compile) {
             // Load XML file and save binary sections.
             opt.verbose(u"Compiling %s to %s", {infile, outname});
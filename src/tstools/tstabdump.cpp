@@ -144,6 +144,8 @@ namespace {
         size_t invalid_msg = 0;
         ts::IPv4SocketAddress sender;
         ts::IPv4SocketAddress destination;
+        ts::IPv6SocketAddress sender6;
+        ts::IPv6SocketAddress destination6;
         ts::ByteBlock packet(ts::IP_MAX_PACKET_SIZE);
         ts::Time timestamp;
         ts::SectionPtrVector sections;
@@ -156,7 +158,12 @@ namespace {
 
             // Wait for a UDP message
             size_t insize = 0;
-            ok = opt.udp.receive(packet.data(), packet.size(), insize, sender, destination, nullptr, opt);
+            if (opt.udp.generation() == ts::IP::v6) {
+                ok = opt.udp.receive(packet.data(), packet.size(), insize, sender6, destination6, nullptr, opt);
+            }
+            else {
+                ok = opt.udp.receive(packet.data(), packet.size(), insize, sender, destination, nullptr, opt);
+            }
 
             // Check packet.
             assert(insize <= packet.size());
@@ -37,8 +37,16 @@
 #include "tsTablesDisplay.h"
 #include "tsTablesLogger.h"
 #include "tsPagerArgs.h"
+#include "tsThread.h"
+#include "tsMessageQueue.h"
+#include "tsDeferredReport.h"
 TS_MAIN(MainCode);
 
+namespace {
+    // In parallel mode, number of packets which are read at a time and sent to all threads.
+    constexpr size_t CHUNK_PACKETS = 10000;
+}
+
 
 //----------------------------------------------------------------------------
 //  Command line options
@@ -57,6 +65,7 @@ namespace {
         ts::PagerArgs      pager;    // Output paging options.
         ts::UString        infile;   // Input file name.
         ts::TSPacketFormat format;   // Input file format.
+        size_t             threads;  // Number of demux threads.
     };
 }
 
@@ -67,7 +76,8 @@ Options::Options(int argc, char *argv[]) :
     logger(display),
     pager(true, true),
     infile(),
-    format(ts::TSPacketFormat::AUTODETECT)
+    format(ts::TSPacketFormat::AUTODETECT),
+    threads(1)
 {
     duck.defineArgsForCAS(*this);
     duck.defineArgsForPDS(*this);
@@ -82,6 +92,13 @@ Options::Options(int argc, char *argv[]) :
     option(u"", 0, FILENAME, 0, 1);
     help(u"", u"Input transport stream file (standard input if omitted).");
 
+    option(u"threads", 0, INTEGER, 0, 1, 1, 64);
+    help(u"threads",
+         u"Demux and format the tables in parallel, using the specified number of threads. "
+         u"The PID's are distributed over the threads and the output is produced in the same order as with one thread. "
+         u"This option is useful on large files with tables on several PID's. "
+         u"By default, one single thread is used.");
+
     analyze(argc, argv);
 
     duck.loadArgs(*this);
@@ -90,12 +107,169 @@ Options::Options(int argc, char *argv[]) :
     display.loadArgs(duck, *this);
 
     getValue(infile, u"");
+    getIntValue(threads, u"threads", 1);
     format = ts::LoadTSPacketFormatInputOption(*this);
 
     exitOnError();
 }
 
 
+//----------------------------------------------------------------------------
+//  Demux and format the tables of a shard of PID's, in a separate thread.
+//----------------------------------------------------------------------------
+
+namespace {
+    class ShardLogger: public ts::Thread
+    {
+        TS_NOBUILD_NOCOPY(ShardLogger);
+    public:
+        // Constructor and destructor.
+        ShardLogger(Options& opt, size_t index, size_t count);
+        virtual ~ShardLogger() override;
+
+        // Input packets, shared by all threads. A null pointer means end of input.
+        typedef ts::SafePtr<ts::TSPacketVector, ts::Mutex> PacketsPtr;
+        typedef ts::MessageQueue<PacketsPtr> PacketQueue;
+        PacketQueue input;
+
+        // Output fragments, one list per chunk of input packets. The last one is sent after end of input.
+        typedef ts::MessageQueue<ts::TablesLogger::FragmentList> FragmentQueue;
+        FragmentQueue output;
+
+        // Replay all messages from the thread, after termination. Return false if there was an error.
+        bool replayMessages(ts::Report& report) { return _report.replay(report); }
+
+        // Access the logger, after termination.
+        const ts::TablesLogger& logger() const { return _logger; }
+
+    private:
+        ts::DeferredReport _report;
+        ts::DuckContext    _duck;
+        ts::TablesDisplay  _display;
+        ts::TablesLogger   _logger;
+
+        // Thread main code.
+        virtual void main() override;
+    };
+
+    typedef ts::SafePtr<ShardLogger> ShardLoggerPtr;
+}
+
+// Constructor.
+ShardLogger::ShardLogger(Options& opt, size_t index, size_t count) :
+    input(),
+    output(),
+    _report(opt.maxSeverity()),
+    _duck(&_report),
+    _display(_duck),
+    _logger(_display)
+{
+    // Same options as the main logger.
+    ts::DuckContext::SavedArgs args;
+    opt.duck.saveArgs(args);
+    _duck.restoreArgs(args);
+    _display.loadArgs(_duck, opt);
+    _logger.loadArgs(_duck, opt);
+    _logger.setShard(index, count);
+    _logger.open();
+}
+
+// Destructor.
+ShardLogger::~ShardLogger()
+{
+    waitForTermination();
+}
+
+// Thread main code.
+void ShardLogger::main()
+{
+    PacketsPtr packets;
+    do {
+        PacketQueue::MessagePtr msg;
+        input.dequeue(msg);
+        packets = *msg;
+        if (packets.isNull()) {
+            // End of input, flush tables if required.
+            _logger.close();
+        }
+        else {
+            for (size_t i = 0; !_logger.completed() && i < packets->size(); ++i) {
+                _logger.feedPacket((*packets)[i]);
+            }
+        }
+        FragmentQueue::MessagePtr fragments(new ts::TablesLogger::FragmentList);
+        _logger.getFragments(*fragments);
+        output.enqueue(fragments);
+    } while (!packets.isNull());
+}
+
+
+//----------------------------------------------------------------------------
+//  Parallel demux, using one thread per shard of PID's.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Return false if an error occurred in a thread.
+    bool ParallelLogging(Options& opt, ts::TSFile& file)
+    {
+        // Start all threads.
+        std::vector<ShardLoggerPtr> workers(opt.threads);
+        for (size_t i = 0; i < workers.size(); ++i) {
+            workers[i] = new ShardLogger(opt, i, workers.size());
+            workers[i]->start();
+        }
+
+        // Collect the output of all threads for one chunk of packets and log it in input order.
+        auto collect = [&opt, &workers]() {
+            ts::TablesLogger::FragmentList fragments;
+            for (const auto& worker : workers) {
+                ShardLogger::FragmentQueue::MessagePtr list;
+                worker->output.dequeue(list);
+                fragments.splice(fragments.end(), *list);
+            }
+            opt.logger.logFragments(fragments);
+        };
+
+        // Read chunks of packets and send them to all threads.
+        // The next chunk is read while the threads process the previous one.
+        bool pending = false;
+        size_t count = 0;
+        do {
+            ShardLogger::PacketsPtr packets(new ts::TSPacketVector(CHUNK_PACKETS));
+            count = file.readPackets(packets->data(), nullptr, packets->size(), opt);
+            if (count > 0) {
+                packets->resize(count);
+                for (const auto& worker : workers) {
+                    worker->input.enqueue(new ShardLogger::PacketsPtr(packets));
+                }
+            }
+            if (pending) {
+                collect();
+            }
+            pending = count > 0;
+        } while (count > 0 && !opt.logger.completed());
+
+        // Terminate all threads and log the tables which are flushed at the end.
+        for (const auto& worker : workers) {
+            worker->input.enqueue(new ShardLogger::PacketsPtr);
+        }
+        if (pending) {
+            collect();
+        }
+        collect();
+
+        // Wait for all threads and collect errors.
+        bool success = true;
+        for (const auto& worker : workers) {
+            worker->waitForTermination();
+            success = worker->replayMessages(opt) && !worker->logger().hasErrors() && success;
+            opt.logger.addDemuxErrors(worker->logger());
+        }
+        return success;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 //  Program entry point
 //----------------------------------------------------------------------------
@@ -120,9 +294,15 @@ int MainCode(int argc, char *argv[])
     }
 
     // Read all packets in the file and pass them to the logger
-    ts::TSPacket pkt;
-    while (!opt.logger.completed() && file.readPackets(&pkt, nullptr, 1, opt) > 0) {
-        opt.logger.feedPacket(pkt);
+    bool success = true;
+    if (opt.threads > 1) {
+        success = ParallelLogging(opt, file);
+    }
+    else {
+        ts::TSPacket pkt;
+        while (!opt.logger.completed() && file.readPackets(&pkt, nullptr, 1, opt) > 0) {
+            opt.logger.feedPacket(pkt);
+        }
     }
     file.close(opt);
     opt.logger.close();
@@ -132,5 +312,5 @@ int MainCode(int argc, char *argv[])
         opt.logger.reportDemuxErrors(std::cerr);
     }
 
-    return opt.logger.hasErrors() ? EXIT_FAILURE : EXIT_SUCCESS;
+    return success && !opt.logger.hasErrors() ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -79,6 +79,7 @@ public:
     void testDecode24();
     void testDecode25();
     void testDecode26();
+    void testDecode27();
     void testEncode1();
     void testEncode2();
     void testEncode3();
@@ -133,6 +134,7 @@ public:
     TSUNIT_TEST(testDecode24);
     TSUNIT_TEST(testDecode25);
     TSUNIT_TEST(testDecode26);
+    TSUNIT_TEST(testDecode27);
     TSUNIT_TEST(testEncode1);
     TSUNIT_TEST(testEncode2);
     TSUNIT_TEST(testEncode3);
@@ -499,6 +501,20 @@ void ARIBCharsetTest::testDecode26()
     T(false);
 }
 
+void ARIBCharsetTest::testDecode27()
+{
+    // Long sequences of alphanumeric characters, using the fast path, with special characters in the middle.
+    B(0x0E, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F, 0x50,
+      0x51, 0x52, 0x20, 0x5C, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x7E, 0x61, 0x62,
+      0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E, 0x6F, 0x70, 0x71, 0x72, 0x0F,
+      0x30, 0x21);
+    U(0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047, 0x0048, 0x0049, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F, 0x0050,
+      0x0051, 0x0052, 0x0020, 0x00A5, 0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037, 0x0038, 0x0039, 0x203E, 0x0061, 0x0062,
+      0x0063, 0x0064, 0x0065, 0x0066, 0x0067, 0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F, 0x0070, 0x0071, 0x0072,
+      0x4E9C);
+    T(true);
+}
+
 #undef B
 #undef U
 #undef T
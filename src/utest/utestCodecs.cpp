@@ -33,6 +33,9 @@
 
 #include "tsAccessUnitIterator.h"
 #include "tsAVC.h"
+#include "tsHEVC.h"
+#include "tsByteBlock.h"
+#include "utestTSUnitBenchmark.h"
 #include "tsunit.h"
 
 
@@ -47,9 +50,11 @@ public:
     virtual void afterTest() override;
 
     void testIterator();
+    void testIteratorSpeed();
 
     TSUNIT_TEST_BEGIN(CodecsTest);
     TSUNIT_TEST(testIterator);
+    TSUNIT_TEST(testIteratorSpeed);
     TSUNIT_TEST_END();
 };
 
@@ -142,3 +147,64 @@ void CodecsTest::testIterator()
     TSUNIT_ASSERT(iter.atEnd());
     TSUNIT_EQUAL(3, iter.currentAccessUnitIndex());
 }
+
+void CodecsTest::testIteratorSpeed()
+{
+    // Synthetic HEVC elementary stream: one second at 50 Mb/s, 25 frames per second, one frame per PES packet.
+    // Each frame is made of an access unit delimiter and 8 slices. The content of the slices is pseudo-random
+    // with many zeroes, to stress the search of start codes, and with start code emulation prevention.
+    constexpr size_t frame_count = 25;
+    constexpr size_t slice_count = 8;
+    constexpr size_t slice_size = 50000000 / 8 / frame_count / slice_count;
+
+    std::vector<ts::ByteBlock> frames(frame_count);
+    size_t expected_count = 0;
+    size_t expected_size = 0;
+    uint32_t rnd = 1;
+
+    for (auto& frame : frames) {
+        frame.appendUInt32(0x00000001);
+        frame.appendUInt16(uint16_t(ts::HEVC_AUT_AUD_NUT << 9) | 0x0001);
+        frame.appendUInt8(0x50);
+        expected_count++;
+        expected_size += 3;
+        for (size_t slice = 0; slice < slice_count; ++slice) {
+            frame.appendUInt24(0x000001);
+            const size_t start = frame.size();
+            frame.appendUInt16(uint16_t(ts::HEVC_AUT_TRAIL_R << 9) | 0x0001);
+            while (frame.size() - start < slice_size - 1) {
+                rnd = rnd * 1103515245 + 12345;
+                const uint8_t b = (rnd & 0x00070000) == 0 ? 0x00 : uint8_t(rnd >> 24);
+                // Start code emulation prevention.
+                if (b <= 0x03 && frame[frame.size() - 1] == 0x00 && frame[frame.size() - 2] == 0x00) {
+                    frame.appendUInt8(0x03);
+                }
+                frame.appendUInt8(b);
+            }
+            frame.appendUInt8(0x80); // rbsp_stop_one_bit
+            expected_count++;
+            expected_size += frame.size() - start;
+        }
+    }
+
+    // Support for benchmarking.
+    utest::TSUnitBenchmark bench(u"TSUNIT_CODECS_ITERATIONS");
+    size_t count = 0;
+    size_t size = 0;
+
+    bench.start();
+    for (size_t iter = 0; iter < bench.iterations; ++iter) {
+        count = size = 0;
+        for (const auto& frame : frames) {
+            for (ts::AccessUnitIterator au(frame.data(), frame.size(), ts::ST_HEVC_VIDEO); !au.atEnd(); au.next()) {
+                count++;
+                size += au.currentAccessUnitSize();
+            }
+        }
+    }
+    bench.stop();
+    bench.report(u"AccessUnitIterator on 50 Mb/s HEVC");
+
+    TSUNIT_EQUAL(expected_count, count);
+    TSUNIT_EQUAL(expected_size, size);
+}
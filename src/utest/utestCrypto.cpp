@@ -255,6 +255,39 @@ void CryptoTest::testCipher(utest::TSUnitBenchmark& bench,
             << "  Returned plain: " << ts::UString::Dump(&tmp[0], retsize, ts::UString::SINGLE_LINE) << std::endl;
         TSUNIT_FAIL("CryptoTest: " + name.toUTF8() + ": decryptInPlace failed");
     }
+
+    // Process several copies of the same message at once, more than the multi-block capacity.
+    if (plain_size > 0 && plain_size == cipher_size) {
+        const size_t count = 11;
+        std::vector<uint8_t> multi(count * plain_size);
+        std::vector<uint8_t*> data(count);
+        std::vector<size_t> sizes(count, plain_size);
+        for (size_t i = 0; i < count; ++i) {
+            data[i] = &multi[i * plain_size];
+            ::memcpy(data[i], plain, plain_size);
+        }
+
+        TSUNIT_ASSERT(algo.encryptMessages(&data[0], &sizes[0], count));
+        for (size_t i = 0; i < count; ++i) {
+            TSUNIT_EQUAL(0, ::memcmp(cipher, data[i], cipher_size));
+        }
+        TSUNIT_ASSERT(algo.decryptMessages(&data[0], &sizes[0], count));
+        for (size_t i = 0; i < count; ++i) {
+            TSUNIT_EQUAL(0, ::memcmp(plain, data[i], plain_size));
+        }
+
+        // Same thing with one-block messages in ECB mode.
+        if (plain_size == algo.blockSize()) {
+            TSUNIT_ASSERT(algo.encryptBlocks(&multi[0], &multi[0], count));
+            for (size_t i = 0; i < count; ++i) {
+                TSUNIT_EQUAL(0, ::memcmp(cipher, data[i], cipher_size));
+            }
+            TSUNIT_ASSERT(algo.decryptBlocks(&multi[0], &multi[0], count));
+            for (size_t i = 0; i < count; ++i) {
+                TSUNIT_EQUAL(0, ::memcmp(plain, data[i], plain_size));
+            }
+        }
+    }
 }
 
 void CryptoTest::testChaining(utest::TSUnitBenchmark& bench,
@@ -32,7 +32,10 @@
 //----------------------------------------------------------------------------
 
 #include "tsDVBCharset.h"
+#include "tsDVBCharTableSingleByte.h"
+#include "tsDVBCharTableUTF8.h"
 #include "tsByteBlock.h"
+#include "utestTSUnitBenchmark.h"
 #include "tsunit.h"
 
 //----------------------------------------------------------------------------
@@ -47,10 +50,14 @@ public:
 
     void testRepository();
     void testDVB();
+    void testLongStrings();
+    void testDecodeSpeed();
 
     TSUNIT_TEST_BEGIN(DVBCharsetTest);
     TSUNIT_TEST(testRepository);
     TSUNIT_TEST(testDVB);
+    TSUNIT_TEST(testLongStrings);
+    TSUNIT_TEST(testDecodeSpeed);
     TSUNIT_TEST_END();
 };
 
@@ -102,3 +109,66 @@ void DVBCharsetTest::testDVB()
     TSUNIT_EQUAL(str1, ts::DVBCharset::DVB.decoded(dvb1, sizeof(dvb1)));
     TSUNIT_ASSERT(ts::ByteBlock(dvb1, sizeof(dvb1)) == ts::DVBCharset::DVB.encoded(str1.toDecomposedDiacritical()));
 }
+
+void DVBCharsetTest::testLongStrings()
+{
+    // Long ASCII sequences use a fast path, make sure that other characters are properly inserted.
+    static const char s1[] = "The quick brown fox jumps over the lazy dog, 0123456789 times.";
+    TSUNIT_EQUAL(u"The quick brown fox jumps over the lazy dog, 0123456789 times.",
+                 ts::DVBCharTableSingleByte::RAW_ISO_6937.decoded(reinterpret_cast<const uint8_t*>(s1), ::strlen(s1)));
+
+    // Characters outside ASCII range at various positions, including a reversed diacritical mark.
+    ts::ByteBlock dvb2(reinterpret_cast<const uint8_t*>("abcdefghijklmnopqrstuvwxyz"), 26);
+    dvb2.append(ts::ByteBlock({0xC2, 0x65, 0x8A}));
+    dvb2.append(reinterpret_cast<const uint8_t*>("ABCDEFGHIJKLMNOPQRSTUVWXYZ"), 26);
+    dvb2.append(ts::ByteBlock({0x01, 0x41}));
+    ts::UString str2(u"abcdefghijklmnopqrstuvwxyz");
+    str2.push_back(ts::LATIN_SMALL_LETTER_E_WITH_ACUTE);
+    str2.push_back(ts::LINE_FEED);
+    str2.append(u"ABCDEFGHIJKLMNOPQRSTUVWXYZA");
+    ts::UString dec2;
+    TSUNIT_ASSERT(!ts::DVBCharTableSingleByte::RAW_ISO_6937.decode(dec2, dvb2.data(), dvb2.size()));
+    TSUNIT_EQUAL(str2, dec2);
+
+    // Reuse the same string, previous content is replaced.
+    TSUNIT_ASSERT(ts::DVBCharTableSingleByte::RAW_ISO_8859_1.decode(dec2, reinterpret_cast<const uint8_t*>(s1), 9));
+    TSUNIT_EQUAL(u"The quick", dec2);
+
+    // UTF-8 with long ASCII sequences.
+    const ts::UString str3(u"Long ASCII sequence before \u00E9\u20AC and after the non-ASCII characters.");
+    const std::string utf3(str3.toUTF8());
+    TSUNIT_EQUAL(str3, ts::DVBCharTableUTF8::RAW_UTF_8.decoded(reinterpret_cast<const uint8_t*>(utf3.data()), utf3.size()));
+    TSUNIT_EQUAL(str3, ts::UString::FromUTF8(utf3));
+}
+
+void DVBCharsetTest::testDecodeSpeed()
+{
+    // Typical event description, mostly ASCII with a few accented characters.
+    ts::ByteBlock dvb;
+    for (int i = 0; i < 4; ++i) {
+        dvb.append(reinterpret_cast<const uint8_t*>("Documentary series about the history of the "), 44);
+        dvb.append(ts::ByteBlock({0xC2, 0x65}));
+        dvb.append(reinterpret_cast<const uint8_t*>("poque in Europe, episode 12. "), 29);
+    }
+    const std::string utf8(ts::DVBCharTableSingleByte::RAW_ISO_6937.decoded(dvb.data(), dvb.size()).toUTF8());
+
+    // Support for benchmarking.
+    utest::TSUnitBenchmark bench(u"TSUNIT_CHARSET_ITERATIONS");
+    ts::UString str;
+
+    bench.start();
+    for (size_t iter = 0; iter < bench.iterations; ++iter) {
+        ts::DVBCharTableSingleByte::RAW_ISO_6937.decode(str, dvb.data(), dvb.size());
+    }
+    bench.stop();
+    bench.report(u"DVBCharTableSingleByte::decode");
+    TSUNIT_EQUAL(296, str.size());
+
+    bench.start();
+    for (size_t iter = 0; iter < bench.iterations; ++iter) {
+        ts::DVBCharTableUTF8::RAW_UTF_8.decode(str, reinterpret_cast<const uint8_t*>(utf8.data()), utf8.size());
+    }
+    bench.stop();
+    bench.report(u"DVBCharTableUTF8::decode");
+    TSUNIT_EQUAL(296, str.size());
+}
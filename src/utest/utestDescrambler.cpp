@@ -0,0 +1,238 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for AbstractDescrambler.
+//
+//----------------------------------------------------------------------------
+
+#include "tsAbstractDescrambler.h"
+#include "tsPluginRepository.h"
+#include "tsPluginEventHandlerInterface.h"
+#include "tsPluginEventData.h"
+#include "tsTSProcessor.h"
+#include "tsTSScrambling.h"
+#include "tsSysUtils.h"
+#include "tsNullReport.h"
+#include "tsCerrReport.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class DescramblerTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testFixedCW();
+
+    TSUNIT_TEST_BEGIN(DescramblerTest);
+    TSUNIT_TEST(testFixedCW);
+    TSUNIT_TEST_END();
+
+private:
+    // Descramble packets with the test descrambler plugin and the specified options.
+    static void Descramble(const ts::TSPacketVector& input, ts::TSPacketVector& output, const ts::UStringVector& args);
+};
+
+TSUNIT_REGISTER(DescramblerTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void DescramblerTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void DescramblerTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// A descrambler plugin without CAS, using fixed control words only.
+//----------------------------------------------------------------------------
+
+namespace {
+    class TestDescrambler : public ts::AbstractDescrambler
+    {
+        TS_NOBUILD_NOCOPY(TestDescrambler);
+    public:
+        // Constructor.
+        TestDescrambler(ts::TSP* t) : ts::AbstractDescrambler(t, u"Test descrambler", u"[options] [service]") {}
+
+        // A factory static method which creates an instance of that class.
+        static ts::ProcessorPlugin* CreateInstance(ts::TSP* t) { return new TestDescrambler(t); }
+
+    protected:
+        // Implementation of AbstractDescrambler, no ECM.
+        virtual bool checkCADescriptor(uint16_t, const ts::ByteBlock&) override { return false; }
+        virtual bool checkECM(const ts::Section&) override { return false; }
+        virtual bool decipherECM(const ts::Section&, CWData&, CWData&) override { return false; }
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Event handlers for memory input and output plugins.
+//----------------------------------------------------------------------------
+
+namespace {
+    class Input : public ts::PluginEventHandlerInterface
+    {
+        TS_NOBUILD_NOCOPY(Input);
+    public:
+        Input(const ts::TSPacketVector& packets) : _packets(packets), _next(0) {}
+        virtual void handlePluginEvent(const ts::PluginEventContext& context) override;
+    private:
+        const ts::TSPacketVector& _packets;
+        size_t _next;
+    };
+
+    // Send packets by groups of 100.
+    void Input::handlePluginEvent(const ts::PluginEventContext& context)
+    {
+        ts::PluginEventData* data = dynamic_cast<ts::PluginEventData*>(context.pluginData());
+        if (data != nullptr && _next < _packets.size()) {
+            const size_t count = std::min<size_t>(100, _packets.size() - _next);
+            data->append(&_packets[_next], count * ts::PKT_SIZE);
+            _next += count;
+        }
+    }
+
+    class Output : public ts::PluginEventHandlerInterface
+    {
+        TS_NOBUILD_NOCOPY(Output);
+    public:
+        Output(ts::TSPacketVector& packets) : _packets(packets) {}
+        virtual void handlePluginEvent(const ts::PluginEventContext& context) override;
+    private:
+        ts::TSPacketVector& _packets;
+    };
+
+    void Output::handlePluginEvent(const ts::PluginEventContext& context)
+    {
+        ts::PluginEventData* data = dynamic_cast<ts::PluginEventData*>(context.pluginData());
+        if (data != nullptr) {
+            const size_t count = data->size() / ts::PKT_SIZE;
+            const size_t index = _packets.size();
+            _packets.resize(index + count);
+            ts::TSPacket::Copy(&_packets[index], data->data(), count);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Descramble packets with the test descrambler plugin.
+//----------------------------------------------------------------------------
+
+void DescramblerTest::Descramble(const ts::TSPacketVector& input, ts::TSPacketVector& output, const ts::UStringVector& args)
+{
+    Input in(input);
+    Output out(output);
+    output.clear();
+
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"DescramblerTest";
+    opt.input = {u"memory", {}};
+    opt.plugins = {{u"testdescrambler", args}};
+    opt.output = {u"memory", {}};
+
+    ts::TSProcessor tsp(CERR);
+    tsp.registerEventHandler(&in, ts::PluginType::INPUT);
+    tsp.registerEventHandler(&out, ts::PluginType::OUTPUT);
+    TSUNIT_ASSERT(tsp.start(opt));
+    tsp.waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void DescramblerTest::testFixedCW()
+{
+    ts::PluginRepository::Instance()->registerProcessor(u"testdescrambler", TestDescrambler::CreateInstance);
+
+    // Reference clear packets: scrambled PID 100 and clear PID 200.
+    ts::TSPacketVector clear(5000);
+    for (size_t i = 0; i < clear.size(); ++i) {
+        const ts::PID pid = i % 5 == 0 ? 200 : 100;
+        clear[i].init(pid, uint8_t(i & ts::CC_MASK), uint8_t(i));
+        for (size_t j = 4; j < ts::PKT_SIZE; ++j) {
+            clear[i].b[j] = uint8_t(i + 7 * j);
+        }
+    }
+
+    // Scramble PID 100 with the even CW.
+    const ts::ByteBlock cw({0x01, 0x23, 0x45, 0x69, 0x89, 0xAB, 0xCD, 0x01});
+    ts::TSScrambling scrambling(NULLREP);
+    TSUNIT_ASSERT(scrambling.setCW(cw, ts::SC_EVEN_KEY));
+    ts::TSPacketVector scrambled(clear);
+    for (auto& pkt : scrambled) {
+        if (pkt.getPID() == 100) {
+            TSUNIT_ASSERT(scrambling.encrypt(pkt));
+        }
+    }
+    TSUNIT_ASSERT(scrambled[1] != clear[1]);
+    TSUNIT_ASSERT(scrambled[1].getScrambling() == ts::SC_EVEN_KEY);
+
+    // Descramble in all modes: packet per packet, packet window without and with descrambling threads.
+    const ts::UString cw_hexa(ts::UString::Dump(cw, ts::UString::COMPACT));
+    ts::TSPacketVector output;
+
+    Descramble(scrambled, output, {u"--pid", u"100", u"--cw", cw_hexa});
+    TSUNIT_EQUAL(clear.size(), output.size());
+    TSUNIT_ASSERT(output == clear);
+
+    Descramble(scrambled, output, {u"--pid", u"100", u"--cw", cw_hexa, u"--threads", u"4"});
+    TSUNIT_EQUAL(clear.size(), output.size());
+    TSUNIT_ASSERT(output == clear);
+
+    // Force the packet window mode on a single-threaded descrambler.
+    TSUNIT_ASSERT(ts::SetEnvironment(u"TSP_FORCED_WINDOW_SIZE", u"333"));
+
+    Descramble(scrambled, output, {u"--pid", u"100", u"--cw", cw_hexa});
+    TSUNIT_EQUAL(clear.size(), output.size());
+    TSUNIT_ASSERT(output == clear);
+
+    Descramble(scrambled, output, {u"--pid", u"100", u"--cw", cw_hexa, u"--threads", u"3"});
+    TSUNIT_EQUAL(clear.size(), output.size());
+    TSUNIT_ASSERT(output == clear);
+
+    TSUNIT_ASSERT(ts::DeleteEnvironment(u"TSP_FORCED_WINDOW_SIZE"));
+}
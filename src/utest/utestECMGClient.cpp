@@ -0,0 +1,351 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for ECMGClient.
+//
+//----------------------------------------------------------------------------
+
+#include "tsECMGClient.h"
+#include "tsECMGClientArgs.h"
+#include "tsTCPServer.h"
+#include "tsReportBuffer.h"
+#include "tsGuardCondition.h"
+#include "tsIPUtils.h"
+#include "tsCerrReport.h"
+#include "utestTSUnitThread.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class ECMGClientTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testMultiStreams();
+
+    TSUNIT_TEST_BEGIN(ECMGClientTest);
+    TSUNIT_TEST(testMultiStreams);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(ECMGClientTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void ECMGClientTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void ECMGClientTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// A minimal ECMG, serving one client in a thread.
+// The ECM is made of the stream id and the CP number.
+// On stream 3, the CW_provision for CP 20 gets a stream_error, the others are ignored.
+//----------------------------------------------------------------------------
+
+namespace {
+    class TestECMG: public utest::TSUnitThread
+    {
+        TS_NOBUILD_NOCOPY(TestECMG);
+    private:
+        ts::TCPServer& _server;
+        ts::ecmgscs::Protocol _protocol {};
+    public:
+        explicit TestECMG(ts::TCPServer& server) :
+            utest::TSUnitThread(),
+            _server(server)
+        {
+        }
+
+        virtual ~TestECMG() override
+        {
+            waitForTermination();
+        }
+
+        static ts::ByteBlock ECM(uint16_t stream_id, uint16_t cp_number)
+        {
+            return ts::ByteBlock({uint8_t(stream_id >> 8), uint8_t(stream_id), uint8_t(cp_number >> 8), uint8_t(cp_number)});
+        }
+
+        virtual void test() override
+        {
+            ts::tlv::Connection<ts::NullMutex> client(_protocol);
+            ts::IPv4SocketAddress client_address;
+            ts::tlv::Logger logger(ts::Severity::Debug, &CERR);
+            TSUNIT_ASSERT(_server.accept(client, client_address, CERR));
+
+            ts::tlv::MessagePtr msg;
+            bool closed = false;
+            while (!closed && client.receive(msg, nullptr, logger)) {
+                switch (msg->tag()) {
+                    case ts::ecmgscs::Tags::channel_setup: {
+                        const ts::ecmgscs::ChannelSetup* req = dynamic_cast<const ts::ecmgscs::ChannelSetup*>(msg.pointer());
+                        TSUNIT_ASSERT(req != nullptr);
+                        ts::ecmgscs::ChannelStatus resp(_protocol);
+                        resp.channel_id = req->channel_id;
+                        resp.section_TSpkt_flag = false;
+                        resp.CW_per_msg = 2;
+                        resp.lead_CW = 1;
+                        resp.max_comp_time = 100;
+                        TSUNIT_ASSERT(client.send(resp, logger));
+                        break;
+                    }
+                    case ts::ecmgscs::Tags::stream_setup: {
+                        const ts::ecmgscs::StreamSetup* req = dynamic_cast<const ts::ecmgscs::StreamSetup*>(msg.pointer());
+                        TSUNIT_ASSERT(req != nullptr);
+                        ts::ecmgscs::StreamStatus resp(_protocol);
+                        resp.channel_id = req->channel_id;
+                        resp.stream_id = req->stream_id;
+                        resp.ECM_id = req->ECM_id;
+                        TSUNIT_ASSERT(client.send(resp, logger));
+                        break;
+                    }
+                    case ts::ecmgscs::Tags::CW_provision: {
+                        const ts::ecmgscs::CWProvision* req = dynamic_cast<const ts::ecmgscs::CWProvision*>(msg.pointer());
+                        TSUNIT_ASSERT(req != nullptr);
+                        if (req->stream_id == 3 && req->CP_number == 20) {
+                            ts::ecmgscs::StreamError resp(_protocol);
+                            resp.channel_id = req->channel_id;
+                            resp.stream_id = req->stream_id;
+                            resp.error_status.push_back(ts::ecmgscs::Errors::unknown_error);
+                            TSUNIT_ASSERT(client.send(resp, logger));
+                        }
+                        else if (req->stream_id != 3) {
+                            ts::ecmgscs::ECMResponse resp(_protocol);
+                            resp.channel_id = req->channel_id;
+                            resp.stream_id = req->stream_id;
+                            resp.CP_number = req->CP_number;
+                            resp.ECM_datagram = ECM(req->stream_id, req->CP_number);
+                            TSUNIT_ASSERT(client.send(resp, logger));
+                        }
+                        break;
+                    }
+                    case ts::ecmgscs::Tags::stream_close_request: {
+                        const ts::ecmgscs::StreamCloseRequest* req = dynamic_cast<const ts::ecmgscs::StreamCloseRequest*>(msg.pointer());
+                        TSUNIT_ASSERT(req != nullptr);
+                        ts::ecmgscs::StreamCloseResponse resp(_protocol);
+                        resp.channel_id = req->channel_id;
+                        resp.stream_id = req->stream_id;
+                        TSUNIT_ASSERT(client.send(resp, logger));
+                        break;
+                    }
+                    case ts::ecmgscs::Tags::channel_close: {
+                        closed = true;
+                        break;
+                    }
+                    default: {
+                        TSUNIT_FAIL("unexpected message from ECMG client");
+                        break;
+                    }
+                }
+            }
+            TSUNIT_ASSERT(closed);
+            client.disconnect(CERR);
+            client.close(CERR);
+        }
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// An ECM handler which logs all notifications, from the ECMG client thread.
+//----------------------------------------------------------------------------
+
+namespace {
+    class TestHandler: public ts::ECMGClientHandlerInterface
+    {
+        TS_NOCOPY(TestHandler);
+    public:
+        TestHandler() = default;
+
+        // Wait until a given number of notifications are received, return all of them in order.
+        ts::UStringList wait(size_t count)
+        {
+            ts::GuardCondition lock(_mutex, _cond);
+            while (_events.size() < count) {
+                // Fail after 5 seconds without notification.
+                if (!lock.waitCondition(5000)) {
+                    break;
+                }
+            }
+            return _events;
+        }
+
+        virtual void handleECM(const ts::ecmgscs::ECMResponse& response) override
+        {
+            notify(ts::UString::Format(u"ECM %d/%d %s", {response.stream_id, response.CP_number, ts::UString::Dump(response.ECM_datagram, ts::UString::COMPACT)}));
+        }
+
+        virtual void handleECMError(uint16_t cp_number, const ts::ecmgscs::StreamError& error) override
+        {
+            notify(ts::UString::Format(u"error %d/%d", {error.stream_id, cp_number}));
+        }
+
+    private:
+        ts::Mutex       _mutex {};
+        ts::Condition   _cond {};
+        ts::UStringList _events {};
+
+        void notify(const ts::UString& event)
+        {
+            ts::GuardCondition lock(_mutex, _cond);
+            _events.push_back(event);
+            lock.signal();
+        }
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void ECMGClientTest::testMultiStreams()
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    const ts::IPv4SocketAddress ecmg_address(ts::IPv4Address::LocalHost, 12349);
+    ts::TCPServer server;
+    TSUNIT_ASSERT(server.open(CERR));
+    TSUNIT_ASSERT(server.reusePort(true, CERR));
+    TSUNIT_ASSERT(server.bind(ecmg_address, CERR));
+    TSUNIT_ASSERT(server.listen(5, CERR));
+
+    TestECMG ecmg(server);
+    TSUNIT_ASSERT(ecmg.start());
+
+    // Each stream has its own report.
+    ts::ReportBuffer<ts::Mutex> report1;
+    ts::ReportBuffer<ts::Mutex> report2;
+    ts::ReportBuffer<ts::Mutex> report3;
+    const ts::tlv::Logger logger1(ts::Severity::Debug, &report1);
+    const ts::tlv::Logger logger2(ts::Severity::Debug, &report2);
+    const ts::tlv::Logger logger3(ts::Severity::Debug, &report3);
+
+    // Open the channel with stream 1, then add streams 2 and 3.
+    ts::ecmgscs::Protocol protocol;
+    ts::ECMGClient client(protocol);
+    ts::ECMGClientArgs args;
+    args.ecmg_address = ecmg_address;
+    args.super_cas_id = 0x12345678;
+    args.ecm_channel_id = 7;
+    args.ecm_stream_id = 1;
+    args.ecm_id = 1;
+    args.cp_duration = 10000;
+    ts::ecmgscs::ChannelStatus channel_status(protocol);
+    ts::ecmgscs::StreamStatus stream_status(protocol);
+    TSUNIT_ASSERT(client.connect(args, channel_status, stream_status, nullptr, logger1));
+    TSUNIT_ASSERT(client.isConnected());
+    TSUNIT_EQUAL(7, channel_status.channel_id);
+    TSUNIT_EQUAL(1, stream_status.stream_id);
+
+    TSUNIT_ASSERT(client.addStream(2, 2, 100, stream_status, nullptr, logger2));
+    TSUNIT_EQUAL(2, stream_status.stream_id);
+    TSUNIT_ASSERT(client.addStream(3, 3, 100, stream_status, nullptr, logger3));
+    TSUNIT_EQUAL(3, stream_status.stream_id);
+    TSUNIT_ASSERT(!client.addStream(2, 4, 100, stream_status, nullptr, logger3));
+    TSUNIT_ASSERT(report3.getMessages().contain(u"ECM stream id 2 already open"));
+
+    // Pipelined requests on streams 1 and 2 in one batch.
+    TestHandler handler;
+    const ts::ByteBlock cw(8, 0x55);
+    ts::ECMGClient::ECMRequestVector requests;
+    for (uint16_t cp = 10; cp < 13; ++cp) {
+        for (uint16_t stream = 1; stream <= 2; ++stream) {
+            ts::ECMGClient::ECMRequest req;
+            req.stream_id = stream;
+            req.cp_number = cp;
+            req.current_cw = cw;
+            req.next_cw = cw;
+            req.handler = &handler;
+            requests.push_back(req);
+        }
+    }
+    TSUNIT_ASSERT(client.submitECMs(requests));
+
+    ts::UStringList events(handler.wait(6));
+    TSUNIT_EQUAL(6, events.size());
+    TSUNIT_EQUAL(u"ECM 1/10 0001000A", events.front());
+    TSUNIT_EQUAL(u"ECM 2/12 0002000C", events.back());
+
+    // A batch on an unknown stream is rejected, nothing is sent.
+    requests.back().stream_id = 9;
+    TSUNIT_ASSERT(!client.submitECMs(requests));
+
+    // Two pending requests on stream 3, one stream_error fails both of them.
+    // The error is reported on the logger of stream 3.
+    TSUNIT_ASSERT(client.submitECM(3, 20, cw, cw, ts::ByteBlock(), 0, &handler));
+    TSUNIT_ASSERT(client.submitECM(3, 21, cw, cw, ts::ByteBlock(), 0, &handler));
+    events = handler.wait(8);
+    TSUNIT_EQUAL(8, events.size());
+    events.erase(events.begin(), std::next(events.begin(), 6));
+    events.sort();
+    TSUNIT_EQUAL(u"error 3/20", events.front());
+    TSUNIT_EQUAL(u"error 3/21", events.back());
+    TSUNIT_ASSERT(report3.getMessages().contain(u"ECMG error on ECM stream 3, 2 pending ECM requests failed"));
+    TSUNIT_ASSERT(!report1.getMessages().contain(u"ECMG error"));
+
+    // Synchronous request, after the failed ones.
+    ts::ecmgscs::ECMResponse response(protocol);
+    TSUNIT_ASSERT(client.generateECM(2, 30, cw, cw, ts::ByteBlock(), 0, response));
+    TSUNIT_EQUAL(2, response.stream_id);
+    TSUNIT_EQUAL(30, response.CP_number);
+    TSUNIT_ASSERT(response.ECM_datagram == TestECMG::ECM(2, 30));
+
+    // Close stream 1, which opened the channel. The channel now reports on the logger of stream 2.
+    TSUNIT_ASSERT(client.removeStream(1));
+    TSUNIT_ASSERT(!client.removeStream(1));
+    TSUNIT_ASSERT(report2.getMessages().contain(u"ECM stream id 1 not open"));
+    TSUNIT_ASSERT(!report1.getMessages().contain(u"ECM stream id 1 not open"));
+    TSUNIT_ASSERT(!client.submitECM(1, 40, cw, cw, ts::ByteBlock(), 0, &handler));
+
+    // The remaining streams still work.
+    TSUNIT_ASSERT(client.submitECM(2, 40, cw, cw, ts::ByteBlock(), 0, &handler));
+    events = handler.wait(9);
+    TSUNIT_EQUAL(9, events.size());
+    TSUNIT_EQUAL(u"ECM 2/40 00020028", events.back());
+
+    TSUNIT_ASSERT(client.disconnect());
+    TSUNIT_ASSERT(!client.isConnected());
+    debug() << "ECMGClientTest::testMultiStreams: stream 1 log:" << std::endl << report1.getMessages() << std::endl;
+}
@@ -95,6 +95,7 @@ public:
     void testGetIntVarLE();
     void testPutIntVarBE();
     void testPutIntVarLE();
+    void testLocateZeroZero();
 
     TSUNIT_TEST_BEGIN(MemoryTest);
     TSUNIT_TEST(testGetUInt8);
@@ -147,6 +148,7 @@ public:
     TSUNIT_TEST(testGetIntVarLE);
     TSUNIT_TEST(testPutIntVarBE);
     TSUNIT_TEST(testPutIntVarLE);
+    TSUNIT_TEST(testLocateZeroZero);
     TSUNIT_TEST_END();
 };
 
@@ -531,3 +533,52 @@ void MemoryTest::testPutIntVarLE()
     ts::PutIntVarLE(out, 8, TS_UCONST64(0x908F8E8D8C8B8A89));
     TSUNIT_EQUAL(0, ::memcmp(out, _bytes + 0x89, 8));
 }
+
+void MemoryTest::testLocateZeroZero()
+{
+    // Test all positions and area sizes, to cover both vector and scalar code.
+    uint8_t area[64];
+    for (size_t pos = 0; pos + 3 <= sizeof(area); ++pos) {
+        ::memset(area, 0xFF, sizeof(area));
+        area[pos] = area[pos + 1] = 0x00;
+        area[pos + 2] = 0x01;
+        for (size_t size = 0; size <= sizeof(area); ++size) {
+            const uint8_t* p = ts::LocateZeroZero(area, size, 0x01);
+            TSUNIT_ASSERT(p == ts::LocatePattern(area, size, area + pos, 3));
+            TSUNIT_ASSERT(p == (pos + 3 <= size ? area + pos : nullptr));
+            TSUNIT_ASSERT(ts::LocateZeroZero(area, size, 0x00) == nullptr);
+        }
+    }
+
+    // First of several occurences, partial patterns.
+    static const uint8_t data[] = {
+        0x00, 0x01, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55,
+        0x66, 0x77, 0x88, 0x99, 0x00, 0x00, 0x01, 0xB3, 0x00, 0x00, 0x00, 0x01, 0x09, 0x00, 0x00, 0x01,
+    };
+    TSUNIT_EQUAL(20, ts::LocateZeroZero(data, sizeof(data), 0x01) - data);
+    TSUNIT_EQUAL(25, ts::LocateZeroZero(data + 21, sizeof(data) - 21, 0x01) - data);
+    TSUNIT_EQUAL(29, ts::LocateZeroZero(data + 26, sizeof(data) - 26, 0x01) - data);
+    TSUNIT_EQUAL(5, ts::LocateZeroZero(data, sizeof(data), 0x00) - data);
+    TSUNIT_EQUAL(2, ts::LocateZeroZero(data, sizeof(data), 0x02) - data);
+    TSUNIT_ASSERT(ts::LocateZeroZero(data, sizeof(data), 0x03) == nullptr);
+
+    // Ranges of third byte.
+    TSUNIT_EQUAL(2, ts::LocateZeroZero(data, sizeof(data), 0x00, 0x02) - data);
+    TSUNIT_EQUAL(5, ts::LocateZeroZero(data, sizeof(data), 0x00, 0x01) - data);
+    TSUNIT_EQUAL(6, ts::LocateZeroZero(data, sizeof(data), 0x05, 0x11) - data);
+    TSUNIT_EQUAL(9, ts::LocateZeroZero(data, sizeof(data), 0x06, 0xFF) - data);
+    TSUNIT_EQUAL(20, ts::LocateZeroZero(data + 8, sizeof(data) - 8, 0x01, 0x01) - data);
+    TSUNIT_ASSERT(ts::LocateZeroZero(data, sizeof(data), 0x12, 0xFF) == nullptr);
+
+    // Range at all positions, to cover both vector and scalar code.
+    for (size_t pos = 0; pos + 3 <= sizeof(area); ++pos) {
+        ::memset(area, 0x55, sizeof(area));
+        area[pos] = area[pos + 1] = 0x00;
+        area[pos + 2] = 0x40;
+        for (size_t size = 0; size <= sizeof(area); ++size) {
+            TSUNIT_ASSERT(ts::LocateZeroZero(area, size, 0x30, 0x4F) == (pos + 3 <= size ? area + pos : nullptr));
+            TSUNIT_ASSERT(ts::LocateZeroZero(area, size, 0x00, 0x3F) == nullptr);
+            TSUNIT_ASSERT(ts::LocateZeroZero(area, size, 0x41, 0xFF) == nullptr);
+        }
+    }
+}
@@ -99,6 +99,7 @@ public:
     void testIP();
     void testExtension();
     void testInheritance();
+    void testSplitSections();
 
     TSUNIT_TEST_BEGIN(NamesTest);
     TSUNIT_TEST(testConfigFile);
@@ -142,6 +143,7 @@ public:
     TSUNIT_TEST(testIP);
     TSUNIT_TEST(testExtension);
     TSUNIT_TEST(testInheritance);
+    TSUNIT_TEST(testSplitSections);
     TSUNIT_TEST_END();
 
 private:
@@ -550,3 +552,34 @@ void NamesTest::testInheritance()
     TSUNIT_EQUAL(u"value1", file.nameFromSection(u"level1", 1));
     TSUNIT_EQUAL(u"unknown (0x00)", file.nameFromSection(u"level1", 0));
 }
+
+void NamesTest::testSplitSections()
+{
+    // Create a temporary names file where sections are split in several parts.
+    // The sections are decoded on demand but all parts must be merged.
+    TSUNIT_ASSERT(ts::UString::Save(ts::UStringVector({
+        u"# Leading comment",
+        u"",
+        u"[Section1]",
+        u"Bits = 16",
+        u"0x0001 = name1",
+        u"0x0010-0x001F = range1",
+        u"[Section2]",
+        u"# Comment in section",
+        u"  2 = name2  ",
+        u"[SECTION1]",
+        u"",
+        u"0x0003 = name3",
+    }), _tempFileName));
+
+    ts::NamesFile file(_tempFileName);
+
+    TSUNIT_EQUAL(u"name1", file.nameFromSection(u"section1", 1));
+    TSUNIT_EQUAL(u"name3", file.nameFromSection(u"Section1", 3));
+    TSUNIT_EQUAL(u"range1 (0x0015)", file.nameFromSection(u"section1", 0x15, ts::NamesFlags::VALUE));
+    TSUNIT_EQUAL(u"unknown (0x0002)", file.nameFromSection(u"section1", 2));
+    TSUNIT_ASSERT(!file.nameExists(u"section1", 0x20));
+    TSUNIT_EQUAL(u"name2", file.nameFromSection(u"section2", 2));
+    TSUNIT_ASSERT(!file.nameExists(u"section3", 2));
+    TSUNIT_EQUAL(0, file.errorCount());
+}
@@ -40,7 +40,11 @@
 #include "tsTCPConnection.h"
 #include "tsTCPServer.h"
 #include "tsUDPSocket.h"
+#include "tsUDPReceiverSet.h"
+#include "tsDuckContext.h"
+#include "tsArgs.h"
 #include "tsThread.h"
+#include "tsSysUtils.h"
 #include "tsNullReport.h"
 #include "tsIPUtils.h"
 #include "tsCerrReport.h"
@@ -69,7 +73,10 @@ public:
     void testIPv4SocketAddress();
     void testIPv6SocketAddress();
     void testTCPSocket();
+    void testTCPNonBlocking();
     void testUDPSocket();
+    void testUDPSocketIPv6();
+    void testUDPReceiverSet();
     void testIPHeader();
     void testIPProtocol();
     void testTCPPacket();
@@ -85,7 +92,10 @@ public:
     TSUNIT_TEST(testIPv4SocketAddress);
     TSUNIT_TEST(testIPv6SocketAddress);
     TSUNIT_TEST(testTCPSocket);
+    TSUNIT_TEST(testTCPNonBlocking);
     TSUNIT_TEST(testUDPSocket);
+    TSUNIT_TEST(testUDPSocketIPv6);
+    TSUNIT_TEST(testUDPReceiverSet);
     TSUNIT_TEST(testIPHeader);
     TSUNIT_TEST(testIPProtocol);
     TSUNIT_TEST(testTCPPacket);
@@ -280,6 +290,32 @@ void NetworkingTest::testIPv6Address()
     TSUNIT_EQUAL(TS_UCONST64(0x93A3DEA02108B81E), a1.interfaceIdentifier());
     TSUNIT_EQUAL(u"fe80::93a3:dea0:2108:b81e", a1.toString());
     TSUNIT_EQUAL(u"fe80:0000:0000:0000:93a3:dea0:2108:b81e", a1.toFullString());
+    TSUNIT_ASSERT(!a1.isMulticast());
+    TSUNIT_ASSERT(!a1.isSSM());
+    TSUNIT_ASSERT(a1.isLinkLocal());
+
+    TSUNIT_ASSERT(a1.resolve(u"ff15::1234", CERR));
+    TSUNIT_ASSERT(a1.isMulticast());
+    TSUNIT_ASSERT(!a1.isSSM());
+    TSUNIT_ASSERT(!a1.isLinkLocal());
+
+    TSUNIT_ASSERT(a1.resolve(u"ff35::1234", CERR));
+    TSUNIT_ASSERT(a1.isMulticast());
+    TSUNIT_ASSERT(a1.isSSM());
+    TSUNIT_ASSERT(!a1.isLinkLocal());
+
+    TSUNIT_ASSERT(a1.resolve(u"ff02::1", CERR));
+    TSUNIT_ASSERT(a1.isMulticast());
+    TSUNIT_ASSERT(a1.isLinkLocal());
+
+    TSUNIT_ASSERT(a1.resolve(u"2001:db8::1", CERR));
+    TSUNIT_ASSERT(!a1.isLinkLocal());
+    TSUNIT_ASSERT(!ts::IPv6Address::LocalHost.isLinkLocal());
+
+    TSUNIT_ASSERT(ts::IPStringGeneration(u"1.2.3.4:5000") == ts::IP::v4);
+    TSUNIT_ASSERT(ts::IPStringGeneration(u"5000") == ts::IP::v4);
+    TSUNIT_ASSERT(ts::IPStringGeneration(u"[::1]:5000") == ts::IP::v6);
+    TSUNIT_ASSERT(ts::IPStringGeneration(u"fe80::1") == ts::IP::v6);
 }
 
 void NetworkingTest::testMACAddress()
@@ -652,6 +688,104 @@ void NetworkingTest::testTCPSocket()
     CERR.debug(u"TCPSocketTest: main thread: terminated");
 }
 
+void NetworkingTest::testTCPNonBlocking()
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    // Client and server sides of a TCP connection on the loopback, all in the same thread.
+    // Small socket buffers on both sides (inherited by the session) to quickly fill the connection.
+    const ts::IPv4SocketAddress serverAddress(ts::IPv4Address::LocalHost, 12346);
+    ts::TCPServer server;
+    TSUNIT_ASSERT(server.open(CERR));
+    TSUNIT_ASSERT(server.reusePort(true, CERR));
+    TSUNIT_ASSERT(server.setReceiveBufferSize(4096, CERR));
+    TSUNIT_ASSERT(server.bind(serverAddress, CERR));
+    TSUNIT_ASSERT(server.listen(5, CERR));
+
+    ts::TCPConnection client;
+    TSUNIT_ASSERT(client.open(CERR));
+    TSUNIT_ASSERT(client.setSendBufferSize(4096, CERR));
+    TSUNIT_ASSERT(client.connect(serverAddress, CERR));
+
+    ts::TCPConnection session;
+    ts::IPv4SocketAddress clientAddress;
+    TSUNIT_ASSERT(server.accept(session, clientAddress, CERR));
+
+    // Switch the client to non-blocking mode and back.
+    TSUNIT_ASSERT(!client.isNonBlocking());
+    TSUNIT_ASSERT(client.setNonBlocking(true, CERR));
+    TSUNIT_ASSERT(client.isNonBlocking());
+    TSUNIT_ASSERT(client.setNonBlocking(false, CERR));
+    TSUNIT_ASSERT(!client.isNonBlocking());
+    TSUNIT_ASSERT(client.setNonBlocking(true, CERR));
+
+    // Nothing to receive yet: no error, no data.
+    uint8_t buffer[1024];
+    size_t size = 1;
+    TSUNIT_ASSERT(client.receive(buffer, sizeof(buffer), size, nullptr, CERR));
+    TSUNIT_EQUAL(0, size);
+
+    // Send much more than the socket buffers can hold, without reading on the other side.
+    // The send operation accepts part of the data, then nothing.
+    ts::ByteBlock data(512 * 1024);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = uint8_t(i / 7);
+    }
+    size_t sent = 0;
+    size = 1;
+    while (size > 0 && sent < data.size()) {
+        TSUNIT_ASSERT(client.send(&data[sent], data.size() - sent, size, CERR));
+        sent += size;
+    }
+    CERR.debug(u"TCPNonBlocking: %d bytes accepted before blocking", {sent});
+    TSUNIT_ASSERT(sent > 0);
+    TSUNIT_ASSERT(sent < data.size());
+
+    // Read everything on the (blocking) server side, completing the send on the client side.
+    ts::ByteBlock received;
+    ts::ByteBlock chunk(64 * 1024);
+    while (received.size() < data.size()) {
+        if (sent < data.size()) {
+            TSUNIT_ASSERT(client.send(&data[sent], data.size() - sent, size, CERR));
+            sent += size;
+        }
+        TSUNIT_ASSERT(session.receive(chunk.data(), chunk.size(), size, nullptr, CERR));
+        received.append(chunk.data(), size);
+    }
+    TSUNIT_EQUAL(data.size(), sent);
+    TSUNIT_ASSERT(received == data);
+
+    // Non-blocking receive on the client side.
+    const char message[] = "Hello";
+    TSUNIT_ASSERT(session.send(message, sizeof(message), CERR));
+    size_t total = 0;
+    for (int i = 0; i < 100 && total < sizeof(message); ++i) {
+        TSUNIT_ASSERT(client.receive(buffer + total, sizeof(buffer) - total, size, nullptr, CERR));
+        total += size;
+        if (size == 0) {
+            ts::SleepThread(10);
+        }
+    }
+    TSUNIT_EQUAL(sizeof(message), total);
+    TSUNIT_EQUAL(0, ::memcmp(message, buffer, total));
+
+    // A disconnection is reported as end of stream, not as "no data".
+    TSUNIT_ASSERT(session.disconnect(CERR));
+    TSUNIT_ASSERT(session.close(CERR));
+    bool ok = true;
+    for (int i = 0; ok && i < 100; ++i) {
+        ok = client.receive(buffer, sizeof(buffer), size, nullptr, NULLREP);
+        if (ok) {
+            TSUNIT_EQUAL(0, size);
+            ts::SleepThread(10);
+        }
+    }
+    TSUNIT_ASSERT(!ok);
+    TSUNIT_ASSERT(!client.isConnected());
+    client.close(CERR);
+    TSUNIT_ASSERT(server.close(CERR));
+}
+
 // A thread class which sends one UDP message and wait from the same message to be replied.
 namespace {
     class UDPClient: public utest::TSUnitThread
@@ -746,6 +880,174 @@ void NetworkingTest::testUDPSocket()
     CERR.debug(u"UDPSocketTest: main thread: reply sent");
 }
 
+void NetworkingTest::testUDPSocketIPv6()
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    // Send a message to ourself on the IPv6 loopback.
+    ts::UDPSocket sock;
+    TSUNIT_ASSERT(sock.open(ts::IP::v6, CERR));
+    TSUNIT_ASSERT(sock.generation() == ts::IP::v6);
+    TSUNIT_ASSERT(sock.bind(ts::IPv6SocketAddress(ts::IPv6Address::LocalHost, ts::IPv6SocketAddress::AnyPort), CERR));
+
+    ts::IPv6SocketAddress local;
+    TSUNIT_ASSERT(sock.getLocalAddress(local, CERR));
+    TSUNIT_ASSERT(local.hasPort());
+    TSUNIT_ASSERT(sock.setDefaultDestination(local, CERR));
+
+    // An IPv4 address cannot be used on an IPv6 socket.
+    TSUNIT_ASSERT(!sock.send("x", 1, ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, 1234), NULLREP));
+
+    // Link-local addresses are rejected, the interface scope is not supported.
+    TSUNIT_ASSERT(!sock.send("x", 1, ts::IPv6SocketAddress(ts::IPv6Address(0xFE80, 0, 0, 0, 0, 0, 0, 1), 1234), NULLREP));
+    ts::UDPSocket sock2;
+    TSUNIT_ASSERT(sock2.open(ts::IP::v6, CERR));
+    TSUNIT_ASSERT(!sock2.bind(ts::IPv6SocketAddress(ts::IPv6Address(0xFF02, 0, 0, 0, 0, 0, 0, 0x1234), 1234), NULLREP));
+    TSUNIT_ASSERT(sock2.close(CERR));
+
+    const char message[] = "Hello";
+    TSUNIT_ASSERT(sock.send(message, sizeof(message), CERR));
+
+    ts::IPv6SocketAddress sender;
+    ts::IPv6SocketAddress destination;
+    char buffer [1024];
+    size_t size = 0;
+    TSUNIT_ASSERT(sock.receive(buffer, sizeof(buffer), size, sender, destination, nullptr, CERR));
+    CERR.debug(u"UDPSocketTest: IPv6 message received, %d bytes, sender: %s, destination: %s", {size, sender, destination});
+    TSUNIT_EQUAL(sizeof(message), size);
+    TSUNIT_ASSERT(::memcmp(message, buffer, size) == 0);
+    TSUNIT_ASSERT(ts::IPv6Address(sender) == ts::IPv6Address::LocalHost);
+    TSUNIT_EQUAL(local.port(), sender.port());
+    TSUNIT_ASSERT(ts::IPv6Address(destination) == ts::IPv6Address::LocalHost);
+    TSUNIT_ASSERT(sock.close(CERR));
+}
+
+// A thread class which closes a set of UDP receivers after some time.
+namespace {
+    class UDPReceiverSetCloser: public utest::TSUnitThread
+    {
+        TS_NOBUILD_NOCOPY(UDPReceiverSetCloser);
+    private:
+        ts::UDPReceiverSet& _set;
+    public:
+        explicit UDPReceiverSetCloser(ts::UDPReceiverSet& set) :
+            utest::TSUnitThread(),
+            _set(set)
+        {
+        }
+
+        virtual ~UDPReceiverSetCloser() override
+        {
+            waitForTermination();
+        }
+
+        virtual void test() override
+        {
+            ts::SleepThread(200);
+            TSUNIT_ASSERT(_set.close(CERR));
+        }
+    };
+}
+
+void NetworkingTest::testUDPReceiverSet()
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    // Three unicast receivers on the loopback, two IPv4 and one IPv6.
+    ts::DuckContext duck;
+    ts::Args args(u"UDP receiver set test", u"[options] [address:]port ...", ts::Args::NO_EXIT_ON_ERROR);
+    ts::UDPReceiverSet set(CERR);
+    set.defineArgs(args, true);
+    TSUNIT_ASSERT(args.analyze(u"test", ts::UStringVector({u"12350", u"12351", u"[::]:12352"})));
+    TSUNIT_ASSERT(set.loadArgs(duck, args));
+    TSUNIT_EQUAL(3, set.count());
+    TSUNIT_ASSERT(set.receiver(0).generation() == ts::IP::v4);
+    TSUNIT_ASSERT(set.receiver(2).generation() == ts::IP::v6);
+    TSUNIT_ASSERT(set.open(CERR));
+
+    ts::UDPSocket sock4;
+    ts::UDPSocket sock6;
+    TSUNIT_ASSERT(sock4.open(ts::IP::v4, CERR));
+    TSUNIT_ASSERT(sock6.open(ts::IP::v6, CERR));
+    const ts::IPv4SocketAddress dest0(ts::IPv4Address::LocalHost, 12350);
+    const ts::IPv4SocketAddress dest1(ts::IPv4Address::LocalHost, 12351);
+    const ts::IPv6SocketAddress dest2(ts::IPv6Address::LocalHost, 12352);
+
+    // Queue three messages on receiver 0, two on receiver 1, one on receiver 2.
+    // Each message contains the index of the receiver and a sequence number.
+    for (uint8_t seq = 0; seq < 3; ++seq) {
+        const uint8_t msg0[2] = {0, seq};
+        const uint8_t msg1[2] = {1, seq};
+        const uint8_t msg2[2] = {2, seq};
+        TSUNIT_ASSERT(sock4.send(msg0, sizeof(msg0), dest0, CERR));
+        if (seq < 2) {
+            TSUNIT_ASSERT(sock4.send(msg1, sizeof(msg1), dest1, CERR));
+        }
+        if (seq < 1) {
+            TSUNIT_ASSERT(sock6.send(msg2, sizeof(msg2), dest2, CERR));
+        }
+    }
+    ts::SleepThread(50);
+
+    // Ready receivers are serviced in turn: one message from each of them, then
+    // one from each receiver which still has messages, etc.
+    const size_t expected_counts[] = {3, 2, 1};
+    size_t counts[3] = {0, 0, 0};
+    uint8_t buffer[1024];
+    size_t size = 0;
+    size_t index = 0;
+    for (size_t round = 0; round < 3; ++round) {
+        const size_t ready = round == 0 ? 3 : (round == 1 ? 2 : 1);
+        bool seen[3] = {false, false, false};
+        for (size_t i = 0; i < ready; ++i) {
+            TSUNIT_ASSERT(set.receive(buffer, sizeof(buffer), size, index, nullptr, CERR, nullptr, 1000));
+            CERR.debug(u"UDPReceiverSet: round %d, received %d bytes on receiver %d", {round, size, index});
+            TSUNIT_EQUAL(2, size);
+            TSUNIT_ASSERT(index < 3);
+            TSUNIT_EQUAL(index, buffer[0]);
+            TSUNIT_EQUAL(counts[index], buffer[1]);
+            TSUNIT_ASSERT(!seen[index]);
+            seen[index] = true;
+            counts[index]++;
+        }
+    }
+    for (size_t i = 0; i < 3; ++i) {
+        TSUNIT_EQUAL(expected_counts[i], counts[i]);
+    }
+
+    // No more message: return after the maximum waiting time, without error.
+    TSUNIT_ASSERT(set.receive(buffer, sizeof(buffer), size, index, nullptr, CERR, nullptr, 100));
+    TSUNIT_EQUAL(0, size);
+
+    // A blocking receive is released when the set is closed from another thread.
+    {
+        UDPReceiverSetCloser closer(set);
+        closer.start();
+        const ts::Time start(ts::Time::CurrentUTC());
+        TSUNIT_ASSERT(!set.receive(buffer, sizeof(buffer), size, index, nullptr, CERR));
+        TSUNIT_ASSERT(ts::Time::CurrentUTC() - start < 5000);
+    }
+    set.close(CERR);
+
+    // With a receive timeout, a receive without message fails after the timeout.
+    ts::Args args2(u"UDP receiver set test", u"[options] [address:]port ...", ts::Args::NO_EXIT_ON_ERROR);
+    ts::UDPReceiverSet set2(CERR);
+    set2.defineArgs(args2, true);
+    TSUNIT_ASSERT(args2.analyze(u"test", ts::UStringVector({u"--receive-timeout", u"200", u"12350", u"[::]:12352"})));
+    TSUNIT_ASSERT(set2.loadArgs(duck, args2));
+    TSUNIT_EQUAL(2, set2.count());
+    TSUNIT_ASSERT(set2.open(CERR));
+    const ts::Time start(ts::Time::CurrentUTC());
+    TSUNIT_ASSERT(!set2.receive(buffer, sizeof(buffer), size, index, nullptr, NULLREP));
+    const ts::MilliSecond duration = ts::Time::CurrentUTC() - start;
+    TSUNIT_ASSERT(duration >= 150);
+    TSUNIT_ASSERT(duration < 5000);
+    TSUNIT_ASSERT(set2.close(CERR));
+
+    TSUNIT_ASSERT(sock4.close(CERR));
+    TSUNIT_ASSERT(sock6.close(CERR));
+}
+
 void NetworkingTest::testIPHeader()
 {
     static const uint8_t reference_header[] = {
@@ -0,0 +1,169 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for PCRAnalyzer.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPCRAnalyzer.h"
+#include "tsTSPacket.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PCRAnalyzerTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testBitrate();
+    void testLongStream();
+    void testWindowCapacity();
+
+    TSUNIT_TEST_BEGIN(PCRAnalyzerTest);
+    TSUNIT_TEST(testBitrate);
+    TSUNIT_TEST(testLongStream);
+    TSUNIT_TEST(testWindowCapacity);
+    TSUNIT_TEST_END();
+
+private:
+    // Build a packet with a PCR.
+    static void BuildPacket(ts::TSPacket& pkt, ts::PID pid, uint8_t cc, uint64_t pcr);
+};
+
+TSUNIT_REGISTER(PCRAnalyzerTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void PCRAnalyzerTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void PCRAnalyzerTest::afterTest()
+{
+}
+
+// Build a packet with a PCR.
+void PCRAnalyzerTest::BuildPacket(ts::TSPacket& pkt, ts::PID pid, uint8_t cc, uint64_t pcr)
+{
+    pkt.init(pid, cc & ts::CC_MASK);
+    if (pcr != ts::INVALID_PCR) {
+        pkt.setPCR(pcr % ts::PCR_SCALE, true);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void PCRAnalyzerTest::testBitrate()
+{
+    // One PCR every 10 packets, 1 ms between PCR's: 10 packets per ms, 15,040,000 b/s.
+    ts::PCRAnalyzer zer;
+    ts::TSPacket pkt;
+    uint64_t pcr = 0;
+    uint8_t cc_pcr = 0;
+    uint8_t cc_data = 0;
+    for (size_t i = 0; i < 10000; ++i) {
+        if (i % 10 == 0) {
+            BuildPacket(pkt, 100, cc_pcr++, pcr);
+            pcr += ts::SYSTEM_CLOCK_FREQ / 1000;
+        }
+        else {
+            BuildPacket(pkt, 200, cc_data++, ts::INVALID_PCR);
+        }
+        zer.feedPacket(pkt);
+    }
+    TSUNIT_ASSERT(zer.bitrateIsValid());
+    TSUNIT_EQUAL(15040000, zer.bitrate188().toInt());
+    TSUNIT_EQUAL(15040000, zer.instantaneousBitrate188().toInt());
+    TSUNIT_EQUAL(16320000, zer.instantaneousBitrate204().toInt());
+
+    // One second of PCR's, one PCR per millisecond.
+    TSUNIT_ASSERT(zer.instantaneousPCRCount() >= 1000);
+    TSUNIT_ASSERT(zer.instantaneousPCRCount() <= ts::PCRAnalyzer::DEFAULT_WINDOW_CAPACITY);
+}
+
+void PCRAnalyzerTest::testLongStream()
+{
+    // Synthetic stream of three days, one PCR packet every 100 ms, 15,040 b/s.
+    // The PCR wraps up every 26.5 hours. The sliding window must stay constant.
+    constexpr uint64_t PCR_INTERVAL = ts::SYSTEM_CLOCK_FREQ / 10;
+    constexpr size_t PACKET_COUNT = 3 * 24 * 3600 * 10;
+
+    ts::PCRAnalyzer zer;
+    zer.setInstantaneousWindow(2000);
+    ts::TSPacket pkt;
+    uint64_t pcr = ts::PCR_SCALE - 3600 * ts::SYSTEM_CLOCK_FREQ; // first wrap-up after one hour
+    size_t max_count = 0;
+    size_t bad_bitrate = 0;
+
+    for (size_t i = 0; i < PACKET_COUNT; ++i) {
+        BuildPacket(pkt, 100, uint8_t(i), pcr);
+        pcr += PCR_INTERVAL;
+        zer.feedPacket(pkt);
+        max_count = std::max(max_count, zer.instantaneousPCRCount());
+        if (i > 100 && zer.instantaneousBitrate188().toInt() != 15040) {
+            bad_bitrate++;
+        }
+    }
+
+    debug() << "PCRAnalyzerTest::testLongStream: max PCR count: " << max_count << ", bad bitrates: " << bad_bitrate << std::endl;
+    TSUNIT_ASSERT(max_count <= 21);
+    TSUNIT_EQUAL(0, bad_bitrate);
+    TSUNIT_EQUAL(15040, zer.bitrate188().toInt());
+}
+
+void PCRAnalyzerTest::testWindowCapacity()
+{
+    // 1000 PCR's per second but a window limited to 50 PCR's.
+    ts::PCRAnalyzer zer;
+    zer.setInstantaneousWindow(10000, 50);
+    ts::TSPacket pkt;
+    uint64_t pcr = 0;
+    size_t max_count = 0;
+    for (size_t i = 0; i < 100000; ++i) {
+        BuildPacket(pkt, 100, uint8_t(i), pcr);
+        pcr += ts::SYSTEM_CLOCK_FREQ / 1000;
+        zer.feedPacket(pkt);
+        max_count = std::max(max_count, zer.instantaneousPCRCount());
+    }
+    TSUNIT_EQUAL(50, max_count);
+    TSUNIT_EQUAL(1504000, zer.instantaneousBitrate188().toInt());
+}
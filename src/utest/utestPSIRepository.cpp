@@ -35,7 +35,10 @@
 #include "tsAbstractTable.h"
 #include "tsMGT.h"
 #include "tsLDT.h"
+#include "tsServiceDescriptor.h"
+#include "tsApplicationDescriptor.h"
 #include "tsunit.h"
+#include "utestTSUnitBenchmark.h"
 
 
 //----------------------------------------------------------------------------
@@ -50,10 +53,12 @@ public:
 
     void testRegistrations();
     void testSharedTID();
+    void testDescriptorLookup();
 
     TSUNIT_TEST_BEGIN(PSIRepositoryTest);
     TSUNIT_TEST(testRegistrations);
     TSUNIT_TEST(testSharedTID);
+    TSUNIT_TEST(testDescriptorLookup);
     TSUNIT_TEST_END();
 };
 
@@ -139,3 +144,48 @@ void PSIRepositoryTest::testSharedTID()
     TSUNIT_ASSERT(ts::MGT::DisplaySection == ts::PSIRepository::Instance()->getSectionDisplay(ts::TID_LDT, ts::Standards::NONE, ts::PID_PSIP));
     TSUNIT_ASSERT(ts::LDT::DisplaySection == ts::PSIRepository::Instance()->getSectionDisplay(ts::TID_LDT, ts::Standards::NONE, ts::PID_LDT));
 }
+
+void PSIRepositoryTest::testDescriptorLookup()
+{
+    const ts::PSIRepository* const repo = ts::PSIRepository::Instance();
+
+    // Standard descriptor, with or without table context.
+    TSUNIT_ASSERT(ts::ServiceDescriptor::DisplayDescriptor == repo->getDescriptorDisplay(ts::EDID::Standard(ts::DID_SERVICE)));
+    TSUNIT_ASSERT(ts::ServiceDescriptor::DisplayDescriptor == repo->getDescriptorDisplay(ts::EDID::Standard(ts::DID_SERVICE), ts::TID_SDT_ACT));
+    TSUNIT_ASSERT(repo->getDescriptorFactory(ts::EDID::Standard(ts::DID_SERVICE)) != nullptr);
+
+    // Table-specific descriptor: same tag, different meaning in an AIT.
+    TSUNIT_ASSERT(!repo->isTableSpecificDescriptor(ts::DID_AIT_APPLICATION, ts::TID_PMT));
+    TSUNIT_ASSERT(repo->isTableSpecificDescriptor(ts::DID_AIT_APPLICATION, ts::TID_AIT));
+    TSUNIT_ASSERT(!repo->isTableSpecificDescriptor(ts::DID_AIT_APPLICATION, ts::TID_NULL));
+    TSUNIT_ASSERT(!repo->isTableSpecificDescriptor(ts::DID_SERVICE, ts::TID_AIT));
+    TSUNIT_ASSERT(ts::ApplicationDescriptor::DisplayDescriptor == repo->getDescriptorDisplay(ts::EDID::Standard(ts::DID_AIT_APPLICATION), ts::TID_AIT));
+    TSUNIT_ASSERT(ts::ApplicationDescriptor::DisplayDescriptor == repo->getDescriptorDisplay(ts::EDID::TableSpecific(ts::DID_AIT_APPLICATION, ts::TID_AIT)));
+    TSUNIT_ASSERT(ts::ApplicationDescriptor::DisplayDescriptor != repo->getDescriptorDisplay(ts::EDID::Standard(ts::DID_AIT_APPLICATION), ts::TID_PMT));
+
+    // Registered table ids are returned in increasing order, once each.
+    std::vector<ts::TID> tids;
+    repo->getRegisteredTableIds(tids);
+    TSUNIT_ASSERT(!tids.empty());
+    for (size_t i = 1; i < tids.size(); ++i) {
+        TSUNIT_ASSERT(tids[i-1] < tids[i]);
+    }
+
+    // Support for benchmarking: lookup all standard descriptor tags in all registered tables.
+    utest::TSUnitBenchmark bench(u"TSUNIT_PSIREPO_ITERATIONS");
+    size_t found = 0;
+    bench.start();
+    for (size_t iter = 0; iter < bench.iterations; ++iter) {
+        found = 0;
+        for (auto tid : tids) {
+            for (size_t did = 0; did < 0x80; ++did) {
+                if (repo->getDescriptorDisplay(ts::EDID::Standard(ts::DID(did)), tid) != nullptr) {
+                    found++;
+                }
+            }
+        }
+    }
+    bench.stop();
+    bench.report(u"PSIRepositoryTest::testDescriptorLookup");
+    TSUNIT_ASSERT(found > 0);
+}
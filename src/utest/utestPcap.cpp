@@ -0,0 +1,408 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for pcap files and IP datagrams views.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPcapFile.h"
+#include "tsPcapFlowIndex.h"
+#include "tsIPPacketView.h"
+#include "tsIPv4Packet.h"
+#include "tsIPProtocols.h"
+#include "tsByteBlock.h"
+#include "tsFileUtils.h"
+#include "tsNullReport.h"
+#include "tsCerrReport.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PcapTest: public tsunit::Test
+{
+public:
+    PcapTest();
+
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testIPv4View();
+    void testIPv6View();
+    void testFragments();
+    void testReadFile();
+    void testFlowIndex();
+
+    TSUNIT_TEST_BEGIN(PcapTest);
+    TSUNIT_TEST(testIPv4View);
+    TSUNIT_TEST(testIPv6View);
+    TSUNIT_TEST(testFragments);
+    TSUNIT_TEST(testReadFile);
+    TSUNIT_TEST(testFlowIndex);
+    TSUNIT_TEST_END();
+
+private:
+    ts::UString _tempFileName;
+
+    // Build IP datagrams and pcap files.
+    static ts::ByteBlock BuildIPv4UDP(size_t payload_size);
+    static ts::ByteBlock BuildIPv6UDP(size_t payload_size);
+    static void AddRecord(ts::ByteBlock& file, uint32_t seconds, uint32_t micro_seconds, const ts::ByteBlock& frame);
+    bool buildFile();
+};
+
+TSUNIT_REGISTER(PcapTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+PcapTest::PcapTest() :
+    _tempFileName()
+{
+}
+
+// Test suite initialization method.
+void PcapTest::beforeTest()
+{
+    if (_tempFileName.empty()) {
+        _tempFileName = ts::TempFile(u".pcap");
+    }
+    ts::DeleteFile(_tempFileName, NULLREP);
+}
+
+// Test suite cleanup method.
+void PcapTest::afterTest()
+{
+    ts::DeleteFile(_tempFileName, NULLREP);
+}
+
+
+//----------------------------------------------------------------------------
+// Build test data.
+//----------------------------------------------------------------------------
+
+// IPv4 UDP datagram from 10.0.0.1:1000 to 224.1.1.1:2000.
+ts::ByteBlock PcapTest::BuildIPv4UDP(size_t payload_size)
+{
+    ts::ByteBlock ip(ts::IPv4_MIN_HEADER_SIZE + ts::UDP_HEADER_SIZE + payload_size, 0x47);
+    ip[0] = 0x45;
+    ip[1] = 0x00;
+    ts::PutUInt16(&ip[2], uint16_t(ip.size()));
+    ts::PutUInt32(&ip[4], 0);
+    ip[8] = 64;
+    ip[9] = ts::IPv4_PROTO_UDP;
+    ts::PutUInt32(&ip[12], 0x0A000001);
+    ts::PutUInt32(&ip[16], 0xE0010101);
+    ts::IPv4Packet::UpdateIPHeaderChecksum(ip.data(), ip.size());
+    ts::PutUInt16(&ip[20], 1000);
+    ts::PutUInt16(&ip[22], 2000);
+    ts::PutUInt16(&ip[24], uint16_t(ts::UDP_HEADER_SIZE + payload_size));
+    ts::PutUInt16(&ip[26], 0);
+    return ip;
+}
+
+// IPv6 UDP datagram from [2001:db8::1]:3000 to [ff05::1]:4000, with a destination options extension header.
+ts::ByteBlock PcapTest::BuildIPv6UDP(size_t payload_size)
+{
+    constexpr size_t ext_size = 8;
+    ts::ByteBlock ip(ts::IPv6_HEADER_SIZE + ext_size + ts::UDP_HEADER_SIZE + payload_size, 0x47);
+    ts::PutUInt32(&ip[0], 0x60000000);
+    ts::PutUInt16(&ip[4], uint16_t(ext_size + ts::UDP_HEADER_SIZE + payload_size));
+    ip[6] = ts::IPv6_EXT_DESTINATION;
+    ip[7] = 64;
+    ::memset(&ip[8], 0, 32);
+    ts::PutUInt16(&ip[8], 0x2001);
+    ts::PutUInt16(&ip[10], 0x0DB8);
+    ip[23] = 0x01;
+    ts::PutUInt16(&ip[24], 0xFF05);
+    ip[39] = 0x01;
+    ip[40] = ts::IPv4_PROTO_UDP;
+    ip[41] = 0;
+    ::memset(&ip[42], 0, 6);
+    ts::PutUInt16(&ip[48], 3000);
+    ts::PutUInt16(&ip[50], 4000);
+    ts::PutUInt16(&ip[52], uint16_t(ts::UDP_HEADER_SIZE + payload_size));
+    ts::PutUInt16(&ip[54], 0);
+    return ip;
+}
+
+// Add a pcap record (little endian) in a pcap file image.
+void PcapTest::AddRecord(ts::ByteBlock& file, uint32_t seconds, uint32_t micro_seconds, const ts::ByteBlock& frame)
+{
+    file.appendUInt32LE(seconds);
+    file.appendUInt32LE(micro_seconds);
+    file.appendUInt32LE(uint32_t(frame.size()));
+    file.appendUInt32LE(uint32_t(frame.size()));
+    file.append(frame);
+}
+
+// Build a pcap file with Ethernet frames.
+bool PcapTest::buildFile()
+{
+    static const uint8_t macs[] = {0x01, 0x00, 0x5E, 0x01, 0x01, 0x01, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55};
+
+    ts::ByteBlock file;
+    file.appendUInt32LE(ts::PCAP_MAGIC_BE);
+    file.appendUInt16LE(2);
+    file.appendUInt16LE(4);
+    file.appendUInt32LE(0);
+    file.appendUInt32LE(0);
+    file.appendUInt32LE(65535);
+    file.appendUInt32LE(ts::LINKTYPE_ETHERNET);
+
+    // #1: IPv4 UDP in a QinQ frame (802.1ad outer tag, 802.1Q inner tag).
+    ts::ByteBlock frame(macs, sizeof(macs));
+    frame.appendUInt16(ts::ETHERTYPE_802_1AD);
+    frame.appendUInt16(100);
+    frame.appendUInt16(ts::ETHERTYPE_802_1Q);
+    frame.appendUInt16(200);
+    frame.appendUInt16(ts::ETHERTYPE_IPv4);
+    frame.append(BuildIPv4UDP(188));
+    AddRecord(file, 1000, 0, frame);
+
+    // #2: IPv6 UDP, with an Ethernet trailer which must be ignored.
+    frame.copy(macs, sizeof(macs));
+    frame.appendUInt16(ts::ETHERTYPE_IPv6);
+    frame.append(BuildIPv6UDP(376));
+    frame.appendUInt32(0xDEADBEEF);
+    AddRecord(file, 1000, 500000, frame);
+
+    // #3: IPv4 UDP in a plain Ethernet frame.
+    frame.copy(macs, sizeof(macs));
+    frame.appendUInt16(ts::ETHERTYPE_IPv4);
+    frame.append(BuildIPv4UDP(188));
+    AddRecord(file, 1001, 0, frame);
+
+    return file.saveToFile(_tempFileName, &CERR);
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void PcapTest::testIPv4View()
+{
+    ts::ByteBlock ip(BuildIPv4UDP(188));
+    ts::IPPacketView view(ip.data(), ip.size());
+    TSUNIT_ASSERT(view.isValid());
+    TSUNIT_ASSERT(view.isIPv4());
+    TSUNIT_ASSERT(!view.isIPv6());
+    TSUNIT_ASSERT(view.isUDP());
+    TSUNIT_ASSERT(!view.isTCP());
+    TSUNIT_EQUAL(4, view.version());
+    TSUNIT_EQUAL(20, view.headerSize());
+    TSUNIT_EQUAL(8, view.protocolHeaderSize());
+    TSUNIT_EQUAL(188, view.protocolDataSize());
+    TSUNIT_EQUAL(ip.data() + 28, view.protocolData());
+    TSUNIT_EQUAL(4, view.addressSize());
+    TSUNIT_EQUAL(1000, view.sourcePort());
+    TSUNIT_EQUAL(2000, view.destinationPort());
+    TSUNIT_EQUAL(u"10.0.0.1:1000", view.sourceString());
+    TSUNIT_EQUAL(u"224.1.1.1:2000", view.destinationString());
+    TSUNIT_ASSERT(view.destinationIPv4SocketAddress().isMulticast());
+
+    // Corrupted header checksum.
+    ip[8]++;
+    TSUNIT_ASSERT(!view.reset(ip.data(), ip.size()));
+    TSUNIT_ASSERT(!view.isValid());
+    ip[8]--;
+
+    // Extra data after the datagram are ignored, truncated datagrams are rejected.
+    ip.appendUInt32(0);
+    TSUNIT_ASSERT(view.reset(ip.data(), ip.size()));
+    TSUNIT_EQUAL(216, view.size());
+    TSUNIT_ASSERT(!view.reset(ip.data(), 100));
+}
+
+void PcapTest::testIPv6View()
+{
+    const ts::ByteBlock ip(BuildIPv6UDP(376));
+    ts::IPPacketView view(ip.data(), ip.size());
+    TSUNIT_ASSERT(view.isValid());
+    TSUNIT_ASSERT(!view.isIPv4());
+    TSUNIT_ASSERT(view.isIPv6());
+    TSUNIT_ASSERT(view.isUDP());
+    TSUNIT_EQUAL(6, view.version());
+    TSUNIT_EQUAL(48, view.headerSize());
+    TSUNIT_EQUAL(8, view.protocolHeaderSize());
+    TSUNIT_EQUAL(376, view.protocolDataSize());
+    TSUNIT_EQUAL(16, view.addressSize());
+    TSUNIT_EQUAL(3000, view.sourcePort());
+    TSUNIT_EQUAL(4000, view.destinationPort());
+    TSUNIT_ASSERT(view.sourceIPv6SocketAddress() == ts::IPv6SocketAddress(ts::IPv6Address(0x2001, 0x0DB8, 0, 0, 0, 0, 0, 1), 3000));
+    TSUNIT_ASSERT(view.destinationIPv6SocketAddress() == ts::IPv6SocketAddress(ts::IPv6Address(0xFF05, 0, 0, 0, 0, 0, 0, 1), 4000));
+    TSUNIT_ASSERT(!view.reset(ip.data(), 39));
+}
+
+void PcapTest::testFragments()
+{
+    ts::IPPacketView view;
+
+    // IPv4 first fragment, "More Fragments" bit set.
+    ts::ByteBlock ip4(BuildIPv4UDP(188));
+    TSUNIT_ASSERT(view.reset(ip4.data(), ip4.size()));
+    TSUNIT_ASSERT(!view.fragmented());
+    ts::PutUInt16(&ip4[6], 0x2000);
+    ts::IPv4Packet::UpdateIPHeaderChecksum(ip4.data(), ip4.size());
+    TSUNIT_ASSERT(view.reset(ip4.data(), ip4.size()));
+    TSUNIT_ASSERT(view.isIPv4());
+    TSUNIT_ASSERT(view.fragmented());
+    TSUNIT_EQUAL(ts::IPv4_PROTO_UDP, view.protocol());
+    TSUNIT_ASSERT(!view.isUDP());
+    TSUNIT_EQUAL(0, view.protocolHeaderSize());
+    TSUNIT_EQUAL(0, view.sourcePort());
+    TSUNIT_EQUAL(0, view.destinationPort());
+    TSUNIT_ASSERT(view.protocolData() == nullptr);
+    TSUNIT_EQUAL(0, view.protocolDataSize());
+
+    // IPv4 last fragment, non-zero fragment offset, the UDP header is garbage.
+    ts::PutUInt16(&ip4[6], 0x00B9);
+    ts::PutUInt16(&ip4[24], 0xFFFF);
+    ts::IPv4Packet::UpdateIPHeaderChecksum(ip4.data(), ip4.size());
+    TSUNIT_ASSERT(view.reset(ip4.data(), ip4.size()));
+    TSUNIT_ASSERT(view.fragmented());
+    TSUNIT_ASSERT(!view.isUDP());
+    TSUNIT_ASSERT(view.protocolData() == nullptr);
+
+    // "Don't Fragment" bit is not a fragment.
+    ts::PutUInt16(&ip4[6], 0x4000);
+    ts::PutUInt16(&ip4[24], uint16_t(ts::UDP_HEADER_SIZE + 188));
+    ts::IPv4Packet::UpdateIPHeaderChecksum(ip4.data(), ip4.size());
+    TSUNIT_ASSERT(view.reset(ip4.data(), ip4.size()));
+    TSUNIT_ASSERT(!view.fragmented());
+    TSUNIT_ASSERT(view.isUDP());
+
+    // IPv6 fragment: replace the destination options header with a fragment header.
+    for (uint16_t offset : {0x0001, 0x00B8}) {
+        ts::ByteBlock ip6(BuildIPv6UDP(376));
+        ip6[6] = ts::IPv6_EXT_FRAGMENT;
+        ip6[40] = ts::IPv4_PROTO_UDP;
+        ip6[41] = 0;
+        ts::PutUInt16(&ip6[42], offset); // first fragment (M=1) or non-first fragment (M=0)
+        ts::PutUInt32(&ip6[44], 0x12345678);
+        TSUNIT_ASSERT(view.reset(ip6.data(), ip6.size()));
+        TSUNIT_ASSERT(view.isIPv6());
+        TSUNIT_ASSERT(view.fragmented());
+        TSUNIT_EQUAL(48, view.headerSize());
+        TSUNIT_EQUAL(ts::IPv4_PROTO_UDP, view.protocol());
+        TSUNIT_ASSERT(!view.isUDP());
+        TSUNIT_EQUAL(0, view.destinationPort());
+        TSUNIT_ASSERT(view.protocolData() == nullptr);
+        TSUNIT_EQUAL(0, view.protocolDataSize());
+    }
+}
+
+void PcapTest::testReadFile()
+{
+    TSUNIT_ASSERT(buildFile());
+
+    ts::PcapFile file;
+    TSUNIT_ASSERT(file.open(_tempFileName, CERR));
+    TSUNIT_ASSERT(file.isOpen());
+    TSUNIT_ASSERT(file.isMemoryMapped());
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    ts::MicroSecond timestamp = -1;
+    ts::IPPacketView ip;
+
+    TSUNIT_ASSERT(file.readIP(data, size, timestamp, CERR));
+    TSUNIT_ASSERT(ip.reset(data, size));
+    TSUNIT_ASSERT(ip.isIPv4());
+    TSUNIT_EQUAL(216, size);
+    TSUNIT_EQUAL(1000 * ts::MicroSecPerSec, timestamp);
+    TSUNIT_EQUAL(u"224.1.1.1:2000", ip.destinationString());
+
+    TSUNIT_ASSERT(file.readIP(data, size, timestamp, CERR));
+    TSUNIT_ASSERT(ip.reset(data, size));
+    TSUNIT_ASSERT(ip.isIPv6());
+    TSUNIT_EQUAL(432, size);
+    TSUNIT_EQUAL(1000 * ts::MicroSecPerSec + 500000, timestamp);
+    TSUNIT_EQUAL(376, ip.protocolDataSize());
+
+    // The legacy IPv4 interface skips IPv6 datagrams.
+    ts::IPv4Packet ip4;
+    TSUNIT_ASSERT(file.readIPv4(ip4, timestamp, CERR));
+    TSUNIT_ASSERT(ip4.isUDP());
+    TSUNIT_EQUAL(188, ip4.protocolDataSize());
+    TSUNIT_EQUAL(1001 * ts::MicroSecPerSec, timestamp);
+
+    TSUNIT_ASSERT(!file.readIP(data, size, timestamp, NULLREP));
+    TSUNIT_ASSERT(file.endOfFile());
+    TSUNIT_EQUAL(3, file.packetCount());
+    TSUNIT_EQUAL(2, file.ipv4PacketCount());
+    TSUNIT_EQUAL(1, file.ipv6PacketCount());
+    TSUNIT_EQUAL(432, file.totalIPv6PacketsSize());
+    file.close();
+    TSUNIT_ASSERT(!file.isOpen());
+}
+
+void PcapTest::testFlowIndex()
+{
+    TSUNIT_ASSERT(buildFile());
+
+    ts::PcapFile file;
+    TSUNIT_ASSERT(file.open(_tempFileName, CERR));
+
+    ts::PcapFlowIndex index;
+    TSUNIT_ASSERT(index.build(file, CERR));
+    TSUNIT_EQUAL(2, index.flows().size());
+
+    for (const auto& it : index.flows()) {
+        const ts::PcapFlowIndex::FlowId& id(it.first);
+        const ts::PcapFlowIndex::FlowStats& stats(it.second);
+        TSUNIT_EQUAL(ts::IPv4_PROTO_UDP, id.protocol);
+        if (id.version == 4) {
+            TSUNIT_EQUAL(u"10.0.0.1:1000", id.sourceString());
+            TSUNIT_EQUAL(u"224.1.1.1:2000", id.destinationString());
+            TSUNIT_EQUAL(2, stats.packet_count);
+            TSUNIT_EQUAL(1, stats.first_packet);
+            TSUNIT_EQUAL(3, stats.last_packet);
+            TSUNIT_EQUAL(2 * 216, stats.total_ip_size);
+            TSUNIT_EQUAL(2 * 188, stats.total_data_size);
+            TSUNIT_EQUAL(1000 * ts::MicroSecPerSec, stats.first_timestamp);
+            TSUNIT_EQUAL(1001 * ts::MicroSecPerSec, stats.last_timestamp);
+        }
+        else {
+            TSUNIT_EQUAL(6, id.version);
+            TSUNIT_EQUAL(3000, id.source_port);
+            TSUNIT_EQUAL(4000, id.destination_port);
+            TSUNIT_EQUAL(1, stats.packet_count);
+            TSUNIT_EQUAL(2, stats.first_packet);
+            TSUNIT_EQUAL(2, stats.last_packet);
+            TSUNIT_EQUAL(376, stats.total_data_size);
+        }
+    }
+}
@@ -0,0 +1,690 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for RTP packets, reordering, SMPTE 2022-1 FEC and SMPTE 2022-7 merge.
+//
+//----------------------------------------------------------------------------
+
+#include "tsRTPPacketView.h"
+#include "tsRTPJitterBuffer.h"
+#include "tsRTPFECDecoder.h"
+#include "tsRTPHitlessMerger.h"
+#include "tsIPProtocols.h"
+#include "tsTSPacket.h"
+#include "tsByteBlock.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class RTPTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testPacketView();
+    void testReorder();
+    void testLoss();
+    void testWrap();
+    void testFECColumn();
+    void testFECRow();
+    void testFECIterative();
+    void testFECUnrecoverable();
+    void testFECJitter();
+    void testMerge();
+    void testMergeLegDown();
+    void testMergeLate();
+    void testMergeRestart();
+    void testMergeRestartDelay();
+
+    TSUNIT_TEST_BEGIN(RTPTest);
+    TSUNIT_TEST(testPacketView);
+    TSUNIT_TEST(testReorder);
+    TSUNIT_TEST(testLoss);
+    TSUNIT_TEST(testWrap);
+    TSUNIT_TEST(testFECColumn);
+    TSUNIT_TEST(testFECRow);
+    TSUNIT_TEST(testFECIterative);
+    TSUNIT_TEST(testFECUnrecoverable);
+    TSUNIT_TEST(testFECJitter);
+    TSUNIT_TEST(testMerge);
+    TSUNIT_TEST(testMergeLegDown);
+    TSUNIT_TEST(testMergeLate);
+    TSUNIT_TEST(testMergeRestart);
+    TSUNIT_TEST(testMergeRestartDelay);
+    TSUNIT_TEST_END();
+
+private:
+    // FEC matrix used in tests: L columns, D rows.
+    static constexpr size_t L = 4;
+    static constexpr size_t D = 3;
+
+    // Build a media RTP packet with a variable payload.
+    static ts::ByteBlockPtr MakeMedia(uint16_t seq, size_t payload_size = 7 * ts::PKT_SIZE);
+
+    // Build a SMPTE 2022-1 FEC packet protecting count packets, starting at first, every offset packets.
+    static ts::ByteBlockPtr MakeFEC(const std::vector<ts::ByteBlockPtr>& media, size_t first, size_t offset, size_t count, bool row);
+
+    // Build a complete matrix of media packets and all column and row FEC packets.
+    static void MakeMatrix(uint16_t first_seq, std::vector<ts::ByteBlockPtr>& media, std::vector<ts::ByteBlockPtr>& columns, std::vector<ts::ByteBlockPtr>& rows);
+
+    // Feed a FEC decoder with a matrix, except the dropped media packets, and return the recovered packets.
+    static size_t Decode(ts::RTPFECDecoder& dec, const std::vector<ts::ByteBlockPtr>& media, const std::set<size_t>& dropped,
+                         const std::vector<ts::ByteBlockPtr>& columns, const std::vector<ts::ByteBlockPtr>& rows, std::vector<ts::ByteBlockPtr>& recovered);
+
+    // Sequence number of an RTP packet.
+    static uint16_t Seq(const ts::ByteBlockPtr& packet) { return ts::GetUInt16(packet->data() + 2); }
+};
+
+TSUNIT_REGISTER(RTPTest);
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t RTPTest::L;
+constexpr size_t RTPTest::D;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void RTPTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void RTPTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Build packets.
+//----------------------------------------------------------------------------
+
+ts::ByteBlockPtr RTPTest::MakeMedia(uint16_t seq, size_t payload_size)
+{
+    ts::ByteBlockPtr pkt(new ts::ByteBlock(ts::RTP_HEADER_SIZE + payload_size));
+    uint8_t* data = pkt->data();
+    data[0] = 0x80;
+    data[1] = ts::RTP_PT_MP2T | (seq % 5 == 0 ? 0x80 : 0x00);
+    ts::PutUInt16(data + 2, seq);
+    ts::PutUInt32(data + 4, 1000 * uint32_t(seq) + 12345);
+    ts::PutUInt32(data + 8, 0x01020304);
+    for (size_t i = 0; i < payload_size; ++i) {
+        data[ts::RTP_HEADER_SIZE + i] = uint8_t(seq + 7 * i);
+    }
+    return pkt;
+}
+
+ts::ByteBlockPtr RTPTest::MakeFEC(const std::vector<ts::ByteBlockPtr>& media, size_t first, size_t offset, size_t count, bool row)
+{
+    // The FEC payload is as long as the longest protected packet.
+    size_t size = 0;
+    for (size_t i = 0; i < count; ++i) {
+        size = std::max(size, media[first + i * offset]->size() - ts::RTP_HEADER_SIZE);
+    }
+
+    ts::ByteBlockPtr pkt(new ts::ByteBlock(ts::RTP_HEADER_SIZE + ts::RTP_FEC_HEADER_SIZE + size, 0));
+    uint8_t* data = pkt->data();
+    uint8_t* fh = data + ts::RTP_HEADER_SIZE;
+    uint8_t* payload = fh + ts::RTP_FEC_HEADER_SIZE;
+    uint8_t bits0 = 0;
+    uint8_t bits1 = 0;
+    uint16_t length = 0;
+    uint32_t timestamp = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const ts::ByteBlock& m(*media[first + i * offset]);
+        bits0 ^= m[0];
+        bits1 ^= m[1];
+        length ^= uint16_t(m.size() - ts::RTP_HEADER_SIZE);
+        timestamp ^= ts::GetUInt32(m.data() + 4);
+        for (size_t n = ts::RTP_HEADER_SIZE; n < m.size(); ++n) {
+            payload[n - ts::RTP_HEADER_SIZE] ^= m[n];
+        }
+    }
+
+    data[0] = 0x80 | (bits0 & 0x3F);
+    data[1] = (bits1 & 0x80) | 96;
+    ts::PutUInt16(data + 2, uint16_t(first));
+    ts::PutUInt16(fh, Seq(media[first]));
+    ts::PutUInt16(fh + 2, length);
+    fh[4] = 0x80 | (bits1 & 0x7F);
+    ts::PutUInt32(fh + 8, timestamp);
+    fh[12] = row ? 0x40 : 0x00;
+    fh[13] = uint8_t(offset);
+    fh[14] = uint8_t(count);
+    return pkt;
+}
+
+void RTPTest::MakeMatrix(uint16_t first_seq, std::vector<ts::ByteBlockPtr>& media, std::vector<ts::ByteBlockPtr>& columns, std::vector<ts::ByteBlockPtr>& rows)
+{
+    media.clear();
+    columns.clear();
+    rows.clear();
+    for (size_t i = 0; i < L * D; ++i) {
+        // Use variable payload sizes to test the length recovery.
+        media.push_back(MakeMedia(uint16_t(first_seq + i), (i % 3 == 1 ? 3 : 7) * ts::PKT_SIZE + (i % 2)));
+    }
+    for (size_t c = 0; c < L; ++c) {
+        columns.push_back(MakeFEC(media, c, L, D, false));
+    }
+    for (size_t r = 0; r < D; ++r) {
+        rows.push_back(MakeFEC(media, r * L, 1, L, true));
+    }
+}
+
+size_t RTPTest::Decode(ts::RTPFECDecoder& dec, const std::vector<ts::ByteBlockPtr>& media, const std::set<size_t>& dropped,
+                       const std::vector<ts::ByteBlockPtr>& columns, const std::vector<ts::ByteBlockPtr>& rows, std::vector<ts::ByteBlockPtr>& recovered)
+{
+    // Send a packet before the matrix: losses before the first received packet cannot be detected.
+    dec.addMedia(MakeMedia(uint16_t(Seq(media.front()) - 1)));
+    for (size_t i = 0; i < media.size(); ++i) {
+        if (dropped.count(i) == 0) {
+            TSUNIT_ASSERT(dec.addMedia(media[i]));
+        }
+    }
+    // Send a packet after the matrix so that the last packets are known to be missing.
+    dec.addMedia(MakeMedia(uint16_t(Seq(media.back()) + 1)));
+    for (const auto& fec : rows) {
+        TSUNIT_ASSERT(dec.addFEC(fec));
+    }
+    for (const auto& fec : columns) {
+        TSUNIT_ASSERT(dec.addFEC(fec));
+    }
+    return dec.recover(recovered);
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void RTPTest::testPacketView()
+{
+    // Header with one CSRC, one extension of one 32-bit word and 3 bytes of padding.
+    ts::ByteBlock pkt({
+        0xB1, 0xA1, 0x12, 0x34, 0x00, 0x01, 0x02, 0x03, 0xAA, 0xBB, 0xCC, 0xDD, // fixed header, P=1, X=1, CC=1, M=1, PT=33
+        0x11, 0x22, 0x33, 0x44,                                                 // CSRC
+        0xBE, 0xDE, 0x00, 0x01, 0x55, 0x66, 0x77, 0x88,                         // extension
+        0x47, 0x01, 0x02,                                                       // payload
+        0x00, 0x00, 0x03,                                                       // padding
+    });
+
+    ts::RTPPacketView rtp(pkt.data(), pkt.size());
+    TSUNIT_ASSERT(rtp.isValid());
+    TSUNIT_ASSERT(rtp.marker());
+    TSUNIT_EQUAL(ts::RTP_PT_MP2T, rtp.payloadType());
+    TSUNIT_EQUAL(0x1234, rtp.sequenceNumber());
+    TSUNIT_EQUAL(0x00010203, rtp.timestamp());
+    TSUNIT_EQUAL(0xAABBCCDD, rtp.ssrc());
+    TSUNIT_EQUAL(24, rtp.headerSize());
+    TSUNIT_EQUAL(3, rtp.payloadSize());
+    TSUNIT_EQUAL(0x47, rtp.payload()[0]);
+
+    // Invalid version, invalid padding, truncated extension.
+    pkt[0] = 0x40;
+    TSUNIT_ASSERT(!rtp.reset(pkt.data(), pkt.size()));
+    TSUNIT_ASSERT(!rtp.isValid());
+    pkt[0] = 0xB1;
+    pkt[pkt.size() - 1] = 10;
+    TSUNIT_ASSERT(!rtp.reset(pkt.data(), pkt.size()));
+    TSUNIT_ASSERT(!rtp.reset(pkt.data(), 18));
+
+    // Raw TS packets are not RTP packets.
+    static const uint8_t ts_pkt[] = {0x47, 0x1F, 0xFF, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    TSUNIT_ASSERT(!rtp.reset(ts_pkt, sizeof(ts_pkt)));
+}
+
+void RTPTest::testReorder()
+{
+    ts::RTPJitterBuffer jb(10);
+    TSUNIT_EQUAL(10, jb.latency());
+
+    // Packets arrive in disorder, one millisecond apart, with one duplicate.
+    static const uint16_t order[] = {100, 102, 101, 103, 106, 104, 105, 105, 107};
+    ts::MicroSecond now = 0;
+    for (auto seq : order) {
+        jb.add(MakeMedia(seq), now, now + 1);
+        now += 1000;
+    }
+    TSUNIT_EQUAL(9, jb.receivedCount());
+    TSUNIT_EQUAL(1, jb.duplicateCount());
+    TSUNIT_EQUAL(3, jb.reorderedCount());
+    TSUNIT_EQUAL(8, jb.size());
+
+    // Nothing before the initial latency.
+    ts::ByteBlockPtr pkt;
+    ts::MicroSecond tstamp = 0;
+    TSUNIT_EQUAL(10000, jb.nextDeadline());
+    TSUNIT_ASSERT(!jb.get(pkt, tstamp, 9999));
+
+    // Then all packets in order.
+    for (uint16_t seq = 100; seq <= 107; ++seq) {
+        TSUNIT_ASSERT(jb.get(pkt, tstamp, 10000));
+        TSUNIT_EQUAL(seq, Seq(pkt));
+    }
+    TSUNIT_ASSERT(!jb.get(pkt, tstamp, 10000));
+    TSUNIT_EQUAL(-1, jb.nextDeadline());
+    TSUNIT_EQUAL(0, jb.lostCount());
+
+    // Invalid RTP packets are rejected.
+    TSUNIT_ASSERT(!jb.add(ts::ByteBlockPtr(new ts::ByteBlock(20, 0x47)), now));
+    TSUNIT_EQUAL(9, jb.receivedCount());
+}
+
+void RTPTest::testLoss()
+{
+    ts::RTPJitterBuffer jb(20);
+    ts::ByteBlockPtr pkt;
+    ts::MicroSecond tstamp = 0;
+
+    // Packet 5 is missing.
+    for (uint16_t seq = 0; seq < 10; ++seq) {
+        if (seq != 5) {
+            TSUNIT_ASSERT(jb.add(MakeMedia(seq), 1000 * seq, 1000 * seq));
+        }
+    }
+    for (uint16_t seq = 0; seq < 5; ++seq) {
+        TSUNIT_ASSERT(jb.get(pkt, tstamp, 20000));
+        TSUNIT_EQUAL(seq, Seq(pkt));
+        TSUNIT_EQUAL(1000 * seq, tstamp);
+    }
+
+    // Packet 6 is held until its arrival time (6 ms) plus latency.
+    TSUNIT_EQUAL(26000, jb.nextDeadline());
+    TSUNIT_ASSERT(!jb.get(pkt, tstamp, 25999));
+    TSUNIT_ASSERT(jb.get(pkt, tstamp, 26000));
+    TSUNIT_EQUAL(6, Seq(pkt));
+    TSUNIT_EQUAL(1, jb.lostCount());
+
+    // Packet 5 arrives too late.
+    TSUNIT_ASSERT(!jb.add(MakeMedia(5), 27000));
+    TSUNIT_EQUAL(1, jb.lateCount());
+
+    // Remaining packets are immediately available.
+    for (uint16_t seq = 7; seq < 10; ++seq) {
+        TSUNIT_ASSERT(jb.get(pkt, tstamp, 27000));
+        TSUNIT_EQUAL(seq, Seq(pkt));
+    }
+
+    // A burst loss of 3 packets.
+    TSUNIT_ASSERT(jb.add(MakeMedia(13), 28000));
+    TSUNIT_ASSERT(!jb.get(pkt, tstamp, 47999));
+    TSUNIT_ASSERT(jb.get(pkt, tstamp, 48000));
+    TSUNIT_EQUAL(13, Seq(pkt));
+    TSUNIT_EQUAL(4, jb.lostCount());
+}
+
+void RTPTest::testWrap()
+{
+    ts::RTPJitterBuffer jb(5);
+    ts::ByteBlockPtr pkt;
+    ts::MicroSecond tstamp = 0;
+
+    // Sequence numbers wrap around 0xFFFF, in disorder.
+    static const uint16_t order[] = {0xFFFD, 0x0000, 0xFFFE, 0xFFFF, 0x0002, 0x0001};
+    for (auto seq : order) {
+        TSUNIT_ASSERT(jb.add(MakeMedia(seq), 0));
+    }
+    for (uint16_t i = 0; i < 6; ++i) {
+        TSUNIT_ASSERT(jb.get(pkt, tstamp, 5000));
+        TSUNIT_EQUAL(uint16_t(0xFFFD + i), Seq(pkt));
+    }
+
+    // One stray packet with an unrelated sequence number is held, then discarded
+    // when the next packet does not confirm it. The sequence does not change.
+    TSUNIT_ASSERT(jb.add(MakeMedia(0x8000), 6000));
+    TSUNIT_ASSERT(!jb.get(pkt, tstamp, 6000));
+    TSUNIT_EQUAL(0, jb.lateCount());
+    TSUNIT_ASSERT(jb.add(MakeMedia(0x0003), 6000));
+    TSUNIT_EQUAL(1, jb.lateCount());
+    TSUNIT_ASSERT(jb.get(pkt, tstamp, 6000));
+    TSUNIT_EQUAL(0x0003, Seq(pkt));
+    TSUNIT_ASSERT(!jb.get(pkt, tstamp, 6000));
+
+    // Restart of the sender with unrelated sequence numbers. The first packet is held,
+    // the second one confirms the new sequence and the stream continues without loss.
+    TSUNIT_ASSERT(jb.add(MakeMedia(0x8000), 7000));
+    TSUNIT_ASSERT(!jb.get(pkt, tstamp, 7000));
+    TSUNIT_ASSERT(jb.add(MakeMedia(0x8001), 7000));
+    TSUNIT_ASSERT(jb.add(MakeMedia(0x8002), 7000));
+    TSUNIT_ASSERT(jb.get(pkt, tstamp, 7000));
+    TSUNIT_EQUAL(0x8000, Seq(pkt));
+    TSUNIT_ASSERT(jb.get(pkt, tstamp, 7000));
+    TSUNIT_EQUAL(0x8001, Seq(pkt));
+    TSUNIT_ASSERT(jb.get(pkt, tstamp, 7000));
+    TSUNIT_EQUAL(0x8002, Seq(pkt));
+    TSUNIT_EQUAL(1, jb.lateCount());
+    TSUNIT_EQUAL(0, jb.lostCount());
+}
+
+void RTPTest::testFECColumn()
+{
+    std::vector<ts::ByteBlockPtr> media, columns, rows, recovered;
+    MakeMatrix(1000, media, columns, rows);
+
+    // One lost packet in each column, different rows. Only column FEC.
+    ts::RTPFECDecoder dec;
+    TSUNIT_EQUAL(4, Decode(dec, media, {0, 5, 10, 7}, columns, {}, recovered));
+    TSUNIT_EQUAL(4, recovered.size());
+    TSUNIT_EQUAL(4, dec.fecCount());
+    TSUNIT_EQUAL(4, dec.recoveredCount());
+    for (const auto& pkt : recovered) {
+        const uint16_t seq = Seq(pkt);
+        TSUNIT_ASSERT(seq >= 1000 && seq < 1000 + L * D);
+        TSUNIT_ASSERT(*pkt == *media[seq - 1000]);
+    }
+}
+
+void RTPTest::testFECRow()
+{
+    std::vector<ts::ByteBlockPtr> media, columns, rows, recovered;
+    MakeMatrix(0xFFFA, media, columns, rows);
+
+    // Two consecutive lost packets in the same row are not recoverable with row FEC only.
+    // Two lost packets in the same column are recoverable with row FEC, across the sequence number wrap.
+    ts::RTPFECDecoder dec;
+    TSUNIT_EQUAL(2, Decode(dec, media, {1, 5, 9, 10}, {}, rows, recovered));
+    TSUNIT_EQUAL(2, recovered.size());
+    TSUNIT_ASSERT(*recovered[0] == *media[1]);
+    TSUNIT_ASSERT(*recovered[1] == *media[5]);
+}
+
+void RTPTest::testFECIterative()
+{
+    std::vector<ts::ByteBlockPtr> media, columns, rows, recovered;
+    MakeMatrix(200, media, columns, rows);
+
+    // Loss pattern which needs several iterations over columns and rows: column 1 recovers 1,
+    // row 0 recovers 0, column 3 recovers 11, row 2 recovers 8, column 0 recovers 4.
+    ts::RTPFECDecoder dec;
+    const std::set<size_t> dropped {0, 1, 4, 8, 11};
+    TSUNIT_EQUAL(dropped.size(), Decode(dec, media, dropped, columns, rows, recovered));
+    std::set<size_t> found;
+    for (const auto& pkt : recovered) {
+        const size_t index = Seq(pkt) - 200;
+        TSUNIT_ASSERT(dropped.count(index) == 1);
+        TSUNIT_ASSERT(*pkt == *media[index]);
+        found.insert(index);
+    }
+    TSUNIT_ASSERT(found == dropped);
+}
+
+void RTPTest::testFECUnrecoverable()
+{
+    std::vector<ts::ByteBlockPtr> media, columns, rows, recovered;
+    MakeMatrix(300, media, columns, rows);
+
+    // A 2x2 square of lost packets cannot be recovered, the rest can.
+    ts::RTPFECDecoder dec;
+    TSUNIT_EQUAL(1, Decode(dec, media, {0, 1, 4, 5, 10}, columns, rows, recovered));
+    TSUNIT_EQUAL(1, recovered.size());
+    TSUNIT_ASSERT(*recovered[0] == *media[10]);
+
+    // The FEC packets are eventually dropped when the stream continues.
+    for (uint16_t seq = 400; seq < 2000; ++seq) {
+        dec.addMedia(MakeMedia(seq, 10));
+    }
+    TSUNIT_EQUAL(0, dec.recover(recovered));
+    TSUNIT_EQUAL(4, dec.unrecoverableCount());
+}
+
+void RTPTest::testFECJitter()
+{
+    // Complete chain: network with loss and reordering, FEC decoder, reordering buffer.
+    ts::RTPJitterBuffer jb(50);
+    ts::RTPFECDecoder dec;
+    std::vector<ts::ByteBlockPtr> output;
+    ts::ByteBlockPtr pkt;
+    ts::MicroSecond tstamp = 0;
+    ts::MicroSecond now = 0;
+
+    for (size_t m = 0; m < 10; ++m) {
+        std::vector<ts::ByteBlockPtr> media, columns, rows, recovered;
+        MakeMatrix(uint16_t(m * L * D), media, columns, rows);
+
+        // Lose one packet in two different columns, swap two packets.
+        std::swap(media[2], media[3]);
+        for (size_t i = 0; i < media.size(); ++i) {
+            const size_t index = Seq(media[i]) % (L * D);
+            if (index != (m + 1) % (L * D) && index != (m + 6) % (L * D)) {
+                jb.add(media[i], now);
+                dec.addMedia(media[i]);
+            }
+            now += 1000;
+            while (jb.get(pkt, tstamp, now)) {
+                output.push_back(pkt);
+            }
+        }
+
+        // FEC packets arrive after the matrix.
+        for (const auto& fec : columns) {
+            dec.addFEC(fec);
+        }
+        dec.recover(recovered);
+        for (const auto& r : recovered) {
+            jb.add(r, now);
+        }
+    }
+
+    // Flush the buffer.
+    dec.addMedia(MakeMedia(uint16_t(10 * L * D)));
+    now += 100000;
+    while (jb.get(pkt, tstamp, now)) {
+        output.push_back(pkt);
+    }
+
+    // Gap-free output.
+    TSUNIT_EQUAL(10 * L * D, output.size());
+    for (size_t i = 0; i < output.size(); ++i) {
+        TSUNIT_EQUAL(i, Seq(output[i]));
+    }
+    TSUNIT_EQUAL(0, jb.lostCount());
+    TSUNIT_EQUAL(20, dec.recoveredCount());
+}
+
+void RTPTest::testMerge()
+{
+    // Two legs, leg 1 is 3 ms behind leg 0, distinct loss patterns, one packet lost on both legs.
+    ts::RTPHitlessMerger merger(2, 10);
+    TSUNIT_EQUAL(2, merger.legs());
+    TSUNIT_EQUAL(10, merger.window());
+
+    const std::set<uint16_t> lost0 {3, 4, 10, 30, 31, 32, 33, 34, 35, 50};
+    const std::set<uint16_t> lost1 {7, 20, 21, 22, 23, 24, 50, 60};
+    std::vector<ts::ByteBlockPtr> output;
+    ts::ByteBlockPtr pkt;
+    ts::MicroSecond tstamp = 0;
+
+    for (ts::MicroSecond now = 0; now < 110000; now += 100) {
+        // One packet per millisecond on each leg.
+        if (now % 1000 == 0 && now < 100000) {
+            const uint16_t seq = uint16_t(now / 1000);
+            if (lost0.count(seq) == 0) {
+                merger.add(0, MakeMedia(seq), now);
+            }
+        }
+        if (now % 1000 == 0 && now >= 3000 && now < 103000) {
+            const uint16_t seq = uint16_t(now / 1000 - 3);
+            if (lost1.count(seq) == 0) {
+                merger.add(1, MakeMedia(seq), now);
+            }
+        }
+        while (merger.get(pkt, tstamp, now)) {
+            output.push_back(pkt);
+        }
+    }
+
+    // Each packet once, in order, except packet 50.
+    TSUNIT_EQUAL(99, output.size());
+    for (size_t i = 0; i < output.size(); ++i) {
+        TSUNIT_EQUAL(i < 50 ? i : i + 1, Seq(output[i]));
+    }
+    TSUNIT_EQUAL(1, merger.lostCount());
+    TSUNIT_EQUAL(lost0.size() + lost1.size() - 2, merger.repairedCount());
+    TSUNIT_EQUAL(100 - lost0.size(), merger.receivedCount(0));
+    TSUNIT_EQUAL(100 - lost1.size(), merger.receivedCount(1));
+    TSUNIT_EQUAL(lost0.size(), merger.lostCount(0));
+    TSUNIT_EQUAL(lost1.size(), merger.lostCount(1));
+    TSUNIT_EQUAL(lost0.size() - 1, merger.usedCount(1));
+    TSUNIT_EQUAL(0, merger.lateCount(0));
+    TSUNIT_EQUAL(0, merger.lateCount(1));
+}
+
+void RTPTest::testMergeLegDown()
+{
+    // Leg 0 stops after packet 20, leg 1 is always there, with 2 ms more delay.
+    ts::RTPHitlessMerger merger(2, 5);
+    std::vector<ts::ByteBlockPtr> output;
+    ts::ByteBlockPtr pkt;
+    ts::MicroSecond tstamp = 0;
+
+    for (ts::MicroSecond now = 0; now < 60000; now += 1000) {
+        const uint16_t seq = uint16_t(0xFFF0 + now / 1000);
+        if (now <= 20000) {
+            merger.add(0, MakeMedia(seq), now);
+        }
+        if (now >= 2000 && now < 50000) {
+            merger.add(1, MakeMedia(uint16_t(seq - 2)), now);
+        }
+        while (merger.get(pkt, tstamp, now)) {
+            output.push_back(pkt);
+        }
+    }
+
+    // No glitch when the leg goes down, across the sequence number wrap.
+    TSUNIT_EQUAL(48, output.size());
+    for (size_t i = 0; i < output.size(); ++i) {
+        TSUNIT_EQUAL(uint16_t(0xFFF0 + i), Seq(output[i]));
+    }
+    TSUNIT_EQUAL(0, merger.lostCount());
+    TSUNIT_EQUAL(21, merger.usedCount(0));
+    TSUNIT_EQUAL(27, merger.usedCount(1));
+    TSUNIT_EQUAL(27, merger.lostCount(0));
+    TSUNIT_EQUAL(0, merger.lostCount(1));
+}
+
+void RTPTest::testMergeLate()
+{
+    // Leg 1 is 20 ms behind leg 0, more than the window.
+    ts::RTPHitlessMerger merger(2, 10);
+    std::vector<ts::ByteBlockPtr> output;
+    ts::ByteBlockPtr pkt;
+    ts::MicroSecond tstamp = 0;
+
+    for (ts::MicroSecond now = 0; now < 100000; now += 1000) {
+        const uint16_t seq = uint16_t(now / 1000);
+        if (seq != 30 && seq < 80) {
+            merger.add(0, MakeMedia(seq), now);
+        }
+        if (seq >= 20) {
+            merger.add(1, MakeMedia(uint16_t(seq - 20)), now);
+        }
+        while (merger.get(pkt, tstamp, now)) {
+            output.push_back(pkt);
+        }
+    }
+
+    // Packet 30 from leg 1 arrives too late, all packets from leg 1 are late.
+    TSUNIT_EQUAL(79, output.size());
+    TSUNIT_EQUAL(1, merger.lostCount());
+    TSUNIT_EQUAL(80, merger.receivedCount(1));
+    TSUNIT_EQUAL(0, merger.usedCount(1));
+    TSUNIT_EQUAL(80, merger.lateCount(1));
+    TSUNIT_EQUAL(1, merger.lostCount(0));
+}
+
+void RTPTest::testMergeRestart()
+{
+    // The sender restarts with new sequence numbers on both legs.
+    ts::RTPHitlessMerger merger(2, 5);
+    std::vector<ts::ByteBlockPtr> output;
+    ts::ByteBlockPtr pkt;
+    ts::MicroSecond tstamp = 0;
+
+    for (ts::MicroSecond now = 0; now < 50000; now += 1000) {
+        const uint16_t seq = uint16_t(now < 20000 ? 1000 + now / 1000 : 40000 + now / 1000);
+        merger.add(0, MakeMedia(seq), now);
+        merger.add(1, MakeMedia(seq), now + 100);
+        while (merger.get(pkt, tstamp, now + 100)) {
+            output.push_back(pkt);
+        }
+    }
+    while (merger.get(pkt, tstamp, 100000)) {
+        output.push_back(pkt);
+    }
+
+    // The first packet after the restart is held until the next one confirms the restart.
+    // No packet is lost or late.
+    TSUNIT_EQUAL(50, output.size());
+    TSUNIT_EQUAL(1019, Seq(output[19]));
+    TSUNIT_EQUAL(40020, Seq(output[20]));
+    TSUNIT_EQUAL(40049, Seq(output[49]));
+    TSUNIT_EQUAL(0, merger.lateCount(0));
+    TSUNIT_EQUAL(0, merger.lateCount(1));
+    TSUNIT_EQUAL(0, merger.lostCount());
+}
+
+void RTPTest::testMergeRestartDelay()
+{
+    // The sender restarts with new sequence numbers, the second leg is delayed by 3 packets.
+    ts::RTPHitlessMerger merger(2, 10);
+    std::vector<ts::ByteBlockPtr> output;
+    ts::ByteBlockPtr pkt;
+    ts::MicroSecond tstamp = 0;
+
+    const auto seq = [](ts::MicroSecond time) { return uint16_t(time < 20000 ? 1000 + time / 1000 : 40000 + time / 1000); };
+    for (ts::MicroSecond now = 0; now < 50000; now += 1000) {
+        merger.add(0, MakeMedia(seq(now)), now);
+        if (now >= 3000) {
+            merger.add(1, MakeMedia(seq(now - 3000)), now + 100);
+        }
+        while (merger.get(pkt, tstamp, now + 100)) {
+            output.push_back(pkt);
+        }
+    }
+    while (merger.get(pkt, tstamp, 100000)) {
+        output.push_back(pkt);
+    }
+
+    // The end of the previous sequence on the delayed leg does not restart the merger again.
+    // All packets are output once, in order.
+    TSUNIT_EQUAL(50, output.size());
+    for (size_t i = 0; i < output.size(); ++i) {
+        TSUNIT_EQUAL(seq(ts::MicroSecond(i) * 1000), Seq(output[i]));
+    }
+    TSUNIT_EQUAL(0, merger.lateCount(0));
+    TSUNIT_EQUAL(2, merger.lateCount(1));
+    TSUNIT_EQUAL(0, merger.lostCount());
+}
@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsReportBuffer.h"
+#include "tsDeferredReport.h"
 #include "tsReportFile.h"
 #include "tsFileUtils.h"
 #include "tsNullReport.h"
@@ -55,6 +56,7 @@ public:
     void testPrintf();
     void testByName();
     void testByStream();
+    void testDeferred();
 
     TSUNIT_TEST_BEGIN(ReportTest);
     TSUNIT_TEST(testSeverity);
@@ -62,6 +64,7 @@ public:
     TSUNIT_TEST(testPrintf);
     TSUNIT_TEST(testByName);
     TSUNIT_TEST(testByStream);
+    TSUNIT_TEST(testDeferred);
     TSUNIT_TEST_END();
 
 private:
@@ -326,3 +329,35 @@ void ReportTest::testByStream()
     ts::UString::Load(value, _fileName);
     TSUNIT_ASSERT(value == ref);
 }
+
+// Test case: deferred messages, replayed with their original severity
+void ReportTest::testDeferred()
+{
+    ts::ReportBuffer<> log(ts::Severity::Debug);
+
+    // Verbose and debug messages are not errors.
+    ts::DeferredReport def1(ts::Severity::Debug);
+    def1.verbose(u"verbose 1");
+    def1.debug(u"debug 1");
+    def1.warning(u"warning 1");
+    TSUNIT_ASSERT(!def1.emptyMessages());
+    TSUNIT_ASSERT(def1.replay(log));
+    TSUNIT_ASSERT(def1.emptyMessages());
+    TSUNIT_ASSERT(!log.gotErrors());
+    TSUNIT_EQUAL(u"verbose 1\n"
+                 u"Debug: debug 1\n"
+                 u"Warning: warning 1",
+                 log.getMessages());
+
+    // Errors are replayed as errors.
+    log.resetMessages();
+    ts::DeferredReport def2;
+    def2.debug(u"debug 2");
+    def2.error(u"error 2");
+    def2.info(u"info 2");
+    TSUNIT_ASSERT(!def2.replay(log));
+    TSUNIT_ASSERT(log.gotErrors());
+    TSUNIT_EQUAL(u"Error: error 2\n"
+                 u"info 2",
+                 log.getMessages());
+}
@@ -72,6 +72,7 @@ public:
     void testMultiSectionsCAT();
     void testMultiSectionsAtProgramLevelPMT();
     void testMultiSectionsAtStreamLevelPMT();
+    void testStreaming();
 
     TSUNIT_TEST_BEGIN(SectionFileTest);
     TSUNIT_TEST(testConfigurationFile);
@@ -85,6 +86,7 @@ public:
     TSUNIT_TEST(testMultiSectionsCAT);
     TSUNIT_TEST(testMultiSectionsAtProgramLevelPMT);
     TSUNIT_TEST(testMultiSectionsAtStreamLevelPMT);
+    TSUNIT_TEST(testStreaming);
     TSUNIT_TEST_END();
 
 private:
@@ -768,3 +770,41 @@ void SectionFileTest::testMemory()
     TSUNIT_EQUAL(0, ::memcmp(out2, psi_pat1_sections, sizeof(psi_pat1_sections)));
     TSUNIT_EQUAL(0, ::memcmp(out2 + 32, psi_pmt_scte35_sections, sizeof(psi_pmt_scte35_sections)));
 }
+
+void SectionFileTest::testStreaming()
+{
+    ts::DuckContext duck(&report());
+    ts::SectionFile file(duck);
+
+    // Compile XML on the fly.
+    TSUNIT_ASSERT(file.compileXML(psi_pat1_xml, _tempFileNameBin));
+    TSUNIT_EQUAL(0, file.tablesCount());
+
+    ts::SectionFile bin(duck);
+    TSUNIT_ASSERT(bin.loadBinary(_tempFileNameBin));
+    TSUNIT_EQUAL(1, bin.tablesCount());
+    TSUNIT_EQUAL(sizeof(psi_pat1_sections), bin.binarySize());
+    TSUNIT_EQUAL(0, ::memcmp(psi_pat1_sections, bin.sections()[0]->content(), sizeof(psi_pat1_sections)));
+
+    // Decompile several tables on the fly.
+    {
+        std::ofstream strm(_tempFileNameBin.toUTF8().c_str(), std::ios::out | std::ios::binary);
+        strm.write(reinterpret_cast<const char*>(psi_pat1_sections), sizeof(psi_pat1_sections));
+        strm.write(reinterpret_cast<const char*>(psi_pmt_scte35_sections), sizeof(psi_pmt_scte35_sections));
+    }
+    TSUNIT_ASSERT(file.decompileBinary(_tempFileNameBin, _tempFileNameXML));
+    TSUNIT_EQUAL(0, file.tablesCount());
+
+    ts::SectionFile xml(duck);
+    TSUNIT_ASSERT(xml.loadXML(_tempFileNameXML));
+    TSUNIT_EQUAL(2, xml.tablesCount());
+    TSUNIT_EQUAL(ts::TID_PAT, xml.tables()[0]->tableId());
+    TSUNIT_EQUAL(ts::TID_PMT, xml.tables()[1]->tableId());
+
+    // Compile the decompiled file on the fly, must be identical to the original sections.
+    TSUNIT_ASSERT(file.compileXML(_tempFileNameXML, _tempFileNameBin));
+    ts::SectionFile bin2(duck);
+    TSUNIT_ASSERT(bin2.loadBinary(_tempFileNameBin));
+    TSUNIT_EQUAL(2, bin2.tablesCount());
+    TSUNIT_EQUAL(sizeof(psi_pat1_sections) + sizeof(psi_pmt_scte35_sections), bin2.binarySize());
+}
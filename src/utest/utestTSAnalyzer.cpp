@@ -0,0 +1,199 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for TSAnalyzer.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSAnalyzerReport.h"
+#include "tsTSAnalyzerOptions.h"
+#include "tsCyclingPacketizer.h"
+#include "tsDuckContext.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TSAnalyzerTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testMerge();
+
+    TSUNIT_TEST_BEGIN(TSAnalyzerTest);
+    TSUNIT_TEST(testMerge);
+    TSUNIT_TEST_END();
+
+private:
+    // Build a synthetic transport stream.
+    static void BuildStream(ts::TSPacketVector& packets);
+
+    // Get a normalized report, without the system times.
+    static ts::UString Report(ts::TSAnalyzerReport& analyzer);
+};
+
+TSUNIT_REGISTER(TSAnalyzerTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void TSAnalyzerTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void TSAnalyzerTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Build a synthetic transport stream: one service with PAT, PMT, a video PID
+// with PCR's and a scrambled audio PID with crypto-periods and one packet loss.
+//----------------------------------------------------------------------------
+
+void TSAnalyzerTest::BuildStream(ts::TSPacketVector& packets)
+{
+    ts::DuckContext duck;
+
+    ts::PAT pat(1, true, 0x1234);
+    pat.pmts[10] = 100;
+    ts::CyclingPacketizer pzpat(duck, ts::PID_PAT);
+    pzpat.addTable(duck, pat);
+
+    ts::PMT pmt(1, true, 10, 200);
+    pmt.streams[200].stream_type = ts::ST_MPEG2_VIDEO;
+    pmt.streams[300].stream_type = ts::ST_MPEG2_AUDIO;
+    ts::CyclingPacketizer pzpmt(duck, 100);
+    pzpmt.addTable(duck, pmt);
+
+    uint8_t cc200 = 0;
+    uint8_t cc300 = 0;
+    packets.resize(30000);
+
+    for (size_t i = 0; i < packets.size(); ++i) {
+        ts::TSPacket& pkt(packets[i]);
+        if (i % 100 == 0) {
+            pzpat.getNextPacket(pkt);
+        }
+        else if (i % 100 == 50) {
+            pzpmt.getNextPacket(pkt);
+        }
+        else if (i % 4 == 1) {
+            pkt.init(200, cc200++ & ts::CC_MASK, 0x20);
+            if (i % 40 == 1) {
+                // 10 Mb/s: 4061 PCR units per 188-byte packet.
+                pkt.setPCR(uint64_t(i) * 4061, true);
+            }
+        }
+        else if (i % 4 == 2) {
+            // Simulate a lost packet.
+            if (i == 12346) {
+                cc300++;
+            }
+            pkt.init(300, cc300++ & ts::CC_MASK, 0x30);
+            pkt.setScrambling((i / 3000) % 2 == 0 ? ts::SC_EVEN_KEY : ts::SC_ODD_KEY);
+        }
+        else {
+            pkt = ts::NullPacket;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get a normalized report, without the system times.
+//----------------------------------------------------------------------------
+
+ts::UString TSAnalyzerTest::Report(ts::TSAnalyzerReport& analyzer)
+{
+    ts::TSAnalyzerOptions opt;
+    opt.normalized = true;
+    std::ostringstream strm;
+    analyzer.report(strm, opt);
+
+    ts::UStringList lines;
+    ts::UString::FromUTF8(strm.str()).split(lines, u'\n', false, true);
+    ts::UString result;
+    for (const auto& line : lines) {
+        if (!line.contain(u":system:")) {
+            result.append(line);
+            result.append(u"\n");
+        }
+    }
+    return result;
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void TSAnalyzerTest::testMerge()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets);
+
+    // Sequential analysis.
+    ts::DuckContext duck;
+    ts::TSAnalyzerReport seq(duck);
+    for (const auto& pkt : packets) {
+        seq.feedPacket(pkt);
+    }
+    const ts::UString ref(Report(seq));
+    debug() << "TSAnalyzerTest::testMerge: sequential report:" << std::endl << ref;
+    TSUNIT_ASSERT(ref.contain(u"pid=300:"));
+    TSUNIT_ASSERT(ref.contain(u":discontinuities=1:"));
+
+    // Parallel analysis of chunks, cut at arbitrary points (inside crypto-periods, sections, between PCR's).
+    static const size_t bounds[] = {0, 9999, 12346, 20011, 30000};
+    constexpr size_t context_size = 1000;
+    ts::TSAnalyzerReport merged(duck);
+
+    for (size_t chunk = 0; chunk + 1 < sizeof(bounds) / sizeof(bounds[0]); ++chunk) {
+        ts::TSAnalyzerReport part(duck);
+        for (size_t i = bounds[chunk] < context_size ? 0 : bounds[chunk] - context_size; i < bounds[chunk]; ++i) {
+            part.feedContextPacket(packets[i]);
+        }
+        for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; ++i) {
+            part.feedPacket(packets[i]);
+        }
+        merged.merge(part);
+    }
+    TSUNIT_EQUAL(ref, Report(merged));
+}
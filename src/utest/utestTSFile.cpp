@@ -32,6 +32,8 @@
 //----------------------------------------------------------------------------
 
 #include "tsTSFile.h"
+#include "tsTSFileIndex.h"
+#include "tsTSFileIndexer.h"
 #include "tsTSPacket.h"
 #include "tsTSPacketMetadata.h"
 #include "tsCerrReport.h"
@@ -57,6 +59,7 @@ public:
     void testDuck();
     void testStuffingRead();
     void testStuffingWrite();
+    void testIndex();
 
     TSUNIT_TEST_BEGIN(TSFileTest);
     TSUNIT_TEST(testTS);
@@ -64,6 +67,7 @@ public:
     TSUNIT_TEST(testDuck);
     TSUNIT_TEST(testStuffingRead);
     TSUNIT_TEST(testStuffingWrite);
+    TSUNIT_TEST(testIndex);
     TSUNIT_TEST_END();
 
 private:
@@ -90,12 +94,14 @@ void TSFileTest::beforeTest()
         _tempFileName = ts::TempFile(u".ts");
     }
     ts::DeleteFile(_tempFileName, NULLREP);
+    ts::DeleteFile(ts::TSFileIndex::IndexFileName(_tempFileName), NULLREP);
 }
 
 // Test suite cleanup method.
 void TSFileTest::afterTest()
 {
     ts::DeleteFile(_tempFileName, NULLREP);
+    ts::DeleteFile(ts::TSFileIndex::IndexFileName(_tempFileName), NULLREP);
 }
 
 
@@ -395,3 +401,113 @@ void TSFileTest::testStuffingWrite()
     TSUNIT_EQUAL(184, packets[5].getPayloadSize());
     TSUNIT_EQUAL(0xFF, packets[5].getPayload()[0]);
 }
+
+void TSFileTest::testIndex()
+{
+    // Build 1000 packets. PID 100 carries a PCR every 10 packets, 100 ms apart.
+    // PID 101 has a random access point every 100 packets, starting at packet 55.
+    ts::TSPacketVector packets(1000);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        if (i % 10 == 0) {
+            packets[i].init(100, uint8_t(i / 10), 0x00);
+            TSUNIT_ASSERT(packets[i].setPCR(uint64_t(i) * 270000, true));
+        }
+        else if (i % 100 == 55) {
+            packets[i].init(101, uint8_t(i / 100), 0x01);
+            TSUNIT_ASSERT(packets[i].setRandomAccessIndicator(true));
+        }
+        else {
+            packets[i].init(102, uint8_t(i), 0x02);
+        }
+    }
+
+    // Write the file and its index, in several chunks.
+    ts::TSFile file;
+    ts::TSFileIndexer indexer;
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE, CERR));
+    TSUNIT_ASSERT(indexer.open(ts::TSFileIndex::IndexFileName(_tempFileName), ts::PKT_SIZE, 0, false, CERR));
+    TSUNIT_ASSERT(indexer.isOpen());
+    for (size_t i = 0; i < packets.size(); i += 64) {
+        const size_t count = std::min<size_t>(64, packets.size() - i);
+        const ts::PacketCounter where = file.writePacketsCount();
+        TSUNIT_ASSERT(file.writePackets(&packets[i], nullptr, count, CERR));
+        TSUNIT_ASSERT(indexer.addPackets(&packets[i], count, where, CERR));
+    }
+    indexer.close();
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_ASSERT(!indexer.isOpen());
+
+    // Load the index: one periodic entry per second and one per random access point.
+    ts::TSFileIndex index;
+    TSUNIT_ASSERT(index.load(ts::TSFileIndex::IndexFileName(_tempFileName), CERR));
+    TSUNIT_EQUAL(ts::PKT_SIZE, index.packetSize());
+    TSUNIT_EQUAL(20, index.entries().size());
+    TSUNIT_EQUAL(9500, index.duration());
+
+    const ts::TSFileIndex::Entry& e0(index.entries()[0]);
+    TSUNIT_EQUAL(0, e0.offset);
+    TSUNIT_EQUAL(0, e0.time);
+    TSUNIT_EQUAL(0, e0.pcr);
+    TSUNIT_EQUAL(100, e0.pid);
+    TSUNIT_ASSERT(!e0.rap);
+
+    const ts::TSFileIndex::Entry& e1(index.entries()[1]);
+    TSUNIT_EQUAL(55 * ts::PKT_SIZE, e1.offset);
+    TSUNIT_EQUAL(500, e1.time);
+    TSUNIT_EQUAL(101, e1.pid);
+    TSUNIT_ASSERT(e1.rap);
+
+    // Seek by time.
+    const ts::TSFileIndex::Entry* e = index.findTime(2700);
+    TSUNIT_ASSERT(e != nullptr);
+    TSUNIT_EQUAL(255 * ts::PKT_SIZE, e->offset);
+    TSUNIT_EQUAL(2500, e->time);
+    TSUNIT_ASSERT(e->rap);
+
+    e = index.findTime(300);
+    TSUNIT_ASSERT(e != nullptr);
+    TSUNIT_EQUAL(0, e->offset);
+
+    e = index.findTime(20000);
+    TSUNIT_ASSERT(e != nullptr);
+    TSUNIT_EQUAL(955 * ts::PKT_SIZE, e->offset);
+
+    // Read the file from the indexed position.
+    ts::TSPacket pkt;
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 1, index.findTime(2700)->offset, CERR));
+    TSUNIT_EQUAL(1, file.readPackets(&pkt, nullptr, 1, CERR));
+    TSUNIT_EQUAL(101, pkt.getPID());
+    TSUNIT_ASSERT(pkt.getRandomAccessIndicator());
+    TSUNIT_ASSERT(file.close(CERR));
+
+    // Append the same packets, the time offsets continue after the existing entries.
+    const uint64_t base = packets.size() * ts::PKT_SIZE;
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::APPEND, CERR));
+    TSUNIT_ASSERT(indexer.open(ts::TSFileIndex::IndexFileName(_tempFileName), ts::PKT_SIZE, base, true, CERR));
+    TSUNIT_ASSERT(file.writePackets(packets.data(), nullptr, packets.size(), CERR));
+    TSUNIT_ASSERT(indexer.addPackets(packets.data(), packets.size(), 0, CERR));
+    indexer.close();
+    TSUNIT_ASSERT(file.close(CERR));
+
+    TSUNIT_ASSERT(index.load(ts::TSFileIndex::IndexFileName(_tempFileName), CERR));
+    TSUNIT_EQUAL(40, index.entries().size());
+    TSUNIT_EQUAL(19000, index.duration());
+    for (size_t i = 1; i < index.entries().size(); ++i) {
+        TSUNIT_ASSERT(index.entries()[i].time >= index.entries()[i-1].time);
+    }
+
+    const ts::TSFileIndex::Entry& e20(index.entries()[20]);
+    TSUNIT_EQUAL(base, e20.offset);
+    TSUNIT_EQUAL(9500, e20.time);
+    TSUNIT_ASSERT(!e20.rap);
+
+    e = index.findTime(12700);
+    TSUNIT_ASSERT(e != nullptr);
+    TSUNIT_EQUAL(base + 255 * ts::PKT_SIZE, e->offset);
+    TSUNIT_EQUAL(12000, e->time);
+    TSUNIT_ASSERT(e->rap);
+
+    // Appending with another packet size is rejected.
+    TSUNIT_ASSERT(!indexer.open(ts::TSFileIndex::IndexFileName(_tempFileName), ts::PKT_SIZE + 4, base, true, NULLREP));
+    TSUNIT_ASSERT(!indexer.isOpen());
+}
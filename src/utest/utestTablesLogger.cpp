@@ -0,0 +1,253 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for TablesLogger.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTablesLogger.h"
+#include "tsTablesDisplay.h"
+#include "tsCyclingPacketizer.h"
+#include "tsDuckContext.h"
+#include "tsReportBuffer.h"
+#include "tsArgs.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
+#include "tsSDT.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TablesLoggerTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testShards();
+
+    TSUNIT_TEST_BEGIN(TablesLoggerTest);
+    TSUNIT_TEST(testShards);
+    TSUNIT_TEST_END();
+
+private:
+    // Build a synthetic transport stream.
+    static void BuildStream(ts::TSPacketVector& packets);
+
+    // Log all tables, text output, XML lines and demux errors, using the same options as tstables.
+    // With less than 2 shards, the packets are sequentially logged. Otherwise, the packets are sent
+    // to all sharded loggers by chunks and the fragments are logged after each chunk.
+    static ts::UString Log(const ts::TSPacketVector& packets, size_t shards, size_t chunk_size);
+};
+
+TSUNIT_REGISTER(TablesLoggerTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void TablesLoggerTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void TablesLoggerTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void TablesLoggerTest::testShards()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets);
+
+    // Sequential logging.
+    const ts::UString ref(Log(packets, 1, packets.size()));
+    debug() << "TablesLoggerTest::testShards: sequential output:" << std::endl << ref;
+    TSUNIT_ASSERT(ref.contain(u"* PAT, TID 0 (0x00), PID 0 (0x0000)"));
+    TSUNIT_ASSERT(ref.contain(u"* PMT, TID 2 (0x02), PID 100 (0x0064)"));
+    TSUNIT_ASSERT(ref.contain(u"* PMT, TID 2 (0x02), PID 101 (0x0065)"));
+    TSUNIT_ASSERT(ref.contain(u"* SDT Actual, TID 66 (0x42), PID 17 (0x0011)"));
+    TSUNIT_ASSERT(ref.contain(u"<PMT version=\"1\""));
+    TSUNIT_ASSERT(ref.contain(u"TS packets discontinuities: 1"));
+
+    // Parallel logging, with chunks which are cut at arbitrary points, inside tables.
+    TSUNIT_EQUAL(ref, Log(packets, 2, 1000));
+    TSUNIT_EQUAL(ref, Log(packets, 3, 777));
+    TSUNIT_EQUAL(ref, Log(packets, 4, 5));
+    TSUNIT_EQUAL(ref, Log(packets, 7, packets.size()));
+}
+
+
+//----------------------------------------------------------------------------
+// Build a synthetic transport stream: two services with PAT, SDT, two PMT's,
+// a new version of one PMT in the middle and one packet loss on the other.
+//----------------------------------------------------------------------------
+
+void TablesLoggerTest::BuildStream(ts::TSPacketVector& packets)
+{
+    ts::DuckContext duck;
+
+    ts::PAT pat(1, true, 0x1234);
+    pat.pmts[10] = 100;
+    pat.pmts[11] = 101;
+    ts::CyclingPacketizer pzpat(duck, ts::PID_PAT);
+    pzpat.addTable(duck, pat);
+
+    ts::SDT sdt(true, 3, true, 0x1234, 0x5678);
+    sdt.services[10].setName(duck, u"Service A");
+    sdt.services[10].setProvider(duck, u"Provider");
+    sdt.services[11].setName(duck, u"Service B");
+    sdt.services[11].setProvider(duck, u"Provider");
+    ts::CyclingPacketizer pzsdt(duck, ts::PID_SDT);
+    pzsdt.addTable(duck, sdt);
+
+    ts::PMT pmt1(0, true, 10, 200);
+    pmt1.streams[200].stream_type = ts::ST_MPEG2_VIDEO;
+    ts::CyclingPacketizer pzpmt1(duck, 100);
+    pzpmt1.addTable(duck, pmt1);
+
+    ts::PMT pmt2(4, true, 11, 300);
+    pmt2.streams[300].stream_type = ts::ST_MPEG2_VIDEO;
+    pmt2.streams[301].stream_type = ts::ST_MPEG2_AUDIO;
+    ts::CyclingPacketizer pzpmt2(duck, 101);
+    pzpmt2.addTable(duck, pmt2);
+
+    packets.resize(20000);
+
+    for (size_t i = 0; i < packets.size(); ++i) {
+        ts::TSPacket& pkt(packets[i]);
+        if (i == 10003) {
+            // New version of the first PMT.
+            pmt1.version = 1;
+            pmt1.streams[201].stream_type = ts::ST_MPEG2_AUDIO;
+            pzpmt1.removeAll();
+            pzpmt1.addTable(duck, pmt1);
+        }
+        if (i % 100 == 0) {
+            pzpat.getNextPacket(pkt);
+        }
+        else if (i % 100 == 25) {
+            pzsdt.getNextPacket(pkt);
+        }
+        else if (i % 50 == 10) {
+            pzpmt1.getNextPacket(pkt);
+        }
+        else if (i % 50 == 30) {
+            // Simulate a lost packet.
+            if (i == 12330) {
+                pzpmt2.getNextPacket(pkt);
+            }
+            pzpmt2.getNextPacket(pkt);
+        }
+        else {
+            pkt = ts::NullPacket;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Log all tables.
+//----------------------------------------------------------------------------
+
+ts::UString TablesLoggerTest::Log(const ts::TSPacketVector& packets, size_t shards, size_t chunk_size)
+{
+    static const ts::UStringVector options({u"--packet-index", u"--text-output", u"-", u"--log-xml-line"});
+
+    // Main logger, with text output in memory.
+    ts::ReportBuffer<> report;
+    ts::DuckContext duck(&report);
+    ts::TablesDisplay display(duck);
+    ts::TablesLogger logger(display);
+    ts::Args args(u"tables logger test", u"[options]", ts::Args::NO_EXIT_ON_ERROR);
+    logger.defineArgs(args);
+    TSUNIT_ASSERT(args.analyze(u"test", options));
+    TSUNIT_ASSERT(logger.loadArgs(duck, args));
+    TSUNIT_ASSERT(logger.open());
+    std::ostringstream text;
+    duck.setOutput(&text);
+
+    if (shards < 2) {
+        for (const auto& pkt : packets) {
+            logger.feedPacket(pkt);
+        }
+    }
+    else {
+        // All sharded loggers use the same options as the main logger.
+        std::vector<ts::ReportBuffer<>> shard_reports(shards);
+        std::vector<ts::SafePtr<ts::DuckContext>> shard_ducks(shards);
+        std::vector<ts::SafePtr<ts::TablesDisplay>> shard_displays(shards);
+        std::vector<ts::SafePtr<ts::TablesLogger>> shard_loggers(shards);
+        for (size_t i = 0; i < shards; ++i) {
+            shard_ducks[i] = new ts::DuckContext(&shard_reports[i]);
+            shard_displays[i] = new ts::TablesDisplay(*shard_ducks[i]);
+            shard_loggers[i] = new ts::TablesLogger(*shard_displays[i]);
+            TSUNIT_ASSERT(shard_loggers[i]->loadArgs(*shard_ducks[i], args));
+            shard_loggers[i]->setShard(i, shards);
+            TSUNIT_ASSERT(shard_loggers[i]->open());
+        }
+
+        // Send all chunks of packets to all shards, then log the fragments of all shards.
+        for (size_t start = 0; start < packets.size(); start += chunk_size) {
+            const size_t end = std::min(packets.size(), start + chunk_size);
+            ts::TablesLogger::FragmentList fragments;
+            for (const auto& shard : shard_loggers) {
+                for (size_t i = start; i < end; ++i) {
+                    shard->feedPacket(packets[i]);
+                }
+                shard->getFragments(fragments);
+            }
+            logger.logFragments(fragments);
+        }
+
+        // Log the tables which are flushed at the end and collect demux errors.
+        ts::TablesLogger::FragmentList fragments;
+        for (size_t i = 0; i < shards; ++i) {
+            shard_loggers[i]->close();
+            shard_loggers[i]->getFragments(fragments);
+            logger.addDemuxErrors(*shard_loggers[i]);
+            TSUNIT_ASSERT(shard_reports[i].getMessages().empty());
+        }
+        logger.logFragments(fragments);
+    }
+
+    logger.close();
+    logger.reportDemuxErrors(text);
+    return ts::UString::FromUTF8(text.str()) + report.getMessages();
+}
@@ -34,6 +34,14 @@
 #include "tsECMGSCS.h"
 #include "tsEMMGMUX.h"
 #include "tstlvMessageFactory.h"
+#include "tstlvConnection.h"
+#include "tsTCPServer.h"
+#include "tsNullMutex.h"
+#include "tsNullReport.h"
+#include "tsIPUtils.h"
+#include "tsSysUtils.h"
+#include "tsCerrReport.h"
+#include "utestTSUnitBenchmark.h"
 #include "tsunit.h"
 
 
@@ -51,12 +59,18 @@ public:
     void testEMMG();
     void testECMGError();
     void testEMMGError();
+    void testReuse();
+    void testECMGSpeed();
+    void testConnectionNonBlocking();
 
     TSUNIT_TEST_BEGIN(TagLengthValueTest);
     TSUNIT_TEST(testECMG);
     TSUNIT_TEST(testEMMG);
     TSUNIT_TEST(testECMGError);
     TSUNIT_TEST(testEMMGError);
+    TSUNIT_TEST(testReuse);
+    TSUNIT_TEST(testECMGSpeed);
+    TSUNIT_TEST(testConnectionNonBlocking);
     TSUNIT_TEST_END();
 };
 
@@ -350,3 +364,294 @@ void TagLengthValueTest::testEMMGError()
     debug() << "TagLengthValueTest::testEMMGError: dump" << std::endl << str << std::endl;
     TSUNIT_EQUAL(refString, str);
 }
+
+void TagLengthValueTest::testReuse()
+{
+    ts::ecmgscs::Protocol protocol;
+
+    ts::ecmgscs::CWProvision cwp(protocol);
+    cwp.channel_id = 3;
+    cwp.stream_id = 4;
+    cwp.CP_number = 0x1234;
+    cwp.CP_CW_combination.push_back(ts::ecmgscs::CPCWCombination(0x1234, ts::ByteBlock(8, 0x11)));
+    cwp.CP_CW_combination.push_back(ts::ecmgscs::CPCWCombination(0x1235, ts::ByteBlock(8, 0x22)));
+    cwp.has_access_criteria = true;
+    cwp.access_criteria = ts::ByteBlock({0xAA, 0xBB, 0xCC});
+
+    ts::ecmgscs::StreamTest test(protocol);
+    test.channel_id = 5;
+    test.stream_id = 6;
+
+    // Serialize the two messages one after the other in the same byte block.
+    ts::ByteBlockPtr data(new ts::ByteBlock);
+    {
+        ts::tlv::Serializer zer(data);
+        cwp.serialize(zer);
+    }
+    const size_t cwp_size = data->size();
+    {
+        ts::tlv::Serializer zer(data);
+        test.serialize(zer);
+    }
+    TSUNIT_ASSERT(data->size() > cwp_size);
+
+    // Reuse the same byte block after clear, same result.
+    ts::ByteBlockPtr data2(new ts::ByteBlock);
+    for (int i = 0; i < 3; ++i) {
+        data2->clear();
+        ts::tlv::Serializer zer(data2);
+        cwp.serialize(zer);
+    }
+    TSUNIT_EQUAL(cwp_size, data2->size());
+    TSUNIT_EQUAL(0, ::memcmp(data->data(), data2->data(), cwp_size));
+
+    // Reuse the same factory for all messages.
+    ts::tlv::MessageFactory fac(protocol);
+    for (int i = 0; i < 2; ++i) {
+        TSUNIT_EQUAL(ts::tlv::OK, fac.analyze(data->data(), cwp_size));
+        TSUNIT_EQUAL(ts::ecmgscs::Tags::CW_provision, fac.commandTag());
+        TSUNIT_EQUAL(2, fac.count(ts::ecmgscs::Tags::CP_CW_combination));
+        TSUNIT_EQUAL(0, fac.count(ts::ecmgscs::Tags::CP_duration));
+        TSUNIT_EQUAL(0x1234, fac.get<uint16_t>(ts::ecmgscs::Tags::CP_number));
+
+        // The parameters point into the message buffer, without copy.
+        ts::tlv::MessageFactory::Parameter param;
+        fac.get(ts::ecmgscs::Tags::access_criteria, param);
+        TSUNIT_EQUAL(3, param.length);
+        TSUNIT_ASSERT(param.addr >= data->data() && param.addr < data->data() + cwp_size);
+
+        ts::tlv::MessagePtr msg(fac.factory());
+        ts::ecmgscs::CWProvision* ptr = dynamic_cast<ts::ecmgscs::CWProvision*>(msg.pointer());
+        TSUNIT_ASSERT(ptr != nullptr);
+        TSUNIT_EQUAL(3, ptr->channel_id);
+        TSUNIT_EQUAL(4, ptr->stream_id);
+        TSUNIT_EQUAL(2, ptr->CP_CW_combination.size());
+        TSUNIT_EQUAL(0x1234, ptr->CP_CW_combination[0].CP);
+        TSUNIT_ASSERT(ptr->CP_CW_combination[0].CW == ts::ByteBlock(8, 0x11));
+        TSUNIT_EQUAL(0x1235, ptr->CP_CW_combination[1].CP);
+        TSUNIT_ASSERT(ptr->CP_CW_combination[1].CW == ts::ByteBlock(8, 0x22));
+        TSUNIT_ASSERT(ptr->has_access_criteria);
+        TSUNIT_ASSERT(ptr->access_criteria == ts::ByteBlock({0xAA, 0xBB, 0xCC}));
+
+        TSUNIT_EQUAL(ts::tlv::OK, fac.analyze(data->data() + cwp_size, data->size() - cwp_size));
+        TSUNIT_EQUAL(ts::ecmgscs::Tags::stream_test, fac.commandTag());
+        TSUNIT_EQUAL(0, fac.count(ts::ecmgscs::Tags::CP_CW_combination));
+        TSUNIT_EQUAL(5, fac.get<uint16_t>(ts::ecmgscs::Tags::ECM_channel_id));
+        TSUNIT_EQUAL(6, fac.get<uint16_t>(ts::ecmgscs::Tags::ECM_stream_id));
+
+        // Truncated message, previous state is forgotten.
+        TSUNIT_EQUAL(ts::tlv::InvalidMessage, fac.analyze(data->data(), 7));
+        TSUNIT_ASSERT(fac.factory().isNull());
+        TSUNIT_ASSERT(!fac.errorResponse().isNull());
+    }
+}
+
+void TagLengthValueTest::testECMGSpeed()
+{
+    // Typical ECMG <=> SCS exchange: CW_provision and ECM_response.
+    ts::ecmgscs::Protocol protocol;
+
+    ts::ecmgscs::CWProvision cwp(protocol);
+    cwp.channel_id = 1;
+    cwp.stream_id = 2;
+    cwp.CP_number = 100;
+    cwp.CP_CW_combination.push_back(ts::ecmgscs::CPCWCombination(100, ts::ByteBlock(16, 0x5A)));
+    cwp.CP_CW_combination.push_back(ts::ecmgscs::CPCWCombination(101, ts::ByteBlock(16, 0xA5)));
+
+    ts::ecmgscs::ECMResponse resp(protocol);
+    resp.channel_id = 1;
+    resp.stream_id = 2;
+    resp.CP_number = 100;
+    resp.ECM_datagram.resize(188, 0x47);
+
+    utest::TSUnitBenchmark bench1(u"TSUNIT_TLV_ITERATIONS");
+    utest::TSUnitBenchmark bench2(u"TSUNIT_TLV_ITERATIONS");
+    constexpr size_t count = 1000;
+    size_t total = 0;
+
+    // Allocate new buffers and objects for each message.
+    bench1.start();
+    for (size_t iter = 0; iter < bench1.iterations; ++iter) {
+        for (size_t i = 0; i < count; ++i) {
+            ts::ByteBlockPtr bb1(new ts::ByteBlock);
+            ts::tlv::Serializer zer1(bb1);
+            cwp.serialize(zer1);
+            ts::tlv::MessageFactory fac1(bb1->data(), bb1->size(), protocol);
+            total += fac1.get<uint16_t>(ts::ecmgscs::Tags::CP_number);
+
+            ts::ByteBlockPtr bb2(new ts::ByteBlock);
+            ts::tlv::Serializer zer2(bb2);
+            resp.serialize(zer2);
+            ts::tlv::MessageFactory fac2(bb2->data(), bb2->size(), protocol);
+            total += fac2.get<uint16_t>(ts::ecmgscs::Tags::CP_number);
+        }
+    }
+    bench1.stop();
+    bench1.report(u"TagLengthValueTest::testECMGSpeed: new buffers");
+
+    // Reuse the same serialization buffer and message factory.
+    ts::ByteBlockPtr bb(new ts::ByteBlock);
+    ts::tlv::MessageFactory fac(protocol);
+    bench2.start();
+    for (size_t iter = 0; iter < bench2.iterations; ++iter) {
+        for (size_t i = 0; i < count; ++i) {
+            bb->clear();
+            {
+                ts::tlv::Serializer zer(bb);
+                cwp.serialize(zer);
+            }
+            fac.analyze(bb->data(), bb->size());
+            total += fac.get<uint16_t>(ts::ecmgscs::Tags::CP_number);
+
+            bb->clear();
+            {
+                ts::tlv::Serializer zer(bb);
+                resp.serialize(zer);
+            }
+            fac.analyze(bb->data(), bb->size());
+            total += fac.get<uint16_t>(ts::ecmgscs::Tags::CP_number);
+        }
+    }
+    bench2.stop();
+    bench2.report(u"TagLengthValueTest::testECMGSpeed: reused buffers");
+
+    TSUNIT_EQUAL(2 * 100 * count * (bench1.iterations + bench2.iterations), total);
+}
+
+namespace {
+    typedef ts::tlv::Connection<ts::NullMutex> TestConnection;
+
+    // Receive one message on a non-blocking connection, wait a bit for it.
+    ts::tlv::MessagePtr ReceiveOne(TestConnection& conn, ts::tlv::Logger& logger)
+    {
+        ts::tlv::MessagePtr msg;
+        for (int i = 0; i < 100 && msg.isNull(); ++i) {
+            TSUNIT_ASSERT(conn.receiveNonBlocking(msg, logger));
+            if (msg.isNull()) {
+                ts::SleepThread(10);
+            }
+        }
+        return msg;
+    }
+
+    // Check the content of a CW_provision message.
+    void CheckCWProvision(const ts::tlv::MessagePtr& msg, uint16_t cp_number, size_t ac_size)
+    {
+        TSUNIT_ASSERT(!msg.isNull());
+        const ts::ecmgscs::CWProvision* cwp = dynamic_cast<const ts::ecmgscs::CWProvision*>(msg.pointer());
+        TSUNIT_ASSERT(cwp != nullptr);
+        TSUNIT_EQUAL(7, cwp->channel_id);
+        TSUNIT_EQUAL(8, cwp->stream_id);
+        TSUNIT_EQUAL(cp_number, cwp->CP_number);
+        TSUNIT_ASSERT(cwp->has_access_criteria);
+        TSUNIT_EQUAL(ac_size, cwp->access_criteria.size());
+        TSUNIT_ASSERT(cwp->access_criteria == ts::ByteBlock(ac_size, uint8_t(cp_number)));
+    }
+}
+
+void TagLengthValueTest::testConnectionNonBlocking()
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    ts::ecmgscs::Protocol protocol;
+    ts::tlv::Logger logger(ts::Severity::Debug, &CERR);
+
+    // Client and server sides of a TLV connection on the loopback, all in the same thread.
+    const ts::IPv4SocketAddress serverAddress(ts::IPv4Address::LocalHost, 12347);
+    ts::TCPServer server;
+    TSUNIT_ASSERT(server.open(CERR));
+    TSUNIT_ASSERT(server.reusePort(true, CERR));
+    TSUNIT_ASSERT(server.bind(serverAddress, CERR));
+    TSUNIT_ASSERT(server.listen(5, CERR));
+
+    TestConnection client(protocol);
+    TSUNIT_ASSERT(client.open(CERR));
+    TSUNIT_ASSERT(client.setSendBufferSize(4096, CERR));
+    TSUNIT_ASSERT(client.connect(serverAddress, CERR));
+
+    TestConnection peer(protocol);
+    ts::IPv4SocketAddress clientAddress;
+    TSUNIT_ASSERT(server.accept(peer, clientAddress, CERR));
+    TSUNIT_ASSERT(peer.setReceiveBufferSize(4096, CERR));
+    TSUNIT_ASSERT(client.setNonBlocking(true, CERR));
+    TSUNIT_ASSERT(peer.setNonBlocking(true, CERR));
+
+    // Nothing to receive yet.
+    ts::tlv::MessagePtr msg;
+    TSUNIT_ASSERT(peer.receiveNonBlocking(msg, logger));
+    TSUNIT_ASSERT(msg.isNull());
+
+    // Serialize two messages and send them in several raw writes, splitting the header and the payload.
+    ts::ecmgscs::CWProvision cwp(protocol);
+    cwp.channel_id = 7;
+    cwp.stream_id = 8;
+    cwp.CP_number = 1;
+    cwp.has_access_criteria = true;
+    cwp.access_criteria = ts::ByteBlock(100, 1);
+
+    ts::ByteBlockPtr data(new ts::ByteBlock);
+    {
+        ts::tlv::Serializer zer(data);
+        cwp.serialize(zer);
+    }
+    const size_t msg_size = data->size();
+    cwp.CP_number = 2;
+    cwp.access_criteria = ts::ByteBlock(200, 2);
+    {
+        ts::tlv::Serializer zer(data);
+        cwp.serialize(zer);
+    }
+
+    ts::TCPConnection& raw(client);
+    TSUNIT_ASSERT(raw.send(data->data(), 3, CERR));
+    ts::SleepThread(20);
+    TSUNIT_ASSERT(peer.receiveNonBlocking(msg, logger));
+    TSUNIT_ASSERT(msg.isNull());
+
+    TSUNIT_ASSERT(raw.send(data->data() + 3, msg_size - 4, CERR));
+    ts::SleepThread(20);
+    TSUNIT_ASSERT(peer.receiveNonBlocking(msg, logger));
+    TSUNIT_ASSERT(msg.isNull());
+
+    // The last byte of the first message and the complete second message in one write.
+    TSUNIT_ASSERT(raw.send(data->data() + msg_size - 1, data->size() - msg_size + 1, CERR));
+    CheckCWProvision(ReceiveOne(peer, logger), 1, 100);
+    CheckCWProvision(ReceiveOne(peer, logger), 2, 200);
+    TSUNIT_ASSERT(peer.receiveNonBlocking(msg, logger));
+    TSUNIT_ASSERT(msg.isNull());
+
+    // Send many messages without reading them: the socket buffers fill up and the
+    // rest of the data remain in the output buffer of the connection.
+    const size_t count = 500;
+    const size_t ac_size = 1000;
+    for (size_t i = 0; i < count; ++i) {
+        cwp.CP_number = uint16_t(i);
+        cwp.access_criteria = ts::ByteBlock(ac_size, uint8_t(i));
+        TSUNIT_ASSERT(client.sendNonBlocking(cwp, logger));
+    }
+    TSUNIT_ASSERT(client.hasPendingOutput());
+
+    // Read all messages, flushing the output on the other side.
+    for (size_t i = 0; i < count; ++i) {
+        TSUNIT_ASSERT(client.flushOutput(CERR));
+        CheckCWProvision(ReceiveOne(peer, logger), uint16_t(i), ac_size);
+    }
+    TSUNIT_ASSERT(!client.hasPendingOutput());
+    TSUNIT_ASSERT(peer.receiveNonBlocking(msg, logger));
+    TSUNIT_ASSERT(msg.isNull());
+
+    // A disconnection is an error, not an absence of message.
+    TSUNIT_ASSERT(client.disconnect(CERR));
+    TSUNIT_ASSERT(client.close(CERR));
+    bool ok = true;
+    for (int i = 0; ok && i < 100; ++i) {
+        ok = peer.receiveNonBlocking(msg, logger);
+        TSUNIT_ASSERT(msg.isNull());
+        if (ok) {
+            ts::SleepThread(10);
+        }
+    }
+    TSUNIT_ASSERT(!ok);
+    peer.close(NULLREP);
+    TSUNIT_ASSERT(server.close(CERR));
+}
@@ -33,6 +33,8 @@
 
 #include "tsTimeShiftBuffer.h"
 #include "tsCerrReport.h"
+#include "tsNullReport.h"
+#include "tsFileUtils.h"
 #include "tsunit.h"
 
 
@@ -49,15 +51,20 @@ public:
     void testMinimum();
     void testMemory();
     void testFile();
+    void testMapped();
+    void testPersistent();
 
     TSUNIT_TEST_BEGIN(TimeShiftBufferTest);
     TSUNIT_TEST(testMinimum);
     TSUNIT_TEST(testMemory);
     TSUNIT_TEST(testFile);
+    TSUNIT_TEST(testMapped);
+    TSUNIT_TEST(testPersistent);
     TSUNIT_TEST_END();
 
 private:
-    void testCommon(uint8_t total, uint8_t memory);
+    ts::UString _tempFile {};
+    void testCommon(uint8_t total, uint8_t memory, bool mapped = false);
 };
 
 TSUNIT_REGISTER(TimeShiftBufferTest);
@@ -70,11 +77,16 @@ TSUNIT_REGISTER(TimeShiftBufferTest);
 // Test suite initialization method.
 void TimeShiftBufferTest::beforeTest()
 {
+    if (_tempFile.empty()) {
+        _tempFile = ts::TempFile(u".tsshift");
+    }
+    ts::DeleteFile(_tempFile, NULLREP);
 }
 
 // Test suite cleanup method.
 void TimeShiftBufferTest::afterTest()
 {
+    ts::DeleteFile(_tempFile, NULLREP);
 }
 
 
@@ -82,10 +94,11 @@ void TimeShiftBufferTest::afterTest()
 // Unitary tests.
 //----------------------------------------------------------------------------
 
-void TimeShiftBufferTest::testCommon(uint8_t total, uint8_t memory)
+void TimeShiftBufferTest::testCommon(uint8_t total, uint8_t memory, bool mapped)
 {
     ts::TimeShiftBuffer buf(total);
     TSUNIT_ASSERT(buf.setMemoryPackets(memory));
+    TSUNIT_ASSERT(buf.setMemoryMapped(mapped));
     TSUNIT_ASSERT(!buf.isOpen());
     TSUNIT_ASSERT(buf.open(CERR));
     TSUNIT_ASSERT(buf.isOpen());
@@ -93,7 +106,7 @@ void TimeShiftBufferTest::testCommon(uint8_t total, uint8_t memory)
     TSUNIT_EQUAL(0, buf.count());
     TSUNIT_ASSERT(buf.empty());
     TSUNIT_ASSERT(!buf.full());
-    TSUNIT_EQUAL(memory >= total, buf.memoryResident());
+    TSUNIT_EQUAL(memory >= total && !mapped, buf.memoryResident());
 
     ts::TSPacket pkt;
     ts::TSPacketMetadata mdata;
@@ -166,3 +179,77 @@ void TimeShiftBufferTest::testFile()
 {
     testCommon(20, 4);
 }
+
+void TimeShiftBufferTest::testMapped()
+{
+    testCommon(20, 4, true);
+}
+
+void TimeShiftBufferTest::testPersistent()
+{
+    ts::TSPacket pkt;
+    ts::TSPacketMetadata mdata;
+
+    // Partially fill a persistent buffer.
+    {
+        ts::TimeShiftBuffer buf(10);
+        TSUNIT_ASSERT(buf.setPersistentFile(_tempFile));
+        TSUNIT_ASSERT(buf.open(CERR));
+        TSUNIT_ASSERT(!buf.memoryResident());
+        TSUNIT_EQUAL(0, buf.count());
+        for (uint8_t i = 0; i < 6; i++) {
+            pkt.init(i, i, i);
+            mdata.reset();
+            TSUNIT_ASSERT(buf.shift(pkt, mdata, CERR));
+            TSUNIT_EQUAL(ts::PID_NULL, pkt.getPID());
+        }
+        TSUNIT_ASSERT(buf.close(CERR));
+    }
+    TSUNIT_ASSERT(ts::FileExists(_tempFile));
+
+    // Reopen, continue filling and get the packets from the previous session first.
+    {
+        ts::TimeShiftBuffer buf(10);
+        TSUNIT_ASSERT(buf.setPersistentFile(_tempFile));
+        TSUNIT_ASSERT(buf.open(CERR));
+        TSUNIT_EQUAL(6, buf.count());
+        for (uint8_t i = 6; i < 10; i++) {
+            pkt.init(i, i, i);
+            mdata.reset();
+            TSUNIT_ASSERT(buf.shift(pkt, mdata, CERR));
+            TSUNIT_EQUAL(ts::PID_NULL, pkt.getPID());
+        }
+        TSUNIT_ASSERT(buf.full());
+        for (uint8_t i = 10; i < 25; i++) {
+            pkt.init(i, i, i);
+            mdata.reset();
+            TSUNIT_ASSERT(buf.shift(pkt, mdata, CERR));
+            TSUNIT_EQUAL(i - 10, pkt.getPID());
+            TSUNIT_EQUAL(i - 10, *pkt.getPayload());
+            TSUNIT_ASSERT(!mdata.getInputStuffing());
+        }
+        TSUNIT_ASSERT(buf.close(CERR));
+    }
+
+    // Reopen with a full buffer, the next packet is the oldest one.
+    {
+        ts::TimeShiftBuffer buf(10);
+        TSUNIT_ASSERT(buf.setPersistentFile(_tempFile));
+        TSUNIT_ASSERT(buf.open(CERR));
+        TSUNIT_ASSERT(buf.full());
+        pkt.init(25, 25, 25);
+        mdata.reset();
+        TSUNIT_ASSERT(buf.shift(pkt, mdata, CERR));
+        TSUNIT_EQUAL(15, pkt.getPID());
+        TSUNIT_ASSERT(buf.close(CERR));
+    }
+
+    // Reopen with another size, the previous content is dropped.
+    {
+        ts::TimeShiftBuffer buf(12);
+        TSUNIT_ASSERT(buf.setPersistentFile(_tempFile));
+        TSUNIT_ASSERT(buf.open(CERR));
+        TSUNIT_ASSERT(buf.empty());
+        TSUNIT_ASSERT(buf.close(CERR));
+    }
+}
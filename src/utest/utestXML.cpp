@@ -34,6 +34,9 @@
 #include "tsxmlModelDocument.h"
 #include "tsxmlElement.h"
 #include "tsxmlDeclaration.h"
+#include "tsxmlRunningReader.h"
+#include "tsxmlJSONConverter.h"
+#include "tsjsonValue.h"
 #include "tsSectionFile.h"
 #include "tsTextFormatter.h"
 #include "tsCerrReport.h"
@@ -60,6 +63,8 @@ public:
     void testValidation();
     void testCreation();
     void testKeepOpen();
+    void testRunningReader();
+    void testPrintAsJSON();
     void testEscape();
     void testTweaks();
     void testChannels();
@@ -75,6 +80,8 @@ public:
     TSUNIT_TEST(testValidation);
     TSUNIT_TEST(testCreation);
     TSUNIT_TEST(testKeepOpen);
+    TSUNIT_TEST(testRunningReader);
+    TSUNIT_TEST(testPrintAsJSON);
     TSUNIT_TEST(testEscape);
     TSUNIT_TEST(testTweaks);
     TSUNIT_TEST(testChannels);
@@ -394,6 +401,128 @@ void XMLTest::testKeepOpen()
         out.toString());
 }
 
+void XMLTest::testRunningReader()
+{
+    static const ts::UChar* const document =
+        u"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        u"<!-- <root> in comment -->\n"
+        u"<root attr1=\"val1\">\n"
+        u"  <node1>  Text in node1  </node1> <node2\n"
+        u"     attr2=\"a>b\">\n"
+        u"    <node21><![CDATA[ </node2> ]]></node21>\n"
+        u"    <!-- </node2> -->\n"
+        u"    <node22/>\n"
+        u"  </node2>\n"
+        u"  text between nodes\n"
+        u"  <node3 foo=\"bar\"/><node4/>\n"
+        u"</root>\n";
+
+    ts::xml::RunningReader doc(report());
+    TSUNIT_ASSERT(doc.open(document));
+    TSUNIT_ASSERT(!doc.eof());
+
+    ts::xml::Element* root = doc.rootElement();
+    TSUNIT_ASSERT(root != nullptr);
+    TSUNIT_EQUAL(u"root", root->name());
+    TSUNIT_EQUAL(u"val1", root->attribute(u"attr1").value());
+    TSUNIT_EQUAL(0, root->childrenCount());
+
+    ts::xml::Element* elem = doc.readElement();
+    TSUNIT_ASSERT(elem != nullptr);
+    TSUNIT_EQUAL(u"node1", elem->name());
+    TSUNIT_EQUAL(4, elem->lineNumber());
+    TSUNIT_EQUAL(u"  Text in node1  ", elem->text());
+    TSUNIT_EQUAL(1, root->childrenCount());
+
+    elem = doc.readElement();
+    TSUNIT_ASSERT(elem != nullptr);
+    TSUNIT_EQUAL(u"node2", elem->name());
+    TSUNIT_EQUAL(4, elem->lineNumber());
+    TSUNIT_EQUAL(u"a>b", elem->attribute(u"attr2").value());
+    TSUNIT_EQUAL(1, root->childrenCount());
+    TSUNIT_ASSERT(elem->findFirstChild(u"node21") != nullptr);
+    TSUNIT_EQUAL(u" </node2> ", elem->findFirstChild(u"node21")->text());
+    TSUNIT_ASSERT(elem->findFirstChild(u"node22") != nullptr);
+    TSUNIT_EQUAL(8, elem->findFirstChild(u"node22")->lineNumber());
+
+    elem = doc.readElement();
+    TSUNIT_ASSERT(elem != nullptr);
+    TSUNIT_EQUAL(u"node3", elem->name());
+    TSUNIT_EQUAL(11, elem->lineNumber());
+    TSUNIT_EQUAL(u"bar", elem->attribute(u"foo").value());
+
+    elem = doc.readElement();
+    TSUNIT_ASSERT(elem != nullptr);
+    TSUNIT_EQUAL(u"node4", elem->name());
+    TSUNIT_EQUAL(1, root->childrenCount());
+
+    TSUNIT_ASSERT(doc.readElement() == nullptr);
+    TSUNIT_ASSERT(doc.eof());
+    TSUNIT_EQUAL(0, root->childrenCount());
+
+    // Truncated document.
+    ts::ReportBuffer<> rep;
+    ts::xml::RunningReader doc2(rep);
+    TSUNIT_ASSERT(doc2.open(u"<?xml version=\"1.0\"?>\n<root>\n  <node1>\n    <node11/>\n"));
+    TSUNIT_ASSERT(doc2.readElement() == nullptr);
+    TSUNIT_ASSERT(!doc2.eof());
+    TSUNIT_ASSERT(!rep.emptyMessages());
+
+    // Empty root.
+    ts::xml::RunningReader doc3(report());
+    TSUNIT_ASSERT(doc3.open(u"<?xml version=\"1.0\"?>\n<root/>\n"));
+    TSUNIT_ASSERT(doc3.eof());
+    TSUNIT_ASSERT(doc3.rootElement() != nullptr);
+    TSUNIT_ASSERT(doc3.readElement() == nullptr);
+}
+
+void XMLTest::testPrintAsJSON()
+{
+    static const ts::UChar* const document =
+        u"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        u"<tsduck>\n"
+        u"  <PMT version=\"11\" current=\"true\" service_id=\"0x03F2\" PCR_PID=\"0x03F3\">\n"
+        u"    <!-- comment -->\n"
+        u"    <registration_descriptor format_identifier=\"0x43554549\"/>\n"
+        u"    <component elementary_PID=\"0x03F6\" stream_type=\"0x06\">\n"
+        u"      <teletext_descriptor>\n"
+        u"        <teletext language_code=\"r\\u&quot;s\" teletext_type=\"0x01\" page_number=\"100\"/>\n"
+        u"      </teletext_descriptor>\n"
+        u"      <generic_descriptor tag=\"0xF0\">\n"
+        u"        01 02  03\n"
+        u"        04\n"
+        u"      </generic_descriptor>\n"
+        u"    </component>\n"
+        u"  </PMT>\n"
+        u"  <PAT version=\"bad\" current=\"false\" transport_stream_id=\"0x0001\"/>\n"
+        u"</tsduck>\n";
+
+    ts::xml::JSONConverter conv(report());
+    TSUNIT_ASSERT(ts::SectionFile::LoadModel(conv));
+
+    ts::xml::Document doc(report());
+    TSUNIT_ASSERT(doc.parse(document));
+    const ts::json::ValuePtr jdoc(conv.convertToJSON(doc, true));
+
+    // The direct printing must be identical to the printing of the JSON tree.
+    size_t index = 0;
+    for (const ts::xml::Element* elem = doc.rootElement()->firstChildElement(); elem != nullptr; elem = elem->nextSiblingElement()) {
+        ts::TextFormatter ref(report());
+        jdoc->query(ts::UString::Format(u"#nodes[%d]", {index++})).print(ref.setString());
+        ts::TextFormatter out(report());
+        conv.printAsJSON(out.setString(), elem);
+        TSUNIT_EQUAL(ref.toString(), out.toString());
+    }
+    TSUNIT_EQUAL(2, index);
+
+    // Same thing on the root element.
+    ts::TextFormatter ref(report());
+    jdoc->print(ref.setString());
+    ts::TextFormatter out(report());
+    conv.printAsJSON(out.setString(), doc.rootElement());
+    TSUNIT_EQUAL(ref.toString(), out.toString());
+}
+
 void XMLTest::testEscape()
 {
     ts::xml::Document doc(report());